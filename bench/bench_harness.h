@@ -0,0 +1,151 @@
+/**
+ * @file bench_harness.h
+ * @brief uvapi_bench 的计时与输出
+ *
+ * - 每个用例先按倍增确定批大小（单批不少于最短时间的 1/10），再取若干批的中位数，
+ *   减少调度与频率抖动的影响
+ * - 结果以 JSON 输出（每个用例一个对象），便于回归对比；日志只写到 stderr
+ */
+
+#ifndef UVAPI_BENCH_HARNESS_H
+#define UVAPI_BENCH_HARNESS_H
+
+#include "../include/json_writer.h"
+#include "../include/route_metrics.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace uvapi {
+namespace bench {
+
+// 阻止编译器把基准中的计算当作无用代码删除
+template<typename T>
+inline void keep(const T& value) {
+    __asm__ __volatile__("" : : "r"(&value) : "memory");
+}
+
+struct Result {
+    std::string name;
+    uint64_t iterations;  // 计入结果的总迭代次数
+    double ns_per_op;     // 各批中位数
+    double min_ns_per_op;
+    std::vector<std::pair<std::string, double> > extra;  // 用例附加的数值（字节数、百分位等）
+
+    Result() : iterations(0), ns_per_op(0.0), min_ns_per_op(0.0) {}
+
+    Result& add(const std::string& key, double value) {
+        extra.push_back(std::make_pair(key, value));
+        return *this;
+    }
+};
+
+struct Options {
+    uint64_t min_time_ns;  // 每个用例的最短计时
+    int batches;
+    std::string filter;    // 只运行名称包含该子串的用例
+
+    Options() : min_time_ns(200000000ULL), batches(5) {}
+
+    bool selected(const std::string& name) const {
+        return filter.empty() || name.find(filter) != std::string::npos;
+    }
+};
+
+// 有序样本的 p 分位（0-100），最近秩法
+inline double percentile(const std::vector<uint64_t>& sorted, double p) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    size_t rank = static_cast<size_t>(p / 100.0 * static_cast<double>(sorted.size()));
+    if (rank >= sorted.size()) {
+        rank = sorted.size() - 1;
+    }
+    return static_cast<double>(sorted[rank]);
+}
+
+/**
+ * @brief 运行 fn() 若干次并计时
+ *
+ * fn 每次调用完成一次操作；需要准备数据的用例在 fn 之外完成准备。
+ */
+template<typename Fn>
+Result measure(const std::string& name, const Options& options, Fn fn) {
+    Result result;
+    result.name = name;
+
+    uint64_t batch = 1;
+    uint64_t target = options.min_time_ns / 10;
+    for (;;) {
+        uint64_t start = metrics::monotonicNanos();
+        for (uint64_t i = 0; i < batch; i++) {
+            fn();
+        }
+        uint64_t elapsed = metrics::monotonicNanos() - start;
+        if (elapsed >= target || batch >= (1ULL << 32)) {
+            break;
+        }
+        batch *= 2;
+    }
+
+    int batches = options.batches < 1 ? 1 : options.batches;
+    std::vector<double> samples;
+    samples.reserve(static_cast<size_t>(batches));
+    for (int b = 0; b < batches; b++) {
+        uint64_t start = metrics::monotonicNanos();
+        for (uint64_t i = 0; i < batch; i++) {
+            fn();
+        }
+        uint64_t elapsed = metrics::monotonicNanos() - start;
+        samples.push_back(static_cast<double>(elapsed) / static_cast<double>(batch));
+        result.iterations += batch;
+    }
+    std::sort(samples.begin(), samples.end());
+    result.ns_per_op = samples[samples.size() / 2];
+    result.min_ns_per_op = samples.front();
+    std::cerr << "  " << name << ": " << result.ns_per_op << " ns/op" << std::endl;
+    return result;
+}
+
+// 全部结果的 JSON 报告
+inline std::string report(const std::vector<Result>& results, const std::string& version) {
+    std::string out;
+    json::Writer writer(out);
+    writer.beginObject();
+    writer.key("version");
+    writer.string(version);
+    writer.key("results");
+    writer.beginArray();
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result& result = results[i];
+        writer.beginObject();
+        writer.key("name");
+        writer.string(result.name);
+        writer.key("iterations");
+        writer.uinteger(result.iterations);
+        writer.key("ns_per_op");
+        writer.number(result.ns_per_op);
+        writer.key("min_ns_per_op");
+        writer.number(result.min_ns_per_op);
+        writer.key("ops_per_sec");
+        writer.number(result.ns_per_op > 0.0 ? 1e9 / result.ns_per_op : 0.0);
+        for (size_t j = 0; j < result.extra.size(); j++) {
+            writer.key(result.extra[j].first);
+            writer.number(result.extra[j].second);
+        }
+        writer.endObject();
+    }
+    writer.endArray();
+    writer.endObject();
+    out.push_back('\n');
+    return out;
+}
+
+} // namespace bench
+} // namespace uvapi
+
+#endif // UVAPI_BENCH_HARNESS_H
@@ -0,0 +1,819 @@
+/**
+ * @file uvapi_bench.cpp
+ * @brief 可复现的性能基准：路由分发、参数验证、JSON、multipart、缓存、指标与端到端延迟
+ *
+ * 用法：uvapi_bench [--filter 子串] [--min-time 毫秒] [--output 文件]
+ *                   [--requests N] [--connections N] [--port N] [--no-e2e]
+ *
+ * JSON 结果写到 stdout（或 --output 指定的文件），进度写到 stderr。
+ * 端到端用例在后台线程启动服务器，本进程内的 libuv 客户端经回环地址发起请求，
+ * 每个连接同一时刻只有一个请求在途，延迟为写出请求到收齐响应的时间。
+ */
+
+#include "bench_harness.h"
+#include "../include/framework.h"
+#include "../include/multipart.h"
+#include "../include/query_string.h"
+#include "../include/response_cache.h"
+#include "../include/static_schema.h"
+#include "../include/tracing.h"
+#include "../include/version.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <vector>
+#include <mutex>
+#include <thread>
+
+using namespace uvapi;
+using namespace uvapi::restful;
+
+namespace {
+
+// ========== 路由与验证 ==========
+
+struct Order {
+    std::string id;
+    std::string customer;
+    int quantity;
+    double price;
+    bool paid;
+
+    Order() : quantity(0), price(0.0), paid(false) {}
+};
+
+class OrderSchema : public DslBodySchema<Order> {
+public:
+    void define() override {
+        this->field(string("id", offsetof(Order, id)).required().length(1, 64));
+        this->field(string("customer", offsetof(Order, customer)).required());
+        this->field(integer("quantity", offsetof(Order, quantity)).required().range(1, 1000));
+        this->field(number("price", offsetof(Order, price)).required());
+        this->field(boolean("paid", offsetof(Order, paid)).optional());
+    }
+};
+
+// 同一结构的编译期 Schema（UVAPI_SCHEMA），与 OrderSchema 对比
+struct StaticOrder {
+    std::string id;
+    std::string customer;
+    int quantity;
+    double price;
+    bool paid;
+
+    StaticOrder() : quantity(0), price(0.0), paid(false) {}
+};
+
+UVAPI_SCHEMA(StaticOrder,
+    UVAPI_FIELD(id).required().length(1, 64),
+    UVAPI_FIELD(customer).required(),
+    UVAPI_FIELD(quantity).required().range(1, 1000),
+    UVAPI_FIELD(price).required(),
+    UVAPI_FIELD(paid));
+
+// 遥测上报：大数值数组
+struct Telemetry {
+    std::string device;
+    std::vector<int64_t> timestamps;
+    std::vector<double> samples;
+};
+
+class TelemetrySchema : public DslBodySchema<Telemetry> {
+public:
+    void define() override {
+        this->field(string("device", offsetof(Telemetry, device)).required());
+        this->field(int64Array("timestamps", offsetof(Telemetry, timestamps)).required());
+        this->field(numberArray("samples", offsetof(Telemetry, samples)).required());
+    }
+};
+
+HttpResponse okJson(const HttpRequest&) {
+    return HttpResponse(200).json("{\"status\":\"ok\"}");
+}
+
+// 约 50 条路由，接近中小型服务的路由表
+void registerRoutes(Api& api) {
+    static const char* const kResources[] = {
+        "users", "orders", "products", "invoices", "payments", "shipments", "reviews", "carts"
+    };
+    for (size_t i = 0; i < sizeof(kResources) / sizeof(kResources[0]); i++) {
+        std::string base = std::string("/api/v1/") + kResources[i];
+        api.get(base).handler(okJson).register_();
+        api.post(base).handler(okJson).register_();
+        api.get(base + "/:id").handler(okJson).register_();
+        api.put(base + "/:id").handler(okJson).register_();
+        api.delete_(base + "/:id").handler(okJson).register_();
+        api.get(base + "/:id/items/:item").handler(okJson).register_();
+    }
+    api.get("/bench/json").handler(okJson).register_();
+    api.get("/bench/search")
+        .query("page", [](ParamBuilder& p) { p.asInt().range(1, 1000).defaultValue(1); })
+        .query("limit", [](ParamBuilder& p) { p.asInt().range(1, 100).defaultValue(20); })
+        .query("sort", [](ParamBuilder& p) { p.enum_({"name", "created_at", "price"}).defaultValue(std::string("name")); })
+        .handler(okJson)
+        .register_();
+}
+
+// ========== 微基准 ==========
+
+void benchRouting(const bench::Options& options, std::vector<bench::Result>& results) {
+    uv_loop_t loop;
+    uv_loop_init(&loop);
+    {
+        Api api(&loop);
+        registerRoutes(api);
+        server::Server* server = api.getServer();
+
+        if (options.selected("router/static_match")) {
+            results.push_back(bench::measure("router/static_match", options, [server]() {
+                bench::keep(server->matchRoute("/api/v1/shipments", HttpMethod::GET, nullptr));
+            }));
+        }
+        if (options.selected("router/param_match")) {
+            std::map<std::string, std::string> params;
+            results.push_back(bench::measure("router/param_match", options, [server, &params]() {
+                params.clear();
+                bench::keep(server->matchRoute("/api/v1/carts/12345/items/678", HttpMethod::GET, &params));
+            }));
+        }
+        if (options.selected("router/miss")) {
+            results.push_back(bench::measure("router/miss", options, [server]() {
+                bench::keep(server->matchRoute("/api/v2/unknown/path", HttpMethod::GET, nullptr));
+            }));
+        }
+        if (options.selected("router/find_handler")) {
+            std::string path = "/api/v1/orders";
+            results.push_back(bench::measure("router/find_handler", options, [server, &path]() {
+                std::function<HttpResponse(const HttpRequest&)> handler = server->findHandler(path, HttpMethod::GET);
+                bench::keep(handler);
+            }));
+        }
+
+        // RouteBuilder::register_ 生成的验证包装（含默认值填充）加处理器
+        const std::function<HttpResponse(const HttpRequest&)>* search =
+            server->matchRoute("/bench/search", HttpMethod::GET, nullptr);
+        if (search && options.selected("validator/query_valid")) {
+            HttpRequest req;
+            req.method = HttpMethod::GET;
+            req.url_path = "/bench/search";
+            req.query_params["page"] = "3";
+            req.query_params["limit"] = "50";
+            req.query_params["sort"] = "price";
+            results.push_back(bench::measure("validator/query_valid", options, [search, &req]() {
+                HttpResponse resp = (*search)(req);
+                bench::keep(resp.status_code);
+            }));
+        }
+        if (search && options.selected("validator/query_defaults")) {
+            HttpRequest req;
+            req.method = HttpMethod::GET;
+            req.url_path = "/bench/search";
+            results.push_back(bench::measure("validator/query_defaults", options, [search, &req]() {
+                HttpResponse resp = (*search)(req);
+                bench::keep(resp.status_code);
+            }));
+        }
+        if (search && options.selected("validator/query_reject")) {
+            HttpRequest req;
+            req.method = HttpMethod::GET;
+            req.url_path = "/bench/search";
+            req.query_params["limit"] = "5000";
+            results.push_back(bench::measure("validator/query_reject", options, [search, &req]() {
+                HttpResponse resp = (*search)(req);
+                bench::keep(resp.status_code);
+            }));
+        }
+    }
+    uv_run(&loop, UV_RUN_NOWAIT);
+    uv_loop_close(&loop);
+}
+
+void benchSchema(const bench::Options& options, std::vector<bench::Result>& results) {
+    OrderSchema schema;
+    std::string json = "{\"id\":\"ord-20240101-0001\",\"customer\":\"Example Customer Ltd.\","
+                       "\"quantity\":12,\"price\":1999.95,\"paid\":true}";
+
+    if (options.selected("schema/from_json")) {
+        results.push_back(bench::measure("schema/from_json", options, [&schema, &json]() {
+            Order order;
+            bench::keep(schema.fromJson(json, &order));
+        }).add("bytes", static_cast<double>(json.size())));
+    }
+    if (options.selected("schema/parse_validate")) {
+        results.push_back(bench::measure("schema/parse_validate", options, [&schema, &json]() {
+            Order order;
+            std::string error;
+            bench::keep(schema.parseJson(json.data(), json.size(), &order, true, &error));
+        }).add("bytes", static_cast<double>(json.size())));
+    }
+    if (options.selected("schema/to_json")) {
+        Order order;
+        schema.fromJson(json, &order);
+        results.push_back(bench::measure("schema/to_json", options, [&schema, &order]() {
+            std::string out = schema.toJson(&order);
+            bench::keep(out);
+        }));
+    }
+
+    if (options.selected("schema/static_parse_validate")) {
+        results.push_back(bench::measure("schema/static_parse_validate", options, [&json]() {
+            StaticOrder order;
+            bench::keep(static_cast<bool>(parseRequest(json, order)));
+        }).add("bytes", static_cast<double>(json.size())));
+    }
+    if (options.selected("schema/static_to_json")) {
+        StaticOrder order = parseBody<StaticOrder>(json);
+        results.push_back(bench::measure("schema/static_to_json", options, [&order]() {
+            std::string out = toJson(order);
+            bench::keep(out);
+        }));
+    }
+
+    if (options.selected("schema/array_parse") || options.selected("schema/array_to_json")) {
+        TelemetrySchema telemetry_schema;
+        Telemetry telemetry;
+        telemetry.device = "sensor-0001";
+        for (int i = 0; i < 20000; i++) {
+            telemetry.timestamps.push_back(1700000000000LL + i * 250);
+            telemetry.samples.push_back(20.0 + (i % 1000) * 0.013);
+        }
+        std::string body = telemetry_schema.toJson(&telemetry);
+        if (options.selected("schema/array_parse")) {
+            results.push_back(bench::measure("schema/array_parse", options, [&telemetry_schema, &body]() {
+                Telemetry parsed;
+                std::string error;
+                bench::keep(telemetry_schema.parseJson(body.data(), body.size(), &parsed, true, &error));
+            }).add("bytes", static_cast<double>(body.size())).add("elements", 40000.0));
+        }
+        if (options.selected("schema/array_to_json")) {
+            results.push_back(bench::measure("schema/array_to_json", options, [&telemetry_schema, &telemetry]() {
+                std::string out = telemetry_schema.toJson(&telemetry);
+                bench::keep(out);
+            }).add("bytes", static_cast<double>(body.size())).add("elements", 40000.0));
+        }
+    }
+}
+
+void benchParamValue(const bench::Options& options, std::vector<bench::Result>& results) {
+    if (options.selected("param_value/int")) {
+        results.push_back(bench::measure("param_value/int", options, []() {
+            ParamValue pv("123456");
+            int value = pv;
+            bench::keep(value);
+        }));
+    }
+    if (options.selected("param_value/double")) {
+        results.push_back(bench::measure("param_value/double", options, []() {
+            ParamValue pv("1999.95");
+            double value = pv;
+            bench::keep(value);
+        }));
+    }
+    if (options.selected("param_value/bool")) {
+        results.push_back(bench::measure("param_value/bool", options, []() {
+            ParamValue pv("true");
+            bool value = pv;
+            bench::keep(value);
+        }));
+    }
+    if (options.selected("param_value/invalid_int")) {
+        results.push_back(bench::measure("param_value/invalid_int", options, []() {
+            ParamValue pv("12ab");
+            int value = pv;
+            bench::keep(value);
+        }));
+    }
+}
+
+void benchQueryString(const bench::Options& options, std::vector<bench::Result>& results) {
+    if (options.selected("query/plain")) {
+        const std::string query = "page=2&limit=20&sort=created_at&order=desc&status=active";
+        results.push_back(bench::measure("query/plain", options, [&query]() {
+            size_t total = 0;
+            query::forEachParam(query.data(), query.size(),
+                [](size_t) -> char* { return nullptr; },
+                [&total](const StringSlice& k, const StringSlice& v) { total += k.size + v.size; });
+            bench::keep(total);
+        }).add("bytes", static_cast<double>(query.size())));
+    }
+    if (options.selected("query/encoded")) {
+        const std::string query = "q=caf%C3%A9+au+lait&tag=a%2Fb&tag=c%26d&redirect=https%3A%2F%2Fexample.com%2Fx%3Fy%3D1";
+        std::vector<char> buffer;
+        results.push_back(bench::measure("query/encoded", options, [&query, &buffer]() {
+            size_t total = 0;
+            query::forEachParam(query.data(), query.size(),
+                [&buffer](size_t n) -> char* { buffer.resize(n); return buffer.data(); },
+                [&total](const StringSlice& k, const StringSlice& v) { total += k.size + v.size; });
+            bench::keep(total);
+        }).add("bytes", static_cast<double>(query.size())));
+    }
+}
+
+void benchCors(const bench::Options& options, std::vector<bench::Result>& results) {
+    CorsConfig config;
+    config.allowed_origins = "https://app.example.com, https://admin.example.com, https://*.example.net";
+    config.allow_credentials = true;
+    cors::CorsPolicy policy(config);
+    if (options.selected("cors/preflight_exact")) {
+        results.push_back(bench::measure("cors/preflight_exact", options, [&policy]() {
+            size_t count = 0;
+            const cors::CorsPolicy::Rendered* rendered = policy.match("https://admin.example.com");
+            if (rendered && policy.allowsMethod("POST")) {
+                cors::CorsPolicy::emit(*rendered, true, "https://admin.example.com",
+                                       [&count](const char*, const char*) { ++count; });
+            }
+            bench::keep(count);
+        }));
+    }
+    if (options.selected("cors/suffix_match")) {
+        results.push_back(bench::measure("cors/suffix_match", options, [&policy]() {
+            bench::keep(policy.match("https://tenant-42.example.net") != nullptr);
+        }));
+    }
+}
+
+// 每个请求的追踪开销：未采样（只有慢请求阈值）与采样写入缓冲区
+void benchTracing(const bench::Options& options, std::vector<bench::Result>& results) {
+    if (options.selected("trace/slow_threshold_only")) {
+        trace::Tracer tracer(trace::TracePolicy().sampleRate(0).slowThreshold(std::chrono::seconds(10)));
+        results.push_back(bench::measure("trace/slow_threshold_only", options, [&tracer]() {
+            trace::RequestSpan span(&tracer);
+            trace::noteResponse(200, 0);
+            bench::keep(span.recording());
+        }));
+    }
+    if (options.selected("trace/sampled")) {
+        trace::Tracer tracer(trace::TracePolicy().sampleRate(1.0).drainInterval(std::chrono::milliseconds(10)));
+        tracer.start();
+        std::string pattern("/users/:id");
+        results.push_back(bench::measure("trace/sampled", options, [&tracer, &pattern]() {
+            trace::RequestSpan span(&tracer);
+            span.request("GET", "/users/42", 0);
+            span.route(1, &pattern);
+            trace::noteResponse(200, 64);
+        }));
+        tracer.stop();
+    }
+}
+
+std::string multipartBody(size_t file_size) {
+    std::string body;
+    body += "--BenchBoundary7MA4YWxk\r\n";
+    body += "Content-Disposition: form-data; name=\"title\"\r\n\r\n";
+    body += "quarterly report\r\n";
+    body += "--BenchBoundary7MA4YWxk\r\n";
+    body += "Content-Disposition: form-data; name=\"owner\"\r\n\r\n";
+    body += "finance\r\n";
+    body += "--BenchBoundary7MA4YWxk\r\n";
+    body += "Content-Disposition: form-data; name=\"file\"; filename=\"report.bin\"\r\n";
+    body += "Content-Type: application/octet-stream\r\n\r\n";
+    for (size_t i = 0; i < file_size; i++) {
+        body.push_back(static_cast<char>('a' + i % 26));
+    }
+    body += "\r\n--BenchBoundary7MA4YWxk--\r\n";
+    return body;
+}
+
+void benchMultipart(const bench::Options& options, std::vector<bench::Result>& results) {
+    static const size_t kSizes[] = { 1024, 64 * 1024, 1024 * 1024 };
+    static const char* const kNames[] = { "multipart/parse_1k", "multipart/parse_64k", "multipart/parse_1m" };
+    for (size_t i = 0; i < sizeof(kSizes) / sizeof(kSizes[0]); i++) {
+        if (!options.selected(kNames[i])) {
+            continue;
+        }
+        std::string body = multipartBody(kSizes[i]);
+        bench::Result result = bench::measure(kNames[i], options, [&body]() {
+            MultipartParser parser("BenchBoundary7MA4YWxk");
+            bench::keep(parser.parse(body.data(), body.size()));
+        });
+        result.add("bytes", static_cast<double>(body.size()));
+        result.add("mb_per_sec", result.ns_per_op > 0.0 ? static_cast<double>(body.size()) / result.ns_per_op * 1e3 : 0.0);
+        results.push_back(result);
+    }
+}
+
+void benchCache(const bench::Options& options, std::vector<bench::Result>& results) {
+    ShardedResponseCache<std::string> cache(10000, 64 * 1024 * 1024);
+    std::vector<std::string> keys;
+    for (int i = 0; i < 1000; i++) {
+        keys.push_back("/api/v1/products/" + std::to_string(i));
+        cache.put(keys.back(), std::string(512, 'x'));
+    }
+
+    if (options.selected("cache/sharded_hit")) {
+        size_t next = 0;
+        results.push_back(bench::measure("cache/sharded_hit", options, [&cache, &keys, &next]() {
+            bench::keep(cache.find(keys[next++ % keys.size()]));
+        }));
+    }
+    if (options.selected("cache/sharded_miss")) {
+        std::string missing = "/api/v1/products/missing";
+        results.push_back(bench::measure("cache/sharded_miss", options, [&cache, &missing]() {
+            bench::keep(cache.find(missing));
+        }));
+    }
+    if (options.selected("cache/sharded_put")) {
+        size_t next = 0;
+        std::string body(512, 'y');
+        results.push_back(bench::measure("cache/sharded_put", options, [&cache, &keys, &next, &body]() {
+            bench::keep(cache.put(keys[next++ % keys.size()], body));
+        }));
+    }
+    if (options.selected("cache/simple_get")) {
+        ResponseCache<std::string> simple(1000);
+        for (size_t i = 0; i < keys.size(); i++) {
+            simple.put(keys[i], std::string(512, 'x'));
+        }
+        size_t next = 0;
+        std::string out;
+        results.push_back(bench::measure("cache/simple_get", options, [&simple, &keys, &next, &out]() {
+            bench::keep(simple.get(keys[next++ % keys.size()], out));
+        }));
+    }
+}
+
+void benchMetrics(const bench::Options& options, std::vector<bench::Result>& results) {
+    metrics::Counter counter("bench_requests_total", "Benchmark counter");
+    metrics::Gauge gauge("bench_in_flight", "Benchmark gauge");
+    metrics::Histogram histogram("bench_latency_seconds", "Benchmark histogram",
+                                 std::vector<double>{0.001, 0.005, 0.01, 0.05, 0.1, 0.5, 1.0});
+
+    if (options.selected("metrics/counter_increment")) {
+        results.push_back(bench::measure("metrics/counter_increment", options, [&counter]() {
+            counter.increment();
+        }));
+    }
+    if (options.selected("metrics/gauge_increment")) {
+        results.push_back(bench::measure("metrics/gauge_increment", options, [&gauge]() {
+            gauge.increment();
+        }));
+    }
+    if (options.selected("metrics/histogram_observe")) {
+        double value = 0.0;
+        results.push_back(bench::measure("metrics/histogram_observe", options, [&histogram, &value]() {
+            value = value > 0.9 ? 0.0 : value + 0.0137;
+            histogram.observe(value);
+        }));
+    }
+    bench::keep(counter.value());
+}
+
+// ========== 端到端（回环） ==========
+
+struct E2eConfig {
+    uint64_t requests;
+    int connections;
+    int port;
+    std::string path;
+
+    E2eConfig() : requests(100000), connections(16), port(18089), path("/bench/json") {}
+};
+
+// 后台线程中的服务器
+class LoopbackServer {
+public:
+    LoopbackServer() : server_(nullptr), state_(0) {}
+
+    bool start(int port) {
+        thread_ = std::thread(&LoopbackServer::run, this, port);
+        std::unique_lock<std::mutex> lock(mutex_);
+        ready_.wait(lock, [this]() { return state_ != 0; });
+        return state_ > 0;
+    }
+
+    void stop() {
+        if (thread_.joinable()) {
+            if (state_ > 0) {
+                uv_async_send(&stop_);
+            }
+            thread_.join();
+        }
+    }
+
+private:
+    uv_loop_t loop_;
+    uv_async_t stop_;
+    server::Server* server_;
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    int state_;  // 0 启动中，1 已监听，-1 失败
+
+    void signal(int state) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        state_ = state;
+        ready_.notify_all();
+    }
+
+    static void onStop(uv_async_t* handle) {
+        LoopbackServer* self = static_cast<LoopbackServer*>(handle->data);
+        self->server_->stop();
+        uv_close(reinterpret_cast<uv_handle_t*>(handle), nullptr);
+        uv_stop(handle->loop);
+    }
+
+    static void closeHandle(uv_handle_t* handle, void*) {
+        if (!uv_is_closing(handle)) {
+            uv_close(handle, nullptr);
+        }
+    }
+
+    void run(int port) {
+        uv_loop_init(&loop_);
+        {
+            Api api(&loop_);
+            registerRoutes(api);
+            server_ = api.getServer();
+            uv_async_init(&loop_, &stop_, onStop);
+            stop_.data = this;
+            if (!server_->listen("127.0.0.1", port)) {
+                uv_close(reinterpret_cast<uv_handle_t*>(&stop_), nullptr);
+                signal(-1);
+            } else {
+                signal(1);
+                uv_run(&loop_, UV_RUN_DEFAULT);
+            }
+        }
+        uv_walk(&loop_, closeHandle, nullptr);
+        uv_run(&loop_, UV_RUN_DEFAULT);
+        uv_loop_close(&loop_);
+    }
+};
+
+class LoadGenerator;
+
+struct LoadClient {
+    uv_tcp_t tcp;
+    uv_connect_t connect;
+    uv_write_t write;
+    LoadGenerator* generator;
+    std::string buffer;
+    uint64_t sent_ns;
+};
+
+// 同一线程内的 libuv 客户端：每个连接收齐一个响应后立即发出下一个请求
+class LoadGenerator {
+public:
+    explicit LoadGenerator(const E2eConfig& config)
+        : config_(config), issued_(0), completed_(0), errors_(0), warmup_(0), open_(0) {
+        request_ = "GET " + config.path + " HTTP/1.1\r\nHost: 127.0.0.1\r\nUser-Agent: uvapi_bench\r\n\r\n";
+        warmup_ = config.requests / 10 < 1000 ? config.requests / 10 : 1000;
+    }
+
+    bool run() {
+        uv_loop_init(&loop_);
+        struct sockaddr_in addr;
+        uv_ip4_addr("127.0.0.1", config_.port, &addr);
+        clients_.resize(static_cast<size_t>(config_.connections < 1 ? 1 : config_.connections));
+        latencies_.reserve(static_cast<size_t>(config_.requests));
+        for (size_t i = 0; i < clients_.size(); i++) {
+            LoadClient* client = new LoadClient();
+            client->generator = this;
+            client->sent_ns = 0;
+            clients_[i] = client;
+            uv_tcp_init(&loop_, &client->tcp);
+            uv_tcp_nodelay(&client->tcp, 1);
+            client->tcp.data = client;
+            client->connect.data = client;
+            open_++;
+            if (uv_tcp_connect(&client->connect, &client->tcp,
+                               reinterpret_cast<const struct sockaddr*>(&addr), onConnect) != 0) {
+                errors_++;
+                closeClient(client);
+            }
+        }
+        start_ns_ = metrics::monotonicNanos();
+        uv_run(&loop_, UV_RUN_DEFAULT);
+        end_ns_ = metrics::monotonicNanos();
+        uv_loop_close(&loop_);
+        for (size_t i = 0; i < clients_.size(); i++) {
+            delete clients_[i];
+        }
+        clients_.clear();
+        std::sort(latencies_.begin(), latencies_.end());
+        return completed_ > 0;
+    }
+
+    bench::Result result(const std::string& name) const {
+        bench::Result result;
+        result.name = name;
+        result.iterations = completed_;
+        double elapsed = static_cast<double>(end_ns_ - start_ns_);
+        result.ns_per_op = completed_ > 0 ? elapsed / static_cast<double>(completed_) : 0.0;
+        result.min_ns_per_op = result.ns_per_op;
+        result.add("connections", static_cast<double>(config_.connections));
+        result.add("requests_per_sec", elapsed > 0.0 ? static_cast<double>(completed_) * 1e9 / elapsed : 0.0);
+        result.add("errors", static_cast<double>(errors_));
+        result.add("p50_us", bench::percentile(latencies_, 50.0) / 1e3);
+        result.add("p90_us", bench::percentile(latencies_, 90.0) / 1e3);
+        result.add("p99_us", bench::percentile(latencies_, 99.0) / 1e3);
+        result.add("p999_us", bench::percentile(latencies_, 99.9) / 1e3);
+        result.add("max_us", latencies_.empty() ? 0.0 : static_cast<double>(latencies_.back()) / 1e3);
+        return result;
+    }
+
+private:
+    E2eConfig config_;
+    uv_loop_t loop_;
+    std::string request_;
+    std::vector<LoadClient*> clients_;
+    std::vector<uint64_t> latencies_;
+    uint64_t issued_;
+    uint64_t completed_;
+    uint64_t errors_;
+    uint64_t warmup_;  // 前若干个响应不计入延迟分布
+    size_t open_;
+    uint64_t start_ns_;
+    uint64_t end_ns_;
+
+    static void onAlloc(uv_handle_t*, size_t suggested, uv_buf_t* buf) {
+        static thread_local char storage[64 * 1024];
+        (void)suggested;
+        *buf = uv_buf_init(storage, sizeof(storage));
+    }
+
+    static void onClosed(uv_handle_t* handle) {
+        LoadClient* client = static_cast<LoadClient*>(handle->data);
+        client->generator->open_--;
+    }
+
+    void closeClient(LoadClient* client) {
+        uv_handle_t* handle = reinterpret_cast<uv_handle_t*>(&client->tcp);
+        if (!uv_is_closing(handle)) {
+            uv_close(handle, onClosed);
+        }
+    }
+
+    static void onConnect(uv_connect_t* req, int status) {
+        LoadClient* client = static_cast<LoadClient*>(req->data);
+        LoadGenerator* self = client->generator;
+        if (status != 0) {
+            self->errors_++;
+            self->closeClient(client);
+            return;
+        }
+        uv_read_start(reinterpret_cast<uv_stream_t*>(&client->tcp), onAlloc, onRead);
+        self->sendNext(client);
+    }
+
+    void sendNext(LoadClient* client) {
+        if (issued_ >= config_.requests) {
+            closeClient(client);
+            return;
+        }
+        issued_++;
+        client->sent_ns = metrics::monotonicNanos();
+        uv_buf_t buf = uv_buf_init(const_cast<char*>(request_.data()), static_cast<unsigned int>(request_.size()));
+        client->write.data = client;
+        if (uv_write(&client->write, reinterpret_cast<uv_stream_t*>(&client->tcp), &buf, 1, onWritten) != 0) {
+            errors_++;
+            closeClient(client);
+        }
+    }
+
+    static void onWritten(uv_write_t* req, int status) {
+        if (status != 0) {
+            LoadClient* client = static_cast<LoadClient*>(req->data);
+            client->generator->errors_++;
+            client->generator->closeClient(client);
+        }
+    }
+
+    // 已收齐一个响应时返回其长度，否则返回 0
+    static size_t completeResponse(const std::string& buffer) {
+        size_t header_end = buffer.find("\r\n\r\n");
+        if (header_end == std::string::npos) {
+            return 0;
+        }
+        size_t length = 0;
+        size_t line = buffer.find("\r\n") + 2;
+        while (line < header_end) {
+            size_t next = buffer.find("\r\n", line);
+            if (next - line > 15 && StringSlice(buffer.data() + line, 15).equalsIgnoreCase("Content-Length:", 15)) {
+                length = static_cast<size_t>(std::strtoull(buffer.c_str() + line + 15, nullptr, 10));
+            }
+            line = next + 2;
+        }
+        size_t total = header_end + 4 + length;
+        return buffer.size() >= total ? total : 0;
+    }
+
+    static void onRead(uv_stream_t* stream, ssize_t nread, const uv_buf_t* buf) {
+        LoadClient* client = static_cast<LoadClient*>(stream->data);
+        LoadGenerator* self = client->generator;
+        if (nread < 0) {
+            // 请求在途时连接被关闭
+            if (client->sent_ns != 0) {
+                self->errors_++;
+            }
+            self->closeClient(client);
+            return;
+        }
+        client->buffer.append(buf->base, static_cast<size_t>(nread));
+        size_t size = completeResponse(client->buffer);
+        if (size == 0) {
+            return;
+        }
+        bool ok = client->buffer.compare(0, 12, "HTTP/1.1 200") == 0;
+        client->buffer.erase(0, size);
+        uint64_t latency = metrics::monotonicNanos() - client->sent_ns;
+        client->sent_ns = 0;
+        if (!ok) {
+            self->errors_++;
+        }
+        self->completed_++;
+        if (self->completed_ > self->warmup_) {
+            self->latencies_.push_back(latency);
+        }
+        self->sendNext(client);
+    }
+};
+
+void benchEndToEnd(const E2eConfig& config, std::vector<bench::Result>& results) {
+    LoopbackServer server;
+    if (!server.start(config.port)) {
+        std::cerr << "e2e: failed to listen on 127.0.0.1:" << config.port << ", skipped" << std::endl;
+        server.stop();
+        return;
+    }
+    LoadGenerator generator(config);
+    bool ok = generator.run();
+    server.stop();
+    if (!ok) {
+        std::cerr << "e2e: no responses received" << std::endl;
+        return;
+    }
+    bench::Result result = generator.result("e2e/get_json");
+    std::cerr << "  e2e/get_json: " << result.ns_per_op << " ns/request" << std::endl;
+    results.push_back(result);
+}
+
+void usage() {
+    std::cerr << "usage: uvapi_bench [--filter NAME] [--min-time MS] [--output FILE]\n"
+                 "                   [--requests N] [--connections N] [--port N] [--no-e2e]" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    bench::Options options;
+    E2eConfig e2e;
+    bool run_e2e = true;
+    std::string output;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--filter" && has_value) {
+            options.filter = argv[++i];
+        } else if (arg == "--min-time" && has_value) {
+            options.min_time_ns = std::strtoull(argv[++i], nullptr, 10) * 1000000ULL;
+        } else if (arg == "--output" && has_value) {
+            output = argv[++i];
+        } else if (arg == "--requests" && has_value) {
+            e2e.requests = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--connections" && has_value) {
+            e2e.connections = std::atoi(argv[++i]);
+        } else if (arg == "--port" && has_value) {
+            e2e.port = std::atoi(argv[++i]);
+        } else if (arg == "--no-e2e") {
+            run_e2e = false;
+        } else {
+            usage();
+            return 2;
+        }
+    }
+
+    std::vector<bench::Result> results;
+    std::cerr << "uvapi_bench " << UVAPI_VERSION_STRING << std::endl;
+    benchRouting(options, results);
+    benchSchema(options, results);
+    benchParamValue(options, results);
+    benchQueryString(options, results);
+    benchCors(options, results);
+    benchTracing(options, results);
+    benchMultipart(options, results);
+    benchCache(options, results);
+    benchMetrics(options, results);
+    if (run_e2e && options.selected("e2e/get_json")) {
+        benchEndToEnd(e2e, results);
+    }
+
+    std::string json = bench::report(results, UVAPI_VERSION_STRING);
+    if (output.empty()) {
+        std::fwrite(json.data(), 1, json.size(), stdout);
+        return 0;
+    }
+    std::ofstream file(output.c_str(), std::ios::binary);
+    if (!file) {
+        std::cerr << "cannot write " << output << std::endl;
+        return 1;
+    }
+    file << json;
+    return 0;
+}
@@ -1,6 +1,8 @@
 #include "../include/framework.h"
+#include "../include/server_cluster.h"
 #include <iostream>
 #include <atomic>
+#include <cstdlib>
 
 using namespace uvapi;
 using namespace restful;
@@ -8,7 +10,10 @@ using namespace restful;
 // 请求计数器
 std::atomic<uint64_t> request_count{0};
 
-int main() {
+int main(int argc, char* argv[]) {
+    // 可选参数：工作线程数（1 = 单循环，0 = CPU 核数）
+    int workers = argc > 1 ? std::atoi(argv[1]) : 1;
+
     std::cout << "UVAPI 性能测试服务器 (轻量级优化版)" << std::endl;
     std::cout << "===================" << std::endl;
     
@@ -68,12 +73,25 @@ int main() {
     std::cout << "  wrk -t1 -c10 -d30s http://localhost:8080/" << std::endl;
     std::cout << "  wrk -t4 -c50 -d30s http://localhost:8080/" << std::endl;
     
-    if (!server.listen("0.0.0.0", 8080)) {
-        std::cerr << "启动服务器失败" << std::endl;
-        return 1;
-    }
+    std::cout << "\n多核模式: " << argv[0] << " <workers>" << std::endl;
     
-    uv_run(loop, UV_RUN_DEFAULT);
+    if (workers != 1) {
+        // 路由已注册在 server 上，集群为每个工作线程复制一份并以 SO_REUSEPORT 监听
+        server::ServerCluster cluster(server, workers);
+        if (!cluster.listen("0.0.0.0", 8080)) {
+            std::cerr << "启动服务器失败" << std::endl;
+            return 1;
+        }
+        std::cout << "工作线程数: " << cluster.workerCount() << std::endl;
+        cluster.join();
+    } else {
+        if (!server.listen("0.0.0.0", 8080)) {
+            std::cerr << "启动服务器失败" << std::endl;
+            return 1;
+        }
+        
+        uv_run(loop, UV_RUN_DEFAULT);
+    }
     uv_loop_close(loop);
     
     std::cout << "\n总请求数: " << request_count.load() << std::endl;
@@ -38,17 +38,15 @@ int main(int argc, char* argv[]) {
     // ========== 启用静态文件服务 ==========
     std::cout << "1. 启用静态文件服务..." << std::endl;
     
-    // 方法 1: 使用默认配置
-    // bool success = api.getServer()->enableStaticFiles("./public", "/static");
-    
-    // 方法 2: 自定义配置（先获取 Server 实例）
     auto server = api.getServer();
     
-    // 启用静态文件服务
-    bool success = server->enableStaticFiles(
-        "./public",    // 根目录
+    // 未匹配路由的 GET / HEAD 请求按前缀映射到根目录
+    bool success = server->serveStatic(
         "/static",     // URL 前缀
-        true           // 启用缓存
+        "./public",    // 根目录
+        uvapi::server::StaticOptions()
+            .cacheControl("public, max-age=3600")
+            .fallback("index.html")   // 单页应用：无扩展名的路径回退到 index.html
     );
     
     if (!success) {
@@ -59,18 +57,13 @@ int main(int argc, char* argv[]) {
     std::cout << "   ✓ 静态文件服务已启用" << std::endl;
     std::cout << "   - 根目录: ./public" << std::endl;
     std::cout << "   - URL 前缀: /static" << std::endl;
-    std::cout << "   - 缓存: 已启用" << std::endl << std::endl;
+    std::cout << "   - 预压缩: 自动选择 .br / .gz 兄弟文件" << std::endl << std::endl;
     
     // ========== 预热缓存 ==========
     std::cout << "2. 预热缓存..." << std::endl;
     
-    // 预热单个文件
-    server->prewarmCache("index.html");
-    
-    // 预热整个目录（最多 100 个文件）
-    server->prewarmDirectory("css", 100);
-    server->prewarmDirectory("js", 100);
-    server->prewarmDirectory("images", 100);
+    // 预先解析并映射常用文件，首个请求不再访问文件系统
+    server->prewarmStatic("/static", "index.html");
     
     std::cout << "   ✓ 缓存预热完成" << std::endl << std::endl;
     
@@ -140,20 +133,18 @@ int main(int argc, char* argv[]) {
  *    - http://localhost:8080/static/js/script.js
  * 
  * 3. 缓存预热：
- *    - 在应用启动时预热常用文件
- *    - 预热整个目录以加载多个文件
- *    - 可以设置最大文件数限制
+ *    - 在应用启动时用 prewarmStatic() 预热常用文件
  * 
  * 4. 缓存管理：
- *    - 定期清理缓存：server->clearStaticCache()
- *    - 动态调整缓存大小：server->setStaticCacheConfig(...)
- *    - 监控缓存命中率（需要自定义实现）
+ *    - 文件元数据和小文件映射常驻缓存，按字节数 LRU 淘汰（StaticOptions::maxCacheBytes）
+ *    - 目录监视器在文件变化时立即失效，另按 revalidateEvery() 兜底重新 stat
+ *    - 替换文件请用“写入临时文件再 rename”，不要原地截断正在映射的文件
  * 
  * 5. 性能优化：
- *    - 启用 sendfile 零拷贝传输（默认启用）
- *    - 使用 ETag 和 Last-Modified 头（默认启用）
- *    - 设置合理的缓存大小和过期时间
- *    - 预热常用文件以减少首次访问延迟
+ *    - 文件内容通过 mmap 映射，请求时不读文件、不复制到 std::string
+ *    - 强 ETag 和 Last-Modified（默认启用），命中时返回 304
+ *    - 构建时生成 app.js.br / app.js.gz，按 Accept-Encoding 直接返回预压缩内容
+ *    - 支持 Range 请求（断点续传、视频拖动）
  * 
  * 6. 安全注意事项：
  *    - 确保根目录权限正确
@@ -80,7 +80,7 @@ HttpResponse handleUpload(const HttpRequest& req) {
     
     char* json_str = cJSON_Print(root);
     std::string result(json_str);
-    free(json_str);
+    cJSON_free(json_str);
     cJSON_Delete(root);
 
     HttpResponse resp(200);
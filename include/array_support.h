@@ -1,17 +1,29 @@
 /**
  * @file array_support.h
  * @brief 数组类型序列化/反序列化支持
- * 
- * 为 UVAPI DSL 添加完整的数组类型支持
+ *
+ * 为 UVAPI DSL 添加完整的数组类型支持：
+ * - readArray / writeArray：std::vector<int / int64_t / double / bool / std::string> 与 JSON 数组
+ *   之间的批量转换，直接基于 json::Reader / json::Writer，不经过 cJSON 节点。
+ *   数值数组先预数元素个数再 reserve()，逐元素读取时不做类型分派；写出时整段追加到输出缓冲区
+ * - DslBodySchema 的 stringArray() / intArray() / int64Array() / numberArray() / boolArray()
+ *   字段通过这里读写
+ *
+ * 所有函数都通过返回值报告错误，不抛异常。
  */
 
 #ifndef ARRAY_SUPPORT_H
 #define ARRAY_SUPPORT_H
 
+#include "json_stream.h"
+#include "json_writer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
 #include <vector>
 #include <string>
-#include <cJSON.h>
-#include <stdexcept>
 
 namespace uvapi {
 
@@ -28,168 +40,193 @@ enum class ArrayElementType {
 // 数组元素序列化/反序列化辅助函数
 namespace array_utils {
 
-// 从 JSON 数组元素转换为指定类型
-template<typename T>
-T fromJsonElement(const cJSON* json);
+// 数组读取结果
+enum class ArrayError {
+    NONE,
+    NOT_ARRAY,     // 值不是数组
+    WRONG_TYPE,    // 元素类型不符（该元素尚未消费）
+    NOT_INTEGER,   // 整数数组中出现小数（该元素已消费）
+    OUT_OF_RANGE,  // 整数元素超出目标类型范围（该元素已消费）
+    SYNTAX         // JSON 语法错误（详情见 Reader::describeError()）
+};
 
-// 从指定类型转换为 JSON 数组元素
-template<typename T>
-cJSON* toJsonElement(const T& value);
+// ========== 流式批量读写 ==========
 
-// 字符串特化
-template<>
-inline std::string fromJsonElement<std::string>(const cJSON* json) {
-    if (!cJSON_IsString(json)) {
-        throw std::runtime_error("Expected string element");
+// 单个元素的读取
+template<typename I>
+inline ArrayError readIntegerElement(json::Reader& reader, I& out) {
+    char c = reader.peek();
+    if (c != '-' && (c < '0' || c > '9')) {
+        return ArrayError::WRONG_TYPE;
     }
-    return json->valuestring;
-}
-
-template<>
-inline cJSON* toJsonElement<std::string>(const std::string& value) {
-    return cJSON_CreateString(value.c_str());
-}
-
-// int 特化
-template<>
-inline int fromJsonElement<int>(const cJSON* json) {
-    if (!cJSON_IsNumber(json)) {
-        throw std::runtime_error("Expected number element");
+    json::Number num;
+    if (!reader.readNumber(num)) {
+        return ArrayError::SYNTAX;
     }
-    return static_cast<int>(json->valuedouble);
-}
-
-template<>
-inline cJSON* toJsonElement<int>(const int& value) {
-    return cJSON_CreateNumber(value);
-}
-
-// int64_t 特化
-template<>
-inline int64_t fromJsonElement<int64_t>(const cJSON* json) {
-    if (!cJSON_IsNumber(json)) {
-        throw std::runtime_error("Expected number element");
+    typedef std::numeric_limits<I> limits;
+    if (num.is_integer) {
+        if (num.integer < static_cast<int64_t>(limits::min()) || num.integer > static_cast<int64_t>(limits::max())) {
+            return ArrayError::OUT_OF_RANGE;
+        }
+        out = static_cast<I>(num.integer);
+        return ArrayError::NONE;
     }
-    return static_cast<int64_t>(json->valuedouble);
-}
-
-template<>
-inline cJSON* toJsonElement<int64_t>(const int64_t& value) {
-    return cJSON_CreateNumber(static_cast<double>(value));
-}
-
-// float 特化
-template<>
-inline float fromJsonElement<float>(const cJSON* json) {
-    if (!cJSON_IsNumber(json)) {
-        throw std::runtime_error("Expected number element");
+    // 与字段读取一致：1e3 这类整值浮点数也按整数接受
+    if (num.value != std::floor(num.value)) {
+        return ArrayError::NOT_INTEGER;
+    }
+    if (num.value < static_cast<double>(limits::min()) || num.value >= static_cast<double>(limits::max()) + 1.0) {
+        return ArrayError::OUT_OF_RANGE;
     }
-    return static_cast<float>(json->valuedouble);
+    out = static_cast<I>(num.value);
+    return ArrayError::NONE;
 }
 
-template<>
-inline cJSON* toJsonElement<float>(const float& value) {
-    return cJSON_CreateNumber(value);
+inline ArrayError readElement(json::Reader& reader, int& out) {
+    return readIntegerElement<int>(reader, out);
 }
 
-// double 特化
-template<>
-inline double fromJsonElement<double>(const cJSON* json) {
-    if (!cJSON_IsNumber(json)) {
-        throw std::runtime_error("Expected number element");
-    }
-    return json->valuedouble;
+inline ArrayError readElement(json::Reader& reader, int64_t& out) {
+    return readIntegerElement<int64_t>(reader, out);
 }
 
-template<>
-inline cJSON* toJsonElement<double>(const double& value) {
-    return cJSON_CreateNumber(value);
+inline ArrayError readElement(json::Reader& reader, double& out) {
+    char c = reader.peek();
+    if (c != '-' && (c < '0' || c > '9')) {
+        return ArrayError::WRONG_TYPE;
+    }
+    json::Number num;
+    if (!reader.readNumber(num)) {
+        return ArrayError::SYNTAX;
+    }
+    out = num.value;
+    return ArrayError::NONE;
 }
 
-// bool 特化
-template<>
-inline bool fromJsonElement<bool>(const cJSON* json) {
-    if (!cJSON_IsBool(json)) {
-        throw std::runtime_error("Expected boolean element");
+inline ArrayError readElement(json::Reader& reader, bool& out) {
+    char c = reader.peek();
+    if (c != 't' && c != 'f') {
+        return ArrayError::WRONG_TYPE;
     }
-    return cJSON_IsTrue(json);
+    return reader.readBool(out) ? ArrayError::NONE : ArrayError::SYNTAX;
 }
 
-template<>
-inline cJSON* toJsonElement<bool>(const bool& value) {
-    return cJSON_CreateBool(value);
+inline ArrayError readElement(json::Reader& reader, std::string& out) {
+    if (reader.peek() != '"') {
+        return ArrayError::WRONG_TYPE;
+    }
+    return reader.readString(out) ? ArrayError::NONE : ArrayError::SYNTAX;
 }
 
-// 通用数组序列化函数
+/**
+ * @brief 读取 JSON 数组到 vec（覆盖原有内容，复用其容量）
+ *
+ * 读取器应位于数组的 '['。出错时 vec 保留已读取的元素，error_index 为出错元素的下标。
+ */
 template<typename T>
-cJSON* serializeArray(const std::vector<T>& vec) {
-    cJSON* array = cJSON_CreateArray();
-    if (!array) {
-        return nullptr;
-    }
-    
-    for (const auto& item : vec) {
-        cJSON* element = toJsonElement(item);
-        if (!element) {
-            cJSON_Delete(array);
-            return nullptr;
+ArrayError readArray(json::Reader& reader, std::vector<T>& vec, size_t* error_index = nullptr) {
+    if (reader.peek() != '[') {
+        return ArrayError::NOT_ARRAY;
+    }
+    if (!reader.beginArray()) {
+        return ArrayError::SYNTAX;
+    }
+    vec.clear();
+    size_t expected = reader.countFlatElements();
+    if (expected > vec.capacity()) {
+        vec.reserve(expected);
+    }
+    while (reader.nextElement()) {
+        vec.emplace_back();
+        ArrayError error = readElement(reader, vec.back());
+        if (error != ArrayError::NONE) {
+            if (error_index) *error_index = vec.size() - 1;
+            vec.pop_back();
+            return error;
         }
-        cJSON_AddItemToArray(array, element);
     }
-    
-    return array;
+    return reader.failed() ? ArrayError::SYNTAX : ArrayError::NONE;
 }
 
-// 通用数组反序列化函数
-template<typename T>
-bool deserializeArray(const cJSON* json, std::vector<T>& vec) {
-    if (!cJSON_IsArray(json)) {
-        return false;
+// std::vector<bool> 不能就地引用元素，单独处理
+inline ArrayError readArray(json::Reader& reader, std::vector<bool>& vec, size_t* error_index = nullptr) {
+    if (reader.peek() != '[') {
+        return ArrayError::NOT_ARRAY;
+    }
+    if (!reader.beginArray()) {
+        return ArrayError::SYNTAX;
     }
-    
     vec.clear();
-    cJSON* element = json->child;
-    while (element) {
-        try {
-            T value = fromJsonElement<T>(element);
-            vec.push_back(value);
-        } catch (const std::exception&) {
-            return false;
+    vec.reserve(reader.countFlatElements());
+    while (reader.nextElement()) {
+        bool value = false;
+        ArrayError error = readElement(reader, value);
+        if (error != ArrayError::NONE) {
+            if (error_index) *error_index = vec.size();
+            return error;
         }
-        element = element->next;
+        vec.push_back(value);
     }
-    
-    return true;
+    return reader.failed() ? ArrayError::SYNTAX : ArrayError::NONE;
 }
 
-// std::optional<std::vector<T>> 序列化
-template<typename T>
-cJSON* serializeOptionalArray(const uvapi::optional<std::vector<T>>& opt_vec) {
-    if (!opt_vec.has_value()) {
-        return cJSON_CreateNull();
+/**
+ * @brief readArray() 因元素错误返回后跳过数组的剩余部分，使读取器回到数组之后
+ * @return 剩余部分语法正确时返回 true
+ */
+inline bool skipRest(json::Reader& reader, ArrayError error) {
+    if (error == ArrayError::WRONG_TYPE && !reader.skipValue()) {
+        return false;
+    }
+    while (reader.nextElement()) {
+        if (!reader.skipValue()) {
+            return false;
+        }
+    }
+    return !reader.failed();
+}
+
+// 写出的元素直接追加到写入器的缓冲区（数组内不再逐个经过 Writer 的分隔符判断）
+inline void appendElement(std::string& out, int value) { json::appendInteger(out, value); }
+inline void appendElement(std::string& out, int64_t value) { json::appendInteger(out, value); }
+inline void appendElement(std::string& out, double value) { json::appendDouble(out, value); }
+inline void appendElement(std::string& out, bool value) {
+    if (value) {
+        out.append("true", 4);
+    } else {
+        out.append("false", 5);
     }
-    return serializeArray(opt_vec.value());
 }
+inline void appendElement(std::string& out, const std::string& value) {
+    json::appendQuoted(out, value.data(), value.size());
+}
+
+// 每个元素的预估字节数（含逗号），用于一次性 reserve()
+template<typename T> struct ElementWidth { static const size_t value = 8; };
+template<> struct ElementWidth<int64_t> { static const size_t value = 12; };
+template<> struct ElementWidth<double> { static const size_t value = 12; };
+template<> struct ElementWidth<bool> { static const size_t value = 6; };
+template<> struct ElementWidth<std::string> { static const size_t value = 16; };
 
-// std::optional<std::vector<T>> 反序列化
 template<typename T>
-bool deserializeOptionalArray(const cJSON* json, uvapi::optional<std::vector<T>>& opt_vec) {
-    if (cJSON_IsNull(json)) {
-        opt_vec.reset();
-        return true;
-    }
-    
-    std::vector<T> vec;
-    if (!deserializeArray(json, vec)) {
-        return false;
+void writeArray(json::Writer& writer, const std::vector<T>& vec) {
+    writer.beginArray();
+    std::string& out = writer.buffer();
+    size_t needed = out.size() + vec.size() * ElementWidth<T>::value + 1;
+    if (needed > out.capacity()) {
+        out.reserve(std::max(needed, out.capacity() * 2));  // 保持几何增长，多次调用时不退化
+    }
+    for (size_t i = 0; i < vec.size(); ++i) {
+        if (i > 0) {
+            out += ',';
+        }
+        appendElement(out, static_cast<const T&>(vec[i]));
     }
-    
-    opt_vec = std::move(vec);
-    return true;
+    writer.endArray();
 }
 
 } // namespace array_utils
 
 } // namespace uvapi
 
-#endif // ARRAY_SUPPORT_H
\ No newline at end of file
+#endif // ARRAY_SUPPORT_H
@@ -0,0 +1,183 @@
+/**
+ * @file body_stream.h
+ * @brief 请求体分块投递的基础组件
+ *
+ * - BodyFeeder：按块切分请求体。默认借用 uvhttp 的缓冲区，不复制；
+ *   消费方暂停时只把尚未投递的剩余部分复制出来，恢复后从副本继续
+ * - NdjsonSplitter：把分块输入切成完整的行，行完整落在一块内时直接返回指向该块的切片，
+ *   只有跨块的半行才缓存
+ *
+ * 与路由的对接见 RouteBuilder::bodyStream()；multipart 上传直接把块交给 MultipartParser::feed()。
+ */
+
+#ifndef UVAPI_BODY_STREAM_H
+#define UVAPI_BODY_STREAM_H
+
+#include "request_view.h"
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+namespace uvapi {
+
+// 块回调的返回值
+enum class BodyAction {
+    CONTINUE,  // 继续投递下一块
+    PAUSE,     // 暂停，直到调用 resume()
+    ABORT      // 中止：不再投递，也不调用结束回调
+};
+
+// ========== 分块投递 ==========
+
+class BodyFeeder {
+public:
+    BodyFeeder() : data_(nullptr), size_(0), offset_(0), base_(0), owned_flag_(false) {}
+
+    // 借用 data（调用方保证在 detach() 或投递完之前有效）
+    void reset(const char* data, size_t size) {
+        owned_.clear();
+        data_ = data;
+        size_ = data ? size : 0;
+        offset_ = 0;
+        base_ = 0;
+        owned_flag_ = false;
+    }
+
+    bool done() const { return offset_ >= size_; }
+    size_t remaining() const { return size_ - offset_; }
+    size_t consumed() const { return base_ + offset_; }
+
+    // 下一块（最多 max_size 字节）并前移；已投递完时返回空切片
+    StringSlice next(size_t max_size) {
+        size_t size = remaining() < max_size ? remaining() : max_size;
+        StringSlice chunk(data_ + offset_, size);
+        offset_ += size;
+        return chunk;
+    }
+
+    // 把未投递的剩余部分复制为自有存储，之后不再引用借用的缓冲区
+    void detach() {
+        if (owned() || done()) {
+            return;
+        }
+        owned_.assign(data_ + offset_, remaining());
+        base_ += offset_;
+        data_ = owned_.data();
+        size_ = owned_.size();
+        offset_ = 0;
+        owned_flag_ = true;
+    }
+
+    bool owned() const { return owned_flag_; }
+
+private:
+    const char* data_;
+    size_t size_;
+    size_t offset_;
+    size_t base_;  // detach() 之前已投递的字节数
+    bool owned_flag_;
+    std::string owned_;
+};
+
+// ========== NDJSON 分行 ==========
+
+class NdjsonSplitter {
+public:
+    explicit NdjsonSplitter(size_t max_line = 1024 * 1024)
+        : max_line_(max_line), lines_(0), failed_(false) {}
+
+    /**
+     * @brief 输入下一块，对每个完整的行调用 fn(StringSlice line)
+     *
+     * 行尾的 "\r\n" / "\n" 被去掉，空行跳过。fn 返回 false、或单行超过上限时返回 false，
+     * 之后的调用都返回 false。
+     */
+    template<typename Fn>
+    bool feed(const char* data, size_t size, Fn fn) {
+        if (failed_) {
+            return false;
+        }
+        const char* end = data + size;
+        const char* p = data;
+        while (p < end) {
+            const char* newline = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+            if (!newline) {
+                if (partial_.size() + static_cast<size_t>(end - p) > max_line_) {
+                    return fail("NDJSON line exceeds limit");
+                }
+                partial_.append(p, static_cast<size_t>(end - p));
+                return true;
+            }
+            bool ok;
+            if (partial_.empty()) {
+                ok = emit(p, static_cast<size_t>(newline - p), fn);
+            } else {
+                if (partial_.size() + static_cast<size_t>(newline - p) > max_line_) {
+                    return fail("NDJSON line exceeds limit");
+                }
+                partial_.append(p, static_cast<size_t>(newline - p));
+                ok = emit(partial_.data(), partial_.size(), fn);
+                partial_.clear();
+            }
+            if (!ok) {
+                return false;
+            }
+            p = newline + 1;
+        }
+        return true;
+    }
+
+    // 输入结束：最后一行可以没有换行
+    template<typename Fn>
+    bool finish(Fn fn) {
+        if (failed_) {
+            return false;
+        }
+        if (partial_.empty()) {
+            return true;
+        }
+        std::string last;
+        last.swap(partial_);
+        return emit(last.data(), last.size(), fn);
+    }
+
+    size_t lines() const { return lines_; }
+    const std::string& error() const { return error_; }
+
+private:
+    std::string partial_;
+    size_t max_line_;
+    size_t lines_;
+    bool failed_;
+    std::string error_;
+
+    template<typename Fn>
+    bool emit(const char* data, size_t size, Fn& fn) {
+        if (size > 0 && data[size - 1] == '\r') {
+            size--;
+        }
+        if (size > max_line_) {
+            return fail("NDJSON line exceeds limit");
+        }
+        if (size == 0) {
+            return true;
+        }
+        lines_++;
+        if (!fn(StringSlice(data, size))) {
+            return fail("NDJSON line rejected");
+        }
+        return true;
+    }
+
+    bool fail(const char* message) {
+        failed_ = true;
+        error_ = message;
+        partial_.clear();
+        return false;
+    }
+};
+
+} // namespace uvapi
+
+#endif // UVAPI_BODY_STREAM_H
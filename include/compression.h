@@ -0,0 +1,383 @@
+/**
+ * @file compression.h
+ * @brief 响应压缩：按 Accept-Encoding 协商 br / gzip，按大小和 MIME 类型决定是否压缩
+ *
+ * - 压缩上下文按线程复用：gzip 的 z_stream 只初始化一次，之后每次 deflateReset；
+ *   brotli 编码器没有重置接口，改为复用其内部大块分配（按大小缓存在线程内），
+ *   每次创建实例不再向系统申请哈希表内存
+ * - 输出按压缩上界一次预留，编码器直接写入目标缓冲区，没有中间分块和拼接
+ * - 库在编译时可选：定义 UVAPI_WITH_ZLIB / UVAPI_WITH_BROTLI（CMake 找到对应库时自动定义），
+ *   未启用的编码在协商时视为不可用
+ *
+ * @code
+ * api.compression(uvapi::compress::CompressionPolicy()
+ *                     .minSize(1024)
+ *                     .gzipLevel(5)
+ *                     .brotliQuality(4));
+ * @endcode
+ */
+
+#ifndef UVAPI_COMPRESSION_H
+#define UVAPI_COMPRESSION_H
+
+#include "request_view.h"
+#include "static_files.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifdef UVAPI_WITH_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef UVAPI_WITH_BROTLI
+#include <brotli/encode.h>
+#endif
+
+namespace uvapi {
+namespace compress {
+
+enum class Encoding {
+    IDENTITY,
+    GZIP,
+    BROTLI
+};
+
+inline const char* encodingName(Encoding encoding) {
+    switch (encoding) {
+        case Encoding::GZIP: return "gzip";
+        case Encoding::BROTLI: return "br";
+        case Encoding::IDENTITY: return "identity";
+    }
+    return "identity";
+}
+
+inline bool gzipAvailable() {
+#ifdef UVAPI_WITH_ZLIB
+    return true;
+#else
+    return false;
+#endif
+}
+
+inline bool brotliAvailable() {
+#ifdef UVAPI_WITH_BROTLI
+    return true;
+#else
+    return false;
+#endif
+}
+
+// ========== 压缩策略 ==========
+
+struct CompressionPolicy {
+    size_t min_size;                      // 小于此大小的响应体不压缩
+    std::vector<std::string> mime_types;  // 允许压缩的类型，按前缀匹配（"text/" 匹配所有文本类型）
+    int gzip_level;                       // 1-9
+    int brotli_quality;                   // 0-11，动态响应建议 4 左右
+    bool gzip;
+    bool brotli;
+
+    CompressionPolicy()
+        : min_size(1024)
+        , gzip_level(6)
+        , brotli_quality(4)
+        , gzip(true)
+        , brotli(true) {
+        mime_types.push_back("application/json");
+        mime_types.push_back("text/");
+        mime_types.push_back("application/javascript");
+        mime_types.push_back("application/xml");
+        mime_types.push_back("image/svg+xml");
+    }
+
+    CompressionPolicy& minSize(size_t bytes) {
+        min_size = bytes;
+        return *this;
+    }
+
+    CompressionPolicy& allowType(const std::string& type) {
+        mime_types.push_back(type);
+        return *this;
+    }
+
+    // 清空默认类型列表（随后用 allowType 指定）
+    CompressionPolicy& clearTypes() {
+        mime_types.clear();
+        return *this;
+    }
+
+    CompressionPolicy& gzipLevel(int level) {
+        gzip_level = level < 1 ? 1 : (level > 9 ? 9 : level);
+        return *this;
+    }
+
+    CompressionPolicy& brotliQuality(int quality) {
+        brotli_quality = quality < 0 ? 0 : (quality > 11 ? 11 : quality);
+        return *this;
+    }
+
+    CompressionPolicy& useGzip(bool enabled) {
+        gzip = enabled;
+        return *this;
+    }
+
+    CompressionPolicy& useBrotli(bool enabled) {
+        brotli = enabled;
+        return *this;
+    }
+
+    // Content-Type（忽略 ; 之后的参数，大小写不敏感）是否在允许列表中
+    bool allowsType(StringSlice content_type) const {
+        if (!content_type.valid()) {
+            return false;
+        }
+        const char* semi = static_cast<const char*>(std::memchr(content_type.data, ';', content_type.size));
+        size_t size = semi ? static_cast<size_t>(semi - content_type.data) : content_type.size;
+        while (size > 0 && content_type.data[size - 1] == ' ') {
+            size--;
+        }
+        for (size_t i = 0; i < mime_types.size(); i++) {
+            const std::string& type = mime_types[i];
+            bool prefix = !type.empty() && type[type.size() - 1] == '/';
+            if (prefix ? (size >= type.size() && StringSlice(content_type.data, type.size())
+                                                     .equalsIgnoreCase(type.data(), type.size()))
+                       : StringSlice(content_type.data, size).equalsIgnoreCase(type.data(), type.size())) {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+// 按 Accept-Encoding 选择编码（br 优先），只考虑策略允许且编译时可用的编码
+inline Encoding negotiate(const CompressionPolicy& policy, StringSlice accept_encoding) {
+    unsigned accepted = server::acceptedEncodings(accept_encoding);
+    if (policy.brotli && brotliAvailable() && (accepted & server::ENCODING_BR)) {
+        return Encoding::BROTLI;
+    }
+    if (policy.gzip && gzipAvailable() && (accepted & server::ENCODING_GZIP)) {
+        return Encoding::GZIP;
+    }
+    return Encoding::IDENTITY;
+}
+
+// ========== gzip ==========
+
+#ifdef UVAPI_WITH_ZLIB
+
+class GzipContext {
+public:
+    // 当前线程的上下文
+    static GzipContext& forThread() {
+        static thread_local GzipContext context;
+        return context;
+    }
+
+    // 压缩到 out（覆盖原内容），失败时返回 false
+    bool compress(const char* data, size_t size, int level, std::string& out) {
+        if (!ready_ || level != level_) {
+            if (!init(level)) {
+                return false;
+            }
+        } else if (deflateReset(&stream_) != Z_OK) {
+            return false;
+        }
+        out.resize(deflateBound(&stream_, static_cast<uLong>(size)));
+        stream_.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+        stream_.avail_in = static_cast<uInt>(size);
+        stream_.next_out = reinterpret_cast<Bytef*>(&out[0]);
+        stream_.avail_out = static_cast<uInt>(out.size());
+        // 输出缓冲区不小于 deflateBound，一次 Z_FINISH 即可完成
+        int rc = deflate(&stream_, Z_FINISH);
+        if (rc != Z_STREAM_END) {
+            out.clear();
+            return false;
+        }
+        out.resize(static_cast<size_t>(stream_.total_out));
+        return true;
+    }
+
+    ~GzipContext() {
+        if (ready_) {
+            deflateEnd(&stream_);
+        }
+    }
+
+private:
+    z_stream stream_;
+    bool ready_;
+    int level_;
+
+    GzipContext() : ready_(false), level_(0) {
+        std::memset(&stream_, 0, sizeof(stream_));
+    }
+
+    GzipContext(const GzipContext&) = delete;
+    GzipContext& operator=(const GzipContext&) = delete;
+
+    bool init(int level) {
+        if (ready_) {
+            deflateEnd(&stream_);
+            ready_ = false;
+        }
+        std::memset(&stream_, 0, sizeof(stream_));
+        // windowBits 15 + 16：gzip 封装
+        if (deflateInit2(&stream_, level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+            return false;
+        }
+        ready_ = true;
+        level_ = level;
+        return true;
+    }
+};
+
+#endif // UVAPI_WITH_ZLIB
+
+// ========== brotli ==========
+
+#ifdef UVAPI_WITH_BROTLI
+
+/**
+ * @brief brotli 编码器的线程内分配缓存
+ *
+ * 编码器按质量和窗口分配固定大小的哈希表与环形缓冲区，释放的块按大小留在线程内，
+ * 下一个同参数的编码器直接取回。缓存总量有上限，超出时交还系统。
+ */
+class BrotliArena {
+public:
+    static BrotliArena& forThread() {
+        static thread_local BrotliArena arena;
+        return arena;
+    }
+
+    static void* allocate(void* opaque, size_t size) {
+        return static_cast<BrotliArena*>(opaque)->take(size);
+    }
+
+    static void release(void* opaque, void* ptr) {
+        if (ptr) {
+            static_cast<BrotliArena*>(opaque)->give(ptr);
+        }
+    }
+
+    size_t cachedBytes() const { return cached_bytes_; }
+
+    ~BrotliArena() {
+        for (size_t i = 0; i < blocks_.size(); i++) {
+            std::free(blocks_[i]);
+        }
+    }
+
+private:
+    // 块头记录大小，保持 16 字节对齐
+    static const size_t kHeader = 16;
+    static const size_t kMaxCached = 32 * 1024 * 1024;
+
+    std::vector<void*> blocks_;  // 指向块头
+    size_t cached_bytes_;
+
+    BrotliArena() : cached_bytes_(0) {}
+
+    BrotliArena(const BrotliArena&) = delete;
+    BrotliArena& operator=(const BrotliArena&) = delete;
+
+    static size_t& blockSize(void* block) { return *static_cast<size_t*>(block); }
+
+    void* take(size_t size) {
+        for (size_t i = blocks_.size(); i > 0; i--) {
+            void* block = blocks_[i - 1];
+            if (blockSize(block) == size) {
+                blocks_[i - 1] = blocks_.back();
+                blocks_.pop_back();
+                cached_bytes_ -= size;
+                return static_cast<char*>(block) + kHeader;
+            }
+        }
+        void* block = std::malloc(size + kHeader);
+        if (!block) {
+            return nullptr;
+        }
+        blockSize(block) = size;
+        return static_cast<char*>(block) + kHeader;
+    }
+
+    void give(void* ptr) {
+        void* block = static_cast<char*>(ptr) - kHeader;
+        size_t size = blockSize(block);
+        if (cached_bytes_ + size > kMaxCached) {
+            std::free(block);
+            return;
+        }
+        blocks_.push_back(block);
+        cached_bytes_ += size;
+    }
+};
+
+// 压缩到 out（覆盖原内容），失败时返回 false
+inline bool brotliCompress(const char* data, size_t size, int quality, std::string& out) {
+    BrotliArena& arena = BrotliArena::forThread();
+    BrotliEncoderState* state = BrotliEncoderCreateInstance(BrotliArena::allocate, BrotliArena::release, &arena);
+    if (!state) {
+        return false;
+    }
+    BrotliEncoderSetParameter(state, BROTLI_PARAM_QUALITY, static_cast<uint32_t>(quality));
+    BrotliEncoderSetParameter(state, BROTLI_PARAM_MODE, BROTLI_MODE_TEXT);
+    BrotliEncoderSetParameter(state, BROTLI_PARAM_SIZE_HINT,
+                              static_cast<uint32_t>(size > UINT32_MAX ? UINT32_MAX : size));
+    size_t bound = BrotliEncoderMaxCompressedSize(size);
+    out.resize(bound > 0 ? bound : size + 1024);
+
+    const uint8_t* next_in = reinterpret_cast<const uint8_t*>(data);
+    size_t avail_in = size;
+    uint8_t* next_out = reinterpret_cast<uint8_t*>(&out[0]);
+    size_t avail_out = out.size();
+    bool ok = BrotliEncoderCompressStream(state, BROTLI_OPERATION_FINISH, &avail_in, &next_in,
+                                          &avail_out, &next_out, nullptr) == BROTLI_TRUE &&
+              BrotliEncoderIsFinished(state) == BROTLI_TRUE;
+    BrotliEncoderDestroyInstance(state);
+    if (!ok) {
+        out.clear();
+        return false;
+    }
+    out.resize(out.size() - avail_out);
+    return true;
+}
+
+#endif // UVAPI_WITH_BROTLI
+
+/**
+ * @brief 按编码压缩到 out（覆盖原内容）
+ *
+ * 编码不可用、压缩失败或结果不比原文小时返回 false，调用方应发送原文。
+ */
+inline bool compressBody(Encoding encoding, const CompressionPolicy& policy, const char* data, size_t size,
+                         std::string& out) {
+    bool ok = false;
+    switch (encoding) {
+        case Encoding::GZIP:
+#ifdef UVAPI_WITH_ZLIB
+            ok = GzipContext::forThread().compress(data, size, policy.gzip_level, out);
+#endif
+            break;
+        case Encoding::BROTLI:
+#ifdef UVAPI_WITH_BROTLI
+            ok = brotliCompress(data, size, policy.brotli_quality, out);
+#endif
+            break;
+        case Encoding::IDENTITY:
+            break;
+    }
+    (void)policy;
+    (void)data;
+    return ok && out.size() < size;
+}
+
+} // namespace compress
+} // namespace uvapi
+
+#endif // UVAPI_COMPRESSION_H
@@ -0,0 +1,287 @@
+/**
+ * @file cors.h
+ * @brief 跨源资源共享（CORS）：来源匹配与预渲染的响应头部
+ *
+ * - CorsConfig 在开启时编译为 CorsPolicy：精确来源进入哈希表（不区分大小写），"*.example.com"
+ *   形式的条目（可带协议前缀，只匹配该协议）成为子域名后缀规则，"*" 允许任意来源
+ * - "*" 不能与 allow_credentials 同时使用：那等于把凭据访问开放给任意网站，编译时报错并忽略 "*"，
+ *   需要凭据时必须列出具体来源或子域名规则
+ * - 每个精确来源的预检头部和实际请求头部在编译时渲染完成；后缀规则共用一份头部，
+ *   只有 Access-Control-Allow-Origin 在写出时替换为请求的来源
+ * - 分发路径在路由之前查询策略：预检请求直接以 204 应答，不进入路由；
+ *   其他跨源请求先写入允许头部，随处理器的响应一并发出
+ *
+ * @code
+ * uvapi::CorsConfig config;
+ * config.allowed_origins = "https://app.example.com, *.example.com";
+ * config.allow_credentials = true;
+ * api.enableCors(config);
+ * @endcode
+ */
+
+#ifndef UVAPI_CORS_H
+#define UVAPI_CORS_H
+
+#include "request_view.h"
+#include "response_headers.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace uvapi {
+
+// CORS 配置（列表字段均为逗号分隔）
+struct CorsConfig {
+    bool enabled;
+    std::string allowed_origins;  // "*"、精确来源或 "https://*.example.com" 子域名规则（"*" 不能与凭据同时使用）
+    std::string allowed_methods;
+    std::string allowed_headers;
+    std::string expose_headers;   // 实际请求响应中允许脚本读取的头部，为空时不发送
+    bool allow_credentials;
+    int max_age;                  // 预检结果在浏览器中的缓存秒数，<= 0 时不发送 Access-Control-Max-Age
+
+    CorsConfig()
+        : enabled(false), allowed_origins("*"), allowed_methods("GET, POST, PUT, DELETE, OPTIONS"),
+          allowed_headers("Content-Type, Authorization"), allow_credentials(false), max_age(86400) {}
+};
+
+namespace cors {
+
+// 切分逗号分隔的列表，去掉两端空白和空项
+inline std::vector<std::string> splitList(const std::string& list) {
+    std::vector<std::string> items;
+    size_t pos = 0;
+    while (pos <= list.size()) {
+        size_t end = list.find(',', pos);
+        if (end == std::string::npos) {
+            end = list.size();
+        }
+        size_t first = pos;
+        size_t last = end;
+        while (first < last && (list[first] == ' ' || list[first] == '\t')) {
+            ++first;
+        }
+        while (last > first && (list[last - 1] == ' ' || list[last - 1] == '\t')) {
+            --last;
+        }
+        if (last > first) {
+            items.push_back(list.substr(first, last - first));
+        }
+        pos = end + 1;
+    }
+    return items;
+}
+
+inline std::string toLower(const std::string& s) {
+    std::string out(s);
+    for (size_t i = 0; i < out.size(); ++i) {
+        if (out[i] >= 'A' && out[i] <= 'Z') {
+            out[i] = static_cast<char>(out[i] - 'A' + 'a');
+        }
+    }
+    return out;
+}
+
+inline unsigned char lowerByte(char c) {
+    return static_cast<unsigned char>(c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c);
+}
+
+// 不区分大小写的 FNV-1a，供来源哈希表按切片查找（不为查找构造 std::string）
+struct SliceHash {
+    size_t operator()(const StringSlice& s) const {
+        uint64_t h = 1469598103934665603ULL;
+        for (size_t i = 0; i < s.size; ++i) {
+            h ^= lowerByte(s.data[i]);
+            h *= 1099511628211ULL;
+        }
+        return static_cast<size_t>(h);
+    }
+};
+
+struct SliceEqualIgnoreCase {
+    bool operator()(const StringSlice& a, const StringSlice& b) const {
+        return a.equalsIgnoreCase(b.data, b.size);
+    }
+};
+
+// ========== 编译后的策略 ==========
+
+class CorsPolicy {
+public:
+    // 一个来源（或一类来源）预渲染的头部
+    struct Rendered {
+        std::string origin;        // 精确来源；共用头部时为空
+        bool echo_origin;          // Access-Control-Allow-Origin 写出时替换为请求的来源
+        ResponseHeaders preflight;
+        ResponseHeaders actual;
+
+        Rendered() : echo_origin(false) {}
+    };
+
+    explicit CorsPolicy(const CorsConfig& config) : any_origin_(false), credentials_(config.allow_credentials) {
+        methods_ = splitList(config.allowed_methods);
+        std::vector<std::string> origins = splitList(config.allowed_origins);
+        for (size_t i = 0; i < origins.size(); ++i) {
+            const std::string& origin = origins[i];
+            if (origin == "*") {
+                if (credentials_) {
+                    std::cerr << "Error: CORS allowed_origins \"*\" cannot be combined with allow_credentials; "
+                              << "list the allowed origins explicitly (\"*\" ignored)" << std::endl;
+                } else {
+                    any_origin_ = true;
+                }
+                continue;
+            }
+            size_t star = origin.find("*.");
+            if (star != std::string::npos) {
+                SuffixRule rule;
+                rule.scheme = toLower(origin.substr(0, star));  // "https://"，没有协议时为空
+                rule.suffix = toLower(origin.substr(star + 1)); // ".example.com[:port]"
+                suffixes_.push_back(rule);
+                continue;
+            }
+            Rendered entry;
+            entry.origin = toLower(origin);
+            render(config, entry.origin, entry);
+            exact_.push_back(entry);
+        }
+        // 索引在 exact_ 不再变化之后建立，切片指向其中的字符串
+        for (size_t i = 0; i < exact_.size(); ++i) {
+            index_[StringSlice(exact_[i].origin)] = i;
+        }
+        shared_.echo_origin = true;
+        render(config, std::string(), shared_);
+        if (any_origin_) {
+            render(config, "*", wildcard_);
+            wildcard_.preflight.erase("Vary");
+            wildcard_.actual.erase("Vary");
+        }
+    }
+
+    /**
+     * @brief 查找来源对应的头部，不允许的来源返回 nullptr
+     *
+     * 精确来源优先（不区分大小写），其次子域名规则，最后是 "*"。
+     */
+    const Rendered* match(const StringSlice& origin) const {
+        if (!origin.valid() || origin.empty()) {
+            return nullptr;
+        }
+        OriginIndex::const_iterator it = index_.find(origin);
+        if (it != index_.end()) {
+            return &exact_[it->second];
+        }
+        for (size_t i = 0; i < suffixes_.size(); ++i) {
+            if (suffixes_[i].matches(origin)) {
+                return &shared_;
+            }
+        }
+        // 携带凭据时构造阶段已拒绝 "*"
+        return any_origin_ ? &wildcard_ : nullptr;
+    }
+
+    // 预检请求的 Access-Control-Request-Method 是否在允许列表中（方法名区分大小写）
+    bool allowsMethod(const StringSlice& method) const {
+        for (size_t i = 0; i < methods_.size(); ++i) {
+            if (StringSlice(methods_[i]) == method) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief 写出头部：set(const char* name, const char* value)
+     * @param origin 请求的 Origin，回显时直接作为值写出，须以 '\0' 结尾
+     */
+    template<typename SetHeader>
+    static void emit(const Rendered& rendered, bool preflight, const StringSlice& origin, SetHeader set) {
+        const ResponseHeaders& headers = preflight ? rendered.preflight : rendered.actual;
+        for (ResponseHeaders::const_iterator it = headers.begin(); it != headers.end(); ++it) {
+            if (rendered.echo_origin && it == headers.begin()) {
+                set(it->first.c_str(), origin.data);
+            } else {
+                set(it->first.c_str(), it->second.c_str());
+            }
+        }
+    }
+
+private:
+    typedef std::unordered_map<StringSlice, size_t, SliceHash, SliceEqualIgnoreCase> OriginIndex;
+
+    struct SuffixRule {
+        std::string scheme;
+        std::string suffix;
+
+        // 主机名以后缀结尾且前面至少还有一级标签（规则不匹配裸域名本身）
+        bool matches(const StringSlice& origin) const {
+            const char* sep = nullptr;
+            for (size_t i = 0; i + 2 < origin.size; ++i) {
+                if (origin.data[i] == ':' && origin.data[i + 1] == '/' && origin.data[i + 2] == '/') {
+                    sep = origin.data + i + 3;
+                    break;
+                }
+            }
+            if (!sep) {
+                return false;
+            }
+            size_t scheme_size = static_cast<size_t>(sep - origin.data);
+            if (!scheme.empty() && !StringSlice(origin.data, scheme_size).equalsIgnoreCase(scheme.data(), scheme.size())) {
+                return false;
+            }
+            size_t host_size = origin.size - scheme_size;
+            if (host_size <= suffix.size()) {
+                return false;
+            }
+            for (size_t i = 0; i < host_size - suffix.size(); ++i) {
+                if (sep[i] == '/' || sep[i] == ':') {
+                    return false;
+                }
+            }
+            return StringSlice(sep + host_size - suffix.size(), suffix.size()).equalsIgnoreCase(suffix.data(), suffix.size());
+        }
+    };
+
+    bool any_origin_;   // 只在不携带凭据时为 true
+    bool credentials_;
+    std::vector<std::string> methods_;
+    std::vector<Rendered> exact_;
+    OriginIndex index_;
+    std::vector<SuffixRule> suffixes_;
+    Rendered shared_;    // 子域名规则：回显来源
+    Rendered wildcard_;  // 不携带凭据的 "*"：不随来源变化，没有 Vary
+
+    // Access-Control-Allow-Origin 总是第一个头部（回显时按位置替换）
+    static void render(const CorsConfig& config, const std::string& origin, Rendered& out) {
+        out.preflight.set("Access-Control-Allow-Origin", origin);
+        out.actual.set("Access-Control-Allow-Origin", origin);
+        if (config.allow_credentials) {
+            out.preflight.set("Access-Control-Allow-Credentials", "true");
+            out.actual.set("Access-Control-Allow-Credentials", "true");
+        }
+        if (!config.allowed_methods.empty()) {
+            out.preflight.set("Access-Control-Allow-Methods", config.allowed_methods);
+        }
+        if (!config.allowed_headers.empty()) {
+            out.preflight.set("Access-Control-Allow-Headers", config.allowed_headers);
+        }
+        if (config.max_age > 0) {
+            out.preflight.set("Access-Control-Max-Age", std::to_string(config.max_age));
+        }
+        if (!config.expose_headers.empty()) {
+            out.actual.set("Access-Control-Expose-Headers", config.expose_headers);
+        }
+        // 允许的来源不是 "*" 时响应随 Origin 变化，共享缓存需要区分
+        out.preflight.set("Vary", "Origin");
+        out.actual.set("Vary", "Origin");
+    }
+};
+
+} // namespace cors
+} // namespace uvapi
+
+#endif // UVAPI_CORS_H
@@ -109,6 +109,7 @@ public:
     Schema& pattern(const std::string& regex) {
         if (!fields_.empty()) {
             fields_.back().validation.pattern = regex;
+            fields_.back().validation.compiled_pattern = CompiledPattern(regex);
             fields_.back().validation.has_pattern = true;
         }
         return *this;
@@ -360,13 +361,14 @@ private:
     // 验证正则表达式
     static ValidationResult validatePattern(const std::string& name, const std::string& value,
                                             const restful::ParamDefinition& def) {
-        try {
-            std::regex pattern(def.validation.pattern);
-            if (!std::regex_match(value, pattern)) {
-                return ValidationResult::error(name, "Value does not match required pattern");
-            }
-        } catch (const std::regex_error&) {
-            // 正则表达式错误，跳过验证
+        // 声明时已编译；未编译的规则回退为按源码编译
+        CompiledPattern fallback;
+        const CompiledPattern& compiled = def.validation.compiled_pattern.compiled()
+            ? def.validation.compiled_pattern
+            : (fallback = CompiledPattern(def.validation.pattern));
+        // 正则表达式错误，跳过验证
+        if (compiled.ok() && !compiled.matches(value.data(), value.size())) {
+            return ValidationResult::error(name, "Value does not match required pattern");
         }
 
         return ValidationResult::ok();
@@ -635,6 +637,7 @@ struct ApiDefinition {
     ApiDefinition& pattern(const std::string& regex) {
         if (!params.empty()) {
             params.back().validation.pattern = regex;
+            params.back().validation.compiled_pattern = CompiledPattern(regex);
             params.back().validation.has_pattern = true;
         }
         return *this;
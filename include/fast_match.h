@@ -0,0 +1,216 @@
+/**
+ * @file fast_match.h
+ * @brief 内置格式的手写匹配器（email / uuid / ipv4 / date / datetime）
+ *
+ * 与 framework_types.h 中的正则表达式语义一致，但只做一次线性扫描，
+ * 不构造 std::regex、不分配内存。供 validators 和 CompiledPattern 使用。
+ */
+
+#ifndef UVAPI_FAST_MATCH_H
+#define UVAPI_FAST_MATCH_H
+
+#include <cstddef>
+#include <cstring>
+
+namespace uvapi {
+namespace fastmatch {
+
+inline bool isDigit(char c) { return c >= '0' && c <= '9'; }
+inline bool isAlpha(char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'); }
+inline bool isHex(char c) { return isDigit(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F'); }
+
+// 读取 n 位十进制数字
+inline bool readDigits(const char* s, size_t n, int& out) {
+    int value = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (!isDigit(s[i])) {
+            return false;
+        }
+        value = value * 10 + (s[i] - '0');
+    }
+    out = value;
+    return true;
+}
+
+/**
+ * @brief ^[a-zA-Z0-9._%+-]+@[a-zA-Z0-9.-]+\.[a-zA-Z]{2,}$
+ */
+inline bool isEmail(const char* s, size_t n) {
+    size_t at = n;
+    for (size_t i = 0; i < n; i++) {
+        char c = s[i];
+        if (c == '@') {
+            at = i;
+            break;
+        }
+        if (!(isAlpha(c) || isDigit(c) || c == '.' || c == '_' || c == '%' || c == '+' || c == '-')) {
+            return false;
+        }
+    }
+    if (at == 0 || at == n) {
+        return false;
+    }
+
+    // 域名部分：最后一个 '.' 之后至少两个字母，之前至少一个域名字符
+    const char* domain = s + at + 1;
+    size_t domain_len = n - at - 1;
+    size_t last_dot = domain_len;
+    for (size_t i = 0; i < domain_len; i++) {
+        char c = domain[i];
+        if (c == '.') {
+            last_dot = i;
+        } else if (!(isAlpha(c) || isDigit(c) || c == '-')) {
+            return false;
+        }
+    }
+    if (last_dot == domain_len || last_dot == 0) {
+        return false;
+    }
+    size_t tld_len = domain_len - last_dot - 1;
+    if (tld_len < 2) {
+        return false;
+    }
+    for (size_t i = last_dot + 1; i < domain_len; i++) {
+        if (!isAlpha(domain[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 8-4-4-4-12 十六进制 UUID
+ */
+inline bool isUuid(const char* s, size_t n) {
+    if (n != 36) {
+        return false;
+    }
+    for (size_t i = 0; i < n; i++) {
+        if (i == 8 || i == 13 || i == 18 || i == 23) {
+            if (s[i] != '-') {
+                return false;
+            }
+        } else if (!isHex(s[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 点分十进制 IPv4（每段 0-255，不允许前导零）
+ */
+inline bool isIpv4(const char* s, size_t n) {
+    size_t i = 0;
+    for (int part = 0; part < 4; part++) {
+        if (part > 0) {
+            if (i >= n || s[i] != '.') {
+                return false;
+            }
+            i++;
+        }
+        size_t start = i;
+        int value = 0;
+        while (i < n && isDigit(s[i]) && i - start < 3) {
+            value = value * 10 + (s[i] - '0');
+            i++;
+        }
+        size_t len = i - start;
+        if (len == 0 || value > 255 || (len > 1 && s[start] == '0')) {
+            return false;
+        }
+    }
+    return i == n;
+}
+
+inline int daysInMonth(int year, int month) {
+    static const int days[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    if (month == 2 && ((year % 4 == 0 && year % 100 != 0) || year % 400 == 0)) {
+        return 29;
+    }
+    return days[month - 1];
+}
+
+// 仅检查 \d{4}-\d{2}-\d{2} 形状，不检查取值
+inline bool hasDateShape(const char* s, size_t n) {
+    if (n != 10) {
+        return false;
+    }
+    for (size_t i = 0; i < n; i++) {
+        if (i == 4 || i == 7 ? s[i] != '-' : !isDigit(s[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 仅检查 \d{4}-\d{2}-\d{2} \d{2}:\d{2}:\d{2} 形状，不检查取值
+inline bool hasDatetimeShape(const char* s, size_t n) {
+    if (n != 19 || !hasDateShape(s, 10) || s[10] != ' ') {
+        return false;
+    }
+    for (size_t i = 11; i < n; i++) {
+        if (i == 13 || i == 16 ? s[i] != ':' : !isDigit(s[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief YYYY-MM-DD，并检查月份和日期是否有效
+ */
+inline bool isDate(const char* s, size_t n) {
+    int year = 0, month = 0, day = 0;
+    if (n != 10 || s[4] != '-' || s[7] != '-') {
+        return false;
+    }
+    if (!readDigits(s, 4, year) || !readDigits(s + 5, 2, month) || !readDigits(s + 8, 2, day)) {
+        return false;
+    }
+    return month >= 1 && month <= 12 && day >= 1 && day <= daysInMonth(year, month);
+}
+
+/**
+ * @brief YYYY-MM-DD HH:MM:SS
+ */
+inline bool isDatetime(const char* s, size_t n) {
+    int hour = 0, minute = 0, second = 0;
+    if (n != 19 || !isDate(s, 10) || s[10] != ' ' || s[13] != ':' || s[16] != ':') {
+        return false;
+    }
+    if (!readDigits(s + 11, 2, hour) || !readDigits(s + 14, 2, minute) || !readDigits(s + 17, 2, second)) {
+        return false;
+    }
+    return hour <= 23 && minute <= 59 && second <= 60;  // 允许闰秒
+}
+
+typedef bool (*Matcher)(const char*, size_t);
+
+/**
+ * @brief 根据正则源码查找等价的手写匹配器
+ *
+ * 只识别框架内置格式使用的正则（见 framework_types.h），其余返回 nullptr。
+ */
+inline Matcher matcherFor(const char* pattern) {
+    struct Entry {
+        const char* source;
+        Matcher matcher;
+    };
+    static const Entry entries[] = {
+        { "^[a-zA-Z0-9._%+-]+@[a-zA-Z0-9.-]+\\.[a-zA-Z]{2,}$", isEmail },
+        { "^[0-9a-fA-F]{8}-[0-9a-fA-F]{4}-[0-9a-fA-F]{4}-[0-9a-fA-F]{4}-[0-9a-fA-F]{12}$", isUuid },
+        { "^(?:(?:25[0-5]|2[0-4]\\d|1\\d\\d|[1-9]?\\d)\\.){3}(?:25[0-5]|2[0-4]\\d|1\\d\\d|[1-9]?\\d)$", isIpv4 },
+    };
+    for (size_t i = 0; i < sizeof(entries) / sizeof(entries[0]); i++) {
+        if (std::strcmp(entries[i].source, pattern) == 0) {
+            return entries[i].matcher;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace fastmatch
+} // namespace uvapi
+
+#endif // UVAPI_FAST_MATCH_H
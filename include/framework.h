@@ -10,17 +10,47 @@
 #define RESTFUL_FRAMEWORK_H
 
 #include "version.h"
-
+#include "route_table.h"
+#include "request_view.h"
+#include "fast_match.h"
+#include "json_stream.h"
+#include "json_writer.h"
+#include "array_support.h"
+#include "route_cache.h"
+#include "route_metrics.h"
+#include "rate_limiter.h"
+#include "object_pool.h"
+#include "string_builder.h"
+#include "response_headers.h"
+#include "cors.h"
+#include "tracing.h"
+#include "pipeline.h"
+#include "static_files.h"
+#include "compression.h"
+#include "offload_pool.h"
+#include "body_stream.h"
+#include "response_stream.h"
+#include "server_options.h"
+#include "health_check.h"
+#include "tls_session.h"
+#include "rcu.h"
+
+#include <cctype>
+#include <cerrno>
+#include <climits>
+#include <cstring>
 #include <string>
 #include <map>
 #include <unordered_map>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <vector>
 #include <sstream>
 #include <algorithm>
 #include <type_traits>
 #include <limits>
+#include <cmath>
 #include <iostream>
 #include <regex>
 #include <ctime>
@@ -446,11 +476,11 @@ inline UvhttpTlsContextPtr makeUvhttpTlsContext(uvhttp_tls_context_t* ptr) {
     return UvhttpTlsContextPtr(ptr, UvhttpTlsContextDeleter());
 }
 
-// char* 自定义删除器（用于 cJSON_Print 返回的字符串）
+// char* 自定义删除器（用于 cJSON_Print 返回的字符串；经 cJSON_free 释放，与 cJSON_InitHooks 设置的分配器一致）
 struct CJsonStringDeleter {
     void operator()(char* ptr) const {
         if (ptr) {
-            free(ptr);
+            cJSON_free(ptr);
         }
     }
 };
@@ -523,6 +553,49 @@ enum class FieldType {
 };
 
 // 字段验证规则
+/**
+ * @brief 预编译的正则表达式
+ *
+ * 在 FieldBuilder::pattern() / ParamBuilder::pattern() 声明时编译一次，
+ * 拷贝验证规则时共享同一个 std::regex 实例。框架内置格式（email、uuid、ipv4）
+ * 的正则会被识别并替换为 fast_match.h 中的手写匹配器。
+ */
+class CompiledPattern {
+public:
+    CompiledPattern() : fast_(nullptr), error_code_(0), compiled_(false) {}
+    
+    explicit CompiledPattern(const std::string& pattern)
+        : fast_(fastmatch::matcherFor(pattern.c_str())), error_code_(0), compiled_(true) {
+        if (fast_) {
+            return;
+        }
+        try {
+            regex_ = std::make_shared<const std::regex>(pattern);
+        } catch (const std::regex_error& e) {
+            error_code_ = static_cast<int>(e.code());
+        }
+    }
+    
+    // 是否已编译（未编译时调用方应回退到按源码编译）
+    bool compiled() const { return compiled_; }
+    // 编译是否成功
+    bool ok() const { return fast_ || regex_; }
+    int errorCode() const { return error_code_; }
+    
+    bool matches(const char* data, size_t size) const {
+        if (fast_) {
+            return fast_(data, size);
+        }
+        return regex_ && std::regex_match(data, data + size, *regex_);
+    }
+    
+private:
+    fastmatch::Matcher fast_;
+    std::shared_ptr<const std::regex> regex_;
+    int error_code_;
+    bool compiled_;
+};
+
 struct FieldValidation {
     bool required;
     int min_length;
@@ -534,6 +607,7 @@ struct FieldValidation {
     bool has_min_value;  // 是否设置了最小值
     bool has_max_value;  // 是否设置了最大值
     std::string pattern;
+    CompiledPattern compiled_pattern;  // pattern() 声明时编译
     std::vector<std::string> enum_values;
     bool has_pattern;  // 是否设置了正则表达式
     bool has_enum;  // 是否设置了枚举值
@@ -546,71 +620,206 @@ struct FieldValidation {
           use_optional(false) {}
 };
 
-// 应用验证规则
-inline std::string applyValidation(const cJSON* json, const FieldValidation& validation, const std::string& field_name) {
-    if (!json) return "";
-    
-    // 字符串长度验证
-    if (cJSON_IsString(json)) {
-        const char* str = json->valuestring;
-        size_t len = strlen(str);
-        std::string value_str(str);
+// 字符串值验证（长度、正则、枚举）
+inline std::string applyStringValidation(const char* str, size_t len, const FieldValidation& validation,
+                                         const std::string& field_name) {
+    if (validation.has_min_length && len < static_cast<size_t>(validation.min_length)) {
+        return "Field '" + field_name + "' must be at least " + std::to_string(validation.min_length) + " characters";
+    }
 
-        if (validation.has_min_length && len < static_cast<size_t>(validation.min_length)) {
-            return "Field '" + field_name + "' must be at least " + std::to_string(validation.min_length) + " characters";
-        }
+    if (validation.has_max_length && len > static_cast<size_t>(validation.max_length)) {
+        return "Field '" + field_name + "' must be at most " + std::to_string(validation.max_length) + " characters";
+    }
 
-        if (validation.has_max_length && len > static_cast<size_t>(validation.max_length)) {
-            return "Field '" + field_name + "' must be at most " + std::to_string(validation.max_length) + " characters";
+    // 正则表达式验证（声明时已编译；手动填写 pattern 的规则在此回退编译）
+    if (validation.has_pattern) {
+        CompiledPattern fallback;
+        const CompiledPattern& compiled = validation.compiled_pattern.compiled()
+            ? validation.compiled_pattern
+            : (fallback = CompiledPattern(validation.pattern));
+        if (!compiled.ok()) {
+            // 正则表达式编译错误，返回详细的错误信息
+            return "Field '" + field_name + "' has invalid regex pattern: " + validation.pattern + " (error code: " + std::to_string(compiled.errorCode()) + ")";
         }
+        if (!compiled.matches(str, len)) {
+            return "Field '" + field_name + "' does not match the required pattern";
+        }
+    }
 
-        // 正则表达式验证
-        if (validation.has_pattern) {
-            try {
-                std::regex regex_pattern(validation.pattern);
-                if (!std::regex_match(value_str, regex_pattern)) {
-                    return "Field '" + field_name + "' does not match the required pattern";
-                }
-            } catch (const std::regex_error& e) {
-                // 正则表达式编译错误，返回详细的错误信息
-                return "Field '" + field_name + "' has invalid regex pattern: " + validation.pattern + " (error code: " + std::to_string(e.code()) + ")";
+    // 枚举值验证
+    if (validation.has_enum) {
+        bool found = false;
+        for (const auto& enum_val : validation.enum_values) {
+            if (enum_val.size() == len && memcmp(enum_val.data(), str, len) == 0) {
+                found = true;
+                break;
             }
         }
-
-        // 枚举值验证
-        if (validation.has_enum) {
-            bool found = false;
-            for (const auto& enum_val : validation.enum_values) {
-                if (value_str == enum_val) {
-                    found = true;
-                    break;
-                }
+        if (!found) {
+            // 构建允许的值列表
+            std::string allowed_values;
+            for (size_t i = 0; i < validation.enum_values.size(); ++i) {
+                if (i > 0) allowed_values += ", ";
+                allowed_values += "'" + validation.enum_values[i] + "'";
             }
-            if (!found) {
-                // 构建允许的值列表
-                std::string allowed_values;
-                for (size_t i = 0; i < validation.enum_values.size(); ++i) {
-                    if (i > 0) allowed_values += ", ";
-                    allowed_values += "'" + validation.enum_values[i] + "'";
+            return "Field '" + field_name + "' must be one of: " + allowed_values;
+        }
+    }
+
+    return "";
+}
+
+// 数值范围验证
+inline std::string applyNumberValidation(double value, const FieldValidation& validation,
+                                         const std::string& field_name) {
+    // 检查最小值
+    if (validation.has_min_value && value < validation.min_value) {
+        return "Field '" + field_name + "' must be at least " + std::to_string(validation.min_value);
+    }
+
+    // 检查最大值
+    if (validation.has_max_value && value > validation.max_value) {
+        return "Field '" + field_name + "' must be at most " + std::to_string(validation.max_value);
+    }
+
+    return "";
+}
+
+// ========== 流式字段读取规则 ==========
+// DslBodySchema（按字段表）与编译期 Schema（static_schema.h）共用，错误信息保持一致
+
+namespace field_rules {
+
+inline bool isNumberStart(char c) {
+    return c == '-' || (c >= '0' && c <= '9');
+}
+
+// 类型不符：校验模式下报错，否则跳过该值（与原 cJSON 路径一致，字段保持不变）
+inline bool typeMismatch(json::Reader& reader, const std::string& name, const char* expected,
+                         bool validate, std::string& message) {
+    if (validate) {
+        message = "Field '" + name + "' must be " + expected;
+        return false;
+    }
+    return reader.skipValue();
+}
+
+template<typename I>
+inline bool inIntegerRange(const json::Number& num) {
+    typedef std::numeric_limits<I> limits;
+    if (num.is_unsigned) {
+        return num.uinteger <= static_cast<uint64_t>(limits::max());
+    }
+    if (num.is_integer) {
+        if (num.integer < 0) {
+            return limits::is_signed && num.integer >= static_cast<int64_t>(limits::min());
+        }
+        return static_cast<uint64_t>(num.integer) <= static_cast<uint64_t>(limits::max());
+    }
+    return num.value >= static_cast<double>(limits::min()) &&
+           num.value < static_cast<double>(limits::max()) + 1.0;
+}
+
+// 元素个数规则（length / minLength / maxLength）
+inline std::string validateArrayLength(size_t count, const FieldValidation& validation, const std::string& name) {
+    if (validation.has_min_length && count < static_cast<size_t>(validation.min_length)) {
+        return "Field '" + name + "' must have at least " + std::to_string(validation.min_length) + " items";
+    }
+    if (validation.has_max_length && count > static_cast<size_t>(validation.max_length)) {
+        return "Field '" + name + "' must have at most " + std::to_string(validation.max_length) + " items";
+    }
+    return "";
+}
+
+// 逐元素规则：数值范围或字符串规则
+template<typename E>
+inline std::string validateElements(const std::vector<E>& vec, const FieldValidation& validation,
+                                    const std::string& name) {
+    if (!validation.has_min_value && !validation.has_max_value) {
+        return "";
+    }
+    for (size_t i = 0; i < vec.size(); ++i) {
+        std::string message = applyNumberValidation(static_cast<double>(vec[i]), validation, name);
+        if (!message.empty()) {
+            return message;
+        }
+    }
+    return "";
+}
+
+inline std::string validateElements(const std::vector<bool>&, const FieldValidation&, const std::string&) {
+    return "";
+}
+
+inline std::string validateElements(const std::vector<std::string>& vec, const FieldValidation& validation,
+                                    const std::string& name) {
+    if (!validation.has_pattern && !validation.has_enum) {
+        return "";
+    }
+    // length() 作用于元素个数，逐元素只检查正则和枚举
+    FieldValidation element_rules = validation;
+    element_rules.has_min_length = false;
+    element_rules.has_max_length = false;
+    for (size_t i = 0; i < vec.size(); ++i) {
+        std::string message = applyStringValidation(vec[i].data(), vec[i].size(), element_rules, name);
+        if (!message.empty()) {
+            return message;
+        }
+    }
+    return "";
+}
+
+/**
+ * @brief 读取标量数组字段（std::vector<int / int64_t / double / bool / std::string>）
+ * @param expected 元素类型不符时的描述，如 "an integer"
+ * @return 失败时返回 false；message 为空表示 JSON 语法错误（由读取器记录）
+ */
+template<typename E>
+bool readArray(json::Reader& reader, std::vector<E>& vec, const FieldValidation& validation,
+               const std::string& name, const char* expected, bool validate, std::string& message) {
+    size_t index = 0;
+    array_utils::ArrayError error = array_utils::readArray(reader, vec, &index);
+    switch (error) {
+        case array_utils::ArrayError::NONE:
+            if (validate) {
+                message = validateArrayLength(vec.size(), validation, name);
+                if (message.empty()) {
+                    message = validateElements(vec, validation, name);
                 }
-                return "Field '" + field_name + "' must be one of: " + allowed_values;
+                return message.empty();
             }
-        }
+            return true;
+        case array_utils::ArrayError::NOT_ARRAY:
+            return typeMismatch(reader, name, "an array", validate, message);
+        case array_utils::ArrayError::SYNTAX:
+            return false;
+        case array_utils::ArrayError::WRONG_TYPE:
+        case array_utils::ArrayError::NOT_INTEGER:
+        case array_utils::ArrayError::OUT_OF_RANGE:
+            break;
+    }
+    if (validate) {
+        message = "Field '" + name + "' item " + std::to_string(index) +
+                  (error == array_utils::ArrayError::OUT_OF_RANGE ? " is out of range" : std::string(" must be ") + expected);
+        return false;
+    }
+    // 非校验模式与标量字段一致：类型不符的值被跳过，字段保持为空
+    vec.clear();
+    return array_utils::skipRest(reader, error);
+}
+
+} // namespace field_rules
+
+// 应用验证规则
+inline std::string applyValidation(const cJSON* json, const FieldValidation& validation, const std::string& field_name) {
+    if (!json) return "";
+    
+    if (cJSON_IsString(json)) {
+        return applyStringValidation(json->valuestring, strlen(json->valuestring), validation, field_name);
     }
     
-    // 数值范围验证
     if (cJSON_IsNumber(json)) {
-        double value = json->valuedouble;
-        
-        // 检查最小值
-        if (validation.has_min_value && value < validation.min_value) {
-            return "Field '" + field_name + "' must be at least " + std::to_string(validation.min_value);
-        }
-        
-        // 检查最大值
-        if (validation.has_max_value && value > validation.max_value) {
-            return "Field '" + field_name + "' must be at most " + std::to_string(validation.max_value);
-        }
+        return applyNumberValidation(json->valuedouble, validation, field_name);
     }
     
     return "";
@@ -631,12 +840,173 @@ struct FieldDefinition {
     BodySchemaBase* nested_schema;  // 嵌套对象的 schema
     BodySchemaBase* item_schema;    // 数组元素的 schema
     FieldType element_type;         // 数组元素的类型（仅对 ARRAY 有效）
+    bool typed_array;               // ARRAY 字段是 std::vector<element_type>，按元素批量读写
     ICustomTypeHandler* custom_handler;  // 自定义类型处理器（仅对 CUSTOM 有效）
     
     FieldDefinition(const std::string& n, FieldType t, size_t o)
         : name(n), type(t), offset(o), is_optional(false), 
           nested_schema(nullptr), item_schema(nullptr), 
-          element_type(FieldType::STRING), custom_handler(nullptr) {}
+          element_type(FieldType::STRING), typed_array(false), custom_handler(nullptr) {}
+};
+
+// ========== 冻结的字段表 ==========
+// 每个 Schema 类型只构建一次，之后只读：解析、序列化和校验都按引用访问，
+// 不再逐次复制 FieldDefinition（名称、正则、枚举列表）。
+
+class FrozenSchema {
+public:
+    static const size_t npos = static_cast<size_t>(-1);
+    
+    // 预计算的字段标志
+    enum : uint8_t {
+        FLAG_REQUIRED = 1 << 0,        // validation.required
+        FLAG_OPTIONAL = 1 << 1,        // 使用 optional 容器
+        FLAG_HAS_VALIDATION = 1 << 2,  // 存在长度/范围/正则/枚举等值校验
+        FLAG_STRING_VALUE = 1 << 3     // 以 JSON 字符串表示（STRING/DATE/EMAIL 等）
+    };
+    
+    explicit FrozenSchema(const std::vector<FieldDefinition>& defs)
+        : fields_(defs), seed_(0), mask_(0) {
+        flags_.reserve(fields_.size());
+        key_offsets_.reserve(fields_.size() + 1);
+        for (size_t i = 0; i < fields_.size(); ++i) {
+            const FieldDefinition& field = fields_[i];
+            flags_.push_back(computeFlags(field));
+            // 预编码键前缀 "name":，序列化时整段追加
+            key_offsets_.push_back(keys_.size());
+            json::appendQuoted(keys_, field.name.data(), field.name.size());
+            keys_ += ':';
+        }
+        key_offsets_.push_back(keys_.size());
+        if (!fields_.empty()) {
+            buildIndex();
+        }
+    }
+    
+    const std::vector<FieldDefinition>& fields() const { return fields_; }
+    size_t size() const { return fields_.size(); }
+    const FieldDefinition& operator[](size_t index) const { return fields_[index]; }
+    
+    uint8_t flags(size_t index) const { return flags_[index]; }
+    bool isRequired(size_t index) const { return (flags_[index] & FLAG_REQUIRED) != 0; }
+    
+    // 已转义的键前缀（含引号和冒号），配合 json::Writer::rawKey() 使用
+    const char* keyPrefix(size_t index) const { return keys_.data() + key_offsets_[index]; }
+    size_t keyPrefixSize(size_t index) const { return key_offsets_[index + 1] - key_offsets_[index]; }
+    
+    /**
+     * @brief 按字段名查找下标
+     * @return 字段下标，未找到返回 npos
+     *
+     * 构建时挑选使所有字段名互不冲突的哈希种子，查找通常只比较一次；
+     * 找不到无冲突种子时退化为线性探测，结果仍然正确。
+     */
+    size_t find(const char* name, size_t len) const {
+        if (fields_.empty()) {
+            return npos;
+        }
+        size_t slot = static_cast<size_t>(hash(name, len, seed_)) & mask_;
+        while (slots_[slot] != kEmpty) {
+            const std::string& candidate = fields_[slots_[slot]].name;
+            if (candidate.size() == len && std::memcmp(candidate.data(), name, len) == 0) {
+                return slots_[slot];
+            }
+            slot = (slot + 1) & mask_;
+        }
+        return npos;
+    }
+    
+    size_t find(const StringSlice& name) const { return find(name.data, name.size); }
+    size_t find(const std::string& name) const { return find(name.data(), name.size()); }
+    
+private:
+    static const uint32_t kEmpty = 0xFFFFFFFFu;
+    static const uint32_t kSeedAttempts = 64;
+    
+    std::vector<FieldDefinition> fields_;
+    std::vector<uint8_t> flags_;
+    std::string keys_;                 // 所有键前缀连续存放
+    std::vector<size_t> key_offsets_;  // keys_ 中每个键前缀的起点（末尾多一个哨兵）
+    std::vector<uint32_t> slots_;      // 开放寻址表：字段下标或 kEmpty
+    uint32_t seed_;
+    size_t mask_;
+    
+    // FNV-1a，带种子
+    static uint32_t hash(const char* s, size_t n, uint32_t seed) {
+        uint32_t h = 2166136261u ^ seed;
+        for (size_t i = 0; i < n; ++i) {
+            h ^= static_cast<unsigned char>(s[i]);
+            h *= 16777619u;
+        }
+        return h ^ (h >> 15);
+    }
+    
+    static uint8_t computeFlags(const FieldDefinition& field) {
+        const FieldValidation& v = field.validation;
+        uint8_t flags = 0;
+        if (v.required) flags |= FLAG_REQUIRED;
+        if (field.is_optional) flags |= FLAG_OPTIONAL;
+        if (v.has_min_length || v.has_max_length || v.has_min_value || v.has_max_value ||
+            v.has_pattern || v.has_enum) {
+            flags |= FLAG_HAS_VALIDATION;
+        }
+        switch (field.type) {
+            case FieldType::STRING:
+            case FieldType::DATE:
+            case FieldType::DATETIME:
+            case FieldType::EMAIL:
+            case FieldType::URL:
+            case FieldType::UUID:
+                flags |= FLAG_STRING_VALUE;
+                break;
+            default:
+                break;
+        }
+        return flags;
+    }
+    
+    // 表大小取不小于 2 倍字段数的 2 的幂，依次尝试种子直到没有冲突
+    void buildIndex() {
+        size_t capacity = 4;
+        while (capacity < fields_.size() * 2) {
+            capacity <<= 1;
+        }
+        mask_ = capacity - 1;
+        for (uint32_t seed = 0; seed < kSeedAttempts; ++seed) {
+            if (place(seed, false)) {
+                return;
+            }
+        }
+        place(0, true);
+    }
+    
+    bool place(uint32_t seed, bool allow_probe) {
+        slots_.assign(mask_ + 1, static_cast<uint32_t>(kEmpty));
+        seed_ = seed;
+        for (size_t i = 0; i < fields_.size(); ++i) {
+            const std::string& name = fields_[i].name;
+            size_t slot = static_cast<size_t>(hash(name.data(), name.size(), seed)) & mask_;
+            if (slots_[slot] != kEmpty) {
+                if (!allow_probe) {
+                    return false;
+                }
+                // 重名字段只保留第一个
+                bool duplicate = false;
+                while (slots_[slot] != kEmpty) {
+                    if (fields_[slots_[slot]].name == name) {
+                        duplicate = true;
+                        break;
+                    }
+                    slot = (slot + 1) & mask_;
+                }
+                if (duplicate) {
+                    continue;
+                }
+            }
+            slots_[slot] = static_cast<uint32_t>(i);
+        }
+        return true;
+    }
 };
 
 // Body Schema 基类
@@ -644,10 +1014,70 @@ class BodySchemaBase {
 public:
     virtual ~BodySchemaBase() {}
     virtual std::vector<FieldDefinition> fields() const = 0;
+    
+    /**
+     * @brief 冻结的字段表：首次访问时由 fields() 构建一次，此后按引用共享
+     *
+     * 构建过程线程安全（多核模式下多个工作线程可能同时首次访问）。
+     * fields() 的结果在构建后不再重新读取。
+     */
+    const FrozenSchema& frozen() const {
+        std::call_once(frozen_once_, [this]() {
+            frozen_.reset(new FrozenSchema(fields()));
+        });
+        return *frozen_;
+    }
+    
     virtual std::string toJson(void* instance) const = 0;
     virtual bool fromJson(const std::string& json, void* instance) const = 0;
     virtual std::string validate(const cJSON* json) const = 0;
     
+    /**
+     * @brief 从 JSON 文本解析到实例（不构造 cJSON DOM）
+     * @param validate 为 true 时同时执行字段级校验和 validateBody()，第一个错误即返回
+     * @param error 失败时输出错误信息，可为 nullptr
+     *
+     * 默认实现回退到 fromJson() + validateObject()；DslBodySchema 以字段表驱动单次扫描。
+     */
+    virtual bool parseJson(const char* data, size_t size, void* instance, bool validate,
+                           std::string* error) const {
+        if (!fromJson(std::string(data, size), instance)) {
+            if (error) *error = "Invalid JSON body";
+            return false;
+        }
+        if (validate) {
+            std::string message = validateObject(instance);
+            if (!message.empty()) {
+                if (error) *error = message;
+                return false;
+            }
+        }
+        return true;
+    }
+    
+    /**
+     * @brief 把实例序列化为紧凑 JSON，直接追加到写入器的缓冲区
+     *
+     * 默认实现回退到 toJson()；DslBodySchema 按字段表直接写入。
+     */
+    virtual void writeJson(const void* instance, json::Writer& out) const {
+        out.raw(toJson(const_cast<void*>(instance)));
+    }
+    
+    /**
+     * @brief 从读取器的当前位置解析一个对象值（用于嵌套对象，与外层共用一次扫描）
+     *
+     * 默认实现先跳过该值得到原始切片，再交给 parseJson()。
+     */
+    virtual bool parseFrom(json::Reader& reader, void* instance, bool validate, std::string* error) const {
+        StringSlice raw;
+        if (!reader.skipValue(&raw)) {
+            if (error) *error = "Invalid JSON: " + reader.describeError();
+            return false;
+        }
+        return parseJson(raw.data, raw.size, instance, validate, error);
+    }
+    
     // 整体校验方法（可选实现，如果不实现则使用默认实现）
     virtual std::string validateBody(void* /*instance*/) const {
         // 默认实现：无额外校验，返回空字符串表示通过
@@ -659,6 +1089,10 @@ public:
         // 默认实现：使用序列化+解析方式（子类应该重写此方法以提升性能）
         return "";
     }
+    
+private:
+    mutable std::once_flag frozen_once_;
+    mutable std::unique_ptr<FrozenSchema> frozen_;
 };
 
 // ========== DSL 风格的 Body Schema ==========
@@ -760,6 +1194,7 @@ public:
     // 正则表达式
     FieldBuilder& pattern(const std::string& regex) {
         validation_.pattern = regex;
+        validation_.compiled_pattern = CompiledPattern(regex);
         validation_.has_pattern = true;
         return *this;
     }
@@ -801,6 +1236,16 @@ public:
         return *this;
     }
     
+    // 声明 ARRAY 字段为 std::vector 标量数组：STRING / INT / INT64 / DOUBLE / BOOL，
+    // 对应 std::vector<std::string / int / int64_t / double / bool>；其他元素类型不支持
+    FieldBuilder& elements(FieldType element_type) {
+        element_type_ = element_type;
+        typed_array_ = element_type == FieldType::STRING || element_type == FieldType::INT ||
+                       element_type == FieldType::INT64 || element_type == FieldType::DOUBLE ||
+                       element_type == FieldType::BOOL;
+        return *this;
+    }
+    
     // 生成 FieldDefinition
     FieldDefinition build() const {
         FieldDefinition def(name_, type_, offset_);
@@ -808,12 +1253,16 @@ public:
         def.is_optional = validation_.use_optional;
         def.nested_schema = nested_schema_;
         def.item_schema = item_schema_;
+        def.element_type = element_type_;
+        def.typed_array = typed_array_ && type_ == FieldType::ARRAY;
         return def;
     }
     
 private:
     BodySchemaBase* nested_schema_ = nullptr;
     BodySchemaBase* item_schema_ = nullptr;
+    FieldType element_type_ = FieldType::STRING;
+    bool typed_array_ = false;
 };
 
 // Schema 构建器
@@ -965,15 +1414,110 @@ public:
 #define OPTIONAL_ARRAY(name, offset) ARRAY_FIELD(name, offset).optional()
 #define OPTIONAL_ARRAY_OPT(name, offset) ARRAY_FIELD(name, offset).optional().useOptional()
 
-// Body 序列化辅助函数
+// ========== 编译期 Schema 接入点 ==========
+// UVAPI_SCHEMA 声明的类型（见 static_schema.h）在这里被识别，序列化、解析和校验直接展开为
+// 按成员类型特化的代码；其余类型仍经 instance.schema() 的虚调用
+
+namespace schema {
+
+template<typename T> class StaticSchema;
+
+namespace detail {
+struct NoStaticSchema {};
+} // namespace detail
+
+// 未声明编译期 Schema 的类型匹配到这里（UVAPI_SCHEMA 生成的重载经 ADL 找到，优先于它）；只用于 decltype
+detail::NoStaticSchema uvapiSchemaOf(const void*);
+
 template<typename T>
-std::string toJson(const T& instance) {
-    BodySchemaBase* schema = instance.schema();
-    if (!schema) {
+struct HasStaticSchema {
+    static const bool value = !std::is_same<
+        decltype(uvapiSchemaOf(static_cast<const T*>(nullptr))), detail::NoStaticSchema>::value;
+};
+
+} // namespace schema
+
+// 按类型选择 Schema 的访问方式：运行时 Schema
+template<typename T, bool Static = schema::HasStaticSchema<T>::value>
+struct SchemaAccess {
+    static bool defined(const T& instance) { return instance.schema() != nullptr; }
+    
+    static void write(const T& instance, json::Writer& out) {
+        instance.schema()->writeJson(&instance, out);
+    }
+    
+    static bool parse(const char* data, size_t size, T& instance, bool validate, std::string* error) {
+        return instance.schema()->parseJson(data, size, &instance, validate, error);
+    }
+    
+    static std::string validate(const T& instance) {
+        return instance.schema()->validateObject(const_cast<T*>(&instance));
+    }
+};
+
+// 编译期 Schema：不经虚调用
+template<typename T>
+struct SchemaAccess<T, true> {
+    static bool defined(const T&) { return true; }
+    
+    static void write(const T& instance, json::Writer& out) {
+        schema::StaticSchema<T>::write(instance, out);
+    }
+    
+    static bool parse(const char* data, size_t size, T& instance, bool validate, std::string* error) {
+        return schema::StaticSchema<T>::parseJson(data, size, instance, validate, error);
+    }
+    
+    static std::string validate(const T& instance) {
+        return schema::StaticSchema<T>::validateObject(instance);
+    }
+};
+
+// Body 序列化辅助函数：追加到已有缓冲区（缓冲区可跨请求复用）
+template<typename T>
+void appendJson(const T& instance, std::string& out) {
+    if (!SchemaAccess<T>::defined(instance)) {
         std::cerr << "Error: Schema not defined" << std::endl;
-        return "{}";
+        out.append("{}", 2);
+        return;
+    }
+    json::Writer writer(out);
+    SchemaAccess<T>::write(instance, writer);
+}
+
+// 重载：已编码的 JSON 字符串按原样追加
+inline void appendJson(const char* json_str, std::string& out) {
+    if (json_str) {
+        out.append(json_str);
+    }
+}
+
+inline void appendJson(const std::string& json_str, std::string& out) {
+    out.append(json_str);
+}
+
+// 列表序列化：所有元素写入同一个缓冲区
+template<typename T>
+void appendJson(const std::vector<T>& instances, std::string& out) {
+    json::Writer writer(out);
+    writer.beginArray();
+    for (size_t i = 0; i < instances.size(); ++i) {
+        if (!SchemaAccess<T>::defined(instances[i])) {
+            std::cerr << "Error: Schema not defined" << std::endl;
+            writer.null();
+            continue;
+        }
+        SchemaAccess<T>::write(instances[i], writer);
     }
-    return schema->toJson(reinterpret_cast<void*>(&instance));
+    writer.endArray();
+}
+
+// Body 序列化辅助函数
+template<typename T>
+std::string toJson(const T& instance) {
+    std::string result;
+    appendJson(instance, result);
+    return result;
 }
 
 // 重载：直接返回字符串
@@ -1026,81 +1570,158 @@ public:
         return builder_.fields();
     }
     
-    // 序列化
+    // 序列化（紧凑 JSON）
     std::string toJson(void* instance) const override {
-        cJSON* json = cJSON_CreateObject();
-        if (!json) return "{}";
+        std::string result;
+        json::Writer writer(result);
+        writeJson(instance, writer);
+        return result;
+    }
+    
+    // 按字段表直接写入，不构造 cJSON 树
+    void writeJson(const void* instance, json::Writer& out) const override {
+        const FrozenSchema& defs = frozen();
+        void* object = const_cast<void*>(instance);
         
-        for (const auto& field : fields()) {
-            // 对于可选字段，检查是否有有效值
-            if (!field.validation.required && !hasValidValue(instance, field.offset, field.type)) {
+        out.beginObject();
+        for (size_t i = 0; i < defs.size(); ++i) {
+            const FieldDefinition& field = defs[i];
+            // 对于可选字段，检查是否有有效值（标量数组为非空）
+            if (!field.validation.required &&
+                !(field.typed_array ? !typedArrayEmpty(static_cast<const char*>(instance) + field.offset, field)
+                                    : hasValidValue(object, field.offset, field.type))) {
                 continue; // 跳过无有效值的可选字段
             }
             
             // 对于 std::optional 字段，检查是否有值
-            if (field.is_optional && !hasOptionalValue(instance, field.offset, field.type)) {
+            if (field.is_optional && !hasOptionalValue(object, field.offset, field.type)) {
                 continue; // 跳过空的 std::optional 字段
             }
             
-            cJSON* field_json;
-            if (field.is_optional) {
-                field_json = createOptionalJsonField(instance, field.offset, field.type);
-            } else {
-                field_json = createJsonField(instance, field.offset, field.type);
-            }
-            
-            if (field_json) {
-                cJSON_AddItemToObject(json, field.name.c_str(), field_json);
-            }
+            out.rawKey(defs.keyPrefix(i), defs.keyPrefixSize(i));
+            writeField(static_cast<const char*>(instance) + field.offset, field, out);
         }
-        
-        char* json_str = cJSON_Print(json);
-        std::string result(json_str ? json_str : "{}");
-        if (json_str) free(json_str);
-        cJSON_Delete(json);
-        
-        return result;
+        out.endObject();
     }
     
-    // 反序列化
+    // 反序列化（流式解析，不执行字段校验）
     bool fromJson(const std::string& json_str, void* instance) const override {
-        cJSON* json = cJSON_Parse(json_str.c_str());
-        if (!json || !cJSON_IsObject(json)) {
-            if (json) cJSON_Delete(json);
+        return parseJson(json_str.data(), json_str.size(), instance, false, nullptr);
+    }
+    
+    // 流式解析：按字段表单次扫描，直接写入字段偏移
+    bool parseJson(const char* data, size_t size, void* instance, bool validate,
+                   std::string* error) const override {
+        json::Reader reader(data, size);
+        if (!parseFrom(reader, instance, validate, error)) {
             return false;
         }
-        
-        for (const auto& field : fields()) {
-            cJSON* field_json = cJSON_GetObjectItem(json, field.name.c_str());
-            if (field_json) {
-                if (field.is_optional) {
-                    setOptionalValue(instance, field.offset, field.type, field_json);
-                } else {
-                    setFieldValue(instance, field.offset, field.type, field_json);
-                }
-            } else if (!field.validation.required) {
-                // 可选字段：如果 JSON 中不存在，设置默认值
-                if (field.is_optional) {
-                    // 对于 std::optional 字段，设置为空值
-                    clearOptionalValue(instance, field.offset, field.type);
-                } else {
-                    setDefaultValue(instance, field.offset, field.type);
-                }
-            }
+        if (!reader.finish()) {
+            if (error) *error = "Invalid JSON: " + reader.describeError();
+            return false;
         }
-        
-        cJSON_Delete(json);
         return true;
     }
     
-    // 验证
-    std::string validate(const cJSON* json) const override {
-        if (!cJSON_IsObject(json)) {
-            return "Request body must be a JSON object";
+    bool parseFrom(json::Reader& reader, void* instance, bool validate, std::string* error) const override {
+        const FrozenSchema& defs = frozen();
+        
+        // 记录已出现的字段（字段数不超过 64 时不分配内存）
+        uint8_t seen_inline[64];
+        std::vector<uint8_t> seen_heap;
+        uint8_t* seen = seen_inline;
+        if (defs.size() > sizeof(seen_inline)) {
+            seen_heap.assign(defs.size(), 0);
+            seen = seen_heap.data();
+        } else {
+            std::memset(seen_inline, 0, sizeof(seen_inline));
+        }
+        
+        char first = reader.peek();
+        if (first != '{') {
+            if (first == '\0' || reader.failed()) {
+                reader.fail("Expected object");
+                if (error) *error = "Invalid JSON: " + reader.describeError();
+            } else if (error) {
+                *error = "Request body must be a JSON object";
+            }
+            return false;
+        }
+        
+        StringSlice key;
+        reader.beginObject();
+        while (reader.nextMember(key)) {
+            size_t index = defs.find(key);
+            if (index == FrozenSchema::npos) {
+                // 未声明的字段：跳过
+                if (!reader.skipValue()) {
+                    break;
+                }
+                continue;
+            }
+            
+            const FieldDefinition& field = defs[index];
+            if (reader.readNull()) {
+                // null 视为未提供
+                if (validate && field.validation.required) {
+                    if (error) *error = "Field '" + field.name + "' is required";
+                    return false;
+                }
+                continue;
+            }
+            
+            std::string message;
+            if (!readField(reader, field, instance, validate, message)) {
+                if (error) {
+                    *error = message.empty() ? "Invalid JSON: " + reader.describeError() : message;
+                }
+                return false;
+            }
+            seen[index] = 1;
+        }
+        if (reader.failed()) {
+            if (error) *error = "Invalid JSON: " + reader.describeError();
+            return false;
+        }
+        
+        // 未出现的字段：必填字段报错，可选字段写入默认值
+        for (size_t i = 0; i < defs.size(); ++i) {
+            if (seen[i]) {
+                continue;
+            }
+            const FieldDefinition& field = defs[i];
+            if (field.validation.required) {
+                if (validate) {
+                    if (error) *error = "Field '" + field.name + "' is required";
+                    return false;
+                }
+            } else if (field.typed_array) {
+                clearTypedArray(static_cast<char*>(instance) + field.offset, field);
+            } else if (field.is_optional) {
+                clearOptionalValue(instance, field.offset, field.type);
+            } else {
+                setDefaultValue(instance, field.offset, field.type);
+            }
+        }
+        
+        if (validate) {
+            std::string message = validateBody(instance);
+            if (!message.empty()) {
+                if (error) *error = message;
+                return false;
+            }
+        }
+        return true;
+    }
+    
+    // 验证
+    std::string validate(const cJSON* json) const override {
+        if (!cJSON_IsObject(json)) {
+            return "Request body must be a JSON object";
         }
         
         // 检查必填字段
-        for (const auto& field : fields()) {
+        for (const auto& field : frozen().fields()) {
             if (field.validation.required) {
                 cJSON* field_json = cJSON_GetObjectItem(json, field.name.c_str());
                 if (!field_json) {
@@ -1110,7 +1731,7 @@ public:
         }
         
         // 验证每个字段的值
-        for (const auto& field : fields()) {
+        for (const auto& field : frozen().fields()) {
             cJSON* field_json = cJSON_GetObjectItem(json, field.name.c_str());
             
             // 如果字段不存在且不是必填的，跳过验证
@@ -1179,6 +1800,28 @@ protected:
         return FieldBuilder(name, FieldType::ARRAY, offset);
     }
     
+    // 定义标量数组字段（std::vector，批量解析和序列化；length() 等长度规则作用于元素个数，
+    // 数值范围和字符串规则作用于每个元素）
+    FieldBuilder stringArray(const std::string& name, size_t offset) {
+        return FieldBuilder(name, FieldType::ARRAY, offset).elements(FieldType::STRING);
+    }
+    
+    FieldBuilder intArray(const std::string& name, size_t offset) {
+        return FieldBuilder(name, FieldType::ARRAY, offset).elements(FieldType::INT);
+    }
+    
+    FieldBuilder int64Array(const std::string& name, size_t offset) {
+        return FieldBuilder(name, FieldType::ARRAY, offset).elements(FieldType::INT64);
+    }
+    
+    FieldBuilder numberArray(const std::string& name, size_t offset) {
+        return FieldBuilder(name, FieldType::ARRAY, offset).elements(FieldType::DOUBLE);
+    }
+    
+    FieldBuilder boolArray(const std::string& name, size_t offset) {
+        return FieldBuilder(name, FieldType::ARRAY, offset).elements(FieldType::BOOL);
+    }
+    
     // 定义字段（简化版本）
     void field(const std::string& name, FieldType type, size_t offset) {
         builder_.addField(name, type, offset);
@@ -1208,110 +1851,6 @@ protected:
     }
     
 private:
-    // 创建 JSON 字段
-    static cJSON* createJsonField(void* instance, size_t offset, FieldType type) {
-        if (!instance) return nullptr;
-        
-        char* field_ptr = static_cast<char*>(instance) + offset;
-        
-        switch (type) {
-            case FieldType::STRING:
-            case FieldType::DATE:
-            case FieldType::DATETIME:
-            case FieldType::EMAIL:
-            case FieldType::URL:
-            case FieldType::UUID:
-                return cJSON_CreateString(reinterpret_cast<std::string*>(field_ptr)->c_str());
-            case FieldType::INT8:
-                return cJSON_CreateNumber(static_cast<int>(*reinterpret_cast<int8_t*>(field_ptr)));
-            case FieldType::INT16:
-                return cJSON_CreateNumber(static_cast<int>(*reinterpret_cast<int16_t*>(field_ptr)));
-            case FieldType::INT:
-                return cJSON_CreateNumber(*reinterpret_cast<int*>(field_ptr));
-            case FieldType::INT64:
-                return cJSON_CreateNumber(static_cast<double>(*reinterpret_cast<int64_t*>(field_ptr)));
-            case FieldType::UINT8:
-                return cJSON_CreateNumber(static_cast<int>(*reinterpret_cast<uint8_t*>(field_ptr)));
-            case FieldType::UINT16:
-                return cJSON_CreateNumber(static_cast<int>(*reinterpret_cast<uint16_t*>(field_ptr)));
-            case FieldType::UINT32:
-                return cJSON_CreateNumber(static_cast<double>(*reinterpret_cast<uint32_t*>(field_ptr)));
-            case FieldType::UINT64:
-                return cJSON_CreateNumber(static_cast<double>(*reinterpret_cast<uint64_t*>(field_ptr)));
-            case FieldType::FP32:
-            case FieldType::FLOAT:
-                return cJSON_CreateNumber(*reinterpret_cast<float*>(field_ptr));
-            case FieldType::DOUBLE:
-                return cJSON_CreateNumber(*reinterpret_cast<double*>(field_ptr));
-            case FieldType::BOOL:
-                return cJSON_CreateBool(*reinterpret_cast<bool*>(field_ptr));
-            case FieldType::ARRAY:
-            case FieldType::OBJECT:
-            case FieldType::CUSTOM:
-                return cJSON_CreateNull();
-        }
-        
-        return nullptr;
-    }
-    
-    // 创建 std::optional JSON 字段
-    static cJSON* createOptionalJsonField(void* instance, size_t offset, FieldType type) {
-        if (!instance) return nullptr;
-        
-        char* field_ptr = static_cast<char*>(instance) + offset;
-        
-        switch (type) {
-            case FieldType::STRING: {
-                auto& opt = *reinterpret_cast<uvapi::optional<std::string>*>(field_ptr);
-                if (opt.has_value()) {
-                    return cJSON_CreateString(opt->c_str());
-                }
-                break;
-            }
-            case FieldType::INT: {
-                auto& opt = *reinterpret_cast<uvapi::optional<int>*>(field_ptr);
-                if (opt.has_value()) {
-                    return cJSON_CreateNumber(*opt);
-                }
-                break;
-            }
-            case FieldType::INT64: {
-                auto& opt = *reinterpret_cast<uvapi::optional<int64_t>*>(field_ptr);
-                if (opt.has_value()) {
-                    return cJSON_CreateNumber(static_cast<double>(*opt));
-                }
-                break;
-            }
-            case FieldType::FLOAT: {
-                auto& opt = *reinterpret_cast<uvapi::optional<float>*>(field_ptr);
-                if (opt.has_value()) {
-                    return cJSON_CreateNumber(*opt);
-                }
-                break;
-            }
-            case FieldType::DOUBLE: {
-                auto& opt = *reinterpret_cast<uvapi::optional<double>*>(field_ptr);
-                if (opt.has_value()) {
-                    return cJSON_CreateNumber(*opt);
-                }
-                break;
-            }
-            case FieldType::BOOL: {
-                auto& opt = *reinterpret_cast<uvapi::optional<bool>*>(field_ptr);
-                if (opt.has_value()) {
-                    return cJSON_CreateBool(*opt);
-                }
-                break;
-            }
-            case FieldType::ARRAY:
-            case FieldType::OBJECT:
-            case FieldType::CUSTOM:
-                return cJSON_CreateNull();
-        }
-        
-        return nullptr;
-    }
-    
     // 设置字段值
     static void setFieldValue(void* instance, size_t offset, FieldType type, const cJSON* json) {
         if (!instance || !json) return;
@@ -1392,6 +1931,352 @@ private:
         }
     }
     
+    template<typename V>
+    static const V& optionalValue(const char* field_ptr) {
+        return *(*reinterpret_cast<const uvapi::optional<V>*>(field_ptr));
+    }
+    
+    // 写入单个字段值（调用前已确认字段需要输出）
+    static void writeField(const char* field_ptr, const FieldDefinition& field, json::Writer& out) {
+        if (field.is_optional) {
+            switch (field.type) {
+                case FieldType::STRING:
+                    out.string(optionalValue<std::string>(field_ptr));
+                    return;
+                case FieldType::INT:
+                    out.integer(optionalValue<int>(field_ptr));
+                    return;
+                case FieldType::INT64:
+                    out.integer(optionalValue<int64_t>(field_ptr));
+                    return;
+                case FieldType::FLOAT:
+                    out.number(optionalValue<float>(field_ptr));
+                    return;
+                case FieldType::DOUBLE:
+                    out.number(optionalValue<double>(field_ptr));
+                    return;
+                case FieldType::BOOL:
+                    out.boolean(optionalValue<bool>(field_ptr));
+                    return;
+                default:
+                    out.null();
+                    return;
+            }
+        }
+        
+        switch (field.type) {
+            case FieldType::STRING:
+            case FieldType::DATE:
+            case FieldType::DATETIME:
+            case FieldType::EMAIL:
+            case FieldType::URL:
+            case FieldType::UUID:
+                out.string(*reinterpret_cast<const std::string*>(field_ptr));
+                return;
+            case FieldType::INT8:
+                out.integer(*reinterpret_cast<const int8_t*>(field_ptr));
+                return;
+            case FieldType::INT16:
+                out.integer(*reinterpret_cast<const int16_t*>(field_ptr));
+                return;
+            case FieldType::INT:
+                out.integer(*reinterpret_cast<const int*>(field_ptr));
+                return;
+            case FieldType::INT64:
+                out.integer(*reinterpret_cast<const int64_t*>(field_ptr));
+                return;
+            case FieldType::UINT8:
+                out.uinteger(*reinterpret_cast<const uint8_t*>(field_ptr));
+                return;
+            case FieldType::UINT16:
+                out.uinteger(*reinterpret_cast<const uint16_t*>(field_ptr));
+                return;
+            case FieldType::UINT32:
+                out.uinteger(*reinterpret_cast<const uint32_t*>(field_ptr));
+                return;
+            case FieldType::UINT64:
+                out.uinteger(*reinterpret_cast<const uint64_t*>(field_ptr));
+                return;
+            case FieldType::FP32:
+            case FieldType::FLOAT:
+                out.number(*reinterpret_cast<const float*>(field_ptr));
+                return;
+            case FieldType::DOUBLE:
+                out.number(*reinterpret_cast<const double*>(field_ptr));
+                return;
+            case FieldType::BOOL:
+                out.boolean(*reinterpret_cast<const bool*>(field_ptr));
+                return;
+            case FieldType::OBJECT:
+                if (field.nested_schema) {
+                    field.nested_schema->writeJson(field_ptr, out);
+                    return;
+                }
+                out.null();
+                return;
+            case FieldType::ARRAY:
+                if (field.typed_array) {
+                    writeTypedArray(field_ptr, field, out);
+                    return;
+                }
+                out.null();
+                return;
+            case FieldType::CUSTOM:
+                out.null();
+                return;
+        }
+        out.null();
+    }
+    
+    // ========== 标量数组字段 ==========
+    
+    static void writeTypedArray(const char* field_ptr, const FieldDefinition& field, json::Writer& out) {
+        switch (field.element_type) {
+            case FieldType::INT:
+                array_utils::writeArray(out, *reinterpret_cast<const std::vector<int>*>(field_ptr));
+                return;
+            case FieldType::INT64:
+                array_utils::writeArray(out, *reinterpret_cast<const std::vector<int64_t>*>(field_ptr));
+                return;
+            case FieldType::DOUBLE:
+                array_utils::writeArray(out, *reinterpret_cast<const std::vector<double>*>(field_ptr));
+                return;
+            case FieldType::BOOL:
+                array_utils::writeArray(out, *reinterpret_cast<const std::vector<bool>*>(field_ptr));
+                return;
+            default:
+                array_utils::writeArray(out, *reinterpret_cast<const std::vector<std::string>*>(field_ptr));
+                return;
+        }
+    }
+    
+    template<typename E>
+    static const std::vector<E>& typedArray(const char* field_ptr) {
+        return *reinterpret_cast<const std::vector<E>*>(field_ptr);
+    }
+    
+    static size_t typedArraySize(const char* field_ptr, const FieldDefinition& field) {
+        switch (field.element_type) {
+            case FieldType::INT: return typedArray<int>(field_ptr).size();
+            case FieldType::INT64: return typedArray<int64_t>(field_ptr).size();
+            case FieldType::DOUBLE: return typedArray<double>(field_ptr).size();
+            case FieldType::BOOL: return typedArray<bool>(field_ptr).size();
+            default: return typedArray<std::string>(field_ptr).size();
+        }
+    }
+    
+    static bool typedArrayEmpty(const char* field_ptr, const FieldDefinition& field) {
+        return typedArraySize(field_ptr, field) == 0;
+    }
+    
+    static void clearTypedArray(char* field_ptr, const FieldDefinition& field) {
+        switch (field.element_type) {
+            case FieldType::INT: reinterpret_cast<std::vector<int>*>(field_ptr)->clear(); return;
+            case FieldType::INT64: reinterpret_cast<std::vector<int64_t>*>(field_ptr)->clear(); return;
+            case FieldType::DOUBLE: reinterpret_cast<std::vector<double>*>(field_ptr)->clear(); return;
+            case FieldType::BOOL: reinterpret_cast<std::vector<bool>*>(field_ptr)->clear(); return;
+            default: reinterpret_cast<std::vector<std::string>*>(field_ptr)->clear(); return;
+        }
+    }
+    
+    // 标量数组字段：按元素类型取出 std::vector 后交给共用的读取规则
+    template<typename E>
+    static bool readTypedArray(json::Reader& reader, const FieldDefinition& field, char* field_ptr,
+                               const char* expected, bool validate, std::string& message) {
+        return field_rules::readArray(reader, *reinterpret_cast<std::vector<E>*>(field_ptr), field.validation,
+                                      field.name, expected, validate, message);
+    }
+    
+    static bool isStringType(FieldType type) {
+        return type == FieldType::STRING || type == FieldType::DATE || type == FieldType::DATETIME ||
+               type == FieldType::EMAIL || type == FieldType::URL || type == FieldType::UUID;
+    }
+    
+    static bool typeMismatch(json::Reader& reader, const FieldDefinition& field, const char* expected,
+                             bool validate, std::string& message) {
+        return field_rules::typeMismatch(reader, field.name, expected, validate, message);
+    }
+    
+    // 读取整数字段；optional_ok 表示该类型支持 optional 容器
+    template<typename I>
+    static bool readIntegerField(json::Reader& reader, const FieldDefinition& field, char* field_ptr,
+                                 bool optional_ok, bool validate, std::string& message) {
+        if (!field_rules::isNumberStart(reader.peek())) {
+            return typeMismatch(reader, field, "an integer", validate, message);
+        }
+        json::Number num;
+        if (!reader.readNumber(num)) {
+            return false;
+        }
+        bool in_range = field_rules::inIntegerRange<I>(num);
+        if (validate) {
+            // 与 cJSON 路径一致：1e3 这类整值浮点数也按整数接受
+            if (!num.is_integer && num.value != std::floor(num.value)) {
+                message = "Field '" + field.name + "' must be an integer";
+                return false;
+            }
+            if (!in_range) {
+                message = "Field '" + field.name + "' is out of range";
+                return false;
+            }
+            message = applyNumberValidation(num.value, field.validation, field.name);
+            if (!message.empty()) {
+                return false;
+            }
+        }
+        
+        I value;
+        if (!in_range) {
+            value = num.value < 0 ? std::numeric_limits<I>::min() : std::numeric_limits<I>::max();
+        } else if (num.is_unsigned) {
+            value = static_cast<I>(num.uinteger);
+        } else if (num.is_integer) {
+            value = static_cast<I>(num.integer);
+        } else {
+            value = static_cast<I>(num.value);
+        }
+        if (!field.is_optional) {
+            *reinterpret_cast<I*>(field_ptr) = value;
+        } else if (optional_ok) {
+            *reinterpret_cast<uvapi::optional<I>*>(field_ptr) = value;
+        }
+        return true;
+    }
+    
+    template<typename F>
+    static bool readFloatField(json::Reader& reader, const FieldDefinition& field, char* field_ptr,
+                               bool optional_ok, bool validate, std::string& message) {
+        if (!field_rules::isNumberStart(reader.peek())) {
+            return typeMismatch(reader, field, "a number", validate, message);
+        }
+        json::Number num;
+        if (!reader.readNumber(num)) {
+            return false;
+        }
+        if (validate) {
+            message = applyNumberValidation(num.value, field.validation, field.name);
+            if (!message.empty()) {
+                return false;
+            }
+        }
+        F value = static_cast<F>(num.value);
+        if (!field.is_optional) {
+            *reinterpret_cast<F*>(field_ptr) = value;
+        } else if (optional_ok) {
+            *reinterpret_cast<uvapi::optional<F>*>(field_ptr) = value;
+        }
+        return true;
+    }
+    
+    /**
+     * @brief 读取单个字段值并写入实例
+     * @return 失败时返回 false；message 为空表示 JSON 语法错误（由读取器记录）
+     */
+    static bool readField(json::Reader& reader, const FieldDefinition& field, void* instance,
+                          bool validate, std::string& message) {
+        char* field_ptr = static_cast<char*>(instance) + field.offset;
+        char c = reader.peek();
+        
+        switch (field.type) {
+            case FieldType::STRING:
+            case FieldType::DATE:
+            case FieldType::DATETIME:
+            case FieldType::EMAIL:
+            case FieldType::URL:
+            case FieldType::UUID: {
+                if (c != '"') {
+                    return typeMismatch(reader, field, "a string", validate, message);
+                }
+                std::string* target = reinterpret_cast<std::string*>(field_ptr);
+                if (field.is_optional) {
+                    if (field.type != FieldType::STRING) {
+                        return reader.skipValue();  // 仅 STRING 支持 optional 容器
+                    }
+                    uvapi::optional<std::string>& opt = *reinterpret_cast<uvapi::optional<std::string>*>(field_ptr);
+                    opt = std::string();
+                    target = &*opt;
+                }
+                // 字符串直接解码到目标字段，复用其已有容量
+                if (!reader.readString(*target)) {
+                    return false;
+                }
+                if (validate) {
+                    message = applyStringValidation(target->data(), target->size(), field.validation, field.name);
+                    return message.empty();
+                }
+                return true;
+            }
+            case FieldType::INT8:
+                return readIntegerField<int8_t>(reader, field, field_ptr, false, validate, message);
+            case FieldType::INT16:
+                return readIntegerField<int16_t>(reader, field, field_ptr, false, validate, message);
+            case FieldType::INT:
+                return readIntegerField<int>(reader, field, field_ptr, true, validate, message);
+            case FieldType::INT64:
+                return readIntegerField<int64_t>(reader, field, field_ptr, true, validate, message);
+            case FieldType::UINT8:
+                return readIntegerField<uint8_t>(reader, field, field_ptr, false, validate, message);
+            case FieldType::UINT16:
+                return readIntegerField<uint16_t>(reader, field, field_ptr, false, validate, message);
+            case FieldType::UINT32:
+                return readIntegerField<uint32_t>(reader, field, field_ptr, false, validate, message);
+            case FieldType::UINT64:
+                return readIntegerField<uint64_t>(reader, field, field_ptr, false, validate, message);
+            case FieldType::FP32:
+                return readFloatField<float>(reader, field, field_ptr, false, validate, message);
+            case FieldType::FLOAT:
+                return readFloatField<float>(reader, field, field_ptr, true, validate, message);
+            case FieldType::DOUBLE:
+                return readFloatField<double>(reader, field, field_ptr, true, validate, message);
+            case FieldType::BOOL: {
+                if (c != 't' && c != 'f') {
+                    return typeMismatch(reader, field, "a boolean", validate, message);
+                }
+                bool value = false;
+                if (!reader.readBool(value)) {
+                    return false;
+                }
+                if (!field.is_optional) {
+                    *reinterpret_cast<bool*>(field_ptr) = value;
+                } else {
+                    *reinterpret_cast<uvapi::optional<bool>*>(field_ptr) = value;
+                }
+                return true;
+            }
+            case FieldType::OBJECT:
+                if (c != '{') {
+                    return typeMismatch(reader, field, "an object", validate, message);
+                }
+                if (field.nested_schema && !field.is_optional) {
+                    // 嵌套对象在同一次扫描中解析
+                    return field.nested_schema->parseFrom(reader, field_ptr, validate, &message);
+                }
+                return reader.skipValue();
+            case FieldType::ARRAY:
+                if (c != '[') {
+                    return typeMismatch(reader, field, "an array", validate, message);
+                }
+                if (field.typed_array && !field.is_optional) {
+                    switch (field.element_type) {
+                        case FieldType::INT:
+                            return readTypedArray<int>(reader, field, field_ptr, "an integer", validate, message);
+                        case FieldType::INT64:
+                            return readTypedArray<int64_t>(reader, field, field_ptr, "an integer", validate, message);
+                        case FieldType::DOUBLE:
+                            return readTypedArray<double>(reader, field, field_ptr, "a number", validate, message);
+                        case FieldType::BOOL:
+                            return readTypedArray<bool>(reader, field, field_ptr, "a boolean", validate, message);
+                        default:
+                            return readTypedArray<std::string>(reader, field, field_ptr, "a string", validate, message);
+                    }
+                }
+                return reader.skipValue();
+            case FieldType::CUSTOM:
+                return reader.skipValue();
+        }
+        return reader.skipValue();
+    }
+    
     // 设置字段默认值
     static void setDefaultValue(void* instance, size_t offset, FieldType type) {
         if (!instance) return;
@@ -1565,6 +2450,19 @@ private:
             case FieldType::BOOL:
                 reinterpret_cast<uvapi::optional<bool>*>(field_ptr)->reset();
                 break;
+            // 以下类型没有 optional 容器（解析时跳过），字段中不会有值
+            case FieldType::INT8:
+            case FieldType::INT16:
+            case FieldType::UINT8:
+            case FieldType::UINT16:
+            case FieldType::UINT32:
+            case FieldType::UINT64:
+            case FieldType::FP32:
+            case FieldType::DATE:
+            case FieldType::DATETIME:
+            case FieldType::EMAIL:
+            case FieldType::URL:
+            case FieldType::UUID:
             case FieldType::ARRAY:
             case FieldType::OBJECT:
             case FieldType::CUSTOM:
@@ -1591,19 +2489,46 @@ private:
                 return reinterpret_cast<uvapi::optional<double>*>(field_ptr)->has_value();
             case FieldType::BOOL:
                 return reinterpret_cast<uvapi::optional<bool>*>(field_ptr)->has_value();
-            case FieldType::ARRAY:
-            case FieldType::OBJECT:
-            case FieldType::CUSTOM:
-                return false;
-        }
-        
-        return false;
-    }
-    
+            // 以下类型没有 optional 容器（解析时跳过），字段中不会有值
+            case FieldType::INT8:
+            case FieldType::INT16:
+            case FieldType::UINT8:
+            case FieldType::UINT16:
+            case FieldType::UINT32:
+            case FieldType::UINT64:
+            case FieldType::FP32:
+            case FieldType::DATE:
+            case FieldType::DATETIME:
+            case FieldType::EMAIL:
+            case FieldType::URL:
+            case FieldType::UUID:
+            case FieldType::ARRAY:
+            case FieldType::OBJECT:
+            case FieldType::CUSTOM:
+                return false;
+        }
+        
+        return false;
+    }
+    
     // 直接验证对象（性能优化：避免序列化再解析）
     std::string validateObject(void* instance) const override {
         // 1. 字段级校验（直接从对象读取）
-        for (const auto& field : fields()) {
+        for (const auto& field : frozen().fields()) {
+            if (field.typed_array) {
+                // 标量数组：空数组视为未提供
+                const char* field_ptr = static_cast<const char*>(instance) + field.offset;
+                size_t count = typedArraySize(field_ptr, field);
+                if (field.validation.required && count == 0) {
+                    return "Field '" + field.name + "' is required";
+                }
+                std::string error = count > 0 ? field_rules::validateArrayLength(count, field.validation, field.name) : std::string();
+                if (!error.empty()) {
+                    return error;
+                }
+                continue;
+            }
+            
             // 获取字段值（字符串形式）
             std::string field_value = getFieldValueAsString(instance, field.offset, field.type);
             
@@ -1635,11 +2560,29 @@ private:
         
         switch (type) {
             case FieldType::STRING:
+            case FieldType::DATE:
+            case FieldType::DATETIME:
+            case FieldType::EMAIL:
+            case FieldType::URL:
+            case FieldType::UUID:
                 return *reinterpret_cast<std::string*>(field_ptr);
+            case FieldType::INT8:
+                return std::to_string(*reinterpret_cast<int8_t*>(field_ptr));
+            case FieldType::INT16:
+                return std::to_string(*reinterpret_cast<int16_t*>(field_ptr));
             case FieldType::INT:
                 return std::to_string(*reinterpret_cast<int*>(field_ptr));
             case FieldType::INT64:
                 return std::to_string(*reinterpret_cast<int64_t*>(field_ptr));
+            case FieldType::UINT8:
+                return std::to_string(*reinterpret_cast<uint8_t*>(field_ptr));
+            case FieldType::UINT16:
+                return std::to_string(*reinterpret_cast<uint16_t*>(field_ptr));
+            case FieldType::UINT32:
+                return std::to_string(*reinterpret_cast<uint32_t*>(field_ptr));
+            case FieldType::UINT64:
+                return std::to_string(*reinterpret_cast<uint64_t*>(field_ptr));
+            case FieldType::FP32:
             case FieldType::FLOAT:
                 return std::to_string(*reinterpret_cast<float*>(field_ptr));
             case FieldType::DOUBLE:
@@ -1664,12 +2607,12 @@ private:
         
         // 字符串类型验证
         if (type == FieldType::STRING) {
-            if (validation.has_min_length && len < validation.min_length) {
+            if (validation.has_min_length && len < static_cast<size_t>(validation.min_length)) {
                 return "Field '" + field_name + "' must be at least " + 
                        std::to_string(validation.min_length) + " characters";
             }
             
-            if (validation.has_max_length && len > validation.max_length) {
+            if (validation.has_max_length && len > static_cast<size_t>(validation.max_length)) {
                 return "Field '" + field_name + "' must be at most " + 
                        std::to_string(validation.max_length) + " characters";
             }
@@ -1738,41 +2681,57 @@ private:
 
 // Body 反序列化辅助函数（只执行解析，不自动校验）
 template<typename T>
-T parseBody(const std::string& json) {
+T parseBody(const char* data, size_t size) {
     T instance;
-    BodySchemaBase* schema = instance.schema();
-    if (!schema) {
+    if (!SchemaAccess<T>::defined(instance)) {
         std::cerr << "Error: Schema not defined" << std::endl;
         return instance;
     }
     
-    // 验证 JSON 格式
-    cJSON* root = cJSON_Parse(json.c_str());
-    if (!root) {
-        std::cerr << "Error: Invalid JSON format" << std::endl;
+    // 单次扫描：语法检查和字段写入同时完成
+    std::string error;
+    if (!SchemaAccess<T>::parse(data, size, instance, false, &error)) {
+        std::cerr << "Error: Failed to parse body: " << error << std::endl;
         return instance;
     }
-    cJSON_Delete(root);
     
-    // 反序列化
-    if (!schema->fromJson(json, &instance)) {
-        std::cerr << "Error: Failed to parse body" << std::endl;
-        return instance;
+    return instance;
+}
+
+template<typename T>
+T parseBody(const std::string& json) {
+    return parseBody<T>(json.data(), json.size());
+}
+
+// 解析并校验（字段级校验在解析过程中完成，第一个错误即返回）
+template<typename T>
+ValidationResult parseRequest(const char* data, size_t size, T& out) {
+    if (!SchemaAccess<T>::defined(out)) {
+        return "Schema not defined";
     }
     
-    return instance;
+    std::string error;
+    if (!SchemaAccess<T>::parse(data, size, out, true, &error)) {
+        return error;
+    }
+    
+    return true;
+}
+
+template<typename T>
+ValidationResult parseRequest(const std::string& json, T& out) {
+    return parseRequest<T>(json.data(), json.size(), out);
 }
 
 // 显式校验函数（性能优化：直接验证对象）
 template<typename T>
 ValidationResult validateRequest(const T& instance) {
-    BodySchemaBase* schema = instance.schema();
-    if (!schema) {
+    if (!SchemaAccess<T>::defined(instance)) {
         return "Schema not defined";
     }
     
     // 直接验证对象（避免序列化再解析）
-    std::string error = schema->validateObject(const_cast<T*>(&instance));
+    std::string error = SchemaAccess<T>::validate(instance);
     if (!error.empty()) {
         return error;
     }
@@ -1800,17 +2759,29 @@ inline uvhttp_method_t toUvhttpMethod(HttpMethod method) {
 // HTTP 响应
 struct HttpResponse {
     int status_code;
-    std::map<std::string, std::string> headers;
+    ResponseHeaders headers;  // 扁平列表，按插入顺序写出
     std::string body;
     
     HttpResponse(int code = 200) : status_code(code) {}
     
     HttpResponse(int code, const std::string& body_text) : status_code(code), body(body_text) {}
     
+    HttpResponse(int code, std::string&& body_text) : status_code(code), body(std::move(body_text)) {}
+    
     HttpResponse(int code, const char* body_text) : status_code(code), body(body_text ? body_text : "") {}
     
+    // 清空内容供对象池复用（响应体保留不超过 64KB 的容量）
+    void reset() {
+        status_code = 200;
+        headers.clear();
+        body.clear();
+        if (body.capacity() > 64 * 1024) {
+            std::string().swap(body);
+        }
+    }
+    
     HttpResponse& header(const std::string& key, const std::string& value) {
-        headers[key] = value;
+        headers.set(key, value);
         return *this;
     }
     
@@ -1819,24 +2790,58 @@ struct HttpResponse {
         return *this;
     }
     
+    // 移入响应体缓冲区（例如 StringBuilder::release() 的结果），不复制
+    HttpResponse& setBody(std::string&& body_text) {
+        body = std::move(body_text);
+        return *this;
+    }
+    
     HttpResponse& json(const std::string& json_body) {
         body = json_body;
-        headers["Content-Type"] = "application/json";
+        headers.set(header::CONTENT_TYPE, "application/json");
         return *this;
     }
     
-    // 自动序列化
+    HttpResponse& json(std::string&& json_body) {
+        body = std::move(json_body);
+        headers.set(header::CONTENT_TYPE, "application/json");
+        return *this;
+    }
+    
+    // 自动序列化（直接写入 body，复用其已有容量）
     template<typename T>
     HttpResponse& json(const T& instance) {
-        body = uvapi::toJson(instance);
-        headers["Content-Type"] = "application/json";
+        body.clear();
+        uvapi::appendJson(instance, body);
+        headers.set(header::CONTENT_TYPE, "application/json");
         return *this;
     }
 };
 
-// 参数值包装类 - 支持自动类型推导和错误报告
 /**
- * @brief ParamValue - 参数值包装类
+ * @brief 把 HttpResponse 写入 uvhttp 响应（不发送）
+ *
+ * 状态码、头部和响应体一次性交给 uvhttp：头部按扁平列表顺序设置，
+ * 响应体直接引用 body 的缓冲区，uvapi 这一侧不再产生中间副本。
+ * 分发路径和 UvhttpMiddlewareAdapter 共用这一个写出入口。
+ */
+inline void applyResponse(uvhttp_response_t* resp, const HttpResponse& response) {
+    uvhttp_response_set_status(resp, response.status_code);
+    for (ResponseHeaders::const_iterator it = response.headers.begin(); it != response.headers.end(); ++it) {
+        uvhttp_response_set_header(resp, it->first.c_str(), it->second.c_str());
+    }
+    if (!response.body.empty()) {
+        uvhttp_response_set_body(resp, response.body.data(), response.body.size());
+    }
+}
+
+// 参数值视图 - 支持自动类型推导和错误报告
+/**
+ * @brief ParamValue - 参数值视图
+ * 
+ * 只引用参数表中的字符串，不复制；转换直接在切片上进行，成功时不分配内存，
+ * 错误消息在调用 errorMessage() 时才生成。被引用的字符串（通常是请求的参数表）
+ * 必须比 ParamValue 活得久，不要在请求结束后保留。
  * 
  * 线程安全说明：
  * - ParamValue 不是线程安全的
@@ -1844,357 +2849,237 @@ struct HttpResponse {
  * - 多个线程应该创建各自的 ParamValue 实例
  */
 class ParamValue {
-private:
-    std::string value_;
-    bool has_value_;
-    mutable bool conversion_error_;  // mutable 因为需要在 const 方法中设置
-    mutable std::string error_message_;  // mutable 因为需要在 const 方法中设置
-    
-    // 类型转换辅助函数 - 特化版本
-    static void parseValueBool(const std::string& value, bool& result, bool& error, std::string& error_msg);
-    static void parseValueString(const std::string& value, std::string& result, bool& error, std::string& error_msg);
-    static void parseValueInt(const std::string& value, long long& result, bool& error, std::string& error_msg);
-    static void parseValueDouble(const std::string& value, double& result, bool& error, std::string& error_msg);
-    
-    // 模板特化版本
-    template<typename T>
-    typename std::enable_if<std::is_same<T, bool>::value, optional<T>>::type
-    as_impl() const {
-        if (!has_value_ || conversion_error_) {
-            return optional<T>();
-        }
-        
-        T result;
-        bool error = false;
-        std::string error_msg;
-        parseValueBool(value_, result, error, error_msg);
-        
-        if (error) {
-            conversion_error_ = true;
-            error_message_ = error_msg;
-            return optional<T>();
-        }
-        
-        return optional<T>(result);
-    }
-    
-    template<typename T>
-    typename std::enable_if<std::is_same<T, std::string>::value, optional<T>>::type
-    as_impl() const {
-        if (!has_value_ || conversion_error_) {
-            return optional<T>();
-        }
-        
-        T result;
-        bool error = false;
-        std::string error_msg;
-        parseValueString(value_, result, error, error_msg);
-        
-        if (error) {
-            conversion_error_ = true;
-            error_message_ = error_msg;
-            return optional<T>();
-        }
-        
-        return optional<T>(result);
-    }
+public:
+    enum class Error {
+        NONE,
+        EMPTY_INTEGER,
+        EMPTY_FLOAT,
+        INVALID_BOOL,
+        INVALID_INTEGER,
+        INVALID_FLOAT,
+        INTEGER_OVERFLOW,
+        FLOAT_OVERFLOW,
+        OUT_OF_RANGE
+    };
     
-    template<typename T>
-    typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value, optional<T>>::type
-    as_impl() const {
-        if (!has_value_ || conversion_error_) {
-            return optional<T>();
-        }
-        
-        long long temp_result;
-        bool error = false;
-        std::string error_msg;
-        parseValueInt(value_, temp_result, error, error_msg);
-        
-        if (!error) {
-            // 检查是否超出目标类型的范围
-            if (temp_result < static_cast<long long>(std::numeric_limits<T>::min()) ||
-                temp_result > static_cast<long long>(std::numeric_limits<T>::max())) {
-                error = true;
-                error_msg = "Value out of range for target type: '" + value_ + "'";
-            }
-        }
-        
-        if (error) {
-            conversion_error_ = true;
-            error_message_ = error_msg;
-            return optional<T>();
-        }
-        
-        return optional<T>(static_cast<T>(temp_result));
-    }
+    // 切片解析（不分配内存），与 strtoll / strtod 接受的格式一致
+    static Error parseBool(StringSlice value, bool& result);
+    static Error parseInt(StringSlice value, long long& result);
+    static Error parseDouble(StringSlice value, double& result);
     
-    template<typename T>
-    typename std::enable_if<std::is_floating_point<T>::value, optional<T>>::type
-    as_impl() const {
-        if (!has_value_ || conversion_error_) {
-            return optional<T>();
-        }
-        
-        double temp_result;
-        bool error = false;
-        std::string error_msg;
-        parseValueDouble(value_, temp_result, error, error_msg);
-        
-        if (!error) {
-            // 对于浮点数，使用 -max 作为最小值，因为 min() 返回的是最小正数
-            double type_min = -static_cast<double>(std::numeric_limits<T>::max());
-            double type_max = static_cast<double>(std::numeric_limits<T>::max());
-            
-            // 检查是否超出目标类型的范围
-            if (temp_result < type_min || temp_result > type_max) {
-                error = true;
-                error_msg = "Value out of range for target type: '" + value_ + "'";
-            }
-        }
-        
-        if (error) {
-            conversion_error_ = true;
-            error_message_ = error_msg;
-            return optional<T>();
-        }
-        
-        return optional<T>(static_cast<T>(temp_result));
-    }
+private:
+    StringSlice value_;
+    mutable Error error_;  // mutable 因为需要在 const 方法中设置
     
-    // operator T() 的模板特化版本
-    template<typename T>
-    typename std::enable_if<std::is_same<T, bool>::value, T>::type
-    op_impl() const {
-        if (!has_value_) {
-            return T();
-        }
-        
-        T result;
-        bool error = false;
-        std::string error_msg;
-        parseValueBool(value_, result, error, error_msg);
-        
-        if (error) {
-            conversion_error_ = true;
-            error_message_ = error_msg;
-            return T();
-        }
-        
-        return result;
+    // 转换到目标类型（含目标类型的范围检查）
+    Error convert(bool& out) const { return parseBool(value_, out); }
+    Error convert(std::string& out) const {
+        out = value_.toString();
+        return Error::NONE;
     }
-    
-    template<typename T>
-    typename std::enable_if<std::is_same<T, std::string>::value, T>::type
-    op_impl() const {
-        if (!has_value_) {
-            return T();
-        }
-        
-        T result;
-        bool error = false;
-        std::string error_msg;
-        parseValueString(value_, result, error, error_msg);
-        
-        if (error) {
-            conversion_error_ = true;
-            error_message_ = error_msg;
-            return T();
-        }
-        
-        return result;
+    Error convert(StringSlice& out) const {
+        out = value_;
+        return Error::NONE;
     }
     
     template<typename T>
-    typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value, T>::type
-    op_impl() const {
-        if (!has_value_) {
-            return T();
+    typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value, Error>::type
+    convert(T& out) const {
+        long long temp_result = 0;
+        Error error = parseInt(value_, temp_result);
+        if (error != Error::NONE) {
+            return error;
         }
-        
-        long long temp_result;
-        bool error = false;
-        std::string error_msg;
-        parseValueInt(value_, temp_result, error, error_msg);
-        
-        if (!error) {
-            // 检查是否超出目标类型的范围
-            if (temp_result < static_cast<long long>(std::numeric_limits<T>::min()) ||
-                temp_result > static_cast<long long>(std::numeric_limits<T>::max())) {
-                error = true;
-                error_msg = "Value out of range for target type: '" + value_ + "'";
-            }
-        }
-        
-        if (error) {
-            conversion_error_ = true;
-            error_message_ = error_msg;
-            return T();
+        // 检查是否超出目标类型的范围
+        if (std::is_signed<T>::value
+                ? (temp_result < static_cast<long long>(std::numeric_limits<T>::min()) ||
+                   temp_result > static_cast<long long>(std::numeric_limits<T>::max()))
+                : (temp_result < 0 ||
+                   static_cast<unsigned long long>(temp_result) >
+                       static_cast<unsigned long long>(std::numeric_limits<T>::max()))) {
+            return Error::OUT_OF_RANGE;
         }
-        
-        return static_cast<T>(temp_result);
+        out = static_cast<T>(temp_result);
+        return Error::NONE;
     }
     
     template<typename T>
-    typename std::enable_if<std::is_floating_point<T>::value, T>::type
-    op_impl() const {
-        if (!has_value_) {
-            return T();
-        }
-        
-        double temp_result;
-        bool error = false;
-        std::string error_msg;
-        parseValueDouble(value_, temp_result, error, error_msg);
-        
-        if (!error) {
-            // 对于浮点数，使用 -max 作为最小值，因为 min() 返回的是最小正数
-            double type_min = -static_cast<double>(std::numeric_limits<T>::max());
-            double type_max = static_cast<double>(std::numeric_limits<T>::max());
-            
-            // 检查是否超出目标类型的范围
-            if (temp_result < type_min || temp_result > type_max) {
-                error = true;
-                error_msg = "Value out of range for target type: '" + value_ + "'";
-            }
+    typename std::enable_if<std::is_floating_point<T>::value, Error>::type
+    convert(T& out) const {
+        double temp_result = 0.0;
+        Error error = parseDouble(value_, temp_result);
+        if (error != Error::NONE) {
+            return error;
         }
-        
-        if (error) {
-            conversion_error_ = true;
-            error_message_ = error_msg;
-            return T();
+        // 对于浮点数，使用 -max 作为最小值，因为 min() 返回的是最小正数
+        double type_min = -static_cast<double>(std::numeric_limits<T>::max());
+        double type_max = static_cast<double>(std::numeric_limits<T>::max());
+        if (temp_result < type_min || temp_result > type_max) {
+            return Error::OUT_OF_RANGE;
         }
-        
-        return static_cast<T>(temp_result);
+        out = static_cast<T>(temp_result);
+        return Error::NONE;
     }
     
 public:
-    ParamValue() : value_(""), has_value_(false), conversion_error_(false), error_message_("") {}
-    explicit ParamValue(const std::string& value) : value_(value), has_value_(true), conversion_error_(false), error_message_("") {}
+    ParamValue() : error_(Error::NONE) {}
+    explicit ParamValue(const char* value) : value_(value), error_(Error::NONE) {}
+    explicit ParamValue(const std::string& value) : value_(value), error_(Error::NONE) {}
+    explicit ParamValue(StringSlice value) : value_(value), error_(Error::NONE) {}
+    ParamValue(std::string&&) = delete;  // 视图不能指向临时字符串
     
     // 检查是否有值
-    bool hasValue() const { return has_value_; }
+    bool hasValue() const { return value_.valid(); }
     
     // 检查是否为空
     bool empty() const { return value_.empty(); }
     
     // 检查是否有转换错误
-    bool hasError() const { return conversion_error_; }
+    bool hasError() const { return error_ != Error::NONE; }
+    Error error() const { return error_; }
     
-    // 获取错误消息
-    const std::string& errorMessage() const { return error_message_; }
+    // 获取错误消息（按需生成）
+    std::string errorMessage() const;
     
-    // 获取原始字符串值
-    const std::string& value() const { return value_; }
+    // 获取原始字符串值（复制）；只读访问用 slice()
+    std::string value() const { return value_.toString(); }
+    StringSlice slice() const { return value_; }
     
     // 显式类型转换 - 带错误检查，返回 optional
     template<typename T>
     optional<T> as() const {
-        return as_impl<T>();
+        if (!hasValue() || hasError()) {
+            return optional<T>();
+        }
+        T result;
+        Error error = convert(result);
+        if (error != Error::NONE) {
+            error_ = error;
+            return optional<T>();
+        }
+        return optional<T>(result);
     }
     
     // 隐式类型转换运算符 - 支持自动类型推导（简化版，不报告错误）
     template<typename T>
     operator T() const {
-        return op_impl<T>();
+        if (!hasValue()) {
+            return T();
+        }
+        T result;
+        Error error = convert(result);
+        if (error != Error::NONE) {
+            error_ = error;
+            return T();
+        }
+        return result;
     }
 };
 
-// 布尔类型转换
-inline void ParamValue::parseValueBool(const std::string& value, bool& result, bool& error, std::string& error_msg) {
-    error = false;
-    error_msg = "";
-    
-    std::string lower = value;
-    std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
-    
-    // 只接受 "true" 和 "false"
-    if (lower == "true") {
+// 布尔类型转换：只接受 "true" 和 "false"（大小写不敏感）
+inline ParamValue::Error ParamValue::parseBool(StringSlice value, bool& result) {
+    result = false;
+    if (value.equalsIgnoreCase("true", 4)) {
         result = true;
-    } else if (lower == "false") {
-        result = false;
-    } else {
-        error = true;
-        error_msg = "Invalid boolean value: '" + value + "'. Expected 'true' or 'false'";
-        result = false;
+        return Error::NONE;
     }
+    return value.equalsIgnoreCase("false", 5) ? Error::NONE : Error::INVALID_BOOL;
 }
 
-// 字符串类型转换
-inline void ParamValue::parseValueString(const std::string& value, std::string& result, bool& error, std::string& error_msg) {
-    error = false;
-    error_msg = "";
-    result = value;
-}
-
-// 整数类型转换
-inline void ParamValue::parseValueInt(const std::string& value, long long& result, bool& error, std::string& error_msg) {
-    error = false;
-    error_msg = "";
-    result = 0;  // 初始化为 0
-    
+// 整数类型转换：允许前导空白和正负号，其余字符必须都是数字
+inline ParamValue::Error ParamValue::parseInt(StringSlice value, long long& result) {
+    result = 0;
     if (value.empty()) {
-        error = true;
-        error_msg = "Empty string cannot be converted to integer";
-        return;
+        return Error::EMPTY_INTEGER;
+    }
+    
+    size_t i = 0;
+    while (i < value.size && std::isspace(static_cast<unsigned char>(value.data[i]))) {
+        i++;
+    }
+    bool negative = false;
+    if (i < value.size && (value.data[i] == '-' || value.data[i] == '+')) {
+        negative = value.data[i] == '-';
+        i++;
+    }
+    const unsigned long long limit = negative
+        ? static_cast<unsigned long long>(LLONG_MAX) + 1ULL
+        : static_cast<unsigned long long>(LLONG_MAX);
+    unsigned long long magnitude = 0;
+    size_t digits = 0;
+    bool overflow = false;
+    for (; i < value.size; i++, digits++) {
+        char c = value.data[i];
+        if (c < '0' || c > '9') {
+            return Error::INVALID_INTEGER;
+        }
+        unsigned long long digit = static_cast<unsigned long long>(c - '0');
+        if (overflow || magnitude > (limit - digit) / 10ULL) {
+            overflow = true;
+            continue;
+        }
+        magnitude = magnitude * 10ULL + digit;
     }
-    
-    errno = 0;
-    char* endptr = nullptr;
-    long long temp_result = strtoll(value.c_str(), &endptr, 10);
-    
-    // 检查转换是否失败
-    if (endptr == value.c_str() || *endptr != '\0') {
-        error = true;
-        error_msg = "Invalid integer format: '" + value + "'";
-        result = 0;
-        return;
+    if (digits == 0) {
+        return Error::INVALID_INTEGER;
     }
-    
-    // 检查是否溢出
-    if (errno == ERANGE) {
-        error = true;
-        error_msg = "Integer overflow: '" + value + "'";
-        result = 0;
-        return;
+    if (overflow) {
+        return Error::INTEGER_OVERFLOW;
     }
-    
-    result = temp_result;
+    result = negative ? static_cast<long long>(0ULL - magnitude) : static_cast<long long>(magnitude);
+    return Error::NONE;
 }
 
-// 浮点数类型转换
-inline void ParamValue::parseValueDouble(const std::string& value, double& result, bool& error, std::string& error_msg) {
-    error = false;
-    error_msg = "";
-    result = 0.0;  // 初始化为 0.0
-    
+// 浮点数类型转换：常见长度在栈上补 '\0' 后交给 strtod
+inline ParamValue::Error ParamValue::parseDouble(StringSlice value, double& result) {
+    result = 0.0;
     if (value.empty()) {
-        error = true;
-        error_msg = "Empty string cannot be converted to floating point";
-        return;
+        return Error::EMPTY_FLOAT;
+    }
+    
+    char stack_buffer[64];
+    std::string heap_buffer;
+    const char* text = stack_buffer;
+    if (value.size < sizeof(stack_buffer)) {
+        std::memcpy(stack_buffer, value.data, value.size);
+        stack_buffer[value.size] = '\0';
+    } else {
+        heap_buffer.assign(value.data, value.size);
+        text = heap_buffer.c_str();
     }
     
     errno = 0;
     char* endptr = nullptr;
-    double temp_result = strtod(value.c_str(), &endptr);
+    double temp_result = strtod(text, &endptr);
     
     // 检查转换是否失败
-    if (endptr == value.c_str() || *endptr != '\0') {
-        error = true;
-        error_msg = "Invalid floating point format: '" + value + "'";
-        result = 0.0;
-        return;
+    if (endptr == text || *endptr != '\0') {
+        return Error::INVALID_FLOAT;
     }
     
     // 检查是否溢出
     if (errno == ERANGE) {
-        error = true;
-        error_msg = "Floating point overflow: '" + value + "'";
-        result = 0.0;
-        return;
+        return Error::FLOAT_OVERFLOW;
     }
     
     result = temp_result;
+    return Error::NONE;
+}
+
+inline std::string ParamValue::errorMessage() const {
+    std::string quoted = "'" + value_.toString() + "'";
+    switch (error_) {
+        case Error::NONE: return std::string();
+        case Error::EMPTY_INTEGER: return "Empty string cannot be converted to integer";
+        case Error::EMPTY_FLOAT: return "Empty string cannot be converted to floating point";
+        case Error::INVALID_BOOL: return "Invalid boolean value: " + quoted + ". Expected 'true' or 'false'";
+        case Error::INVALID_INTEGER: return "Invalid integer format: " + quoted;
+        case Error::INVALID_FLOAT: return "Invalid floating point format: " + quoted;
+        case Error::INTEGER_OVERFLOW: return "Integer overflow: " + quoted;
+        case Error::FLOAT_OVERFLOW: return "Floating point overflow: " + quoted;
+        case Error::OUT_OF_RANGE: return "Value out of range for target type: " + quoted;
+    }
+    return std::string();
 }
 
 // 参数访问器
@@ -2206,7 +3091,7 @@ public:
     explicit ParamAccessor(const std::map<std::string, std::string>& params)
         : params_(params) {}
     
-    // operator[] - 返回 ParamValue，支持自动类型推导
+    // operator[] - 返回指向参数表的 ParamValue，支持自动类型推导
     ParamValue operator[](const std::string& key) const {
         auto it = params_.find(key);
         if (it != params_.end()) {
@@ -2221,12 +3106,118 @@ public:
     }
 };
 
+// ========== 类型化参数绑定 ==========
+
+/**
+ * @brief 路由声明的类型化参数（RouteBuilder::query<T>() / param<T>()）在验证时的解析结果
+ *
+ * 验证器把每个绑定参数解析一次写入固定槽位，处理器按名称直接读取，
+ * 不再经过 ParamValue 重新解析；字符串以切片形式引用请求的参数表或路由的默认值。
+ * 对象位于验证包装的栈上，只在处理器调用期间有效。
+ *
+ * @code
+ * api.get("/users/:id")
+ *    .param<int64_t>("id")
+ *    .query<int>("page", [](ParamBuilder& p) { p.range(1, 1000).defaultValue(1); })
+ *    .handler([](const HttpRequest& req, const BoundParams& params) {
+ *        int64_t id = params.get<int64_t>("id");
+ *        int page = params.get<int>("page");
+ *        ...
+ *    })
+ *    .register_();
+ * @endcode
+ */
+class BoundParams {
+public:
+    static const size_t kMaxSlots = 16;
+    
+    struct Slot {
+        const std::string* name;  // 指向路由验证程序中的名称，未写入时为空
+        StringSlice text;
+        long long int_value;
+        double double_value;
+        bool bool_value;
+        
+        Slot() : name(nullptr), int_value(0), double_value(0.0), bool_value(false) {}
+    };
+    
+    BoundParams() : size_(0) {}
+    
+    BoundParams(const BoundParams&) = delete;
+    BoundParams& operator=(const BoundParams&) = delete;
+    
+    // 参数是否出现在请求中（或使用了默认值）
+    bool has(const std::string& name) const { return find(name) != nullptr; }
+    
+    // 读取绑定值；参数缺失时返回 fallback
+    template<typename T>
+    T get(const std::string& name, T fallback = T()) const {
+        const Slot* slot = find(name);
+        return slot ? extract(*slot, static_cast<T*>(nullptr)) : fallback;
+    }
+    
+    // 原始文本（不复制）
+    StringSlice text(const std::string& name) const {
+        const Slot* slot = find(name);
+        return slot ? slot->text : StringSlice();
+    }
+    
+    // 验证器写入：index 为编译时分配的槽位
+    Slot* slot(size_t index, const std::string* name) {
+        if (index >= kMaxSlots) {
+            return nullptr;
+        }
+        if (index >= size_) {
+            size_ = index + 1;
+        }
+        slots_[index].name = name;
+        return &slots_[index];
+    }
+    
+private:
+    Slot slots_[kMaxSlots];
+    size_t size_;
+    
+    const Slot* find(const std::string& name) const {
+        for (size_t i = 0; i < size_; i++) {
+            if (slots_[i].name && *slots_[i].name == name) {
+                return &slots_[i];
+            }
+        }
+        return nullptr;
+    }
+    
+    template<typename T>
+    static typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value, T>::type
+    extract(const Slot& slot, T*) { return static_cast<T>(slot.int_value); }
+    
+    template<typename T>
+    static typename std::enable_if<std::is_floating_point<T>::value, T>::type
+    extract(const Slot& slot, T*) { return static_cast<T>(slot.double_value); }
+    
+    static bool extract(const Slot& slot, bool*) { return slot.bool_value; }
+    static std::string extract(const Slot& slot, std::string*) { return slot.text.toString(); }
+    static StringSlice extract(const Slot& slot, StringSlice*) { return slot.text; }
+};
+
+// 绑定类型到 ParamDefinition::data_type 的映射（0=string, 1=int, 2=int64, 3=double, 4=float, 5=bool）
+template<typename T> struct ParamBinding;
+template<> struct ParamBinding<std::string> { static const int data_type = 0; };
+template<> struct ParamBinding<StringSlice> { static const int data_type = 0; };
+template<> struct ParamBinding<int> { static const int data_type = 1; };
+template<> struct ParamBinding<long> { static const int data_type = 2; };
+template<> struct ParamBinding<long long> { static const int data_type = 2; };
+template<> struct ParamBinding<double> { static const int data_type = 3; };
+template<> struct ParamBinding<float> { static const int data_type = 4; };
+template<> struct ParamBinding<bool> { static const int data_type = 5; };
+
 // HTTP 请求
 struct HttpRequest {
     HttpMethod method;
     std::string url_path;
-    std::map<std::string, std::string> headers;
-    std::map<std::string, std::string> query_params;
+    RequestHeaders headers;                            // 名称大小写不敏感
+    std::map<std::string, std::string> query_params;  // 已解码；重复的键保留第一个值
+    std::map<std::string, std::vector<std::string> > query_multi;  // 仅重复出现的键：按顺序的全部值
     std::map<std::string, std::string> path_params;
     std::string body;
     int64_t user_id;
@@ -2235,6 +3226,54 @@ struct HttpRequest {
     ParamAccessor pathParam{path_params};
     ParamAccessor queryParam{query_params};
     
+    HttpRequest() : method(HttpMethod::ANY), user_id(0) {}
+    
+    // 清空内容供对象池复用（路径和请求体保留已有容量，请求体超过 64KB 时释放）
+    void reset() {
+        method = HttpMethod::ANY;
+        url_path.clear();
+        headers.clear();
+        query_params.clear();
+        query_multi.clear();
+        path_params.clear();
+        body.clear();
+        if (body.capacity() > 64 * 1024) {
+            std::string().swap(body);
+        }
+        user_id = 0;
+    }
+    
+    // 拷贝时访问器必须绑定到副本自身的参数表，而不是源对象
+    HttpRequest(const HttpRequest& other)
+        : method(other.method), url_path(other.url_path), headers(other.headers),
+          query_params(other.query_params), query_multi(other.query_multi), path_params(other.path_params),
+          body(other.body), user_id(other.user_id),
+          pathParam(path_params), queryParam(query_params) {}
+    
+    // 追加一个查询参数：第一次出现写入 query_params，再次出现时全部值进入 query_multi
+    void addQueryParam(std::string key, std::string value) {
+        std::map<std::string, std::string>::iterator it = query_params.find(key);
+        if (it == query_params.end()) {
+            query_params.insert(std::make_pair(std::move(key), std::move(value)));
+            return;
+        }
+        std::vector<std::string>& values = query_multi[it->first];
+        if (values.empty()) {
+            values.push_back(it->second);
+        }
+        values.push_back(std::move(value));
+    }
+    
+    // 查询参数的全部值（按出现顺序），不存在时为空
+    std::vector<std::string> queryValues(const std::string& key) const {
+        std::map<std::string, std::vector<std::string> >::const_iterator multi = query_multi.find(key);
+        if (multi != query_multi.end()) {
+            return multi->second;
+        }
+        std::map<std::string, std::string>::const_iterator it = query_params.find(key);
+        return it == query_params.end() ? std::vector<std::string>() : std::vector<std::string>(1, it->second);
+    }
+    
     // Request Body - 返回 optional<T>
     // 框架会根据 Schema 验证并解析 Body
     template<typename T>
@@ -2247,16 +3286,378 @@ struct HttpRequest {
     }
 
 private:
-    // Body 反序列化
-    template<typename T>
-    T parseBody() const {
-        return uvapi::parseBody<T>(body);
-    }
-    
-    std::string getHeader(const std::string& key) const;
-    bool isAuthenticated() const;
+    // Body 反序列化
+    template<typename T>
+    T parseBody() const {
+        return uvapi::parseBody<T>(body);
+    }
+    
+    std::string getHeader(const std::string& key) const;
+    bool isAuthenticated() const;
+};
+
+// ========== 请求 / 响应对象池 ==========
+
+template<>
+struct PoolReset<HttpRequest> {
+    void operator()(HttpRequest& request) const { request.reset(); }
+};
+
+template<>
+struct PoolReset<HttpResponse> {
+    void operator()(HttpResponse& response) const { response.reset(); }
+};
+
+// 分发路径共用的对象池：取放只访问线程缓存，跨线程复用经无锁仓库
+inline ObjectPool<HttpRequest>& requestPool() {
+    static ObjectPool<HttpRequest> pool(64);
+    return pool;
+}
+
+inline ObjectPool<HttpResponse>& responsePool() {
+    static ObjectPool<HttpResponse> pool(64);
+    return pool;
+}
+
+/**
+ * @brief 零拷贝 HTTP 请求视图
+ *
+ * 所有字段都是指向 uvhttp 解析缓冲区的切片，头部和参数使用内联小向量存储，
+ * 典型 GET 请求构造视图不产生堆分配。视图只在处理器调用期间有效，
+ * 需要保留的数据请用 toString() 或 toRequest() 复制出来。
+ *
+ * 默认值等修改通过 overlay 完成：overlayOf() 生成共享底层切片的新视图，
+ * 写入只进入新视图的 overlay，不复制原请求。
+ */
+struct HttpRequestView {
+    HttpMethod method;
+    StringSlice url_path;
+    StringSlice body;
+    SliceMap headers;       // 查找时名称大小写不敏感，见 header()；常见名称指向驻留常量
+    SliceMap query_params;  // 已解码；重复的键按顺序保留全部值，见 queryValues()
+    SliceMap path_params;
+    int64_t user_id;
+    std::vector<char> query_buffer;  // 不在请求 arena 内时存放解码后的查询参数
+    
+    HttpRequestView() : method(HttpMethod::ANY), user_id(0) {}
+    
+    // 创建叠加视图：读取回落到 base，写入只影响新视图
+    static HttpRequestView overlayOf(const HttpRequestView& base) {
+        HttpRequestView view(&base);
+        view.method = base.method;
+        view.url_path = base.url_path;
+        view.body = base.body;
+        view.user_id = base.user_id;
+        return view;
+    }
+    
+    StringSlice header(const StringSlice& name) const { return headers.getIgnoreCase(name); }
+    StringSlice header(const HeaderName& name) const { return headers.getIgnoreCase(StringSlice(name.data, name.size)); }
+    StringSlice query(const StringSlice& name) const { return query_params.get(name); }
+    
+    // fn(const StringSlice& value) 按出现顺序对同名查询参数的每个值调用
+    template<typename Fn>
+    void queryValues(const StringSlice& name, Fn fn) const { query_params.forEachValue(name, fn); }
+    StringSlice param(const StringSlice& name) const { return path_params.get(name); }
+    
+    // 物化为拥有数据的 HttpRequest（兼容旧处理器）
+    HttpRequest toRequest() const {
+        HttpRequest req;
+        req.method = method;
+        req.url_path = url_path.toString();
+        req.body = body.toString();
+        req.user_id = user_id;
+        headers.forEach([&req](const StringSlice& k, const StringSlice& v) {
+            req.headers[k.toString()] = v.toString();
+        });
+        query_params.forEach([&req](const StringSlice& k, const StringSlice& v) {
+            req.addQueryParam(k.toString(), v.toString());
+        });
+        path_params.forEach([&req](const StringSlice& k, const StringSlice& v) {
+            req.path_params[k.toString()] = v.toString();
+        });
+        return req;
+    }
+    
+    template<typename T>
+    optional<T> parseBody() const {
+        if (body.empty()) {
+            return optional<T>();
+        }
+        return optional<T>(uvapi::parseBody<T>(body.data, body.size));
+    }
+
+private:
+    explicit HttpRequestView(const HttpRequestView* base)
+        : method(HttpMethod::ANY), headers(&base->headers), query_params(&base->query_params),
+          path_params(&base->path_params), user_id(0) {}
+};
+
+// 视图处理器：按需选择零拷贝请求
+typedef std::function<HttpResponse(const HttpRequestView&)> RequestViewHandler;
+
+// ========== 中间件流水线 ==========
+
+// 运行期流水线：中间件签名为 HttpResponse(const HttpRequest&, const MiddlewareNext&)
+typedef BasicMiddlewarePipeline<HttpRequest, HttpResponse> MiddlewarePipeline;
+typedef MiddlewarePipeline::Next MiddlewareNext;
+typedef MiddlewarePipeline::Stage MiddlewareStage;
+
+// 编译期流水线：Pipeline<Cors, Auth, RateLimit, Handler>，可直接作为路由处理器注册
+template<typename... Stages>
+using Pipeline = StaticPipeline<HttpRequest, HttpResponse, Stages...>;
+
+// ========== 异步处理器 ==========
+
+/**
+ * @brief 流式响应：状态行和头部先写出，响应体按块写出，不需要先在内存中拼出完整响应
+ *
+ * - 由 Responder::stream() 开始；头部带 Content-Length 时按原样写出，否则使用 chunked 编码
+ * - write() / end() 可在任意线程调用；数据经事件循环线程直接写入连接
+ * - 背压：已写入但尚未发送完的字节超过高水位时 writable() 为 false，生产方应停止写入，
+ *   等待 onDrain 回调（回落到低水位以下时在事件循环线程调用一次）
+ * - 流式响应不受路由超时约束，也不压缩；结束后关闭连接（Connection: close）
+ * - 客户端断开后 write() 返回 false，Responder 的 onCancel 回调在事件循环线程执行
+ *
+ * @code
+ * // 在事件循环线程按需生产：写到高水位就等 onDrain
+ * struct Exporter : std::enable_shared_from_this<Exporter> {
+ *     uvapi::JsonArrayStream array;
+ *     Cursor cursor;
+ *     Exporter(uvapi::ResponseStream out, Cursor c) : array(out), cursor(c) {}
+ *     void pump() {
+ *         while (array.stream().writable() && cursor.next()) {
+ *             array.write(cursor.row());
+ *         }
+ *         if (cursor.done()) {
+ *             array.end();
+ *             return;
+ *         }
+ *         std::shared_ptr<Exporter> self = shared_from_this();
+ *         array.stream().onDrain([self]() { self->pump(); });
+ *     }
+ * };
+ * api.get("/export")
+ *    .handlerAsync([&store](const HttpRequest&, uvapi::Responder r) {
+ *        uvapi::ResponseStream out = r.stream(uvapi::HttpResponse(200)
+ *            .header("Content-Type", "application/json"));
+ *        std::make_shared<Exporter>(out, store.scan())->pump();
+ *    })
+ *    .register_();
+ *
+ * // 在其他线程生产：waitWritable() 阻塞到可写或流关闭
+ * std::thread([out, rows]() {
+ *     for (size_t i = 0; i < rows.size() && out.waitWritable(); i++) {
+ *         out.write(rows[i]);
+ *     }
+ *     out.end();
+ * }).detach();
+ * @endcode
+ */
+class ResponseStream {
+public:
+    struct State;
+
+    ResponseStream() {}
+    explicit ResponseStream(const std::shared_ptr<State>& state) : state_(state) {}
+
+    // 写入一块（取得 data 的所有权，不再复制）；流已结束、连接已断开或数据为空时返回 false
+    bool write(std::string data) const;
+    bool write(const char* data, size_t size) const { return data && write(std::string(data, size)); }
+
+    // 结束响应（chunked 编码时写出结束块）；重复调用无效果
+    bool end() const;
+
+    // 已写入但尚未发送完的字节数
+    size_t buffered() const;
+
+    // 未超过高水位且流仍可写
+    bool writable() const;
+
+    // 阻塞当前线程直到可写，流关闭时返回 false；在事件循环线程调用时不等待，直接返回 writable()
+    bool waitWritable() const;
+
+    // 回落到低水位以下时调用一次（立即可写时在当前线程直接调用）；重复设置覆盖之前的回调
+    void onDrain(std::function<void()> callback) const;
+
+    // 默认低水位 256KB、高水位 1MB
+    void setWatermarks(size_t low, size_t high) const;
+
+    // 已结束或已断开
+    bool closed() const;
+
+    bool valid() const { return state_ != nullptr; }
+
+private:
+    std::shared_ptr<State> state_;
+};
+
+/**
+ * @brief 把流式响应写成 JSON 数组：逐个序列化元素，攒够一批再写出，内存占用与元素总数无关
+ *
+ * 元素可以是 Schema 对象或已编码的 JSON 字符串（与 appendJson 相同）。
+ */
+class JsonArrayStream {
+public:
+    explicit JsonArrayStream(ResponseStream stream, size_t batch_bytes = 16 * 1024)
+        : stream_(stream), batch_bytes_(batch_bytes), count_(0), ended_(false) {
+        buffer_.reserve(batch_bytes + 256);
+        buffer_.push_back('[');
+    }
+
+    template<typename T>
+    bool write(const T& item) {
+        if (ended_) {
+            return false;
+        }
+        if (count_++ > 0) {
+            buffer_.push_back(',');
+        }
+        appendJson(item, buffer_);
+        return buffer_.size() < batch_bytes_ || flush();
+    }
+
+    // 写出已攒的元素
+    bool flush() {
+        if (buffer_.empty()) {
+            return !stream_.closed();
+        }
+        bool ok = stream_.write(std::move(buffer_));
+        buffer_ = std::string();
+        buffer_.reserve(batch_bytes_ + 256);
+        return ok;
+    }
+
+    // 写出 ']' 并结束响应
+    bool end() {
+        if (ended_) {
+            return false;
+        }
+        ended_ = true;
+        buffer_.push_back(']');
+        bool ok = flush();
+        return stream_.end() && ok;
+    }
+
+    size_t count() const { return count_; }
+    const ResponseStream& stream() const { return stream_; }
+
+private:
+    ResponseStream stream_;
+    std::string buffer_;
+    size_t batch_bytes_;
+    size_t count_;
+    bool ended_;
+};
+
+/**
+ * @brief 异步响应句柄：处理器返回后，可以在之后任意时刻、任意线程完成响应
+ *
+ * - send() 只有第一次生效，与超时、客户端断开竞争，返回值表示是否由本次调用完成
+ * - 在事件循环线程调用时立即写出；在其他线程调用时经 uv_async_t 交回事件循环写出
+ * - 超时返回 504；客户端断开或服务器停止时不再写出，onCancel 回调在事件循环线程执行
+ * - 句柄可复制，所有副本指向同一个请求；处理器收到的 HttpRequest 在响应完成前一直有效
+ *
+ * @code
+ * api.get("/users/:id")
+ *    .timeout(std::chrono::seconds(2))
+ *    .handlerAsync([&db](const HttpRequest& req, uvapi::Responder r) {
+ *        db.query(req.path_params.at("id"), [r](const std::string& row) {
+ *            r.send(uvapi::HttpResponse(200).json(row));
+ *        });
+ *    })
+ *    .register_();
+ * @endcode
+ */
+class Responder {
+public:
+    struct State;
+
+    Responder() {}
+    explicit Responder(const std::shared_ptr<State>& state) : state_(state) {}
+
+    bool send(HttpResponse response) const;
+
+    /**
+     * @brief 改为流式响应：写出 head 的状态行和头部（忽略 head.body），之后经返回的流写出响应体
+     *
+     * 与 send() 一样只有第一次生效；已响应或已取消时返回无效的流（valid() 为 false）。
+     * 流直接写套接字，TLS 连接上同样返回无效的流，此时仍可调用 send()。
+     */
+    ResponseStream stream(HttpResponse head) const;
+
+    // 已超时、客户端已断开或服务器已停止
+    bool cancelled() const;
+
+    // 已发送或已取消
+    bool done() const;
+
+    // 取消时在事件循环线程调用（已取消时立即在当前线程调用）；重复设置覆盖之前的回调
+    void onCancel(std::function<void()> callback) const;
+
+    // 让资源与请求同生命周期（例如默认值填充后的请求副本、上游连接）
+    void keepAlive(std::shared_ptr<const void> resource) const;
+
+    bool valid() const { return state_ != nullptr; }
+
+private:
+    std::shared_ptr<State> state_;
+};
+
+typedef std::function<void(const HttpRequest&, Responder)> AsyncHandler;
+
+/**
+ * @brief 分块请求体：处理器设置块回调和结束回调，框架按块投递请求体，不复制到 HttpRequest::body
+ *
+ * - 回调都在事件循环线程执行，应在处理器内设置
+ * - 块回调返回 PAUSE 时暂停投递（剩余部分复制出来，不再占用连接的缓冲区），resume() 后继续；
+ *   resume() 可在任意线程调用
+ * - 块回调返回 ABORT 时停止投递；此时尚未响应则返回 400
+ * - 响应一旦发出（或超时、断开）即停止投递；整个请求仍受路由超时约束
+ *
+ * @code
+ * api.post("/ingest")
+ *    .maxBodySize(64 * 1024 * 1024)
+ *    .bodyStream([](const HttpRequest&, uvapi::BodyStream body, uvapi::Responder r) {
+ *        std::shared_ptr<uvapi::NdjsonSplitter> lines = std::make_shared<uvapi::NdjsonSplitter>();
+ *        body.onChunk([lines](uvapi::StringSlice chunk) {
+ *            bool ok = lines->feed(chunk.data, chunk.size, [](uvapi::StringSlice line) { return store(line); });
+ *            return ok ? uvapi::BodyAction::CONTINUE : uvapi::BodyAction::ABORT;
+ *        });
+ *        body.onEnd([lines, r]() {
+ *            lines->finish([](uvapi::StringSlice line) { return store(line); });
+ *            r.send(uvapi::HttpResponse(202));
+ *        });
+ *    })
+ *    .register_();
+ * @endcode
+ */
+class BodyStream {
+public:
+    struct State;
+
+    BodyStream() {}
+    explicit BodyStream(const std::shared_ptr<State>& state) : state_(state) {}
+
+    void onChunk(std::function<BodyAction(StringSlice chunk)> callback) const;
+    void onEnd(std::function<void()> callback) const;
+
+    // 暂停后恢复投递
+    void resume() const;
+
+    // 已投递的字节数 / 请求体总字节数
+    uint64_t received() const;
+    uint64_t total() const;
+
+    bool valid() const { return state_ != nullptr; }
+
+private:
+    std::shared_ptr<State> state_;
 };
 
+// head 为请求行、头部和参数（body 为空）
+typedef std::function<void(const HttpRequest& head, BodyStream body, Responder responder)> BodyStreamHandler;
+
 // ========== Server 层：底层 HTTP 服务器 ==========
 namespace server {
 
@@ -2267,6 +3668,7 @@ struct TlsConfig {
     std::string cert_file;      // 证书文件路径
     std::string key_file;       // 私钥文件路径
     std::string ca_file;        // CA 证书文件路径（可选，用于客户端认证）
+    tls::SessionOptions session;  // 会话恢复、ECDSA 证书与 ALPN（见 tls_session.h）
     
     TlsConfig() : enabled(false) {}
     
@@ -2278,10 +3680,16 @@ struct TlsConfig {
 };
 
 class Server;
+class ServerCluster;
 
 // 前向声明
 int on_uvhttp_request(uvhttp_request_t* req, uvhttp_response_t* resp);
 
+// 把 uvhttp 请求完整转换为 HttpRequest（方法、路径、头部、解码后的查询参数、请求体），
+// 供中间件适配器等不经路由分发的入口使用
+void convertRequest(uvhttp_request_t* req, HttpRequest& out);
+struct AsyncLoop;
+
 class Server {
 public:
     /**
@@ -2298,7 +3706,7 @@ public:
      * 
      * 3. **RAII 资源管理**: 自动清理，无需手动释放
      */
-    Server(uv_loop_t* loop);  // 事件循环注入
+    Server(uv_loop_t* loop, const ServerOptions& options = ServerOptions());  // 事件循环注入
     ~Server();
     
     // 禁止拷贝
@@ -2309,7 +3717,15 @@ public:
     Server(Server&& other) noexcept;
     Server& operator=(Server&& other) noexcept;
     
-    // 配置 TLS/SSL
+    /**
+     * @brief 配置 TLS/SSL
+     *
+     * 在 uvhttp 加载证书、私钥和 CA 之后，按 tls_config.session 直接配置其 mbedtls 上下文：
+     * 会话票据（密钥由定时器轮换，多核模式下各工作线程共用）、会话 ID 缓存、ALPN，
+     * 以及优先于 RSA 证书的 ECDSA 证书。所用 uvhttp 版本不暴露 mbedtls 配置时，
+     * 退回 uvhttp 自带的票据 / 缓存开关，其余选项打印警告后忽略。
+     * 流式响应（Responder::stream）直接写套接字，TLS 连接上不可用。
+     */
     void enableTls(const TlsConfig& tls_config);
     
     // 启动监听
@@ -2318,27 +3734,413 @@ public:
     
     void stop();
     uv_loop_t* getLoop() const { return loop_; }
+    const TlsConfig& getTlsConfig() const { return tls_config_; }
+    
+    // 握手与会话恢复统计（多核模式下各工作线程共用），未开启 TLS 时为空
+    std::shared_ptr<tls::SessionStats> tlsStats() const { return tls_stats_; }
+    
+    // 监听前设置 SO_REUSEPORT，允许多个 Server 在同一端口监听（多核模式）
+    void setReusePort(bool enabled) { reuse_port_ = enabled; }
+    
+    /**
+     * @brief 连接层选项（见 ServerOptions），应在 listen() 之前设置
+     *
+     * uvhttp 配置中没有对应字段的选项会打印警告并忽略；keep-alive 超时、单连接请求上限和
+     * TCP 选项由框架按连接执行（只作用于收到过请求的连接）。
+     */
+    void setOptions(const ServerOptions& options);
+    const ServerOptions& options() const { return options_; }
+    
+    // 本循环的连接统计（可从任意线程读取）；未跟踪连接时全为 0
+    ConnectionStats connectionStats() const;
+    
+    // 使用另一个 Server 的路由（多核模式下各工作线程共用原型发布的路由表，之后的发布同时生效）
+    void importRoutes(const Server& other);
+    
+    // ========== 路由表发布 ==========
+    //
+    // 下面的注册接口修改的是路由配置草稿；请求只读取已发布的只读路由表（路由树 + 处理器 +
+    // 冻结的中间件流水线），发布时从草稿整体重建并原子替换。旧表在各事件循环上正在处理的
+    // 请求结束后回收，排队中的请求继续使用入队时的旧表。listen() 之前的修改在 listen() 时发布；
+    // 之后每次修改立即发布，多处修改用 updateRoutes() 合并为一次。
+    // 草稿不加锁：运行期间的路由修改应在同一个线程进行。
+    
+    // 发布当前草稿（与已发布的相同时不重建），之后与 listen() 之后一样每次修改立即发布；
+    // 返回已发布的版本号
+    uint64_t publishRoutes();
+    
+    /**
+     * @brief 在一次发布中完成多处路由修改
+     *
+     * edit 中调用的注册、移除接口都只修改草稿，返回后统一发布：
+     * 并发的请求要么看到修改前的全部路由，要么看到修改后的全部路由。
+     * @return 发布后的版本号
+     */
+    uint64_t updateRoutes(const std::function<void(Server&)>& edit);
+    
+    // 移除路由（连同其缓存、限流、中间件设置），未注册时返回 false
+    bool removeRoute(const std::string& path, HttpMethod method);
+    
+    // 已发布的路由表版本号（从 1 开始，每次发布加一）
+    uint64_t routeVersion() const;
     
     // 路由注册（供上层 API 使用）
     void addRoute(const std::string& path, HttpMethod method, 
                   std::function<HttpResponse(const HttpRequest&)> handler);
     
+    // 零拷贝路由：处理器直接接收指向解析缓冲区的 HttpRequestView
+    void addViewRoute(const std::string& path, HttpMethod method, RequestViewHandler handler);
+    
+    /**
+     * @brief 异步路由：处理器收到请求副本和 Responder，返回后由 Responder 稍后完成响应
+     *
+     * 中间件照常在处理器之前执行并可以短路，但不作用于异步完成的响应；
+     * 异步路由不经过响应缓存和并发准入控制。timeout 内未完成时返回 504。
+     */
+    void addAsyncRoute(const std::string& path, HttpMethod method, AsyncHandler handler,
+                       std::chrono::milliseconds timeout = std::chrono::milliseconds(30000));
+    
+    // 分块请求体路由（见 BodyStream），建立在异步路由之上
+    void addStreamRoute(const std::string& path, HttpMethod method, BodyStreamHandler handler,
+                        std::chrono::milliseconds timeout = std::chrono::milliseconds(30000));
+    
+    // 路由的请求体上限（0 表示不限制）：超过时在复制请求体之前返回 413
+    void setRouteBodyLimit(const std::string& path, HttpMethod method, size_t max_body_size);
+    
+    /**
+     * @brief 全局中间件：对所有路由按注册顺序在处理器之前执行
+     *
+     * 每条路由的中间件（全局 + 路由级）在注册时冻结为扁平数组，请求时按下标推进，
+     * 不构造闭包。带中间件的路由使用完整 HttpRequest（零拷贝视图处理器由流水线末端转换），
+     * 且不经过路由缓存（缓存命中会绕过中间件）。限流和准入控制在中间件之前判定。
+     */
+    void use(const MiddlewareStage& stage);
+    
+    // 路由级中间件：在全局中间件之后执行
+    void useRoute(const std::string& path, HttpMethod method, const MiddlewareStage& stage);
+    
+    // 为已注册的路由开启响应缓存（GET/HEAD 请求），多核模式下所有工作线程共享同一缓存
+    void enableRouteCache(const std::string& path, HttpMethod method, const RouteCachePolicy& policy);
+    
+    // 全局按键限流：在路由分发前判定（含未匹配的请求），超限返回 429 和 Retry-After
+    void enableRateLimit(const rate::RateLimitPolicy& policy);
+    
+    // 为已注册的路由单独限流（在全局限流之后判定）
+    void enableRouteRateLimit(const std::string& path, HttpMethod method, const rate::RateLimitPolicy& policy);
+    
+    // 并发准入控制：超出上限的请求在本事件循环的有界队列中等待，队列满或排队超时返回 503
+    void enableAdmissionControl(const rate::AdmissionPolicy& policy);
+    
+    // 本事件循环的准入计数（可从任意线程读取）
+    rate::AdmissionStats admissionStats() const;
+    
+    /**
+     * @brief 请求级 arena：每个请求的临时分配（请求视图溢出存储，开启 hook_json 时包括 cJSON 节点
+     *        和打印缓冲区）从线程 arena 线性分配，响应发出后一次性回收
+     *
+     * 开启 hook_json 后，处理器中创建的 cJSON 对象不能保留到请求之外；钩子对整个进程生效，
+     * 须在创建任何 cJSON 值之前开启，之后 cJSON_Print 等返回的字符串必须用 cJSON_free 释放（不能用 free）。
+     */
+    void enableRequestArena(bool hook_json = false);
+    
+    /**
+     * @brief 响应压缩：处理器返回的响应体满足策略（大小、类型）时按 Accept-Encoding 压缩
+     *
+     * 已设置 Content-Encoding 或 Cache-Control: no-transform 的响应不处理；
+     * 缓存路由按协商出的编码分别缓存压缩后的响应，命中时不再压缩。
+     * 静态文件不经过此处（使用预压缩的兄弟文件）。
+     */
+    void enableCompression(const compress::CompressionPolicy& policy);
+    
+    /**
+     * @brief 原生 CORS：在路由之前处理，所有工作线程共用编译后的策略
+     *
+     * 允许来源的预检请求（OPTIONS + Origin + Access-Control-Request-Method）直接以 204
+     * 和预渲染的头部应答，不进入路由、限流和中间件；其他允许来源的请求在分发前写入
+     * Access-Control-Allow-Origin 等头部，随响应一并发出。不允许的来源按普通请求处理，不加任何 CORS 头部。
+     */
+    void enableCors(const CorsConfig& config);
+    void disableCors();
+    
+    /**
+     * @brief 请求追踪：按采样率和慢请求阈值记录请求，写入各线程的环形缓冲区
+     *
+     * 多核模式下所有工作线程共用同一个追踪器（每个线程各自的缓冲区）；传入空指针关闭。
+     * 收集线程由调用方启动（见 trace::Tracer::start）。
+     */
+    void enableTracing(const std::shared_ptr<trace::Tracer>& tracer);
+    
+    /**
+     * @brief CPU 密集型路由的线程池（多核模式下所有工作线程共享一个池）
+     *
+     * 之后用 addOffloadRoute 注册的路由在池中执行处理器，响应交回请求所在的事件循环写出。
+     * 未调用时，首次注册 offload 路由会按默认配置（CPU 核数个线程）创建。
+     */
+    void enableOffload(const offload::OffloadPolicy& policy);
+    
+    // 未开启时为空
+    std::shared_ptr<offload::WorkStealingPool> offloadPool() const { return offload_pool_; }
+    
+    /**
+     * @brief 处理器在线程池中执行的路由（建立在 addAsyncRoute 之上）
+     *
+     * 排队已满时立即返回 503；排队期间超时或客户端断开的请求不再执行。
+     * 处理器在池线程中运行，不能访问事件循环或其他非线程安全的状态。
+     */
+    void addOffloadRoute(const std::string& path, HttpMethod method,
+                         std::function<HttpResponse(const HttpRequest&)> handler,
+                         std::chrono::milliseconds timeout = std::chrono::milliseconds(30000));
+    
+    // 开启路由级延迟统计：已注册和之后注册的路由都记录到 family（多核模式下各工作线程共享）
+    void enableInstrumentation(const std::shared_ptr<metrics::RouteMetricsFamily>& family);
+    
+    /**
+     * @brief 静态文件服务：prefix 之下未匹配路由的 GET / HEAD 请求映射到 root 目录
+     *
+     * 支持强 ETag / Last-Modified 与 304、单范围 Range（206 / 416）、
+     * 按 Accept-Encoding 选择预压缩的 .br / .gz 兄弟文件。文件元数据和小文件的内存映射
+     * 常驻缓存，由所在目录的 uv_fs_event 监视器即时失效；多核模式下各工作线程共享同一缓存。
+     * 根目录不存在时返回 false。
+     */
+    bool serveStatic(const std::string& prefix, const std::string& root,
+                     const StaticOptions& options = StaticOptions());
+    
+    // 启动时预先解析并映射 prefix 下的一个文件，未找到时返回 false
+    bool prewarmStatic(const std::string& prefix, const std::string& relative);
+    
+    /**
+     * @brief 健康检查端点：GET health_path 返回各检查的汇总，GET ready_path 返回就绪状态
+     *
+     * 检查由本循环的定时器调度、在 offload 线程池中执行（未开启时按默认配置创建），
+     * 请求只复制最近一次预渲染的响应体。汇总为 unhealthy 时 /health 返回 503；
+     * 每个检查都完成过一次且汇总不是 unhealthy 之前 /ready 返回 503。
+     * ready_path 为空时不注册就绪端点；多核模式下各工作线程共用同一个管理器。
+     */
+    void enableHealthChecks(const std::shared_ptr<health::HealthCheckManager>& manager,
+                            const std::string& health_path = "/health",
+                            const std::string& ready_path = "/ready");
+    
     // 声明友元函数
     friend int on_uvhttp_request(uvhttp_request_t* req, uvhttp_response_t* resp);
     
-    // 路由查找（供内部使用）
+    // 路由查找（供内部使用）：在路由配置草稿中一次匹配得到处理器，可选写出路径参数；与注册接口在同一线程调用
     std::function<HttpResponse(const HttpRequest&)> findHandler(const std::string& path, HttpMethod method) const;
+    const std::function<HttpResponse(const HttpRequest&)>* matchRoute(
+        const char* path, HttpMethod method, std::map<std::string, std::string>* path_params) const;
     
 private:
     uv_loop_t* loop_;  // 注入的事件循环，不拥有所有权
+    // mbedtls 票据 / 缓存上下文和备用证书；TLS 上下文引用其中的对象，须在 server_ 之后析构
+    struct TlsSession;
+    std::shared_ptr<TlsSession> tls_session_;
     UvhttpServerPtr server_;
     UvhttpRouterPtr router_;
     UvhttpContextPtr uvhttp_ctx_;
     UvhttpConfigPtr config_;
     TlsConfig tls_config_;  // TLS 配置
     bool use_https_;
-    // 使用 unordered_map 存储自定义处理器（直接使用 uvhttp 路由）
-    std::unordered_map<std::string, std::unordered_map<uvhttp_method_t, std::function<HttpResponse(const HttpRequest&)> > > handlers_;
+    bool reuse_port_;
+    // 路由条目：handler 与 view_handler 二者只设置其一
+    struct RouteEntry {
+        std::string path;
+        HttpMethod method;
+        std::function<HttpResponse(const HttpRequest&)> handler;
+        RequestViewHandler view_handler;
+        std::shared_ptr<RouteCache> cache;  // 未启用缓存时为空
+        std::shared_ptr<metrics::RouteMetrics> metrics;  // 未开启统计时为空
+        std::shared_ptr<rate::KeyedRateLimiter> rate_limit;  // 未单独限流时为空
+        std::vector<MiddlewareStage> middleware;  // 路由级中间件
+        std::shared_ptr<const MiddlewarePipeline> pipeline;  // 冻结后的流水线，无中间件时为空
+        AsyncHandler async_handler;  // 异步路由，与 handler / view_handler 互斥
+        BodyStreamHandler stream_handler;  // 分块请求体路由，同样走异步分发
+        std::chrono::milliseconds async_timeout;
+        size_t max_body_size;  // 0 表示不限制
+        
+        RouteEntry() : method(HttpMethod::ANY), async_timeout(30000), max_body_size(0) {}
+        
+        bool isAsync() const { return async_handler || stream_handler; }
+        bool hasHandler() const { return handler || view_handler || isAsync(); }
+    };
+    
+    // 已发布的路由表：只读，多核模式下所有工作线程共用同一份
+    struct RouteSnapshot {
+        RouteTable table;
+        std::vector<RouteEntry> entries;  // 下标即 table 中的路由 ID，只含有处理器的路由
+        uint64_t revision;  // 构建时草稿的修订号
+        
+        RouteSnapshot() : revision(0) {}
+    };
+    typedef rcu::Cell<RouteSnapshot> RouteCell;
+    
+    // 调用路由处理器（经过流水线，或直接调用零拷贝 / 完整请求处理器）
+    static HttpResponse runHandler(const RouteEntry& entry, const HttpRequest& req);
+    
+    // 按全局和路由级中间件重建条目的流水线
+    void rebuildPipeline(RouteEntry& entry) const;
+    
+    // 调用路由处理器（零拷贝视图或完整请求）
+    static HttpResponse invokeRoute(const RouteEntry& entry, uvhttp_request_t* req, HttpMethod method,
+                                    const char* path, const RouteTable::RouteParam* params, int param_count);
+    
+    // 异步分发：复制请求、执行中间件后启动异步处理器，未完成的请求交给本循环的异步队列
+    void dispatchAsync(const RouteEntry& entry, uvhttp_request_t* req, uvhttp_response_t* resp,
+                       HttpMethod method, const char* path,
+                       const RouteTable::RouteParam* params, int param_count);
+    // 本循环的异步队列，首次使用时创建
+    std::shared_ptr<AsyncLoop> asyncLoop();
+    void stopAsync();
+    
+    // 经过路由缓存的分发：命中时直接写出预编码响应，过期时后台刷新；返回写出的状态码
+    int dispatchCached(const RouteEntry& entry, uvhttp_request_t* req, uvhttp_response_t* resp,
+                        HttpMethod method, const char* path,
+                        const RouteTable::RouteParam* params, int param_count);
+    
+    // 分发一次请求（缓存或直接调用处理器）并写出响应，返回写出的状态码
+    int dispatch(const RouteEntry& entry, uvhttp_request_t* req, uvhttp_response_t* resp,
+                 HttpMethod method, const char* path,
+                 const RouteTable::RouteParam* params, int param_count);
+    
+    // dispatch()，路由开启了延迟统计时同时记录各阶段耗时和状态码
+    void dispatchMeasured(const RouteEntry& entry, uvhttp_request_t* req, uvhttp_response_t* resp,
+                          HttpMethod method, const char* path,
+                          const RouteTable::RouteParam* params, int param_count);
+    
+    // 在事件循环的下一轮重新执行处理器并更新缓存
+    void scheduleRevalidation(const RouteEntry& entry, uvhttp_request_t* req, const char* path,
+                              const RouteTable::RouteParam* params, int param_count, const std::string& key,
+                              compress::Encoding encoding);
+    
+    // 本次请求协商出的响应编码（未开启压缩时为 IDENTITY）
+    compress::Encoding negotiateEncoding(uvhttp_request_t* req) const;
+    
+    // 按限流策略取键并判定；拒绝时直接写出 429
+    static bool admitRequest(rate::KeyedRateLimiter& limiter, uvhttp_request_t* req, uvhttp_response_t* resp,
+                             const char* route);
+    
+    // 跨源请求写入 CORS 头部；已应答预检时返回 true
+    static bool applyCors(const cors::CorsPolicy& policy, uvhttp_request_t* req, uvhttp_response_t* resp,
+                          HttpMethod method);
+    
+    // 监听成功后启动空闲键回收定时器，stop() 时关闭
+    void startRateLimitSweep();
+    void stopRateLimitSweep();
+    static void onSweepTimer(uv_timer_t* timer);
+    static void onSweepClosed(uv_handle_t* handle);
+    
+    // 排队中的请求：uvhttp 的请求缓冲区在回调结束后失效，入队时复制一份
+    struct PendingRequest {
+        HttpRequest* request;
+        uvhttp_response_t* resp;
+        std::shared_ptr<const RouteSnapshot> routes;  // 入队时的路由表，排队期间发布的新表不影响它
+        int route_id;
+        compress::Encoding encoding;
+        uv_tcp_t* client;
+        uint64_t peer;  // 连接跟踪用的对端摘要
+        
+        PendingRequest()
+            : request(nullptr), resp(nullptr), route_id(0), encoding(compress::Encoding::IDENTITY),
+              client(nullptr), peer(0) {}
+    };
+    struct AdmissionState;
+    
+    // 取得并发配额返回 true；否则请求已排队（或已返回 503），由队列稍后处理
+    bool beginAdmitted(const RouteCell::ReadGuard& routes, int route_id, uvhttp_request_t* req,
+                       uvhttp_response_t* resp, HttpMethod method, const char* path,
+                       const RouteTable::RouteParam* params, int param_count);
+    void finishAdmitted();
+    void drainAdmissionQueue();
+    void stopAdmission();
+    AdmissionState* admissionState();
+    static void onAdmissionTimer(uv_timer_t* timer);
+    static void onAdmissionClosed(uv_handle_t* handle);
+    
+    // 静态目录：前缀不含结尾的 '/'，根前缀为空串
+    struct StaticMount {
+        std::string prefix;
+        std::shared_ptr<StaticFileCache> cache;  // 所有工作线程共享
+    };
+    struct StaticWatcher;
+    
+    // 在静态目录中找到文件时写出响应并返回 true
+    bool serveStaticFile(const StaticMount& mount, uvhttp_request_t* req, uvhttp_response_t* resp,
+                         HttpMethod method, const char* path, size_t path_size);
+    // 文件首次进入缓存时为其所在目录注册监视器（每个目录一个，本循环内）
+    void watchStaticDirectory(const std::shared_ptr<StaticFileCache>& cache, const std::string& dir);
+    void stopStaticWatchers();
+    static void onStaticFsEvent(uv_fs_event_t* handle, const char* filename, int events, int status);
+    static void onStaticWatcherClosed(uv_handle_t* handle);
+    
+    // 预先创建带 SO_REUSEPORT 的套接字交给 uvhttp 绑定
+    bool openReusePortSocket(const std::string& host);
+    
+    // 连接跟踪：请求开始时记录并执行按连接的选项，返回对端摘要；结束时减少进行中计数
+    struct ConnectionScope;
+    uint64_t beginConnection(uvhttp_request_t* req, uvhttp_response_t* resp);
+    void endConnection(uv_tcp_t* client, uint64_t peer);
+    // 定期清理已关闭的连接，并半关闭空闲超过 keep-alive 超时的连接；stop() 时关闭
+    struct ConnectionSweeper;
+    void startConnectionSweep();
+    void stopConnectionSweep();
+    static void onConnectionSweep(uv_timer_t* timer);
+    static void onConnectionSweepClosed(uv_handle_t* handle);
+    // 监听成功后按管理器的 tickInterval() 调度健康检查，stop() 时关闭
+    struct HealthScheduler;
+    void startHealthChecks();
+    void stopHealthChecks();
+    static void onHealthTimer(uv_timer_t* timer);
+    static void onHealthTimerClosed(uv_handle_t* handle);
+    
+    // 在 uvhttp 的 TLS 上下文上配置会话恢复等选项；监听成功后启动票据密钥轮换定时器，stop() 时关闭
+    void configureTlsSessions(uvhttp_tls_context_t* tls_ctx);
+    struct TlsRotationTimer;
+    void startTlsRotation();
+    void stopTlsRotation();
+    static void onTlsRotationTimer(uv_timer_t* timer);
+    static void onTlsRotationClosed(uv_handle_t* handle);
+    
+    // 注册路由到草稿和 uvhttp，返回路由条目（模式非法时为 nullptr）
+    RouteEntry* registerRoute(const std::string& path, HttpMethod method);
+    
+    // 草稿已修改：修订号加一，运行期间且不在 updateRoutes 中时立即发布
+    void routesChanged();
+    // 草稿与已发布的修订号不同时重建并发布（只读取草稿，工作线程导入时也会调用）
+    void syncRoutes() const;
+    
+    // 路由配置草稿：注册接口修改这里，请求不直接访问；请求时按已发布的路由表一次匹配得到
+    // 稠密路由 ID，直接索引处理器
+    RouteTable route_table_;
+    std::vector<RouteEntry> handlers_;
+    uint64_t route_revision_;  // 草稿每次修改加一
+    std::shared_ptr<RouteCell> routes_;  // 已发布的路由表；工作线程与原型共用
+    RouteCell::Reader* route_reader_;    // 本循环在 routes_ 中的读者槽位
+    bool routes_owner_;  // 由本 Server 的草稿发布；导入原型路由的工作线程为 false
+    bool routes_live_;   // 已开始监听：之后的修改立即发布
+    int route_batch_;    // updateRoutes 的嵌套深度
+    std::shared_ptr<metrics::RouteMetricsFamily> route_metrics_;
+    std::shared_ptr<rate::KeyedRateLimiter> rate_limit_;  // 全局限流，未开启时为空
+    struct RateLimitSweeper;
+    RateLimitSweeper* rate_sweeper_;  // 由关闭回调释放
+    std::shared_ptr<rate::AdmissionController> admission_;  // 所有工作线程共享，未开启时为空
+    AdmissionState* admission_state_;  // 本循环的队列，首次使用时创建，由关闭回调释放
+    bool request_arena_;
+    bool arena_json_;
+    std::vector<MiddlewareStage> middleware_;  // 全局中间件
+    std::shared_ptr<const compress::CompressionPolicy> compression_;  // 未开启时为空
+    std::shared_ptr<const cors::CorsPolicy> cors_;  // 只读，所有工作线程共享；未开启时为空
+    std::shared_ptr<trace::Tracer> tracer_;  // 所有工作线程共享，未开启时为空
+    std::shared_ptr<AsyncLoop> async_loop_;  // 本循环的异步队列，由关闭回调释放
+    std::shared_ptr<offload::WorkStealingPool> offload_pool_;  // 所有工作线程共享，未开启时为空
+    std::vector<StaticMount> static_mounts_;  // 按前缀长度降序
+    std::map<std::string, StaticWatcher*> static_watchers_;  // 按目录，由关闭回调释放
+    ServerOptions options_;
+    std::shared_ptr<ConnectionTracker> connections_;  // 未跟踪连接时为空；异步请求完成时也会访问
+    ConnectionSweeper* connection_sweeper_;  // 由关闭回调释放
+    std::shared_ptr<health::HealthCheckManager> health_;  // 所有工作线程共享，未开启时为空
+    HealthScheduler* health_scheduler_;  // 由关闭回调释放
+    std::shared_ptr<tls::TicketKeyRing> tls_keys_;   // 所有工作线程共享，未开启票据时为空
+    std::shared_ptr<tls::SessionStats> tls_stats_;   // 所有工作线程共享，未开启 TLS 时为空
+    TlsRotationTimer* tls_timer_;  // 由关闭回调释放
+    uint64_t request_peer_;  // 当前请求的对端摘要（只在事件循环线程使用）
 };
 
 } // namespace server
@@ -2363,204 +4165,258 @@ class JSON {
 public:
     // ========== 序列化 API ==========
     
-    // 快速构造：成功响应
+    // 快速构造：成功响应（紧凑 JSON，直接写入缓冲区，不构造 cJSON 树）
     static std::string success(const std::string& message = "Success") {
-        return Object()
-            .set("code", "0")
-            .set("message", message)
-            .toString();
+        StringBuilder json(32 + message.size());
+        json << "{\"code\":\"0\",\"message\":";
+        json.appendQuoted(message);
+        json << '}';
+        return json.release();
     }
     
     // 快速构造：错误响应
     static std::string error(const std::string& message) {
-        return Object()
-            .set("code", "-1")
-            .set("message", message)
-            .toString();
+        StringBuilder json(32 + message.size());
+        json << "{\"code\":\"-1\",\"message\":";
+        json.appendQuoted(message);
+        json << '}';
+        return json.release();
     }
     
     // 快速构造：数据响应
     static std::string data(const std::string& json_data) {
-        // 直接将 JSON 字符串包装到 data 字段中
-        return Object()
-            .set("code", "0")
-            .set("message", "Success")
-            .set("data", json_data)
-            .toString();
+        // 直接将 JSON 字符串包装到 data 字段中（作为字符串值）
+        StringBuilder json(48 + json_data.size());
+        json << "{\"code\":\"0\",\"message\":\"Success\",\"data\":";
+        json.appendQuoted(json_data);
+        json << '}';
+        return json.release();
     }
     
     // ========== JSON 对象构建器 ==========
+    //
+    // 成员按调用顺序直接写入一个缓冲区，不构造 cJSON 树；嵌套的 Object / Array
+    // 以编码好的字节拼接进来。右值上的 toCompactString() 把缓冲区移出，不复制：
+    //   HttpResponse(200).json(JSON::Object().set("id", 1).toCompactString());
     class Array;  // 前向声明
     
     class Object {
     private:
-        CJsonPtr root_;
+        std::string buffer_;  // 已写入的 '{' 和成员，不含结尾的 '}'
+        
+        friend class Array;
+        
+        // 写入分隔逗号和键
+        void key(const std::string& key) {
+            if (buffer_.size() > 1) {
+                buffer_ += ',';
+            }
+            json::appendQuoted(buffer_, key.data(), key.size());
+            buffer_ += ':';
+        }
+        
+        void appendTo(std::string& out) const {
+            out.append(buffer_);
+            out += '}';
+        }
         
     public:
-        Object() : root_(uvapi::makeCJson(cJSON_CreateObject())) {}
+        Object() : buffer_(1, '{') {}
         
         // 链式设置方法
         Object& set(const std::string& key, const std::string& value) {
-            if (root_) {
-                cJSON_AddStringToObject(root_.get(), key.c_str(), value.c_str());
-            }
+            this->key(key);
+            json::appendQuoted(buffer_, value.data(), value.size());
             return *this;
         }
         
         Object& set(const std::string& key, const char* value) {
-            if (root_ && value) {
-                cJSON_AddStringToObject(root_.get(), key.c_str(), value);
+            if (value) {
+                this->key(key);
+                json::appendQuoted(buffer_, value, std::strlen(value));
             }
             return *this;
         }
         
         Object& set(const std::string& key, int value) {
-            if (root_) {
-                cJSON_AddNumberToObject(root_.get(), key.c_str(), value);
-            }
+            this->key(key);
+            json::appendInteger(buffer_, value);
             return *this;
         }
         
         Object& set(const std::string& key, int64_t value) {
-            if (root_) {
-                cJSON_AddNumberToObject(root_.get(), key.c_str(), static_cast<double>(value));
-            }
+            this->key(key);
+            json::appendInteger(buffer_, value);
             return *this;
         }
         
         Object& set(const std::string& key, double value) {
-            if (root_) {
-                cJSON_AddNumberToObject(root_.get(), key.c_str(), value);
-            }
+            this->key(key);
+            json::appendDouble(buffer_, value);
             return *this;
         }
         
         Object& set(const std::string& key, bool value) {
-            if (root_) {
-                cJSON_AddBoolToObject(root_.get(), key.c_str(), value);
+            this->key(key);
+            if (value) {
+                buffer_.append("true", 4);
+            } else {
+                buffer_.append("false", 5);
             }
             return *this;
         }
         
         Object& set(const std::string& key, const Object& obj) {
-            if (root_ && obj.isValid()) {
-                cJSON_AddItemToObject(root_.get(), key.c_str(), cJSON_Duplicate(obj.get(), true));
-            }
+            this->key(key);
+            obj.appendTo(buffer_);
             return *this;
         }
         
-        Object& set(const std::string& key, const Array& arr) {
-            if (root_ && arr.isValid()) {
-                cJSON_AddItemToObject(root_.get(), key.c_str(), cJSON_Duplicate(arr.get(), true));
-            }
-            return *this;
-        }
+        Object& set(const std::string& key, const Array& arr);
         
         Object& setNull(const std::string& key) {
-            if (root_) {
-                cJSON_AddNullToObject(root_.get(), key.c_str());
-            }
+            this->key(key);
+            buffer_.append("null", 4);
             return *this;
         }
         
-        // 转换为 JSON 字符串
+        // 转换为 JSON 字符串（缩进格式）
         std::string toString() const {
-            if (!root_) return "{}";
-            CJsonStringPtr json = uvapi::makeCJsonString(cJSON_Print(root_.get()));
-            return std::string(json.get() ? json.get() : "{}");
+            std::string compact = toCompactString();
+            std::string out;
+            json::appendPretty(out, compact.data(), compact.size());
+            return out;
         }
         
         // 转换为紧凑 JSON 字符串
-        std::string toCompactString() const {
-            if (!root_) return "{}";
-            CJsonStringPtr json = uvapi::makeCJsonString(cJSON_PrintUnformatted(root_.get()));
-            return std::string(json.get() ? json.get() : "{}");
+        std::string toCompactString() const & {
+            std::string out;
+            out.reserve(buffer_.size() + 1);
+            appendTo(out);
+            return out;
         }
         
-        // 检查对象是否有效
-        bool isValid() const { return root_ != nullptr; }
+        // 右值：移出缓冲区，之后对象为空
+        std::string toCompactString() && {
+            buffer_ += '}';
+            std::string out = std::move(buffer_);
+            buffer_.assign(1, '{');
+            return out;
+        }
         
-        // 获取原始 cJSON 指针（用于高级操作）
-        cJSON* get() const { return root_.get(); }
+        // 检查对象是否有效（缓冲区写入不会失败，始终为 true）
+        bool isValid() const { return true; }
+        
+        // 已写入的字节数（用于预估响应体大小）
+        size_t size() const { return buffer_.size() + 1; }
     };
     
     // ========== JSON 数组构建器 ==========
     class Array {
     private:
-        CJsonPtr root_;
+        std::string buffer_;  // 已写入的 '[' 和元素，不含结尾的 ']'
+        
+        friend class Object;
+        
+        // 写入分隔逗号
+        void next() {
+            if (buffer_.size() > 1) {
+                buffer_ += ',';
+            }
+        }
+        
+        void appendTo(std::string& out) const {
+            out.append(buffer_);
+            out += ']';
+        }
         
     public:
-        Array() : root_(uvapi::makeCJson(cJSON_CreateArray())) {}
+        Array() : buffer_(1, '[') {}
         
         // 链式添加方法
         Array& append(const std::string& value) {
-            if (root_) {
-                cJSON_AddItemToArray(root_.get(), cJSON_CreateString(value.c_str()));
-            }
+            next();
+            json::appendQuoted(buffer_, value.data(), value.size());
             return *this;
         }
         
         Array& append(const char* value) {
-            if (root_ && value) {
-                cJSON_AddItemToArray(root_.get(), cJSON_CreateString(value));
+            if (value) {
+                next();
+                json::appendQuoted(buffer_, value, std::strlen(value));
             }
             return *this;
         }
         
         Array& append(int value) {
-            if (root_) {
-                cJSON_AddItemToArray(root_.get(), cJSON_CreateNumber(value));
-            }
+            next();
+            json::appendInteger(buffer_, value);
             return *this;
         }
         
         Array& append(int64_t value) {
-            if (root_) {
-                cJSON_AddItemToArray(root_.get(), cJSON_CreateNumber(static_cast<double>(value)));
-            }
+            next();
+            json::appendInteger(buffer_, value);
             return *this;
         }
         
         Array& append(double value) {
-            if (root_) {
-                cJSON_AddItemToArray(root_.get(), cJSON_CreateNumber(value));
-            }
+            next();
+            json::appendDouble(buffer_, value);
             return *this;
         }
         
         Array& append(bool value) {
-            if (root_) {
-                cJSON_AddItemToArray(root_.get(), cJSON_CreateBool(value));
+            next();
+            if (value) {
+                buffer_.append("true", 4);
+            } else {
+                buffer_.append("false", 5);
             }
             return *this;
         }
         
         Array& append(const Object& obj) {
-            if (root_ && obj.isValid()) {
-                cJSON_AddItemToArray(root_.get(), cJSON_Duplicate(obj.get(), true));
-            }
+            next();
+            obj.appendTo(buffer_);
+            return *this;
+        }
+        
+        Array& append(const Array& arr) {
+            next();
+            arr.appendTo(buffer_);
             return *this;
         }
         
-        // 转换为 JSON 字符串
+        // 转换为 JSON 字符串（缩进格式）
         std::string toString() const {
-            if (!root_) return "[]";
-            CJsonStringPtr json = uvapi::makeCJsonString(cJSON_Print(root_.get()));
-            return std::string(json.get() ? json.get() : "[]");
+            std::string compact = toCompactString();
+            std::string out;
+            json::appendPretty(out, compact.data(), compact.size());
+            return out;
         }
         
         // 转换为紧凑 JSON 字符串
-        std::string toCompactString() const {
-            if (!root_) return "[]";
-            CJsonStringPtr json = uvapi::makeCJsonString(cJSON_PrintUnformatted(root_.get()));
-            return std::string(json.get() ? json.get() : "[]");
+        std::string toCompactString() const & {
+            std::string out;
+            out.reserve(buffer_.size() + 1);
+            appendTo(out);
+            return out;
         }
         
-        // 检查数组是否有效
-        bool isValid() const { return root_ != nullptr; }
+        // 右值：移出缓冲区，之后数组为空
+        std::string toCompactString() && {
+            buffer_ += ']';
+            std::string out = std::move(buffer_);
+            buffer_.assign(1, '[');
+            return out;
+        }
         
-        // 获取原始 cJSON 指针（用于高级操作）
-        cJSON* get() const { return root_.get(); }
+        // 检查数组是否有效（缓冲区写入不会失败，始终为 true）
+        bool isValid() const { return true; }
+        
+        // 已写入的字节数（用于预估响应体大小）
+        size_t size() const { return buffer_.size() + 1; }
     };
     
     // ========== JSON 解析器 ==========
@@ -2620,19 +4476,11 @@ public:
     };
 };
 
-// CORS 配置
-struct CorsConfig {
-    bool enabled;
-    std::string allowed_origins;
-    std::string allowed_methods;
-    std::string allowed_headers;
-    bool allow_credentials;
-    int max_age;
-    
-    CorsConfig() 
-        : enabled(false), allowed_origins("*"), allowed_methods("GET, POST, PUT, DELETE, OPTIONS"),
-          allowed_headers("Content-Type, Authorization"), allow_credentials(false), max_age(86400) {}
-};
+inline JSON::Object& JSON::Object::set(const std::string& key, const JSON::Array& arr) {
+    this->key(key);
+    arr.appendTo(buffer_);
+    return *this;
+}
 
 // Token 信息
 struct TokenInfo {
@@ -2649,6 +4497,9 @@ struct TokenInfo {
 // 请求处理器类型（原始类型，用于向后兼容）
 using RequestHandler = std::function<HttpResponse(const HttpRequest&)>;
 
+// 读取类型化参数的处理器（参数由 RouteBuilder::query<T>() / param<T>() 声明）
+using BoundRequestHandler = std::function<HttpResponse(const HttpRequest&, const BoundParams&)>;
+
 // 前向声明 jsonError
 std::string jsonError(const std::string& message);
 
@@ -2740,11 +4591,13 @@ private:
             // 情况2: handler(ReqBody) -> HttpResponse
             return [func](const HttpRequest& req) -> HttpResponse {
                 try {
-                    // 反序列化请求
-                    ReqBody body = req.parseBody<ReqBody>();
-                    
-                    // 验证请求
-                    ValidationResult validation = validateRequest(body);
+                    // 解析并验证请求（单次扫描）
+                    ReqBody body;
+                    ValidationResult validation;
+                    {
+                        metrics::PhaseTimer timer(metrics::Phase::VALIDATION);
+                        validation = parseRequest(req.body, body);
+                    }
                     if (!validation) {
                         return HttpResponse(400).json(jsonError(validation.error_message));
                     }
@@ -2759,11 +4612,13 @@ private:
             // 情况3: handler(ReqBody) -> ResBody
             return [func](const HttpRequest& req) -> HttpResponse {
                 try {
-                    // 反序列化请求
-                    ReqBody body = req.parseBody<ReqBody>();
-                    
-                    // 验证请求
-                    ValidationResult validation = validateRequest(body);
+                    // 解析并验证请求（单次扫描）
+                    ReqBody body;
+                    ValidationResult validation;
+                    {
+                        metrics::PhaseTimer timer(metrics::Phase::VALIDATION);
+                        validation = parseRequest(req.body, body);
+                    }
                     if (!validation) {
                         return HttpResponse(400).json(jsonError(validation.error_message));
                     }
@@ -2771,10 +4626,9 @@ private:
                     // 调用处理器获取响应
                     ResBody response = func(body);
                     
-                    // 序列化响应
-                    std::string json = response.schema()->toJson(&response);
-                    
-                    return HttpResponse(200).json(json);
+                    // 序列化响应（直接写入响应体）
+                    metrics::PhaseTimer timer(metrics::Phase::SERIALIZATION);
+                    return HttpResponse(200).json(response);
                 } catch (const std::exception& e) {
                     return HttpResponse(400).json(jsonError(std::string("Error: ") + e.what()));
                 }
@@ -2822,6 +4676,7 @@ struct ParamValidation {
     double min_double;
     double max_double;
     std::string pattern;
+    CompiledPattern compiled_pattern;  // pattern() 声明时编译
     std::vector<std::string> enum_values;
     bool has_min;
     bool has_max;
@@ -2846,9 +4701,10 @@ struct ParamDefinition {
     std::string default_value;
     ParamValidation validation;
     int data_type;  // 0=string, 1=int, 2=int64, 3=double, 4=float, 5=bool
+    bool bind;      // 验证时按 data_type 解析并写入 BoundParams
     
     ParamDefinition(const std::string& n, ParamType t) 
-        : name(n), type(t), data_type(0) {}  // 默认为 string
+        : name(n), type(t), data_type(0), bind(false) {}  // 默认为 string
 };
 
 // 参数构建器
@@ -2912,6 +4768,13 @@ public:
         return *this;
     }
     
+    // 绑定为类型化参数（见 BoundParams）：验证时总是检查类型，解析结果交给处理器
+    ParamBuilder& bindAs(int data_type) {
+        param_.data_type = data_type;
+        param_.bind = true;
+        return *this;
+    }
+    
     // 必填参数
     ParamBuilder& required() {
         param_.validation.required = true;
@@ -2947,18 +4810,22 @@ public:
         return *this;
     }
     
-    // 浮点数范围
+    // 浮点数范围（同时将参数视为浮点数，验证时使用浮点边界）
     ParamBuilder& range(double min_val, double max_val) {
         param_.validation.min_double = min_val;
         param_.validation.max_double = max_val;
         param_.validation.has_min = true;
         param_.validation.has_max = true;
+        if (param_.data_type != 4) {
+            param_.data_type = 3;  // double
+        }
         return *this;
     }
     
     // 正则表达式
     ParamBuilder& pattern(const std::string& regex) {
         param_.validation.pattern = regex;
+        param_.validation.compiled_pattern = CompiledPattern(regex);
         param_.validation.has_pattern = true;
         return *this;
     }
@@ -3077,11 +4944,18 @@ struct RouteDefinition {
     std::string path;
     HttpMethod method;
     RequestHandler handler;
+    BoundRequestHandler bound_handler;  // 非空时优先于 handler
+    RequestViewHandler view_handler;  // 非空时优先于 handler
+    AsyncHandler async_handler;       // 非空时优先于以上两者
+    BodyStreamHandler stream_handler; // 非空时优先于以上所有
+    std::chrono::milliseconds timeout;  // 异步处理器的完成时限
+    bool offload;                       // handler 在线程池中执行
+    size_t max_body_size;               // 0 表示不限制
     std::vector<ParamDefinition> path_params;
     std::vector<ParamDefinition> query_params;
     
     RouteDefinition(const std::string& p, HttpMethod m, RequestHandler h)
-        : path(p), method(m), handler(h) {}
+        : path(p), method(m), handler(h), timeout(30000), offload(false), max_body_size(0) {}
 };
 
 // 前向声明
@@ -3093,6 +4967,12 @@ private:
     Api* api_;
     RouteDefinition route_;
     ParamGroup param_group_;
+    std::shared_ptr<server::RouteCachePolicy> cache_policy_;  // 未声明缓存时为空
+    std::shared_ptr<rate::RateLimitPolicy> rate_policy_;      // 未声明限流时为空
+    std::vector<MiddlewareStage> middleware_;                 // 路由级中间件
+    
+    // 注册处理器（含参数验证包装）
+    void registerHandler();
     
 public:
     RouteBuilder(Api* api, const std::string& path, HttpMethod method)
@@ -3113,6 +4993,30 @@ public:
     }
     
     // 应用参数组
+    /**
+     * @brief 类型化参数：验证时解析一次（类型不符返回 400），处理器经 BoundParams 读取
+     *
+     * T 为 int、int64_t、double、float、bool、std::string 或 StringSlice；
+     * config 可继续声明 required / range / defaultValue 等规则。
+     */
+    template<typename T>
+    RouteBuilder& param(const std::string& name, std::function<void(ParamBuilder&)> config = nullptr) {
+        param_group_.addPathParam(name, [config](ParamBuilder& p) {
+            if (config) config(p);
+            p.bindAs(ParamBinding<T>::data_type);
+        });
+        return *this;
+    }
+    
+    template<typename T>
+    RouteBuilder& query(const std::string& name, std::function<void(ParamBuilder&)> config = nullptr) {
+        param_group_.addQueryParam(name, [config](ParamBuilder& p) {
+            if (config) config(p);
+            p.bindAs(ParamBinding<T>::data_type);
+        });
+        return *this;
+    }
+    
     RouteBuilder& apply(const ParamGroup& group) {
         for (const auto& param : group.getParams()) {
             if (param.type == ParamType::PATH) {
@@ -3161,6 +5065,96 @@ public:
     // 设置 handler（返回 RouteBuilder 支持链式调用）
     RouteBuilder& handler(RequestHandler handler) {
         route_.handler = handler;
+        route_.bound_handler = nullptr;
+        route_.view_handler = nullptr;
+        return *this;
+    }
+    
+    // 设置读取类型化参数的 handler（可与 offload() 组合）
+    RouteBuilder& handler(BoundRequestHandler handler) {
+        route_.bound_handler = handler;
+        route_.view_handler = nullptr;
+        return *this;
+    }
+    
+    // 设置零拷贝 handler：参数验证和默认值直接作用于 HttpRequestView
+    RouteBuilder& viewHandler(RequestViewHandler handler) {
+        route_.view_handler = handler;
+        return *this;
+    }
+    
+    /**
+     * @brief 设置异步 handler：参数验证照常执行（失败时直接返回 400），
+     *        之后由 Responder 在任意时刻、任意线程完成响应（见 Responder）
+     */
+    RouteBuilder& handlerAsync(AsyncHandler handler) {
+        route_.async_handler = handler;
+        return *this;
+    }
+    
+    /**
+     * @brief handler 在 offload 线程池中执行（见 Server::addOffloadRoute），用于 CPU 密集型路由
+     *
+     * 只作用于完整请求的 handler；零拷贝的 viewHandler 引用事件循环的缓冲区，不能移出线程。
+     */
+    RouteBuilder& offload() {
+        route_.offload = true;
+        return *this;
+    }
+    
+    /**
+     * @brief 分块接收请求体（见 BodyStream）：用于大文件、multipart 流式解析和 NDJSON 导入
+     *
+     * 参数验证照常执行（失败时返回 400，不投递请求体）。
+     */
+    RouteBuilder& bodyStream(BodyStreamHandler handler) {
+        route_.stream_handler = handler;
+        return *this;
+    }
+    
+    // 请求体上限，超过时返回 413（默认不限制）
+    RouteBuilder& maxBodySize(size_t bytes) {
+        route_.max_body_size = bytes;
+        return *this;
+    }
+    
+    // 异步或 offload handler 的完成时限，超时返回 504（默认 30 秒）
+    RouteBuilder& timeout(std::chrono::milliseconds limit) {
+        route_.timeout = limit;
+        return *this;
+    }
+    
+    /**
+     * @brief 声明路由级响应缓存（仅对 GET/HEAD 请求生效）
+     *
+     * 只缓存 200 响应，带 Set-Cookie 或 Cache-Control: no-store / private 的响应不缓存。
+     * 不要用于用户特定的响应，除非把区分用户的请求头加入 varyHeader()。
+     */
+    RouteBuilder& cache(const server::RouteCachePolicy& policy) {
+        cache_policy_ = std::make_shared<server::RouteCachePolicy>(policy);
+        return *this;
+    }
+    
+    RouteBuilder& cache(std::chrono::milliseconds ttl) {
+        return cache(server::RouteCachePolicy(ttl));
+    }
+    
+    /**
+     * @brief 声明路由级按键限流（键来源见 rate::RateLimitPolicy::byClientIp / byHeader / byRoute）
+     */
+    RouteBuilder& rateLimit(const rate::RateLimitPolicy& policy) {
+        rate_policy_ = std::make_shared<rate::RateLimitPolicy>(policy);
+        return *this;
+    }
+    
+    /**
+     * @brief 路由级中间件（在 Api::use 注册的全局中间件之后执行）
+     *
+     * 接受 HttpResponse(const HttpRequest&, const MiddlewareNext&)，
+     * 也接受旧式的 HttpResponse(const HttpRequest&, RequestHandler)。
+     */
+    RouteBuilder& use(const MiddlewareStage& stage) {
+        middleware_.push_back(stage);
         return *this;
     }
     
@@ -3190,7 +5184,7 @@ using Middleware = std::function<HttpResponse(const HttpRequest&, RequestHandler
  */
 class Api {
 public:
-    Api(uv_loop_t* loop);  // 事件循环注入
+    Api(uv_loop_t* loop, const server::ServerOptions& options = server::ServerOptions());  // 事件循环注入
     ~Api();
     
     // ========== 类型安全的路由注册（推荐使用）==========
@@ -3270,6 +5264,70 @@ public:
     Api& enableCors(bool enabled = true);
     Api& disableCors();
     
+    /**
+     * @brief 开启路由级延迟统计，并在 path 上注册 Prometheus 文本格式的抓取端点
+     *
+     * 按路由、方法、状态码类别和阶段（parse / validation / handler / serialization / total）
+     * 输出 p50/p90/p99/p999 分位数；_count 即请求数。
+     * options.refresh_interval > 0 时在后台线程定时渲染，抓取请求不占用事件循环做格式化。
+     */
+    Api& enableMetrics(const std::string& path = "/metrics");
+    Api& enableMetrics(const std::string& path, metrics::MetricRegistry& registry,
+                       const metrics::ExpositionOptions& options = metrics::ExpositionOptions());
+    
+    /**
+     * @brief 开启按采样的请求追踪与慢请求记录，并在 path 上注册 JSON 查看端点
+     *
+     * 端点返回收集线程最近一次渲染的最近采样请求和慢请求（按时间倒序），每条带各阶段耗时、
+     * 路由、状态码、请求 / 响应体大小和 arena 用量。policy.exporter 在收集线程上接收每一批记录，
+     * 可用 trace::renderOtlpJson() 转换为 OTLP 格式。
+     */
+    Api& enableTracing(const trace::TracePolicy& policy, const std::string& path = "/debug/traces");
+    
+    // 追踪器（未开启时为空），可用于查看 stats() 或手动 collect()
+    trace::Tracer* tracer() const { return tracer_.get(); }
+    
+    // 健康检查端点（见 Server::enableHealthChecks）；检查在 offload 线程池中执行，应在 offload() 之后调用
+    Api& healthChecks(const std::shared_ptr<health::HealthCheckManager>& manager,
+                      const std::string& health_path = "/health", const std::string& ready_path = "/ready");
+    
+    // 全局按键限流（多核模式下所有工作线程共享同一张表）
+    Api& rateLimit(const rate::RateLimitPolicy& policy);
+    
+    // 并发准入控制（多核模式下并发上限为所有工作线程合计）
+    Api& admissionControl(const rate::AdmissionPolicy& policy);
+    
+    // 请求级 arena（见 Server::enableRequestArena）
+    Api& requestArena(bool hook_json = false);
+    
+    // 全局中间件（见 Server::use），按注册顺序执行
+    Api& use(const MiddlewareStage& stage);
+    
+    // 响应压缩（见 Server::enableCompression）
+    Api& compression(const compress::CompressionPolicy& policy = compress::CompressionPolicy());
+    
+    // CPU 密集型路由的线程池（见 Server::enableOffload）；开启指标时其排队深度和等待时间一并导出
+    Api& offload(const offload::OffloadPolicy& policy = offload::OffloadPolicy());
+    
+    // 多核模式：n 个工作线程各自运行事件循环（<= 0 表示 CPU 核数，默认 1 为单循环）
+    Api& workers(int n) { workers_ = n; return *this; }
+    
+    // 连接层选项（见 Server::setOptions），应在 run() 之前设置；多核模式下每个工作线程使用同一份
+    Api& options(const server::ServerOptions& options);
+    
+    // 连接统计（多核模式下为所有工作线程合计）
+    server::ConnectionStats connectionStats() const;
+    
+    /**
+     * @brief 运行期间修改路由（见 Server::updateRoutes）：edit 中注册或移除的路由一次发布，
+     *        多核模式下同时作用于所有工作线程，不需要重启；可以从事件循环之外的线程调用
+     * @return 发布后的路由表版本号
+     */
+    uint64_t updateRoutes(const std::function<void(Api&)>& edit);
+    
+    // 移除路由（见 Server::removeRoute），运行期间立即发布
+    bool removeRoute(const std::string& path, HttpMethod method);
+    
     // 启动应用
     bool run(const std::string& host = "0.0.0.0", int port = 8080);
     
@@ -3280,13 +5338,23 @@ public:
     uvapi::server::Server* getServer() { return server_.get(); }
     
     // Token 管理
+    // 会话 token 为 32 字节随机串，按哈希分片存放在开放寻址哈希表中，由时间轮按秒回收过期项（线程安全）
     std::string generateToken(int64_t user_id, const std::string& username, 
                               const std::string& role, int64_t expires_in_seconds = 3600);
     bool validateToken(const std::string& token, int64_t& user_id, std::string& username, std::string& role);
     std::string refreshToken(const std::string& token, int64_t expires_in_seconds = 3600);
     bool revokeToken(const std::string& token);
+    // 推进过期时间轮（单核模式下由事件循环定时器每秒调用，无需手动调用）
     void cleanupExpiredTokens();
     
+    /**
+     * @brief 启用无状态签名 token（HMAC-SHA256）
+     *
+     * 开启后 generateToken 返回 "v1.<声明>.<签名>"，validateToken 只校验签名和过期时间，
+     * 不访问存储；签名 token 无法通过 revokeToken 撤销。密钥至少 32 字节，传空串关闭。
+     */
+    Api& signedTokens(const std::string& secret);
+    
     // 请求处理
     HttpResponse handle_request(const HttpRequest& req);
     
@@ -3294,6 +5362,14 @@ private:
     // 辅助方法：检查 token 是否过期
     bool isTokenExpired(const TokenInfo& info) const;
     
+    // token 存储（定义在 framework_uvhttp.cpp），由 Api 和过期定时器共享
+    struct TokenState;
+    struct TokenExpiryTimer;
+    static void onTokenTimer(uv_timer_t* timer);
+    static void onTokenTimerClosed(uv_handle_t* handle);
+    void startTokenExpiry();
+    void stopTokenExpiry();
+    
 private:
     std::string api_title_;
     std::string api_description_;
@@ -3302,11 +5378,15 @@ private:
     bool running_;
     CorsConfig cors_config_;
     bool cors_enabled_;
-    std::map<std::string, TokenInfo> tokens_;
-    int64_t token_generation_count_;
-    int64_t last_cleanup_time_;
+    std::shared_ptr<TokenState> tokens_;
+    TokenExpiryTimer* token_timer_;  // 未运行事件循环时为空
     
     std::unique_ptr<uvapi::server::Server> server_;  // 使用 unique_ptr 管理 Server 层
+    int workers_;
+    std::unique_ptr<uvapi::server::ServerCluster> cluster_;  // 多核模式下 server_ 仅作为路由原型
+    std::unique_ptr<metrics::BackgroundScraper> metrics_scraper_;  // 未开启后台渲染时为空
+    metrics::MetricRegistry* metrics_registry_;  // 未开启指标时为空，由调用方持有
+    std::shared_ptr<trace::Tracer> tracer_;  // 未开启追踪时为空
     
     std::string generateRandomString(size_t length);
     std::string extractBearerToken(const std::string& auth_header);
@@ -3344,21 +5424,29 @@ public:
     
     // ========== 转换为 HttpResponse ==========
     
-    // 隐式转换
-    operator HttpResponse() const {
+    // 隐式转换（右值时移出响应体和头部，不复制）
+    operator HttpResponse() const & {
         return response_;
     }
     
+    operator HttpResponse() && {
+        return std::move(response_);
+    }
+    
     // 显式转换
-    HttpResponse toHttpResponse() const {
+    HttpResponse toHttpResponse() const & {
         return response_;
     }
     
+    HttpResponse toHttpResponse() && {
+        return std::move(response_);
+    }
+    
     // ========== 访问器 ==========
     
     int status() const { return response_.status_code; }
     const std::string& body() const { return response_.body; }
-    const std::map<std::string, std::string>& headers() const { return response_.headers; }
+    const ResponseHeaders& headers() const { return response_.headers; }
     
     // ========== 修改器（仅用于高级场景） ==========
     
@@ -3372,8 +5460,13 @@ public:
         return *this;
     }
     
+    Response& setBody(std::string&& body) {
+        response_.body = std::move(body);
+        return *this;
+    }
+    
     Response& setHeader(const std::string& key, const std::string& value) {
-        response_.headers[key] = value;
+        response_.headers.set(key, value);
         return *this;
     }
 };
@@ -3414,7 +5507,29 @@ private:
     int status_code_;
     std::string message_;
     std::map<std::string, std::string> headers_;
-    mutable std::string pending_data_;  // 待序列化的数据
+    mutable std::string pending_data_;  // 已编码的 data 字段 JSON
+    
+    // 类型是否自带 toJson() 成员（优先于 Schema 序列化）
+    template<typename T>
+    struct has_to_json {
+        template<typename U>
+        static auto test(int) -> decltype(std::declval<const U&>().toJson(), std::true_type());
+        template<typename U>
+        static std::false_type test(...);
+        static const bool value = decltype(test<T>(0))::value;
+    };
+    
+    // 类型是否声明了 Body Schema（schema() 方法或 UVAPI_SCHEMA）
+    template<typename T>
+    struct has_body_schema {
+        template<typename U>
+        static auto test(int) -> typename std::is_convertible<
+            decltype(std::declval<const U&>().schema()), BodySchemaBase*>::type;
+        template<typename U>
+        static std::false_type test(...);
+        static const bool value = (decltype(test<T>(0))::value || schema::HasStaticSchema<T>::value) &&
+                                  !has_to_json<T>::value;
+    };
     
 public:
     ResponseBuilder(int code = 200, const std::string& msg = "Success")
@@ -3574,11 +5689,13 @@ public:
     >::type {
         // 错误处理
         try {
-            JSON::Array arr;
+            pending_data_.clear();
+            json::Writer writer(pending_data_);
+            writer.beginArray();
             for (const auto& instance : instances) {
-                arr.append(instance.toJson());
+                writer.raw(instance.toJson());
             }
-            pending_data_ = arr.toString();
+            writer.endArray();
         } catch (...) {
             status_code_ = 500;
             message_ = "Serialization error";
@@ -3587,6 +5704,26 @@ public:
         return *this;
     }
     
+    // 描述 Schema 对象数据（按字段表直接序列化）
+    template<typename T>
+    auto data(const T& instance) -> typename std::enable_if<
+        has_body_schema<T>::value, ResponseBuilder&
+    >::type {
+        pending_data_.clear();
+        appendJson(instance, pending_data_);
+        return *this;
+    }
+    
+    // 描述 Schema 对象列表（所有元素写入同一个缓冲区）
+    template<typename T>
+    auto data(const std::vector<T>& instances) -> typename std::enable_if<
+        has_body_schema<T>::value, ResponseBuilder&
+    >::type {
+        pending_data_.clear();
+        appendJson(instances, pending_data_);
+        return *this;
+    }
+    
     // 描述字符串数据
     ResponseBuilder& data(const std::string& json_data) {
         pending_data_ = json_data;
@@ -3595,23 +5732,37 @@ public:
     
     // ========== 构建 Response 对象 ==========
     
+    // 私有方法：构建响应体 {"code":"...","message":"...","data":...}，data 按原样嵌入
+    void writeBody(std::string& body, const std::string* data_str) const {
+        body.clear();
+        body.reserve(48 + message_.size() + (data_str ? data_str->size() : 0));
+        json::Writer writer(body);
+        writer.beginObject();
+        writer.key("code", 4);
+        writer.string(std::to_string(status_code_));
+        writer.key("message", 7);
+        writer.string(message_);
+        if (data_str) {
+            writer.key("data", 4);
+            writer.raw(*data_str);
+        }
+        writer.endObject();
+    }
+    
     // 私有方法：构建带数据的 Response（消除代码冗余）
     Response buildWithData(const std::string& data_str) const {
         Response resp;
         resp.response_.status_code = status_code_;
         
         // 构建响应体
-        resp.response_.body = JSON::Object()
-            .set("code", std::to_string(status_code_))
-            .set("message", message_)
-            .set("data", data_str)
-            .toString();
+        writeBody(resp.response_.body, &data_str);
         
         // 设置头部
-        resp.response_.headers["Content-Type"] = "application/json";
+        resp.response_.headers.reserve(headers_.size() + 1);
+        resp.response_.headers.set(header::CONTENT_TYPE, "application/json");
         for (const auto& h : headers_) {
             if (h.first != "Content-Type") {
-                resp.response_.headers[h.first] = h.second;
+                resp.response_.headers.set(h.first, h.second);
             }
         }
         
@@ -3626,12 +5777,10 @@ public:
         // 构建基础响应
         Response resp;
         resp.response_.status_code = status_code_;
-        resp.response_.body = JSON::Object()
-            .set("code", std::to_string(status_code_))
-            .set("message", message_)
-            .toString();
+        writeBody(resp.response_.body, nullptr);
+        resp.response_.headers.reserve(headers_.size());
         for (const auto& h : headers_) {
-            resp.response_.headers[h.first] = h.second;
+            resp.response_.headers.set(h.first, h.second);
         }
         return resp;
     }
@@ -145,7 +145,7 @@ public:
         if (!root_) return "{}";
         char* json = cJSON_Print(root_);
         std::string result(json ? json : "{}");
-        if (json) free(json);
+        if (json) cJSON_free(json);
         return result;
     }
     
@@ -390,7 +390,7 @@ public:
             char* json = cJSON_Print(root);
             if (json) {
                 response.body = json;
-                free(json);
+                cJSON_free(json);
             }
             cJSON_Delete(root);
         }
@@ -27,9 +27,8 @@ namespace validators {
  * @return 验证结果
  */
 inline ValidationResult validateEmail(const std::string& email) {
-    // 简化的邮箱验证正则表达式
-    static const std::regex email_regex(R"(^[a-zA-Z0-9._%+-]+@[a-zA-Z0-9.-]+\.[a-zA-Z]{2,}$)");
-    if (!std::regex_match(email, email_regex)) {
+    // 简化的邮箱格式：^[a-zA-Z0-9._%+-]+@[a-zA-Z0-9.-]+\.[a-zA-Z]{2,}$（手写匹配器）
+    if (!fastmatch::isEmail(email.data(), email.size())) {
         return ValidationResult("Invalid email format");
     }
     return ValidationResult::ok();
@@ -56,29 +55,36 @@ inline ValidationResult validateUrl(const std::string& url) {
  */
 inline ValidationResult validateUuid(const std::string& uuid) {
     // UUID 格式验证（8-4-4-4-12 格式）
-    static const std::regex uuid_regex(R"(^[0-9a-fA-F]{8}-[0-9a-fA-F]{4}-[0-9a-fA-F]{4}-[0-9a-fA-F]{4}-[0-9a-fA-F]{12}$)");
-    if (!std::regex_match(uuid, uuid_regex)) {
+    if (!fastmatch::isUuid(uuid.data(), uuid.size())) {
         return ValidationResult("Invalid UUID format");
     }
     return ValidationResult::ok();
 }
 
+/**
+ * @brief 验证 IPv4 地址格式
+ * @param ip 点分十进制地址
+ * @return 验证结果
+ */
+inline ValidationResult validateIpv4(const std::string& ip) {
+    if (!fastmatch::isIpv4(ip.data(), ip.size())) {
+        return ValidationResult("Invalid IPv4 address");
+    }
+    return ValidationResult::ok();
+}
+
 /**
  * @brief 验证日期格式 (YYYY-MM-DD)
  * @param date 日期字符串
  * @return 验证结果
  */
 inline ValidationResult validateDate(const std::string& date) {
-    static const std::regex date_regex(R"(^\d{4}-\d{2}-\d{2}$)");
-    if (!std::regex_match(date, date_regex)) {
+    if (!fastmatch::hasDateShape(date.data(), date.size())) {
         return ValidationResult("Invalid date format, expected YYYY-MM-DD");
     }
     
-    // 验证日期是否有效
-    std::tm tm = {};
-    std::istringstream ss(date);
-    ss >> std::get_time(&tm, "%Y-%m-%d");
-    if (ss.fail()) {
+    // 验证日期是否有效（月份、当月天数、闰年）
+    if (!fastmatch::isDate(date.data(), date.size())) {
         return ValidationResult("Invalid date value");
     }
     
@@ -91,16 +97,12 @@ inline ValidationResult validateDate(const std::string& date) {
  * @return 验证结果
  */
 inline ValidationResult validateDatetime(const std::string& datetime) {
-    static const std::regex datetime_regex(R"(^\d{4}-\d{2}-\d{2} \d{2}:\d{2}:\d{2}$)");
-    if (!std::regex_match(datetime, datetime_regex)) {
+    if (!fastmatch::hasDatetimeShape(datetime.data(), datetime.size())) {
         return ValidationResult("Invalid datetime format, expected YYYY-MM-DD HH:MM:SS");
     }
     
     // 验证日期时间是否有效
-    std::tm tm = {};
-    std::istringstream ss(datetime);
-    ss >> std::get_time(&tm, "%Y-%m-%d %H:%M:%S");
-    if (ss.fail()) {
+    if (!fastmatch::isDatetime(datetime.data(), datetime.size())) {
         return ValidationResult("Invalid datetime value");
     }
     
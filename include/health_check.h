@@ -2,17 +2,43 @@
  * @file health_check.h
  * @brief 健康检查功能
  * 
- * 提供健康检查端点，用于生产环境监控
+ * 提供健康检查端点，用于生产环境监控：
+ * - 每个检查器有独立的执行间隔和超时；到期的检查由调度方（Server 的 libuv 定时器）
+ *   提交到 offload 线程池并行执行，不在请求路径上运行
+ * - 每次有检查完成或超时，重新渲染汇总结果并以原子指针交换发布；
+ *   /health 与 /ready 只读取最近一次预渲染的响应体
+ * - 超时的检查立即记为 unhealthy，但不会被中断；在它返回之前不会再次提交，
+ *   挂起的探测不会在线程池中堆积
+ *
+ * @code
+ * auto health = std::make_shared<uvapi::health::HealthCheckManager>();
+ * health->addChecker(uvapi::health::diskChecker("/data"));
+ * health->addChecker(uvapi::health::HealthChecker("db", pingDatabase)
+ *                        .interval(std::chrono::seconds(5))
+ *                        .timeout(std::chrono::milliseconds(500)));
+ * api.healthChecks(health);  // GET /health 与 GET /ready
+ * @endcode
  */
 
 #ifndef HEALTH_CHECK_H
 #define HEALTH_CHECK_H
 
+#include "string_builder.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <string>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
 #include <functional>
 #include <chrono>
 #include <ctime>
+#include <fstream>
+#include <unistd.h>
+#include <sys/statvfs.h>
 
 namespace uvapi {
 namespace health {
@@ -40,7 +66,14 @@ struct HealthCheckResult {
         , timestamp(std::chrono::system_clock::now()) {}
     
     std::string toJson() const {
-        std::string status_str;
+        StringBuilder json(128 + message.size());
+        appendJson(json);
+        return json.release();
+    }
+    
+    // 追加到调用方的缓冲区（消息和详情按 JSON 转义）
+    void appendJson(StringBuilder& json) const {
+        const char* status_str = "healthy";
         switch (status) {
             case HealthStatus::HEALTHY: status_str = "healthy"; break;
             case HealthStatus::UNHEALTHY: status_str = "unhealthy"; break;
@@ -51,21 +84,20 @@ struct HealthCheckResult {
         char time_buf[64];
         std::strftime(time_buf, sizeof(time_buf), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&ts));
         
-        std::string json = "{";
-        json += "\"status\":\"" + status_str + "\",";
-        json += "\"message\":\"" + message + "\",";
-        json += "\"timestamp\":\"" + std::string(time_buf) + "\",";
-        json += "\"details\":{";
+        json << "{\"status\":\"" << status_str << "\",\"message\":";
+        json.appendQuoted(message);
+        json << ",\"timestamp\":\"" << time_buf << "\",\"details\":{";
         
         bool first = true;
-        for (const auto& [key, value] : details) {
-            if (!first) json += ",";
-            json += "\"" + key + "\":\"" + value + "\"";
+        for (std::map<std::string, std::string>::const_iterator it = details.begin(); it != details.end(); ++it) {
+            if (!first) json << ',';
+            json.appendQuoted(it->first);
+            json << ':';
+            json.appendQuoted(it->second);
             first = false;
         }
         
-        json += "}}";
-        return json;
+        json << "}}";
     }
 };
 
@@ -76,15 +108,31 @@ using HealthCheckFunction = std::function<HealthCheckResult()>;
 
 /**
  * @brief 健康检查器
+ *
+ * 检查函数在线程池中执行，不能访问事件循环；同一检查器不会并发执行。
  */
 class HealthChecker {
 private:
     std::string name_;
     HealthCheckFunction check_function_;
+    std::chrono::milliseconds interval_;
+    std::chrono::milliseconds timeout_;
     
 public:
     HealthChecker(const std::string& name, HealthCheckFunction func)
-        : name_(name), check_function_(func) {}
+        : name_(name), check_function_(func), interval_(10000), timeout_(2000) {}
+    
+    // 两次执行的间隔（从上一次开始执行算起），默认 10 秒，至少 10ms
+    HealthChecker& interval(std::chrono::milliseconds value) {
+        interval_ = value.count() < 10 ? std::chrono::milliseconds(10) : value;
+        return *this;
+    }
+    
+    // 超过该时间未返回即记为 unhealthy，默认 2 秒，至少 1ms
+    HealthChecker& timeout(std::chrono::milliseconds value) {
+        timeout_ = value.count() < 1 ? std::chrono::milliseconds(1) : value;
+        return *this;
+    }
     
     HealthCheckResult check() const {
         if (check_function_) {
@@ -97,55 +145,247 @@ public:
     }
     
     const std::string& name() const { return name_; }
+    std::chrono::milliseconds interval() const { return interval_; }
+    std::chrono::milliseconds timeout() const { return timeout_; }
+};
+
+/**
+ * @brief 预渲染的健康检查响应
+ *
+ * 发布后不再修改，请求线程只读取。
+ */
+struct HealthSnapshot {
+    HealthStatus status;      // 所有已完成检查的汇总
+    bool ready;               // 每个检查都至少完成过一次且汇总不是 unhealthy
+    std::string health_body;  // {"status":...,"checks":{...}}
+    std::string ready_body;   // {"status":"ready"} 或 {"status":"not_ready"}
+    
+    HealthSnapshot() : status(HealthStatus::HEALTHY), ready(false) {}
+    
+    int healthCode() const { return status == HealthStatus::UNHEALTHY ? 503 : 200; }
+    int readyCode() const { return ready ? 200 : 503; }
 };
 
 /**
  * @brief 健康检查管理器
+ *
+ * 调度方按 tickInterval() 周期调用 tick()，把到期的检查提交到线程池，
+ * 池线程调用 runCheck() 执行并发布新的汇总；latest() 可在任意线程调用。
+ * 多核模式下各工作线程的定时器共用同一个管理器，到期的检查只会被其中一个提交。
  */
 class HealthCheckManager {
 private:
-    std::vector<HealthChecker> checkers_;
+    struct Slot {
+        HealthChecker checker;
+        HealthCheckResult result;
+        bool reported;   // 至少完成（或超时）过一次
+        bool running;    // 已提交，尚未返回
+        bool timed_out;  // 本次执行已记为超时
+        uint64_t next_due_ms;
+        uint64_t started_ms;
+        
+        explicit Slot(const HealthChecker& c)
+            : checker(c), reported(false), running(false), timed_out(false), next_due_ms(0), started_ms(0) {}
+    };
+    
+    std::vector<Slot> slots_;      // 按名称排序，与 checkAll() 的输出顺序一致
+    mutable std::mutex mutex_;
+    std::shared_ptr<const HealthSnapshot> latest_;  // 通过 std::atomic_load / atomic_store 访问
     
 public:
-    HealthCheckManager() {}
+    HealthCheckManager() : latest_(std::make_shared<HealthSnapshot>()) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        publish();
+    }
     
-    // 添加健康检查器
+    HealthCheckManager(const HealthCheckManager&) = delete;
+    HealthCheckManager& operator=(const HealthCheckManager&) = delete;
+    
+    // 添加健康检查器；同名的检查器被替换。应在开始调度之前添加
     void addChecker(const HealthChecker& checker) {
-        checkers_.push_back(checker);
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<Slot>::iterator it = slots_.begin();
+        while (it != slots_.end() && it->checker.name() < checker.name()) {
+            ++it;
+        }
+        if (it != slots_.end() && it->checker.name() == checker.name()) {
+            *it = Slot(checker);
+        } else {
+            slots_.insert(it, Slot(checker));
+        }
+        publish();
     }
     
-    // 执行所有健康检查
-    std::string checkAll() const {
-        std::map<std::string, HealthCheckResult> results;
-        HealthStatus overall_status = HealthStatus::HEALTHY;
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return slots_.size();
+    }
+    
+    // 最近一次发布的结果（不为空）
+    std::shared_ptr<const HealthSnapshot> latest() const {
+        return std::atomic_load(&latest_);
+    }
+    
+    // 调度定时器的周期：各检查间隔和超时中的最小值，介于 10ms 和 1s 之间
+    std::chrono::milliseconds tickInterval() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        int64_t tick = 1000;
+        for (size_t i = 0; i < slots_.size(); i++) {
+            tick = std::min<int64_t>(tick, slots_[i].checker.interval().count());
+            tick = std::min<int64_t>(tick, slots_[i].checker.timeout().count());
+        }
+        return std::chrono::milliseconds(tick < 10 ? 10 : tick);
+    }
+    
+    /**
+     * @brief 处理到期的检查和超时
+     *
+     * 对每个到期且未在执行的检查调用 submit(index)，submit 负责让某个线程随后调用
+     * runCheck(index)；返回 false（例如线程池排队已满）时下一次 tick 重试。
+     * submit 在锁外调用。
+     * @return 提交的检查数
+     */
+    template<typename Submit>
+    size_t tick(uint64_t now_ms, Submit submit) {
+        std::vector<size_t> due;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            bool changed = false;
+            for (size_t i = 0; i < slots_.size(); i++) {
+                Slot& slot = slots_[i];
+                if (slot.running) {
+                    uint64_t timeout_ms = static_cast<uint64_t>(slot.checker.timeout().count());
+                    if (!slot.timed_out && now_ms - slot.started_ms >= timeout_ms) {
+                        slot.timed_out = true;
+                        slot.reported = true;
+                        slot.result = HealthCheckResult();
+                        slot.result.status = HealthStatus::UNHEALTHY;
+                        slot.result.message = "Check timed out after " + std::to_string(timeout_ms) + " ms";
+                        changed = true;
+                    }
+                    continue;
+                }
+                if (now_ms >= slot.next_due_ms) {
+                    slot.running = true;
+                    slot.timed_out = false;
+                    slot.started_ms = now_ms;
+                    slot.next_due_ms = now_ms + static_cast<uint64_t>(slot.checker.interval().count());
+                    due.push_back(i);
+                }
+            }
+            if (changed) {
+                publish();
+            }
+        }
         
-        for (const auto& checker : checkers_) {
-            HealthCheckResult result = checker.check();
-            results[checker.name()] = result;
-            
-            if (result.status == HealthStatus::UNHEALTHY) {
-                overall_status = HealthStatus::UNHEALTHY;
-            } else if (result.status == HealthStatus::DEGRADED && overall_status == HealthStatus::HEALTHY) {
-                overall_status = HealthStatus::DEGRADED;
+        size_t submitted = 0;
+        for (size_t i = 0; i < due.size(); i++) {
+            if (submit(due[i])) {
+                submitted++;
+                continue;
             }
+            std::lock_guard<std::mutex> lock(mutex_);
+            slots_[due[i]].running = false;
+            slots_[due[i]].next_due_ms = 0;
         }
+        return submitted;
+    }
+    
+    /**
+     * @brief 执行第 index 个检查并发布结果（由 tick() 的 submit 安排，在池线程中调用）
+     *
+     * 已超时的检查返回后仍写入实际结果，作为最新状态。
+     */
+    void runCheck(size_t index) {
+        std::unique_ptr<HealthChecker> checker;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (index >= slots_.size()) {
+                return;
+            }
+            checker.reset(new HealthChecker(slots_[index].checker));
+        }
+        // 锁外执行探测，慢检查不阻塞其他检查的发布和 tick()
+        HealthCheckResult result = checker->check();
         
-        std::string json = "{";
-        json += "\"status\":\"" + statusToString(overall_status) + "\",";
-        json += "\"checks\":{";
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (index >= slots_.size() || slots_[index].checker.name() != checker->name()) {
+            return;
+        }
+        Slot& slot = slots_[index];
+        slot.result = std::move(result);
+        slot.reported = true;
+        slot.running = false;
+        slot.timed_out = false;
+        publish();
+    }
+    
+    // 同步串行执行所有健康检查（不经过调度，也不发布），用于测试或命令行诊断
+    std::string checkAll() const {
+        std::vector<HealthChecker> checkers;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            checkers.reserve(slots_.size());
+            for (size_t i = 0; i < slots_.size(); i++) {
+                checkers.push_back(slots_[i].checker);
+            }
+        }
         
-        bool first = true;
-        for (const auto& [name, result] : results) {
-            if (!first) json += ",";
-            json += "\"" + name + "\":" + result.toJson();
-            first = false;
+        HealthStatus overall_status = HealthStatus::HEALTHY;
+        StringBuilder json(64 + checkers.size() * 192);
+        StringBuilder checks(checkers.size() * 192);
+        for (size_t i = 0; i < checkers.size(); i++) {
+            HealthCheckResult result = checkers[i].check();
+            overall_status = combine(overall_status, result.status);
+            if (i > 0) checks << ',';
+            checks.appendQuoted(checkers[i].name());
+            checks << ':';
+            result.appendJson(checks);
         }
         
-        json += "}}";
-        return json;
+        json << "{\"status\":\"" << statusToString(overall_status) << "\",\"checks\":{" << checks.str() << "}}";
+        return json.release();
     }
     
 private:
+    // 重新渲染并发布汇总结果（调用方持有 mutex_）
+    void publish() {
+        std::shared_ptr<HealthSnapshot> snapshot = std::make_shared<HealthSnapshot>();
+        bool all_reported = true;
+        
+        StringBuilder checks(slots_.size() * 192);
+        for (size_t i = 0; i < slots_.size(); i++) {
+            const Slot& slot = slots_[i];
+            if (i > 0) checks << ',';
+            checks.appendQuoted(slot.checker.name());
+            checks << ':';
+            if (slot.reported) {
+                snapshot->status = combine(snapshot->status, slot.result.status);
+                slot.result.appendJson(checks);
+            } else {
+                all_reported = false;
+                checks << "{\"status\":\"pending\",\"message\":\"Check has not completed yet\"}";
+            }
+        }
+        
+        StringBuilder json(64 + checks.size());
+        json << "{\"status\":\"" << statusToString(snapshot->status) << "\",\"checks\":{" << checks.str() << "}}";
+        snapshot->health_body = json.release();
+        snapshot->ready = all_reported && snapshot->status != HealthStatus::UNHEALTHY;
+        snapshot->ready_body = snapshot->ready ? "{\"status\":\"ready\"}" : "{\"status\":\"not_ready\"}";
+        std::atomic_store(&latest_, std::shared_ptr<const HealthSnapshot>(snapshot));
+    }
+    
+    static HealthStatus combine(HealthStatus overall, HealthStatus status) {
+        if (status == HealthStatus::UNHEALTHY) {
+            return HealthStatus::UNHEALTHY;
+        }
+        if (status == HealthStatus::DEGRADED && overall == HealthStatus::HEALTHY) {
+            return HealthStatus::DEGRADED;
+        }
+        return overall;
+    }
+    
     static std::string statusToString(HealthStatus status) {
         switch (status) {
             case HealthStatus::HEALTHY: return "healthy";
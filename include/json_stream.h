@@ -0,0 +1,606 @@
+/**
+ * @file json_stream.h
+ * @brief 流式 JSON 读取器：单次扫描，不构造 DOM
+ *
+ * 读取器按调用方的需要逐个消费 JSON 值（拉取式），用于由 Schema 字段表
+ * 驱动的反序列化：
+ * - 对象键在没有转义时直接返回指向输入缓冲区的切片，不分配内存
+ * - 字符串值解码到调用方提供的 std::string（通常就是目标字段本身）
+ * - int64 范围内的整数精确解析，浮点数优先使用 Clinger 快速路径
+ * - 不关心的值用 skipValue() 跳过，同样会检查语法
+ * - 第一个错误即停止，错误信息和偏移量可通过 error()/offset() 获取
+ *
+ * @code
+ * uvapi::json::Reader reader(body.data(), body.size());
+ * uvapi::StringSlice key;
+ * if (reader.beginObject()) {
+ *     while (reader.nextMember(key)) {
+ *         if (key.equals("name", 4)) reader.readString(name);
+ *         else reader.skipValue();
+ *     }
+ * }
+ * bool ok = reader.finish();
+ * @endcode
+ */
+
+#ifndef UVAPI_JSON_STREAM_H
+#define UVAPI_JSON_STREAM_H
+
+#include "request_view.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+namespace uvapi {
+namespace json {
+
+// 数值读取结果
+struct Number {
+    bool is_integer;   // 无小数和指数部分，且能用 int64 精确表示
+    bool is_unsigned;  // 无小数和指数部分的非负数，且能用 uint64 精确表示
+    int64_t integer;
+    uint64_t uinteger;
+    double value;      // 总是有效（整数也会换算为 double）
+
+    Number() : is_integer(false), is_unsigned(false), integer(0), uinteger(0), value(0.0) {}
+};
+
+class Reader {
+public:
+    static const int kMaxDepth = 64;
+
+    Reader(const char* data, size_t size)
+        : begin_(data), cur_(data), end_(data + size), error_(nullptr), depth_(0), first_member_(true),
+          has_escape_(false) {}
+
+    bool failed() const { return error_ != nullptr; }
+    const char* error() const { return error_ ? error_ : ""; }
+    size_t offset() const { return static_cast<size_t>(cur_ - begin_); }
+
+    // 错误描述，如 "Expected ':' after key at offset 12"
+    std::string describeError() const {
+        return std::string(error()) + " at offset " + std::to_string(offset());
+    }
+
+    // 返回下一个非空白字符，输入结束时返回 '\0'
+    char peek() {
+        skipWhitespace();
+        return cur_ < end_ ? *cur_ : '\0';
+    }
+
+    // ========== 对象 ==========
+
+    bool beginObject() {
+        if (!expect('{', "Expected object")) {
+            return false;
+        }
+        first_member_ = true;
+        return enter();
+    }
+
+    /**
+     * @brief 读取下一个成员的键并消费 ':'
+     * @param key 输出键；无转义时指向输入缓冲区，否则指向内部暂存区（下次调用前有效）
+     * @return 读到成员返回 true；遇到 '}' 或出错返回 false（用 failed() 区分）
+     */
+    bool nextMember(StringSlice& key) {
+        if (failed()) {
+            return false;
+        }
+        char c = peek();
+        if (c == '}') {
+            ++cur_;
+            --depth_;
+            first_member_ = false;
+            return false;
+        }
+        if (!first_member_ && !expect(',', "Expected ',' or '}' in object")) {
+            return false;
+        }
+        first_member_ = false;
+        if (peek() != '"') {
+            return fail("Expected string key");
+        }
+        if (!readStringSlice(key, key_scratch_)) {
+            return false;
+        }
+        return expect(':', "Expected ':' after key");
+    }
+
+    // ========== 标量 ==========
+
+    // 读取字符串并解码转义（含 \uXXXX 代理对），结果写入 out
+    bool readString(std::string& out) {
+        if (peek() != '"') {
+            return fail("Expected string");
+        }
+        StringSlice slice;
+        if (!scanString(slice)) {
+            return false;
+        }
+        if (!has_escape_) {
+            out.assign(slice.data, slice.size);
+            return true;
+        }
+        out.clear();
+        return decodeString(slice, out);
+    }
+
+    bool readNumber(Number& out) {
+        skipWhitespace();
+        const char* start = cur_;
+        bool negative = false;
+        if (cur_ < end_ && *cur_ == '-') {
+            negative = true;
+            ++cur_;
+        }
+        if (cur_ >= end_ || !isDigit(*cur_)) {
+            return fail("Expected number");
+        }
+
+        // 整数部分：不允许前导零。尾数累加到 uint64 上限为止，其余记为截断
+        uint64_t mantissa = 0;
+        int digits = 0;
+        int exponent = 0;
+        bool truncated = false;
+        if (*cur_ == '0') {
+            ++cur_;
+        } else {
+            while (cur_ < end_ && isDigit(*cur_)) {
+                // 连续 8 位数字一次换算；mantissa < 1e11 时结果不超过 1e19，不会溢出
+                uint32_t eight = 0;
+                if (mantissa < 100000000000ULL && end_ - cur_ >= 8 && parseEightDigits(cur_, eight)) {
+                    mantissa = mantissa * 100000000ULL + eight;
+                    digits += 8;
+                    cur_ += 8;
+                    continue;
+                }
+                uint64_t d = static_cast<uint64_t>(*cur_ - '0');
+                if (!truncated && mantissa <= (UINT64_MAX - d) / 10) {
+                    mantissa = mantissa * 10 + d;
+                    ++digits;
+                } else {
+                    ++exponent;
+                    truncated = true;
+                }
+                ++cur_;
+            }
+        }
+
+        bool integral = true;
+        if (cur_ < end_ && *cur_ == '.') {
+            integral = false;
+            ++cur_;
+            if (cur_ >= end_ || !isDigit(*cur_)) {
+                return fail("Expected digit after '.'");
+            }
+            while (cur_ < end_ && isDigit(*cur_)) {
+                if (!truncated && digits < 19) {
+                    mantissa = mantissa * 10 + static_cast<uint64_t>(*cur_ - '0');
+                    if (mantissa != 0) {
+                        ++digits;  // 前导零不占有效位
+                    }
+                    --exponent;
+                } else {
+                    truncated = true;
+                }
+                ++cur_;
+            }
+        }
+        if (cur_ < end_ && (*cur_ == 'e' || *cur_ == 'E')) {
+            integral = false;
+            ++cur_;
+            bool exp_negative = false;
+            if (cur_ < end_ && (*cur_ == '+' || *cur_ == '-')) {
+                exp_negative = *cur_ == '-';
+                ++cur_;
+            }
+            if (cur_ >= end_ || !isDigit(*cur_)) {
+                return fail("Expected digit in exponent");
+            }
+            int exp_value = 0;
+            while (cur_ < end_ && isDigit(*cur_)) {
+                if (exp_value < 100000) {
+                    exp_value = exp_value * 10 + (*cur_ - '0');
+                }
+                ++cur_;
+            }
+            exponent += exp_negative ? -exp_value : exp_value;
+        }
+
+        out.is_integer = false;
+        out.integer = 0;
+        out.is_unsigned = integral && !truncated && !negative;
+        out.uinteger = out.is_unsigned ? mantissa : 0;
+        if (integral && !truncated) {
+            uint64_t limit = static_cast<uint64_t>(INT64_MAX) + (negative ? 1 : 0);
+            if (mantissa <= limit) {
+                out.is_integer = true;
+                out.integer = negative ? static_cast<int64_t>(0 - mantissa) : static_cast<int64_t>(mantissa);
+                out.value = static_cast<double>(out.integer);
+                return true;
+            }
+        }
+
+        // Clinger 快速路径：尾数和 10 的幂都能精确表示为 double 时，一次乘除即为正确舍入
+        static const double kPow10[] = {
+            1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+        };
+        if (!truncated && mantissa <= (static_cast<uint64_t>(1) << 53) && exponent >= -22 && exponent <= 22) {
+            double v = static_cast<double>(mantissa);
+            v = exponent < 0 ? v / kPow10[-exponent] : v * kPow10[exponent];
+            out.value = negative ? -v : v;
+            return true;
+        }
+
+        // 其余情况交给 strtod（先复制到以 '\0' 结尾的缓冲区）
+        size_t len = static_cast<size_t>(cur_ - start);
+        char stack_buf[64];
+        std::string heap_buf;
+        const char* num = stack_buf;
+        if (len < sizeof(stack_buf)) {
+            std::memcpy(stack_buf, start, len);
+            stack_buf[len] = '\0';
+        } else {
+            heap_buf.assign(start, len);
+            num = heap_buf.c_str();
+        }
+        out.value = std::strtod(num, nullptr);
+        return true;
+    }
+
+    bool readBool(bool& out) {
+        char c = peek();
+        if (c == 't' && literal("true", 4)) {
+            out = true;
+            return true;
+        }
+        if (c == 'f' && literal("false", 5)) {
+            out = false;
+            return true;
+        }
+        return fail("Expected boolean");
+    }
+
+    // 值为 null 时消费并返回 true，否则不移动位置
+    bool readNull() {
+        return peek() == 'n' && literal("null", 4);
+    }
+
+    // ========== 跳过 ==========
+
+    /**
+     * @brief 跳过一个完整的值（含嵌套对象和数组），同时检查语法
+     * @param raw 可选，输出该值在输入中的原始切片
+     */
+    bool skipValue(StringSlice* raw = nullptr) {
+        char c = peek();
+        const char* start = cur_;
+        bool ok = false;
+        switch (c) {
+            case '{': {
+                StringSlice key;
+                ok = beginObject();
+                while (ok && nextMember(key)) {
+                    ok = skipValue();
+                }
+                ok = ok && !failed();
+                break;
+            }
+            case '[': {
+                ok = beginArray();
+                while (ok && nextElement()) {
+                    ok = skipValue();
+                }
+                ok = ok && !failed();
+                break;
+            }
+            case '"': {
+                StringSlice slice;
+                ok = scanString(slice);
+                break;
+            }
+            case 't':
+            case 'f': {
+                bool b = false;
+                ok = readBool(b);
+                break;
+            }
+            case 'n':
+                ok = readNull() || fail("Expected value");
+                break;
+            default: {
+                Number n;
+                ok = readNumber(n);
+                break;
+            }
+        }
+        if (ok && raw) {
+            *raw = StringSlice(start, static_cast<size_t>(cur_ - start));
+        }
+        return ok;
+    }
+
+    // ========== 数组 ==========
+
+    bool beginArray() {
+        if (!expect('[', "Expected array")) {
+            return false;
+        }
+        first_member_ = true;
+        return enter();
+    }
+
+    // 定位到下一个数组元素；遇到 ']' 或出错返回 false
+    bool nextElement() {
+        if (failed()) {
+            return false;
+        }
+        char c = peek();
+        if (c == ']') {
+            ++cur_;
+            --depth_;
+            first_member_ = false;
+            return false;
+        }
+        if (!first_member_ && !expect(',', "Expected ',' or ']' in array")) {
+            return false;
+        }
+        first_member_ = false;
+        return true;
+    }
+
+    /**
+     * @brief 预数当前数组的元素个数（在 beginArray() 之后调用，不移动位置）
+     *
+     * 只适用于元素是数字、布尔或 null 的扁平数组：遇到字符串或嵌套容器时返回 0，
+     * 调用方按未知处理。结果只用于 reserve()，语法仍由逐个读取时检查。
+     */
+    size_t countFlatElements() const {
+        size_t commas = 0;
+        bool any = false;
+        for (const char* p = cur_; p < end_; ++p) {
+            char c = *p;
+            if (c == ']') {
+                return any ? commas + 1 : 0;
+            }
+            if (c == '"' || c == '[' || c == '{') {
+                return 0;
+            }
+            commas += c == ',';
+            any = any || c > ' ';
+        }
+        return 0;
+    }
+
+    // 顶层值结束后只允许空白
+    bool finish() {
+        if (failed()) {
+            return false;
+        }
+        if (peek() != '\0' || cur_ != end_) {
+            return fail("Unexpected trailing characters");
+        }
+        return true;
+    }
+
+    // 记录错误并返回 false（第一个错误优先）
+    bool fail(const char* message) {
+        if (!error_) {
+            error_ = message;
+        }
+        return false;
+    }
+
+private:
+    const char* begin_;
+    const char* cur_;
+    const char* end_;
+    const char* error_;
+    int depth_;
+    bool first_member_;
+    bool has_escape_;
+    std::string key_scratch_;
+
+    static bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+    // 8 个字节都是十进制数字时换算为整数（SWAR：一次处理 8 字节，只用于小端序）
+    static bool parseEightDigits(const char* p, uint32_t& out) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        uint64_t chunk;
+        std::memcpy(&chunk, p, 8);
+        // 每个字节的高半字节为 3，且加 6 后不进位（即 '0'..'9'）
+        uint64_t high = chunk & 0xF0F0F0F0F0F0F0F0ULL;
+        uint64_t carry = ((chunk + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4;
+        if ((high | carry) != 0x3333333333333333ULL) {
+            return false;
+        }
+        chunk = ((chunk & 0x0F0F0F0F0F0F0F0FULL) * 2561) >> 8;
+        chunk = ((chunk & 0x00FF00FF00FF00FFULL) * 6553601) >> 16;
+        out = static_cast<uint32_t>(((chunk & 0x0000FFFF0000FFFFULL) * 42949672960001ULL) >> 32);
+        return true;
+#else
+        (void)p;
+        (void)out;
+        return false;
+#endif
+    }
+
+    void skipWhitespace() {
+        while (cur_ < end_ && (*cur_ == ' ' || *cur_ == '\n' || *cur_ == '\r' || *cur_ == '\t')) {
+            ++cur_;
+        }
+    }
+
+    bool expect(char c, const char* message) {
+        if (failed()) {
+            return false;
+        }
+        if (peek() != c) {
+            return fail(message);
+        }
+        ++cur_;
+        return true;
+    }
+
+    bool enter() {
+        if (++depth_ > kMaxDepth) {
+            return fail("Nesting too deep");
+        }
+        return true;
+    }
+
+    bool literal(const char* word, size_t n) {
+        if (static_cast<size_t>(end_ - cur_) < n || std::memcmp(cur_, word, n) != 0) {
+            return false;
+        }
+        cur_ += n;
+        return true;
+    }
+
+    // 扫描字符串（cur_ 指向 '"'），输出不含引号的原始内容，并记录是否含转义
+    bool scanString(StringSlice& raw) {
+        ++cur_;
+        const char* start = cur_;
+        has_escape_ = false;
+        while (cur_ < end_) {
+            unsigned char c = static_cast<unsigned char>(*cur_);
+            if (c == '"') {
+                raw = StringSlice(start, static_cast<size_t>(cur_ - start));
+                ++cur_;
+                return true;
+            }
+            if (c == '\\') {
+                has_escape_ = true;
+                ++cur_;
+                if (cur_ >= end_) {
+                    break;
+                }
+            } else if (c < 0x20) {
+                return fail("Control character in string");
+            }
+            ++cur_;
+        }
+        return fail("Unterminated string");
+    }
+
+    // 读取字符串为切片；有转义时解码到 scratch
+    bool readStringSlice(StringSlice& out, std::string& scratch) {
+        StringSlice raw;
+        if (!scanString(raw)) {
+            return false;
+        }
+        if (!has_escape_) {
+            out = raw;
+            return true;
+        }
+        scratch.clear();
+        if (!decodeString(raw, scratch)) {
+            return false;
+        }
+        out = StringSlice(scratch);
+        return true;
+    }
+
+    static int hexValue(char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+
+    static bool readHex4(const char* p, const char* end, uint32_t& out) {
+        if (end - p < 4) {
+            return false;
+        }
+        uint32_t v = 0;
+        for (int i = 0; i < 4; ++i) {
+            int h = hexValue(p[i]);
+            if (h < 0) {
+                return false;
+            }
+            v = (v << 4) | static_cast<uint32_t>(h);
+        }
+        out = v;
+        return true;
+    }
+
+    static void appendUtf8(std::string& out, uint32_t cp) {
+        if (cp < 0x80) {
+            out += static_cast<char>(cp);
+        } else if (cp < 0x800) {
+            out += static_cast<char>(0xC0 | (cp >> 6));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        } else if (cp < 0x10000) {
+            out += static_cast<char>(0xE0 | (cp >> 12));
+            out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        } else {
+            out += static_cast<char>(0xF0 | (cp >> 18));
+            out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        }
+    }
+
+    bool decodeString(const StringSlice& raw, std::string& out) {
+        const char* p = raw.data;
+        const char* end = raw.data + raw.size;
+        out.reserve(out.size() + raw.size);
+        while (p < end) {
+            // 批量复制不含转义的片段
+            const char* run = p;
+            while (p < end && *p != '\\') {
+                ++p;
+            }
+            out.append(run, static_cast<size_t>(p - run));
+            if (p >= end) {
+                break;
+            }
+            ++p;  // 跳过 '\\'
+            char esc = *p++;
+            switch (esc) {
+                case '"': out += '"'; break;
+                case '\\': out += '\\'; break;
+                case '/': out += '/'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'n': out += '\n'; break;
+                case 'r': out += '\r'; break;
+                case 't': out += '\t'; break;
+                case 'u': {
+                    uint32_t cp = 0;
+                    if (!readHex4(p, end, cp)) {
+                        return fail("Invalid \\u escape");
+                    }
+                    p += 4;
+                    if (cp >= 0xD800 && cp <= 0xDBFF) {
+                        uint32_t low = 0;
+                        if (end - p < 6 || p[0] != '\\' || p[1] != 'u' || !readHex4(p + 2, end, low) ||
+                            low < 0xDC00 || low > 0xDFFF) {
+                            return fail("Invalid surrogate pair");
+                        }
+                        p += 6;
+                        cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                    } else if (cp >= 0xDC00 && cp <= 0xDFFF) {
+                        return fail("Invalid surrogate pair");
+                    }
+                    appendUtf8(out, cp);
+                    break;
+                }
+                default:
+                    return fail("Invalid escape sequence");
+            }
+        }
+        return true;
+    }
+};
+
+} // namespace json
+} // namespace uvapi
+
+#endif // UVAPI_JSON_STREAM_H
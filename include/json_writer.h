@@ -0,0 +1,451 @@
+/**
+ * @file json_writer.h
+ * @brief 紧凑 JSON 写入器：直接追加到调用方的缓冲区
+ *
+ * 与 json_stream.h 的 Reader 对应，由 Schema 字段表驱动序列化：
+ * - 输出紧凑 JSON（无缩进和多余空白），不构造 cJSON 树
+ * - 整数使用两位查表格式化；浮点数整值走整数路径，
+ *   其余按 15/16/17 位有效数字依次尝试，取第一个能精确往返的最短表示
+ * - 字符串只对 '"'、'\\' 和控制字符转义，其余字节按原样成段复制；
+ *   查找需要转义的字节时一次检查 16 字节（SSE2）或 8 字节（其他平台），干净的 ASCII/UTF-8 整段跳过
+ * - 逗号由写入器根据嵌套层级自动插入
+ *
+ * 缓冲区由调用方持有，可在多次序列化之间复用（clear() 保留容量）。
+ * 需要缩进格式时用 appendPretty() 对紧凑结果重新排版。
+ *
+ * @code
+ * std::string buf;
+ * uvapi::json::Writer w(buf);
+ * w.beginObject();
+ * w.key("id");    w.integer(42);
+ * w.key("name");  w.string("alice");
+ * w.endObject();  // buf == {"id":42,"name":"alice"}
+ * @endcode
+ */
+
+#ifndef UVAPI_JSON_WRITER_H
+#define UVAPI_JSON_WRITER_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace uvapi {
+namespace json {
+
+// ========== 数值格式化 ==========
+
+/**
+ * @brief 无符号整数转十进制，写入 buf 末尾
+ * @param end 指向缓冲区末尾（至少 20 字节空间）
+ * @return 第一个数字的位置
+ */
+inline char* formatUnsigned(uint64_t value, char* end) {
+    static const char kDigits[] =
+        "00010203040506070809"
+        "10111213141516171819"
+        "20212223242526272829"
+        "30313233343536373839"
+        "40414243444546474849"
+        "50515253545556575859"
+        "60616263646566676869"
+        "70717273747576777879"
+        "80818283848586878889"
+        "90919293949596979899";
+    char* p = end;
+    while (value >= 100) {
+        unsigned idx = static_cast<unsigned>(value % 100) * 2;
+        value /= 100;
+        *--p = kDigits[idx + 1];
+        *--p = kDigits[idx];
+    }
+    if (value >= 10) {
+        unsigned idx = static_cast<unsigned>(value) * 2;
+        *--p = kDigits[idx + 1];
+        *--p = kDigits[idx];
+    } else {
+        *--p = static_cast<char>('0' + value);
+    }
+    return p;
+}
+
+inline void appendUnsigned(std::string& out, uint64_t value) {
+    char buf[24];
+    char* end = buf + sizeof(buf);
+    char* p = formatUnsigned(value, end);
+    out.append(p, static_cast<size_t>(end - p));
+}
+
+inline void appendInteger(std::string& out, int64_t value) {
+    char buf[24];
+    char* end = buf + sizeof(buf);
+    // 取绝对值时避免 INT64_MIN 溢出
+    uint64_t magnitude = value < 0 ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+    char* p = formatUnsigned(magnitude, end);
+    if (value < 0) {
+        *--p = '-';
+    }
+    out.append(p, static_cast<size_t>(end - p));
+}
+
+/**
+ * @brief 双精度浮点数的最短往返表示；NaN/Inf 不是合法 JSON，输出 null
+ */
+inline void appendDouble(std::string& out, double value) {
+    if (!std::isfinite(value)) {
+        out.append("null", 4);
+        return;
+    }
+    // 2^53 以内的整值：按整数输出（与 cJSON 行为一致，不带小数点）
+    if (value == std::floor(value) && std::fabs(value) < 9007199254740992.0) {
+        appendInteger(out, static_cast<int64_t>(value));
+        return;
+    }
+    char buf[32];
+    int len = 0;
+    for (int precision = 15; precision <= 17; ++precision) {
+        len = std::snprintf(buf, sizeof(buf), "%.*g", precision, value);
+        if (precision == 17 || std::strtod(buf, nullptr) == value) {
+            break;
+        }
+    }
+    out.append(buf, static_cast<size_t>(len));
+}
+
+/**
+ * @brief 单精度浮点数的最短往返表示（按 float 精度，避免 0.1f 输出为 0.100000001490116）
+ */
+inline void appendFloat(std::string& out, float value) {
+    if (!std::isfinite(value)) {
+        out.append("null", 4);
+        return;
+    }
+    if (value == std::floor(value) && std::fabs(value) < 16777216.0f) {
+        appendInteger(out, static_cast<int64_t>(value));
+        return;
+    }
+    char buf[32];
+    int len = 0;
+    for (int precision = 6; precision <= 9; ++precision) {
+        len = std::snprintf(buf, sizeof(buf), "%.*g", precision, static_cast<double>(value));
+        if (precision == 9 || std::strtof(buf, nullptr) == value) {
+            break;
+        }
+    }
+    out.append(buf, static_cast<size_t>(len));
+}
+
+// ========== 字符串转义 ==========
+
+inline bool needsEscape(unsigned char c) {
+    return c < 0x20 || c == '"' || c == '\\';
+}
+
+/**
+ * @brief 从 i 开始查找第一个需要转义的字节，没有时返回 n
+ */
+inline size_t findEscape(const char* s, size_t i, size_t n) {
+#if defined(__SSE2__)
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i control = _mm_set1_epi8(0x1F);
+    while (i + 16 <= n) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        // 无符号 c <= 0x1F 等价于 min(c, 0x1F) == c
+        __m128i hit = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+                                   _mm_cmpeq_epi8(_mm_min_epu8(chunk, control), chunk));
+        if (_mm_movemask_epi8(hit) != 0) {
+            break;
+        }
+        i += 16;
+    }
+#else
+    const uint64_t kOnes = 0x0101010101010101ULL;
+    const uint64_t kHigh = 0x8080808080808080ULL;
+    while (i + 8 <= n) {
+        uint64_t word;
+        std::memcpy(&word, s + i, 8);
+        uint64_t quote = word ^ (kOnes * '"');
+        uint64_t backslash = word ^ (kOnes * '\\');
+        // 某个字节为 0 / 小于 0x20 时对应的最高位被置位
+        uint64_t hit = ((quote - kOnes) & ~quote) | ((backslash - kOnes) & ~backslash) | ((word - kOnes * 0x20) & ~word);
+        if ((hit & kHigh) != 0) {
+            break;
+        }
+        i += 8;
+    }
+#endif
+    while (i < n && !needsEscape(static_cast<unsigned char>(s[i]))) {
+        ++i;
+    }
+    return i;
+}
+
+inline void appendEscaped(std::string& out, const char* s, size_t n) {
+    static const char kHex[] = "0123456789abcdef";
+    size_t run = 0;
+    for (size_t i = findEscape(s, 0, n); i < n; i = findEscape(s, run, n)) {
+        unsigned char c = static_cast<unsigned char>(s[i]);
+        // 先整段复制无需转义的字节
+        out.append(s + run, i - run);
+        run = i + 1;
+        switch (c) {
+            case '"': out.append("\\\"", 2); break;
+            case '\\': out.append("\\\\", 2); break;
+            case '\n': out.append("\\n", 2); break;
+            case '\r': out.append("\\r", 2); break;
+            case '\t': out.append("\\t", 2); break;
+            case '\b': out.append("\\b", 2); break;
+            case '\f': out.append("\\f", 2); break;
+            default: {
+                char esc[6] = { '\\', 'u', '0', '0', kHex[c >> 4], kHex[c & 0xF] };
+                out.append(esc, 6);
+                break;
+            }
+        }
+    }
+    out.append(s + run, n - run);
+}
+
+inline void appendQuoted(std::string& out, const char* s, size_t n) {
+    out += '"';
+    appendEscaped(out, s, n);
+    out += '"';
+}
+
+// ========== 格式化输出 ==========
+
+/**
+ * @brief 把紧凑 JSON 重新排版后追加到 out（与 cJSON_Print 的格式一致）
+ *
+ * 对象成员每行一个、按层级用制表符缩进，键值之间为 ":\t"；数组元素在同一行，以 ", " 分隔。
+ * 输入须是本文件写出的紧凑 JSON（字符串之外没有空白），不做校验。
+ */
+inline void appendPretty(std::string& out, const char* json, size_t n) {
+    std::vector<char> stack;  // 每层容器的开括号
+    out.reserve(out.size() + n + n / 4);
+    for (size_t i = 0; i < n; ++i) {
+        char c = json[i];
+        switch (c) {
+            case '"': {
+                // 字符串原样复制（跳过转义的引号）
+                size_t end = i + 1;
+                while (end < n && json[end] != '"') {
+                    end += json[end] == '\\' ? 2 : 1;
+                }
+                end = end < n ? end + 1 : n;
+                out.append(json + i, end - i);
+                i = end - 1;
+                break;
+            }
+            case '{':
+                stack.push_back('{');
+                out.append("{\n", 2);
+                if (i + 1 < n && json[i + 1] != '}') {
+                    out.append(stack.size(), '\t');
+                }
+                break;
+            case '}':
+                if (i > 0 && json[i - 1] != '{') {
+                    out += '\n';
+                }
+                if (!stack.empty()) {
+                    stack.pop_back();
+                }
+                out.append(stack.size(), '\t');
+                out += '}';
+                break;
+            case '[':
+                stack.push_back('[');
+                out += '[';
+                break;
+            case ']':
+                if (!stack.empty()) {
+                    stack.pop_back();
+                }
+                out += ']';
+                break;
+            case ':':
+                out.append(":\t", 2);
+                break;
+            case ',':
+                if (!stack.empty() && stack.back() == '{') {
+                    out.append(",\n", 2);
+                    out.append(stack.size(), '\t');
+                } else {
+                    out.append(", ", 2);
+                }
+                break;
+            default:
+                out += c;
+                break;
+        }
+    }
+}
+
+// ========== 写入器 ==========
+
+class Writer {
+public:
+    static const int kMaxDepth = 64;  // 位图可记录的层级，更深的层级使用 deep_
+
+    explicit Writer(std::string& out) : out_(out), depth_(0), has_element_(0), after_key_(false) {}
+
+    std::string& buffer() { return out_; }
+
+    void beginObject() {
+        separator();
+        out_ += '{';
+        push();
+    }
+
+    void endObject() {
+        pop();
+        out_ += '}';
+    }
+
+    void beginArray() {
+        separator();
+        out_ += '[';
+        push();
+    }
+
+    void endArray() {
+        pop();
+        out_ += ']';
+    }
+
+    void key(const char* k, size_t n) {
+        separator();
+        appendQuoted(out_, k, n);
+        out_ += ':';
+        after_key_ = true;
+    }
+
+    void key(const char* k) { key(k, std::strlen(k)); }
+    void key(const std::string& k) { key(k.data(), k.size()); }
+
+    // 写入已编码好的键前缀（形如 "name":，由调用方保证已转义）
+    void rawKey(const char* prefix, size_t n) {
+        separator();
+        out_.append(prefix, n);
+        after_key_ = true;
+    }
+
+    void string(const char* s, size_t n) {
+        separator();
+        appendQuoted(out_, s, n);
+    }
+
+    void string(const char* s) { string(s, std::strlen(s)); }
+    void string(const std::string& s) { string(s.data(), s.size()); }
+
+    void integer(int64_t value) {
+        separator();
+        appendInteger(out_, value);
+    }
+
+    void uinteger(uint64_t value) {
+        separator();
+        appendUnsigned(out_, value);
+    }
+
+    void number(double value) {
+        separator();
+        appendDouble(out_, value);
+    }
+
+    void number(float value) {
+        separator();
+        appendFloat(out_, value);
+    }
+
+    void boolean(bool value) {
+        separator();
+        if (value) {
+            out_.append("true", 4);
+        } else {
+            out_.append("false", 5);
+        }
+    }
+
+    void null() {
+        separator();
+        out_.append("null", 4);
+    }
+
+    // 写入已编码好的 JSON 值（不做校验）
+    void raw(const char* json, size_t n) {
+        separator();
+        out_.append(json, n);
+    }
+
+    void raw(const std::string& json) { raw(json.data(), json.size()); }
+
+private:
+    std::string& out_;
+    int depth_;
+    uint64_t has_element_;  // 第 i 位：第 i 层容器是否已有元素
+    bool after_key_;
+
+    std::vector<bool> deep_;  // 超过 kMaxDepth 的层级
+
+    bool levelHasElement() const {
+        if (depth_ <= kMaxDepth) {
+            return depth_ > 0 && (has_element_ & (static_cast<uint64_t>(1) << (depth_ - 1))) != 0;
+        }
+        return deep_[static_cast<size_t>(depth_ - kMaxDepth - 1)];
+    }
+
+    void setLevelHasElement(bool value) {
+        if (depth_ <= 0) {
+            return;
+        }
+        if (depth_ <= kMaxDepth) {
+            uint64_t bit = static_cast<uint64_t>(1) << (depth_ - 1);
+            has_element_ = value ? (has_element_ | bit) : (has_element_ & ~bit);
+            return;
+        }
+        size_t index = static_cast<size_t>(depth_ - kMaxDepth - 1);
+        if (deep_.size() <= index) {
+            deep_.resize(index + 1, false);
+        }
+        deep_[index] = value;
+    }
+
+    // 在值或键之前插入逗号
+    void separator() {
+        if (after_key_) {
+            after_key_ = false;
+            return;
+        }
+        if (levelHasElement()) {
+            out_ += ',';
+        }
+        setLevelHasElement(true);
+    }
+
+    void push() {
+        ++depth_;
+        setLevelHasElement(false);
+    }
+
+    void pop() {
+        --depth_;
+        after_key_ = false;
+    }
+};
+
+} // namespace json
+} // namespace uvapi
+
+#endif // UVAPI_JSON_WRITER_H
@@ -3,6 +3,12 @@
  * @brief 监控指标功能
  * 
  * 提供监控指标收集和导出功能，用于生产环境监控
+ *
+ * 导出路径不阻塞记录方：
+ * - 记录（increment / set / observe）只有 relaxed 原子操作
+ * - 注册表以写时复制的快照发布指标列表，抓取时不持有注册表锁
+ * - 抓取结果直接追加到调用方复用的缓冲区，数值用查表 / 最短往返格式化，不经过 iostream
+ * - 支持 Prometheus 文本格式和 OpenMetrics；BackgroundScraper 可在独立线程中定时渲染
  */
 
 #ifndef METRICS_H
@@ -10,11 +16,18 @@
 
 #include <string>
 #include <map>
+#include <memory>
+#include <cstdint>
 #include <atomic>
 #include <mutex>
 #include <chrono>
 #include <vector>
-#include <sstream>
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <condition_variable>
+
+#include "json_writer.h"
 
 namespace uvapi {
 namespace metrics {
@@ -25,14 +38,87 @@ namespace metrics {
 enum class MetricType {
     COUNTER,    // 计数器（只增不减）
     GAUGE,      // 仪表盘（可增可减）
-    HISTOGRAM   // 直方图（分布统计）
+    HISTOGRAM,  // 直方图（分布统计）
+    SUMMARY     // 摘要（分位数）
+};
+
+/**
+ * @brief 导出格式
+ */
+enum class ExpositionFormat {
+    PROMETHEUS,   // text/plain; version=0.0.4
+    OPENMETRICS   // application/openmetrics-text; version=1.0.0（计数器带 _total 后缀，以 # EOF 结尾）
 };
 
+inline const char* contentType(ExpositionFormat format) {
+    return format == ExpositionFormat::OPENMETRICS
+        ? "application/openmetrics-text; version=1.0.0; charset=utf-8"
+        : "text/plain; version=0.0.4; charset=utf-8";
+}
+
 /**
  * @brief 指标标签
  */
 using MetricLabels = std::map<std::string, std::string>;
 
+// ========== 文本格式化 ==========
+
+namespace detail {
+
+// 样本值：整值走整数路径，其余为最短往返表示；NaN / Inf 按 Prometheus 的写法
+inline void appendSampleValue(std::string& out, double value) {
+    if (std::isnan(value)) {
+        out.append("NaN", 3);
+    } else if (std::isinf(value)) {
+        out.append(value > 0 ? "+Inf" : "-Inf", 4);
+    } else {
+        json::appendDouble(out, value);
+    }
+}
+
+// 标签值转义 \\、\" 和换行；HELP 文本只转义 \\ 和换行
+inline void appendEscapedText(std::string& out, const std::string& text, bool quote) {
+    size_t run = 0;
+    for (size_t i = 0; i < text.size(); ++i) {
+        char c = text[i];
+        if (c != '\\' && c != '\n' && !(quote && c == '"')) {
+            continue;
+        }
+        out.append(text, run, i - run);
+        run = i + 1;
+        out += '\\';
+        out += c == '\n' ? 'n' : c;
+    }
+    out.append(text, run, std::string::npos);
+}
+
+/**
+ * @brief 写出一个样本的名称和标签：name suffix {labels,extra} 以及一个空格
+ * @param labels 已渲染的标签（k="v",...），可为空
+ * @param extra 追加在末尾的已渲染标签（如 le="0.5"），可为 nullptr
+ */
+inline void appendSeries(std::string& out, const std::string& name, const char* suffix,
+                         const std::string& labels, const std::string* extra) {
+    out.append(name);
+    if (suffix) {
+        out.append(suffix);
+    }
+    if (!labels.empty() || extra) {
+        out += '{';
+        out.append(labels);
+        if (extra) {
+            if (!labels.empty()) {
+                out += ',';
+            }
+            out.append(*extra);
+        }
+        out += '}';
+    }
+    out += ' ';
+}
+
+} // namespace detail
+
 /**
  * @brief 基础指标
  */
@@ -42,7 +128,37 @@ protected:
     std::string help_;
     MetricType type_;
     MetricLabels labels_;
-    mutable std::mutex mutex_;
+    std::string label_text_;  // 按 labels_ 预渲染的 k="v",...，抓取时直接复制
+    mutable std::mutex mutex_;  // 只保护标签，记录路径不使用
+    
+    std::string labelText() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return label_text_;
+    }
+    
+    /**
+     * @brief 指标族名称：OpenMetrics 中计数器的族名不含 _total 后缀
+     */
+    std::string familyName(ExpositionFormat format) const {
+        static const std::string kTotal = "_total";
+        if (format == ExpositionFormat::OPENMETRICS && type_ == MetricType::COUNTER &&
+            name_.size() > kTotal.size() && name_.compare(name_.size() - kTotal.size(), kTotal.size(), kTotal) == 0) {
+            return name_.substr(0, name_.size() - kTotal.size());
+        }
+        return name_;
+    }
+    
+    void appendHeader(std::string& out, const std::string& family, const char* type) const {
+        out.append("# HELP ", 7);
+        out.append(family);
+        out += ' ';
+        detail::appendEscapedText(out, help_, false);
+        out.append("\n# TYPE ", 8);
+        out.append(family);
+        out += ' ';
+        out.append(type);
+        out += '\n';
+    }
     
 public:
     Metric(const std::string& name, const std::string& help, MetricType type)
@@ -57,60 +173,117 @@ public:
     void addLabel(const std::string& key, const std::string& value) {
         std::lock_guard<std::mutex> lock(mutex_);
         labels_[key] = value;
+        label_text_.clear();
+        for (MetricLabels::const_iterator it = labels_.begin(); it != labels_.end(); ++it) {
+            if (!label_text_.empty()) {
+                label_text_ += ',';
+            }
+            label_text_.append(it->first);
+            label_text_.append("=\"", 2);
+            detail::appendEscapedText(label_text_, it->second, true);
+            label_text_ += '"';
+        }
+    }
+    
+    /**
+     * @brief 把本指标的导出文本追加到 out（不清空 out）
+     */
+    virtual void appendTo(std::string& out, ExpositionFormat format) const = 0;
+    
+    std::string toPrometheus() const {
+        std::string out;
+        appendTo(out, ExpositionFormat::PROMETHEUS);
+        return out;
     }
+};
+
+// ========== 分片计数单元 ==========
+
+namespace detail {
+
+static const size_t kMetricShards = 16;  // 2 的幂
+
+/**
+ * @brief 当前线程的分片下标
+ *
+ * 线程首次记录指标时按轮转分配，之后固定不变；每个事件循环线程写自己的分片，
+ * 热路径上只有无竞争的 relaxed 原子操作，抓取时再合并所有分片。
+ */
+inline size_t threadShard() {
+    static std::atomic<size_t> next(0);
+    static thread_local size_t index = next.fetch_add(1, std::memory_order_relaxed) & (kMetricShards - 1);
+    return index;
+}
+
+// 独占一个缓存行的计数单元，避免不同线程的分片伪共享
+struct CounterCell {
+    std::atomic<uint64_t> value;
+    char padding[64 - sizeof(std::atomic<uint64_t>)];
+    
+    CounterCell() : value(0) {}
+};
+
+struct DoubleCell {
+    std::atomic<double> value;
+    char padding[64 - sizeof(std::atomic<double>)];
     
-    virtual std::string toPrometheus() const = 0;
+    DoubleCell() : value(0.0) {}
 };
 
+// std::atomic<double> 在 C++11 中没有 fetch_add，使用 CAS 循环（分片内无竞争，通常一次成功）
+inline void atomicAdd(std::atomic<double>& target, double delta) {
+    double current = target.load(std::memory_order_relaxed);
+    while (!target.compare_exchange_weak(current, current + delta, std::memory_order_relaxed)) {
+    }
+}
+
+} // namespace detail
+
 /**
  * @brief 计数器指标
  */
 class Counter : public Metric {
 private:
-    std::atomic<uint64_t> value_;
+    detail::CounterCell cells_[detail::kMetricShards];
     
 public:
     Counter(const std::string& name, const std::string& help = "")
-        : Metric(name, help, MetricType::COUNTER), value_(0) {}
+        : Metric(name, help, MetricType::COUNTER) {}
     
     void increment(uint64_t delta = 1) {
-        value_ += delta;
+        cells_[detail::threadShard()].value.fetch_add(delta, std::memory_order_relaxed);
     }
     
+    // 合并所有分片
     uint64_t value() const {
-        return value_.load();
+        uint64_t total = 0;
+        for (size_t i = 0; i < detail::kMetricShards; ++i) {
+            total += cells_[i].value.load(std::memory_order_relaxed);
+        }
+        return total;
     }
     
     void reset() {
-        value_ = 0;
+        for (size_t i = 0; i < detail::kMetricShards; ++i) {
+            cells_[i].value.store(0, std::memory_order_relaxed);
+        }
     }
     
-    std::string toPrometheus() const override {
-        std::lock_guard<std::mutex> lock(mutex_);
-        std::ostringstream oss;
-        
-        oss << "# HELP " << name_ << " " << help_ << "\n";
-        oss << "# TYPE " << name_ << " counter\n";
-        
-        if (!labels_.empty()) {
-            oss << name_ << "{";
-            bool first = true;
-            for (const auto& [key, value] : labels_) {
-                if (!first) oss << ",";
-                oss << key << "=\"" << value << "\"";
-                first = false;
-            }
-            oss << "} " << value_ << "\n";
-        } else {
-            oss << name_ << " " << value_ << "\n";
-        }
-        
-        return oss.str();
+    void appendTo(std::string& out, ExpositionFormat format) const override {
+        std::string family = familyName(format);
+        appendHeader(out, family, "counter");
+        // OpenMetrics 的样本名固定为 <族名>_total
+        detail::appendSeries(out, family, format == ExpositionFormat::OPENMETRICS ? "_total" : nullptr,
+                             labelText(), nullptr);
+        json::appendUnsigned(out, value());
+        out += '\n';
     }
 };
 
 /**
  * @brief 仪表盘指标
+ *
+ * set() 需要全局一致的当前值，因此不分片；所有操作都是无锁的 relaxed 原子操作。
  */
 class Gauge : public Metric {
 private:
@@ -121,146 +294,199 @@ public:
         : Metric(name, help, MetricType::GAUGE), value_(0) {}
     
     void set(double value) {
-        value_ = value;
+        value_.store(value, std::memory_order_relaxed);
     }
     
     void increment(double delta = 1.0) {
-        value_ += delta;
+        detail::atomicAdd(value_, delta);
     }
     
     void decrement(double delta = 1.0) {
-        value_ -= delta;
+        increment(-delta);
     }
     
     double value() const {
-        return value_.load();
+        return value_.load(std::memory_order_relaxed);
     }
     
-    std::string toPrometheus() const override {
-        std::lock_guard<std::mutex> lock(mutex_);
-        std::ostringstream oss;
-        
-        oss << "# HELP " << name_ << " " << help_ << "\n";
-        oss << "# TYPE " << name_ << " gauge\n";
-        
-        if (!labels_.empty()) {
-            oss << name_ << "{";
-            bool first = true;
-            for (const auto& [key, value] : labels_) {
-                if (!first) oss << ",";
-                oss << key << "=\"" << value << "\"";
-                first = false;
-            }
-            oss << "} " << value_ << "\n";
-        } else {
-            oss << name_ << " " << value_ << "\n";
-        }
-        
-        return oss.str();
+    void appendTo(std::string& out, ExpositionFormat /*format*/) const override {
+        appendHeader(out, name_, "gauge");
+        detail::appendSeries(out, name_, nullptr, labelText(), nullptr);
+        detail::appendSampleValue(out, value());
+        out += '\n';
     }
 };
 
 /**
- * @brief 直方图指标（简化版）
+ * @brief 直方图指标
+ *
+ * 每个分片持有一组桶计数和一个浮点累计和：
+ * - observe() 用二分查找定位桶，只对当前线程的分片做 relaxed 原子加
+ * - 桶计数之和即为样本数，不单独维护 count，抓取时合并所有分片
+ * - sum 以 double 累计，不再截断为整数
  */
 class Histogram : public Metric {
+public:
+    // 合并后的快照（buckets[i] 为非累积计数，最后一个为 +Inf 桶）
+    struct Snapshot {
+        std::vector<double> boundaries;
+        std::vector<uint64_t> buckets;
+        double sum;
+        uint64_t count;
+    };
+    
 private:
-    std::vector<uint64_t> buckets_;
-    std::vector<double> bucket_boundaries_;
-    std::atomic<uint64_t> sum_;
-    std::atomic<uint64_t> count_;
+    std::vector<double> bucket_boundaries_;  // 升序
+    size_t bucket_count_;                    // 含 +Inf 桶
+    size_t shard_stride_;                    // 每个分片占用的计数单元数（按缓存行对齐）
+    std::unique_ptr<std::atomic<uint64_t>[]> buckets_;
+    detail::DoubleCell sums_[detail::kMetricShards];
+    std::vector<std::string> le_labels_;     // 预渲染的 le="..." 标签，最后一个为 +Inf
     
 public:
     Histogram(const std::string& name, const std::string& help = "",
               const std::vector<double>& boundaries = {0.1, 0.5, 1.0, 5.0, 10.0})
         : Metric(name, help, MetricType::HISTOGRAM)
-        , bucket_boundaries_(boundaries)
-        , sum_(0)
-        , count_(0) {
-        buckets_.resize(boundaries.size() + 1, 0);
+        , bucket_boundaries_(boundaries) {
+        std::sort(bucket_boundaries_.begin(), bucket_boundaries_.end());
+        bucket_boundaries_.erase(std::unique(bucket_boundaries_.begin(), bucket_boundaries_.end()),
+                                 bucket_boundaries_.end());
+        bucket_count_ = bucket_boundaries_.size() + 1;
+        for (size_t i = 0; i < bucket_boundaries_.size(); ++i) {
+            std::string label = "le=\"";
+            detail::appendSampleValue(label, bucket_boundaries_[i]);
+            label += '"';
+            le_labels_.push_back(label);
+        }
+        le_labels_.push_back("le=\"+Inf\"");
+        
+        const size_t per_line = 64 / sizeof(std::atomic<uint64_t>);
+        shard_stride_ = (bucket_count_ + per_line - 1) / per_line * per_line;
+        size_t total = shard_stride_ * detail::kMetricShards;
+        buckets_.reset(new std::atomic<uint64_t>[total]);
+        for (size_t i = 0; i < total; ++i) {
+            buckets_[i].store(0, std::memory_order_relaxed);
+        }
+    }
+    
+    // 桶下标：第一个满足 value <= boundary 的桶，否则为 +Inf 桶
+    size_t bucketIndex(double value) const {
+        return static_cast<size_t>(std::lower_bound(bucket_boundaries_.begin(), bucket_boundaries_.end(), value) -
+                                   bucket_boundaries_.begin());
     }
     
     void observe(double value) {
-        sum_ += static_cast<uint64_t>(value);
-        count_++;
-        
-        // 找到合适的 bucket
-        size_t bucket_index = buckets_.size() - 1;  // 默认到最后一个
-        for (size_t i = 0; i < bucket_boundaries_.size(); ++i) {
-            if (value <= bucket_boundaries_[i]) {
-                bucket_index = i;
-                break;
+        size_t shard = detail::threadShard();
+        buckets_[shard * shard_stride_ + bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+        detail::atomicAdd(sums_[shard].value, value);
+    }
+    
+    const std::vector<double>& boundaries() const { return bucket_boundaries_; }
+    
+    // 合并所有分片（抓取时调用）
+    Snapshot snapshot() const {
+        Snapshot snap;
+        snap.boundaries = bucket_boundaries_;
+        snap.buckets.assign(bucket_count_, 0);
+        snap.sum = 0.0;
+        snap.count = 0;
+        for (size_t shard = 0; shard < detail::kMetricShards; ++shard) {
+            const std::atomic<uint64_t>* cells = &buckets_[shard * shard_stride_];
+            for (size_t i = 0; i < bucket_count_; ++i) {
+                uint64_t n = cells[i].load(std::memory_order_relaxed);
+                snap.buckets[i] += n;
+                snap.count += n;
             }
+            snap.sum += sums_[shard].value.load(std::memory_order_relaxed);
         }
-        
-        buckets_[bucket_index]++;
+        return snap;
     }
     
-    std::string toPrometheus() const override {
-        std::lock_guard<std::mutex> lock(mutex_);
-        std::ostringstream oss;
-        
-        oss << "# HELP " << name_ << " " << help_ << "\n";
-        oss << "# TYPE " << name_ << " histogram\n";
+    uint64_t count() const { return snapshot().count; }
+    double sum() const { return snapshot().sum; }
+    
+    void appendTo(std::string& out, ExpositionFormat /*format*/) const override {
+        Snapshot snap = snapshot();
+        std::string labels = labelText();
+        appendHeader(out, name_, "histogram");
         
-        // 输出 bucket 指标
-        for (size_t i = 0; i < bucket_boundaries_.size(); ++i) {
-            uint64_t cumulative = 0;
-            for (size_t j = 0; j <= i; ++j) {
-                cumulative += buckets_[j];
-            }
-            
-            oss << name_ << "_bucket{le=\"" << bucket_boundaries_[i] << "\"} " << cumulative << "\n";
+        // 桶计数在一次遍历中累积
+        uint64_t cumulative = 0;
+        for (size_t i = 0; i < le_labels_.size(); ++i) {
+            cumulative += snap.buckets[i];
+            detail::appendSeries(out, name_, "_bucket", labels, &le_labels_[i]);
+            json::appendUnsigned(out, cumulative);
+            out += '\n';
         }
         
-        // 输出 +Inf bucket（总数）
-        oss << name_ << "_bucket{le=\"+Inf\"} " << count_ << "\n";
-        
-        // 输出 sum 和 count
-        oss << name_ << "_sum " << sum_ << "\n";
-        oss << name_ << "_count " << count_ << "\n";
-        
-        return oss.str();
+        detail::appendSeries(out, name_, "_sum", labels, nullptr);
+        detail::appendSampleValue(out, snap.sum);
+        out += '\n';
+        detail::appendSeries(out, name_, "_count", labels, nullptr);
+        json::appendUnsigned(out, snap.count);
+        out += '\n';
     }
 };
 
 /**
  * @brief 指标注册表
+ *
+ * 注册和查找使用 mutex_；每次注册后发布一份按名称排序的指标列表快照，
+ * 抓取只原子地读取快照，不与注册方或记录方竞争锁。
  */
 class MetricRegistry {
+public:
+    typedef std::vector<std::shared_ptr<Metric> > MetricList;
+    
 private:
     std::map<std::string, std::shared_ptr<Metric>> metrics_;
     mutable std::mutex mutex_;
+    std::shared_ptr<const MetricList> snapshot_;  // 通过 std::atomic_load / atomic_store 访问
+    mutable std::atomic<size_t> last_scrape_size_;  // 上次抓取的字节数，用于预留缓冲区
+    
+    // 调用方持有 mutex_
+    void publishLocked() {
+        std::shared_ptr<MetricList> list = std::make_shared<MetricList>();
+        list->reserve(metrics_.size());
+        for (const auto& entry : metrics_) {
+            list->push_back(entry.second);
+        }
+        std::atomic_store(&snapshot_, std::shared_ptr<const MetricList>(list));
+    }
+    
+    template<typename T>
+    std::shared_ptr<T> add(const std::shared_ptr<T>& metric) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        metrics_[metric->name()] = metric;
+        publishLocked();
+        return metric;
+    }
     
 public:
-    MetricRegistry() {}
+    MetricRegistry() : snapshot_(std::make_shared<MetricList>()), last_scrape_size_(0) {}
     
     // 注册计数器
     std::shared_ptr<Counter> registerCounter(const std::string& name,
                                                const std::string& help = "") {
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto counter = std::make_shared<Counter>(name, help);
-        metrics_[name] = counter;
-        return counter;
+        return add(std::make_shared<Counter>(name, help));
     }
     
     // 注册仪表盘
     std::shared_ptr<Gauge> registerGauge(const std::string& name,
                                            const std::string& help = "") {
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto gauge = std::make_shared<Gauge>(name, help);
-        metrics_[name] = gauge;
-        return gauge;
+        return add(std::make_shared<Gauge>(name, help));
     }
     
     // 注册直方图
     std::shared_ptr<Histogram> registerHistogram(const std::string& name,
                                                    const std::string& help = "",
                                                    const std::vector<double>& boundaries = {0.1, 0.5, 1.0, 5.0, 10.0}) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto histogram = std::make_shared<Histogram>(name, help, boundaries);
-        metrics_[name] = histogram;
-        return histogram;
+        return add(std::make_shared<Histogram>(name, help, boundaries));
+    }
+    
+    // 注册自定义指标（同名时替换）
+    void registerMetric(const std::shared_ptr<Metric>& metric) {
+        add(metric);
     }
     
     // 获取指标
@@ -273,16 +499,139 @@ public:
         return nullptr;
     }
     
+    // 当前指标列表快照（不加锁）
+    std::shared_ptr<const MetricList> snapshot() const {
+        return std::atomic_load(&snapshot_);
+    }
+    
+    /**
+     * @brief 把所有指标渲染到 out（先清空，保留容量）
+     *
+     * 可以在任意线程调用；out 通常由调用方跨次抓取复用。
+     */
+    void scrape(std::string& out, ExpositionFormat format = ExpositionFormat::PROMETHEUS) const {
+        out.clear();
+        out.reserve(last_scrape_size_.load(std::memory_order_relaxed));
+        std::shared_ptr<const MetricList> list = snapshot();
+        for (size_t i = 0; i < list->size(); ++i) {
+            (*list)[i]->appendTo(out, format);
+            if (format == ExpositionFormat::PROMETHEUS) {
+                out += '\n';
+            }
+        }
+        if (format == ExpositionFormat::OPENMETRICS) {
+            out.append("# EOF\n", 6);
+        }
+        last_scrape_size_.store(out.size(), std::memory_order_relaxed);
+    }
+    
     // 导出为 Prometheus 格式
     std::string toPrometheus() const {
+        std::string out;
+        scrape(out, ExpositionFormat::PROMETHEUS);
+        return out;
+    }
+};
+
+// ========== 后台抓取 ==========
+
+/**
+ * @brief 抓取端点选项
+ */
+struct ExpositionOptions {
+    ExpositionFormat format;
+    std::chrono::milliseconds refresh_interval;  // > 0 时由 BackgroundScraper 定时渲染，请求只返回最近结果
+
+    explicit ExpositionOptions(ExpositionFormat fmt = ExpositionFormat::PROMETHEUS,
+                               std::chrono::milliseconds interval = std::chrono::milliseconds(0))
+        : format(fmt), refresh_interval(interval) {}
+};
+
+/**
+ * @brief 在独立线程中按固定间隔渲染注册表，请求路径只取最近一次的结果
+ *
+ * 渲染不占用事件循环线程；没有读方持有的旧缓冲区会被下一次渲染复用。
+ */
+class BackgroundScraper {
+public:
+    BackgroundScraper(const MetricRegistry& registry, std::chrono::milliseconds interval,
+                      ExpositionFormat format = ExpositionFormat::PROMETHEUS)
+        : registry_(registry), interval_(interval), format_(format), running_(false) {}
+    
+    ~BackgroundScraper() { stop(); }
+    
+    BackgroundScraper(const BackgroundScraper&) = delete;
+    BackgroundScraper& operator=(const BackgroundScraper&) = delete;
+    
+    ExpositionFormat format() const { return format_; }
+    
+    // 先同步渲染一次，保证 latest() 立即可用
+    void start() {
         std::lock_guard<std::mutex> lock(mutex_);
-        std::ostringstream oss;
-        
-        for (const auto& [name, metric] : metrics_) {
-            oss << metric->toPrometheus() << "\n";
+        if (running_) {
+            return;
+        }
+        refresh();
+        running_ = true;
+        thread_ = std::thread(&BackgroundScraper::run, this);
+    }
+    
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!running_) {
+                return;
+            }
+            running_ = false;
+        }
+        cv_.notify_all();
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+    
+    // 最近一次渲染的结果；未启动时为空
+    std::shared_ptr<const std::string> latest() const {
+        return std::atomic_load(&latest_);
+    }
+    
+    // 立即渲染一次（只由后台线程或 start() 调用）
+    void refresh() {
+        std::shared_ptr<std::string> buffer;
+        if (spare_ && spare_.use_count() == 1) {
+            buffer.swap(spare_);
+        } else {
+            buffer = std::make_shared<std::string>();
+        }
+        registry_.scrape(*buffer, format_);
+        std::shared_ptr<const std::string> previous =
+            std::atomic_exchange(&latest_, std::shared_ptr<const std::string>(buffer));
+        // 发布后不会再有新的读方拿到 previous，读方全部释放后即可复用
+        spare_ = std::const_pointer_cast<std::string>(previous);
+    }
+    
+private:
+    const MetricRegistry& registry_;
+    std::chrono::milliseconds interval_;
+    ExpositionFormat format_;
+    std::shared_ptr<const std::string> latest_;  // 通过 std::atomic_load / atomic_exchange 访问
+    std::shared_ptr<std::string> spare_;
+    
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool running_;
+    std::thread thread_;
+    
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (running_) {
+            if (cv_.wait_for(lock, interval_, [this]() { return !running_; })) {
+                break;
+            }
+            lock.unlock();
+            refresh();
+            lock.lock();
         }
-        
-        return oss.str();
     }
 };
 
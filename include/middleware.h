@@ -30,53 +30,70 @@ using Handler = std::function<HttpResponse(const HttpRequest&)>;
 using Middleware = std::function<HttpResponse(const HttpRequest&, Handler)>;
 
 // 中间件链
+// 每一级的 next 处理器在 add / setFinalHandler 时一次性构建，执行时不再逐级创建闭包。
+// 新代码建议使用 pipeline.h 的扁平流水线（Api::use / RouteBuilder::use）。
 class MiddlewareChain {
 private:
     std::vector<Middleware> middlewares_;
     Handler final_handler_;
+    std::vector<Handler> nexts_;  // nexts_[i] 执行第 i 级，nexts_[size] 为最终处理器
     
 public:
-    MiddlewareChain() {}
+    MiddlewareChain() { rebuild(); }
+    
+    // 复制时重建 next 表（其中的闭包引用的是所属链）
+    MiddlewareChain(const MiddlewareChain& other)
+        : middlewares_(other.middlewares_), final_handler_(other.final_handler_) {
+        rebuild();
+    }
+    
+    MiddlewareChain& operator=(const MiddlewareChain& other) {
+        if (this != &other) {
+            middlewares_ = other.middlewares_;
+            final_handler_ = other.final_handler_;
+            rebuild();
+        }
+        return *this;
+    }
     
     // 添加中间件
     void add(Middleware middleware) {
         middlewares_.push_back(middleware);
+        rebuild();
     }
     
     // 设置最终处理器
     void setFinalHandler(Handler handler) {
         final_handler_ = handler;
+        rebuild();
     }
     
     // 执行中间件链
     HttpResponse execute(const HttpRequest& request) {
-        return executeMiddleware(request, 0);
+        return nexts_[0](request);
     }
     
 private:
-    // 递归执行中间件
-    HttpResponse executeMiddleware(const HttpRequest& request, size_t index) {
-        // 如果还有中间件，执行当前中间件
-        if (index < middlewares_.size()) {
-            // 创建下一个处理器（递归调用）
-            Handler next = [this, index](const HttpRequest& req) -> HttpResponse {
-                return executeMiddleware(req, index + 1);
-            };
-            
-            // 执行当前中间件
-            return middlewares_[index](request, next);
+    void rebuild() {
+        nexts_.clear();
+        nexts_.reserve(middlewares_.size() + 1);
+        for (size_t index = 0; index < middlewares_.size(); ++index) {
+            // 只捕获 this 和下标，std::function 内联存储，不分配
+            nexts_.push_back([this, index](const HttpRequest& req) -> HttpResponse {
+                return middlewares_[index](req, nexts_[index + 1]);
+            });
         }
-        
-        // 所有中间件执行完毕，执行最终处理器
         if (final_handler_) {
-            return final_handler_(request);
+            nexts_.push_back(final_handler_);
+            return;
         }
-        
         // 没有最终处理器，返回 404
-        HttpResponse resp(404);
-        resp.headers["Content-Type"] = "application/json";
-        resp.body = "{\"error\":\"Not Found\"}";
-        return resp;
+        nexts_.push_back([](const HttpRequest&) -> HttpResponse {
+            HttpResponse resp(404);
+            resp.headers["Content-Type"] = "application/json";
+            resp.body = "{\"error\":\"Not Found\"}";
+            return resp;
+        });
     }
 };
 
@@ -12,30 +12,74 @@
 #include <vector>
 #include <map>
 #include <functional>
+#include <memory>
 #include <set>
+#include <cstdio>
 
 namespace uvapi {
 
+// ========== 落盘临时文件 ==========
+
+// 大文件部分写入的临时文件，最后一个引用释放时删除
+struct SpillFile {
+    std::string path;
+    
+    explicit SpillFile(const std::string& p) : path(p) {}
+    ~SpillFile() { std::remove(path.c_str()); }
+    
+    SpillFile(const SpillFile&) = delete;
+    SpillFile& operator=(const SpillFile&) = delete;
+};
+
 // ========== 上传的文件信息 ==========
 
 struct UploadedFile {
     std::string field_name;      // 表单字段名
     std::string filename;        // 原始文件名
     std::string content_type;    // 内容类型（MIME type）
-    std::vector<char> data;      // 文件数据
+    std::vector<char> data;      // 文件数据（落盘或流式回调时为空）
     size_t size;                 // 文件大小
+    std::shared_ptr<SpillFile> spill;  // 超过 spill_threshold 时的临时文件
     
     UploadedFile() : size(0) {}
     
+    // 数据是否保存在内存中
+    bool inMemory() const { return !spill; }
+    
+    // 临时文件路径（数据在内存中时为空）
+    std::string tempPath() const { return spill ? spill->path : std::string(); }
+    
     // 保存文件到磁盘
     bool saveTo(const std::string& filepath) const {
         FILE* fp = fopen(filepath.c_str(), "wb");
         if (!fp) return false;
         
-        size_t written = fwrite(data.data(), 1, data.size(), fp);
-        fclose(fp);
+        if (!spill) {
+            size_t written = fwrite(data.data(), 1, data.size(), fp);
+            fclose(fp);
+            return written == data.size();
+        }
         
-        return written == data.size();
+        // 从临时文件分块复制
+        FILE* src = fopen(spill->path.c_str(), "rb");
+        if (!src) {
+            fclose(fp);
+            return false;
+        }
+        char buf[64 * 1024];
+        size_t total = 0;
+        bool ok = true;
+        size_t n;
+        while ((n = fread(buf, 1, sizeof(buf), src)) > 0) {
+            if (fwrite(buf, 1, n, fp) != n) {
+                ok = false;
+                break;
+            }
+            total += n;
+        }
+        fclose(src);
+        fclose(fp);
+        return ok && total == size;
     }
 };
 
@@ -46,6 +90,10 @@ struct UploadConfig {
     size_t max_total_size;                   // 最大总上传大小（字节）
     std::set<std::string> allowed_types;    // 允许的文件类型（MIME type）
     bool check_file_extension;               // 是否检查文件扩展名
+    size_t spill_threshold;                  // 文件超过该大小时写入临时文件（0 = 始终保存在内存中）
+    std::string temp_dir;                    // 临时文件目录
+    size_t max_header_size;                  // 单个部分头部的最大大小
+    size_t max_field_size;                   // 普通字段值的最大大小
     
     // 默认配置
     static UploadConfig defaultConfig() {
@@ -64,7 +112,11 @@ struct UploadConfig {
     UploadConfig() 
         : max_file_size(10 * 1024 * 1024)
         , max_total_size(50 * 1024 * 1024)
-        , check_file_extension(true) {}
+        , check_file_extension(true)
+        , spill_threshold(1024 * 1024)
+        , temp_dir("/tmp")
+        , max_header_size(16 * 1024)
+        , max_field_size(1024 * 1024) {}
 };
 
 // ========== 文件上传验证结果 ==========
@@ -84,26 +136,67 @@ struct UploadValidationResult {
 
 // ========== 多部分表单解析器 ==========
 
+/**
+ * @brief 增量式 multipart/form-data 解析器
+ *
+ * 按 uvhttp 交付的顺序逐块调用 feed()，最后调用 finish()：
+ * - 分隔符用 Boyer-Moore-Horspool 查找，跨块的分隔符前缀只保留不超过分隔符长度的尾部
+ * - 普通字段值直接追加到结果中；文件数据按 spill_threshold 写入临时文件，
+ *   或通过 onFileData() 流式交给调用方，内存占用与上传大小无关
+ * - 类型/扩展名不合法或超过 max_file_size 的文件被跳过，不影响其余部分
+ *
+ * @code
+ * MultipartParser parser(boundary, config);
+ * parser.onFileData([](const UploadedFile& file, const char* data, size_t size) {
+ *     return sink.write(file.field_name, data, size);  // 返回 false 中止解析
+ * });
+ * for (each chunk) if (!parser.feed(chunk.data, chunk.size)) return badRequest(parser.error());
+ * if (!parser.finish()) return badRequest(parser.error());
+ * @endcode
+ */
 class MultipartParser {
 public:
     // 解析回调函数类型
     using FieldCallback = std::function<void(const std::string& name, const std::string& value)>;
     using FileCallback = std::function<void(const std::string& name, const std::string& filename, 
                                             const std::string& content_type, const std::vector<char>& data)>;
+    // 文件数据块回调：设置后文件数据不再缓存；返回 false 中止解析
+    using FileDataCallback = std::function<bool(const UploadedFile& file, const char* data, size_t size)>;
     
     MultipartParser(const std::string& boundary);
     MultipartParser(const std::string& boundary, const UploadConfig& config);
     ~MultipartParser();
     
-    // 解析多部分表单数据
+    MultipartParser(const MultipartParser&) = delete;
+    MultipartParser& operator=(const MultipartParser&) = delete;
+    
+    // 一次性解析完整的多部分表单数据（等价于 reset() + feed() + finish()）
     bool parse(const char* data, size_t size);
     
+    // 输入下一块数据；出错时返回 false，之后的调用均返回 false
+    bool feed(const char* data, size_t size);
+    
+    // 输入结束；未遇到结束分隔符时返回 false
+    bool finish();
+    
+    // 恢复到初始状态（保留回调和配置）
+    void reset();
+    
+    // 是否已解析到结束分隔符
+    bool done() const { return state_ == State::DONE; }
+    
+    // 最近一次失败的原因
+    const std::string& error() const { return error_; }
+    
     // 设置字段回调
     void onField(FieldCallback callback) { field_callback_ = callback; }
     
-    // 设置文件回调
+    // 设置文件回调（文件结束时调用；落盘或流式时 data 为空）
     void onFile(FileCallback callback) { file_callback_ = callback; }
     
+    // 设置文件数据块回调
+    void onFileData(FileDataCallback callback) { file_data_callback_ = callback; }
+    
     // 获取解析的字段
     const std::map<std::string, std::string>& getFields() const { return fields_; }
     
@@ -117,17 +210,63 @@ public:
     void setConfig(const UploadConfig& config) { config_ = config; }
     
 private:
+    enum class State {
+        BODY,           // 部分主体（或第一个分隔符之前的前导内容）
+        AFTER_DELIM,    // 分隔符之后：期待 CRLF 或 "--"
+        CLOSE_DASH,     // 读到一个 '-'，期待第二个
+        HEADERS,        // 部分头部
+        DONE,           // 已读到结束分隔符，忽略其余内容
+        FAILED
+    };
+    
+    enum class PartKind {
+        NONE,           // 前导内容或被跳过的部分
+        FIELD,
+        FILE
+    };
+    
     std::string boundary_;
+    std::string delimiter_;       // "\r\n--" + boundary
+    size_t skip_[256];            // Horspool 跳转表
     std::map<std::string, std::string> fields_;
     std::map<std::string, UploadedFile> files_;
     UploadConfig config_;
     size_t total_uploaded_size_;  // 已上传的总大小
+    size_t total_bytes_;          // 已输入的总字节数
+    
+    State state_;
+    std::string pending_;         // 跨块保留的未决字节（可能是分隔符前缀）
+    std::string header_buf_;      // 当前部分的头部
+    size_t header_line_start_;    // header_buf_ 中当前行的起点
+    std::string error_;
+    
+    // 当前部分
+    PartKind part_kind_;
+    std::string part_name_;
+    std::string field_value_;
+    UploadedFile file_;
+    FILE* spill_fp_;
     
     FieldCallback field_callback_;
     FileCallback file_callback_;
+    FileDataCallback file_data_callback_;
+    
+    // 状态机：尽可能多地消费输入，返回已消费字节数
+    size_t consume(const char* data, size_t size);
+    size_t consumeBody(const char* data, size_t size);
+    size_t consumeHeaders(const char* data, size_t size);
+    size_t findDelimiter(const char* data, size_t size) const;
+    size_t partialDelimiterSuffix(const char* data, size_t size) const;
+    
+    // 部分生命周期
+    bool beginPart();
+    bool appendPartData(const char* data, size_t size);
+    bool endPart();
+    void discardPart();
+    bool spillFile();
+    bool fail(const std::string& message);
     
     // 解析辅助方法
-    bool parsePart(const std::string& part);
     std::string extractHeaderValue(const std::string& headers, const std::string& name);
     std::string extractFilename(const std::string& content_disposition);
     
@@ -1,98 +1,446 @@
+/**
+ * @file object_pool.h
+ * @brief 对象池与按尺寸分级的内存块池
+ *
+ * 两级结构，热路径上没有互斥锁：
+ * - 线程缓存：每个线程在每个池上有一段私有的自由列表，acquire / release 只读写本线程的数组
+ * - 全局仓库：线程缓存满了按批（kPoolBatch 个）转入仓库，空了整批取回；
+ *   仓库是无锁栈，只有"压入一批"（CAS）和"整体取走"（exchange）两种操作，因此不存在 ABA 问题
+ *
+ * 跨线程释放（A 线程取出、B 线程归还）进入 B 的线程缓存，满了再经仓库回到其他线程。
+ * 线程退出时其缓存整体归还到仓库。
+ *
+ * SlabAllocator 在同样的结构上按 16 ~ 4096 字节的尺寸分级管理原始内存块，
+ * 块从 64KB 的大块中切出，分配器销毁时整体释放。
+ */
+
 #ifndef UVAPI_OBJECT_POOL_H
 #define UVAPI_OBJECT_POOL_H
 
-#include <stack>
-#include <mutex>
-#include <memory>
-#include <functional>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <deque>
-#include <unordered_map>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <typeinfo>
+#include <unordered_map>
+#include <vector>
 
 namespace uvapi {
 
+namespace detail {
+
+static const size_t kPoolBatch = 32;  // 线程缓存与仓库之间一次转移的对象数
+static const size_t kPoolLocalCapacity = kPoolBatch * 2;
+
+struct PoolBatch {
+    PoolBatch* next;
+    size_t count;
+    void* items[kPoolBatch];
+};
+
+// 某个线程在某个池上的缓存：只有所属线程写入，count 可被 size() 从其他线程读取
+struct PoolLocalCache {
+    void* items[kPoolLocalCapacity];
+    std::atomic<size_t> count;
+    PoolBatch* spare;  // 留一个空批次，避免每次转移都分配
+
+    PoolLocalCache() : count(0), spare(nullptr) {}
+};
+
+class PoolCore;
+
+/**
+ * @brief 当前线程用过的池及其缓存
+ *
+ * 持有池的 shared_ptr，线程退出时可以安全地把缓存归还；已关闭的池在下一次未命中时清理。
+ */
+class PoolThreadTable {
+public:
+    struct Slot {
+        PoolCore* core;
+        PoolLocalCache* cache;
+        std::shared_ptr<PoolCore> owner;
+    };
+
+    inline PoolThreadTable();
+    inline ~PoolThreadTable();
+
+    // 当前线程的表是否已构造且尚未析构（可在线程局部对象销毁后安全查询）
+    static bool& alive() {
+        static thread_local bool live = false;  // 平凡析构，不受销毁顺序影响
+        return live;
+    }
+
+    PoolLocalCache* find(const PoolCore* core) {
+        if (last_ < slots_.size() && slots_[last_].core == core) {
+            return slots_[last_].cache;
+        }
+        for (size_t i = 0; i < slots_.size(); ++i) {
+            if (slots_[i].core == core) {
+                last_ = i;
+                return slots_[i].cache;
+            }
+        }
+        return nullptr;
+    }
+
+    void add(PoolCore* core, PoolLocalCache* cache, const std::shared_ptr<PoolCore>& owner) {
+        Slot slot = { core, cache, owner };
+        slots_.push_back(slot);
+        last_ = slots_.size() - 1;
+    }
+
+    // 归还并移除指定的池；core 为空时移除所有已关闭的池
+    inline void remove(const PoolCore* core);
+
+private:
+    std::vector<Slot> slots_;
+    size_t last_;
+};
+
+inline PoolThreadTable& poolThreadTable() {
+    static thread_local PoolThreadTable table;
+    return table;
+}
+
+/**
+ * @brief 与元素类型无关的池核心：元素以 void* 保存，由 destroy 回调销毁
+ */
+class PoolCore : public std::enable_shared_from_this<PoolCore> {
+public:
+    typedef void (*DestroyFn)(void*);
+
+    /**
+     * @param max_items 仓库中最多保留的元素数，超出的直接销毁
+     * @param local_capacity 每个线程缓存的容量（2 ~ kPoolLocalCapacity）
+     */
+    PoolCore(DestroyFn destroy, size_t max_items, size_t local_capacity)
+        : destroy_(destroy)
+        , max_items_(max_items)
+        , local_capacity_(std::max<size_t>(2, std::min(local_capacity, kPoolLocalCapacity)))
+        , head_(nullptr)
+        , depot_items_(0)
+        , closed_(false) {}
+
+    PoolCore(const PoolCore&) = delete;
+    PoolCore& operator=(const PoolCore&) = delete;
+
+    // 最后一个引用释放时已没有线程持有本池的缓存
+    ~PoolCore() {
+        trim(0);
+        for (size_t i = 0; i < caches_.size(); ++i) {
+            destroyItems(caches_[i]->items, caches_[i]->count.load(std::memory_order_relaxed));
+            delete caches_[i]->spare;
+            delete caches_[i];
+        }
+    }
+
+    // 取出一个元素，池为空时返回 nullptr
+    void* acquire() {
+        PoolLocalCache* cache = localCache();
+        size_t n = cache->count.load(std::memory_order_relaxed);
+        if (n == 0) {
+            n = refill(cache);
+            if (n == 0) {
+                return nullptr;
+            }
+        }
+        void* item = cache->items[n - 1];
+        cache->count.store(n - 1, std::memory_order_relaxed);
+        return item;
+    }
+
+    void release(void* item) {
+        PoolLocalCache* cache = localCache();
+        size_t n = cache->count.load(std::memory_order_relaxed);
+        if (n >= local_capacity_) {
+            n = flush(cache, n, local_capacity_ / 2);
+        }
+        cache->items[n] = item;
+        cache->count.store(n + 1, std::memory_order_relaxed);
+    }
+
+    // 直接放入仓库（预填充时使用，任何线程都能取到）
+    void seed(void* const* items, size_t n) {
+        while (n > 0) {
+            size_t count = std::min(n, kPoolBatch);
+            PoolBatch* batch = new PoolBatch();
+            std::memcpy(batch->items, items, count * sizeof(void*));
+            batch->count = count;
+            depot_items_.fetch_add(count, std::memory_order_relaxed);
+            pushChain(batch, batch);
+            items += count;
+            n -= count;
+        }
+    }
+
+    // 仓库与所有线程缓存中的元素总数
+    size_t size() const {
+        size_t total = depot_items_.load(std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(caches_mutex_);
+        for (size_t i = 0; i < caches_.size(); ++i) {
+            total += caches_[i]->count.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    size_t maxItems() const { return max_items_.load(std::memory_order_relaxed); }
+    void setMaxItems(size_t n) { max_items_.store(n, std::memory_order_relaxed); }
+
+    // 从仓库中销毁元素，直到不超过 keep 个
+    void trim(size_t keep) {
+        while (depot_items_.load(std::memory_order_relaxed) > keep) {
+            PoolBatch* batch = popBatch();
+            if (!batch) {
+                break;
+            }
+            depot_items_.fetch_sub(batch->count, std::memory_order_relaxed);
+            destroyItems(batch->items, batch->count);
+            delete batch;
+        }
+    }
+
+    // 池对象销毁：之后归还的缓存直接销毁，不再进入仓库
+    void close() {
+        closed_.store(true, std::memory_order_release);
+        // 函数内静态的池在进程退出时可能晚于主线程的线程表析构，此时缓存已由表的析构归还
+        if (PoolThreadTable::alive()) {
+            poolThreadTable().remove(this);
+        }
+        trim(0);
+    }
+
+    bool closed() const { return closed_.load(std::memory_order_acquire); }
+
+    // 线程缓存归还（线程退出或池关闭时）
+    void retire(PoolLocalCache* cache) {
+        size_t n = cache->count.load(std::memory_order_relaxed);
+        if (closed()) {
+            destroyItems(cache->items, n);
+        } else {
+            while (n > 0) {
+                n = flush(cache, n, std::min(n, kPoolBatch));
+            }
+        }
+        cache->count.store(0, std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(caches_mutex_);
+        caches_.erase(std::remove(caches_.begin(), caches_.end(), cache), caches_.end());
+        delete cache->spare;
+        delete cache;
+    }
+
+private:
+    DestroyFn destroy_;
+    std::atomic<size_t> max_items_;
+    const size_t local_capacity_;
+    std::atomic<PoolBatch*> head_;
+    std::atomic<size_t> depot_items_;
+    std::atomic<bool> closed_;
+
+    mutable std::mutex caches_mutex_;  // 只在线程首次使用本池、线程退出和 size() 时使用
+    std::vector<PoolLocalCache*> caches_;
+
+    PoolLocalCache* localCache() {
+        PoolThreadTable& table = poolThreadTable();
+        PoolLocalCache* cache = table.find(this);
+        if (cache) {
+            return cache;
+        }
+        table.remove(nullptr);
+        cache = new PoolLocalCache();
+        {
+            std::lock_guard<std::mutex> lock(caches_mutex_);
+            caches_.push_back(cache);
+        }
+        table.add(this, cache, shared_from_this());
+        return cache;
+    }
+
+    void destroyItems(void* const* items, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            destroy_(items[i]);
+        }
+    }
+
+    void pushChain(PoolBatch* first, PoolBatch* last) {
+        PoolBatch* head = head_.load(std::memory_order_relaxed);
+        do {
+            last->next = head;
+        } while (!head_.compare_exchange_weak(head, first, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    // 整体取走，留下第一批，其余压回
+    PoolBatch* popBatch() {
+        if (!head_.load(std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        PoolBatch* all = head_.exchange(nullptr, std::memory_order_acq_rel);
+        if (!all) {
+            return nullptr;
+        }
+        if (all->next) {
+            PoolBatch* last = all->next;
+            while (last->next) {
+                last = last->next;
+            }
+            pushChain(all->next, last);
+        }
+        all->next = nullptr;
+        return all;
+    }
+
+    size_t refill(PoolLocalCache* cache) {
+        PoolBatch* batch = popBatch();
+        if (!batch) {
+            return 0;
+        }
+        size_t n = batch->count;
+        depot_items_.fetch_sub(n, std::memory_order_relaxed);
+        std::memcpy(cache->items, batch->items, n * sizeof(void*));
+        cache->count.store(n, std::memory_order_relaxed);
+        if (!cache->spare) {
+            cache->spare = batch;
+        } else {
+            delete batch;
+        }
+        return n;
+    }
+
+    // 把最早放入的 count 个元素转入仓库（仓库已满时销毁），返回剩余个数
+    size_t flush(PoolLocalCache* cache, size_t n, size_t count) {
+        PoolBatch* batch = cache->spare ? cache->spare : new PoolBatch();
+        cache->spare = nullptr;
+        std::memcpy(batch->items, cache->items, count * sizeof(void*));
+        batch->count = count;
+        std::memmove(cache->items, cache->items + count, (n - count) * sizeof(void*));
+        cache->count.store(n - count, std::memory_order_relaxed);
+
+        if (depot_items_.load(std::memory_order_relaxed) + count > max_items_.load(std::memory_order_relaxed)) {
+            destroyItems(batch->items, count);
+            cache->spare = batch;
+        } else {
+            depot_items_.fetch_add(count, std::memory_order_relaxed);
+            pushChain(batch, batch);
+        }
+        return n - count;
+    }
+};
+
+inline PoolThreadTable::PoolThreadTable() : last_(0) {
+    alive() = true;
+}
+
+inline PoolThreadTable::~PoolThreadTable() {
+    alive() = false;
+    for (size_t i = 0; i < slots_.size(); ++i) {
+        slots_[i].owner->retire(slots_[i].cache);
+    }
+}
+
+inline void PoolThreadTable::remove(const PoolCore* core) {
+    for (size_t i = slots_.size(); i-- > 0;) {
+        if (core ? slots_[i].core == core : slots_[i].owner->closed()) {
+            Slot slot = slots_[i];
+            slots_.erase(slots_.begin() + static_cast<std::ptrdiff_t>(i));
+            slot.owner->retire(slot.cache);
+        }
+    }
+    last_ = 0;
+}
+
+} // namespace detail
+
+// ========== 对象池 ==========
+
+/**
+ * @brief 对象归还到池之前的复位操作
+ *
+ * 默认不做任何事；需要清空内容但保留容量的类型可以特化（如 HttpRequest）。
+ */
+template<typename T>
+struct PoolReset {
+    void operator()(T&) const {}
+};
+
+/**
+ * @brief 类型化对象池
+ *
+ * max_size() 约束全局仓库中的对象数，每个线程另外最多缓存 min(kPoolLocalCapacity, max_size()) 个。
+ * acquire() 返回的句柄析构时归还对象，句柄不能比池活得更久。
+ */
 template<typename T>
 class ObjectPool {
 public:
-    explicit ObjectPool(size_t initial_size = 10) 
-        : max_size_(initial_size * 10) {
-        std::lock_guard<std::mutex> lock(mutex_);
+    typedef std::unique_ptr<T, std::function<void(T*)>> Handle;
+
+    explicit ObjectPool(size_t initial_size = 10)
+        : core_(std::make_shared<detail::PoolCore>(&destroyObject, initial_size * 10, initial_size * 10)) {
+        std::vector<void*> items(initial_size);
         for (size_t i = 0; i < initial_size; ++i) {
-            pool_.push(std::unique_ptr<T>(new T()));
+            items[i] = new T();
         }
+        core_->seed(items.data(), items.size());
     }
-    
+
     ~ObjectPool() {
-        std::lock_guard<std::mutex> lock(mutex_);
-        while (!pool_.empty()) {
-            pool_.pop();
-        }
+        core_->close();
     }
-    
-    std::unique_ptr<T, std::function<void(T*)>> acquire() {
-        std::unique_ptr<T> obj;
-        {
-            std::lock_guard<std::mutex> lock(mutex_);
-            if (!pool_.empty()) {
-                obj = std::move(pool_.top());
-                pool_.pop();
-            } else {
-                obj = std::unique_ptr<T>(new T());
-            }
+
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    Handle acquire() {
+        T* obj = static_cast<T*>(core_->acquire());
+        if (!obj) {
+            obj = new T();
         }
-        
-        return std::unique_ptr<T, std::function<void(T*)>>(
-            obj.release(),
-            [this](T* ptr) {
-                this->release(ptr);
-            }
-        );
+        return Handle(obj, [this](T* ptr) { this->release(ptr); });
     }
-    
+
     size_t size() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return pool_.size();
+        return core_->size();
     }
-    
+
     size_t max_size() const {
-        return max_size_;
+        return core_->maxItems();
     }
-    
+
+    // 仓库中只保留 new_size 个，上限调整为 new_size * 10
     void resize(size_t new_size) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        while (pool_.size() > new_size && !pool_.empty()) {
-            pool_.pop();
-        }
-        max_size_ = new_size * 10;
+        core_->setMaxItems(new_size * 10);
+        core_->trim(new_size);
     }
-    
+
 private:
+    static void destroyObject(void* ptr) {
+        delete static_cast<T*>(ptr);
+    }
+
     void release(T* ptr) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        if (pool_.size() < max_size_) {
-            pool_.push(std::unique_ptr<T>(ptr));
-        } else {
-            delete ptr;
-        }
+        PoolReset<T>()(*ptr);
+        core_->release(ptr);
     }
-    
-    mutable std::mutex mutex_;
-    std::stack<std::unique_ptr<T>> pool_;
-    size_t max_size_;
+
+    std::shared_ptr<detail::PoolCore> core_;
 };
 
 template<typename T>
 class PoolAllocator {
 public:
     using value_type = T;
-    
+
     PoolAllocator(std::shared_ptr<ObjectPool<T>> pool)
         : pool_(pool) {}
-    
+
     template<typename U>
     PoolAllocator(const PoolAllocator<U>& other)
         : pool_(other.pool_) {}
-    
+
     T* allocate(size_t n) {
         if (n != 1) {
             return static_cast<T*>(::operator new(n * sizeof(T)));
@@ -102,7 +450,7 @@ public:
         allocated_.push_back(raw);
         return raw;
     }
-    
+
     void deallocate(T* p, size_t n) {
         if (n != 1) {
             ::operator delete(p);
@@ -113,62 +461,203 @@ public:
             allocated_.erase(it);
         }
     }
-    
+
 private:
     std::shared_ptr<ObjectPool<T>> pool_;
     std::deque<T*> allocated_;
 };
 
+// ========== 分级内存块 ==========
+
+/**
+ * @brief 按尺寸分级的内存块池：16、32、...、4096 字节共 9 级，更大的请求直接走 operator new
+ *
+ * 块至少按 16 字节对齐。deallocate 必须传入与 allocate 相同的尺寸。
+ */
+class SlabAllocator {
+public:
+    static const size_t kMinBlock = 16;
+    static const size_t kMaxBlock = 4096;
+    static const size_t kClassCount = 9;
+    static const size_t kChunkSize = 64 * 1024;
+
+    SlabAllocator() : reserved_(0) {
+        for (size_t i = 0; i < kClassCount; ++i) {
+            // 块随大块整体释放，单个块无需销毁；仓库不设上限
+            classes_[i] = std::make_shared<detail::PoolCore>(&keepBlock, SIZE_MAX / 2, detail::kPoolLocalCapacity);
+        }
+    }
+
+    ~SlabAllocator() {
+        for (size_t i = 0; i < kClassCount; ++i) {
+            classes_[i]->close();
+        }
+        for (size_t i = 0; i < chunks_.size(); ++i) {
+            ::operator delete(chunks_[i]);
+        }
+    }
+
+    SlabAllocator(const SlabAllocator&) = delete;
+    SlabAllocator& operator=(const SlabAllocator&) = delete;
+
+    static size_t classIndex(size_t size) {
+        size_t index = 0;
+        size_t block = kMinBlock;
+        while (block < size) {
+            block <<= 1;
+            index++;
+        }
+        return index;
+    }
+
+    static size_t blockSize(size_t index) { return kMinBlock << index; }
+
+    void* allocate(size_t size) {
+        if (size > kMaxBlock) {
+            return ::operator new(size);
+        }
+        size_t index = classIndex(size);
+        void* block = classes_[index]->acquire();
+        if (!block) {
+            carveChunk(index);
+            block = classes_[index]->acquire();
+        }
+        return block;
+    }
+
+    void deallocate(void* ptr, size_t size) {
+        if (!ptr) {
+            return;
+        }
+        if (size > kMaxBlock) {
+            ::operator delete(ptr);
+            return;
+        }
+        classes_[classIndex(size)]->release(ptr);
+    }
+
+    // 已向系统申请的字节数
+    size_t reservedBytes() const { return reserved_.load(std::memory_order_relaxed); }
+
+    // 某一级当前空闲的块数
+    size_t freeBlocks(size_t index) const { return classes_[index]->size(); }
+
+private:
+    std::shared_ptr<detail::PoolCore> classes_[kClassCount];
+    std::mutex chunks_mutex_;  // 只在申请新的大块时使用
+    std::vector<void*> chunks_;
+    std::atomic<size_t> reserved_;
+
+    static void keepBlock(void*) {}
+
+    void carveChunk(size_t index) {
+        char* chunk = static_cast<char*>(::operator new(kChunkSize));
+        {
+            std::lock_guard<std::mutex> lock(chunks_mutex_);
+            chunks_.push_back(chunk);
+        }
+        reserved_.fetch_add(kChunkSize, std::memory_order_relaxed);
+
+        size_t block = blockSize(index);
+        size_t count = kChunkSize / block;
+        std::vector<void*> blocks(count);
+        for (size_t i = 0; i < count; ++i) {
+            blocks[i] = chunk + i * block;
+        }
+        classes_[index]->seed(blocks.data(), count);
+    }
+};
+
+// ========== 池管理器 ==========
+
+/**
+ * @brief 按类型共享的对象池和全局分级内存块
+ *
+ * getPool 的结果缓存在线程本地，命中时只读一次代次计数，不取全局锁；clear() 使所有线程的缓存失效。
+ */
 class MemoryPoolManager {
 public:
     static MemoryPoolManager& instance() {
         static MemoryPoolManager manager;
         return manager;
     }
-    
+
     template<typename T>
     std::shared_ptr<ObjectPool<T>> getPool(size_t initial_size = 10) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        size_t type_hash = typeid(T).hash_code();
-        
-        auto it = pools_.find(type_hash);
-        if (it == pools_.end()) {
-            auto pool = std::shared_ptr<ObjectPool<T>>(new ObjectPool<T>(initial_size));
-            pools_[type_hash] = pool;
-            return pool;
-        }
-        
-        return std::static_pointer_cast<ObjectPool<T>>(it->second);
+        return localPool<T>(initial_size);
     }
-    
+
     template<typename T>
-    std::unique_ptr<T, std::function<void(T*)>> acquire() {
-        return getPool<T>()->acquire();
+    typename ObjectPool<T>::Handle acquire() {
+        return localPool<T>(10)->acquire();
+    }
+
+    void* allocate(size_t size) {
+        return slab_.allocate(size);
     }
-    
+
+    void deallocate(void* ptr, size_t size) {
+        slab_.deallocate(ptr, size);
+    }
+
+    SlabAllocator& slab() { return slab_; }
+
     void clear() {
         std::lock_guard<std::mutex> lock(mutex_);
         pools_.clear();
+        generation_.fetch_add(1, std::memory_order_release);
     }
-    
+
     size_t poolCount() const {
         std::lock_guard<std::mutex> lock(mutex_);
         return pools_.size();
     }
-    
+
 private:
-    MemoryPoolManager() {}
+    MemoryPoolManager() : generation_(1) {}
     ~MemoryPoolManager() {
         clear();
     }
-    
+
     MemoryPoolManager(const MemoryPoolManager&) = delete;
     MemoryPoolManager& operator=(const MemoryPoolManager&) = delete;
-    
-    mutable std::mutex mutex_;
+
+    template<typename T>
+    const std::shared_ptr<ObjectPool<T>>& localPool(size_t initial_size) {
+        struct Cached {
+            uint64_t generation;
+            std::shared_ptr<ObjectPool<T>> pool;
+        };
+        static thread_local Cached cached = { 0, std::shared_ptr<ObjectPool<T>>() };
+        uint64_t generation = generation_.load(std::memory_order_acquire);
+        if (cached.generation != generation || !cached.pool) {
+            cached.pool = lookup<T>(initial_size);
+            cached.generation = generation;
+        }
+        return cached.pool;
+    }
+
+    template<typename T>
+    std::shared_ptr<ObjectPool<T>> lookup(size_t initial_size) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        size_t type_hash = typeid(T).hash_code();
+
+        auto it = pools_.find(type_hash);
+        if (it == pools_.end()) {
+            auto pool = std::shared_ptr<ObjectPool<T>>(new ObjectPool<T>(initial_size));
+            pools_[type_hash] = pool;
+            return pool;
+        }
+
+        return std::static_pointer_cast<ObjectPool<T>>(it->second);
+    }
+
+    mutable std::mutex mutex_;  // 只在线程首次取某个类型的池和 clear() 时使用
     std::unordered_map<size_t, std::shared_ptr<void>> pools_;
+    std::atomic<uint64_t> generation_;
+    SlabAllocator slab_;
 };
 
-} 
+}
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,276 @@
+/**
+ * @file offload_pool.h
+ * @brief CPU 密集型处理器的有界工作窃取线程池
+ *
+ * - 每个工作线程一个任务队列；外部提交按轮转分散到各队列，池内线程提交时进入自己的队列
+ * - 空闲线程先取自己的队列，再按顺序从其他队列窃取，均按 FIFO 执行，排队时间可预期
+ * - 排队总数有上限，超出时 submit() 返回 false，由调用方立即拒绝（而不是无限堆积）
+ * - 排队深度与排队等待时间以 Prometheus 指标导出（uvapi_offload_queue_depth、
+ *   uvapi_offload_wait_seconds、uvapi_offload_rejected_total）
+ *
+ * 与 uv_queue_work 不同，线程数和队列上限独立配置，不与 libuv 的文件系统 / DNS 请求共用线程。
+ *
+ * @code
+ * api.offload(uvapi::offload::OffloadPolicy().threads(4).maxQueue(256));
+ * api.post("/reports")
+ *    .offload()
+ *    .handler([](const HttpRequest& req) { return renderReport(req); })
+ *    .register_();
+ * @endcode
+ */
+
+#ifndef UVAPI_OFFLOAD_POOL_H
+#define UVAPI_OFFLOAD_POOL_H
+
+#include "metrics.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace uvapi {
+namespace offload {
+
+// ========== 线程池配置 ==========
+
+struct OffloadPolicy {
+    size_t thread_count;  // 0 表示 CPU 核数
+    size_t max_queue;     // 排队上限（不含正在执行的任务）
+
+    OffloadPolicy() : thread_count(0), max_queue(1024) {}
+
+    OffloadPolicy& threads(size_t count) {
+        thread_count = count;
+        return *this;
+    }
+
+    OffloadPolicy& maxQueue(size_t count) {
+        max_queue = count < 1 ? 1 : count;
+        return *this;
+    }
+};
+
+struct OffloadStats {
+    uint64_t submitted;
+    uint64_t rejected;
+    uint64_t completed;
+    size_t queued;
+    size_t running;
+};
+
+// ========== 工作窃取线程池 ==========
+
+class WorkStealingPool {
+public:
+    typedef std::function<void()> Task;
+
+    explicit WorkStealingPool(const OffloadPolicy& policy = OffloadPolicy())
+        : max_queue_(policy.max_queue < 1 ? 1 : policy.max_queue)
+        , queued_(0)
+        , running_(0)
+        , next_(0)
+        , submitted_(0)
+        , completed_(0)
+        , stopping_(false)
+        , depth_(std::make_shared<metrics::Gauge>("uvapi_offload_queue_depth",
+                                                  "Tasks waiting in the offload pool"))
+        , wait_(std::make_shared<metrics::Histogram>("uvapi_offload_wait_seconds",
+                                                     "Time offloaded tasks spent queued before running",
+                                                     std::vector<double>{0.0001, 0.0005, 0.001, 0.005, 0.01,
+                                                                         0.05, 0.1, 0.5, 1.0, 5.0}))
+        , rejected_(std::make_shared<metrics::Counter>("uvapi_offload_rejected_total",
+                                                       "Tasks rejected because the offload queue was full")) {
+        size_t count = policy.thread_count;
+        if (count == 0) {
+            count = std::thread::hardware_concurrency();
+        }
+        if (count == 0) {
+            count = 1;
+        }
+        queues_.reserve(count);
+        for (size_t i = 0; i < count; i++) {
+            queues_.push_back(std::unique_ptr<Queue>(new Queue()));
+        }
+        threads_.reserve(count);
+        for (size_t i = 0; i < count; i++) {
+            threads_.push_back(std::thread(&WorkStealingPool::workerLoop, this, i));
+        }
+    }
+
+    // 停止并等待工作线程退出；仍在排队的任务直接销毁，不再执行
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+            stopping_.store(true);
+        }
+        wake_.notify_all();
+        for (size_t i = 0; i < threads_.size(); i++) {
+            threads_[i].join();
+        }
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    /**
+     * @brief 提交任务，可在任意线程调用
+     *
+     * 排队已满或池已停止时返回 false，任务不会执行。
+     */
+    bool submit(Task task) {
+        if (!task || stopping_.load()) {
+            return false;
+        }
+        if (queued_.fetch_add(1) >= max_queue_) {
+            queued_.fetch_sub(1);
+            rejected_->increment();
+            return false;
+        }
+        submitted_.fetch_add(1, std::memory_order_relaxed);
+        depth_->increment();
+
+        // 池内线程提交时进入自己的队列，其余轮转分散
+        size_t index = worker().pool == this ? worker().index
+                                             : next_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+        Queue& queue = *queues_[index];
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.items.push_back(Item(std::move(task)));
+        }
+        {
+            // 与等待方的条件检查串行化，避免丢失唤醒
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+        }
+        wake_.notify_one();
+        return true;
+    }
+
+    size_t threadCount() const { return threads_.size(); }
+    size_t maxQueue() const { return max_queue_; }
+    size_t queued() const { return queued_.load(); }
+
+    OffloadStats stats() const {
+        OffloadStats stats;
+        stats.submitted = submitted_.load(std::memory_order_relaxed);
+        stats.rejected = rejected_->value();
+        stats.completed = completed_.load(std::memory_order_relaxed);
+        stats.queued = queued_.load();
+        stats.running = running_.load();
+        return stats;
+    }
+
+    // 当前线程是否为本池的工作线程
+    bool onWorkerThread() const { return worker().pool == this; }
+
+    const std::shared_ptr<metrics::Histogram>& waitHistogram() const { return wait_; }
+
+    // 把排队深度、等待时间和拒绝次数注册到指标注册表
+    void registerMetrics(metrics::MetricRegistry& registry) const {
+        registry.registerMetric(depth_);
+        registry.registerMetric(wait_);
+        registry.registerMetric(rejected_);
+    }
+
+private:
+    struct Item {
+        Task task;
+        std::chrono::steady_clock::time_point enqueued;
+
+        Item() {}
+        explicit Item(Task t) : task(std::move(t)), enqueued(std::chrono::steady_clock::now()) {}
+    };
+
+    // 各队列单独分配并在末尾填充一个缓存行，相邻队列的锁不伪共享
+    //（C++11 的 new 不保证扩展对齐，不使用 alignas）
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Item> items;
+        char padding[64];
+    };
+
+    struct WorkerSlot {
+        const WorkStealingPool* pool;
+        size_t index;
+    };
+
+    static WorkerSlot& worker() {
+        static thread_local WorkerSlot slot = { nullptr, 0 };
+        return slot;
+    }
+
+    size_t max_queue_;
+    std::vector<std::unique_ptr<Queue> > queues_;
+    std::vector<std::thread> threads_;
+    std::atomic<size_t> queued_;
+    std::atomic<size_t> running_;
+    std::atomic<size_t> next_;
+    std::atomic<uint64_t> submitted_;
+    std::atomic<uint64_t> completed_;
+    std::atomic<bool> stopping_;
+    std::mutex sleep_mutex_;
+    std::condition_variable wake_;
+    std::shared_ptr<metrics::Gauge> depth_;
+    std::shared_ptr<metrics::Histogram> wait_;
+    std::shared_ptr<metrics::Counter> rejected_;
+
+    bool popFrom(size_t index, Item& out) {
+        Queue& queue = *queues_[index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.items.empty()) {
+            return false;
+        }
+        out = std::move(queue.items.front());
+        queue.items.pop_front();
+        return true;
+    }
+
+    // 先取自己的队列，再从其他队列窃取
+    bool take(size_t self, Item& out) {
+        size_t count = queues_.size();
+        for (size_t i = 0; i < count; i++) {
+            if (popFrom((self + i) % count, out)) {
+                queued_.fetch_sub(1);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void run(Item& item) {
+        std::chrono::duration<double> waited = std::chrono::steady_clock::now() - item.enqueued;
+        wait_->observe(waited.count());
+        depth_->decrement();
+        running_.fetch_add(1);
+        item.task();
+        running_.fetch_sub(1);
+        completed_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void workerLoop(size_t index) {
+        worker().pool = this;
+        worker().index = index;
+        while (!stopping_.load()) {
+            Item item;
+            if (take(index, item)) {
+                run(item);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleep_mutex_);
+            // 计数先于入队递增：看到非零但暂时取不到时重试，不会睡过已提交的任务
+            wake_.wait(lock, [this]() { return stopping_.load() || queued_.load() > 0; });
+        }
+    }
+};
+
+} // namespace offload
+} // namespace uvapi
+
+#endif // UVAPI_OFFLOAD_POOL_H
@@ -0,0 +1,148 @@
+/**
+ * @file pipeline.h
+ * @brief 扁平中间件流水线
+ *
+ * 两种形式：
+ * - BasicMiddlewarePipeline：启动时冻结为一个中间件数组，按下标游标推进。
+ *   每个中间件收到一个只含（流水线指针, 下标）的 Next 游标，调用它即进入下一级；
+ *   请求路径上不构造 std::function 闭包，也没有堆分配。
+ * - StaticPipeline<Request, Response, Stages...>：编译期展开的流水线，
+ *   最后一个类型是处理器，其余为中间件；各级之间没有间接调用，编译器可以完全内联。
+ *
+ * 中间件可以短路（不调用 next 直接返回响应），也可以多次调用 next（例如重试）。
+ *
+ * @code
+ * // 编译期形式：中间件提供模板化的 operator()，最后一级是处理器
+ * struct Auth {
+ *     template<typename Next>
+ *     HttpResponse operator()(const HttpRequest& req, const Next& next) const {
+ *         if (req.headers.find("Authorization") == req.headers.end()) {
+ *             return HttpResponse(401);
+ *         }
+ *         return next(req);
+ *     }
+ * };
+ * struct Hello {
+ *     HttpResponse operator()(const HttpRequest&) const { return HttpResponse(200, "hello"); }
+ * };
+ * api.get("/hello", uvapi::Pipeline<Auth, Hello>());
+ * @endcode
+ */
+
+#ifndef UVAPI_PIPELINE_H
+#define UVAPI_PIPELINE_H
+
+#include <cstddef>
+#include <functional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace uvapi {
+
+// ========== 运行期扁平流水线 ==========
+
+template<typename Request, typename Response>
+class BasicMiddlewarePipeline {
+public:
+    // 指向下一级的游标：按值传递，复制成本为两个字长
+    class Next {
+    public:
+        Response operator()(const Request& req) const {
+            return pipeline_->invoke(index_, req);
+        }
+
+        // 之后还有多少个中间件（不含处理器）
+        size_t remaining() const { return pipeline_->stages_.size() - index_; }
+
+    private:
+        friend class BasicMiddlewarePipeline;
+
+        Next(const BasicMiddlewarePipeline* pipeline, size_t index)
+            : pipeline_(pipeline), index_(index) {}
+
+        const BasicMiddlewarePipeline* pipeline_;
+        size_t index_;
+    };
+
+    typedef std::function<Response(const Request&, const Next&)> Stage;
+    typedef std::function<Response(const Request&)> Terminal;
+
+    BasicMiddlewarePipeline(std::vector<Stage> stages, Terminal terminal)
+        : stages_(std::move(stages)), terminal_(std::move(terminal)) {}
+
+    Response run(const Request& req) const { return invoke(0, req); }
+    Response operator()(const Request& req) const { return invoke(0, req); }
+
+    size_t size() const { return stages_.size(); }
+
+private:
+    std::vector<Stage> stages_;
+    Terminal terminal_;
+
+    Response invoke(size_t index, const Request& req) const {
+        if (index < stages_.size()) {
+            return stages_[index](req, Next(this, index + 1));
+        }
+        return terminal_(req);
+    }
+};
+
+// ========== 编译期流水线 ==========
+
+/**
+ * @brief 编译期展开的流水线
+ *
+ * Stages 中除最后一个外都是中间件，需提供
+ * `template<typename Next> Response operator()(const Request&, const Next&) const`；
+ * 最后一个是处理器，提供 `Response operator()(const Request&) const`。
+ * 自身也是一个处理器，可以直接注册为路由处理器，或作为另一条流水线的最后一级。
+ */
+template<typename Request, typename Response, typename... Stages>
+class StaticPipeline {
+    static_assert(sizeof...(Stages) > 0, "StaticPipeline requires at least a handler");
+
+public:
+    template<size_t I>
+    class Cursor {
+    public:
+        explicit Cursor(const StaticPipeline* pipeline) : pipeline_(pipeline) {}
+
+        Response operator()(const Request& req) const {
+            return pipeline_->template call<I>(req);
+        }
+
+    private:
+        const StaticPipeline* pipeline_;
+    };
+
+    StaticPipeline() {}
+
+    explicit StaticPipeline(Stages... stages) : stages_(std::move(stages)...) {}
+
+    Response operator()(const Request& req) const { return call<0>(req); }
+
+    // 访问某一级（例如读取中间件的配置）
+    template<size_t I>
+    const typename std::tuple_element<I, std::tuple<Stages...> >::type& stage() const {
+        return std::get<I>(stages_);
+    }
+
+private:
+    std::tuple<Stages...> stages_;
+
+    template<size_t I>
+    typename std::enable_if<(I + 1 < sizeof...(Stages)), Response>::type call(const Request& req) const {
+        return std::get<I>(stages_)(req, Cursor<I + 1>(this));
+    }
+
+    template<size_t I>
+    typename std::enable_if<(I + 1 == sizeof...(Stages)), Response>::type call(const Request& req) const {
+        return std::get<I>(stages_)(req);
+    }
+};
+
+} // namespace uvapi
+
+#endif // UVAPI_PIPELINE_H
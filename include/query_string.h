@@ -0,0 +1,172 @@
+/**
+ * @file query_string.h
+ * @brief 查询字符串的单遍解析与百分号解码
+ *
+ * - findSpecial()：SSE2（或 8 字节 SWAR）一次比较 16 / 8 个字节，跳过不含 '&' '=' '%' '+' 的片段
+ * - forEachParam()：单遍扫描切分参数，在扫描途中记录哪些键、值需要解码；
+ *   不含 '%' / '+' 的键值直接返回指向原文的切片，需要解码的写入调用方提供的缓冲区
+ * - 没有 '=' 的片段是值为空的参数（?debug&page=2 中的 debug），空片段和空键被跳过；
+ *   重复的键按出现顺序逐个回调，由调用方决定多值的存放方式
+ *
+ * 解码结果不会比原文长：缓冲区与原文等长，每个键值解码到与其在原文中相同的偏移处，互不重叠，
+ * 因此整个查询字符串最多只需要一次分配（通常来自请求 arena）。
+ */
+
+#ifndef UVAPI_QUERY_STRING_H
+#define UVAPI_QUERY_STRING_H
+
+#include "request_view.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace uvapi {
+namespace query {
+
+inline bool isSpecial(char c) {
+    return c == '&' || c == '=' || c == '%' || c == '+';
+}
+
+/**
+ * @brief 从 i 开始查找第一个 '&' '=' '%' '+'，没有时返回 n
+ */
+inline size_t findSpecial(const char* s, size_t i, size_t n) {
+#if defined(__SSE2__)
+    const __m128i amp = _mm_set1_epi8('&');
+    const __m128i eq = _mm_set1_epi8('=');
+    const __m128i pct = _mm_set1_epi8('%');
+    const __m128i plus = _mm_set1_epi8('+');
+    while (i + 16 <= n) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        __m128i hit = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, amp), _mm_cmpeq_epi8(chunk, eq)),
+                                   _mm_or_si128(_mm_cmpeq_epi8(chunk, pct), _mm_cmpeq_epi8(chunk, plus)));
+        int mask = _mm_movemask_epi8(hit);
+        if (mask != 0) {
+            return i + static_cast<size_t>(__builtin_ctz(static_cast<unsigned>(mask)));
+        }
+        i += 16;
+    }
+#else
+    const uint64_t kOnes = 0x0101010101010101ULL;
+    const uint64_t kHigh = 0x8080808080808080ULL;
+    while (i + 8 <= n) {
+        uint64_t word;
+        std::memcpy(&word, s + i, 8);
+        uint64_t amp = word ^ (kOnes * '&');
+        uint64_t eq = word ^ (kOnes * '=');
+        uint64_t pct = word ^ (kOnes * '%');
+        uint64_t plus = word ^ (kOnes * '+');
+        // 某个字节为 0 时对应的最高位被置位
+        uint64_t hit = ((amp - kOnes) & ~amp) | ((eq - kOnes) & ~eq) | ((pct - kOnes) & ~pct) | ((plus - kOnes) & ~plus);
+        if ((hit & kHigh) != 0) {
+            break;
+        }
+        i += 8;
+    }
+#endif
+    while (i < n && !isSpecial(s[i])) {
+        ++i;
+    }
+    return i;
+}
+
+inline int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+/**
+ * @brief 解码 application/x-www-form-urlencoded 片段：'+' 变空格，%XX 变对应字节
+ *
+ * 不完整或非十六进制的 % 序列按原样保留。out 可以与 in 相同（原地解码）。
+ * @return 解码后的长度（不超过 n）
+ */
+inline size_t decode(const char* in, size_t n, char* out) {
+    size_t w = 0;
+    for (size_t r = 0; r < n; ++r) {
+        char c = in[r];
+        if (c == '+') {
+            out[w++] = ' ';
+        } else if (c == '%' && r + 2 < n && hexValue(in[r + 1]) >= 0 && hexValue(in[r + 2]) >= 0) {
+            out[w++] = static_cast<char>(hexValue(in[r + 1]) * 16 + hexValue(in[r + 2]));
+            r += 2;
+        } else {
+            out[w++] = c;
+        }
+    }
+    return w;
+}
+
+/**
+ * @brief 单遍解析查询字符串（不含 '?'）
+ * @param scratch scratch(size) 返回至少 size 字节的可写缓冲区；只在第一次需要解码时调用一次，
+ *                返回 NULL 时该查询字符串不解码（切片保持原始编码）
+ * @param fn fn(const StringSlice& key, const StringSlice& value) 按出现顺序对每个参数调用
+ */
+template<typename Scratch, typename Fn>
+void forEachParam(const char* query, size_t size, Scratch scratch, Fn fn) {
+    if (!query || size == 0) {
+        return;
+    }
+    char* buffer = nullptr;
+    bool scratch_taken = false;
+
+    size_t start = 0;
+    size_t eq = SIZE_MAX;     // 当前片段第一个 '=' 的位置
+    bool key_encoded = false;
+    bool value_encoded = false;
+    for (size_t i = findSpecial(query, 0, size);; i = findSpecial(query, i + 1, size)) {
+        if (i < size && query[i] != '&') {
+            if (query[i] == '=') {
+                if (eq == SIZE_MAX) {
+                    eq = i;
+                }
+            } else if (eq == SIZE_MAX) {
+                key_encoded = true;
+            } else {
+                value_encoded = true;
+            }
+            continue;
+        }
+
+        // 片段结束（'&' 或末尾）
+        size_t key_end = eq == SIZE_MAX ? i : eq;
+        if (key_end > start) {
+            size_t value_start = eq == SIZE_MAX ? i : eq + 1;
+            if ((key_encoded || value_encoded) && !scratch_taken) {
+                scratch_taken = true;
+                buffer = scratch(size);
+            }
+            StringSlice key(query + start, key_end - start);
+            StringSlice value(query + value_start, i - value_start);
+            if (buffer && key_encoded) {
+                key.data = buffer + start;
+                key.size = decode(query + start, key_end - start, buffer + start);
+            }
+            if (buffer && value_encoded) {
+                value.data = buffer + value_start;
+                value.size = decode(query + value_start, i - value_start, buffer + value_start);
+            }
+            fn(key, value);
+        }
+        if (i >= size) {
+            break;
+        }
+        start = i + 1;
+        eq = SIZE_MAX;
+        key_encoded = false;
+        value_encoded = false;
+    }
+}
+
+} // namespace query
+} // namespace uvapi
+
+#endif // UVAPI_QUERY_STRING_H
@@ -3,6 +3,16 @@
  * @brief 连接限流功能
  * 
  * 提令牌桶算法实现，用于限制连接速率和并发数
+ *
+ * KeyedRateLimiter 按键（客户端 IP、API 令牌、路由）独立限流，适合在事件循环中调用：
+ * - 每个键一个 16 字节的 GCRA 单元（键哈希 + 理论到达时间），tryAcquire 只做一次 CAS，从不阻塞
+ * - 分片的开放寻址表：已有键的查找无锁，只有插入新键和回收空闲键时锁住所在分片
+ * - 空闲键由 sweep() 惰性回收（框架用 libuv 定时器周期调用）
+ *
+ * AdmissionController / AdmissionQueue 是事件循环里的并发准入控制：
+ * 超出并发上限的请求进入每个循环自己的有界 FIFO，排队超时或队列已满时返回 503，
+ * 全程只做原子计数，不在回调里等待条件变量。
+ * ConnectionLimiter 的带超时等待会阻塞调用线程，只适合在事件循环之外使用。
  */
 
 #ifndef RATE_LIMITER_H
@@ -10,7 +20,14 @@
 
 #include <atomic>
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
 #include <mutex>
+#include <random>
+#include <string>
+#include <vector>
 #include <condition_variable>
 
 namespace uvapi {
@@ -128,20 +145,35 @@ private:
 
 /**
  * @brief 滑动窗口限流器
+ *
+ * 时间戳存放在容量为 max_requests 的环形缓冲区中，按时间先后排列：
+ * 缓冲区满且最早的时间戳仍在窗口内时拒绝，否则覆盖最早的一个，每次调用 O(1)。
  */
 class SlidingWindow {
 private:
     std::vector<std::chrono::steady_clock::time_point> requests_;
+    mutable size_t head_;   // 最早的时间戳
+    mutable size_t count_;
     const uint64_t window_size_;  // 窗口大小（毫秒）
     const uint64_t max_requests_;  // 最大请求数
     mutable std::mutex mutex_;
 
+    // 调用方持有 mutex_：丢弃窗口外的时间戳
+    void expireLocked(std::chrono::steady_clock::time_point now) const {
+        auto cutoff = now - std::chrono::milliseconds(window_size_);
+        while (count_ > 0 && requests_[head_] < cutoff) {
+            head_ = (head_ + 1) % requests_.size();
+            count_--;
+        }
+    }
+
 public:
     SlidingWindow(uint64_t window_size_ms, uint64_t max_requests)
-        : window_size_(window_size_ms)
-        , max_requests_(max_requests) {
-        requests_.reserve(max_requests_);
-    }
+        : requests_(static_cast<size_t>(max_requests > 0 ? max_requests : 1))
+        , head_(0)
+        , count_(0)
+        , window_size_(window_size_ms)
+        , max_requests_(max_requests) {}
     
     /**
      * @brief 尝试通过限流
@@ -151,21 +183,13 @@ public:
         auto now = std::chrono::steady_clock::now();
         std::lock_guard<std::mutex> lock(mutex_);
         
-        // 移除窗口外的请求
-        auto cutoff = now - std::chrono::milliseconds(window_size_);
-        requests_.erase(
-            std::remove_if(requests_.begin(), requests_.end(),
-                [cutoff](const std::chrono::steady_clock::time_point& time) { return time < cutoff; }),
-            requests_.end()
-        );
-        
-        // 检查是否超过限制
-        if (requests_.size() >= max_requests_) {
+        expireLocked(now);
+        if (count_ >= max_requests_) {
             return false;
         }
         
-        // 添加当前请求
-        requests_.push_back(now);
+        requests_[(head_ + count_) % requests_.size()] = now;
+        count_++;
         return true;
     }
     
@@ -174,12 +198,16 @@ public:
      */
     uint64_t currentRequests() const {
         std::lock_guard<std::mutex> lock(mutex_);
-        return requests_.size();
+        expireLocked(std::chrono::steady_clock::now());
+        return count_;
     }
 };
 
 /**
  * @brief 并发连接数限制器
+ *
+ * tryAcquire(timeout_ms > 0) 会在条件变量上等待，不要在事件循环回调中使用；
+ * 请求级的并发控制见 AdmissionController。
  */
 class ConnectionLimiter {
 private:
@@ -201,7 +229,7 @@ public:
     bool tryAcquire(uint64_t timeout_ms = 0) {
         uint64_t current = current_connections_.load();
         
-        if (current < max_connections_) {
+        while (current < max_connections_) {
             if (current_connections_.compare_exchange_weak(current, current + 1)) {
                 return true;
             }
@@ -397,21 +425,538 @@ public:
     }
 };
 
+// ========== 按键限流 ==========
+
+/**
+ * @brief 限流键的来源
+ */
+enum class KeySource {
+    CLIENT_IP,  // 对端地址
+    HEADER,     // 指定请求头（如 X-API-Key）；请求未携带时退回对端地址
+    ROUTE       // 路由模式本身：整条路由共享一个配额
+};
+
+/**
+ * @brief 键表放不下新键时的处理方式
+ */
+enum class OverflowAction {
+    SHARED_BUCKET,  // 放不下的键按分片共用一个配额（默认）：轮换键值不能绕过限流
+    DENY,           // 直接拒绝
+    ALLOW           // 放行不限流（只适合键由服务端决定、不可能被客户端撑满的场景）
+};
+
+/**
+ * @brief 按键限流策略：每个键以 rate 个/秒补充，最多积攒 burst 个
+ */
+struct RateLimitPolicy {
+    double rate;
+    uint64_t burst;
+    KeySource key_source;
+    std::string header;
+    size_t max_keys;                          // 全部分片合计的键数上限
+    std::chrono::milliseconds idle_timeout;   // 恢复满额后再空闲这么久即可回收
+    OverflowAction overflow;                  // 键表满时的处理方式
+
+    RateLimitPolicy(double per_second, uint64_t burst_size)
+        : rate(per_second > 0 ? per_second : 1.0)
+        , burst(burst_size > 0 ? burst_size : 1)
+        , key_source(KeySource::CLIENT_IP)
+        , max_keys(1 << 20)
+        , idle_timeout(60000)
+        , overflow(OverflowAction::SHARED_BUCKET) {}
+
+    RateLimitPolicy& byClientIp() {
+        key_source = KeySource::CLIENT_IP;
+        return *this;
+    }
+
+    RateLimitPolicy& byHeader(const std::string& name) {
+        key_source = KeySource::HEADER;
+        header = name;
+        return *this;
+    }
+
+    RateLimitPolicy& byRoute() {
+        key_source = KeySource::ROUTE;
+        return *this;
+    }
+
+    RateLimitPolicy& maxKeys(size_t count) {
+        max_keys = count;
+        return *this;
+    }
+
+    RateLimitPolicy& idleTimeout(std::chrono::milliseconds timeout) {
+        idle_timeout = timeout;
+        return *this;
+    }
+
+    RateLimitPolicy& onOverflow(OverflowAction action) {
+        overflow = action;
+        return *this;
+    }
+};
+
+struct RateLimitDecision {
+    bool allowed;
+    uint64_t remaining;       // 通过后还可立即通过的请求数
+    uint64_t retry_after_ms;  // 拒绝时距离下一个可用配额的时间
+};
+
+/**
+ * @brief 按键 GCRA 限流器
+ *
+ * 每个键只保存理论到达时间（TAT）：请求在 max(TAT, now) + 间隔 - now <= burst * 间隔 时通过，
+ * 等价于容量为 burst、速率为 rate 的令牌桶。
+ *
+ * 表满（或单个分片满）时优先就地回收空闲键，仍然放不下则计入 overflows() 并按 policy.overflow 处理：
+ * 默认由该分片的共用配额判定（64 个分片，轮换键值最多获得 64 个键的配额），也可以直接拒绝或放行。
+ *
+ * 键哈希带有进程启动时随机生成的种子，客户端无法离线构造与其他客户端相同的键哈希。
+ */
+class KeyedRateLimiter {
+public:
+    explicit KeyedRateLimiter(const RateLimitPolicy& policy)
+        : policy_(policy)
+        , epoch_(std::chrono::steady_clock::now())
+        , overflows_(0) {
+        interval_ns_ = static_cast<uint64_t>(1e9 / policy_.rate);
+        if (interval_ns_ == 0) {
+            interval_ns_ = 1;
+        }
+        tolerance_ns_ = interval_ns_ * policy_.burst;
+        idle_ns_ = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(policy_.idle_timeout).count());
+
+        // 装载因子不超过 1/2
+        size_t per_shard = (policy_.max_keys * 2 + kShards - 1) / kShards;
+        size_t capacity = 16;
+        while (capacity < per_shard) {
+            capacity <<= 1;
+        }
+        for (size_t i = 0; i < kShards; ++i) {
+            shards_[i].init(capacity);
+        }
+        seed_ = hashSeed();
+    }
+
+    KeyedRateLimiter(const KeyedRateLimiter&) = delete;
+    KeyedRateLimiter& operator=(const KeyedRateLimiter&) = delete;
+
+    const RateLimitPolicy& policy() const { return policy_; }
+
+    // 自构造起的纳秒数（从 1 开始，0 表示单元未使用）
+    uint64_t now() const {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - epoch_).count()) + 1;
+    }
+
+    RateLimitDecision tryAcquire(const char* key, size_t size, uint64_t count = 1) {
+        return tryAcquireAt(key, size, now(), count);
+    }
+
+    RateLimitDecision tryAcquire(const std::string& key, uint64_t count = 1) {
+        return tryAcquireAt(key.data(), key.size(), now(), count);
+    }
+
+    // 以指定时刻判定（now_ns 取自 now()，测试中可直接给定）
+    RateLimitDecision tryAcquireAt(const char* key, size_t size, uint64_t now_ns, uint64_t count = 1) {
+        uint64_t hash = hashKey(seed_, key, size);
+        Shard& shard = shards_[hash >> (64 - kShardBits)];
+        Cell* cell = shard.find(hash);
+        if (!cell) {
+            cell = insert(shard, hash, now_ns);
+            if (!cell) {
+                overflows_.fetch_add(1, std::memory_order_relaxed);
+                if (policy_.overflow == OverflowAction::ALLOW) {
+                    RateLimitDecision open = { true, policy_.burst, 0 };
+                    return open;
+                }
+                if (policy_.overflow == OverflowAction::DENY) {
+                    RateLimitDecision denied = { false, 0, (interval_ns_ + 999999) / 1000000 };
+                    return denied;
+                }
+                cell = &shard.overflow;
+            }
+        }
+        return acquire(*cell, now_ns, count);
+    }
+
+    /**
+     * @brief 回收空闲键：TAT + idle_timeout 早于当前时刻的键
+     * @return 回收的键数
+     */
+    size_t sweep() { return sweepAt(now()); }
+
+    size_t sweepAt(uint64_t now_ns) {
+        size_t reclaimed = 0;
+        for (size_t i = 0; i < kShards; ++i) {
+            std::lock_guard<std::mutex> lock(shards_[i].mutex);
+            reclaimed += sweepLocked(shards_[i], now_ns);
+        }
+        return reclaimed;
+    }
+
+    size_t size() const {
+        size_t total = 0;
+        for (size_t i = 0; i < kShards; ++i) {
+            total += shards_[i].used.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    uint64_t overflows() const { return overflows_.load(std::memory_order_relaxed); }
+
+private:
+    static const int kShardBits = 6;
+    static const size_t kShards = static_cast<size_t>(1) << kShardBits;
+    static const size_t kMaxProbe = 64;
+    static const uint64_t kEmpty = 0;
+    static const uint64_t kTombstone = 1;
+
+    struct Cell {
+        std::atomic<uint64_t> key;  // 键哈希；kEmpty / kTombstone 为保留值
+        std::atomic<uint64_t> tat;  // 理论到达时间，0 表示满额
+    };
+
+    struct Shard {
+        std::unique_ptr<Cell[]> cells;
+        size_t mask;
+        size_t max_used;
+        std::atomic<size_t> used;
+        Cell overflow;     // 放不下的键共用的配额（OverflowAction::SHARED_BUCKET）
+        std::mutex mutex;  // 只在插入和回收时使用
+        char padding[64];
+
+        Shard() : mask(0), max_used(0), used(0) {}
+
+        void init(size_t capacity) {
+            overflow.key.store(kEmpty, std::memory_order_relaxed);
+            overflow.tat.store(0, std::memory_order_relaxed);
+            cells.reset(new Cell[capacity]);
+            for (size_t i = 0; i < capacity; ++i) {
+                cells[i].key.store(kEmpty, std::memory_order_relaxed);
+                cells[i].tat.store(0, std::memory_order_relaxed);
+            }
+            mask = capacity - 1;
+            max_used = capacity / 2;
+        }
+
+        // 无锁查找：跳过墓碑，遇到空槽停止
+        Cell* find(uint64_t hash) {
+            size_t index = static_cast<size_t>(hash) & mask;
+            for (size_t probe = 0; probe < kMaxProbe && probe <= mask; ++probe) {
+                Cell& cell = cells[(index + probe) & mask];
+                uint64_t key = cell.key.load(std::memory_order_acquire);
+                if (key == hash) {
+                    return &cell;
+                }
+                if (key == kEmpty) {
+                    return nullptr;
+                }
+            }
+            return nullptr;
+        }
+    };
+
+    RateLimitPolicy policy_;
+    std::chrono::steady_clock::time_point epoch_;
+    uint64_t interval_ns_;
+    uint64_t tolerance_ns_;
+    uint64_t idle_ns_;
+    uint64_t seed_;
+    std::atomic<uint64_t> overflows_;
+    Shard shards_[kShards];
+
+    // FNV-1a 以种子为初始状态，splitmix64 终结步骤再混入种子：让高位（选分片）和低位（选槽）都充分混合
+    static uint64_t hashKey(uint64_t seed, const char* key, size_t size) {
+        uint64_t h = 14695981039346656037ULL ^ seed;
+        for (size_t i = 0; i < size; ++i) {
+            h ^= static_cast<unsigned char>(key[i]);
+            h *= 1099511628211ULL;
+        }
+        h ^= seed >> 17;
+        h ^= h >> 30;
+        h *= 0xbf58476d1ce4e5b9ULL;
+        h ^= h >> 27;
+        h *= 0x94d049bb133111ebULL;
+        h ^= h >> 31;
+        return h < 2 ? h + 2 : h;
+    }
+
+    // 每个进程一个随机种子（random_device 之外再混入时钟与栈地址）
+    static uint64_t hashSeed() {
+        static const uint64_t seed = []() {
+            std::random_device device;
+            uint64_t value = (static_cast<uint64_t>(device()) << 32) ^ device();
+            int local = 0;
+            value ^= static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+            value ^= static_cast<uint64_t>(reinterpret_cast<uintptr_t>(&local)) << 7;
+            return value;
+        }();
+        return seed;
+    }
+
+    // GCRA 判定：CAS 更新单元的 TAT
+    RateLimitDecision acquire(Cell& cell, uint64_t now_ns, uint64_t count) {
+        uint64_t cost = interval_ns_ * count;
+        uint64_t tat = cell.tat.load(std::memory_order_relaxed);
+        for (;;) {
+            uint64_t base = tat > now_ns ? tat : now_ns;
+            uint64_t next = base + cost;
+            if (next - now_ns > tolerance_ns_) {
+                uint64_t wait_ns = next - now_ns - tolerance_ns_;
+                RateLimitDecision denied = { false, 0, (wait_ns + 999999) / 1000000 };
+                return denied;
+            }
+            if (cell.tat.compare_exchange_weak(tat, next, std::memory_order_relaxed)) {
+                RateLimitDecision allowed = { true, (tolerance_ns_ - (next - now_ns)) / interval_ns_, 0 };
+                return allowed;
+            }
+        }
+    }
+
+    Cell* insert(Shard& shard, uint64_t hash, uint64_t now_ns) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (shard.used.load(std::memory_order_relaxed) >= shard.max_used) {
+            sweepLocked(shard, now_ns);
+        }
+        for (int attempt = 0; attempt < 2; ++attempt) {
+            size_t index = static_cast<size_t>(hash) & shard.mask;
+            Cell* slot = nullptr;
+            for (size_t probe = 0; probe < kMaxProbe && probe <= shard.mask; ++probe) {
+                Cell& cell = shard.cells[(index + probe) & shard.mask];
+                uint64_t key = cell.key.load(std::memory_order_relaxed);
+                if (key == hash) {
+                    return &cell;  // 无锁查找之后由其他线程插入
+                }
+                if (key == kTombstone && !slot) {
+                    slot = &cell;
+                } else if (key == kEmpty) {
+                    if (!slot) {
+                        slot = &cell;
+                    }
+                    break;
+                }
+            }
+            if (slot && shard.used.load(std::memory_order_relaxed) < shard.max_used) {
+                slot->tat.store(0, std::memory_order_relaxed);
+                slot->key.store(hash, std::memory_order_release);
+                shard.used.fetch_add(1, std::memory_order_relaxed);
+                return slot;
+            }
+            if (attempt == 0 && sweepLocked(shard, now_ns) == 0) {
+                break;
+            }
+        }
+        return nullptr;
+    }
+
+    // 调用方持有分片锁
+    size_t sweepLocked(Shard& shard, uint64_t now_ns) {
+        size_t reclaimed = 0;
+        for (size_t i = 0; i <= shard.mask; ++i) {
+            Cell& cell = shard.cells[i];
+            uint64_t key = cell.key.load(std::memory_order_relaxed);
+            if (key == kEmpty || key == kTombstone) {
+                continue;
+            }
+            uint64_t tat = cell.tat.load(std::memory_order_relaxed);
+            if (tat + idle_ns_ >= now_ns) {
+                continue;
+            }
+            // 先清零 TAT：并发的 tryAcquire 的 CAS 随之失败并按满额重试，不会把旧状态写回
+            if (!cell.tat.compare_exchange_strong(tat, 0, std::memory_order_relaxed)) {
+                continue;
+            }
+            cell.key.store(kTombstone, std::memory_order_release);
+            shard.used.fetch_sub(1, std::memory_order_relaxed);
+            reclaimed++;
+        }
+        // 后继为空槽的墓碑可以还原为空槽（不会截断其他键的探测链）
+        bool changed = reclaimed > 0;
+        while (changed) {
+            changed = false;
+            for (size_t i = shard.mask + 1; i-- > 0;) {
+                if (shard.cells[i].key.load(std::memory_order_relaxed) == kTombstone &&
+                    shard.cells[(i + 1) & shard.mask].key.load(std::memory_order_relaxed) == kEmpty) {
+                    shard.cells[i].key.store(kEmpty, std::memory_order_release);
+                    changed = true;
+                }
+            }
+        }
+        return reclaimed;
+    }
+};
+
+// ========== 事件循环准入控制 ==========
+
+/**
+ * @brief 并发准入策略
+ */
+struct AdmissionPolicy {
+    uint64_t max_in_flight;                  // 全部工作线程合计的并发请求上限
+    size_t max_queue;                        // 每个事件循环的排队上限，0 表示不排队直接 503
+    std::chrono::milliseconds queue_timeout; // 排队超过这个时间返回 503
+    uint64_t retry_after_seconds;            // 503 响应的 Retry-After
+
+    explicit AdmissionPolicy(uint64_t limit)
+        : max_in_flight(limit > 0 ? limit : 1)
+        , max_queue(1024)
+        , queue_timeout(1000)
+        , retry_after_seconds(1) {}
+
+    AdmissionPolicy& maxQueue(size_t count) {
+        max_queue = count;
+        return *this;
+    }
+
+    AdmissionPolicy& queueTimeout(std::chrono::milliseconds timeout) {
+        queue_timeout = timeout;
+        return *this;
+    }
+
+    AdmissionPolicy& retryAfter(uint64_t seconds) {
+        retry_after_seconds = seconds;
+        return *this;
+    }
+};
+
+struct AdmissionStats {
+    uint64_t in_flight;  // 本循环正在处理的请求
+    uint64_t queued;     // 本循环排队中的请求
+    uint64_t rejected;   // 队列已满直接返回 503
+    uint64_t timed_out;  // 排队超时返回 503
+};
+
+/**
+ * @brief 全局并发配额：所有工作线程共享，只做原子计数，从不阻塞
+ */
+class AdmissionController {
+public:
+    explicit AdmissionController(const AdmissionPolicy& policy) : policy_(policy), in_flight_(0) {}
+
+    AdmissionController(const AdmissionController&) = delete;
+    AdmissionController& operator=(const AdmissionController&) = delete;
+
+    const AdmissionPolicy& policy() const { return policy_; }
+
+    bool tryAcquire() {
+        uint64_t current = in_flight_.load(std::memory_order_relaxed);
+        while (current < policy_.max_in_flight) {
+            if (in_flight_.compare_exchange_weak(current, current + 1, std::memory_order_acquire)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void release() {
+        in_flight_.fetch_sub(1, std::memory_order_release);
+    }
+
+    uint64_t inFlight() const { return in_flight_.load(std::memory_order_relaxed); }
+
+private:
+    AdmissionPolicy policy_;
+    std::atomic<uint64_t> in_flight_;
+};
+
+/**
+ * @brief 单个事件循环的有界 FIFO 和计数
+ *
+ * 队列只在所属循环线程上读写；计数是原子变量，可以从任意线程读取（stats()）。
+ */
+template<typename T>
+class AdmissionQueue {
+public:
+    explicit AdmissionQueue(size_t capacity)
+        : slots_(capacity), head_(0), count_(0)
+        , in_flight_(0), queued_(0), rejected_(0), timed_out_(0) {}
+
+    size_t capacity() const { return slots_.size(); }
+    size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+
+    /**
+     * @brief 入队；队列已满时返回 false 并计入 rejected
+     * @param deadline 排队截止时刻（与调用方的时钟一致，如 uv_now()）
+     */
+    bool push(const T& item, uint64_t deadline) {
+        if (count_ >= slots_.size()) {
+            rejected_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        Slot& slot = slots_[(head_ + count_) % slots_.size()];
+        slot.item = item;
+        slot.deadline = deadline;
+        count_++;
+        queued_.store(count_, std::memory_order_relaxed);
+        return true;
+    }
+
+    const T& front() const { return slots_[head_].item; }
+    uint64_t frontDeadline() const { return slots_[head_].deadline; }
+
+    void pop() {
+        slots_[head_].item = T();  // 释放条目持有的资源，不等到槽位被覆盖
+        head_ = (head_ + 1) % slots_.size();
+        count_--;
+        queued_.store(count_, std::memory_order_relaxed);
+    }
+
+    void noteStarted() { in_flight_.fetch_add(1, std::memory_order_relaxed); }
+    void noteFinished() { in_flight_.fetch_sub(1, std::memory_order_relaxed); }
+    void noteRejected() { rejected_.fetch_add(1, std::memory_order_relaxed); }
+    void noteTimedOut() { timed_out_.fetch_add(1, std::memory_order_relaxed); }
+
+    AdmissionStats stats() const {
+        AdmissionStats out;
+        out.in_flight = in_flight_.load(std::memory_order_relaxed);
+        out.queued = queued_.load(std::memory_order_relaxed);
+        out.rejected = rejected_.load(std::memory_order_relaxed);
+        out.timed_out = timed_out_.load(std::memory_order_relaxed);
+        return out;
+    }
+
+private:
+    struct Slot {
+        T item;
+        uint64_t deadline;
+        Slot() : item(), deadline(0) {}
+    };
+
+    std::vector<Slot> slots_;
+    size_t head_;
+    size_t count_;
+    std::atomic<uint64_t> in_flight_;
+    std::atomic<uint64_t> queued_;
+    std::atomic<uint64_t> rejected_;
+    std::atomic<uint64_t> timed_out_;
+};
+
 // ========== RAII 连接管理器 ==========
 
+/**
+ * @brief 作用域内占用一个连接配额
+ *
+ * 默认不等待：配额用尽时 acquired() 为 false，由调用方返回 503。
+ * 只有在事件循环之外（如工作线程）才应传入大于 0 的 timeout_ms。
+ */
 class ConnectionGuard {
 private:
-    RateLimiter& limiter_;
+    RateLimiter* limiter_;  // 指针而非引用，移动赋值时可以重新绑定
     bool acquired_;
     
 public:
-    ConnectionGuard(RateLimiter& limiter) : limiter_(limiter), acquired_(false) {
-        acquired_ = limiter_.acquireConnection();
+    explicit ConnectionGuard(RateLimiter& limiter, uint64_t timeout_ms = 0)
+        : limiter_(&limiter), acquired_(false) {
+        acquired_ = limiter_->acquireConnection(timeout_ms);
     }
     
     ~ConnectionGuard() {
         if (acquired_) {
-            limiter_.releaseConnection();
+            limiter_->releaseConnection();
         }
     }
     
@@ -430,7 +975,7 @@ public:
     ConnectionGuard& operator=(ConnectionGuard&& other) noexcept {
         if (this != &other) {
             if (acquired_) {
-                limiter_.releaseConnection();
+                limiter_->releaseConnection();
             }
             limiter_ = other.limiter_;
             acquired_ = other.acquired_;
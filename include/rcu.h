@@ -0,0 +1,250 @@
+/**
+ * @file rcu.h
+ * @brief 读多写少的只读快照发布：原子指针切换 + 按纪元回收
+ *
+ * - 写方在旁边构建完整的新快照，publish() 一次原子存储替换当前版本，旧版本挂入待回收列表
+ * - 读方（每个事件循环一个 Reader 槽位）用 ReadGuard 进入读区：宣告当前纪元、读取指针，
+ *   期间不加锁、不修改引用计数；离开时清除宣告
+ * - 旧版本在所有读者都离开了它被替换之前的纪元后释放（由 publish() 或最后离开的读者执行）；
+ *   需要跨回调使用快照的读者（如排队中的请求）在读区内调用 retain() 取得引用计数持有
+ *
+ * @code
+ * uvapi::rcu::Cell<Table> cell(std::make_shared<Table>());
+ * uvapi::rcu::Cell<Table>::Reader* reader = cell.attach();  // 读者线程各一个
+ * {
+ *     uvapi::rcu::Cell<Table>::ReadGuard table(cell, reader);
+ *     table->lookup(key);
+ * }
+ * cell.publish(std::make_shared<Table>(next));  // 任意线程
+ * @endcode
+ */
+
+#ifndef UVAPI_RCU_H
+#define UVAPI_RCU_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace uvapi {
+namespace rcu {
+
+template<typename T>
+class Cell {
+private:
+    struct Node {
+        std::shared_ptr<const T> value;
+        uint64_t version;
+        uint64_t retired_epoch;  // 被替换时的纪元，读者宣告的纪元都不小于它后可以释放
+    };
+
+public:
+    // 读者槽位：只由所属线程进入和离开读区，写方扫描
+    class Reader {
+    public:
+        Reader() : epoch_(0), in_use_(false) {}
+
+    private:
+        friend class Cell;
+        std::atomic<uint64_t> epoch_;  // 0 表示不在读区
+        bool in_use_;                  // 受 Cell 的互斥锁保护
+    };
+
+    /**
+     * @brief 读区：构造时取得当前快照，析构前快照不会被释放
+     *
+     * 可以嵌套（内层沿用外层的宣告）；不能跨线程，也不应跨越事件循环的回调。
+     */
+    class ReadGuard {
+    public:
+        ReadGuard(Cell& cell, Reader* reader)
+            : cell_(cell), reader_(reader), outer_(reader->epoch_.load(std::memory_order_relaxed) == 0) {
+            // 宣告与读取指针都是顺序一致的：写方扫描时看不到宣告，说明这里一定读到了新指针
+            if (outer_) {
+                reader_->epoch_.store(cell_.epoch_.load());
+            }
+            node_ = cell_.current_.load();
+        }
+
+        ~ReadGuard() {
+            if (!outer_) {
+                return;
+            }
+            reader_->epoch_.store(0, std::memory_order_release);
+            if (cell_.retired_count_.load(std::memory_order_relaxed) > 0) {
+                cell_.tryReclaim();
+            }
+        }
+
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+
+        const T& operator*() const { return *node_->value; }
+        const T* operator->() const { return node_->value.get(); }
+        const T* get() const { return node_->value.get(); }
+        uint64_t version() const { return node_->version; }
+
+        // 在读区之外继续使用快照（引用计数持有，不阻塞回收其他版本）
+        std::shared_ptr<const T> retain() const { return node_->value; }
+
+    private:
+        Cell& cell_;
+        Reader* reader_;
+        bool outer_;
+        const Node* node_;
+    };
+
+    explicit Cell(std::shared_ptr<const T> initial)
+        : current_(new Node()), epoch_(1), retired_count_(0) {
+        Node* node = current_.load(std::memory_order_relaxed);
+        node->value = std::move(initial);
+        node->version = 1;
+        node->retired_epoch = 0;
+    }
+
+    // 析构时不能再有读者处于读区
+    ~Cell() {
+        delete current_.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < retired_.size(); i++) {
+            delete retired_[i];
+        }
+    }
+
+    Cell(const Cell&) = delete;
+    Cell& operator=(const Cell&) = delete;
+
+    // 为一个读者线程分配槽位；槽位直到 detach 之前有效
+    Reader* attach() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (size_t i = 0; i < readers_.size(); i++) {
+            if (!readers_[i]->in_use_) {
+                readers_[i]->in_use_ = true;
+                return readers_[i].get();
+            }
+        }
+        readers_.push_back(std::unique_ptr<Reader>(new Reader()));
+        readers_.back()->in_use_ = true;
+        return readers_.back().get();
+    }
+
+    // 读者不在读区时调用；槽位留给之后的 attach 复用
+    void detach(Reader* reader) {
+        if (!reader) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        reader->in_use_ = false;
+    }
+
+    /**
+     * @brief 替换当前快照（任意线程，写方之间互斥）
+     * @return 新版本号
+     */
+    uint64_t publish(std::shared_ptr<const T> value) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        swapLocked(std::move(value));
+        reclaimLocked();
+        return current_.load(std::memory_order_relaxed)->version;
+    }
+
+    /**
+     * @brief 按当前快照决定是否替换：build(const T& current) 返回新快照，返回空指针表示不替换
+     *
+     * build 在写锁内执行，同时到达的多个写方只有一个会构建。
+     * @return 是否替换
+     */
+    template<typename Build>
+    bool update(Build build) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::shared_ptr<const T> next = build(*current_.load(std::memory_order_relaxed)->value);
+        if (!next) {
+            return false;
+        }
+        swapLocked(std::move(next));
+        reclaimLocked();
+        return true;
+    }
+
+    // 非读者线程取得当前快照（加锁并增加引用计数）
+    std::shared_ptr<const T> load() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return current_.load(std::memory_order_relaxed)->value;
+    }
+
+    uint64_t version() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return current_.load(std::memory_order_relaxed)->version;
+    }
+
+    // 已替换、仍在等待读者离开的版本数
+    size_t retired() const { return retired_count_.load(std::memory_order_relaxed); }
+
+    // 释放所有读者都已离开的旧版本，返回释放的个数
+    size_t reclaim() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return reclaimLocked();
+    }
+
+private:
+    std::atomic<Node*> current_;
+    std::atomic<uint64_t> epoch_;  // 每次替换加一
+    std::atomic<size_t> retired_count_;
+    std::vector<Node*> retired_;
+    std::vector<std::unique_ptr<Reader> > readers_;  // 地址稳定，读者直接持有指针
+    mutable std::mutex mutex_;
+
+    // 读者离开读区时顺带回收；其他线程持有锁时跳过，留给下一个读者或写方
+    void tryReclaim() {
+        std::unique_lock<std::mutex> lock(mutex_, std::try_to_lock);
+        if (lock.owns_lock()) {
+            reclaimLocked();
+        }
+    }
+
+    void swapLocked(std::shared_ptr<const T> value) {
+        Node* previous = current_.load(std::memory_order_relaxed);
+        Node* node = new Node();
+        node->value = std::move(value);
+        node->version = previous->version + 1;
+        node->retired_epoch = 0;
+        current_.store(node);
+        // 先换指针再推进纪元：宣告了新纪元的读者一定读到新指针
+        previous->retired_epoch = epoch_.fetch_add(1) + 1;
+        retired_.push_back(previous);
+        retired_count_.store(retired_.size(), std::memory_order_relaxed);
+    }
+
+    size_t reclaimLocked() {
+        if (retired_.empty()) {
+            return 0;
+        }
+        uint64_t oldest = UINT64_MAX;
+        for (size_t i = 0; i < readers_.size(); i++) {
+            uint64_t epoch = readers_[i]->epoch_.load();
+            if (epoch != 0 && epoch < oldest) {
+                oldest = epoch;
+            }
+        }
+        size_t freed = 0;
+        size_t kept = 0;
+        for (size_t i = 0; i < retired_.size(); i++) {
+            if (retired_[i]->retired_epoch <= oldest) {
+                delete retired_[i];
+                freed++;
+            } else {
+                retired_[kept++] = retired_[i];
+            }
+        }
+        retired_.resize(kept);
+        retired_count_.store(kept, std::memory_order_relaxed);
+        return freed;
+    }
+};
+
+} // namespace rcu
+} // namespace uvapi
+
+#endif // UVAPI_RCU_H
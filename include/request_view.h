@@ -0,0 +1,266 @@
+/**
+ * @file request_view.h
+ * @brief 零拷贝请求视图的基础类型
+ *
+ * - StringSlice：指向外部缓冲区的只读切片（C++11 下的 string_view 替代）
+ * - detail::SmallVector：前 N 个元素内联存储，超出后才使用堆
+ * - SliceMap：扁平键值切片表，支持写时叠加（overlay）默认值
+ *
+ * 切片不拥有内存，生命周期不得超过其指向的缓冲区（通常是 uvhttp 解析缓冲区，
+ * 仅在请求回调期间有效）。需要保留数据时请调用 toString()。
+ */
+
+#ifndef UVAPI_REQUEST_VIEW_H
+#define UVAPI_REQUEST_VIEW_H
+
+#include "uvapi_allocator.h"
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace uvapi {
+
+// ========== 字符串切片 ==========
+
+struct StringSlice {
+    const char* data;
+    size_t size;
+
+    StringSlice() : data(nullptr), size(0) {}
+    StringSlice(const char* d, size_t n) : data(d), size(n) {}
+    StringSlice(const char* s) : data(s), size(s ? std::strlen(s) : 0) {}
+    StringSlice(const std::string& s) : data(s.data()), size(s.size()) {}
+
+    // 是否指向有效数据（区分“不存在”和“空值”）
+    bool valid() const { return data != nullptr; }
+    bool empty() const { return size == 0; }
+
+    std::string toString() const {
+        return data ? std::string(data, size) : std::string();
+    }
+
+    bool equals(const char* s, size_t n) const {
+        return size == n && (n == 0 || std::memcmp(data, s, n) == 0);
+    }
+
+    bool equalsIgnoreCase(const char* s, size_t n) const {
+        if (size != n) {
+            return false;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            char a = data[i];
+            char b = s[i];
+            if (a >= 'A' && a <= 'Z') a = static_cast<char>(a + ('a' - 'A'));
+            if (b >= 'A' && b <= 'Z') b = static_cast<char>(b + ('a' - 'A'));
+            if (a != b) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool operator==(const StringSlice& other) const { return equals(other.data, other.size); }
+    bool operator!=(const StringSlice& other) const { return !equals(other.data, other.size); }
+};
+
+namespace detail {
+
+// ========== 小容量向量 ==========
+
+template<typename T, size_t N>
+class SmallVector {
+public:
+    SmallVector() : size_(0) {}
+
+    void push_back(const T& value) {
+        if (size_ < N) {
+            inline_[size_] = value;
+        } else {
+            heap_.push_back(value);
+        }
+        ++size_;
+    }
+
+    T& operator[](size_t i) { return i < N ? inline_[i] : heap_[i - N]; }
+    const T& operator[](size_t i) const { return i < N ? inline_[i] : heap_[i - N]; }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    void clear() {
+        size_ = 0;
+        heap_.clear();
+    }
+
+private:
+    T inline_[N];
+    size_t size_;
+    std::vector<T, RequestAllocator<T> > heap_;  // 溢出部分：请求期间从活动 arena 分配
+};
+
+} // namespace detail
+
+// ========== 键值切片表 ==========
+
+struct SlicePair {
+    StringSlice key;
+    StringSlice value;
+};
+
+/**
+ * @brief 扁平键值切片表
+ *
+ * 查找顺序：overlay → 自身条目 → base。overlay 只保存切片，
+ * 默认值可以直接指向路由注册时持有的字符串，因此叠加过程同样不分配内存。
+ */
+class SliceMap {
+public:
+    SliceMap() : base_(nullptr) {}
+    explicit SliceMap(const SliceMap* base) : base_(base) {}
+
+    void add(const StringSlice& key, const StringSlice& value) {
+        SlicePair pair = { key, value };
+        entries_.push_back(pair);
+    }
+
+    // 覆盖值（写入 overlay，不修改底层缓冲区）
+    void set(const StringSlice& key, const StringSlice& value) {
+        for (size_t i = 0; i < overlay_.size(); ++i) {
+            if (overlay_[i].key == key) {
+                overlay_[i].value = value;
+                return;
+            }
+        }
+        SlicePair pair = { key, value };
+        overlay_.push_back(pair);
+    }
+
+    // 仅当键不存在或值为空时写入默认值
+    void setDefault(const StringSlice& key, const StringSlice& value) {
+        StringSlice current = get(key);
+        if (!current.valid() || current.empty()) {
+            set(key, value);
+        }
+    }
+
+    StringSlice get(const StringSlice& key) const {
+        for (size_t i = 0; i < overlay_.size(); ++i) {
+            if (overlay_[i].key == key) {
+                return overlay_[i].value;
+            }
+        }
+        for (size_t i = 0; i < entries_.size(); ++i) {
+            if (entries_[i].key == key) {
+                return entries_[i].value;
+            }
+        }
+        return base_ ? base_->get(key) : StringSlice();
+    }
+
+    // HTTP 头名称大小写不敏感；键与条目指向同一驻留名称时直接命中
+    StringSlice getIgnoreCase(const StringSlice& key) const {
+        for (size_t i = 0; i < overlay_.size(); ++i) {
+            if (sameOrEqualIgnoreCase(overlay_[i].key, key)) {
+                return overlay_[i].value;
+            }
+        }
+        for (size_t i = 0; i < entries_.size(); ++i) {
+            if (sameOrEqualIgnoreCase(entries_[i].key, key)) {
+                return entries_[i].value;
+            }
+        }
+        return base_ ? base_->getIgnoreCase(key) : StringSlice();
+    }
+
+    bool has(const StringSlice& key) const { return get(key).valid(); }
+
+    /**
+     * @brief 按出现顺序遍历同一个键的所有值（如 ?tag=a&tag=b）
+     *
+     * overlay 中的值覆盖该键的全部原始值；自身没有该键时回落到 base。
+     */
+    template<typename Fn>
+    void forEachValue(const StringSlice& key, Fn fn) const {
+        for (size_t i = 0; i < overlay_.size(); ++i) {
+            if (overlay_[i].key == key) {
+                fn(overlay_[i].value);
+                return;
+            }
+        }
+        bool found = false;
+        for (size_t i = 0; i < entries_.size(); ++i) {
+            if (entries_[i].key == key) {
+                fn(entries_[i].value);
+                found = true;
+            }
+        }
+        if (!found && base_) {
+            base_->forEachValue(key, fn);
+        }
+    }
+
+    size_t count(const StringSlice& key) const {
+        size_t n = 0;
+        forEachValue(key, [&n](const StringSlice&) { ++n; });
+        return n;
+    }
+
+    // 遍历所有可见条目（被 overlay 覆盖的条目只出现一次）
+    template<typename Fn>
+    void forEach(Fn fn) const {
+        for (size_t i = 0; i < overlay_.size(); ++i) {
+            fn(overlay_[i].key, overlay_[i].value);
+        }
+        forEachBelow(fn, *this);
+    }
+
+    void clear() {
+        entries_.clear();
+        overlay_.clear();
+    }
+
+    const SliceMap* base() const { return base_; }
+
+private:
+    detail::SmallVector<SlicePair, 16> entries_;
+    detail::SmallVector<SlicePair, 4> overlay_;
+    const SliceMap* base_;
+
+    static bool sameOrEqualIgnoreCase(const StringSlice& entry, const StringSlice& key) {
+        return (entry.data == key.data && entry.size == key.size) || entry.equalsIgnoreCase(key.data, key.size);
+    }
+
+    bool shadowedByOverlay(const StringSlice& key) const {
+        for (size_t i = 0; i < overlay_.size(); ++i) {
+            if (overlay_[i].key == key) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    template<typename Fn>
+    void forEachBelow(Fn& fn, const SliceMap& top) const {
+        if (this != &top) {
+            for (size_t i = 0; i < overlay_.size(); ++i) {
+                if (!top.shadowedByOverlay(overlay_[i].key)) {
+                    fn(overlay_[i].key, overlay_[i].value);
+                }
+            }
+        }
+        for (size_t i = 0; i < entries_.size(); ++i) {
+            if (!top.shadowedByOverlay(entries_[i].key)) {
+                fn(entries_[i].key, entries_[i].value);
+            }
+        }
+        if (base_) {
+            base_->forEachBelow(fn, top);
+        }
+    }
+};
+
+} // namespace uvapi
+
+#endif // UVAPI_REQUEST_VIEW_H
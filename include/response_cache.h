@@ -3,9 +3,15 @@
 
 #include <string>
 #include <unordered_map>
+#include <list>
+#include <vector>
+#include <memory>
 #include <mutex>
 #include <chrono>
 #include <functional>
+#include <cstdint>
+
+#include "metrics.h"
 
 namespace uvapi {
 
@@ -262,6 +268,389 @@ private:
 // 特化：使用字符串键的响应缓存
 using StringResponseCache = ResponseCache<std::string>;
 
+/**
+ * @brief 分片响应缓存：按键哈希分成多个分片，每个分片独立加锁
+ *
+ * 与 ResponseCache 的使用警告相同，区别在于：
+ * - 多个工作线程访问不同分片时互不阻塞（分片数为 2 的幂，默认 16）
+ * - 每个分片维护 LRU 链表，命中时移到表头，淘汰表尾，均为 O(1)
+ * - 同时受条目数和字节数预算约束（按分片均分）
+ * - 命中/未命中/淘汰计数可通过 bindMetrics() 导出到 MetricRegistry
+ *
+ * 缓存值以 shared_ptr<const ValueType> 保存，find() 命中时不复制响应体。
+ * ValueType 默认为 std::string；其他类型需提供 byteSize() 用于字节预算。
+ *
+ * @code
+ * uvapi::ShardedResponseCache<std::string> cache(10000, 64 * 1024 * 1024);
+ * cache.bindMetrics(uvapi::metrics::getGlobalMetricRegistry(), "api_cache");
+ * cache.put("/api/config", body);
+ * auto hit = cache.find("/api/config");   // nullptr 表示未命中
+ * @endcode
+ */
+template<typename KeyType, typename Hash = std::hash<KeyType>, typename ValueType = std::string>
+class ShardedResponseCache {
+public:
+    using Value = std::shared_ptr<const ValueType>;
+    
+    // 统计快照
+    struct Stats {
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t evictions;    // 因预算不足被淘汰
+        uint64_t expirations;  // 因过期被删除
+        size_t entries;
+        size_t bytes;
+    };
+    
+    /**
+     * @param max_entries 最大条目数（所有分片合计）
+     * @param max_bytes 最大字节数（所有分片合计，按响应体和键的大小计算）
+     * @param ttl 缓存过期时间
+     * @param shard_count 分片数，向上取整为 2 的幂
+     */
+    ShardedResponseCache(size_t max_entries = 1000,
+                         size_t max_bytes = 64 * 1024 * 1024,
+                         std::chrono::milliseconds ttl = std::chrono::milliseconds(60000),
+                         size_t shard_count = 16)
+        : ttl_(ttl) {
+        size_t count = 1;
+        while (count < shard_count) {
+            count <<= 1;
+        }
+        shard_mask_ = count - 1;
+        shards_.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            shards_.push_back(std::unique_ptr<Shard>(new Shard()));
+        }
+        setLimits(max_entries, max_bytes);
+    }
+    
+    ShardedResponseCache(const ShardedResponseCache&) = delete;
+    ShardedResponseCache& operator=(const ShardedResponseCache&) = delete;
+    
+    /**
+     * @brief 查找缓存
+     * @return 命中时返回共享的响应体，未命中或已过期返回 nullptr
+     */
+    Value find(const KeyType& key) {
+        Shard& shard = shardFor(key);
+        auto now = std::chrono::steady_clock::now();
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        
+        auto it = shard.index.find(key);
+        if (it == shard.index.end()) {
+            recordMiss(shard);
+            return Value();
+        }
+        
+        typename LruList::iterator node = it->second;
+        if (now - node->timestamp > ttl_) {
+            eraseNode(shard, it);
+            shard.expirations++;
+            if (expirations_counter_) expirations_counter_->increment();
+            recordMiss(shard);
+            return Value();
+        }
+        
+        // 移到表头（最近使用）
+        shard.lru.splice(shard.lru.begin(), shard.lru, node);
+        shard.hits++;
+        if (hits_counter_) hits_counter_->increment();
+        return node->value;
+    }
+    
+    // 获取缓存的响应（复制到 out_response）
+    bool get(const KeyType& key, ValueType& out_response) {
+        Value value = find(key);
+        if (!value) {
+            return false;
+        }
+        out_response = *value;
+        return true;
+    }
+    
+    /**
+     * @brief 缓存响应
+     * @return 是否已缓存；单个条目超过分片字节预算时不缓存
+     */
+    bool put(const KeyType& key, ValueType response) {
+        return put(key, std::make_shared<const ValueType>(std::move(response)));
+    }
+    
+    bool put(const KeyType& key, const Value& value) {
+        if (!value) {
+            return false;
+        }
+        Shard& shard = shardFor(key);
+        size_t bytes = entryBytes(key, *value);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        
+        auto it = shard.index.find(key);
+        if (it != shard.index.end()) {
+            eraseNode(shard, it);
+        }
+        if (bytes > shard_max_bytes_ || shard_max_entries_ == 0) {
+            return false;
+        }
+        
+        // 淘汰表尾直到满足预算
+        while (!shard.lru.empty() &&
+               (shard.lru.size() >= shard_max_entries_ || shard.bytes + bytes > shard_max_bytes_)) {
+            auto victim = shard.index.find(shard.lru.back().key);
+            eraseNode(shard, victim);
+            shard.evictions++;
+            if (evictions_counter_) evictions_counter_->increment();
+        }
+        
+        shard.lru.push_front(Node(key, value, bytes));
+        shard.index[key] = shard.lru.begin();
+        shard.bytes += bytes;
+        if (entries_gauge_) entries_gauge_->increment(1.0);
+        if (bytes_gauge_) bytes_gauge_->increment(static_cast<double>(bytes));
+        return true;
+    }
+    
+    /**
+     * @brief 删除指定键的缓存
+     * @return 是否成功删除
+     */
+    bool remove(const KeyType& key) {
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.index.find(key);
+        if (it == shard.index.end()) {
+            return false;
+        }
+        eraseNode(shard, it);
+        return true;
+    }
+    
+    // 清空所有缓存
+    void clear() {
+        for (size_t i = 0; i < shards_.size(); ++i) {
+            Shard& shard = *shards_[i];
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            if (entries_gauge_) entries_gauge_->decrement(static_cast<double>(shard.lru.size()));
+            if (bytes_gauge_) bytes_gauge_->decrement(static_cast<double>(shard.bytes));
+            shard.lru.clear();
+            shard.index.clear();
+            shard.bytes = 0;
+        }
+    }
+    
+    /**
+     * @brief 清理所有过期条目
+     *
+     * LRU 表尾是最久未访问的条目，未过期的条目可能在其后，因此需要遍历整个分片。
+     * 建议定期调用（如每分钟一次）以释放内存。
+     */
+    void cleanup() {
+        auto now = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < shards_.size(); ++i) {
+            Shard& shard = *shards_[i];
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            for (auto node = shard.lru.begin(); node != shard.lru.end();) {
+                auto next = node;
+                ++next;
+                if (now - node->timestamp > ttl_) {
+                    eraseNode(shard, shard.index.find(node->key));
+                    shard.expirations++;
+                    if (expirations_counter_) expirations_counter_->increment();
+                }
+                node = next;
+            }
+        }
+    }
+    
+    /**
+     * @brief 设置容量预算（按分片均分，超出部分立即淘汰）
+     */
+    void setLimits(size_t max_entries, size_t max_bytes) {
+        size_t count = shards_.size();
+        shard_max_entries_ = (max_entries + count - 1) / count;
+        shard_max_bytes_ = (max_bytes + count - 1) / count;
+        for (size_t i = 0; i < count; ++i) {
+            Shard& shard = *shards_[i];
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            while (!shard.lru.empty() &&
+                   (shard.lru.size() > shard_max_entries_ || shard.bytes > shard_max_bytes_)) {
+                eraseNode(shard, shard.index.find(shard.lru.back().key));
+                shard.evictions++;
+                if (evictions_counter_) evictions_counter_->increment();
+            }
+        }
+    }
+    
+    /**
+     * @brief 设置缓存过期时间（应在开始服务之前调用）
+     */
+    void setTtl(std::chrono::milliseconds ttl) {
+        ttl_ = ttl;
+    }
+    
+    // 当前条目数
+    size_t size() const {
+        size_t total = 0;
+        for (size_t i = 0; i < shards_.size(); ++i) {
+            std::lock_guard<std::mutex> lock(shards_[i]->mutex);
+            total += shards_[i]->lru.size();
+        }
+        return total;
+    }
+    
+    // 当前占用字节数
+    size_t bytes() const {
+        size_t total = 0;
+        for (size_t i = 0; i < shards_.size(); ++i) {
+            std::lock_guard<std::mutex> lock(shards_[i]->mutex);
+            total += shards_[i]->bytes;
+        }
+        return total;
+    }
+    
+    size_t shardCount() const { return shards_.size(); }
+    
+    // 汇总各分片的统计信息
+    Stats stats() const {
+        Stats result = { 0, 0, 0, 0, 0, 0 };
+        for (size_t i = 0; i < shards_.size(); ++i) {
+            const Shard& shard = *shards_[i];
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            result.hits += shard.hits;
+            result.misses += shard.misses;
+            result.evictions += shard.evictions;
+            result.expirations += shard.expirations;
+            result.entries += shard.lru.size();
+            result.bytes += shard.bytes;
+        }
+        return result;
+    }
+    
+    /**
+     * @brief 获取缓存命中率
+     * @return 命中率（0.0 - 1.0）
+     */
+    double getHitRate() const {
+        Stats s = stats();
+        uint64_t total = s.hits + s.misses;
+        return total == 0 ? 0.0 : static_cast<double>(s.hits) / static_cast<double>(total);
+    }
+    
+    /**
+     * @brief 重置统计信息（不影响已导出的指标）
+     */
+    void resetStats() {
+        for (size_t i = 0; i < shards_.size(); ++i) {
+            Shard& shard = *shards_[i];
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.hits = 0;
+            shard.misses = 0;
+            shard.evictions = 0;
+            shard.expirations = 0;
+        }
+    }
+    
+    /**
+     * @brief 把统计信息注册到指标注册表
+     * @param prefix 指标名前缀，生成 <prefix>_hits_total、_misses_total、
+     *               _evictions_total、_expirations_total 计数器和 _entries、_bytes 仪表盘
+     *
+     * 应在开始服务之前调用；之后的变化实时反映到指标中。
+     */
+    void bindMetrics(metrics::MetricRegistry& registry, const std::string& prefix = "uvapi_response_cache") {
+        hits_counter_ = registry.registerCounter(prefix + "_hits_total", "Response cache hits");
+        misses_counter_ = registry.registerCounter(prefix + "_misses_total", "Response cache misses");
+        evictions_counter_ = registry.registerCounter(prefix + "_evictions_total",
+                                                      "Response cache entries evicted by budget");
+        expirations_counter_ = registry.registerCounter(prefix + "_expirations_total",
+                                                        "Response cache entries expired by TTL");
+        entries_gauge_ = registry.registerGauge(prefix + "_entries", "Response cache entries");
+        bytes_gauge_ = registry.registerGauge(prefix + "_bytes", "Response cache size in bytes");
+        
+        Stats s = stats();
+        entries_gauge_->set(static_cast<double>(s.entries));
+        bytes_gauge_->set(static_cast<double>(s.bytes));
+    }
+    
+private:
+    struct Node {
+        KeyType key;
+        Value value;
+        size_t bytes;
+        std::chrono::steady_clock::time_point timestamp;
+        
+        Node(const KeyType& k, const Value& v, size_t b)
+            : key(k), value(v), bytes(b), timestamp(std::chrono::steady_clock::now()) {}
+    };
+    
+    using LruList = std::list<Node>;
+    using Index = std::unordered_map<KeyType, typename LruList::iterator, Hash>;
+    
+    struct Shard {
+        mutable std::mutex mutex;
+        LruList lru;     // 表头为最近使用
+        Index index;
+        size_t bytes;
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t evictions;
+        uint64_t expirations;
+        
+        Shard() : bytes(0), hits(0), misses(0), evictions(0), expirations(0) {}
+    };
+    
+    std::vector<std::unique_ptr<Shard> > shards_;
+    size_t shard_mask_;
+    size_t shard_max_entries_;
+    size_t shard_max_bytes_;
+    std::chrono::milliseconds ttl_;
+    Hash hash_;
+    
+    std::shared_ptr<metrics::Counter> hits_counter_;
+    std::shared_ptr<metrics::Counter> misses_counter_;
+    std::shared_ptr<metrics::Counter> evictions_counter_;
+    std::shared_ptr<metrics::Counter> expirations_counter_;
+    std::shared_ptr<metrics::Gauge> entries_gauge_;
+    std::shared_ptr<metrics::Gauge> bytes_gauge_;
+    
+    Shard& shardFor(const KeyType& key) {
+        size_t h = hash_(key);
+        // 混合高位，避免标准库恒等哈希（如整数键）只用到低位
+        h ^= h >> 16;
+        return *shards_[h & shard_mask_];
+    }
+    
+    void recordMiss(Shard& shard) {
+        shard.misses++;
+        if (misses_counter_) misses_counter_->increment();
+    }
+    
+    // 调用方持有分片锁
+    void eraseNode(Shard& shard, typename Index::iterator it) {
+        size_t bytes = it->second->bytes;
+        shard.bytes -= bytes;
+        shard.lru.erase(it->second);
+        shard.index.erase(it);
+        if (entries_gauge_) entries_gauge_->decrement(1.0);
+        if (bytes_gauge_) bytes_gauge_->decrement(static_cast<double>(bytes));
+    }
+    
+    static size_t keyBytes(const std::string& key) { return key.size(); }
+    template<typename K>
+    static size_t keyBytes(const K&) { return sizeof(K); }
+    
+    static size_t valueBytes(const std::string& value) { return value.size(); }
+    template<typename V>
+    static size_t valueBytes(const V& value) { return value.byteSize(); }
+    
+    static size_t entryBytes(const KeyType& key, const ValueType& value) {
+        return valueBytes(value) + keyBytes(key);
+    }
+};
+
+// 特化：使用字符串键的分片响应缓存
+using StringShardedResponseCache = ShardedResponseCache<std::string>;
+
 } 
 
 #endif
\ No newline at end of file
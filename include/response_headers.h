@@ -0,0 +1,214 @@
+/**
+ * @file response_headers.h
+ * @brief 扁平头部列表与预驻留的头部名称
+ *
+ * 响应头按插入顺序存放在一个 vector 中，替代 std::map：
+ * - 名称大小写不敏感（与 HTTP 语义一致），重复设置会覆盖已有值
+ * - 常用名称（Content-Type、Content-Length、Cache-Control）预先驻留为常量，
+ *   设置时不需要 strlen，也不会产生重复条目
+ * - 写出时顺序遍历，没有树节点分配和指针追逐
+ *
+ * 接口与原先的 std::map 保持兼容（operator[]、find、end、count、erase、范围 for），
+ * 元素类型仍是 std::pair<std::string, std::string>。
+ * 注意：与 std::map 不同，插入新头部后之前取得的引用和迭代器可能失效。
+ *
+ * HttpRequest::headers 使用同一个列表（RequestHeaders），请求头查找因此同样大小写不敏感。
+ * internHeaderName() 把常见请求头名称映射到驻留常量，零拷贝视图用它统一名称的存储与大小写。
+ */
+
+#ifndef UVAPI_RESPONSE_HEADERS_H
+#define UVAPI_RESPONSE_HEADERS_H
+
+#include "request_view.h"
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace uvapi {
+
+// ========== 预驻留的头部名称 ==========
+
+struct HeaderName {
+    const char* data;
+    size_t size;
+};
+
+namespace header {
+static const HeaderName CONTENT_TYPE = { "Content-Type", 12 };
+static const HeaderName CONTENT_LENGTH = { "Content-Length", 14 };
+static const HeaderName CACHE_CONTROL = { "Cache-Control", 13 };
+static const HeaderName ACCEPT = { "Accept", 6 };
+static const HeaderName ACCEPT_ENCODING = { "Accept-Encoding", 15 };
+static const HeaderName AUTHORIZATION = { "Authorization", 13 };
+static const HeaderName CONNECTION = { "Connection", 10 };
+static const HeaderName COOKIE = { "Cookie", 6 };
+static const HeaderName HOST = { "Host", 4 };
+static const HeaderName IF_MODIFIED_SINCE = { "If-Modified-Since", 17 };
+static const HeaderName IF_NONE_MATCH = { "If-None-Match", 13 };
+static const HeaderName IF_RANGE = { "If-Range", 8 };
+static const HeaderName ORIGIN = { "Origin", 6 };
+static const HeaderName RANGE = { "Range", 5 };
+static const HeaderName USER_AGENT = { "User-Agent", 10 };
+static const HeaderName X_FORWARDED_FOR = { "X-Forwarded-For", 15 };
+static const HeaderName X_REAL_IP = { "X-Real-IP", 9 };
+}
+
+/**
+ * @brief 查找名称对应的驻留常量（大小写不敏感），不是常见头部时返回 nullptr
+ *
+ * 返回的 data 指向静态存储、采用规范大小写；同一名称总是返回同一指针，
+ * 查找方传入驻留名称时可以先按指针比较（见 SliceMap::getIgnoreCase）。
+ */
+inline const HeaderName* internHeaderName(const char* name, size_t size) {
+    static const HeaderName kKnown[] = {
+        { "Host", 4 }, { "Accept", 6 }, { "Cookie", 6 }, { "Origin", 6 }, { "Range", 5 },
+        { "Expect", 6 }, { "Referer", 7 }, { "Upgrade", 7 }, { "If-Range", 8 }, { "X-Real-IP", 9 },
+        { "Connection", 10 }, { "User-Agent", 10 }, { "X-Request-ID", 12 }, { "Content-Type", 12 },
+        { "Authorization", 13 }, { "Cache-Control", 13 }, { "If-None-Match", 13 },
+        { "Content-Length", 14 }, { "Accept-Encoding", 15 }, { "Accept-Language", 15 },
+        { "X-Forwarded-For", 15 }, { "If-Modified-Since", 17 }, { "Transfer-Encoding", 17 },
+        { "Access-Control-Request-Method", 29 }, { "Access-Control-Request-Headers", 30 },
+    };
+    for (size_t i = 0; i < sizeof(kKnown) / sizeof(kKnown[0]); ++i) {
+        if (kKnown[i].size == size && StringSlice(kKnown[i].data, kKnown[i].size).equalsIgnoreCase(name, size)) {
+            return &kKnown[i];
+        }
+    }
+    return nullptr;
+}
+
+// ========== 响应头列表 ==========
+
+class ResponseHeaders {
+public:
+    typedef std::pair<std::string, std::string> value_type;
+    typedef std::vector<value_type> List;
+    typedef List::iterator iterator;
+    typedef List::const_iterator const_iterator;
+
+    ResponseHeaders() {}
+
+    // 与 std::map 相同：不存在时追加一个空值并返回其引用
+    std::string& operator[](const std::string& name) {
+        iterator it = find(name.data(), name.size());
+        if (it != entries_.end()) {
+            return it->second;
+        }
+        entries_.push_back(value_type(name, std::string()));
+        return entries_.back().second;
+    }
+
+    void set(const char* name, size_t name_size, const std::string& value) {
+        slot(name, name_size) = value;
+    }
+
+    void set(const char* name, size_t name_size, std::string&& value) {
+        slot(name, name_size) = std::move(value);
+    }
+
+    void set(const std::string& name, const std::string& value) {
+        set(name.data(), name.size(), value);
+    }
+
+    void set(const std::string& name, std::string&& value) {
+        set(name.data(), name.size(), std::move(value));
+    }
+
+    void set(const HeaderName& name, const std::string& value) {
+        set(name.data, name.size, value);
+    }
+
+    void set(const HeaderName& name, std::string&& value) {
+        set(name.data, name.size, std::move(value));
+    }
+
+    // 不做去重直接追加（调用方保证不重复，或确实需要多值头部如 Set-Cookie）
+    void add(const std::string& name, const std::string& value) {
+        entries_.push_back(value_type(name, value));
+    }
+
+    iterator find(const char* name, size_t name_size) {
+        for (iterator it = entries_.begin(); it != entries_.end(); ++it) {
+            if (StringSlice(it->first).equalsIgnoreCase(name, name_size)) {
+                return it;
+            }
+        }
+        return entries_.end();
+    }
+
+    const_iterator find(const char* name, size_t name_size) const {
+        for (const_iterator it = entries_.begin(); it != entries_.end(); ++it) {
+            if (StringSlice(it->first).equalsIgnoreCase(name, name_size)) {
+                return it;
+            }
+        }
+        return entries_.end();
+    }
+
+    iterator find(const std::string& name) { return find(name.data(), name.size()); }
+    const_iterator find(const std::string& name) const { return find(name.data(), name.size()); }
+    iterator find(const HeaderName& name) { return find(name.data, name.size); }
+    const_iterator find(const HeaderName& name) const { return find(name.data, name.size); }
+
+    // 不存在时返回 nullptr
+    const std::string* get(const char* name, size_t name_size) const {
+        const_iterator it = find(name, name_size);
+        return it == entries_.end() ? nullptr : &it->second;
+    }
+
+    const std::string* get(const std::string& name) const { return get(name.data(), name.size()); }
+    const std::string* get(const HeaderName& name) const { return get(name.data, name.size); }
+
+    bool has(const std::string& name) const { return get(name) != nullptr; }
+    bool has(const HeaderName& name) const { return get(name) != nullptr; }
+
+    size_t count(const std::string& name) const { return has(name) ? 1 : 0; }
+
+    size_t erase(const std::string& name) {
+        iterator it = find(name);
+        if (it == entries_.end()) {
+            return 0;
+        }
+        entries_.erase(it);
+        return 1;
+    }
+
+    iterator erase(iterator it) { return entries_.erase(it); }
+
+    iterator begin() { return entries_.begin(); }
+    iterator end() { return entries_.end(); }
+    const_iterator begin() const { return entries_.begin(); }
+    const_iterator end() const { return entries_.end(); }
+
+    size_t size() const { return entries_.size(); }
+    bool empty() const { return entries_.empty(); }
+    void reserve(size_t count) { entries_.reserve(count); }
+
+    // 清空但保留容量（供对象池复用）
+    void clear() { entries_.clear(); }
+
+    // 底层连续存储（可直接作为 CachedResponse::HeaderList 使用）
+    const List& entries() const { return entries_; }
+
+private:
+    List entries_;
+
+    std::string& slot(const char* name, size_t name_size) {
+        iterator it = find(name, name_size);
+        if (it != entries_.end()) {
+            return it->second;
+        }
+        entries_.push_back(value_type(std::string(name, name_size), std::string()));
+        return entries_.back().second;
+    }
+};
+
+// 请求头与响应头共用扁平列表
+typedef ResponseHeaders RequestHeaders;
+
+} // namespace uvapi
+
+#endif // UVAPI_RESPONSE_HEADERS_H
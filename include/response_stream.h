@@ -0,0 +1,86 @@
+/**
+ * @file response_stream.h
+ * @brief 流式响应的 HTTP/1.1 分帧
+ *
+ * - 状态行和头部由框架直接写入连接，不经过 uvhttp 的整体响应
+ * - 未声明 Content-Length 时使用 chunked 编码：每块前缀为十六进制长度，结束块为 "0\r\n\r\n"
+ * - 流式响应结束后关闭连接，头部总是带 Connection: close；调用方设置的 Connection /
+ *   Transfer-Encoding 被忽略，名称或值中含 CR / LF 的头部不写出
+ *
+ * 与连接、背压的对接见 ResponseStream（framework.h）。
+ */
+
+#ifndef UVAPI_RESPONSE_STREAM_H
+#define UVAPI_RESPONSE_STREAM_H
+
+#include "response_headers.h"
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+
+namespace uvapi {
+namespace server {
+
+inline const char* statusReason(int status) {
+    switch (status) {
+        case 200: return "OK";
+        case 201: return "Created";
+        case 202: return "Accepted";
+        case 203: return "Non-Authoritative Information";
+        case 206: return "Partial Content";
+        case 400: return "Bad Request";
+        case 401: return "Unauthorized";
+        case 403: return "Forbidden";
+        case 404: return "Not Found";
+        case 409: return "Conflict";
+        case 500: return "Internal Server Error";
+        case 503: return "Service Unavailable";
+        default: break;
+    }
+    if (status < 300) {
+        return "OK";
+    }
+    return status < 400 ? "Redirect" : (status < 500 ? "Client Error" : "Server Error");
+}
+
+// 状态行和头部（以空行结束）
+inline std::string streamHead(int status, const ResponseHeaders& headers, bool chunked) {
+    std::string out;
+    char line[64];
+    std::snprintf(line, sizeof(line), "HTTP/1.1 %d %s\r\n", status, statusReason(status));
+    out.append(line);
+    for (ResponseHeaders::const_iterator it = headers.begin(); it != headers.end(); ++it) {
+        StringSlice name(it->first);
+        if (name.equalsIgnoreCase("Connection", 10) || name.equalsIgnoreCase("Transfer-Encoding", 17) ||
+            (chunked && name.equalsIgnoreCase("Content-Length", 14)) ||
+            it->first.find_first_of("\r\n") != std::string::npos ||
+            it->second.find_first_of("\r\n") != std::string::npos) {
+            continue;
+        }
+        out.append(it->first);
+        out.append(": ", 2);
+        out.append(it->second);
+        out.append("\r\n", 2);
+    }
+    if (chunked) {
+        out.append("Transfer-Encoding: chunked\r\n");
+    }
+    out.append("Connection: close\r\n\r\n");
+    return out;
+}
+
+// chunked 编码的块前缀："<十六进制长度>\r\n"
+inline std::string chunkPrefix(size_t size) {
+    char prefix[24];
+    int length = std::snprintf(prefix, sizeof(prefix), "%llx\r\n", static_cast<unsigned long long>(size));
+    return std::string(prefix, static_cast<size_t>(length));
+}
+
+static const char kChunkSuffix[] = "\r\n";
+static const char kLastChunk[] = "0\r\n\r\n";
+
+} // namespace server
+} // namespace uvapi
+
+#endif // UVAPI_RESPONSE_STREAM_H
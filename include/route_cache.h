@@ -0,0 +1,347 @@
+/**
+ * @file route_cache.h
+ * @brief 路由级响应缓存：整条响应预编码为一个不可变共享缓冲区
+ *
+ * 在 RouteBuilder 上用 cache() 声明，由分发路径直接使用：
+ * - 缓存键 = 方法 + 路径 + 指定的查询参数 / 请求头取值
+ * - 命中时直接按预编码的状态码、头部和响应体写出，不构造 HttpResponse、不遍历 std::map
+ * - 每个条目带 ETag（处理器未设置时按响应体哈希生成），If-None-Match 匹配时返回 304
+ * - 过期后的 stale_while_revalidate 窗口内继续返回旧响应，同时只触发一次后台刷新
+ *
+ * 缓存由多核模式的所有工作线程共享（底层为 ShardedResponseCache）。
+ *
+ * @code
+ * api.get("/api/config")
+ *    .cache(uvapi::server::RouteCachePolicy(std::chrono::seconds(30))
+ *               .staleWhileRevalidate(std::chrono::seconds(60))
+ *               .varyQuery("lang"))
+ *    .handler(getConfig)
+ *    .register_();
+ * @endcode
+ */
+
+#ifndef UVAPI_ROUTE_CACHE_H
+#define UVAPI_ROUTE_CACHE_H
+
+#include "response_cache.h"
+#include "request_view.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace uvapi {
+namespace server {
+
+// ========== 缓存策略 ==========
+
+struct RouteCachePolicy {
+    std::chrono::milliseconds ttl;                     // 新鲜期
+    std::chrono::milliseconds stale_while_revalidate;  // 过期后仍可返回旧响应的时长
+    std::vector<std::string> vary_query;               // 参与缓存键的查询参数
+    std::vector<std::string> vary_headers;             // 参与缓存键的请求头（大小写不敏感）
+    size_t max_entries;
+    size_t max_bytes;
+
+    explicit RouteCachePolicy(std::chrono::milliseconds fresh_for = std::chrono::milliseconds(60000))
+        : ttl(fresh_for)
+        , stale_while_revalidate(0)
+        , max_entries(1000)
+        , max_bytes(16 * 1024 * 1024) {}
+
+    RouteCachePolicy& staleWhileRevalidate(std::chrono::milliseconds window) {
+        stale_while_revalidate = window;
+        return *this;
+    }
+
+    RouteCachePolicy& varyQuery(const std::string& name) {
+        vary_query.push_back(name);
+        return *this;
+    }
+
+    RouteCachePolicy& varyHeader(const std::string& name) {
+        vary_headers.push_back(name);
+        return *this;
+    }
+
+    RouteCachePolicy& maxEntries(size_t count) {
+        max_entries = count;
+        return *this;
+    }
+
+    RouteCachePolicy& maxBytes(size_t bytes) {
+        max_bytes = bytes;
+        return *this;
+    }
+};
+
+// ========== 预编码响应 ==========
+
+/**
+ * @brief 不可变的预编码响应
+ *
+ * 头部名称、头部值和响应体连续存放在同一个缓冲区中（头部以 '\0' 结尾），
+ * 可以直接交给 uvhttp_response_set_header / set_body，命中时无需任何分配。
+ */
+class CachedResponse {
+public:
+    typedef std::vector<std::pair<std::string, std::string> > HeaderList;
+
+    /**
+     * @brief 从状态码、头部和响应体构建
+     *
+     * 头部中没有 ETag 时按响应体的 FNV-1a 64 位哈希生成强 ETag 并追加到头部。
+     */
+    static std::shared_ptr<const CachedResponse> create(int status, const HeaderList& headers,
+                                                        const std::string& body) {
+        std::shared_ptr<CachedResponse> out(new CachedResponse());
+        out->status_ = status;
+        out->created_at_ = std::chrono::steady_clock::now();
+
+        size_t reserve = body.size();
+        std::string etag;
+        for (size_t i = 0; i < headers.size(); ++i) {
+            reserve += headers[i].first.size() + headers[i].second.size() + 2;
+            if (StringSlice(headers[i].first).equalsIgnoreCase("ETag", 4)) {
+                etag = headers[i].second;
+            }
+        }
+        if (etag.empty()) {
+            etag = computeEtag(body);
+            reserve += etag.size() + 6;
+        }
+        out->buffer_.reserve(reserve);
+
+        for (size_t i = 0; i < headers.size(); ++i) {
+            out->appendHeader(headers[i].first, headers[i].second);
+        }
+        if (out->findHeader("ETag") == npos) {
+            out->appendHeader("ETag", etag);
+        }
+        out->etag_ = etag;
+        out->body_offset_ = out->buffer_.size();
+        out->body_size_ = body.size();
+        out->buffer_.append(body);
+        return out;
+    }
+
+    int status() const { return status_; }
+
+    size_t headerCount() const { return headers_.size(); }
+    const char* headerName(size_t index) const { return buffer_.c_str() + headers_[index].first; }
+    const char* headerValue(size_t index) const { return buffer_.c_str() + headers_[index].second; }
+
+    const char* body() const { return buffer_.data() + body_offset_; }
+    size_t bodySize() const { return body_size_; }
+
+    const std::string& etag() const { return etag_; }
+    std::chrono::steady_clock::time_point createdAt() const { return created_at_; }
+
+    // 字节预算按缓冲区大小计算
+    size_t byteSize() const { return buffer_.size() + etag_.size() + sizeof(CachedResponse); }
+
+    /**
+     * @brief If-None-Match 是否与本响应匹配（弱比较：忽略 W/ 前缀，支持 "*" 和逗号分隔列表）
+     */
+    bool matchesIfNoneMatch(const StringSlice& header) const {
+        if (!header.valid() || header.empty()) {
+            return false;
+        }
+        StringSlice mine = stripWeak(StringSlice(etag_));
+        size_t pos = 0;
+        while (pos < header.size) {
+            while (pos < header.size && (header.data[pos] == ' ' || header.data[pos] == ',')) {
+                ++pos;
+            }
+            size_t start = pos;
+            while (pos < header.size && header.data[pos] != ',') {
+                ++pos;
+            }
+            size_t end = pos;
+            while (end > start && header.data[end - 1] == ' ') {
+                --end;
+            }
+            StringSlice candidate(header.data + start, end - start);
+            if (candidate.equals("*", 1)) {
+                return true;
+            }
+            StringSlice tag = stripWeak(candidate);
+            if (!tag.empty() && tag.size == mine.size && std::memcmp(tag.data, mine.data, tag.size) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    static const size_t npos = static_cast<size_t>(-1);
+
+    int status_;
+    std::string buffer_;
+    std::vector<std::pair<size_t, size_t> > headers_;  // 名称和值在 buffer_ 中的偏移
+    size_t body_offset_;
+    size_t body_size_;
+    std::string etag_;
+    std::chrono::steady_clock::time_point created_at_;
+
+    CachedResponse() : status_(200), body_offset_(0), body_size_(0) {}
+
+    void appendHeader(const std::string& name, const std::string& value) {
+        size_t name_offset = buffer_.size();
+        buffer_.append(name);
+        buffer_ += '\0';
+        size_t value_offset = buffer_.size();
+        buffer_.append(value);
+        buffer_ += '\0';
+        headers_.push_back(std::make_pair(name_offset, value_offset));
+    }
+
+    size_t findHeader(const char* name) const {
+        for (size_t i = 0; i < headers_.size(); ++i) {
+            if (StringSlice(headerName(i)).equalsIgnoreCase(name, std::strlen(name))) {
+                return i;
+            }
+        }
+        return npos;
+    }
+
+    static StringSlice stripWeak(const StringSlice& tag) {
+        if (tag.size >= 2 && tag.data[0] == 'W' && tag.data[1] == '/') {
+            return StringSlice(tag.data + 2, tag.size - 2);
+        }
+        return tag;
+    }
+
+    static std::string computeEtag(const std::string& body) {
+        uint64_t h = 14695981039346656037ULL;
+        for (size_t i = 0; i < body.size(); ++i) {
+            h ^= static_cast<unsigned char>(body[i]);
+            h *= 1099511628211ULL;
+        }
+        static const char kHex[] = "0123456789abcdef";
+        std::string tag(18, '"');
+        for (int i = 0; i < 16; ++i) {
+            tag[static_cast<size_t>(16 - i)] = kHex[h & 0xF];
+            h >>= 4;
+        }
+        return tag;
+    }
+};
+
+// ========== 路由缓存 ==========
+
+class RouteCache {
+public:
+    enum class Freshness {
+        MISS,
+        FRESH,
+        STALE   // 已过期但仍在 stale_while_revalidate 窗口内
+    };
+
+    explicit RouteCache(const RouteCachePolicy& policy)
+        : policy_(policy)
+        , entries_(policy.max_entries, policy.max_bytes, policy.ttl + policy.stale_while_revalidate) {}
+
+    const RouteCachePolicy& policy() const { return policy_; }
+
+    /**
+     * @brief 构建缓存键
+     * @param query 按名称取查询参数的函数，返回 StringSlice
+     * @param header 按名称取请求头（大小写不敏感）的函数，返回 StringSlice
+     */
+    template<typename QueryFn, typename HeaderFn>
+    std::string buildKey(int method, const StringSlice& path, QueryFn query, HeaderFn header) const {
+        std::string key;
+        key.reserve(path.size + 16);
+        key += static_cast<char>('0' + method);
+        key.append(path.data, path.size);
+        // 取值之间用 \x1f 分隔；不存在的取值用 \x1e 标记，与空值区分
+        for (size_t i = 0; i < policy_.vary_query.size(); ++i) {
+            appendPart(key, query(policy_.vary_query[i]));
+        }
+        for (size_t i = 0; i < policy_.vary_headers.size(); ++i) {
+            appendPart(key, header(policy_.vary_headers[i]));
+        }
+        return key;
+    }
+
+    Freshness lookup(const std::string& key, std::shared_ptr<const CachedResponse>& out) {
+        out = entries_.find(key);
+        if (!out) {
+            return Freshness::MISS;
+        }
+        if (std::chrono::steady_clock::now() - out->createdAt() <= policy_.ttl) {
+            return Freshness::FRESH;
+        }
+        return Freshness::STALE;
+    }
+
+    void store(const std::string& key, const std::shared_ptr<const CachedResponse>& response) {
+        entries_.put(key, response);
+    }
+
+    /**
+     * @brief 申请后台刷新：同一个键同时只有一个调用方返回 true
+     */
+    bool beginRevalidation(const std::string& key) {
+        std::lock_guard<std::mutex> lock(revalidating_mutex_);
+        return revalidating_.insert(key).second;
+    }
+
+    void endRevalidation(const std::string& key) {
+        std::lock_guard<std::mutex> lock(revalidating_mutex_);
+        revalidating_.erase(key);
+    }
+
+    void clear() { entries_.clear(); }
+    bool remove(const std::string& key) { return entries_.remove(key); }
+
+    ShardedResponseCache<std::string, std::hash<std::string>, CachedResponse>& entries() { return entries_; }
+
+    /**
+     * @brief 响应是否可以缓存：仅 200，且没有 Set-Cookie 和 Cache-Control: no-store / private
+     */
+    static bool isCacheable(int status, const CachedResponse::HeaderList& headers) {
+        if (status != 200) {
+            return false;
+        }
+        for (size_t i = 0; i < headers.size(); ++i) {
+            StringSlice name(headers[i].first);
+            const std::string& value = headers[i].second;
+            if (name.equalsIgnoreCase("Set-Cookie", 10)) {
+                return false;
+            }
+            if (name.equalsIgnoreCase("Cache-Control", 13) &&
+                (value.find("no-store") != std::string::npos || value.find("private") != std::string::npos)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    RouteCachePolicy policy_;
+    ShardedResponseCache<std::string, std::hash<std::string>, CachedResponse> entries_;
+    std::mutex revalidating_mutex_;
+    std::set<std::string> revalidating_;
+
+    static void appendPart(std::string& key, const StringSlice& value) {
+        key += '\x1f';
+        if (!value.valid()) {
+            key += '\x1e';
+            return;
+        }
+        key.append(value.data, value.size);
+    }
+};
+
+} // namespace server
+} // namespace uvapi
+
+#endif // UVAPI_ROUTE_CACHE_H
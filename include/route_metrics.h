@@ -0,0 +1,442 @@
+/**
+ * @file route_metrics.h
+ * @brief 路由级延迟与吞吐量统计：按路由、状态码类别和处理阶段记录
+ *
+ * 由 restful::Api::enableMetrics() 开启，分发路径直接使用：
+ * - 每个请求在栈上持有一个 RequestTiming，框架在解析、验证、序列化处用 PhaseTimer 累计耗时，
+ *   处理器耗时 = 总耗时 - 其余阶段
+ * - 延迟记录到对数线性分桶的 LatencyHistogram（HDR 风格，相对误差约 3%），
+ *   按线程分片，记录时只有 relaxed 原子加，抓取时合并并计算 p50/p90/p99/p999
+ * - 所有路由汇总为一个 Prometheus summary 指标族，注册到 MetricRegistry
+ *
+ * 未开启时 PhaseTimer 只读取一次线程局部指针，不取时间。
+ *
+ * @code
+ * api.enableMetrics();             // GET /metrics，使用全局注册表
+ * api.get("/users/:id", getUser);
+ * // uvapi_route_duration_seconds{method="GET",route="/users/:id",status="2xx",phase="handler",quantile="0.99"} 0.00021
+ * @endcode
+ */
+
+#ifndef UVAPI_ROUTE_METRICS_H
+#define UVAPI_ROUTE_METRICS_H
+
+#include "metrics.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace uvapi {
+namespace metrics {
+
+// ========== 处理阶段 ==========
+
+enum class Phase {
+    PARSE = 0,          // 从 uvhttp 解析结果构建请求
+    VALIDATION = 1,     // 参数验证、请求体解析与 Schema 验证
+    HANDLER = 2,        // 用户处理器（由总耗时推算）
+    SERIALIZATION = 3,  // 响应体序列化与写出
+    TOTAL = 4
+};
+
+static const size_t kPhaseCount = 5;
+
+inline const char* phaseName(Phase phase) {
+    switch (phase) {
+        case Phase::PARSE: return "parse";
+        case Phase::VALIDATION: return "validation";
+        case Phase::HANDLER: return "handler";
+        case Phase::SERIALIZATION: return "serialization";
+        case Phase::TOTAL: return "total";
+    }
+    return "unknown";
+}
+
+inline uint64_t monotonicNanos() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// ========== 延迟直方图 ==========
+
+/**
+ * @brief 对数线性分桶的纳秒延迟直方图
+ *
+ * 每个 2 的幂区间再等分为 16 个子桶：小于 16ns 的值精确记录，
+ * 其余按子桶中点估计，相对误差不超过 1/32。超过上限（约 137 秒）的值计入最后一个桶。
+ */
+class LatencyHistogram {
+public:
+    static const int kSubBucketBits = 4;
+    static const uint64_t kSubBuckets = 1u << kSubBucketBits;
+    static const int kMaxExponent = 36;
+    static const size_t kBucketCount = static_cast<size_t>((kMaxExponent - kSubBucketBits + 2) * kSubBuckets);
+    static const size_t kShards = 4;  // 比通用指标少：每条路由有多组直方图
+
+    struct Snapshot {
+        std::vector<uint64_t> buckets;
+        uint64_t count;
+        uint64_t sum_ns;
+
+        Snapshot() : buckets(kBucketCount, 0), count(0), sum_ns(0) {}
+
+        // q 分位数（纳秒），无样本时为 0
+        double quantile(double q) const {
+            if (count == 0) {
+                return 0.0;
+            }
+            uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(count - 1)) + 1;
+            uint64_t seen = 0;
+            for (size_t i = 0; i < buckets.size(); ++i) {
+                seen += buckets[i];
+                if (seen >= rank) {
+                    return bucketMidpoint(i);
+                }
+            }
+            return bucketMidpoint(buckets.size() - 1);
+        }
+
+        // 一次遍历计算多个分位数，qs 必须升序
+        void quantiles(const double* qs, size_t n, double* out) const {
+            size_t next = 0;
+            uint64_t seen = 0;
+            for (size_t i = 0; i < buckets.size() && next < n; ++i) {
+                seen += buckets[i];
+                while (next < n && count > 0 &&
+                       seen >= static_cast<uint64_t>(qs[next] * static_cast<double>(count - 1)) + 1) {
+                    out[next++] = bucketMidpoint(i);
+                }
+            }
+            for (; next < n; ++next) {
+                out[next] = count == 0 ? 0.0 : bucketMidpoint(buckets.size() - 1);
+            }
+        }
+
+        void merge(const Snapshot& other) {
+            for (size_t i = 0; i < buckets.size(); ++i) {
+                buckets[i] += other.buckets[i];
+            }
+            count += other.count;
+            sum_ns += other.sum_ns;
+        }
+    };
+
+    LatencyHistogram() {
+        for (size_t s = 0; s < kShards; ++s) {
+            shards_[s].sum.store(0, std::memory_order_relaxed);
+            for (size_t i = 0; i < kBucketCount; ++i) {
+                shards_[s].buckets[i].store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    static size_t bucketIndex(uint64_t ns) {
+        if (ns < kSubBuckets) {
+            return static_cast<size_t>(ns);
+        }
+        int exponent = 63 - __builtin_clzll(ns);
+        if (exponent > kMaxExponent) {
+            return kBucketCount - 1;
+        }
+        uint64_t mantissa = ns >> (exponent - kSubBucketBits);  // [kSubBuckets, 2 * kSubBuckets)
+        return static_cast<size_t>((exponent - kSubBucketBits + 1) * kSubBuckets + (mantissa - kSubBuckets));
+    }
+
+    static double bucketMidpoint(size_t index) {
+        if (index < kSubBuckets) {
+            return static_cast<double>(index);
+        }
+        int exponent = static_cast<int>(index / kSubBuckets) + kSubBucketBits - 1;
+        uint64_t mantissa = index % kSubBuckets + kSubBuckets;
+        double width = static_cast<double>(static_cast<uint64_t>(1) << (exponent - kSubBucketBits));
+        return static_cast<double>(mantissa) * width + width / 2.0;
+    }
+
+    void record(uint64_t ns) {
+        Shard& shard = shards_[detail::threadShard() & (kShards - 1)];
+        shard.buckets[bucketIndex(ns)].fetch_add(1, std::memory_order_relaxed);
+        shard.sum.fetch_add(ns, std::memory_order_relaxed);
+    }
+
+    Snapshot snapshot() const {
+        Snapshot snap;
+        for (size_t s = 0; s < kShards; ++s) {
+            for (size_t i = 0; i < kBucketCount; ++i) {
+                uint64_t n = shards_[s].buckets[i].load(std::memory_order_relaxed);
+                snap.buckets[i] += n;
+                snap.count += n;
+            }
+            snap.sum_ns += shards_[s].sum.load(std::memory_order_relaxed);
+        }
+        return snap;
+    }
+
+private:
+    struct Shard {
+        std::atomic<uint64_t> buckets[kBucketCount];
+        std::atomic<uint64_t> sum;
+        char padding[64];  // 与下一个分片的首个桶错开缓存行
+    };
+
+    Shard shards_[kShards];
+};
+
+// ========== 单个请求的计时 ==========
+
+/**
+ * @brief 请求级阶段计时，构造时绑定为当前线程的活动计时
+ *
+ * 只在同步分发期间有效：处理器返回前所有 PhaseTimer 都累计到这里。
+ */
+class RequestTiming {
+public:
+    RequestTiming() : start_ns_(monotonicNanos()), previous_(slot()) {
+        for (size_t i = 0; i < kPhaseCount; ++i) {
+            phase_ns_[i] = 0;
+        }
+        slot() = this;
+    }
+
+    ~RequestTiming() { slot() = previous_; }
+
+    RequestTiming(const RequestTiming&) = delete;
+    RequestTiming& operator=(const RequestTiming&) = delete;
+
+    static RequestTiming* active() { return slot(); }
+
+    // 嵌套的计时（如追踪作用域内的指标计时）同时累计到外层
+    void add(Phase phase, uint64_t ns) {
+        for (RequestTiming* t = this; t; t = t->previous_) {
+            t->phase_ns_[static_cast<size_t>(phase)] += ns;
+        }
+    }
+    uint64_t phase(Phase phase) const { return phase_ns_[static_cast<size_t>(phase)]; }
+    uint64_t elapsed() const { return monotonicNanos() - start_ns_; }
+
+private:
+    uint64_t start_ns_;
+    uint64_t phase_ns_[kPhaseCount];
+    RequestTiming* previous_;
+
+    static RequestTiming*& slot() {
+        static thread_local RequestTiming* current = nullptr;
+        return current;
+    }
+};
+
+/**
+ * @brief 阶段计时作用域：存在活动的 RequestTiming 时，析构时把耗时累计到对应阶段
+ */
+class PhaseTimer {
+public:
+    explicit PhaseTimer(Phase phase)
+        : timing_(RequestTiming::active()), phase_(phase), start_ns_(timing_ ? monotonicNanos() : 0) {}
+
+    ~PhaseTimer() {
+        if (timing_) {
+            timing_->add(phase_, monotonicNanos() - start_ns_);
+        }
+    }
+
+    PhaseTimer(const PhaseTimer&) = delete;
+    PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+private:
+    RequestTiming* timing_;
+    Phase phase_;
+    uint64_t start_ns_;
+};
+
+// ========== 路由统计 ==========
+
+/**
+ * @brief 一条路由的统计：按状态码类别（1xx-5xx）分组，每组为各阶段一个直方图
+ *
+ * 每组直方图在该类别首次出现时用 CAS 安装，之后只读。
+ */
+class RouteMetrics {
+public:
+    static const size_t kStatusClasses = 5;
+
+    struct PhaseSet {
+        LatencyHistogram phases[kPhaseCount];
+    };
+
+    RouteMetrics(const std::string& route, const std::string& method)
+        : route_(route), method_(method) {
+        label_text_ = "method=\"";
+        detail::appendEscapedText(label_text_, method_, true);
+        label_text_ += "\",route=\"";
+        detail::appendEscapedText(label_text_, route_, true);
+        label_text_ += '"';
+        for (size_t i = 0; i < kStatusClasses; ++i) {
+            classes_[i].store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    ~RouteMetrics() {
+        for (size_t i = 0; i < kStatusClasses; ++i) {
+            delete classes_[i].load(std::memory_order_relaxed);
+        }
+    }
+
+    RouteMetrics(const RouteMetrics&) = delete;
+    RouteMetrics& operator=(const RouteMetrics&) = delete;
+
+    const std::string& route() const { return route_; }
+    const std::string& method() const { return method_; }
+    const std::string& labelText() const { return label_text_; }  // 预渲染的 method="...",route="..."
+
+    static size_t statusClass(int status) {
+        int cls = status / 100;
+        if (cls < 1) {
+            cls = 1;
+        } else if (cls > 5) {
+            cls = 5;
+        }
+        return static_cast<size_t>(cls - 1);
+    }
+
+    void record(int status, const RequestTiming& timing) {
+        PhaseSet& set = phaseSet(statusClass(status));
+        uint64_t total = timing.elapsed();
+        uint64_t parse = timing.phase(Phase::PARSE);
+        uint64_t validation = timing.phase(Phase::VALIDATION);
+        uint64_t serialization = timing.phase(Phase::SERIALIZATION);
+        uint64_t measured = parse + validation + serialization;
+        set.phases[static_cast<size_t>(Phase::PARSE)].record(parse);
+        set.phases[static_cast<size_t>(Phase::VALIDATION)].record(validation);
+        set.phases[static_cast<size_t>(Phase::HANDLER)].record(total > measured ? total - measured : 0);
+        set.phases[static_cast<size_t>(Phase::SERIALIZATION)].record(serialization);
+        set.phases[static_cast<size_t>(Phase::TOTAL)].record(total);
+    }
+
+    // 异步完成的请求没有阶段拆分，只记录处理器和总耗时
+    void record(int status, uint64_t total_ns) {
+        PhaseSet& set = phaseSet(statusClass(status));
+        set.phases[static_cast<size_t>(Phase::HANDLER)].record(total_ns);
+        set.phases[static_cast<size_t>(Phase::TOTAL)].record(total_ns);
+    }
+
+    // 已出现过的状态码类别返回其直方图组，否则返回 nullptr
+    const PhaseSet* find(size_t status_class) const {
+        return classes_[status_class].load(std::memory_order_acquire);
+    }
+
+private:
+    std::string route_;
+    std::string method_;
+    std::string label_text_;
+    std::atomic<PhaseSet*> classes_[kStatusClasses];
+
+    PhaseSet& phaseSet(size_t index) {
+        PhaseSet* set = classes_[index].load(std::memory_order_acquire);
+        if (set) {
+            return *set;
+        }
+        PhaseSet* created = new PhaseSet();
+        if (classes_[index].compare_exchange_strong(set, created, std::memory_order_acq_rel)) {
+            return *created;
+        }
+        delete created;  // 其他线程已安装
+        return *set;
+    }
+};
+
+/**
+ * @brief 所有路由的延迟指标族，以 Prometheus summary 格式导出
+ *
+ * 路由列表写时复制：注册时加锁，抓取时只原子地读取列表；请求路径通过路由条目直接持有 RouteMetrics。
+ */
+class RouteMetricsFamily : public Metric {
+public:
+    typedef std::vector<std::shared_ptr<RouteMetrics> > RouteList;
+
+    explicit RouteMetricsFamily(const std::string& name = "uvapi_route_duration_seconds",
+                                const std::string& help = "Per-route request latency by status class and phase")
+        : Metric(name, help, MetricType::SUMMARY), routes_(std::make_shared<RouteList>()) {}
+
+    // 同一路由和方法重复注册时返回同一个对象
+    std::shared_ptr<RouteMetrics> route(const std::string& path, const std::string& method) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::shared_ptr<const RouteList> current = std::atomic_load(&routes_);
+        for (size_t i = 0; i < current->size(); ++i) {
+            if ((*current)[i]->route() == path && (*current)[i]->method() == method) {
+                return (*current)[i];
+            }
+        }
+        // 写时复制：抓取方读到的列表不会被修改
+        std::shared_ptr<RouteList> next = std::make_shared<RouteList>(*current);
+        std::shared_ptr<RouteMetrics> metrics = std::make_shared<RouteMetrics>(path, method);
+        next->push_back(metrics);
+        std::atomic_store(&routes_, std::shared_ptr<const RouteList>(next));
+        return metrics;
+    }
+
+    size_t routeCount() const {
+        return std::atomic_load(&routes_)->size();
+    }
+
+    void appendTo(std::string& out, ExpositionFormat /*format*/) const override {
+        static const size_t kQuantileCount = 4;
+        static const double kQuantiles[kQuantileCount] = { 0.5, 0.9, 0.99, 0.999 };
+        static const char* const kClassLabels[] = { "1xx", "2xx", "3xx", "4xx", "5xx" };
+        static const std::string kQuantileLabels[kQuantileCount] = {
+            "quantile=\"0.5\"", "quantile=\"0.9\"", "quantile=\"0.99\"", "quantile=\"0.999\""
+        };
+
+        std::shared_ptr<const RouteList> routes = std::atomic_load(&routes_);
+        appendHeader(out, name_, "summary");
+
+        std::string labels;
+        double values[kQuantileCount];
+        for (size_t r = 0; r < routes->size(); ++r) {
+            const RouteMetrics& route = *(*routes)[r];
+            for (size_t c = 0; c < RouteMetrics::kStatusClasses; ++c) {
+                const RouteMetrics::PhaseSet* set = route.find(c);
+                if (!set) {
+                    continue;
+                }
+                for (size_t p = 0; p < kPhaseCount; ++p) {
+                    LatencyHistogram::Snapshot snap = set->phases[p].snapshot();
+                    snap.quantiles(kQuantiles, kQuantileCount, values);
+
+                    labels = route.labelText();
+                    labels.append(",status=\"", 9);
+                    labels.append(kClassLabels[c]);
+                    labels.append("\",phase=\"", 9);
+                    labels.append(phaseName(static_cast<Phase>(p)));
+                    labels += '"';
+
+                    for (size_t q = 0; q < kQuantileCount; ++q) {
+                        detail::appendSeries(out, name_, nullptr, labels, &kQuantileLabels[q]);
+                        detail::appendSampleValue(out, values[q] / 1e9);
+                        out += '\n';
+                    }
+                    detail::appendSeries(out, name_, "_sum", labels, nullptr);
+                    detail::appendSampleValue(out, static_cast<double>(snap.sum_ns) / 1e9);
+                    out += '\n';
+                    detail::appendSeries(out, name_, "_count", labels, nullptr);
+                    json::appendUnsigned(out, snap.count);
+                    out += '\n';
+                }
+            }
+        }
+    }
+
+private:
+    std::shared_ptr<const RouteList> routes_;  // 通过 std::atomic_load / atomic_store 访问；mutex_ 串行化注册
+};
+
+} // namespace metrics
+} // namespace uvapi
+
+#endif // UVAPI_ROUTE_METRICS_H
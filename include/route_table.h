@@ -0,0 +1,297 @@
+/**
+ * @file route_table.h
+ * @brief 路由表：一次匹配同时得到路由 ID 和路径参数
+ *
+ * 注册时把路由模式拆成分段前缀树，每个节点按 HTTP 方法保存稠密的路由 ID。
+ * 请求到达时只遍历一次路径：
+ * - 静态分段优先，其次 `:name` 参数分段，最后 `*` 通配分段
+ * - 匹配成功返回路由 ID（handlers 向量下标），同时写出路径参数
+ * - 匹配过程中不分配内存，路径参数只在匹配成功后写入
+ *
+ * @code
+ * uvapi::server::RouteTable table;
+ * int id = table.add("/api/users/:id", 1);          // 1 = GET
+ * std::map<std::string, std::string> params;
+ * int hit = table.match("/api/users/42", 1, &params); // hit == id, params["id"] == "42"
+ * @endcode
+ */
+
+#ifndef ROUTE_TABLE_H
+#define ROUTE_TABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace uvapi {
+namespace server {
+
+class RouteTable {
+public:
+    static const int kNoRoute = -1;
+    static const int kMethodCount = 8;   // 与 HttpMethod 枚举对应（ANY = 0）
+    static const int kMaxParams = 16;
+
+    // 路径参数切片
+    struct RouteParam {
+        const std::string* name;
+        const char* value;
+        size_t length;
+    };
+
+    /**
+     * @brief 注册路由模式
+     * @param pattern 路由模式，如 "/users/:id"，末尾 "*" 为通配分段
+     * @param method HttpMethod 的整数值，0 (ANY) 匹配所有方法
+     * @return 稠密路由 ID；同一模式和方法重复注册时返回已有 ID，模式非法时返回 kNoRoute
+     */
+    int add(const std::string& pattern, int method) {
+        if (method < 0 || method >= kMethodCount) {
+            return kNoRoute;
+        }
+
+        uint32_t node = 0;
+        int param_count = 0;
+        size_t pos = 0;
+        const size_t len = pattern.size();
+        while (nextSegment(pattern.c_str(), len, pos)) {
+            size_t start = pos;
+            while (pos < len && pattern[pos] != '/') {
+                ++pos;
+            }
+            std::string segment = pattern.substr(start, pos - start);
+
+            if (segment[0] == ':' || segment[0] == '*') {
+                bool wildcard = segment[0] == '*';
+                std::string name = wildcard ? (segment.size() > 1 ? segment.substr(1) : std::string("*"))
+                                            : segment.substr(1);
+                if (name.empty() || ++param_count > kMaxParams) {
+                    return kNoRoute;
+                }
+                if (wildcard && pos < len && pattern.find_first_not_of('/', pos) != std::string::npos) {
+                    return kNoRoute;  // 通配分段只能位于末尾
+                }
+                int32_t child = wildcard ? nodes_[node].wildcard_child : nodes_[node].param_child;
+                if (child < 0) {
+                    // newNode() 可能使 nodes_ 重新分配，之后必须按下标重新访问
+                    int32_t created = newNode();
+                    if (wildcard) {
+                        nodes_[node].wildcard_child = created;
+                    } else {
+                        nodes_[node].param_child = created;
+                    }
+                    nodes_[static_cast<size_t>(created)].param_name = name;
+                    node = static_cast<uint32_t>(created);
+                } else {
+                    node = static_cast<uint32_t>(child);
+                    if (nodes_[node].param_name != name) {
+                        return kNoRoute;  // 同一位置的参数名必须一致
+                    }
+                }
+                if (wildcard) {
+                    break;
+                }
+            } else {
+                int32_t child = findStatic(nodes_[node], segment.c_str(), segment.size());
+                if (child < 0) {
+                    child = newNode();
+                    nodes_[node].static_children.push_back(
+                        std::make_pair(segment, static_cast<uint32_t>(child)));
+                }
+                node = static_cast<uint32_t>(child);
+            }
+        }
+
+        int32_t& slot = nodes_[node].routes[method];
+        if (slot < 0) {
+            slot = static_cast<int32_t>(route_count_++);
+        }
+        return slot;
+    }
+
+    /**
+     * @brief 匹配请求路径
+     * @param path 请求路径（不含查询字符串）
+     * @param method HttpMethod 的整数值
+     * @param params 输出路径参数，可为 nullptr
+     * @return 路由 ID，未命中返回 kNoRoute
+     */
+    int match(const char* path, int method, std::map<std::string, std::string>* params) const {
+        if (!path || nodes_.empty()) {
+            return kNoRoute;
+        }
+        return match(path, std::strlen(path), method, params);
+    }
+
+    int match(const char* path, size_t len, int method, std::map<std::string, std::string>* params) const {
+        RouteParam captured[kMaxParams];
+        int count = 0;
+        int id = match(path, len, method, captured, &count);
+        if (id != kNoRoute && params) {
+            for (int i = 0; i < count; ++i) {
+                (*params)[*captured[i].name].assign(captured[i].value, captured[i].length);
+            }
+        }
+        return id;
+    }
+
+    /**
+     * @brief 匹配请求路径，路径参数以切片形式输出（不分配内存）
+     * @param out 至少 kMaxParams 个元素；name 指向路由表内部字符串，value 指向 path
+     * @param out_count 输出参数个数
+     */
+    int match(const char* path, size_t len, int method, RouteParam* out, int* out_count) const {
+        if (out_count) {
+            *out_count = 0;
+        }
+        if (!path || method < 0 || method >= kMethodCount) {
+            return kNoRoute;
+        }
+        Capture captures[kMaxParams];
+        int capture_count = 0;
+        int id = matchNode(0, path, len, 0, method, captures, capture_count);
+        if (id != kNoRoute && out && out_count) {
+            for (int i = 0; i < capture_count; ++i) {
+                out[i].name = &nodes_[captures[i].node].param_name;
+                out[i].value = path + captures[i].start;
+                out[i].length = captures[i].length;
+            }
+            *out_count = capture_count;
+        }
+        return id;
+    }
+
+    size_t size() const { return route_count_; }
+    bool empty() const { return route_count_ == 0; }
+
+    void clear() {
+        nodes_.clear();
+        nodes_.push_back(Node());
+        route_count_ = 0;
+    }
+
+    RouteTable() : route_count_(0) {
+        nodes_.push_back(Node());
+    }
+
+private:
+    struct Node {
+        std::vector<std::pair<std::string, uint32_t> > static_children;
+        int32_t param_child;
+        int32_t wildcard_child;
+        std::string param_name;
+        int32_t routes[kMethodCount];
+
+        Node() : param_child(-1), wildcard_child(-1) {
+            for (int i = 0; i < kMethodCount; ++i) {
+                routes[i] = -1;
+            }
+        }
+    };
+
+    struct Capture {
+        uint32_t node;
+        size_t start;
+        size_t length;
+    };
+
+    std::vector<Node> nodes_;
+    size_t route_count_;
+
+    int32_t newNode() {
+        nodes_.push_back(Node());
+        return static_cast<int32_t>(nodes_.size() - 1);
+    }
+
+    // 跳过连续的 '/'，返回是否还有下一个分段
+    static bool nextSegment(const char* s, size_t len, size_t& pos) {
+        while (pos < len && s[pos] == '/') {
+            ++pos;
+        }
+        return pos < len;
+    }
+
+    static int32_t findStatic(const Node& node, const char* seg, size_t seg_len) {
+        for (size_t i = 0; i < node.static_children.size(); ++i) {
+            const std::string& name = node.static_children[i].first;
+            if (name.size() == seg_len && std::memcmp(name.data(), seg, seg_len) == 0) {
+                return static_cast<int32_t>(node.static_children[i].second);
+            }
+        }
+        return -1;
+    }
+
+    int routeFor(const Node& node, int method) const {
+        if (node.routes[method] >= 0) {
+            return node.routes[method];
+        }
+        return node.routes[0];  // ANY
+    }
+
+    int matchNode(uint32_t node_index, const char* path, size_t len, size_t pos, int method,
+                  Capture* captures, int& capture_count) const {
+        const Node& node = nodes_[node_index];
+        if (!nextSegment(path, len, pos)) {
+            int id = routeFor(node, method);
+            if (id >= 0) {
+                return id;
+            }
+            // 允许 "/static/*" 匹配 "/static"
+            if (node.wildcard_child >= 0) {
+                const Node& wild = nodes_[static_cast<size_t>(node.wildcard_child)];
+                id = routeFor(wild, method);
+                if (id >= 0 && capture_count < kMaxParams) {
+                    Capture c = { static_cast<uint32_t>(node.wildcard_child), pos, 0 };
+                    captures[capture_count++] = c;
+                    return id;
+                }
+            }
+            return kNoRoute;
+        }
+
+        size_t end = pos;
+        while (end < len && path[end] != '/') {
+            ++end;
+        }
+
+        int32_t child = findStatic(node, path + pos, end - pos);
+        if (child >= 0) {
+            int id = matchNode(static_cast<uint32_t>(child), path, len, end, method, captures, capture_count);
+            if (id >= 0) {
+                return id;
+            }
+        }
+
+        if (node.param_child >= 0 && capture_count < kMaxParams) {
+            int saved = capture_count;
+            Capture c = { static_cast<uint32_t>(node.param_child), pos, end - pos };
+            captures[capture_count++] = c;
+            int id = matchNode(static_cast<uint32_t>(node.param_child), path, len, end, method,
+                               captures, capture_count);
+            if (id >= 0) {
+                return id;
+            }
+            capture_count = saved;
+        }
+
+        if (node.wildcard_child >= 0 && capture_count < kMaxParams) {
+            int id = routeFor(nodes_[static_cast<size_t>(node.wildcard_child)], method);
+            if (id >= 0) {
+                Capture c = { static_cast<uint32_t>(node.wildcard_child), pos, len - pos };
+                captures[capture_count++] = c;
+                return id;
+            }
+        }
+
+        return kNoRoute;
+    }
+};
+
+} // namespace server
+} // namespace uvapi
+
+#endif // ROUTE_TABLE_H
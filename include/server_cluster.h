@@ -0,0 +1,215 @@
+/**
+ * @file server_cluster.h
+ * @brief 多核服务器模式：每核一个事件循环，SO_REUSEPORT 分流连接
+ *
+ * 路由只在原型 Server 上注册一次，启动时复制到每个工作线程：
+ * - 每个工作线程拥有独立的 uv_loop_t、uvhttp 上下文和路由表
+ * - 所有工作线程以 SO_REUSEPORT 监听同一端口，由内核分配连接
+ * - 处理器在多个线程中并发执行，必须是线程安全的
+ *
+ * @code
+ * uv_loop_t* loop = uv_default_loop();
+ * uvapi::server::Server prototype(loop);   // 只用于注册路由，不监听
+ * prototype.addRoute("/", uvapi::HttpMethod::GET, handler);
+ *
+ * uvapi::server::ServerCluster cluster(prototype, 0);  // 0 = CPU 核数
+ * if (cluster.listen("0.0.0.0", 8080)) {
+ *     cluster.join();
+ * }
+ * @endcode
+ */
+
+#ifndef UVAPI_SERVER_CLUSTER_H
+#define UVAPI_SERVER_CLUSTER_H
+
+#include "framework.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace uvapi {
+namespace server {
+
+class ServerCluster {
+public:
+    /**
+     * @param prototype 已注册路由的原型 Server，集群运行期间必须保持有效
+     * @param workers 工作线程数，<= 0 时使用 std::thread::hardware_concurrency()
+     */
+    ServerCluster(const Server& prototype, int workers)
+        : prototype_(prototype), ready_count_(0), failed_(false) {
+        if (workers <= 0) {
+            workers = static_cast<int>(std::thread::hardware_concurrency());
+        }
+        if (workers <= 0) {
+            workers = 1;
+        }
+        for (int i = 0; i < workers; i++) {
+            workers_.push_back(std::unique_ptr<Worker>(new Worker()));
+        }
+    }
+
+    ~ServerCluster() {
+        stop();
+        join();
+    }
+
+    ServerCluster(const ServerCluster&) = delete;
+    ServerCluster& operator=(const ServerCluster&) = delete;
+
+    /**
+     * @brief 启动所有工作线程并等待其完成监听
+     * @return 所有工作线程都监听成功时返回 true；否则已启动的线程会被停止
+     */
+    bool listen(const std::string& host, int port) {
+        if (!threads_.empty()) {
+            return false;
+        }
+        host_ = host;
+        port_ = port;
+        ready_count_ = 0;
+        failed_ = false;
+
+        for (size_t i = 0; i < workers_.size(); i++) {
+            threads_.push_back(std::thread(&ServerCluster::runWorker, this, workers_[i].get()));
+        }
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this]() { return ready_count_ == workers_.size(); });
+        bool ok = !failed_;
+        lock.unlock();
+
+        if (!ok) {
+            stop();
+            join();
+        }
+        return ok;
+    }
+
+    // 通知所有工作线程停止（可从任意线程调用）
+    void stop() {
+        for (size_t i = 0; i < workers_.size(); i++) {
+            Worker* worker = workers_[i].get();
+            std::lock_guard<std::mutex> lock(worker->mutex);
+            if (worker->running) {
+                uv_async_send(&worker->stop_async);
+            }
+        }
+    }
+
+    // 等待所有工作线程退出
+    void join() {
+        for (size_t i = 0; i < threads_.size(); i++) {
+            if (threads_[i].joinable()) {
+                threads_[i].join();
+            }
+        }
+        threads_.clear();
+    }
+
+    size_t workerCount() const { return workers_.size(); }
+
+    // 所有运行中工作线程的连接统计合计
+    ConnectionStats connectionStats() const {
+        ConnectionStats total;
+        for (size_t i = 0; i < workers_.size(); i++) {
+            Worker& worker = *workers_[i];
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            if (worker.running && worker.server) {
+                accumulate(total, worker.server->connectionStats());
+            }
+        }
+        return total;
+    }
+
+private:
+    struct Worker {
+        uv_loop_t loop;
+        uv_async_t stop_async;
+        std::unique_ptr<Server> server;
+        std::mutex mutex;
+        bool running;
+
+        Worker() : running(false) {}
+    };
+
+    const Server& prototype_;
+    std::vector<std::unique_ptr<Worker> > workers_;
+    std::vector<std::thread> threads_;
+    std::string host_;
+    int port_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    size_t ready_count_;
+    bool failed_;
+
+    void reportReady(bool ok) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!ok) {
+            failed_ = true;
+        }
+        ready_count_++;
+        cv_.notify_all();
+    }
+
+    static void onStopAsync(uv_async_t* handle) {
+        Worker* worker = static_cast<Worker*>(handle->data);
+        if (worker->server) {
+            worker->server->stop();
+        }
+        uv_stop(&worker->loop);
+    }
+
+    static void onCloseWalk(uv_handle_t* handle, void* /*arg*/) {
+        if (!uv_is_closing(handle)) {
+            uv_close(handle, nullptr);
+        }
+    }
+
+    void runWorker(Worker* worker) {
+        if (uv_loop_init(&worker->loop) != 0) {
+            reportReady(false);
+            return;
+        }
+        uv_async_init(&worker->loop, &worker->stop_async, onStopAsync);
+        worker->stop_async.data = worker;
+
+        // 每个工作线程独立的 Server：复制路由和 TLS 配置，以 SO_REUSEPORT 监听
+        worker->server.reset(new Server(&worker->loop));
+        worker->server->importRoutes(prototype_);
+        if (prototype_.getTlsConfig().enabled) {
+            worker->server->enableTls(prototype_.getTlsConfig());
+        }
+        worker->server->setReusePort(workers_.size() > 1);
+
+        bool ok = worker->server->listen(host_, port_);
+        {
+            std::lock_guard<std::mutex> lock(worker->mutex);
+            worker->running = true;
+        }
+        reportReady(ok);
+
+        if (ok) {
+            uv_run(&worker->loop, UV_RUN_DEFAULT);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(worker->mutex);
+            worker->running = false;
+        }
+
+        // 释放 Server 后关闭剩余句柄，再关闭循环
+        worker->server.reset();
+        uv_walk(&worker->loop, onCloseWalk, nullptr);
+        uv_run(&worker->loop, UV_RUN_DEFAULT);
+        uv_loop_close(&worker->loop);
+    }
+};
+
+} // namespace server
+} // namespace uvapi
+
+#endif // UVAPI_SERVER_CLUSTER_H
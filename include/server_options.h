@@ -0,0 +1,278 @@
+/**
+ * @file server_options.h
+ * @brief 连接层调优选项与连接统计
+ *
+ * - ServerOptions：keep-alive 超时、单连接最大请求数、读缓冲区和头部上限、TCP_NODELAY、
+ *   TCP keepalive、监听 backlog。uvhttp 配置中存在对应字段时直接写入（按成员探测，
+ *   不同版本的 uvhttp 字段不同）；keep-alive 超时、单连接请求上限和套接字选项由框架按连接执行
+ * - ConnectionTracker：按客户端句柄记录每个连接的请求数和进行中的请求，
+ *   句柄地址被新连接复用时按对端地址区分
+ *
+ * 默认选项不改变 uvhttp 的行为，也不跟踪连接；设置任一按连接执行的选项
+ * （或 trackConnections(true)）后开始跟踪，每个请求多一次哈希查找和一次 getpeername。
+ *
+ * @code
+ * uvapi::server::ServerOptions options;
+ * options.keepAliveTimeout(std::chrono::seconds(75))  // 大于负载均衡的空闲超时
+ *        .maxRequestsPerConnection(10000)
+ *        .tcpNoDelay(true)
+ *        .listenBacklog(1024);
+ * uvapi::restful::Api api(loop, options);
+ * @endcode
+ */
+
+#ifndef UVAPI_SERVER_OPTIONS_H
+#define UVAPI_SERVER_OPTIONS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+
+namespace uvapi {
+namespace server {
+
+// ========== 连接选项 ==========
+
+struct ServerOptions {
+    std::chrono::milliseconds keepalive_timeout;  // 空闲连接超时，0 表示使用 uvhttp 默认
+    uint64_t max_requests_per_connection;         // 达到后响应带 Connection: close，0 表示不限制
+    size_t read_buffer_size;                      // 0 表示使用 uvhttp 默认
+    size_t max_header_size;                       // 0 表示使用 uvhttp 默认
+    size_t max_connections;                       // 0 表示使用 uvhttp 默认
+    int listen_backlog;                           // 0 表示使用 uvhttp 默认
+    bool tcp_nodelay;
+    unsigned tcp_keepalive_seconds;               // TCP keepalive 探测间隔，0 表示不开启
+    bool track_connections;                       // 即使没有按连接执行的选项也统计连接
+
+    ServerOptions()
+        : keepalive_timeout(0)
+        , max_requests_per_connection(0)
+        , read_buffer_size(0)
+        , max_header_size(0)
+        , max_connections(0)
+        , listen_backlog(0)
+        , tcp_nodelay(false)
+        , tcp_keepalive_seconds(0)
+        , track_connections(false) {}
+
+    ServerOptions& keepAliveTimeout(std::chrono::milliseconds timeout) {
+        keepalive_timeout = timeout;
+        return *this;
+    }
+
+    ServerOptions& maxRequestsPerConnection(uint64_t count) {
+        max_requests_per_connection = count;
+        return *this;
+    }
+
+    ServerOptions& readBufferSize(size_t bytes) {
+        read_buffer_size = bytes;
+        return *this;
+    }
+
+    ServerOptions& maxHeaderSize(size_t bytes) {
+        max_header_size = bytes;
+        return *this;
+    }
+
+    ServerOptions& maxConnections(size_t count) {
+        max_connections = count;
+        return *this;
+    }
+
+    ServerOptions& listenBacklog(int backlog) {
+        listen_backlog = backlog;
+        return *this;
+    }
+
+    ServerOptions& tcpNoDelay(bool enabled) {
+        tcp_nodelay = enabled;
+        return *this;
+    }
+
+    ServerOptions& tcpKeepAlive(unsigned seconds) {
+        tcp_keepalive_seconds = seconds;
+        return *this;
+    }
+
+    ServerOptions& trackConnections(bool enabled) {
+        track_connections = enabled;
+        return *this;
+    }
+
+    // 是否需要按连接跟踪
+    bool tracksConnections() const {
+        return track_connections || keepalive_timeout.count() > 0 || max_requests_per_connection > 0 ||
+               tcp_nodelay || tcp_keepalive_seconds > 0;
+    }
+};
+
+// ========== 连接统计 ==========
+
+struct ConnectionStats {
+    size_t active;          // 当前打开的连接（收到过请求的）
+    size_t idle;            // 其中没有进行中请求的连接
+    uint64_t opened;        // 累计连接数
+    uint64_t reused;        // 累计承载过不止一个请求的连接数
+    uint64_t closed;        // 累计关闭的连接数
+    uint64_t requests;      // 累计请求数
+    uint64_t max_requests;  // 单个连接承载的最多请求数
+
+    ConnectionStats()
+        : active(0), idle(0), opened(0), reused(0), closed(0), requests(0), max_requests(0) {}
+
+    double requestsPerConnection() const {
+        return opened > 0 ? static_cast<double>(requests) / static_cast<double>(opened) : 0.0;
+    }
+};
+
+/**
+ * @brief 单个事件循环内的连接表
+ *
+ * 连接表只在事件循环线程修改；统计计数为原子变量，stats() 可在任意线程调用。
+ * 句柄只作为键比较，不解引用；连接是否仍然打开由 prune() 的调用方判定。
+ */
+class ConnectionTracker {
+public:
+    struct Connection {
+        uint64_t peer;       // 对端地址摘要，用于识别复用了同一句柄地址的新连接
+        uint64_t requests;
+        uint32_t in_flight;
+        uint64_t last_active_ms;
+        bool draining;       // 已决定关闭：不再复用，空闲后半关闭
+
+        Connection() : peer(0), requests(0), in_flight(0), last_active_ms(0), draining(false) {}
+    };
+
+    ConnectionTracker()
+        : active_(0), idle_(0), opened_(0), reused_(0), closed_(0), requests_(0), max_requests_(0) {}
+
+    ConnectionTracker(const ConnectionTracker&) = delete;
+    ConnectionTracker& operator=(const ConnectionTracker&) = delete;
+
+    /**
+     * @brief 请求开始
+     * @param fresh 输出：是否为新连接（首次见到，或同一句柄地址上的对端已变化）
+     */
+    Connection& begin(const void* handle, uint64_t peer, uint64_t now_ms, bool& fresh) {
+        std::pair<Map::iterator, bool> inserted = connections_.insert(Map::value_type(handle, Connection()));
+        Connection& connection = inserted.first->second;
+        fresh = inserted.second || connection.peer != peer;
+        if (fresh) {
+            if (!inserted.second) {
+                retire(connection);  // 旧连接已关闭，句柄地址被新连接复用
+            }
+            active_.fetch_add(1, std::memory_order_relaxed);
+            connection = Connection();
+            connection.peer = peer;
+            opened_.fetch_add(1, std::memory_order_relaxed);
+        } else if (connection.in_flight == 0) {
+            idle_.fetch_sub(1, std::memory_order_relaxed);
+        }
+        connection.requests++;
+        connection.in_flight++;
+        connection.last_active_ms = now_ms;
+        requests_.fetch_add(1, std::memory_order_relaxed);
+        if (connection.requests == 2) {
+            reused_.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (connection.requests > max_requests_.load(std::memory_order_relaxed)) {
+            max_requests_.store(connection.requests, std::memory_order_relaxed);
+        }
+        return connection;
+    }
+
+    // 请求结束（响应已交给连接），返回该连接的记录；未跟踪或已被新连接取代时返回 nullptr
+    Connection* end(const void* handle, uint64_t peer, uint64_t now_ms) {
+        Map::iterator it = connections_.find(handle);
+        if (it == connections_.end() || it->second.peer != peer || it->second.in_flight == 0) {
+            return nullptr;
+        }
+        if (--it->second.in_flight == 0) {
+            idle_.fetch_add(1, std::memory_order_relaxed);
+        }
+        it->second.last_active_ms = now_ms;
+        return &it->second;
+    }
+
+    // 移除 is_live(handle) 返回 false 的连接
+    template<typename Fn>
+    void prune(Fn is_live) {
+        Map::iterator it = connections_.begin();
+        while (it != connections_.end()) {
+            if (is_live(it->first)) {
+                ++it;
+                continue;
+            }
+            retire(it->second);
+            it = connections_.erase(it);
+        }
+    }
+
+    // 对空闲超过 idle_ms、尚未标记关闭的连接调用 fn(handle)，fn 返回 true 时标记为关闭中
+    template<typename Fn>
+    void forEachIdle(uint64_t now_ms, uint64_t idle_ms, Fn fn) {
+        for (Map::iterator it = connections_.begin(); it != connections_.end(); ++it) {
+            Connection& connection = it->second;
+            if (connection.in_flight == 0 && !connection.draining &&
+                now_ms - connection.last_active_ms >= idle_ms && fn(it->first)) {
+                connection.draining = true;
+            }
+        }
+    }
+
+    ConnectionStats stats() const {
+        ConnectionStats stats;
+        stats.active = active_.load(std::memory_order_relaxed);
+        stats.idle = idle_.load(std::memory_order_relaxed);
+        stats.opened = opened_.load(std::memory_order_relaxed);
+        stats.reused = reused_.load(std::memory_order_relaxed);
+        stats.closed = closed_.load(std::memory_order_relaxed);
+        stats.requests = requests_.load(std::memory_order_relaxed);
+        stats.max_requests = max_requests_.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    size_t size() const { return connections_.size(); }
+
+private:
+    typedef std::unordered_map<const void*, Connection> Map;
+
+    Map connections_;
+    std::atomic<size_t> active_;
+    std::atomic<size_t> idle_;
+    std::atomic<uint64_t> opened_;
+    std::atomic<uint64_t> reused_;
+    std::atomic<uint64_t> closed_;
+    std::atomic<uint64_t> requests_;
+    std::atomic<uint64_t> max_requests_;
+
+    void retire(const Connection& connection) {
+        active_.fetch_sub(1, std::memory_order_relaxed);
+        if (connection.in_flight == 0) {
+            idle_.fetch_sub(1, std::memory_order_relaxed);
+        }
+        closed_.fetch_add(1, std::memory_order_relaxed);
+    }
+};
+
+// 多个连接表（多核模式下各工作线程一份）的合计；max_requests 取最大值
+inline void accumulate(ConnectionStats& total, const ConnectionStats& part) {
+    total.active += part.active;
+    total.idle += part.idle;
+    total.opened += part.opened;
+    total.reused += part.reused;
+    total.closed += part.closed;
+    total.requests += part.requests;
+    if (part.max_requests > total.max_requests) {
+        total.max_requests = part.max_requests;
+    }
+}
+
+} // namespace server
+} // namespace uvapi
+
+#endif // UVAPI_SERVER_OPTIONS_H
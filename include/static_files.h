@@ -0,0 +1,875 @@
+/**
+ * @file static_files.h
+ * @brief 静态文件服务：元数据缓存、内存映射的文件内容和条件 / 范围请求
+ *
+ * 由 Server::serveStatic() 使用，也可以单独使用：
+ * - 每个文件的 stat 结果、强 ETag、Last-Modified、Content-Type 和预压缩兄弟文件
+ *   （.br / .gz）在首次请求时解析一次，之后命中缓存不再访问文件系统
+ * - 文件内容通过 mmap 映射，小文件的映射常驻缓存（按字节数 LRU 淘汰），
+ *   大文件每次请求单独映射；请求路径上没有 read() 和 std::string 拷贝
+ * - 缓存由 uv_fs_event 目录监视器即时失效（见 Server），另按 revalidate_interval
+ *   兜底重新 stat，监视器不可用时也不会一直返回旧内容
+ * - 路径按段规范化，拒绝 ".."、NUL 和反斜杠；符号链接解析后必须仍在根目录内
+ *
+ * 注意：映射期间被原地截断的文件会在读取时触发 SIGBUS。部署时请用
+ * “写入临时文件再 rename” 的方式替换文件（新 inode，旧映射保持有效）。
+ *
+ * @code
+ * server->serveStatic("/assets", "./public",
+ *                     uvapi::server::StaticOptions()
+ *                         .cacheControl("public, max-age=31536000, immutable")
+ *                         .fallback("index.html"));
+ * @endcode
+ */
+
+#ifndef UVAPI_STATIC_FILES_H
+#define UVAPI_STATIC_FILES_H
+
+#include "request_view.h"
+
+#include <chrono>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace uvapi {
+namespace server {
+
+// ========== 静态文件选项 ==========
+
+struct StaticOptions {
+    std::string index_file;     // 目录请求返回的文件，空表示目录请求返回 404
+    std::string fallback_file;  // 无扩展名的路径未找到时返回的文件（单页应用），空表示不回退
+    std::string cache_control;  // 空表示不设置 Cache-Control
+    bool precompressed;         // 按 Accept-Encoding 选择 .br / .gz 兄弟文件
+    bool dotfiles;              // 是否允许访问以 '.' 开头的路径段
+    size_t max_cached_file;     // 超过此大小的文件不常驻映射，每次请求单独映射
+    size_t max_cache_bytes;     // 常驻映射的合计上限
+    size_t max_entries;         // 元数据条目上限
+    std::chrono::milliseconds revalidate_interval;  // 兜底重新 stat 的间隔
+
+    StaticOptions()
+        : index_file("index.html")
+        , cache_control("public, max-age=0")
+        , precompressed(true)
+        , dotfiles(false)
+        , max_cached_file(1024 * 1024)
+        , max_cache_bytes(64 * 1024 * 1024)
+        , max_entries(4096)
+        , revalidate_interval(2000) {}
+
+    StaticOptions& indexFile(const std::string& name) {
+        index_file = name;
+        return *this;
+    }
+
+    StaticOptions& fallback(const std::string& name) {
+        fallback_file = name;
+        return *this;
+    }
+
+    StaticOptions& cacheControl(const std::string& value) {
+        cache_control = value;
+        return *this;
+    }
+
+    StaticOptions& usePrecompressed(bool enabled) {
+        precompressed = enabled;
+        return *this;
+    }
+
+    StaticOptions& allowDotfiles(bool enabled) {
+        dotfiles = enabled;
+        return *this;
+    }
+
+    StaticOptions& maxCachedFile(size_t bytes) {
+        max_cached_file = bytes;
+        return *this;
+    }
+
+    StaticOptions& maxCacheBytes(size_t bytes) {
+        max_cache_bytes = bytes;
+        return *this;
+    }
+
+    StaticOptions& maxEntries(size_t count) {
+        max_entries = count;
+        return *this;
+    }
+
+    StaticOptions& revalidateEvery(std::chrono::milliseconds interval) {
+        revalidate_interval = interval;
+        return *this;
+    }
+};
+
+// ========== 路径规范化 ==========
+
+inline int staticHexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+/**
+ * @brief 把 URL 路径（前缀之后的部分）规范化为根目录下的相对路径
+ *
+ * 解码 %XX，去掉空段和 "."，遇到 ".."、NUL、控制字符或反斜杠时返回 false；
+ * dotfiles 为 false 时以 '.' 开头的段同样拒绝。结果不以 '/' 开头，
+ * 原路径以 '/' 结尾时保留结尾的 '/'（表示目录）。遇到 '?' 或 '#' 停止。
+ */
+inline bool normalizeStaticPath(const char* data, size_t size, bool dotfiles, std::string& out) {
+    out.clear();
+    size_t end = 0;
+    while (end < size && data[end] != '?' && data[end] != '#') {
+        end++;
+    }
+    std::string segment;
+    for (size_t i = 0; i <= end; i++) {
+        char c = i < end ? data[i] : '/';
+        if (c == '/') {
+            if (segment == "..") {
+                return false;
+            }
+            if (!segment.empty() && segment != ".") {
+                if (!dotfiles && segment[0] == '.') {
+                    return false;
+                }
+                if (!out.empty()) {
+                    out += '/';
+                }
+                out += segment;
+            }
+            segment.clear();
+            continue;
+        }
+        if (c == '%') {
+            if (i + 2 >= end || staticHexValue(data[i + 1]) < 0 || staticHexValue(data[i + 2]) < 0) {
+                return false;
+            }
+            c = static_cast<char>(staticHexValue(data[i + 1]) * 16 + staticHexValue(data[i + 2]));
+            // 编码后的 '/' 不作为分隔符，直接拒绝
+            if (c == '/') {
+                return false;
+            }
+            i += 2;
+        }
+        if (c == '\0' || c == '\\' || static_cast<unsigned char>(c) < 0x20 || c == 0x7f) {
+            return false;
+        }
+        segment += c;
+    }
+    if (end > 0 && data[end - 1] == '/' && !out.empty()) {
+        out += '/';
+    }
+    return true;
+}
+
+// ========== MIME 类型 ==========
+
+inline const char* staticMimeType(const std::string& path) {
+    static const struct {
+        const char* ext;
+        const char* type;
+    } kTypes[] = {
+        { "html", "text/html; charset=utf-8" },
+        { "htm", "text/html; charset=utf-8" },
+        { "css", "text/css; charset=utf-8" },
+        { "js", "text/javascript; charset=utf-8" },
+        { "mjs", "text/javascript; charset=utf-8" },
+        { "json", "application/json" },
+        { "map", "application/json" },
+        { "txt", "text/plain; charset=utf-8" },
+        { "xml", "application/xml" },
+        { "svg", "image/svg+xml" },
+        { "png", "image/png" },
+        { "jpg", "image/jpeg" },
+        { "jpeg", "image/jpeg" },
+        { "gif", "image/gif" },
+        { "webp", "image/webp" },
+        { "avif", "image/avif" },
+        { "ico", "image/x-icon" },
+        { "woff", "font/woff" },
+        { "woff2", "font/woff2" },
+        { "ttf", "font/ttf" },
+        { "otf", "font/otf" },
+        { "wasm", "application/wasm" },
+        { "pdf", "application/pdf" },
+        { "mp4", "video/mp4" },
+        { "webm", "video/webm" },
+        { "mp3", "audio/mpeg" },
+        { "wav", "audio/wav" },
+        { "zip", "application/zip" },
+    };
+    size_t slash = path.rfind('/');
+    size_t dot = path.rfind('.');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+        return "application/octet-stream";
+    }
+    StringSlice ext(path.data() + dot + 1, path.size() - dot - 1);
+    for (size_t i = 0; i < sizeof(kTypes) / sizeof(kTypes[0]); i++) {
+        if (ext.equalsIgnoreCase(kTypes[i].ext, std::strlen(kTypes[i].ext))) {
+            return kTypes[i].type;
+        }
+    }
+    return "application/octet-stream";
+}
+
+// ========== HTTP 日期 ==========
+
+// IMF-fixdate（RFC 7231），不依赖 locale；buffer 至少 30 字节
+inline size_t formatHttpDate(int64_t seconds, char* buffer, size_t size) {
+    static const char* const kDays[] = { "Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat" };
+    static const char* const kMonths[] = { "Jan", "Feb", "Mar", "Apr", "May", "Jun",
+                                           "Jul", "Aug", "Sep", "Oct", "Nov", "Dec" };
+    time_t t = static_cast<time_t>(seconds);
+    struct tm tm;
+    if (!gmtime_r(&t, &tm)) {
+        return 0;
+    }
+    int written = std::snprintf(buffer, size, "%s, %02d %s %04d %02d:%02d:%02d GMT",
+                                kDays[tm.tm_wday], tm.tm_mday, kMonths[tm.tm_mon], tm.tm_year + 1900,
+                                tm.tm_hour, tm.tm_min, tm.tm_sec);
+    return written > 0 && static_cast<size_t>(written) < size ? static_cast<size_t>(written) : 0;
+}
+
+// 只接受 IMF-fixdate（RFC 7231 要求发送方使用的格式），其他格式返回 false
+inline bool parseHttpDate(StringSlice value, int64_t& seconds) {
+    static const char kMonths[] = "JanFebMarAprMayJunJulAugSepOctNovDec";
+    if (value.size != 29 || value.data[3] != ',' || value.data[4] != ' ' ||
+        std::memcmp(value.data + 25, " GMT", 4) != 0) {
+        return false;
+    }
+    const char* p = value.data;
+    int digits[12];
+    const int positions[12] = { 5, 6, 12, 13, 14, 15, 17, 18, 20, 21, 23, 24 };
+    for (int i = 0; i < 12; i++) {
+        char c = p[positions[i]];
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        digits[i] = c - '0';
+    }
+    int month = -1;
+    for (int m = 0; m < 12; m++) {
+        if (std::memcmp(p + 8, kMonths + m * 3, 3) == 0) {
+            month = m;
+            break;
+        }
+    }
+    if (month < 0) {
+        return false;
+    }
+    struct tm tm;
+    std::memset(&tm, 0, sizeof(tm));
+    tm.tm_mday = digits[0] * 10 + digits[1];
+    tm.tm_mon = month;
+    tm.tm_year = digits[2] * 1000 + digits[3] * 100 + digits[4] * 10 + digits[5] - 1900;
+    tm.tm_hour = digits[6] * 10 + digits[7];
+    tm.tm_min = digits[8] * 10 + digits[9];
+    tm.tm_sec = digits[10] * 10 + digits[11];
+    time_t t = timegm(&tm);
+    if (t == static_cast<time_t>(-1)) {
+        return false;
+    }
+    seconds = static_cast<int64_t>(t);
+    return true;
+}
+
+// ========== 请求头解析 ==========
+
+enum StaticEncoding {
+    ENCODING_BR = 1,
+    ENCODING_GZIP = 2
+};
+
+inline StringSlice trimStaticToken(const char* begin, const char* end) {
+    while (begin < end && (*begin == ' ' || *begin == '\t')) begin++;
+    while (end > begin && (end[-1] == ' ' || end[-1] == '\t')) end--;
+    return StringSlice(begin, static_cast<size_t>(end - begin));
+}
+
+// 返回 Accept-Encoding 接受的预压缩编码（ENCODING_* 位掩码），q=0 视为拒绝
+inline unsigned acceptedEncodings(StringSlice header) {
+    if (!header.valid() || header.empty()) {
+        return 0;
+    }
+    int br = -1;
+    int gzip = -1;
+    int star = -1;
+    const char* p = header.data;
+    const char* end = header.data + header.size;
+    while (p < end) {
+        const char* comma = static_cast<const char*>(std::memchr(p, ',', static_cast<size_t>(end - p)));
+        const char* item_end = comma ? comma : end;
+        const char* semi = static_cast<const char*>(std::memchr(p, ';', static_cast<size_t>(item_end - p)));
+        StringSlice name = trimStaticToken(p, semi ? semi : item_end);
+        int accepted = 1;
+        if (semi) {
+            StringSlice param = trimStaticToken(semi + 1, item_end);
+            if (param.size >= 2 && (param.data[0] == 'q' || param.data[0] == 'Q') && param.data[1] == '=') {
+                // 只要出现非零数字即为正权重
+                accepted = 0;
+                for (size_t i = 2; i < param.size; i++) {
+                    if (param.data[i] >= '1' && param.data[i] <= '9') {
+                        accepted = 1;
+                        break;
+                    }
+                }
+            }
+        }
+        if (name.equalsIgnoreCase("br", 2)) {
+            br = accepted;
+        } else if (name.equalsIgnoreCase("gzip", 4) || name.equalsIgnoreCase("x-gzip", 6)) {
+            gzip = accepted;
+        } else if (name.equals("*", 1)) {
+            star = accepted;
+        }
+        p = comma ? comma + 1 : end;
+    }
+    unsigned result = 0;
+    if (br == 1 || (br < 0 && star == 1)) result |= ENCODING_BR;
+    if (gzip == 1 || (gzip < 0 && star == 1)) result |= ENCODING_GZIP;
+    return result;
+}
+
+// If-None-Match 列表是否包含 etag（弱比较，"*" 匹配任何存在的表示）
+inline bool etagListMatches(StringSlice header, const std::string& etag) {
+    if (!header.valid() || header.empty()) {
+        return false;
+    }
+    StringSlice target(etag);
+    if (target.size > 2 && target.data[0] == 'W' && target.data[1] == '/') {
+        target = StringSlice(target.data + 2, target.size - 2);
+    }
+    const char* p = header.data;
+    const char* end = header.data + header.size;
+    while (p < end) {
+        const char* comma = static_cast<const char*>(std::memchr(p, ',', static_cast<size_t>(end - p)));
+        StringSlice tag = trimStaticToken(p, comma ? comma : end);
+        if (tag.equals("*", 1)) {
+            return true;
+        }
+        if (tag.size > 2 && tag.data[0] == 'W' && tag.data[1] == '/') {
+            tag = StringSlice(tag.data + 2, tag.size - 2);
+        }
+        if (tag.equals(target.data, target.size)) {
+            return true;
+        }
+        p = comma ? comma + 1 : end;
+    }
+    return false;
+}
+
+struct ByteRange {
+    uint64_t first;
+    uint64_t last;  // 含
+
+    ByteRange() : first(0), last(0) {}
+    uint64_t length() const { return last - first + 1; }
+};
+
+enum class RangeResult {
+    NONE,           // 无 Range 或无法解析：返回完整内容
+    PARTIAL,        // 返回 206
+    UNSATISFIABLE   // 返回 416
+};
+
+inline bool parseStaticNumber(StringSlice text, uint64_t& value) {
+    if (text.empty() || text.size > 19) {
+        return false;
+    }
+    value = 0;
+    for (size_t i = 0; i < text.size; i++) {
+        if (text.data[i] < '0' || text.data[i] > '9') {
+            return false;
+        }
+        value = value * 10 + static_cast<uint64_t>(text.data[i] - '0');
+    }
+    return true;
+}
+
+/**
+ * @brief 解析单个字节范围（bytes=a-b、bytes=a-、bytes=-n）
+ *
+ * 多个范围按 RFC 7233 允许的方式忽略（返回完整内容），语法错误同样视为无 Range。
+ */
+inline RangeResult parseByteRange(StringSlice header, uint64_t size, ByteRange& range) {
+    if (!header.valid() || header.size < 7 || !StringSlice(header.data, 6).equalsIgnoreCase("bytes=", 6)) {
+        return RangeResult::NONE;
+    }
+    StringSlice spec = trimStaticToken(header.data + 6, header.data + header.size);
+    if (std::memchr(spec.data, ',', spec.size)) {
+        return RangeResult::NONE;
+    }
+    const char* dash = static_cast<const char*>(std::memchr(spec.data, '-', spec.size));
+    if (!dash) {
+        return RangeResult::NONE;
+    }
+    StringSlice first_text = trimStaticToken(spec.data, dash);
+    StringSlice last_text = trimStaticToken(dash + 1, spec.data + spec.size);
+    uint64_t first = 0;
+    uint64_t last = 0;
+    if (first_text.empty()) {
+        // 后缀范围：最后 n 个字节
+        if (!parseStaticNumber(last_text, last)) {
+            return RangeResult::NONE;
+        }
+        if (last == 0 || size == 0) {
+            return RangeResult::UNSATISFIABLE;
+        }
+        range.first = last < size ? size - last : 0;
+        range.last = size - 1;
+        return RangeResult::PARTIAL;
+    }
+    if (!parseStaticNumber(first_text, first)) {
+        return RangeResult::NONE;
+    }
+    if (last_text.empty()) {
+        last = UINT64_MAX;
+    } else if (!parseStaticNumber(last_text, last) || last < first) {
+        return RangeResult::NONE;
+    }
+    if (first >= size) {
+        return RangeResult::UNSATISFIABLE;
+    }
+    range.first = first;
+    range.last = last < size ? last : size - 1;
+    return RangeResult::PARTIAL;
+}
+
+// ========== 文件映射 ==========
+
+class MappedFile {
+public:
+    /**
+     * @brief 映射整个文件；文件大小或修改时间与预期不符（已被替换）时返回 nullptr
+     */
+    static std::shared_ptr<const MappedFile> open(const std::string& path, uint64_t expected_size,
+                                                  int64_t expected_mtime_ns) {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return nullptr;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || static_cast<uint64_t>(st.st_size) != expected_size ||
+            mtimeNs(st) != expected_mtime_ns) {
+            ::close(fd);
+            return nullptr;
+        }
+        void* data = nullptr;
+        if (expected_size > 0) {
+            data = mmap(nullptr, static_cast<size_t>(expected_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data == MAP_FAILED) {
+                ::close(fd);
+                return nullptr;
+            }
+        }
+        // 映射建立后即可关闭描述符
+        ::close(fd);
+        return std::shared_ptr<const MappedFile>(new MappedFile(static_cast<const char*>(data),
+                                                                static_cast<size_t>(expected_size)));
+    }
+
+    ~MappedFile() {
+        if (data_) {
+            munmap(const_cast<char*>(data_), size_);
+        }
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+    static int64_t mtimeNs(const struct stat& st) {
+#if defined(__APPLE__)
+        return static_cast<int64_t>(st.st_mtimespec.tv_sec) * 1000000000LL + st.st_mtimespec.tv_nsec;
+#else
+        return static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec;
+#endif
+    }
+
+private:
+    MappedFile(const char* data, size_t size) : data_(data), size_(size) {}
+
+    const char* data_;
+    size_t size_;
+};
+
+// ========== 文件元数据 ==========
+
+struct StaticFile {
+    std::string path;           // 解析后的绝对路径
+    uint64_t size;
+    uint64_t inode;
+    int64_t mtime_ns;
+    std::string etag;           // 强 ETag："<大小>-<修改时间纳秒>"（十六进制）
+    std::string last_modified;  // IMF-fixdate
+    const char* content_type;
+    std::shared_ptr<const StaticFile> br;    // 预压缩兄弟文件，不存在或比原文件旧时为空
+    std::shared_ptr<const StaticFile> gzip;
+
+    StaticFile() : size(0), inode(0), mtime_ns(0), content_type("application/octet-stream") {}
+
+    int64_t mtimeSeconds() const { return mtime_ns / 1000000000LL; }
+};
+
+// ========== 文件缓存 ==========
+
+/**
+ * @brief 一个根目录的元数据和映射缓存，多核模式下所有工作线程共享（内部加锁）
+ *
+ * 元数据条目和常驻映射共用一条 LRU 链：条目数超过 max_entries 或映射合计超过
+ * max_cache_bytes 时从最久未用的一端淘汰。已交给请求的映射由 shared_ptr 持有，
+ * 淘汰不会影响正在发送的响应。
+ */
+class StaticFileCache {
+public:
+    StaticFileCache(const std::string& root, const StaticOptions& options)
+        : options_(options), mapped_bytes_(0) {
+        char resolved[PATH_MAX];
+        if (realpath(root.c_str(), resolved)) {
+            root_ = resolved;
+        }
+    }
+
+    StaticFileCache(const StaticFileCache&) = delete;
+    StaticFileCache& operator=(const StaticFileCache&) = delete;
+
+    // 根目录不存在时为 false
+    bool valid() const { return !root_.empty(); }
+    const std::string& root() const { return root_; }
+    const StaticOptions& options() const { return options_; }
+
+    /**
+     * @brief 查找 normalizeStaticPath 得到的相对路径
+     *
+     * 空路径或以 '/' 结尾时查找目录下的 index_file；目录本身同样返回其 index_file。
+     * inserted 非空时，本次新解析（而非命中缓存）的文件将其置为 true，
+     * 调用方据此为所在目录注册监视器。
+     */
+    std::shared_ptr<const StaticFile> lookup(const std::string& relative, uint64_t now_ms,
+                                             bool* inserted = nullptr) {
+        if (!valid()) {
+            return nullptr;
+        }
+        std::string path = root_;
+        if (!relative.empty()) {
+            path += '/';
+            path += relative;
+        }
+        if (relative.empty() || relative[relative.size() - 1] == '/') {
+            if (options_.index_file.empty()) {
+                return nullptr;
+            }
+            if (path[path.size() - 1] != '/') {
+                path += '/';
+            }
+            path += options_.index_file;
+        }
+
+        uint64_t interval = static_cast<uint64_t>(options_.revalidate_interval.count());
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            std::unordered_map<std::string, Slot>::iterator it = slots_.find(path);
+            if (it != slots_.end() && it->second.file && now_ms - it->second.checked_ms < interval) {
+                touch(it->second);
+                return it->second.file;
+            }
+        }
+
+        // 过期或未命中：在锁外访问文件系统
+        std::shared_ptr<const StaticFile> file = resolve(path, true);
+        if (!file) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            eraseLocked(path);
+            return nullptr;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::unordered_map<std::string, Slot>::iterator it = slots_.find(path);
+        if (it != slots_.end() && it->second.file && sameVersion(*it->second.file, *file) &&
+            sameVariants(*it->second.file, *file)) {
+            // 内容未变：保留已有条目（和映射），只刷新检查时间
+            it->second.checked_ms = now_ms;
+            touch(it->second);
+            return it->second.file;
+        }
+        if (it != slots_.end()) {
+            dropLocked(it);
+        }
+        Slot& slot = slots_[path];
+        slot.file = file;
+        slot.checked_ms = now_ms;
+        lru_.push_front(path);
+        slot.lru = lru_.begin();
+        slot.linked = true;
+        evictLocked();
+        if (inserted) {
+            *inserted = true;
+        }
+        return file;
+    }
+
+    /**
+     * @brief 取得文件内容的映射
+     *
+     * 不超过 max_cached_file 的文件常驻缓存；文件已被替换时返回 nullptr
+     * （调用方应 invalidate 后重新 lookup）。
+     */
+    std::shared_ptr<const MappedFile> content(const StaticFile& file) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            std::unordered_map<std::string, Slot>::iterator it = slots_.find(file.path);
+            if (it != slots_.end() && it->second.mapping && it->second.mapping_mtime_ns == file.mtime_ns &&
+                it->second.mapping->size() == file.size) {
+                touch(it->second);
+                return it->second.mapping;
+            }
+        }
+        std::shared_ptr<const MappedFile> mapping = MappedFile::open(file.path, file.size, file.mtime_ns);
+        if (!mapping || file.size > options_.max_cached_file) {
+            return mapping;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        Slot& slot = slots_[file.path];
+        if (slot.mapping) {
+            mapped_bytes_ -= slot.mapping->size();
+        }
+        slot.mapping = mapping;
+        slot.mapping_mtime_ns = file.mtime_ns;
+        mapped_bytes_ += mapping->size();
+        if (slot.linked) {
+            touch(slot);
+        } else {
+            lru_.push_front(file.path);
+            slot.lru = lru_.begin();
+            slot.linked = true;
+        }
+        evictLocked();
+        return mapping;
+    }
+
+    // 预热：解析并映射一个文件，文件不存在时返回 false
+    bool prewarm(const std::string& relative, uint64_t now_ms) {
+        std::shared_ptr<const StaticFile> file = lookup(relative, now_ms);
+        if (!file) {
+            return false;
+        }
+        content(*file);
+        if (file->br) content(*file->br);
+        if (file->gzip) content(*file->gzip);
+        return true;
+    }
+
+    /**
+     * @brief 文件（或目录）发生变化：使其自身、预压缩兄弟文件、引用它的原文件
+     *        和路径在其之下的条目全部失效
+     */
+    void invalidate(const std::string& path) {
+        std::string primary = path;
+        if (endsWith(primary, ".br") || endsWith(primary, ".gz")) {
+            primary.resize(primary.size() - 3);
+        }
+        std::string below = path + "/";
+        std::string br = primary + ".br";
+        std::string gzip = primary + ".gz";
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (std::unordered_map<std::string, Slot>::iterator it = slots_.begin(); it != slots_.end();) {
+            const std::string& key = it->first;
+            if (key == path || key == primary || key == br || key == gzip ||
+                key.compare(0, below.size(), below) == 0) {
+                it = dropLocked(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    // 目录内容发生变化但不知道具体文件：使该目录下直接包含的条目全部失效
+    void invalidateDirectory(const std::string& dir) {
+        std::string prefix = dir + "/";
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (std::unordered_map<std::string, Slot>::iterator it = slots_.begin(); it != slots_.end();) {
+            if (it->first.compare(0, prefix.size(), prefix) == 0 &&
+                it->first.find('/', prefix.size()) == std::string::npos) {
+                it = dropLocked(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        slots_.clear();
+        lru_.clear();
+        mapped_bytes_ = 0;
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return slots_.size();
+    }
+
+    size_t mappedBytes() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return mapped_bytes_;
+    }
+
+private:
+    struct Slot {
+        std::shared_ptr<const StaticFile> file;       // 仅映射、未经 lookup 的兄弟文件为空
+        std::shared_ptr<const MappedFile> mapping;    // 未常驻时为空
+        int64_t mapping_mtime_ns;
+        uint64_t checked_ms;
+        std::list<std::string>::iterator lru;
+        bool linked;
+
+        Slot() : mapping_mtime_ns(0), checked_ms(0), linked(false) {}
+    };
+
+    StaticOptions options_;
+    std::string root_;
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, Slot> slots_;
+    std::list<std::string> lru_;  // 头部最近使用
+    size_t mapped_bytes_;
+
+    static bool endsWith(const std::string& value, const char* suffix) {
+        size_t n = std::strlen(suffix);
+        return value.size() >= n && value.compare(value.size() - n, n, suffix) == 0;
+    }
+
+    static bool sameVersion(const StaticFile& a, const StaticFile& b) {
+        return a.path == b.path && a.size == b.size && a.inode == b.inode && a.mtime_ns == b.mtime_ns;
+    }
+
+    static bool sameVariant(const std::shared_ptr<const StaticFile>& a, const std::shared_ptr<const StaticFile>& b) {
+        if (!a || !b) {
+            return !a && !b;
+        }
+        return sameVersion(*a, *b);
+    }
+
+    static bool sameVariants(const StaticFile& a, const StaticFile& b) {
+        return sameVariant(a.br, b.br) && sameVariant(a.gzip, b.gzip);
+    }
+
+    // 路径解析后必须位于根目录内（防止符号链接逃逸）
+    bool insideRoot(const std::string& path) const {
+        char resolved[PATH_MAX];
+        if (!realpath(path.c_str(), resolved)) {
+            return false;
+        }
+        size_t n = root_.size();
+        if (root_ == "/") {
+            return true;
+        }
+        return std::strncmp(resolved, root_.c_str(), n) == 0 && (resolved[n] == '/' || resolved[n] == '\0');
+    }
+
+    std::shared_ptr<const StaticFile> resolve(std::string path, bool with_variants) const {
+        struct stat st;
+        if (stat(path.c_str(), &st) != 0) {
+            return nullptr;
+        }
+        if (S_ISDIR(st.st_mode) && with_variants && !options_.index_file.empty()) {
+            // 目录本身：返回其 index_file（路径以目录下的文件为准）
+            path += '/';
+            path += options_.index_file;
+            if (stat(path.c_str(), &st) != 0) {
+                return nullptr;
+            }
+        }
+        if (!S_ISREG(st.st_mode) || !insideRoot(path)) {
+            return nullptr;
+        }
+
+        std::shared_ptr<StaticFile> file = std::make_shared<StaticFile>();
+        file->path = path;
+        file->size = static_cast<uint64_t>(st.st_size);
+        file->inode = static_cast<uint64_t>(st.st_ino);
+        file->mtime_ns = MappedFile::mtimeNs(st);
+        char etag[48];
+        std::snprintf(etag, sizeof(etag), "\"%llx-%llx\"", static_cast<unsigned long long>(file->size),
+                      static_cast<unsigned long long>(file->mtime_ns));
+        file->etag = etag;
+        char date[32];
+        size_t date_size = formatHttpDate(file->mtimeSeconds(), date, sizeof(date));
+        file->last_modified.assign(date, date_size);
+        file->content_type = staticMimeType(path);
+
+        if (with_variants && options_.precompressed) {
+            file->br = resolveVariant(path + ".br", *file);
+            file->gzip = resolveVariant(path + ".gz", *file);
+        }
+        return file;
+    }
+
+    // 兄弟文件比原文件旧时视为过期，不使用
+    std::shared_ptr<const StaticFile> resolveVariant(const std::string& path, const StaticFile& original) const {
+        std::shared_ptr<const StaticFile> variant = resolve(path, false);
+        if (!variant || variant->mtime_ns < original.mtime_ns) {
+            return nullptr;
+        }
+        std::shared_ptr<StaticFile> copy = std::make_shared<StaticFile>(*variant);
+        copy->content_type = original.content_type;
+        return copy;
+    }
+
+    void touch(Slot& slot) {
+        if (slot.linked) {
+            lru_.splice(lru_.begin(), lru_, slot.lru);
+        }
+    }
+
+    std::unordered_map<std::string, Slot>::iterator dropLocked(std::unordered_map<std::string, Slot>::iterator it) {
+        if (it->second.mapping) {
+            mapped_bytes_ -= it->second.mapping->size();
+        }
+        if (it->second.linked) {
+            lru_.erase(it->second.lru);
+        }
+        return slots_.erase(it);
+    }
+
+    void eraseLocked(const std::string& path) {
+        std::unordered_map<std::string, Slot>::iterator it = slots_.find(path);
+        if (it != slots_.end()) {
+            dropLocked(it);
+        }
+    }
+
+    void evictLocked() {
+        while (!lru_.empty() && (slots_.size() > options_.max_entries || mapped_bytes_ > options_.max_cache_bytes)) {
+            std::string victim = lru_.back();
+            eraseLocked(victim);
+        }
+    }
+};
+
+} // namespace server
+} // namespace uvapi
+
+#endif // UVAPI_STATIC_FILES_H
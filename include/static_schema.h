@@ -0,0 +1,887 @@
+/**
+ * @file static_schema.h
+ * @brief 编译期 Body Schema：按成员指针列出字段，为每个类型生成特化的解析、校验与序列化
+ *
+ * - UVAPI_SCHEMA(Type, UVAPI_FIELD(member)...) 写在类型定义之后（同一命名空间内），
+ *   字段以成员指针和字面量名称描述：字段个数、名称长度和成员类型都在编译期确定
+ * - 解析时按键名长度和内容逐个比较（长度是编译期常量），命中后直接写入成员；
+ *   读写与校验按成员类型选择编解码（ValueCodec），不经虚调用，也不按 FieldType 分派
+ * - appendJson / parseBody / parseRequest / validateRequest、HttpResponse::json() 和
+ *   ResponseBuilder::data() 自动识别这类类型
+ * - 需要 BodySchemaBase* 的现有代码（如 DslBodySchema 的嵌套对象）使用 bodySchema<Type>()
+ *
+ * 与 DslBodySchema 的行为一致：未声明的键被跳过，null 视为未提供，校验模式下第一个错误即返回，
+ * 错误信息相同；可选字段缺失时重置为默认值，无有效值时序列化跳过。
+ * 校验规则（长度、范围、正则、枚举）含字符串和已编译的正则，不能是 constexpr：
+ * 每个类型的字段列表在首次使用时构建一次，之后只读。
+ *
+ * 支持的成员类型：std::string、整数（8~64 位，有/无符号）、float / double、bool、
+ * std::vector<int / int64_t / double / bool / std::string>、uvapi::optional<上述标量>、
+ * 另一个 UVAPI_SCHEMA 类型，以及它们组成的 std::vector。
+ *
+ * @code
+ * struct User {
+ *     int64_t id;
+ *     std::string name;
+ *     optional<std::string> email;
+ *     std::vector<std::string> tags;
+ *
+ *     User() : id(0) {}
+ *
+ *     // 可选：整体校验，返回非空字符串表示失败
+ *     std::string validateBody() const { return ""; }
+ * };
+ *
+ * UVAPI_SCHEMA(User,
+ *     UVAPI_FIELD(id).required().min(1),
+ *     UVAPI_FIELD(name).required().length(1, 64),
+ *     UVAPI_FIELD(email).pattern("^[^@]+@[^@]+$"),
+ *     UVAPI_FIELD_AS("labels", tags).maxLength(16));
+ *
+ * User user;
+ * ValidationResult result = parseRequest(req.body, user);
+ * return HttpResponse(200).json(user);
+ * @endcode
+ */
+
+#ifndef UVAPI_STATIC_SCHEMA_H
+#define UVAPI_STATIC_SCHEMA_H
+
+#include "framework.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace uvapi {
+namespace schema {
+
+template<typename T> class StaticBodySchema;
+
+namespace detail {
+
+inline std::string requiredMessage(const std::string& name) {
+    return "Field '" + name + "' is required";
+}
+
+// ========== 值编解码 ==========
+// 每种成员类型一个特化，提供：
+//   accepts(c)      值的首字符是否可能是该类型
+//   expected()      类型不符时的描述
+//   read()          读取已通过 accepts() 的值；失败返回 false，message 为空表示语法错误
+//   write()         写出值
+//   omit()          序列化时是否跳过（可选字段没有有效值、optional 为空）
+//   reset()         可选字段缺失时重置
+//   check()         直接校验对象时的字段规则
+//   describe()      填写 FieldDefinition 的类型信息（供 fields() 使用）
+
+template<typename V, typename Enable = void>
+struct ValueCodec {
+    static_assert(sizeof(V) == 0, "UVAPI_FIELD: unsupported member type");
+};
+
+// 字符串
+template<>
+struct ValueCodec<std::string> {
+    static bool accepts(char c) { return c == '"'; }
+    static const char* expected() { return "a string"; }
+
+    static bool read(json::Reader& reader, std::string& value, const FieldValidation& rules,
+                     const std::string& name, bool validate, std::string& message) {
+        if (!reader.readString(value)) {
+            return false;
+        }
+        if (validate) {
+            message = applyStringValidation(value.data(), value.size(), rules, name);
+            return message.empty();
+        }
+        return true;
+    }
+
+    static void write(const std::string& value, json::Writer& out) { out.string(value); }
+    static bool omit(const std::string& value, bool required) { return !required && value.empty(); }
+    static void reset(std::string& value) { value.clear(); }
+
+    static std::string check(const std::string& value, const FieldValidation& rules, const std::string& name) {
+        if (value.empty()) {
+            return rules.required ? requiredMessage(name) : std::string();
+        }
+        return applyStringValidation(value.data(), value.size(), rules, name);
+    }
+
+    static void describe(FieldDefinition& def) { def.type = FieldType::STRING; }
+};
+
+// 整数（bool 除外）
+template<typename I>
+struct ValueCodec<I, typename std::enable_if<std::is_integral<I>::value && !std::is_same<I, bool>::value>::type> {
+    static bool accepts(char c) { return field_rules::isNumberStart(c); }
+    static const char* expected() { return "an integer"; }
+
+    static bool read(json::Reader& reader, I& value, const FieldValidation& rules,
+                     const std::string& name, bool validate, std::string& message) {
+        json::Number num;
+        if (!reader.readNumber(num)) {
+            return false;
+        }
+        bool in_range = field_rules::inIntegerRange<I>(num);
+        if (validate) {
+            // 与 DslBodySchema 一致：1e3 这类整值浮点数也按整数接受
+            if (!num.is_integer && num.value != std::floor(num.value)) {
+                message = "Field '" + name + "' must be an integer";
+                return false;
+            }
+            if (!in_range) {
+                message = "Field '" + name + "' is out of range";
+                return false;
+            }
+            message = applyNumberValidation(num.value, rules, name);
+            if (!message.empty()) {
+                return false;
+            }
+        }
+        if (!in_range) {
+            value = num.value < 0 ? std::numeric_limits<I>::min() : std::numeric_limits<I>::max();
+        } else if (num.is_unsigned) {
+            value = static_cast<I>(num.uinteger);
+        } else if (num.is_integer) {
+            value = static_cast<I>(num.integer);
+        } else {
+            value = static_cast<I>(num.value);
+        }
+        return true;
+    }
+
+    static void write(I value, json::Writer& out) {
+        if (std::is_signed<I>::value) {
+            out.integer(static_cast<int64_t>(value));
+        } else {
+            out.uinteger(static_cast<uint64_t>(value));
+        }
+    }
+
+    static bool omit(I value, bool required) { return !required && value == 0; }
+    static void reset(I& value) { value = 0; }
+
+    static std::string check(I value, const FieldValidation& rules, const std::string& name) {
+        return applyNumberValidation(static_cast<double>(value), rules, name);
+    }
+
+    static void describe(FieldDefinition& def) {
+        const bool is_signed = std::is_signed<I>::value;
+        switch (sizeof(I)) {
+            case 1: def.type = is_signed ? FieldType::INT8 : FieldType::UINT8; break;
+            case 2: def.type = is_signed ? FieldType::INT16 : FieldType::UINT16; break;
+            case 4: def.type = is_signed ? FieldType::INT : FieldType::UINT32; break;
+            default: def.type = is_signed ? FieldType::INT64 : FieldType::UINT64; break;
+        }
+    }
+};
+
+// 浮点数
+template<typename F>
+struct ValueCodec<F, typename std::enable_if<std::is_floating_point<F>::value>::type> {
+    static bool accepts(char c) { return field_rules::isNumberStart(c); }
+    static const char* expected() { return "a number"; }
+
+    static bool read(json::Reader& reader, F& value, const FieldValidation& rules,
+                     const std::string& name, bool validate, std::string& message) {
+        json::Number num;
+        if (!reader.readNumber(num)) {
+            return false;
+        }
+        if (validate) {
+            message = applyNumberValidation(num.value, rules, name);
+            if (!message.empty()) {
+                return false;
+            }
+        }
+        value = static_cast<F>(num.value);
+        return true;
+    }
+
+    static void write(F value, json::Writer& out) { out.number(value); }
+    static bool omit(F value, bool required) { return !required && value == 0; }
+    static void reset(F& value) { value = 0; }
+
+    static std::string check(F value, const FieldValidation& rules, const std::string& name) {
+        return applyNumberValidation(static_cast<double>(value), rules, name);
+    }
+
+    static void describe(FieldDefinition& def) {
+        def.type = std::is_same<F, float>::value ? FieldType::FLOAT : FieldType::DOUBLE;
+    }
+};
+
+// 布尔
+template<>
+struct ValueCodec<bool> {
+    static bool accepts(char c) { return c == 't' || c == 'f'; }
+    static const char* expected() { return "a boolean"; }
+
+    static bool read(json::Reader& reader, bool& value, const FieldValidation&,
+                     const std::string&, bool, std::string&) {
+        return reader.readBool(value);
+    }
+
+    static void write(bool value, json::Writer& out) { out.boolean(value); }
+    static bool omit(bool value, bool required) { return !required && !value; }
+    static void reset(bool& value) { value = false; }
+    static std::string check(bool, const FieldValidation&, const std::string&) { return ""; }
+    static void describe(FieldDefinition& def) { def.type = FieldType::BOOL; }
+};
+
+// uvapi::optional<标量>：空值不序列化，出现即视为有值
+template<typename X>
+struct ValueCodec<uvapi::optional<X> > {
+    typedef ValueCodec<X> Inner;
+
+    static bool accepts(char c) { return Inner::accepts(c); }
+    static const char* expected() { return Inner::expected(); }
+
+    static bool read(json::Reader& reader, uvapi::optional<X>& value, const FieldValidation& rules,
+                     const std::string& name, bool validate, std::string& message) {
+        X parsed = X();
+        if (!Inner::read(reader, parsed, rules, name, validate, message)) {
+            return false;
+        }
+        value = std::move(parsed);
+        return true;
+    }
+
+    static void write(const uvapi::optional<X>& value, json::Writer& out) { Inner::write(*value, out); }
+    static bool omit(const uvapi::optional<X>& value, bool) { return !value.has_value(); }
+    static void reset(uvapi::optional<X>& value) { value.reset(); }
+
+    static std::string check(const uvapi::optional<X>& value, const FieldValidation& rules, const std::string& name) {
+        if (!value.has_value()) {
+            return rules.required ? requiredMessage(name) : std::string();
+        }
+        return Inner::check(*value, rules, name);
+    }
+
+    static void describe(FieldDefinition& def) {
+        Inner::describe(def);
+        def.is_optional = true;
+    }
+};
+
+// 嵌套的编译期 Schema 对象：与外层共用一次扫描
+template<typename U>
+struct ValueCodec<U, typename std::enable_if<HasStaticSchema<U>::value>::type> {
+    static bool accepts(char c) { return c == '{'; }
+    static const char* expected() { return "an object"; }
+
+    static bool read(json::Reader& reader, U& value, const FieldValidation&,
+                     const std::string&, bool validate, std::string& message) {
+        return StaticSchema<U>::parseFrom(reader, value, validate, &message);
+    }
+
+    static void write(const U& value, json::Writer& out) { StaticSchema<U>::write(value, out); }
+    static bool omit(const U&, bool) { return false; }
+    static void reset(U& value) { value = U(); }
+
+    static std::string check(const U& value, const FieldValidation&, const std::string&) {
+        return StaticSchema<U>::validateObject(value);
+    }
+
+    static void describe(FieldDefinition& def) {
+        def.type = FieldType::OBJECT;
+        def.nested_schema = &StaticBodySchema<U>::instance();
+    }
+};
+
+// 标量数组元素的描述与 FieldType
+template<typename E> struct ArrayElement;
+template<> struct ArrayElement<int> {
+    static const char* expected() { return "an integer"; }
+    static FieldType type() { return FieldType::INT; }
+};
+template<> struct ArrayElement<int64_t> {
+    static const char* expected() { return "an integer"; }
+    static FieldType type() { return FieldType::INT64; }
+};
+template<> struct ArrayElement<double> {
+    static const char* expected() { return "a number"; }
+    static FieldType type() { return FieldType::DOUBLE; }
+};
+template<> struct ArrayElement<bool> {
+    static const char* expected() { return "a boolean"; }
+    static FieldType type() { return FieldType::BOOL; }
+};
+template<> struct ArrayElement<std::string> {
+    static const char* expected() { return "a string"; }
+    static FieldType type() { return FieldType::STRING; }
+};
+
+template<typename E> struct IsScalarElement : std::false_type {};
+template<> struct IsScalarElement<int> : std::true_type {};
+template<> struct IsScalarElement<int64_t> : std::true_type {};
+template<> struct IsScalarElement<double> : std::true_type {};
+template<> struct IsScalarElement<bool> : std::true_type {};
+template<> struct IsScalarElement<std::string> : std::true_type {};
+
+// 标量数组：批量读写（array_utils），规则与 DslBodySchema 的 intArray() 等相同
+template<typename E>
+struct ValueCodec<std::vector<E>, typename std::enable_if<IsScalarElement<E>::value>::type> {
+    static bool accepts(char c) { return c == '['; }
+    static const char* expected() { return "an array"; }
+
+    static bool read(json::Reader& reader, std::vector<E>& value, const FieldValidation& rules,
+                     const std::string& name, bool validate, std::string& message) {
+        return field_rules::readArray(reader, value, rules, name, ArrayElement<E>::expected(), validate, message);
+    }
+
+    static void write(const std::vector<E>& value, json::Writer& out) { array_utils::writeArray(out, value); }
+    static bool omit(const std::vector<E>& value, bool required) { return !required && value.empty(); }
+    static void reset(std::vector<E>& value) { value.clear(); }
+
+    static std::string check(const std::vector<E>& value, const FieldValidation& rules, const std::string& name) {
+        // 空数组视为未提供
+        if (value.empty()) {
+            return rules.required ? requiredMessage(name) : std::string();
+        }
+        return field_rules::validateArrayLength(value.size(), rules, name);
+    }
+
+    static void describe(FieldDefinition& def) {
+        def.type = FieldType::ARRAY;
+        def.element_type = ArrayElement<E>::type();
+        def.typed_array = true;
+    }
+};
+
+// 对象数组：逐个元素按元素类型的 Schema 解析
+template<typename U>
+struct ValueCodec<std::vector<U>, typename std::enable_if<HasStaticSchema<U>::value>::type> {
+    static bool accepts(char c) { return c == '['; }
+    static const char* expected() { return "an array"; }
+
+    static bool read(json::Reader& reader, std::vector<U>& value, const FieldValidation& rules,
+                     const std::string& name, bool validate, std::string& message) {
+        if (!reader.beginArray()) {
+            return false;
+        }
+        value.clear();
+        while (reader.nextElement()) {
+            if (reader.peek() != '{') {
+                if (validate) {
+                    message = "Field '" + name + "' item " + std::to_string(value.size()) + " must be an object";
+                    return false;
+                }
+                if (!reader.skipValue()) {
+                    return false;
+                }
+                continue;
+            }
+            value.emplace_back();
+            if (!StaticSchema<U>::parseFrom(reader, value.back(), validate, &message)) {
+                return false;
+            }
+        }
+        if (reader.failed()) {
+            return false;
+        }
+        if (validate) {
+            message = field_rules::validateArrayLength(value.size(), rules, name);
+            return message.empty();
+        }
+        return true;
+    }
+
+    static void write(const std::vector<U>& value, json::Writer& out) {
+        out.beginArray();
+        for (size_t i = 0; i < value.size(); ++i) {
+            StaticSchema<U>::write(value[i], out);
+        }
+        out.endArray();
+    }
+
+    static bool omit(const std::vector<U>& value, bool required) { return !required && value.empty(); }
+    static void reset(std::vector<U>& value) { value.clear(); }
+
+    static std::string check(const std::vector<U>& value, const FieldValidation& rules, const std::string& name) {
+        if (value.empty()) {
+            return rules.required ? requiredMessage(name) : std::string();
+        }
+        std::string message = field_rules::validateArrayLength(value.size(), rules, name);
+        for (size_t i = 0; message.empty() && i < value.size(); ++i) {
+            message = StaticSchema<U>::validateObject(value[i]);
+        }
+        return message;
+    }
+
+    static void describe(FieldDefinition& def) {
+        def.type = FieldType::ARRAY;
+        def.element_type = FieldType::OBJECT;
+        def.item_schema = &StaticBodySchema<U>::instance();
+    }
+};
+
+// 类型可选的整体校验：std::string validateBody() const
+template<typename T>
+struct HasValidateBody {
+    template<typename U>
+    static auto test(int) -> typename std::is_convertible<
+        decltype(std::declval<const U&>().validateBody()), std::string>::type;
+    template<typename U>
+    static std::false_type test(...);
+    static const bool value = decltype(test<T>(0))::value;
+};
+
+template<typename T>
+typename std::enable_if<HasValidateBody<T>::value, std::string>::type
+validateBody(const T& instance) {
+    return instance.validateBody();
+}
+
+template<typename T>
+typename std::enable_if<!HasValidateBody<T>::value, std::string>::type
+validateBody(const T&) {
+    return "";
+}
+
+// ========== 字段列表展开 ==========
+// 字段列表是 std::tuple<Field...>，每个操作按下标递归展开为直线代码
+
+template<typename T, typename Fields, size_t I = 0, size_t N = std::tuple_size<Fields>::value>
+struct FieldLoop {
+    typedef typename std::tuple_element<I, Fields>::type FieldT;
+    typedef FieldLoop<T, Fields, I + 1, N> Next;
+
+    // 按键名找到字段并读取（名称长度是编译期常量，先比长度再比内容）
+    // 返回 -1 表示失败，0 表示未声明的键，1 表示已处理
+    static int read(const Fields& fields, const StringSlice& key, json::Reader& reader, T& instance,
+                    bool validate, bool* seen, std::string& message) {
+        const FieldT& field = std::get<I>(fields);
+        if (!field.matches(key)) {
+            return Next::read(fields, key, reader, instance, validate, seen, message);
+        }
+        if (reader.readNull()) {
+            // null 视为未提供
+            if (validate && field.rules().required) {
+                message = requiredMessage(field.name());
+                return -1;
+            }
+            return 1;
+        }
+        if (!field.read(reader, instance, validate, message)) {
+            return -1;
+        }
+        seen[I] = true;
+        return 1;
+    }
+
+    // 未出现的字段：必填字段报错（仅校验模式），可选字段重置
+    static bool finish(const Fields& fields, T& instance, bool validate, const bool* seen, std::string& message) {
+        if (!seen[I]) {
+            const FieldT& field = std::get<I>(fields);
+            if (!field.rules().required) {
+                field.reset(instance);
+            } else if (validate) {
+                message = requiredMessage(field.name());
+                return false;
+            }
+        }
+        return Next::finish(fields, instance, validate, seen, message);
+    }
+
+    static void write(const Fields& fields, const T& instance, json::Writer& out) {
+        std::get<I>(fields).write(instance, out);
+        Next::write(fields, instance, out);
+    }
+
+    static std::string check(const Fields& fields, const T& instance) {
+        std::string message = std::get<I>(fields).check(instance);
+        if (!message.empty()) {
+            return message;
+        }
+        return Next::check(fields, instance);
+    }
+
+    static void describe(const Fields& fields, const T& probe, std::vector<FieldDefinition>& out) {
+        out.push_back(std::get<I>(fields).definition(probe));
+        Next::describe(fields, probe, out);
+    }
+};
+
+template<typename T, typename Fields, size_t N>
+struct FieldLoop<T, Fields, N, N> {
+    static int read(const Fields&, const StringSlice&, json::Reader&, T&, bool, bool*, std::string&) {
+        return 0;
+    }
+    static bool finish(const Fields&, T&, bool, const bool*, std::string&) { return true; }
+    static void write(const Fields&, const T&, json::Writer&) {}
+    static std::string check(const Fields&, const T&) { return ""; }
+    static void describe(const Fields&, const T&, std::vector<FieldDefinition>&) {}
+};
+
+} // namespace detail
+
+// ========== 字段描述 ==========
+
+/**
+ * @brief 一个成员字段：成员指针与名称长度是模板参数，校验规则在声明时设置
+ *
+ * 由 UVAPI_FIELD / UVAPI_FIELD_AS 生成，规则方法与 FieldBuilder 相同。
+ */
+template<typename Member, Member Ptr, size_t N>
+class Field;
+
+template<typename Owner, typename V, V Owner::*Ptr, size_t N>
+class Field<V Owner::*, Ptr, N> {
+public:
+    typedef detail::ValueCodec<V> Codec;
+
+    static const size_t kNameSize = N - 1;
+
+    explicit Field(const char (&name)[N]) : name_(name, kNameSize) {
+        json::appendQuoted(key_prefix_, name, kNameSize);
+        key_prefix_ += ':';
+    }
+
+    Field& required() {
+        rules_.required = true;
+        return *this;
+    }
+
+    Field& optional() {
+        rules_.required = false;
+        return *this;
+    }
+
+    // 字符串长度；数组字段为元素个数
+    Field& length(int min_len, int max_len) {
+        rules_.min_length = min_len;
+        rules_.max_length = max_len;
+        rules_.has_min_length = true;
+        rules_.has_max_length = true;
+        return *this;
+    }
+
+    Field& minLength(int min_len) {
+        rules_.min_length = min_len;
+        rules_.has_min_length = true;
+        return *this;
+    }
+
+    Field& maxLength(int max_len) {
+        rules_.max_length = max_len;
+        rules_.has_max_length = true;
+        return *this;
+    }
+
+    Field& range(double min_val, double max_val) {
+        rules_.min_value = min_val;
+        rules_.max_value = max_val;
+        rules_.has_min_value = true;
+        rules_.has_max_value = true;
+        return *this;
+    }
+
+    Field& min(double min_val) {
+        rules_.min_value = min_val;
+        rules_.has_min_value = true;
+        return *this;
+    }
+
+    Field& max(double max_val) {
+        rules_.max_value = max_val;
+        rules_.has_max_value = true;
+        return *this;
+    }
+
+    Field& pattern(const std::string& regex) {
+        rules_.pattern = regex;
+        rules_.compiled_pattern = CompiledPattern(regex);
+        rules_.has_pattern = true;
+        return *this;
+    }
+
+    Field& enumValues(const std::vector<std::string>& values) {
+        rules_.enum_values = values;
+        rules_.has_enum = true;
+        return *this;
+    }
+
+    Field& oneOf(const std::string& v1, const std::string& v2 = "",
+                 const std::string& v3 = "", const std::string& v4 = "") {
+        std::vector<std::string> values;
+        if (!v1.empty()) values.push_back(v1);
+        if (!v2.empty()) values.push_back(v2);
+        if (!v3.empty()) values.push_back(v3);
+        if (!v4.empty()) values.push_back(v4);
+        return enumValues(values);
+    }
+
+    const std::string& name() const { return name_; }
+    const FieldValidation& rules() const { return rules_; }
+
+    bool matches(const StringSlice& key) const {
+        return key.size == kNameSize && std::memcmp(key.data, name_.data(), kNameSize) == 0;
+    }
+
+    bool read(json::Reader& reader, Owner& instance, bool validate, std::string& message) const {
+        if (!Codec::accepts(reader.peek())) {
+            return field_rules::typeMismatch(reader, name_, Codec::expected(), validate, message);
+        }
+        return Codec::read(reader, instance.*Ptr, rules_, name_, validate, message);
+    }
+
+    void write(const Owner& instance, json::Writer& out) const {
+        if (Codec::omit(instance.*Ptr, rules_.required)) {
+            return;
+        }
+        out.rawKey(key_prefix_.data(), key_prefix_.size());
+        Codec::write(instance.*Ptr, out);
+    }
+
+    void reset(Owner& instance) const { Codec::reset(instance.*Ptr); }
+
+    std::string check(const Owner& instance) const { return Codec::check(instance.*Ptr, rules_, name_); }
+
+    // 运行时字段描述（偏移量按 probe 实例计算）
+    FieldDefinition definition(const Owner& probe) const {
+        size_t offset = static_cast<size_t>(reinterpret_cast<const char*>(&(probe.*Ptr)) -
+                                            reinterpret_cast<const char*>(&probe));
+        FieldDefinition def(name_, FieldType::STRING, offset);
+        def.validation = rules_;
+        Codec::describe(def);
+        def.validation.use_optional = def.is_optional;
+        return def;
+    }
+
+private:
+    std::string name_;
+    std::string key_prefix_;  // "name": 预编码，序列化时整段写入
+    FieldValidation rules_;
+};
+
+template<typename Owner, typename V, V Owner::*Ptr, size_t N>
+const size_t Field<V Owner::*, Ptr, N>::kNameSize;
+
+// UVAPI_FIELD 的实现：成员指针作为模板参数，名称长度由字面量推导
+template<typename Member, Member Ptr, size_t N>
+Field<Member, Ptr, N> field(const char (&name)[N]) {
+    return Field<Member, Ptr, N>(name);
+}
+
+// ========== 每个类型的特化 Schema ==========
+
+/**
+ * @brief 按 UVAPI_SCHEMA 的字段列表展开的解析、校验与序列化（全部为静态函数）
+ */
+template<typename T>
+class StaticSchema {
+public:
+    typedef decltype(uvapiSchemaOf(static_cast<const T*>(nullptr))) Descriptor;
+    typedef decltype(Descriptor::fields()) Fields;
+
+    static const size_t kFieldCount = std::tuple_size<Fields>::value;
+
+    // 字段列表（含校验规则）首次使用时构建，之后只读（C++11 保证局部静态变量的初始化线程安全）
+    static const Fields& fields() {
+        static const Fields instance = Descriptor::fields();
+        return instance;
+    }
+
+    static bool parseJson(const char* data, size_t size, T& instance, bool validate, std::string* error) {
+        json::Reader reader(data, size);
+        if (!parseFrom(reader, instance, validate, error)) {
+            return false;
+        }
+        if (!reader.finish()) {
+            if (error) *error = "Invalid JSON: " + reader.describeError();
+            return false;
+        }
+        return true;
+    }
+
+    // 从读取器的当前位置解析一个对象（嵌套对象与外层共用一次扫描）
+    static bool parseFrom(json::Reader& reader, T& instance, bool validate, std::string* error) {
+        const Fields& defs = fields();
+        bool seen[kFieldCount + 1] = {};
+
+        char first = reader.peek();
+        if (first != '{') {
+            if (first == '\0' || reader.failed()) {
+                reader.fail("Expected object");
+                if (error) *error = "Invalid JSON: " + reader.describeError();
+            } else if (error) {
+                *error = "Request body must be a JSON object";
+            }
+            return false;
+        }
+
+        std::string message;
+        StringSlice key;
+        reader.beginObject();
+        while (reader.nextMember(key)) {
+            int result = detail::FieldLoop<T, Fields>::read(defs, key, reader, instance, validate, seen, message);
+            if (result < 0) {
+                if (error) {
+                    *error = message.empty() ? "Invalid JSON: " + reader.describeError() : message;
+                }
+                return false;
+            }
+            // 未声明的字段：跳过
+            if (result == 0 && !reader.skipValue()) {
+                break;
+            }
+        }
+        if (reader.failed()) {
+            if (error) *error = "Invalid JSON: " + reader.describeError();
+            return false;
+        }
+
+        if (!detail::FieldLoop<T, Fields>::finish(defs, instance, validate, seen, message)) {
+            if (error) *error = message;
+            return false;
+        }
+
+        if (validate) {
+            message = detail::validateBody(instance);
+            if (!message.empty()) {
+                if (error) *error = message;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static void write(const T& instance, json::Writer& out) {
+        out.beginObject();
+        detail::FieldLoop<T, Fields>::write(fields(), instance, out);
+        out.endObject();
+    }
+
+    // 直接校验对象：字段规则，然后整体校验
+    static std::string validateObject(const T& instance) {
+        std::string message = detail::FieldLoop<T, Fields>::check(fields(), instance);
+        if (!message.empty()) {
+            return message;
+        }
+        return detail::validateBody(instance);
+    }
+
+    // 运行时字段表（与 DslBodySchema::fields() 的格式相同）
+    static std::vector<FieldDefinition> definitions() {
+        std::vector<FieldDefinition> defs;
+        defs.reserve(kFieldCount);
+        T probe;
+        detail::FieldLoop<T, Fields>::describe(fields(), probe, defs);
+        return defs;
+    }
+};
+
+template<typename T>
+const size_t StaticSchema<T>::kFieldCount;
+
+/**
+ * @brief BodySchemaBase 适配：供需要运行时 Schema 的现有代码使用（每个类型一个实例）
+ *
+ * 虚函数只是转发到 StaticSchema<T>；appendJson / parseRequest 等直接使用 StaticSchema<T>，不经过这里。
+ */
+template<typename T>
+class StaticBodySchema : public BodySchemaBase {
+public:
+    static StaticBodySchema& instance() {
+        static StaticBodySchema schema;
+        return schema;
+    }
+
+    std::vector<FieldDefinition> fields() const override {
+        return StaticSchema<T>::definitions();
+    }
+
+    std::string toJson(void* instance) const override {
+        std::string result;
+        json::Writer writer(result);
+        StaticSchema<T>::write(*static_cast<const T*>(instance), writer);
+        return result;
+    }
+
+    bool fromJson(const std::string& json_str, void* instance) const override {
+        return StaticSchema<T>::parseJson(json_str.data(), json_str.size(), *static_cast<T*>(instance), false, nullptr);
+    }
+
+    // cJSON 入口：重新编码后按流式路径校验
+    std::string validate(const cJSON* json) const override {
+        if (!cJSON_IsObject(json)) {
+            return "Request body must be a JSON object";
+        }
+        char* text = cJSON_PrintUnformatted(json);
+        if (!text) {
+            return "Invalid JSON body";
+        }
+        T scratch;
+        std::string error;
+        StaticSchema<T>::parseJson(text, std::strlen(text), scratch, true, &error);
+        cJSON_free(text);
+        return error;
+    }
+
+    bool parseJson(const char* data, size_t size, void* instance, bool validate,
+                   std::string* error) const override {
+        return StaticSchema<T>::parseJson(data, size, *static_cast<T*>(instance), validate, error);
+    }
+
+    void writeJson(const void* instance, json::Writer& out) const override {
+        StaticSchema<T>::write(*static_cast<const T*>(instance), out);
+    }
+
+    bool parseFrom(json::Reader& reader, void* instance, bool validate, std::string* error) const override {
+        return StaticSchema<T>::parseFrom(reader, *static_cast<T*>(instance), validate, error);
+    }
+
+    std::string validateBody(void* instance) const override {
+        return detail::validateBody(*static_cast<const T*>(instance));
+    }
+
+    std::string validateObject(void* instance) const override {
+        return StaticSchema<T>::validateObject(*static_cast<const T*>(instance));
+    }
+
+private:
+    StaticBodySchema() {}
+};
+
+// UVAPI_SCHEMA 类型的 BodySchemaBase 视图
+template<typename T>
+BodySchemaBase* bodySchema() {
+    static_assert(HasStaticSchema<T>::value, "bodySchema<T>() requires UVAPI_SCHEMA(T, ...)");
+    return &StaticBodySchema<T>::instance();
+}
+
+} // namespace schema
+} // namespace uvapi
+
+// ========== 声明宏 ==========
+
+/**
+ * UVAPI_SCHEMA(Type, fields...);  写在 Type 定义之后、与 Type 相同的命名空间内；Type 为不带限定的类名。
+ * 生成描述类 UvapiSchemaOf_Type 和经 ADL 查找的 uvapiSchemaOf(const Type*)（只声明，仅用于 decltype）。
+ */
+#define UVAPI_SCHEMA(Type, ...) \
+    struct UvapiSchemaOf_##Type; \
+    UvapiSchemaOf_##Type uvapiSchemaOf(const Type*); \
+    struct UvapiSchemaOf_##Type { \
+        typedef Type UvapiSchemaSelf; \
+        static auto fields() -> decltype(std::make_tuple(__VA_ARGS__)) { \
+            return std::make_tuple(__VA_ARGS__); \
+        } \
+    }
+
+// 字段名与成员名相同
+#define UVAPI_FIELD(member) UVAPI_FIELD_AS(#member, member)
+
+// 指定 JSON 字段名
+#define UVAPI_FIELD_AS(json_name, member) \
+    ::uvapi::schema::field<decltype(&UvapiSchemaSelf::member), &UvapiSchemaSelf::member>(json_name)
+
+#endif // UVAPI_STATIC_SCHEMA_H
@@ -1,100 +1,195 @@
+/**
+ * @file string_builder.h
+ * @brief 追加式字符串构建器
+ *
+ * 底层直接是一个 std::string：短内容落在其内联缓冲区（SSO），更长时按倍数增长，
+ * 可以用 reserve() 一次预留。数值格式化不经过 iostream 和 locale
+ * （整数两位查表、浮点数最短往返表示，见 json_writer.h），
+ * release() 把缓冲区移交给调用方，不复制内容。
+ *
+ * @code
+ * uvapi::StringBuilder sb(128);
+ * sb << "{\"id\":" << 42 << ",\"name\":";
+ * sb.appendQuoted(name);
+ * sb << '}';
+ * response.body = sb.release();
+ * @endcode
+ */
+
 #ifndef UVAPI_STRING_BUILDER_H
 #define UVAPI_STRING_BUILDER_H
 
+#include "json_writer.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <string>
-#include <sstream>
 
 namespace uvapi {
 
-/**
- * @brief 高效的字符串构建器
- * 
- * 相比直接使用 std::string + 操作符，StringBuilder 可以减少内存分配次数
- */
 class StringBuilder {
 private:
-    std::ostringstream stream_;
-    
+    std::string buffer_;
+
 public:
     StringBuilder() {}
-    
+
+    explicit StringBuilder(size_t capacity) {
+        buffer_.reserve(capacity);
+    }
+
+    StringBuilder& reserve(size_t capacity) {
+        buffer_.reserve(capacity);
+        return *this;
+    }
+
     // 追加各种类型
     StringBuilder& append(const std::string& str) {
-        stream_ << str;
+        buffer_.append(str);
         return *this;
     }
-    
+
     StringBuilder& append(const char* str) {
-        if (str) stream_ << str;
+        if (str) buffer_.append(str);
+        return *this;
+    }
+
+    StringBuilder& append(const char* data, size_t size) {
+        buffer_.append(data, size);
         return *this;
     }
-    
+
     StringBuilder& append(char c) {
-        stream_ << c;
+        buffer_ += c;
         return *this;
     }
-    
+
     StringBuilder& append(int value) {
-        stream_ << value;
+        json::appendInteger(buffer_, value);
         return *this;
     }
-    
+
+    StringBuilder& append(unsigned value) {
+        json::appendUnsigned(buffer_, value);
+        return *this;
+    }
+
     StringBuilder& append(int64_t value) {
-        stream_ << value;
+        json::appendInteger(buffer_, value);
         return *this;
     }
-    
+
+    StringBuilder& append(uint64_t value) {
+        json::appendUnsigned(buffer_, value);
+        return *this;
+    }
+
+    // 最短往返表示；NaN / Inf 输出 null
     StringBuilder& append(double value) {
-        stream_ << value;
+        json::appendDouble(buffer_, value);
         return *this;
     }
-    
+
     StringBuilder& append(bool value) {
-        stream_ << (value ? "true" : "false");
+        if (value) {
+            buffer_.append("true", 4);
+        } else {
+            buffer_.append("false", 5);
+        }
+        return *this;
+    }
+
+    // JSON 字符串转义（不含两侧引号）
+    StringBuilder& appendEscaped(const char* data, size_t size) {
+        json::appendEscaped(buffer_, data, size);
+        return *this;
+    }
+
+    StringBuilder& appendEscaped(const std::string& str) {
+        return appendEscaped(str.data(), str.size());
+    }
+
+    // 带引号的 JSON 字符串
+    StringBuilder& appendQuoted(const char* data, size_t size) {
+        json::appendQuoted(buffer_, data, size);
         return *this;
     }
-    
+
+    StringBuilder& appendQuoted(const std::string& str) {
+        return appendQuoted(str.data(), str.size());
+    }
+
+    StringBuilder& appendQuoted(const char* str) {
+        return appendQuoted(str, std::strlen(str));
+    }
+
     // 操作符重载
     StringBuilder& operator<<(const std::string& str) {
         return append(str);
     }
-    
+
     StringBuilder& operator<<(const char* str) {
         return append(str);
     }
-    
+
     StringBuilder& operator<<(char c) {
         return append(c);
     }
-    
+
     StringBuilder& operator<<(int value) {
         return append(value);
     }
-    
+
+    StringBuilder& operator<<(unsigned value) {
+        return append(value);
+    }
+
     StringBuilder& operator<<(int64_t value) {
         return append(value);
     }
-    
+
+    StringBuilder& operator<<(uint64_t value) {
+        return append(value);
+    }
+
     StringBuilder& operator<<(double value) {
         return append(value);
     }
-    
+
     StringBuilder& operator<<(bool value) {
         return append(value);
     }
-    
-    // 构建最终字符串
+
+    size_t size() const { return buffer_.size(); }
+    bool empty() const { return buffer_.empty(); }
+    size_t capacity() const { return buffer_.capacity(); }
+    const char* data() const { return buffer_.data(); }
+
+    // 只读访问当前内容（不复制）
+    const std::string& str() const { return buffer_; }
+
+    // 直接写入底层缓冲区（供 json::Writer 等追加式写入器使用）
+    std::string& buffer() { return buffer_; }
+
+    // 构建最终字符串（复制）
     std::string toString() const {
-        return stream_.str();
+        return buffer_;
     }
-    
-    // 清空
+
+    // 移交缓冲区，构建器随后为空
+    std::string release() {
+        std::string out;
+        out.swap(buffer_);
+        return out;
+    }
+
+    // 清空（保留容量）
     void clear() {
-        stream_.str("");
-        stream_.clear();
+        buffer_.clear();
     }
 };
 
-} 
+}
 
-#endif
\ No newline at end of file
+#endif
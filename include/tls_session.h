@@ -0,0 +1,274 @@
+/**
+ * @file tls_session.h
+ * @brief TLS 会话恢复：选项、票据密钥轮换与握手统计
+ *
+ * - SessionOptions：会话票据（RFC 5077）与会话 ID 缓存、票据密钥轮换间隔、
+ *   优先使用的 ECDSA 证书、ALPN 协议列表，作为 TlsConfig 的一部分交给 Server::enableTls
+ * - TicketKeyRing：票据密钥按间隔轮换；多核模式下所有工作线程共用一份，
+ *   一个工作线程签发的票据可以在其他工作线程上恢复
+ * - SessionStats：握手数、恢复数、被拒绝的票据数与恢复比例，以 Prometheus 指标导出
+ *   （uvapi_tls_handshakes_total、uvapi_tls_resumed_total、uvapi_tls_tickets_rejected_total、
+ *   uvapi_tls_resumption_ratio）
+ *
+ * mbedtls 上下文的配置见 Server::enableTls（framework_uvhttp.cpp）。
+ *
+ * @code
+ * uvapi::server::TlsConfig tls("server-rsa.crt", "server-rsa.key");
+ * tls.session.ecdsa("server-ec.crt", "server-ec.key")      // 支持 ECDSA 的客户端优先使用
+ *            .ticketRotation(std::chrono::hours(1))
+ *            .sessionCache(8192, std::chrono::hours(1));
+ * server.enableTls(tls);
+ * @endcode
+ */
+
+#ifndef UVAPI_TLS_SESSION_H
+#define UVAPI_TLS_SESSION_H
+
+#include "metrics.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace uvapi {
+namespace tls {
+
+// ========== 会话恢复选项 ==========
+
+struct SessionOptions {
+    bool session_tickets;                  // 签发和接受会话票据
+    std::chrono::seconds ticket_rotation;  // 票据密钥轮换间隔；上一把密钥再保留一个间隔
+    size_t session_cache_size;             // 会话 ID 缓存条目数（每个工作线程一份），0 表示关闭
+    std::chrono::seconds session_timeout;  // 会话 ID 缓存条目的有效期
+    std::string ecdsa_cert_file;           // 可选：ECDSA 证书，客户端支持时优先于 cert_file
+    std::string ecdsa_key_file;
+    std::vector<std::string> alpn;         // 按优先级排列，空表示不协商
+
+    SessionOptions()
+        : session_tickets(true)
+        , ticket_rotation(3600)
+        , session_cache_size(4096)
+        , session_timeout(3600)
+        , alpn(1, "http/1.1") {}
+
+    SessionOptions& sessionTickets(bool enabled) {
+        session_tickets = enabled;
+        return *this;
+    }
+
+    // 至少 60 秒
+    SessionOptions& ticketRotation(std::chrono::seconds interval) {
+        ticket_rotation = interval.count() < 60 ? std::chrono::seconds(60) : interval;
+        return *this;
+    }
+
+    SessionOptions& sessionCache(size_t entries, std::chrono::seconds timeout = std::chrono::seconds(3600)) {
+        session_cache_size = entries;
+        session_timeout = timeout;
+        return *this;
+    }
+
+    SessionOptions& ecdsa(const std::string& cert_file, const std::string& key_file) {
+        ecdsa_cert_file = cert_file;
+        ecdsa_key_file = key_file;
+        return *this;
+    }
+
+    SessionOptions& alpnProtocols(const std::vector<std::string>& protocols) {
+        alpn = protocols;
+        return *this;
+    }
+
+    bool prefersEcdsa() const { return !ecdsa_cert_file.empty() && !ecdsa_key_file.empty(); }
+};
+
+// ========== 票据密钥 ==========
+
+struct TicketKey {
+    static const size_t kNameSize = 4;     // mbedtls 票据中的密钥名长度
+    static const size_t kSecretSize = 32;  // AES-256-GCM
+
+    unsigned char name[kNameSize];
+    unsigned char secret[kSecretSize];
+    uint64_t generation;  // 从 1 开始，每次轮换加一
+
+    TicketKey() : generation(0) {
+        std::memset(name, 0, sizeof(name));
+        std::memset(secret, 0, sizeof(secret));
+    }
+};
+
+/**
+ * @brief 按固定间隔轮换的票据密钥（线程安全）
+ *
+ * 各工作线程的定时器调用 rotateIfDue()，到期后只有第一个调用方生成新密钥；
+ * 之后每个工作线程比较 generation() 与自己已装载的代数，把新密钥交给各自的 mbedtls 票据上下文。
+ */
+class TicketKeyRing {
+public:
+    explicit TicketKeyRing(std::chrono::seconds rotation)
+        : rotation_ms_(static_cast<uint64_t>(rotation.count()) * 1000), next_ms_(0), generation_(0) {}
+
+    TicketKeyRing(const TicketKeyRing&) = delete;
+    TicketKeyRing& operator=(const TicketKeyRing&) = delete;
+
+    /**
+     * @brief 到期（或还没有密钥）时生成新密钥
+     * @param fill fill(unsigned char* out, size_t size) 写入随机字节，失败返回 false（保留当前密钥，下次重试）
+     * @return 本次是否轮换
+     */
+    template<typename Fill>
+    bool rotateIfDue(uint64_t now_ms, Fill fill) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (generation_.load(std::memory_order_relaxed) > 0 && now_ms < next_ms_) {
+            return false;
+        }
+        TicketKey key;
+        if (!fill(key.name, TicketKey::kNameSize) || !fill(key.secret, TicketKey::kSecretSize)) {
+            return false;
+        }
+        key.generation = generation_.load(std::memory_order_relaxed) + 1;
+        current_ = key;
+        next_ms_ = now_ms + rotation_ms_;
+        generation_.store(key.generation, std::memory_order_release);
+        return true;
+    }
+
+    // 当前密钥；还没有生成过时返回 false
+    bool current(TicketKey& out) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        out = current_;
+        return current_.generation > 0;
+    }
+
+    uint64_t generation() const { return generation_.load(std::memory_order_acquire); }
+
+    std::chrono::seconds rotation() const { return std::chrono::seconds(rotation_ms_ / 1000); }
+
+    // 密钥的有效期：当前间隔加上作为上一把密钥保留的一个间隔
+    uint32_t keyLifetimeSeconds() const { return static_cast<uint32_t>(rotation_ms_ / 1000 * 2); }
+
+private:
+    uint64_t rotation_ms_;
+    uint64_t next_ms_;
+    std::atomic<uint64_t> generation_;
+    TicketKey current_;
+    mutable std::mutex mutex_;
+};
+
+// ========== 握手统计 ==========
+
+/**
+ * @brief 握手与会话恢复计数（多核模式下所有工作线程共用一份）
+ *
+ * 握手数按新 TLS 连接的第一个请求计数；恢复数来自 mbedtls 的票据解析和会话缓存查找回调，
+ * 每次恢复恰好命中其中之一。
+ */
+class SessionStats {
+public:
+    SessionStats()
+        : handshakes_(0)
+        , resumed_(0)
+        , handshake_counter_(std::make_shared<metrics::Counter>("uvapi_tls_handshakes_total",
+                                                                "TLS handshakes completed by new connections"))
+        , resumed_counter_(std::make_shared<metrics::Counter>("uvapi_tls_resumed_total",
+                                                              "TLS handshakes resumed from a session ticket or the session cache"))
+        , rejected_counter_(std::make_shared<metrics::Counter>("uvapi_tls_tickets_rejected_total",
+                                                               "Session tickets rejected as expired, unknown or invalid"))
+        , ratio_(std::make_shared<metrics::Gauge>("uvapi_tls_resumption_ratio",
+                                                  "Fraction of TLS handshakes that resumed a session")) {}
+
+    SessionStats(const SessionStats&) = delete;
+    SessionStats& operator=(const SessionStats&) = delete;
+
+    void handshake() {
+        handshakes_.fetch_add(1, std::memory_order_relaxed);
+        handshake_counter_->increment();
+        updateRatio();
+    }
+
+    void resumed() {
+        resumed_.fetch_add(1, std::memory_order_relaxed);
+        resumed_counter_->increment();
+        updateRatio();
+    }
+
+    void ticketRejected() { rejected_counter_->increment(); }
+
+    uint64_t handshakes() const { return handshakes_.load(std::memory_order_relaxed); }
+    uint64_t resumedCount() const { return resumed_.load(std::memory_order_relaxed); }
+
+    // 恢复握手占全部握手的比例；两个计数分别在握手中途和第一个请求时增加，短时间内可能略大于 1，按 1 截断
+    double resumptionRatio() const {
+        uint64_t total = handshakes();
+        if (total == 0) {
+            return 0.0;
+        }
+        double ratio = static_cast<double>(resumedCount()) / static_cast<double>(total);
+        return ratio > 1.0 ? 1.0 : ratio;
+    }
+
+    void registerMetrics(metrics::MetricRegistry& registry) const {
+        registry.registerMetric(handshake_counter_);
+        registry.registerMetric(resumed_counter_);
+        registry.registerMetric(rejected_counter_);
+        registry.registerMetric(ratio_);
+    }
+
+private:
+    std::atomic<uint64_t> handshakes_;
+    std::atomic<uint64_t> resumed_;
+    std::shared_ptr<metrics::Counter> handshake_counter_;
+    std::shared_ptr<metrics::Counter> resumed_counter_;
+    std::shared_ptr<metrics::Counter> rejected_counter_;
+    std::shared_ptr<metrics::Gauge> ratio_;
+
+    void updateRatio() { ratio_->set(resumptionRatio()); }
+};
+
+/**
+ * @brief 以 nullptr 结尾的 ALPN 协议数组（mbedtls_ssl_conf_alpn_protocols 的参数），
+ *        字符串由本对象持有，生命周期需覆盖 TLS 配置
+ */
+class AlpnList {
+public:
+    AlpnList() {}
+    explicit AlpnList(const std::vector<std::string>& protocols) { assign(protocols); }
+
+    AlpnList(const AlpnList&) = delete;
+    AlpnList& operator=(const AlpnList&) = delete;
+
+    // 空串和超过 255 字节的协议名（ALPN 的长度字段只有一个字节）被跳过
+    void assign(const std::vector<std::string>& protocols) {
+        protocols_.clear();
+        for (size_t i = 0; i < protocols.size(); i++) {
+            if (!protocols[i].empty() && protocols[i].size() <= 255) {
+                protocols_.push_back(protocols[i]);
+            }
+        }
+        pointers_.clear();
+        for (size_t i = 0; i < protocols_.size(); i++) {
+            pointers_.push_back(protocols_[i].c_str());
+        }
+        pointers_.push_back(nullptr);
+    }
+
+    bool empty() const { return protocols_.empty(); }
+    size_t size() const { return protocols_.size(); }
+    const char** data() { return pointers_.data(); }
+
+private:
+    std::vector<std::string> protocols_;
+    std::vector<const char*> pointers_;
+};
+
+} // namespace tls
+} // namespace uvapi
+
+#endif // UVAPI_TLS_SESSION_H
@@ -0,0 +1,451 @@
+/**
+ * @file token_store.h
+ * @brief 会话 token 存储：开放寻址哈希表 + 分层时间轮过期
+ *
+ * - TokenKey：固定 32 字节的 token（URL 安全的 base64 字符表，每字符 6 位随机数）
+ * - TokenTable：线性探测的开放寻址哈希表，槽位连续存放，删除采用后移（无墓碑）
+ * - TimerWheel：4 层 × 64 槽的分层时间轮，调度和到期均为 O(1) 均摊；
+ *   到期时只回调键，由调用方回表确认（已撤销 / 已刷新的 token 直接忽略）
+ * - 签名 token 的编解码辅助函数（base64url、声明打包、常量时间比较），
+ *   MAC 本身由调用方计算（framework_uvhttp.cpp 中使用 mbedtls 的 HMAC-SHA256）
+ *
+ * 本文件不依赖 uvhttp / mbedtls，也不做同步；并发访问由调用方加锁。
+ */
+
+#ifndef UVAPI_TOKEN_STORE_H
+#define UVAPI_TOKEN_STORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace uvapi {
+namespace auth {
+
+// ========== 固定长度 token ==========
+
+static const size_t kTokenSize = 32;
+
+struct TokenKey {
+    char bytes[kTokenSize];
+
+    // 由随机字节生成：每个字节取低 6 位映射到 URL 安全字符表（无取模偏差）
+    static TokenKey fromRandom(const unsigned char* random) {
+        static const char kAlphabet[] =
+            "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+        TokenKey key;
+        for (size_t i = 0; i < kTokenSize; ++i) {
+            key.bytes[i] = kAlphabet[random[i] & 63];
+        }
+        return key;
+    }
+
+    // 长度不是 32 时返回 false
+    static bool parse(const char* data, size_t size, TokenKey& out) {
+        if (size != kTokenSize) {
+            return false;
+        }
+        std::memcpy(out.bytes, data, kTokenSize);
+        return true;
+    }
+
+    std::string toString() const { return std::string(bytes, kTokenSize); }
+
+    bool operator==(const TokenKey& other) const {
+        return std::memcmp(bytes, other.bytes, kTokenSize) == 0;
+    }
+
+    uint64_t hash() const {
+        uint64_t words[4];
+        std::memcpy(words, bytes, sizeof(words));
+        uint64_t h = words[0] ^ (words[1] * 0x9E3779B97F4A7C15ULL) ^
+                     (words[2] * 0xC2B2AE3D27D4EB4FULL) ^ (words[3] * 0x165667B19E3779F9ULL);
+        h ^= h >> 33;
+        h *= 0xFF51AFD7ED558CCDULL;
+        h ^= h >> 33;
+        return h;
+    }
+};
+
+// ========== 开放寻址哈希表 ==========
+
+template<typename V>
+class TokenTable {
+public:
+    explicit TokenTable(size_t initial_capacity = 64)
+        : size_(0) {
+        size_t capacity = 16;
+        while (capacity < initial_capacity) {
+            capacity <<= 1;
+        }
+        slots_.resize(capacity);
+        mask_ = capacity - 1;
+    }
+
+    V* find(const TokenKey& key) {
+        size_t index = locate(key);
+        return index == npos ? nullptr : &slots_[index].value;
+    }
+
+    const V* find(const TokenKey& key) const {
+        size_t index = locate(key);
+        return index == npos ? nullptr : &slots_[index].value;
+    }
+
+    // 已存在时覆盖并返回 false
+    bool insert(const TokenKey& key, V value) {
+        // 负载因子上限 0.7
+        if ((size_ + 1) * 10 > slots_.size() * 7) {
+            rehash(slots_.size() * 2);
+        }
+        size_t index = static_cast<size_t>(key.hash()) & mask_;
+        while (slots_[index].used) {
+            if (slots_[index].key == key) {
+                slots_[index].value = std::move(value);
+                return false;
+            }
+            index = (index + 1) & mask_;
+        }
+        slots_[index].used = true;
+        slots_[index].key = key;
+        slots_[index].value = std::move(value);
+        ++size_;
+        return true;
+    }
+
+    bool erase(const TokenKey& key) {
+        size_t hole = locate(key);
+        if (hole == npos) {
+            return false;
+        }
+        // 后移删除：把后续探测链上的元素前移填补空洞，保持查找不需要墓碑
+        size_t next = (hole + 1) & mask_;
+        while (slots_[next].used) {
+            size_t home = static_cast<size_t>(slots_[next].key.hash()) & mask_;
+            // home 不在 (hole, next] 区间内时，该元素可以前移到 hole
+            bool movable = hole <= next ? (home <= hole || home > next)
+                                        : (home <= hole && home > next);
+            if (movable) {
+                slots_[hole].key = slots_[next].key;
+                slots_[hole].value = std::move(slots_[next].value);
+                hole = next;
+            }
+            next = (next + 1) & mask_;
+        }
+        slots_[hole].used = false;
+        slots_[hole].value = V();
+        --size_;
+        return true;
+    }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    size_t capacity() const { return slots_.size(); }
+
+    void clear() {
+        std::vector<Slot>(slots_.size()).swap(slots_);
+        size_ = 0;
+    }
+
+    // 按槽位顺序遍历（回调参数：键、值）
+    template<typename F>
+    void forEach(F fn) const {
+        for (size_t i = 0; i < slots_.size(); ++i) {
+            if (slots_[i].used) {
+                fn(slots_[i].key, slots_[i].value);
+            }
+        }
+    }
+
+private:
+    static const size_t npos = static_cast<size_t>(-1);
+
+    struct Slot {
+        bool used;
+        TokenKey key;
+        V value;
+
+        Slot() : used(false), key(), value() {}
+    };
+
+    std::vector<Slot> slots_;
+    size_t mask_;
+    size_t size_;
+
+    size_t locate(const TokenKey& key) const {
+        size_t index = static_cast<size_t>(key.hash()) & mask_;
+        while (slots_[index].used) {
+            if (slots_[index].key == key) {
+                return index;
+            }
+            index = (index + 1) & mask_;
+        }
+        return npos;
+    }
+
+    void rehash(size_t capacity) {
+        std::vector<Slot> old;
+        old.swap(slots_);
+        slots_.resize(capacity);
+        mask_ = capacity - 1;
+        size_ = 0;
+        for (size_t i = 0; i < old.size(); ++i) {
+            if (old[i].used) {
+                insert(old[i].key, std::move(old[i].value));
+            }
+        }
+    }
+};
+
+// ========== 分层时间轮 ==========
+
+/**
+ * @brief 4 层 × 64 槽的分层时间轮（刻度由调用方定义，token 过期使用秒）
+ *
+ * 第 0 层覆盖未来 64 个刻度，每上一层范围乘以 64；超出 64^4 的过期时间放在最高层，
+ * 逐级下沉时重新计算位置。advance() 逐刻度推进，没有待到期条目时直接跳到目标刻度。
+ */
+class TimerWheel {
+public:
+    static const unsigned kLevels = 4;
+    static const unsigned kSlotBits = 6;
+    static const size_t kSlots = static_cast<size_t>(1) << kSlotBits;
+
+    explicit TimerWheel(uint64_t start_tick = 0)
+        : current_(start_tick)
+        , pending_(0) {}
+
+    void schedule(const TokenKey& key, uint64_t expire_tick) {
+        Entry entry;
+        entry.key = key;
+        entry.expires = expire_tick;
+        place(entry);
+        ++pending_;
+    }
+
+    /**
+     * @brief 推进到 now_tick，对每个到期条目调用 on_due(key, expire_tick)
+     *
+     * on_due 中不得调用本时间轮的 schedule()。
+     * @return 到期条目数
+     */
+    template<typename F>
+    size_t advance(uint64_t now_tick, F on_due) {
+        size_t fired = 0;
+        while (current_ < now_tick) {
+            if (pending_ == 0) {
+                current_ = now_tick;
+                break;
+            }
+            ++current_;
+            cascade();
+            std::vector<Entry>& slot = slots_[0][current_ & (kSlots - 1)];
+            if (slot.empty()) {
+                continue;
+            }
+            std::vector<Entry> due;
+            due.swap(slot);
+            for (size_t i = 0; i < due.size(); ++i) {
+                if (due[i].expires > current_) {
+                    // 超出时间轮范围而被截断的条目：重新放入
+                    place(due[i]);
+                    continue;
+                }
+                --pending_;
+                ++fired;
+                on_due(due[i].key, due[i].expires);
+            }
+            // 复用已分配的容量
+            due.clear();
+            if (slot.empty()) {
+                slot.swap(due);
+            }
+        }
+        return fired;
+    }
+
+    uint64_t currentTick() const { return current_; }
+    size_t pending() const { return pending_; }
+
+private:
+    struct Entry {
+        TokenKey key;
+        uint64_t expires;
+    };
+
+    std::vector<Entry> slots_[kLevels][kSlots];
+    uint64_t current_;  // 最后处理过的刻度
+    size_t pending_;
+
+    void place(const Entry& entry) {
+        uint64_t expires = entry.expires;
+        if (expires <= current_) {
+            // 已到期：下一个刻度触发
+            expires = current_ + 1;
+        }
+        uint64_t delta = expires - current_;
+        unsigned level = 0;
+        while (level + 1 < kLevels && delta >= (static_cast<uint64_t>(1) << (kSlotBits * (level + 1)))) {
+            ++level;
+        }
+        uint64_t max_delta = (static_cast<uint64_t>(1) << (kSlotBits * kLevels)) - 1;
+        if (delta > max_delta) {
+            expires = current_ + max_delta;
+        }
+        size_t index = static_cast<size_t>(expires >> (kSlotBits * level)) & (kSlots - 1);
+        slots_[level][index].push_back(entry);
+    }
+
+    // 刻度跨过上层槽位边界时，把上层对应槽位的条目重新放入下层
+    void cascade() {
+        for (unsigned level = 1; level < kLevels; ++level) {
+            if ((current_ & ((static_cast<uint64_t>(1) << (kSlotBits * level)) - 1)) != 0) {
+                break;
+            }
+            size_t index = static_cast<size_t>(current_ >> (kSlotBits * level)) & (kSlots - 1);
+            std::vector<Entry> moving;
+            moving.swap(slots_[level][index]);
+            for (size_t i = 0; i < moving.size(); ++i) {
+                place(moving[i]);
+            }
+        }
+    }
+};
+
+// ========== 签名 token 编解码 ==========
+
+static const size_t kSignatureSize = 32;  // HMAC-SHA256
+
+inline void base64UrlEncode(const unsigned char* data, size_t size, std::string& out) {
+    static const char kAlphabet[] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+    out.reserve(out.size() + (size * 4 + 2) / 3);
+    size_t i = 0;
+    for (; i + 3 <= size; i += 3) {
+        uint32_t v = (static_cast<uint32_t>(data[i]) << 16) | (static_cast<uint32_t>(data[i + 1]) << 8) | data[i + 2];
+        out += kAlphabet[(v >> 18) & 63];
+        out += kAlphabet[(v >> 12) & 63];
+        out += kAlphabet[(v >> 6) & 63];
+        out += kAlphabet[v & 63];
+    }
+    if (i < size) {
+        uint32_t v = static_cast<uint32_t>(data[i]) << 16;
+        if (i + 1 < size) {
+            v |= static_cast<uint32_t>(data[i + 1]) << 8;
+        }
+        out += kAlphabet[(v >> 18) & 63];
+        out += kAlphabet[(v >> 12) & 63];
+        if (i + 1 < size) {
+            out += kAlphabet[(v >> 6) & 63];
+        }
+    }
+}
+
+// 无填充的 base64url；包含非法字符时返回 false
+inline bool base64UrlDecode(const char* data, size_t size, std::string& out) {
+    if (size % 4 == 1) {
+        return false;
+    }
+    out.clear();
+    out.reserve(size * 3 / 4);
+    uint32_t acc = 0;
+    int bits = 0;
+    for (size_t i = 0; i < size; ++i) {
+        char c = data[i];
+        uint32_t v;
+        if (c >= 'A' && c <= 'Z') v = static_cast<uint32_t>(c - 'A');
+        else if (c >= 'a' && c <= 'z') v = static_cast<uint32_t>(c - 'a' + 26);
+        else if (c >= '0' && c <= '9') v = static_cast<uint32_t>(c - '0' + 52);
+        else if (c == '-') v = 62;
+        else if (c == '_') v = 63;
+        else return false;
+        acc = (acc << 6) | v;
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            out += static_cast<char>((acc >> bits) & 0xFF);
+        }
+    }
+    return true;
+}
+
+// 比较耗时与内容无关，避免通过时间差猜测签名
+inline bool constantTimeEquals(const void* a, const void* b, size_t size) {
+    const unsigned char* x = static_cast<const unsigned char*>(a);
+    const unsigned char* y = static_cast<const unsigned char*>(b);
+    unsigned char diff = 0;
+    for (size_t i = 0; i < size; ++i) {
+        diff = static_cast<unsigned char>(diff | (x[i] ^ y[i]));
+    }
+    return diff == 0;
+}
+
+/**
+ * @brief 打包声明：user_id(8) | expires_at(8) | 用户名长度(2) | 用户名 | 角色长度(2) | 角色
+ *
+ * 整数按大端序写出；用户名或角色超过 65535 字节时返回 false。
+ */
+inline bool packClaims(int64_t user_id, int64_t expires_at, const std::string& username,
+                       const std::string& role, std::string& out) {
+    if (username.size() > 0xFFFF || role.size() > 0xFFFF) {
+        return false;
+    }
+    out.clear();
+    out.reserve(20 + username.size() + role.size());
+    uint64_t values[2] = { static_cast<uint64_t>(user_id), static_cast<uint64_t>(expires_at) };
+    for (int v = 0; v < 2; ++v) {
+        for (int shift = 56; shift >= 0; shift -= 8) {
+            out += static_cast<char>((values[v] >> shift) & 0xFF);
+        }
+    }
+    const std::string* fields[2] = { &username, &role };
+    for (int f = 0; f < 2; ++f) {
+        out += static_cast<char>((fields[f]->size() >> 8) & 0xFF);
+        out += static_cast<char>(fields[f]->size() & 0xFF);
+        out.append(*fields[f]);
+    }
+    return true;
+}
+
+inline bool unpackClaims(const std::string& data, int64_t& user_id, int64_t& expires_at,
+                         std::string& username, std::string& role) {
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(data.data());
+    size_t size = data.size();
+    if (size < 20) {
+        return false;
+    }
+    uint64_t values[2] = { 0, 0 };
+    for (int v = 0; v < 2; ++v) {
+        for (int i = 0; i < 8; ++i) {
+            values[v] = (values[v] << 8) | p[v * 8 + i];
+        }
+    }
+    size_t pos = 16;
+    std::string* fields[2] = { &username, &role };
+    for (int f = 0; f < 2; ++f) {
+        if (pos + 2 > size) {
+            return false;
+        }
+        size_t length = (static_cast<size_t>(p[pos]) << 8) | p[pos + 1];
+        pos += 2;
+        if (pos + length > size) {
+            return false;
+        }
+        fields[f]->assign(data, pos, length);
+        pos += length;
+    }
+    if (pos != size) {
+        return false;
+    }
+    user_id = static_cast<int64_t>(values[0]);
+    expires_at = static_cast<int64_t>(values[1]);
+    return true;
+}
+
+} // namespace auth
+} // namespace uvapi
+
+#endif // UVAPI_TOKEN_STORE_H
@@ -0,0 +1,656 @@
+/**
+ * @file tracing.h
+ * @brief 按采样记录的请求追踪与慢请求记录
+ *
+ * - 每个请求在分发入口的栈上持有一个 RequestSpan：被采样、或开启了慢请求阈值时，
+ *   它挂上一个 metrics::RequestTiming，框架已有的 PhaseTimer（解析、验证与请求体解析、
+ *   序列化与写出）照常累计，处理器耗时由总耗时推算
+ * - 请求结束时，被采样或超过阈值的请求写成一条固定大小的 SpanRecord，推入当前线程的
+ *   单生产者 / 单消费者无锁环形缓冲区；缓冲区满时丢弃并计数，事件循环从不等待
+ * - 收集线程按间隔取走所有线程的记录，保留最近的采样记录和慢请求，预渲染 /debug/traces 的 JSON，
+ *   并把每一批交给导出回调（renderOtlpJson() 生成 OTLP/HTTP 的 JSON 请求体）
+ *
+ * 未开启追踪时分发路径只多一次空指针判断。采样率为 0 但设置了慢请求阈值时，
+ * 每个请求都要取两次时间并累计阶段耗时，只有超过阈值的才会写入记录。
+ *
+ * @code
+ * api.enableTracing(uvapi::trace::TracePolicy()
+ *                       .sampleRate(0.01)
+ *                       .slowThreshold(std::chrono::milliseconds(200)));
+ * // GET /debug/traces -> {"recent":[...],"slow":[...],"recorded":N,"dropped":M}
+ * @endcode
+ */
+
+#ifndef UVAPI_TRACING_H
+#define UVAPI_TRACING_H
+
+#include "json_writer.h"
+#include "route_metrics.h"
+#include "uvapi_allocator.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace uvapi {
+namespace trace {
+
+// ========== 记录 ==========
+
+// 固定大小、可按值复制的请求记录；字符串字段截断并以 '\0' 结尾
+struct SpanRecord {
+    enum Flags {
+        SAMPLED = 1,
+        SLOW = 2
+    };
+
+    uint64_t trace_id;
+    uint64_t start_ns;     // steady_clock
+    uint64_t duration_ns;
+    uint64_t phase_ns[metrics::kPhaseCount];  // 按 metrics::Phase 索引；TOTAL 与 duration_ns 相同
+    uint64_t request_bytes;
+    uint64_t response_bytes;
+    uint32_t arena_bytes;   // 请求结束时 arena 已分配的字节数（未开启 arena 时为 0）
+    uint32_t arena_allocs;  // arena 分配次数
+    int32_t route_id;       // 未匹配路由时为 -1
+    uint16_t status;        // 0 表示未在本次回调中发出（异步路由等）
+    uint8_t flags;
+    char method[9];
+    char route[48];
+    char path[64];
+};
+
+inline void copyField(char* out, size_t capacity, const char* text, size_t size) {
+    if (!text) {
+        out[0] = '\0';
+        return;
+    }
+    size_t n = size < capacity - 1 ? size : capacity - 1;
+    std::memcpy(out, text, n);
+    out[n] = '\0';
+}
+
+// ========== 线程环形缓冲区 ==========
+
+/**
+ * @brief 单生产者（事件循环线程）/ 单消费者（收集线程）的固定容量环形缓冲区
+ */
+class SpanRing {
+public:
+    explicit SpanRing(size_t capacity) : head_(0), tail_(0), dropped_(0) {
+        size_t size = 16;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        slots_.resize(size);
+        mask_ = size - 1;
+    }
+
+    SpanRing(const SpanRing&) = delete;
+    SpanRing& operator=(const SpanRing&) = delete;
+
+    // 生产者：缓冲区满时丢弃并返回 false
+    bool push(const SpanRecord& record) {
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) > mask_) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        slots_[static_cast<size_t>(head) & mask_] = record;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 消费者：取走全部已提交的记录，返回条数
+    size_t drain(std::vector<SpanRecord>& out) {
+        uint64_t tail = tail_.load(std::memory_order_relaxed);
+        uint64_t head = head_.load(std::memory_order_acquire);
+        for (uint64_t i = tail; i < head; ++i) {
+            out.push_back(slots_[static_cast<size_t>(i) & mask_]);
+        }
+        tail_.store(head, std::memory_order_release);
+        return static_cast<size_t>(head - tail);
+    }
+
+    size_t capacity() const { return slots_.size(); }
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    std::vector<SpanRecord> slots_;
+    size_t mask_;
+    std::atomic<uint64_t> head_;  // 只由生产者写
+    std::atomic<uint64_t> tail_;  // 只由消费者写
+    std::atomic<uint64_t> dropped_;
+};
+
+// ========== 追踪策略 ==========
+
+typedef std::function<void(const std::vector<SpanRecord>&)> Exporter;
+
+struct TracePolicy {
+    double sample_rate;                         // 0-1，按请求独立采样
+    std::chrono::microseconds slow_threshold;   // > 0 时超过阈值的请求总是记录
+    size_t ring_capacity;                       // 每个线程的缓冲区记录数（向上取 2 的幂）
+    size_t retained;                            // /debug/traces 保留的最近采样记录和慢请求数（各自）
+    std::chrono::milliseconds drain_interval;   // 收集线程取走记录的间隔
+    Exporter exporter;                          // 在收集线程上对每一批记录调用，可为空
+
+    TracePolicy()
+        : sample_rate(0.0), slow_threshold(std::chrono::milliseconds(500)), ring_capacity(1024),
+          retained(256), drain_interval(std::chrono::milliseconds(200)) {}
+
+    TracePolicy& sampleRate(double rate) { sample_rate = rate; return *this; }
+    TracePolicy& slowThreshold(std::chrono::microseconds threshold) { slow_threshold = threshold; return *this; }
+    TracePolicy& ringCapacity(size_t capacity) { ring_capacity = capacity; return *this; }
+    TracePolicy& retain(size_t count) { retained = count; return *this; }
+    TracePolicy& drainInterval(std::chrono::milliseconds interval) { drain_interval = interval; return *this; }
+    TracePolicy& exportTo(const Exporter& fn) { exporter = fn; return *this; }
+};
+
+struct TraceStats {
+    uint64_t recorded;  // 收集线程已取走的记录数
+    uint64_t dropped;   // 因缓冲区满丢弃的记录数
+    size_t threads;     // 已注册缓冲区的线程数
+};
+
+// ========== 追踪器 ==========
+
+/**
+ * @brief 持有所有线程的缓冲区和收集线程；事件循环线程只调用 sample() / ring()
+ */
+class Tracer {
+public:
+    explicit Tracer(const TracePolicy& policy)
+        : policy_(policy), id_(nextId()), recorded_(0), running_(false) {
+        always_ = policy_.sample_rate >= 1.0;
+        threshold_ = policy_.sample_rate <= 0.0 ? 0
+                   : static_cast<uint64_t>(policy_.sample_rate * 18446744073709551615.0);
+        slow_ns_ = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            policy_.slow_threshold).count());
+        // steady_clock 没有纪元：记录创建时两者的差，导出时换算为墙上时间
+        uint64_t wall = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+        wall_offset_ns_ = wall - metrics::monotonicNanos();
+        trace_salt_ = mix(wall ^ (id_ << 32));
+    }
+
+    ~Tracer() { stop(); }
+
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+
+    const TracePolicy& policy() const { return policy_; }
+
+    // 采样率和慢请求阈值都为 0 时不记录任何请求
+    bool active() const { return always_ || threshold_ > 0 || slow_ns_ > 0; }
+    uint64_t slowNanos() const { return slow_ns_; }
+    uint64_t wallOffsetNanos() const { return wall_offset_ns_; }
+    uint64_t traceSalt() const { return trace_salt_; }
+
+    // 本次请求是否采样（线程局部 xorshift，不加锁）
+    bool sample() {
+        if (always_) {
+            return true;
+        }
+        return threshold_ > 0 && nextRandom() < threshold_;
+    }
+
+    static uint64_t nextRandom() {
+        static thread_local uint64_t state = 0;
+        if (state == 0) {
+            int local = 0;
+            state = mix(metrics::monotonicNanos() ^ reinterpret_cast<uintptr_t>(&local)) | 1;
+        }
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+
+    // 当前线程的缓冲区，首次调用时注册
+    SpanRing* ring() {
+        static thread_local std::vector<std::pair<uint64_t, SpanRing*> > owned;
+        for (size_t i = 0; i < owned.size(); ++i) {
+            if (owned[i].first == id_) {
+                return owned[i].second;
+            }
+        }
+        SpanRing* ring = new SpanRing(policy_.ring_capacity);
+        {
+            std::lock_guard<std::mutex> lock(rings_mutex_);
+            rings_.push_back(std::unique_ptr<SpanRing>(ring));
+        }
+        owned.push_back(std::make_pair(id_, ring));
+        return ring;
+    }
+
+    // 启动收集线程
+    void start() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (running_) {
+            return;
+        }
+        running_ = true;
+        thread_ = std::thread(&Tracer::run, this);
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!running_) {
+                return;
+            }
+            running_ = false;
+        }
+        cv_.notify_all();
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+
+    /**
+     * @brief 取走所有线程的记录，更新保留集合和渲染结果，并交给导出回调
+     *
+     * 由收集线程调用；未启动收集线程时（如测试）可以直接调用。
+     * @return 本次取走的条数
+     */
+    size_t collect() {
+        std::vector<SpanRecord> batch;
+        {
+            std::lock_guard<std::mutex> lock(rings_mutex_);
+            for (size_t i = 0; i < rings_.size(); ++i) {
+                rings_[i]->drain(batch);
+            }
+        }
+        std::lock_guard<std::mutex> lock(collect_mutex_);
+        for (size_t i = 0; i < batch.size(); ++i) {
+            std::deque<SpanRecord>& kept = (batch[i].flags & SpanRecord::SLOW) ? slow_ : recent_;
+            kept.push_back(batch[i]);
+            while (kept.size() > policy_.retained) {
+                kept.pop_front();
+            }
+        }
+        recorded_.fetch_add(batch.size(), std::memory_order_relaxed);
+        if (!batch.empty() || !latest()) {
+            render();
+        }
+        if (!batch.empty() && policy_.exporter) {
+            policy_.exporter(batch);
+        }
+        return batch.size();
+    }
+
+    // 最近一次渲染的 /debug/traces 响应体
+    std::shared_ptr<const std::string> latest() const {
+        return std::atomic_load(&latest_);
+    }
+
+    TraceStats stats() const {
+        TraceStats stats;
+        stats.recorded = recorded_.load(std::memory_order_relaxed);
+        stats.dropped = 0;
+        std::lock_guard<std::mutex> lock(rings_mutex_);
+        for (size_t i = 0; i < rings_.size(); ++i) {
+            stats.dropped += rings_[i]->dropped();
+        }
+        stats.threads = rings_.size();
+        return stats;
+    }
+
+    // 以 JSON 对象写出一条记录（/debug/traces 的数组元素）
+    void appendRecord(json::Writer& w, const SpanRecord& r) const {
+        w.beginObject();
+        w.key("trace_id");
+        appendHexId(w, r.trace_id);
+        w.key("start_unix_ns");   w.uinteger(r.start_ns + wall_offset_ns_);
+        w.key("duration_ns");     w.uinteger(r.duration_ns);
+        w.key("method");          w.string(r.method);
+        w.key("route");           w.string(r.route);
+        w.key("path");            w.string(r.path);
+        w.key("route_id");        w.integer(r.route_id);
+        w.key("status");          w.uinteger(r.status);
+        w.key("request_bytes");   w.uinteger(r.request_bytes);
+        w.key("response_bytes");  w.uinteger(r.response_bytes);
+        w.key("arena_bytes");     w.uinteger(r.arena_bytes);
+        w.key("arena_allocs");    w.uinteger(r.arena_allocs);
+        w.key("sampled");         w.boolean((r.flags & SpanRecord::SAMPLED) != 0);
+        w.key("slow");            w.boolean((r.flags & SpanRecord::SLOW) != 0);
+        w.key("phases_ns");
+        w.beginObject();
+        for (size_t p = 0; p < metrics::kPhaseCount; ++p) {
+            if (static_cast<metrics::Phase>(p) == metrics::Phase::TOTAL) {
+                continue;
+            }
+            w.key(metrics::phaseName(static_cast<metrics::Phase>(p)));
+            w.uinteger(r.phase_ns[p]);
+        }
+        w.endObject();
+        w.endObject();
+    }
+
+    // 32 位十六进制的 trace id（盐值 + 记录 id），与 OTLP 导出一致
+    void appendHexId(json::Writer& w, uint64_t id) const {
+        char hex[33];
+        formatHex(trace_salt_, hex);
+        formatHex(id, hex + 16);
+        w.string(hex, 32);
+    }
+
+    static void formatHex(uint64_t value, char* out) {
+        static const char kDigits[] = "0123456789abcdef";
+        for (int i = 15; i >= 0; --i) {
+            out[i] = kDigits[value & 0xf];
+            value >>= 4;
+        }
+        out[16] = '\0';
+    }
+
+    static uint64_t mix(uint64_t x) {
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdULL;
+        x ^= x >> 33;
+        x *= 0xc4ceb9fe1a85ec53ULL;
+        x ^= x >> 33;
+        return x;
+    }
+
+private:
+    TracePolicy policy_;
+    uint64_t id_;
+    bool always_;
+    uint64_t threshold_;
+    uint64_t slow_ns_;
+    uint64_t wall_offset_ns_;
+    uint64_t trace_salt_;
+
+    mutable std::mutex rings_mutex_;
+    std::vector<std::unique_ptr<SpanRing> > rings_;  // 线程退出后保留，随追踪器释放
+
+    std::mutex collect_mutex_;
+    std::deque<SpanRecord> recent_;
+    std::deque<SpanRecord> slow_;
+    std::atomic<uint64_t> recorded_;
+    std::shared_ptr<const std::string> latest_;  // 通过 std::atomic_load / atomic_store 访问
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool running_;
+    std::thread thread_;
+
+    static uint64_t nextId() {
+        static std::atomic<uint64_t> next(1);
+        return next.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // 调用方持有 collect_mutex_
+    void render() {
+        std::shared_ptr<std::string> body = std::make_shared<std::string>();
+        json::Writer w(*body);
+        w.beginObject();
+        w.key("recent");
+        w.beginArray();
+        for (std::deque<SpanRecord>::const_reverse_iterator it = recent_.rbegin(); it != recent_.rend(); ++it) {
+            appendRecord(w, *it);
+        }
+        w.endArray();
+        w.key("slow");
+        w.beginArray();
+        for (std::deque<SpanRecord>::const_reverse_iterator it = slow_.rbegin(); it != slow_.rend(); ++it) {
+            appendRecord(w, *it);
+        }
+        w.endArray();
+        TraceStats current = stats();
+        w.key("recorded");  w.uinteger(current.recorded);
+        w.key("dropped");   w.uinteger(current.dropped);
+        w.key("threads");   w.uinteger(current.threads);
+        w.endObject();
+        std::atomic_store(&latest_, std::shared_ptr<const std::string>(body));
+    }
+
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (running_) {
+            lock.unlock();
+            collect();
+            lock.lock();
+            if (cv_.wait_for(lock, policy_.drain_interval, [this]() { return !running_; })) {
+                break;
+            }
+        }
+        lock.unlock();
+        collect();  // 停止前取走剩余记录
+    }
+};
+
+// ========== 请求作用域 ==========
+
+/**
+ * @brief 一个请求的追踪作用域：构造时决定是否采样，析构时按需写入当前线程的缓冲区
+ *
+ * 不记录时（未开启、未采样且没有慢请求阈值）所有成员函数都立即返回。
+ * 须在请求 arena 作用域之内构造，析构时才能读到本次请求的 arena 用量。
+ */
+class RequestSpan {
+public:
+    explicit RequestSpan(Tracer* tracer) : tracer_(nullptr), timing_(nullptr), previous_(nullptr) {
+        if (!tracer || !tracer->active()) {
+            return;
+        }
+        bool sampled = tracer->sample();
+        if (!sampled && tracer->slowNanos() == 0) {
+            return;
+        }
+        tracer_ = tracer;
+        std::memset(&record_, 0, sizeof(record_));
+        record_.flags = sampled ? SpanRecord::SAMPLED : 0;
+        record_.route_id = -1;
+        timing_ = new (&timing_storage_) metrics::RequestTiming();
+        record_.start_ns = metrics::monotonicNanos();
+        previous_ = slot();
+        slot() = this;
+    }
+
+    ~RequestSpan() {
+        if (!tracer_) {
+            return;
+        }
+        finish();
+        slot() = previous_;
+        timing_->~RequestTiming();
+    }
+
+    RequestSpan(const RequestSpan&) = delete;
+    RequestSpan& operator=(const RequestSpan&) = delete;
+
+    // 当前线程正在记录的请求（不记录时为 NULL）
+    static RequestSpan* active() { return slot(); }
+
+    bool recording() const { return tracer_ != nullptr; }
+
+    void request(const char* method, const char* path, uint64_t body_bytes) {
+        if (!tracer_) {
+            return;
+        }
+        copyField(record_.method, sizeof(record_.method), method, method ? std::strlen(method) : 0);
+        copyField(record_.path, sizeof(record_.path), path, path ? std::strlen(path) : 0);
+        record_.request_bytes = body_bytes;
+    }
+
+    void route(int route_id, const std::string* pattern) {
+        if (!tracer_) {
+            return;
+        }
+        record_.route_id = route_id;
+        if (pattern) {
+            copyField(record_.route, sizeof(record_.route), pattern->data(), pattern->size());
+        }
+    }
+
+    void response(int status, uint64_t body_bytes) {
+        if (!tracer_) {
+            return;
+        }
+        record_.status = static_cast<uint16_t>(status);
+        record_.response_bytes = body_bytes;
+    }
+
+private:
+    Tracer* tracer_;
+    metrics::RequestTiming* timing_;
+    std::aligned_storage<sizeof(metrics::RequestTiming), alignof(metrics::RequestTiming)>::type timing_storage_;
+    RequestSpan* previous_;
+    SpanRecord record_;
+
+    static RequestSpan*& slot() {
+        static thread_local RequestSpan* current = nullptr;
+        return current;
+    }
+
+    void finish() {
+        uint64_t total = metrics::monotonicNanos() - record_.start_ns;
+        bool slow = tracer_->slowNanos() > 0 && total >= tracer_->slowNanos();
+        if (!slow && !(record_.flags & SpanRecord::SAMPLED)) {
+            return;
+        }
+        record_.flags |= slow ? SpanRecord::SLOW : 0;
+        record_.duration_ns = total;
+        uint64_t others = 0;
+        for (size_t p = 0; p < metrics::kPhaseCount; ++p) {
+            record_.phase_ns[p] = timing_->phase(static_cast<metrics::Phase>(p));
+            others += record_.phase_ns[p];
+        }
+        record_.phase_ns[static_cast<size_t>(metrics::Phase::HANDLER)] = total > others ? total - others : 0;
+        record_.phase_ns[static_cast<size_t>(metrics::Phase::TOTAL)] = total;
+        RequestArena* arena = RequestArena::current();
+        if (arena) {
+            record_.arena_bytes = static_cast<uint32_t>(arena->bytesUsed());
+            record_.arena_allocs = static_cast<uint32_t>(arena->allocations());
+        }
+        record_.trace_id = Tracer::nextRandom();
+        tracer_->ring()->push(record_);
+    }
+};
+
+// 分发路径在写出响应处调用：记录状态码和响应体大小
+inline void noteResponse(int status, uint64_t body_bytes) {
+    RequestSpan* span = RequestSpan::active();
+    if (span) {
+        span->response(status, body_bytes);
+    }
+}
+
+// ========== OTLP 导出 ==========
+
+/**
+ * @brief 把一批记录渲染为 OTLP/HTTP JSON（ExportTraceServiceRequest），追加到 out
+ *
+ * 每条记录是一个 SERVER span；各阶段耗时作为 uvapi.phase.* 属性，状态码 >= 500 时 span 状态为 ERROR。
+ * 发送（如 POST 到收集器的 /v1/traces）由导出回调自行完成。
+ */
+inline void renderOtlpJson(const Tracer& tracer, const std::vector<SpanRecord>& spans,
+                           const std::string& service_name, std::string& out) {
+    json::Writer w(out);
+    w.beginObject();
+    w.key("resourceSpans");
+    w.beginArray();
+    w.beginObject();
+    w.key("resource");
+    w.beginObject();
+    w.key("attributes");
+    w.beginArray();
+    w.beginObject();
+    w.key("key");   w.string("service.name");
+    w.key("value"); w.beginObject(); w.key("stringValue"); w.string(service_name); w.endObject();
+    w.endObject();
+    w.endArray();
+    w.endObject();
+    w.key("scopeSpans");
+    w.beginArray();
+    w.beginObject();
+    w.key("scope");
+    w.beginObject(); w.key("name"); w.string("uvapi"); w.endObject();
+    w.key("spans");
+    w.beginArray();
+    for (size_t i = 0; i < spans.size(); ++i) {
+        const SpanRecord& r = spans[i];
+        uint64_t start = r.start_ns + tracer.wallOffsetNanos();
+        char span_id[17];
+        Tracer::formatHex(Tracer::mix(r.trace_id), span_id);
+        std::string name(r.method);
+        name += ' ';
+        name += r.route[0] ? r.route : r.path;
+
+        w.beginObject();
+        w.key("traceId");            tracer.appendHexId(w, r.trace_id);
+        w.key("spanId");             w.string(span_id, 16);
+        w.key("name");               w.string(name);
+        w.key("kind");               w.integer(2);  // SPAN_KIND_SERVER
+        w.key("startTimeUnixNano");  w.string(std::to_string(start));
+        w.key("endTimeUnixNano");    w.string(std::to_string(start + r.duration_ns));
+        w.key("attributes");
+        w.beginArray();
+        const char* string_keys[] = { "http.request.method", "http.route", "url.path" };
+        const char* string_values[] = { r.method, r.route, r.path };
+        for (size_t k = 0; k < 3; ++k) {
+            if (!string_values[k][0]) {
+                continue;
+            }
+            w.beginObject();
+            w.key("key");   w.string(string_keys[k]);
+            w.key("value"); w.beginObject(); w.key("stringValue"); w.string(string_values[k]); w.endObject();
+            w.endObject();
+        }
+        std::pair<std::string, uint64_t> ints[] = {
+            std::make_pair(std::string("http.response.status_code"), static_cast<uint64_t>(r.status)),
+            std::make_pair(std::string("http.request.body.size"), r.request_bytes),
+            std::make_pair(std::string("http.response.body.size"), r.response_bytes),
+            std::make_pair(std::string("uvapi.arena.bytes"), static_cast<uint64_t>(r.arena_bytes)),
+            std::make_pair(std::string("uvapi.arena.allocations"), static_cast<uint64_t>(r.arena_allocs)),
+        };
+        for (size_t k = 0; k < sizeof(ints) / sizeof(ints[0]); ++k) {
+            w.beginObject();
+            w.key("key");   w.string(ints[k].first);
+            // OTLP JSON 中 int64 按字符串编码
+            w.key("value"); w.beginObject(); w.key("intValue"); w.string(std::to_string(ints[k].second)); w.endObject();
+            w.endObject();
+        }
+        for (size_t p = 0; p < metrics::kPhaseCount; ++p) {
+            metrics::Phase phase = static_cast<metrics::Phase>(p);
+            if (phase == metrics::Phase::TOTAL) {
+                continue;
+            }
+            w.beginObject();
+            w.key("key");   w.string(std::string("uvapi.phase.") + metrics::phaseName(phase) + "_ns");
+            w.key("value"); w.beginObject(); w.key("intValue"); w.string(std::to_string(r.phase_ns[p])); w.endObject();
+            w.endObject();
+        }
+        w.endArray();
+        w.key("status");
+        w.beginObject(); w.key("code"); w.integer(r.status >= 500 ? 2 : 0); w.endObject();
+        w.endObject();
+    }
+    w.endArray();
+    w.endObject();
+    w.endArray();
+    w.endObject();
+    w.endArray();
+    w.endObject();
+}
+
+} // namespace trace
+} // namespace uvapi
+
+#endif // UVAPI_TRACING_H
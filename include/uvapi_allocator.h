@@ -6,6 +6,11 @@
  * - UVAPI_ALLOCATOR_TYPE == 0: 系统分配器（malloc/free）
  * - UVAPI_ALLOCATOR_TYPE == 1: mimalloc 分配器（通过 UVHTTP）
  * - UVAPI_ALLOCATOR_TYPE == 2: 自定义分配器（需要应用层实现）
+ *
+ * RequestArena 是单个请求的线性分配器：分配只移动指针，请求结束时一次性复位。
+ * ArenaScope 把它设为当前线程的活动 arena，ArenaAllocator 让标准容器从中分配，
+ * 框架在开启后同时让 cJSON 的节点和打印缓冲区走活动 arena（见 Server::enableRequestArena、
+ * uvapi_json_alloc / uvapi_json_free）。
  */
 
 #ifndef UVAPI_ALLOCATOR_H
@@ -14,6 +19,10 @@
 #include <stddef.h>
 #include <stdlib.h>
 
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
 // 默认使用系统分配器
 #ifndef UVAPI_ALLOCATOR_TYPE
 #define UVAPI_ALLOCATOR_TYPE 0
@@ -114,6 +123,417 @@ static inline const char* uvapi_allocator_name() {
 #endif
 }
 
+// ========== 请求级 arena ==========
+
+/**
+ * @brief 单个请求的线性分配器
+ *
+ * - allocate() 在当前块内移动指针，块用完时向 uvapi_alloc 申请新块（超过块大小一半的请求单独成块）
+ * - 没有单独的释放操作；reset() 一次性回收全部内存，只保留一个块供下一个请求使用
+ * - 某次请求用了多个块时，reset() 把保留块换成能容纳这次峰值的大小（不超过 kMaxRetained），
+ *   稳定负载下每个请求只用一个块
+ *
+ * 不是线程安全的：每个事件循环线程使用自己的 arena（见 threadArena()）。
+ */
+class RequestArena {
+public:
+    static const size_t kDefaultBlockSize = 16 * 1024;
+    static const size_t kMaxRetained = 1024 * 1024;
+
+    explicit RequestArena(size_t block_size = kDefaultBlockSize)
+        : head_(nullptr), block_size_(block_size < 256 ? 256 : block_size), used_(0), peak_(0), allocs_(0) {}
+
+    ~RequestArena() {
+        releaseFrom(head_);
+    }
+
+    RequestArena(const RequestArena&) = delete;
+    RequestArena& operator=(const RequestArena&) = delete;
+
+    /**
+     * @brief 分配 size 字节，按 align 对齐（align 须为 2 的幂）
+     * @return 失败（包括 size 大到无法表示）时返回 NULL
+     */
+    void* allocate(size_t size, size_t align = alignof(std::max_align_t)) {
+        if (size > SIZE_MAX - align) {
+            return NULL;
+        }
+        if (head_) {
+            void* ptr = bump(head_, size, align);
+            if (ptr) {
+                return ptr;
+            }
+        }
+        size_t need = size + align;
+        Block* block = newBlock(need > block_size_ / 2 ? need : block_size_);
+        if (!block) {
+            return NULL;
+        }
+        // 单独成块的大分配不抢占当前块：挂在当前块之后，后续小分配继续使用当前块
+        if (head_ && need > block_size_ / 2) {
+            block->next = head_->next;
+            head_->next = block;
+        } else {
+            block->next = head_;
+            head_ = block;
+        }
+        return bump(block, size, align);
+    }
+
+    template<typename T>
+    T* allocateArray(size_t count) {
+        return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+    }
+
+    // 复制一段字符串（带结尾 '\0'）
+    char* copyString(const char* data, size_t size) {
+        char* out = static_cast<char*>(allocate(size + 1, 1));
+        if (out) {
+            for (size_t i = 0; i < size; ++i) {
+                out[i] = data[i];
+            }
+            out[size] = '\0';
+        }
+        return out;
+    }
+
+    // 指针是否位于本 arena 的某个块内
+    bool owns(const void* ptr) const {
+        const char* p = static_cast<const char*>(ptr);
+        for (const Block* block = head_; block; block = block->next) {
+            const char* begin = block->data();
+            if (p >= begin && p < begin + block->size) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // 回收本次请求的全部内存
+    void reset() {
+        if (!head_) {
+            return;
+        }
+        size_t total = used_;
+        peak_ = total > peak_ ? total : peak_;
+        if (head_->next) {
+            // 用了多个块：全部释放，换成一个能容纳峰值的块
+            releaseFrom(head_);
+            head_ = nullptr;
+            size_t retained = total + total / 4;
+            if (retained > kMaxRetained) {
+                retained = kMaxRetained;
+            }
+            head_ = newBlock(retained > block_size_ ? retained : block_size_);
+        } else {
+            head_->used = 0;
+        }
+        used_ = 0;
+        allocs_ = 0;
+    }
+
+    size_t bytesUsed() const { return used_; }
+    size_t peakBytes() const { return peak_ > used_ ? peak_ : used_; }
+
+    // 上次 reset() 以来的分配次数
+    size_t allocations() const { return allocs_; }
+
+    size_t bytesReserved() const {
+        size_t total = 0;
+        for (const Block* block = head_; block; block = block->next) {
+            total += block->size;
+        }
+        return total;
+    }
+
+    size_t blockCount() const {
+        size_t count = 0;
+        for (const Block* block = head_; block; block = block->next) {
+            count++;
+        }
+        return count;
+    }
+
+    // 当前线程的活动 arena（不在 ArenaScope 内时为 NULL）
+    static RequestArena* current() { return currentSlot(); }
+
+    // 当前线程的活动 arena 是否同时接管 cJSON 分配
+    static bool jsonHooked() { return jsonSlot(); }
+
+    // 每个线程一个、随线程销毁的 arena
+    static RequestArena& threadArena() {
+        static thread_local RequestArena arena;
+        return arena;
+    }
+
+private:
+    friend class ArenaScope;
+
+    struct Block {
+        Block* next;
+        size_t size;
+        size_t used;
+        char* data() { return reinterpret_cast<char*>(this + 1); }
+        const char* data() const { return reinterpret_cast<const char*>(this + 1); }
+    };
+
+    Block* head_;
+    size_t block_size_;
+    size_t used_;
+    size_t peak_;
+    size_t allocs_;
+
+    static RequestArena*& currentSlot() {
+        static thread_local RequestArena* arena = NULL;
+        return arena;
+    }
+
+    static bool& jsonSlot() {
+        static thread_local bool hooked = false;
+        return hooked;
+    }
+
+    Block* newBlock(size_t size) {
+        if (size > SIZE_MAX - sizeof(Block)) {
+            return NULL;
+        }
+        void* raw = uvapi_alloc(sizeof(Block) + size);
+        if (!raw) {
+            return NULL;
+        }
+        Block* block = static_cast<Block*>(raw);
+        block->next = NULL;
+        block->size = size;
+        block->used = 0;
+        return block;
+    }
+
+    void* bump(Block* block, size_t size, size_t align) {
+        uintptr_t base = reinterpret_cast<uintptr_t>(block->data());
+        uintptr_t start = (base + block->used + align - 1) & ~static_cast<uintptr_t>(align - 1);
+        size_t offset = static_cast<size_t>(start - base);
+        // 分开比较，避免 offset + size 回绕
+        if (offset > block->size || size > block->size - offset) {
+            return NULL;
+        }
+        used_ += offset + size - block->used;
+        block->used = offset + size;
+        allocs_++;
+        return reinterpret_cast<void*>(start);
+    }
+
+    static void releaseFrom(Block* block) {
+        while (block) {
+            Block* next = block->next;
+            uvapi_free(block);
+            block = next;
+        }
+    }
+};
+
+/**
+ * @brief 作用域内把 arena 设为当前线程的活动 arena，离开时复位 arena 并恢复之前的设置
+ *
+ * arena 为 NULL 时不做任何事，便于按配置开关。hook_json 为 true 时 cJSON 分配也走该 arena，
+ * 此时作用域内创建的 cJSON 对象和打印结果不能保留到作用域之外。
+ */
+class ArenaScope {
+public:
+// 作用域内的 arena 可能是局部变量；析构时恢复之前的设置，GCC 12 看不到这一点会误报 -Wdangling-pointer
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 12
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdangling-pointer"
+#endif
+    explicit ArenaScope(RequestArena* arena, bool hook_json = false)
+        : arena_(arena)
+        , previous_(RequestArena::currentSlot())
+        , previous_json_(RequestArena::jsonSlot()) {
+        if (arena_) {
+            RequestArena::currentSlot() = arena_;
+            RequestArena::jsonSlot() = hook_json;
+        }
+    }
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 12
+#pragma GCC diagnostic pop
+#endif
+
+    ~ArenaScope() {
+        if (arena_) {
+            RequestArena::currentSlot() = previous_;
+            RequestArena::jsonSlot() = previous_json_;
+            arena_->reset();
+        }
+    }
+
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+
+private:
+    RequestArena* arena_;
+    RequestArena* previous_;
+    bool previous_json_;
+};
+
+// ========== cJSON 分配钩子 ==========
+
+namespace detail {
+
+// 每次分配前的来源标记：tag 由魔数、来源和大小共同生成，释放时两者都须吻合
+struct JsonAllocHeader {
+    uint64_t tag;
+    uint64_t size;
+};
+
+static const uint64_t kJsonArenaMagic = 0x9e3779b97f4a7c15ULL;
+static const uint64_t kJsonHeapMagic = 0xc2b2ae3d27d4eb4fULL;
+
+static inline uint64_t jsonAllocTag(uint64_t magic, uint64_t size) {
+    return magic ^ (size * 0xff51afd7ed558ccdULL);
+}
+
+} // namespace detail
+
+/**
+ * @brief cJSON 的分配钩子：处于开启 JSON 接管的 ArenaScope 内时从活动 arena 分配，否则使用 malloc
+ *
+ * 每块前有一个 16 字节的来源标记，uvapi_json_free 据此区分 arena 与堆内存，
+ * 不依赖释放时所在的线程或作用域，也不需要全局登记。
+ */
+static inline void* uvapi_json_alloc(size_t size) {
+    const size_t header = sizeof(detail::JsonAllocHeader);
+    if (size > SIZE_MAX - header) {
+        return NULL;
+    }
+    uint64_t magic = detail::kJsonHeapMagic;
+    void* raw = NULL;
+    RequestArena* arena = RequestArena::current();
+    if (arena && RequestArena::jsonHooked()) {
+        raw = arena->allocate(header + size);
+        magic = detail::kJsonArenaMagic;
+    }
+    if (!raw) {
+        raw = malloc(header + size);
+        magic = detail::kJsonHeapMagic;
+    }
+    if (!raw) {
+        return NULL;
+    }
+    detail::JsonAllocHeader* tag = static_cast<detail::JsonAllocHeader*>(raw);
+    tag->tag = detail::jsonAllocTag(magic, size);
+    tag->size = size;
+    return tag + 1;
+}
+
+/**
+ * @brief cJSON 的释放钩子：arena 内存为空操作（随 arena 复位回收），堆内存交给 free()
+ *
+ * 只能释放 uvapi_json_alloc 返回的指针，因此钩子须在创建任何 cJSON 值之前安装（配置阶段），
+ * 钩子生效后 cJSON_Print 等返回的字符串也必须用 cJSON_free 释放而不是 free()。
+ * arena 内的 cJSON 值不能在 arena 复位之后访问，但在作用域外或其他线程上释放是安全的。
+ */
+static inline void uvapi_json_free(void* ptr) {
+    if (!ptr) {
+        return;
+    }
+    detail::JsonAllocHeader* tag = static_cast<detail::JsonAllocHeader*>(ptr) - 1;
+    if (tag->tag == detail::jsonAllocTag(detail::kJsonArenaMagic, tag->size)) {
+        return;
+    }
+    if (tag->tag == detail::jsonAllocTag(detail::kJsonHeapMagic, tag->size)) {
+        free(tag);
+        return;
+    }
+    // 不是本钩子分配的指针（如安装钩子之前创建的值），按普通 malloc 指针处理
+    free(ptr);
+}
+
+/**
+ * @brief 从 RequestArena 分配的标准库分配器（arena 内的内存 deallocate 为空操作）
+ *
+ * 容器必须在 arena 复位之前销毁，如 std::vector<int, ArenaAllocator<int> > v(ArenaAllocator<int>(arena))。
+ * arena 分配失败时退回 operator new(std::nothrow)，仍失败时返回 NULL（框架不使用异常）。
+ */
+template<typename T>
+class ArenaAllocator {
+public:
+    typedef T value_type;
+
+    explicit ArenaAllocator(RequestArena& arena) : arena_(&arena) {}
+
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena_(other.arena()) {}
+
+    T* allocate(size_t n) {
+        void* ptr = n > SIZE_MAX / sizeof(T) ? NULL : arena_->allocate(n * sizeof(T), alignof(T));
+        if (!ptr && n <= SIZE_MAX / sizeof(T)) {
+            ptr = ::operator new(n * sizeof(T), std::nothrow);
+        }
+        return static_cast<T*>(ptr);
+    }
+
+    void deallocate(T* ptr, size_t) {
+        if (ptr && !arena_->owns(ptr)) {
+            ::operator delete(ptr);
+        }
+    }
+
+    RequestArena* arena() const { return arena_; }
+
+    template<typename U>
+    bool operator==(const ArenaAllocator<U>& other) const { return arena_ == other.arena(); }
+
+    template<typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const { return arena_ != other.arena(); }
+
+private:
+    RequestArena* arena_;
+};
+
+/**
+ * @brief 构造时绑定当前线程的活动 arena，没有活动 arena 或 arena 分配失败时退回 operator new(std::nothrow)
+ *
+ * 用于框架内部只在请求期间存在的容器（如请求视图的溢出存储），不需要显式传递 arena。
+ */
+template<typename T>
+class RequestAllocator {
+public:
+    typedef T value_type;
+
+    RequestAllocator() : arena_(RequestArena::current()) {}
+
+    template<typename U>
+    RequestAllocator(const RequestAllocator<U>& other) : arena_(other.arena()) {}
+
+    // 分配失败时返回 NULL（框架不使用异常）
+    T* allocate(size_t n) {
+        if (n > SIZE_MAX / sizeof(T)) {
+            return NULL;
+        }
+        void* ptr = arena_ ? arena_->allocate(n * sizeof(T), alignof(T)) : NULL;
+        if (!ptr) {
+            ptr = ::operator new(n * sizeof(T), std::nothrow);
+        }
+        return static_cast<T*>(ptr);
+    }
+
+    void deallocate(T* ptr, size_t) {
+        if (ptr && (!arena_ || !arena_->owns(ptr))) {
+            ::operator delete(ptr);
+        }
+    }
+
+    RequestArena* arena() const { return arena_; }
+
+    template<typename U>
+    bool operator==(const RequestAllocator<U>& other) const { return arena_ == other.arena(); }
+
+    template<typename U>
+    bool operator!=(const RequestAllocator<U>& other) const { return arena_ != other.arena(); }
+
+private:
+    RequestArena* arena_;
+};
+
 } // namespace uvapi
 
 #endif // UVAPI_ALLOCATOR_H
\ No newline at end of file
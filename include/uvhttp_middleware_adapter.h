@@ -28,29 +28,17 @@ public:
         return [](uvhttp_request_t* uv_req, 
                    uvhttp_response_t* uv_resp, 
                    uvhttp_middleware_context_t* ctx) -> int {
-            // 转换 UVHTTP 请求/响应为 UVAPI 请求/响应
-            HttpRequest req = convertRequest(uv_req);
+            // 转换 UVHTTP 请求为 UVAPI 请求（与路由分发共用同一套头部与查询参数解析）
+            HttpRequest req;
+            convertRequest(uv_req, req);
             
             // 创建下一个处理器的 lambda
             RequestHandler next_handler = [uv_req, uv_resp](const HttpRequest& r) -> HttpResponse {
                 // 将处理后的请求转换回 UVHTTP 响应
                 HttpResponse uvapi_resp = r;
                 
-                // 设置 UVHTTP 响应状态码
-                uvhttp_response_set_status(uv_resp, uvapi_resp.status_code);
-                
-                // 设置响应头
-                for (const auto& header : uvapi_resp.headers) {
-                    uvhttp_response_set_header(uv_resp, 
-                                                 header.first.c_str(), 
-                                                 header.second.c_str());
-                }
-                
-                // 设置响应体
-                if (!uvapi_resp.body.empty()) {
-                    uvhttp_response_set_body(uv_resp, uvapi_resp.body.c_str(), 
-                                            uvapi_resp.body.length());
-                }
+                // 状态码、响应头和响应体一次写入
+                applyResponse(uv_resp, uvapi_resp);
                 
                 return uvapi_resp;
             };
@@ -59,125 +47,12 @@ public:
             HttpResponse uvapi_resp = middleware(req, next_handler);
             
             // 转换 UVAPI 响应为 UVHTTP 响应
-            uvhttp_response_set_status(uv_resp, uvapi_resp.status_code);
-            
-            for (const auto& header : uvapi_resp.headers) {
-                uvhttp_response_set_header(uv_resp, 
-                                             header.first.c_str(), 
-                                             header.second.c_str());
-            }
-            
-            if (!uvapi_resp.body.empty()) {
-                uvhttp_response_set_body(uv_resp, uvapi_resp.body.c_str(), 
-                                        uvapi_resp.body.length());
-            }
+            applyResponse(uv_resp, uvapi_resp);
             
             // 返回继续处理
             return UVHTTP_MIDDLEWARE_CONTINUE;
         };
     }
-    
-private:
-    /**
-     * @brief 将 UVHTTP 请求转换为 UVAPI 请求
-     */
-    static HttpRequest convertRequest(uvhttp_request_t* uv_req) {
-        HttpRequest req;
-        
-        // 设置 HTTP 方法
-        const char* method_str = uvhttp_request_get_method(uv_req);
-        if (method_str) {
-            req.method = stringToHttpMethod(method_str);
-        }
-        
-        // 设置 URL 路径
-        const char* path_str = uvhttp_request_get_path(uv_req);
-        if (path_str) {
-            req.url_path = path_str;
-        }
-        
-        // 设置请求头
-        uvhttp_request_foreach_header(uv_req, [](const char* name, 
-                                                     const char* value, 
-                                                     void* user_data) {
-            HttpRequest* req = static_cast<HttpRequest*>(user_data);
-            req->headers[name] = value;
-            return 0;
-        }, &req);
-        
-        // 设置查询参数
-        const char* query_str = uvhttp_request_get_query(uv_req);
-        if (query_str) {
-            parseQueryString(query_str, req.query_params);
-        }
-        
-        // 设置请求体
-        const char* body_str = uvhttp_request_get_body(uv_req);
-        size_t body_len = uvhttp_request_get_body_length(uv_req);
-        if (body_str && body_len > 0) {
-            req.body = std::string(body_str, body_len);
-        }
-        
-        return req;
-    }
-    
-    /**
-     * @brief 解析查询字符串
-     */
-    static void parseQueryString(const std::string& query, 
-                                 std::map<std::string, std::string>& params) {
-        size_t pos = 0;
-        while (pos < query.length()) {
-            size_t key_end = query.find('=', pos);
-            if (key_end == std::string::npos) break;
-            
-            size_t value_end = query.find('&', key_end);
-            if (value_end == std::string::npos) value_end = query.length();
-            
-            std::string key = query.substr(pos, key_end - pos);
-            std::string value = query.substr(key_end + 1, value_end - key_end - 1);
-            
-            // URL 解码
-            key = urlDecode(key);
-            value = urlDecode(value);
-            
-            params[key] = value;
-            pos = value_end + 1;
-        }
-    }
-    
-    /**
-     * @brief URL 解码
-     */
-    static std::string urlDecode(const std::string& str) {
-        std::string result;
-        for (size_t i = 0; i < str.length(); ++i) {
-            if (str[i] == '%' && i + 2 < str.length()) {
-                char hex[3] = {str[i+1], str[i+2], 0};
-                result += static_cast<char>(std::strtol(hex, nullptr, 16));
-                i += 2;
-            } else if (str[i] == '+') {
-                result += ' ';
-            } else {
-                result += str[i];
-            }
-        }
-        return result;
-    }
-    
-    /**
-     * @brief 将字符串转换为 HTTP 方法枚举
-     */
-    static HttpMethod stringToHttpMethod(const std::string& method) {
-        if (method == "GET") return HttpMethod::GET;
-        if (method == "POST") return HttpMethod::POST;
-        if (method == "PUT") return HttpMethod::PUT;
-        if (method == "DELETE") return HttpMethod::DELETE;
-        if (method == "PATCH") return HttpMethod::PATCH;
-        if (method == "HEAD") return HttpMethod::HEAD;
-        if (method == "OPTIONS") return HttpMethod::OPTIONS;
-        return HttpMethod::GET;
-    }
 };
 
 /**
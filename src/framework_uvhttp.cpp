@@ -6,15 +6,31 @@
  */
 
 #include "framework.h"
+#include "query_string.h"
 #include "uvhttp_connection.h"
+#include "server_cluster.h"
+#include "token_store.h"
 #include <sstream>
 #include <cstdlib>
 #include <iostream>
 #include <cstring>
-#include <random>
 #include <climits>
 #include <cerrno>
+#include <condition_variable>
 #include <type_traits>
+#include <unordered_set>
+#include <sys/socket.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <mbedtls/md.h>
+#include <mbedtls/ctr_drbg.h>
+#include <mbedtls/entropy.h>
+#include <mbedtls/version.h>
+#include <mbedtls/ssl.h>
+#include <mbedtls/ssl_ticket.h>
+#include <mbedtls/ssl_cache.h>
+#include <mbedtls/x509_crt.h>
+#include <mbedtls/pk.h>
 
 namespace uvapi {
 
@@ -114,362 +130,3430 @@ std::string jsonData(const std::string& data) {
     return restful::JSON::data(data);
 }
 
-// ========== Server 层实现 ==========
+// ========== 异步响应状态 ==========
+
+// 一次异步请求：阶段转换 PENDING → COMPLETED / CANCELLED 在互斥锁内完成（可能来自任意线程），
+// COMPLETED → FINISHED 只在事件循环线程用 CAS 完成，因此响应恰好写出一次
+struct Responder::State {
+    enum Phase { PENDING, COMPLETED, FINISHED, CANCELLED, STREAMING };
+    
+    std::atomic<int> phase;
+    std::mutex mutex;  // 保护 response、on_cancel、retained
+    HttpResponse response;
+    std::function<void()> on_cancel;
+    std::vector<std::shared_ptr<const void> > retained;
+    std::function<void()> cleanup;  // 框架内部：完成或取消时在事件循环线程调用一次
+    
+    // 以下字段在处理器执行前填好，之后只读
+    std::shared_ptr<HttpRequest> request;  // uvhttp 的请求缓冲区在回调结束后失效，持有一份副本
+    uvhttp_response_t* resp;
+    uv_tcp_t* client;
+    std::weak_ptr<server::AsyncLoop> loop;
+    uint64_t deadline_ms;  // uv_now 时间
+    uint64_t started_ns;
+    compress::Encoding encoding;
+    std::shared_ptr<const compress::CompressionPolicy> compression;
+    std::shared_ptr<metrics::RouteMetrics> metrics;
+    std::shared_ptr<server::ConnectionTracker> connections;  // 未跟踪连接时为空
+    uint64_t peer;
+    bool tls;  // 连接经过 TLS：流式响应直接写套接字，不可用
+    
+    State()
+        : phase(PENDING), resp(nullptr), client(nullptr), deadline_ms(0), started_ns(0),
+          encoding(compress::Encoding::IDENTITY), peer(0), tls(false) {}
+};
 
 // ========== Server 层实现 ==========
 
 namespace server {
 
-// uvhttp 请求回调
-int on_uvhttp_request(uvhttp_request_t* req, uvhttp_response_t* resp) {
-    if (!req || !resp) {
-        if (resp) {
-            uvhttp_response_set_status(resp, 500);
-            uvhttp_response_send(resp);
-        }
-        return -1;
-    }
+// 本循环的异步队列：其他线程完成的响应经 wakeup 交回循环，定时器检查超时和断开
+struct AsyncLoop {
+    uv_async_t wakeup;
+    uv_timer_t timer;
+    uv_thread_t thread;  // 事件循环线程
     
-    // 获取 server 实例
-    // 通过 req->client->data 获取 connection，然后通过 connection->server 获取服务器
-    uvhttp_connection_t* conn = static_cast<uvhttp_connection_t*>(req->client->data);
-    if (!conn || !conn->server) {
-        uvhttp_response_set_status(resp, 500);
-        uvhttp_response_send(resp);
-        return -1;
-    }
-    uvhttp_server_t* http_server = conn->server;
-    if (!http_server || !http_server->user_data) {
-        uvhttp_response_set_status(resp, 500);
-        uvhttp_response_send(resp);
-        return -1;
-    }
+    std::mutex mutex;  // 保护 completed、tasks、closed
+    std::vector<std::shared_ptr<Responder::State> > completed;
+    std::vector<std::function<void()> > tasks;
+    bool closed;
     
-    server::Server* svr_instance = reinterpret_cast<server::Server*>(http_server->user_data);
+    // 以下只在事件循环线程访问
+    std::vector<std::shared_ptr<Responder::State> > pending;
+    uint64_t tick_ms;
+    bool timer_active;
+    int open_handles;
+    std::shared_ptr<AsyncLoop> self;  // 关闭期间保持存活，最后一个关闭回调释放
     
-    // 构造 HttpRequest
-    HttpRequest uvapi_req;
-    
-    // 获取方法
-    const char* method_str = uvhttp_request_get_method(req);
-    uvhttp_method_t uvhttp_method = uvhttp_method_from_string(method_str);
-    if (uvhttp_method == UVHTTP_GET) {
-        uvapi_req.method = HttpMethod::GET;
-    } else if (uvhttp_method == UVHTTP_POST) {
-        uvapi_req.method = HttpMethod::POST;
-    } else if (uvhttp_method == UVHTTP_PUT) {
-        uvapi_req.method = HttpMethod::PUT;
-    } else if (uvhttp_method == UVHTTP_DELETE) {
-        uvapi_req.method = HttpMethod::DELETE;
-    } else if (uvhttp_method == UVHTTP_HEAD) {
-        uvapi_req.method = HttpMethod::HEAD;
-    } else if (uvhttp_method == UVHTTP_OPTIONS) {
-        uvapi_req.method = HttpMethod::OPTIONS;
-    } else if (uvhttp_method == UVHTTP_PATCH) {
-        uvapi_req.method = HttpMethod::PATCH;
-    } else {
-        uvapi_req.method = HttpMethod::ANY;
+    AsyncLoop() : closed(false), tick_ms(50), timer_active(false), open_handles(0) {}
+    
+    // 在其他线程完成时调用；队列已关闭时返回 false（stopAsync 会处理仍在 pending 中的请求）
+    bool post(const std::shared_ptr<Responder::State>& state) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (closed) {
+            return false;
+        }
+        completed.push_back(state);
+        uv_async_send(&wakeup);
+        return true;
     }
     
-    uvapi_req.url_path = uvhttp_request_get_path(req);
-    uvapi_req.user_id = 0;
+    // 在事件循环线程执行 task（例如其他线程恢复请求体投递）
+    bool post(std::function<void()> task) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (closed) {
+            return false;
+        }
+        tasks.push_back(std::move(task));
+        uv_async_send(&wakeup);
+        return true;
+    }
     
-    // 获取请求头
+    bool onLoopThread() const {
+        uv_thread_t current = uv_thread_self();
+        return uv_thread_equal(&current, &thread) != 0;
+    }
+};
+
+namespace {
+
+HttpMethod toHttpMethod(uvhttp_method_t uvhttp_method) {
+    switch (uvhttp_method) {
+        case UVHTTP_GET: return HttpMethod::GET;
+        case UVHTTP_POST: return HttpMethod::POST;
+        case UVHTTP_PUT: return HttpMethod::PUT;
+        case UVHTTP_DELETE: return HttpMethod::DELETE;
+        case UVHTTP_HEAD: return HttpMethod::HEAD;
+        case UVHTTP_OPTIONS: return HttpMethod::OPTIONS;
+        case UVHTTP_PATCH: return HttpMethod::PATCH;
+        default: return HttpMethod::ANY;
+    }
+}
+
+// 查询参数解码缓冲区：arena 为 NULL 或分配失败时使用 fallback
+struct QueryScratch {
+    RequestArena* arena;
+    std::vector<char>* fallback;
+
+    char* operator()(size_t size) const {
+        char* out = arena ? static_cast<char*>(arena->allocate(size, 1)) : nullptr;
+        if (!out) {
+            fallback->resize(size);
+            out = fallback->data();
+        }
+        return out;
+    }
+};
+
+// 解码后的切片只在回调内使用时共用一个线程缓冲区，不占用 arena
+std::vector<char>* transientQueryBuffer() {
+    static thread_local std::vector<char> buffer;
+    return &buffer;
+}
+
+template<typename Fn>
+void forEachQueryParam(const char* query, const QueryScratch& scratch, Fn fn) {
+    if (query) {
+        query::forEachParam(query, std::strlen(query), scratch, fn);
+    }
+}
+
+// 请求体按长度取，二进制内容中的 '\0' 不会截断
+StringSlice requestBody(uvhttp_request_t* req) {
+    const char* body = uvhttp_request_get_body(req);
+    return body ? StringSlice(body, uvhttp_request_get_body_length(req)) : StringSlice();
+}
+
+void fillRequestView(uvhttp_request_t* req, HttpRequestView& view,
+                     const RouteTable::RouteParam* params, int param_count) {
     for (size_t i = 0; i < req->header_count; i++) {
         const uvhttp_header_t* header = uvhttp_request_get_header_at(req, i);
         if (header) {
-            uvapi_req.headers[header->name] = header->value;
+            StringSlice name(header->name);
+            const HeaderName* known = internHeaderName(name.data, name.size);
+            if (known) {
+                name = StringSlice(known->data, known->size);
+            }
+            view.headers.add(name, StringSlice(header->value));
         }
     }
-    
-    // 获取查询参数
-    const char* query_string = uvhttp_request_get_query_string(req);
-    if (query_string && strlen(query_string) > 0) {
-        // 简单解析查询参数 - 使用 std::string 和 std::vector 替代 strdup
-        size_t query_len = strlen(query_string);
-        std::vector<char> query_copy(query_string, query_string + query_len + 1); // +1 for null terminator
-        
-        char* token = strtok(query_copy.data(), "&");
-        while (token != nullptr) {
-            char* equals = strchr(token, '=');
-            if (equals) {
-                *equals = '\0';
-                uvapi_req.query_params[token] = equals + 1;
-            }
-            token = strtok(nullptr, "&");
+    // 解码结果随视图存活：arena 内分配，否则放入视图自带的缓冲区
+    QueryScratch scratch = { RequestArena::current(), &view.query_buffer };
+    forEachQueryParam(uvhttp_request_get_query_string(req), scratch,
+                      [&view](const StringSlice& k, const StringSlice& v) { view.query_params.add(k, v); });
+    for (int i = 0; i < param_count; i++) {
+        view.path_params.add(StringSlice(*params[i].name), StringSlice(params[i].value, params[i].length));
+    }
+    view.body = requestBody(req);
+}
+
+void fillRequest(uvhttp_request_t* req, HttpRequest& out,
+                 const RouteTable::RouteParam* params, int param_count, bool copy_body = true) {
+    for (size_t i = 0; i < req->header_count; i++) {
+        const uvhttp_header_t* header = uvhttp_request_get_header_at(req, i);
+        if (header) {
+            out.headers[header->name] = header->value;
         }
     }
-    
-    // 获取请求体
-    const char* body = uvhttp_request_get_body(req);
-    if (body) {
-        uvapi_req.body = body;
+    QueryScratch scratch = { nullptr, transientQueryBuffer() };
+    forEachQueryParam(uvhttp_request_get_query_string(req), scratch,
+                      [&out](const StringSlice& k, const StringSlice& v) { out.addQueryParam(k.toString(), v.toString()); });
+    for (int i = 0; i < param_count; i++) {
+        out.path_params[*params[i].name].assign(params[i].value, params[i].length);
     }
-    
-    // 使用 uvhttp 路由匹配获取路径参数
-    uvhttp_route_match_t match;
-    uvhttp_error_t match_result = uvhttp_router_match(
-        svr_instance->router_.get(),
-        uvapi_req.url_path.c_str(),
-        method_str,
-        &match
-    );
-    
-    // 查找自定义处理器
-    auto handler = svr_instance->findHandler(uvapi_req.url_path, uvapi_req.method);
-    
-    if (handler) {
-        // 提取路径参数（仅在匹配成功时）
-        if (match_result == UVHTTP_OK) {
-            for (size_t i = 0; i < match.param_count; i++) {
-                uvapi_req.path_params[match.params[i].name] = match.params[i].value;
-            }
+    StringSlice body = requestBody(req);
+    if (copy_body && body.valid()) {
+        out.body.assign(body.data, body.size);
+    }
+}
+
+// 由已持有的请求构建视图（后台刷新时 uvhttp 缓冲区已不可用）
+void fillRequestViewFrom(const HttpRequest& source, HttpRequestView& view) {
+    view.method = source.method;
+    view.url_path = StringSlice(source.url_path);
+    view.body = StringSlice(source.body);
+    for (RequestHeaders::const_iterator it = source.headers.begin(); it != source.headers.end(); ++it) {
+        view.headers.add(StringSlice(it->first), StringSlice(it->second));
+    }
+    for (std::map<std::string, std::string>::const_iterator it = source.query_params.begin(); it != source.query_params.end(); ++it) {
+        std::map<std::string, std::vector<std::string> >::const_iterator multi = source.query_multi.find(it->first);
+        if (multi == source.query_multi.end()) {
+            view.query_params.add(StringSlice(it->first), StringSlice(it->second));
+            continue;
         }
-        
-        // 调用处理器
-        HttpResponse uvapi_resp = handler(uvapi_req);
-        
-        // 设置响应
-        uvhttp_response_set_status(resp, uvapi_resp.status_code);
-        
-        // 设置响应头
-        for (std::map<std::string, std::string>::const_iterator it = uvapi_resp.headers.begin(); 
-             it != uvapi_resp.headers.end(); ++it) {
-            uvhttp_response_set_header(resp, it->first.c_str(), it->second.c_str());
+        for (size_t i = 0; i < multi->second.size(); i++) {
+            view.query_params.add(StringSlice(it->first), StringSlice(multi->second[i]));
         }
-        
-        // 设置响应体
-        if (!uvapi_resp.body.empty()) {
-            uvhttp_response_set_body(resp, uvapi_resp.body.c_str(), uvapi_resp.body.size());
+    }
+    for (std::map<std::string, std::string>::const_iterator it = source.path_params.begin(); it != source.path_params.end(); ++it) {
+        view.path_params.add(StringSlice(it->first), StringSlice(it->second));
+    }
+}
+
+// 按名称查找请求头（大小写不敏感），不存在时返回无效切片
+StringSlice findRequestHeader(uvhttp_request_t* req, const std::string& name) {
+    for (size_t i = 0; i < req->header_count; i++) {
+        const uvhttp_header_t* header = uvhttp_request_get_header_at(req, i);
+        if (header && StringSlice(header->name).equalsIgnoreCase(name.data(), name.size())) {
+            return StringSlice(header->value);
         }
-        
-        uvhttp_response_send(resp);
+    }
+    return StringSlice();
+}
+
+// 按名称查找查询参数（第一个匹配，已解码），不存在时返回无效切片；结果在下一次解析前有效
+StringSlice findQueryParam(uvhttp_request_t* req, const std::string& name) {
+    StringSlice found;
+    QueryScratch scratch = { nullptr, transientQueryBuffer() };
+    forEachQueryParam(uvhttp_request_get_query_string(req), scratch,
+                      [&found, &name](const StringSlice& k, const StringSlice& v) {
+                          if (!found.valid() && k.equals(name.data(), name.size())) {
+                              found = v;
+                          }
+                      });
+    return found;
+}
+
+void sendResponse(uvhttp_response_t* resp, const HttpResponse& response) {
+    metrics::PhaseTimer timer(metrics::Phase::SERIALIZATION);
+    applyResponse(resp, response);
+    trace::noteResponse(response.status_code, response.body.size());
+    uvhttp_response_send(resp);
+}
+
+// 直接从预编码缓冲区写出（头部已是以 '\0' 结尾的字符串）
+void sendCached(uvhttp_response_t* resp, const CachedResponse& cached, bool with_body) {
+    metrics::PhaseTimer timer(metrics::Phase::SERIALIZATION);
+    uvhttp_response_set_status(resp, cached.status());
+    for (size_t i = 0; i < cached.headerCount(); i++) {
+        uvhttp_response_set_header(resp, cached.headerName(i), cached.headerValue(i));
+    }
+    if (with_body && cached.bodySize() > 0) {
+        uvhttp_response_set_body(resp, cached.body(), cached.bodySize());
+    }
+    trace::noteResponse(cached.status(), with_body ? cached.bodySize() : 0);
+    uvhttp_response_send(resp);
+}
+
+// 304 只带验证相关的头部
+void sendNotModified(uvhttp_response_t* resp, const CachedResponse& cached) {
+    metrics::PhaseTimer timer(metrics::Phase::SERIALIZATION);
+    uvhttp_response_set_status(resp, 304);
+    trace::noteResponse(304, 0);
+    for (size_t i = 0; i < cached.headerCount(); i++) {
+        StringSlice name(cached.headerName(i));
+        if (name.equalsIgnoreCase("ETag", 4) || name.equalsIgnoreCase("Cache-Control", 13) ||
+            name.equalsIgnoreCase("Vary", 4) || name.equalsIgnoreCase("Expires", 7)) {
+            uvhttp_response_set_header(resp, cached.headerName(i), cached.headerValue(i));
+        }
+    }
+    uvhttp_response_send(resp);
+}
+
+// 可缓存时写入缓存并返回预编码响应，否则返回 nullptr
+std::shared_ptr<const CachedResponse> storeCached(RouteCache& cache, const std::string& key,
+                                                  const HttpResponse& response) {
+    const CachedResponse::HeaderList& headers = response.headers.entries();
+    if (!RouteCache::isCacheable(response.status_code, headers)) {
+        return nullptr;
+    }
+    metrics::PhaseTimer timer(metrics::Phase::SERIALIZATION);
+    std::shared_ptr<const CachedResponse> cached =
+        CachedResponse::create(response.status_code, headers, response.body);
+    cache.store(key, cached);
+    return cached;
+}
+
+// 后台刷新任务：持有请求副本和处理器副本，不依赖 Server 的生命周期
+struct RevalidationTask {
+    uv_timer_t timer;
+    std::function<void()> run;
+};
+
+void onRevalidationClosed(uv_handle_t* handle) {
+    delete static_cast<RevalidationTask*>(handle->data);
+}
+
+void onRevalidationTimer(uv_timer_t* timer) {
+    RevalidationTask* task = static_cast<RevalidationTask*>(timer->data);
+    task->run();
+    uv_close(reinterpret_cast<uv_handle_t*>(timer), onRevalidationClosed);
+}
+
+// 对端地址写入 buf，返回长度（取不到时为 0）
+size_t peerAddress(uvhttp_request_t* req, char* buf, size_t size) {
+    struct sockaddr_storage addr;
+    int len = static_cast<int>(sizeof(addr));
+    if (!req->client || uv_tcp_getpeername(req->client, reinterpret_cast<struct sockaddr*>(&addr), &len) != 0) {
         return 0;
     }
-    
-    // 404 Not Found
-    uvhttp_response_set_status(resp, 404);
+    int rc = addr.ss_family == AF_INET6
+        ? uv_ip6_name(reinterpret_cast<const struct sockaddr_in6*>(&addr), buf, size)
+        : uv_ip4_name(reinterpret_cast<const struct sockaddr_in*>(&addr), buf, size);
+    return rc == 0 ? std::strlen(buf) : 0;
+}
+
+void installJsonArenaHooks() {
+    static std::once_flag once;
+    std::call_once(once, []() {
+        cJSON_Hooks hooks;
+        hooks.malloc_fn = uvapi_json_alloc;
+        hooks.free_fn = uvapi_json_free;
+        cJSON_InitHooks(&hooks);
+    });
+}
+
+void sendServiceUnavailable(uvhttp_response_t* resp, uint64_t retry_after_seconds) {
+    char retry_after[24];
+    std::snprintf(retry_after, sizeof(retry_after), "%llu", static_cast<unsigned long long>(retry_after_seconds));
+    uvhttp_response_set_status(resp, 503);
     uvhttp_response_set_header(resp, "Content-Type", "application/json");
-    const char* not_found = R"({"error": "Not Found", "message": "The requested resource was not found"})";
-    uvhttp_response_set_body(resp, not_found, strlen(not_found));
+    uvhttp_response_set_header(resp, "Retry-After", retry_after);
+    const char* body = R"({"error": "Service Unavailable", "message": "Server is overloaded, retry later"})";
+    uvhttp_response_set_body(resp, body, std::strlen(body));
+    trace::noteResponse(503, std::strlen(body));
     uvhttp_response_send(resp);
-    
-    return 0;
 }
 
-server::Server::Server(uv_loop_t* loop) 
-    : loop_(loop), use_https_(false) {
-    
-    if (!loop_) {
-        std::cerr << "Error: Event loop cannot be null" << std::endl;
+// 按策略压缩响应体；不满足条件（状态码、大小、类型、已编码）时保持原样
+void compressResponse(const compress::CompressionPolicy& policy, compress::Encoding encoding, HttpResponse& response) {
+    if (response.status_code < 200 || response.status_code == 204 || response.status_code == 206 ||
+        response.status_code >= 300 || response.body.size() < policy.min_size ||
+        response.headers.has("Content-Encoding")) {
         return;
     }
-    
-    // 创建 uvhttp 上下文（两步法：创建 + 初始化）
-    uvhttp_context_t* ctx_ptr = nullptr;
-    uvhttp_error_t result = uvhttp_context_create(loop_, &ctx_ptr);
-    if (result != UVHTTP_OK || !ctx_ptr) {
-        std::cerr << "Error: Failed to create uvhttp context" << std::endl;
+    const std::string* content_type = response.headers.get(header::CONTENT_TYPE);
+    if (!content_type || !policy.allowsType(StringSlice(*content_type))) {
         return;
     }
-    
-    result = uvhttp_context_init(ctx_ptr);
-    if (result != UVHTTP_OK) {
-        uvhttp_context_destroy(ctx_ptr);
-        std::cerr << "Error: Failed to initialize uvhttp context" << std::endl;
+    const std::string* cache_control = response.headers.get(header::CACHE_CONTROL);
+    if (cache_control && cache_control->find("no-transform") != std::string::npos) {
         return;
     }
-    uvhttp_ctx_ = makeUvhttpContext(ctx_ptr);
-    
-    // 创建配置
-    uvhttp_config_t* config_ptr = nullptr;
-    result = uvhttp_config_new(&config_ptr);
-    if (result != UVHTTP_OK || !config_ptr) {
-        std::cerr << "Error: Failed to create uvhttp config" << std::endl;
+    // 可压缩的表示都需要 Vary，共享缓存才不会把压缩结果交给不支持的客户端
+    std::string& vary = response.headers["Vary"];
+    if (vary.empty()) {
+        vary = "Accept-Encoding";
+    } else if (vary.find("Accept-Encoding") == std::string::npos && vary != "*") {
+        vary += ", Accept-Encoding";
+    }
+    if (encoding == compress::Encoding::IDENTITY) {
         return;
     }
-    config_ = makeUvhttpConfig(config_ptr);
     
-    // 创建路由器
-    uvhttp_router_t* router_ptr = nullptr;
-    result = uvhttp_router_new(&router_ptr);
-    if (result != UVHTTP_OK || !router_ptr) {
-        std::cerr << "Error: Failed to create uvhttp router" << std::endl;
+    metrics::PhaseTimer timer(metrics::Phase::SERIALIZATION);
+    // 输出缓冲区按线程复用：交换后原响应体的容量留给下一次压缩
+    static thread_local std::string scratch;
+    if (!compress::compressBody(encoding, policy, response.body.data(), response.body.size(), scratch)) {
         return;
     }
-    router_ = makeUvhttpRouter(router_ptr);
-    
-    // 创建服务器
-    uvhttp_server_t* server_ptr = nullptr;
-    result = uvhttp_server_new(loop_, &server_ptr);
-    if (result != UVHTTP_OK || !server_ptr) {
-        std::cerr << "Error: Failed to create uvhttp server" << std::endl;
+    response.body.swap(scratch);
+    response.headers.set("Content-Encoding", compress::encodingName(encoding));
+    // 强 ETag 标识字节内容，压缩后的表示需要不同的值
+    ResponseHeaders::iterator etag = response.headers.find("ETag");
+    if (etag != response.headers.end() && etag->second.size() >= 2 && etag->second[etag->second.size() - 1] == '"') {
+        etag->second.insert(etag->second.size() - 1, encoding == compress::Encoding::BROTLI ? "-br" : "-gz");
+    }
+}
+
+// 静态目录前缀统一为以 '/' 开头、不以 '/' 结尾（根前缀为空串）
+std::string normalizeMountPrefix(const std::string& prefix) {
+    std::string out = prefix;
+    while (!out.empty() && out[out.size() - 1] == '/') {
+        out.resize(out.size() - 1);
+    }
+    if (!out.empty() && out[0] != '/') {
+        out.insert(0, "/");
+    }
+    return out;
+}
+
+// 静态响应的验证头部（200 / 206 / 304 共用）
+void setStaticValidators(uvhttp_response_t* resp, const StaticFile& chosen, const StaticFile& original,
+                         const StaticOptions& options) {
+    uvhttp_response_set_header(resp, "ETag", chosen.etag.c_str());
+    uvhttp_response_set_header(resp, "Last-Modified", original.last_modified.c_str());
+    if (!options.cache_control.empty()) {
+        uvhttp_response_set_header(resp, "Cache-Control", options.cache_control.c_str());
+    }
+    if (original.br || original.gzip) {
+        uvhttp_response_set_header(resp, "Vary", "Accept-Encoding");
+    }
+}
+
+const char* methodName(HttpMethod method) {
+    switch (method) {
+        case HttpMethod::GET: return "GET";
+        case HttpMethod::POST: return "POST";
+        case HttpMethod::PUT: return "PUT";
+        case HttpMethod::DELETE: return "DELETE";
+        case HttpMethod::HEAD: return "HEAD";
+        case HttpMethod::OPTIONS: return "OPTIONS";
+        case HttpMethod::PATCH: return "PATCH";
+        case HttpMethod::ANY: return "ANY";
+    }
+    return "ANY";
+}
+
+// ========== 异步请求 ==========
+
+const char kAsyncTimeoutBody[] = R"({"error": "Gateway Timeout", "message": "The handler did not respond in time"})";
+const char kAsyncShutdownBody[] = R"({"error": "Service Unavailable", "message": "Server is shutting down"})";
+
+// 经过中间件时，流水线末端从这里取得本次请求的异步状态（取走即表示处理器已启动）
+// ========== 连接跟踪 ==========
+
+uint64_t monotonicMillis() {
+    return metrics::monotonicNanos() / 1000000;
+}
+
+// 对端地址（含端口）的 FNV-1a 摘要，取不到时为 0
+uint64_t peerDigest(uv_tcp_t* client) {
+    struct sockaddr_storage addr;
+    int len = static_cast<int>(sizeof(addr));
+    if (!client || uv_tcp_getpeername(client, reinterpret_cast<struct sockaddr*>(&addr), &len) != 0) {
+        return 0;
+    }
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&addr);
+    uint64_t hash = 14695981039346656037ULL;
+    for (int i = 0; i < len; i++) {
+        hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+void onShutdownComplete(uv_shutdown_t* req, int) {
+    delete req;
+}
+
+// 半关闭连接：已排队的写完成后发出 FIN，对端关闭后由 uvhttp 回收连接
+bool shutdownConnection(uv_tcp_t* client) {
+    if (uv_is_closing(reinterpret_cast<uv_handle_t*>(client))) {
+        return false;
+    }
+    uv_shutdown_t* req = new uv_shutdown_t();
+    if (uv_shutdown(req, reinterpret_cast<uv_stream_t*>(client), onShutdownComplete) != 0) {
+        delete req;
+        return false;
+    }
+    return true;
+}
+
+// 请求结束；连接已达到请求上限且没有其他进行中的请求时半关闭
+void endTrackedRequest(ConnectionTracker& tracker, uv_tcp_t* client, uint64_t peer) {
+    ConnectionTracker::Connection* connection = tracker.end(client, peer, monotonicMillis());
+    if (connection && connection->draining && connection->in_flight == 0) {
+        shutdownConnection(client);
+    }
+}
+
+std::shared_ptr<Responder::State>& currentAsyncCall() {
+    static thread_local std::shared_ptr<Responder::State> current;
+    return current;
+}
+
+bool asyncClientGone(const Responder::State& state) {
+    return state.client && uv_is_closing(reinterpret_cast<const uv_handle_t*>(state.client));
+}
+
+// 完成后释放取消回调（回调常捕获 Responder 自身，不释放会形成循环引用）；
+// 请求副本和 keepAlive 的资源随最后一个 Responder 副本释放，处理器线程此时可能仍在使用
+void releaseAsync(Responder::State& state) {
+    std::function<void()> on_cancel;
+    std::function<void()> cleanup;
+    std::shared_ptr<ConnectionTracker> connections;
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        on_cancel.swap(state.on_cancel);
+        cleanup.swap(state.cleanup);
+        connections.swap(state.connections);
+    }
+    if (cleanup) {
+        cleanup();
+    }
+    if (connections) {
+        endTrackedRequest(*connections, state.client, state.peer);
+    }
+}
+
+// 在事件循环线程写出已完成的响应；客户端已断开时丢弃
+void finishAsync(const std::shared_ptr<Responder::State>& state) {
+    int expected = Responder::State::COMPLETED;
+    if (!state->phase.compare_exchange_strong(expected, Responder::State::FINISHED)) {
         return;
     }
-    server_ = makeUvhttpServer(server_ptr);
-    
-    // 设置路由器到服务器
-    server_->router = router_.get();
-    server_->config = config_.get();
-    server_->user_data = this;
+    HttpResponse response = std::move(state->response);
+    if (!asyncClientGone(*state)) {
+        if (state->compression) {
+            compressResponse(*state->compression, state->encoding, response);
+        }
+        sendResponse(state->resp, response);
+        if (state->metrics) {
+            state->metrics->record(response.status_code, metrics::monotonicNanos() - state->started_ns);
+        }
+    }
+    releaseAsync(*state);
 }
 
-// 移动构造函数
-server::Server::Server(Server&& other) noexcept
-    : loop_(other.loop_),
-      server_(std::move(other.server_)),
-      router_(std::move(other.router_)),
-      uvhttp_ctx_(std::move(other.uvhttp_ctx_)),
-      config_(std::move(other.config_)),
-      tls_config_(std::move(other.tls_config_)),
-      use_https_(other.use_https_),
-      handlers_(std::move(other.handlers_)) {
-    if (server_) server_->user_data = this;
+// 在事件循环线程取消仍未完成的请求：超时返回 504，停止时返回 503，断开时不写出；之后执行 onCancel 回调
+enum class CancelReason { TIMEOUT, DISCONNECT, SHUTDOWN };
+
+void cancelAsync(const std::shared_ptr<Responder::State>& state, CancelReason reason) {
+    std::function<void()> on_cancel;
+    bool streaming;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        int phase = state->phase.load();
+        streaming = phase == Responder::State::STREAMING;
+        // 流式响应不受超时约束；头部已写出，断开和停止时只中止，不再写错误响应
+        if (phase != Responder::State::PENDING && !(streaming && reason != CancelReason::TIMEOUT)) {
+            return;
+        }
+        state->phase.store(Responder::State::CANCELLED);
+        on_cancel.swap(state->on_cancel);
+    }
+    if (!streaming && reason != CancelReason::DISCONNECT && !asyncClientGone(*state)) {
+        bool timeout = reason == CancelReason::TIMEOUT;
+        uvhttp_response_set_status(state->resp, timeout ? 504 : 503);
+        uvhttp_response_set_header(state->resp, "Content-Type", "application/json");
+        const char* body = timeout ? kAsyncTimeoutBody : kAsyncShutdownBody;
+        uvhttp_response_set_body(state->resp, body, std::strlen(body));
+        uvhttp_response_send(state->resp);
+        if (state->metrics) {
+            state->metrics->record(timeout ? 504 : 503, metrics::monotonicNanos() - state->started_ns);
+        }
+    }
+    if (on_cancel) {
+        on_cancel();
+    }
+    releaseAsync(*state);
 }
 
-// 移动赋值运算符
-server::Server& server::Server::operator=(Server&& other) noexcept {
-    if (this != &other) {
-        loop_ = other.loop_;
-        server_ = std::move(other.server_);
-        router_ = std::move(other.router_);
-        uvhttp_ctx_ = std::move(other.uvhttp_ctx_);
-        config_ = std::move(other.config_);
-        tls_config_ = std::move(other.tls_config_);
-        use_https_ = other.use_https_;
-        handlers_ = std::move(other.handlers_);
+void onAsyncWakeup(uv_async_t* handle) {
+    AsyncLoop* loop = static_cast<AsyncLoop*>(handle->data);
+    std::vector<std::shared_ptr<Responder::State> > completed;
+    std::vector<std::function<void()> > tasks;
+    {
+        std::lock_guard<std::mutex> lock(loop->mutex);
+        completed.swap(loop->completed);
+        tasks.swap(loop->tasks);
+    }
+    for (size_t i = 0; i < completed.size(); i++) {
+        finishAsync(completed[i]);
+    }
+    for (size_t i = 0; i < tasks.size(); i++) {
+        tasks[i]();
+    }
+}
+
+void onAsyncTimer(uv_timer_t* timer) {
+    AsyncLoop* loop = static_cast<AsyncLoop*>(timer->data);
+    uint64_t now = uv_now(timer->loop);
+    std::vector<std::shared_ptr<Responder::State> >& pending = loop->pending;
+    size_t kept = 0;
+    for (size_t i = 0; i < pending.size(); i++) {
+        std::shared_ptr<Responder::State> state = pending[i];
+        int phase = state->phase.load();
+        if (phase == Responder::State::PENDING || phase == Responder::State::STREAMING) {
+            if (asyncClientGone(*state)) {
+                cancelAsync(state, CancelReason::DISCONNECT);
+            } else if (phase == Responder::State::PENDING && state->deadline_ms <= now) {
+                cancelAsync(state, CancelReason::TIMEOUT);
+            }
+        }
+        // 已完成但尚未写出的请求留在列表中，直到 wakeup 写出；流式响应留到结束，以便检测断开
+        phase = state->phase.load();
+        if (phase == Responder::State::PENDING || phase == Responder::State::COMPLETED ||
+            phase == Responder::State::STREAMING) {
+            pending[kept++] = state;
+        }
+    }
+    pending.resize(kept);
+    if (pending.empty()) {
+        uv_timer_stop(&loop->timer);
+        loop->timer_active = false;
+    }
+}
+
+} // namespace
+} // namespace server
+
+void convertRequest(uvhttp_request_t* req, HttpRequest& out) {
+    out.method = server::toHttpMethod(uvhttp_method_from_string(uvhttp_request_get_method(req)));
+    const char* path = uvhttp_request_get_path(req);
+    out.url_path = path ? path : "";
+    server::fillRequest(req, out, nullptr, 0);
+}
+
+// ========== 分块请求体 ==========
+
+// 回调和投递进度只在事件循环线程访问；mutex 只保护跨线程的暂停 / 恢复标志
+struct BodyStream::State {
+    std::function<BodyAction(StringSlice)> on_chunk;
+    std::function<void()> on_end;
+    std::shared_ptr<Responder::State> call;
+    BodyFeeder feeder;
+    std::atomic<uint64_t> received;
+    uint64_t total;
+    size_t chunk_size;
+    bool pumping;
+    bool finished;
+    
+    std::mutex mutex;
+    bool paused;
+    bool resume_requested;  // 块回调返回 PAUSE 之前已经调用了 resume()
+    
+    State() : received(0), total(0), chunk_size(64 * 1024), pumping(false), finished(false),
+              paused(false), resume_requested(false) {}
+};
+
+namespace server {
+namespace {
+
+// 结束投递并释放回调（回调通常捕获 BodyStream 自身，不释放会形成循环引用）
+void closeBodyStream(BodyStream::State& stream) {
+    stream.finished = true;
+    stream.feeder.reset(nullptr, 0);
+    std::function<BodyAction(StringSlice)> on_chunk;
+    std::function<void()> on_end;
+    on_chunk.swap(stream.on_chunk);
+    on_end.swap(stream.on_end);
+}
+
+// 在事件循环线程投递请求体，直到投递完、暂停、中止或请求已完成
+void pumpBody(const std::shared_ptr<BodyStream::State>& stream) {
+    if (stream->pumping || stream->finished) {
+        return;  // 块回调中同步调用了 resume()，由外层循环继续
+    }
+    stream->pumping = true;
+    while (!stream->finished) {
+        int phase = stream->call->phase.load();
+        if (phase != Responder::State::PENDING && phase != Responder::State::STREAMING) {
+            closeBodyStream(*stream);  // 已响应、超时或断开：丢弃剩余部分
+            break;
+        }
+        if (stream->feeder.done()) {
+            std::function<void()> on_end;
+            on_end.swap(stream->on_end);
+            stream->finished = true;
+            if (on_end) {
+                on_end();
+            }
+            closeBodyStream(*stream);
+            break;
+        }
+        StringSlice chunk = stream->feeder.next(stream->chunk_size);
+        stream->received.fetch_add(chunk.size);
+        {
+            std::lock_guard<std::mutex> lock(stream->mutex);
+            stream->resume_requested = false;
+        }
+        BodyAction action = stream->on_chunk ? stream->on_chunk(chunk) : BodyAction::CONTINUE;
+        if (action == BodyAction::ABORT) {
+            closeBodyStream(*stream);
+            Responder(stream->call).send(HttpResponse(400).json(
+                R"({"error": "Bad Request", "message": "Request body rejected"})"));
+            break;
+        }
+        if (action == BodyAction::PAUSE) {
+            // 连接的缓冲区在本次回调之后失效，剩余部分复制出来
+            stream->feeder.detach();
+            std::lock_guard<std::mutex> lock(stream->mutex);
+            if (stream->resume_requested) {
+                stream->resume_requested = false;
+                continue;
+            }
+            stream->paused = true;
+            break;
+        }
+    }
+    stream->pumping = false;
+}
+
+// 启动异步处理器或分块请求体处理器；body 为连接缓冲区中的原始请求体（仅分块路由使用）
+void startAsyncCall(const AsyncHandler& async_handler, const BodyStreamHandler& stream_handler,
+                    const std::shared_ptr<Responder::State>& state, const HttpRequest& req, StringSlice body) {
+    if (!stream_handler) {
+        async_handler(req, Responder(state));
+        return;
+    }
+    std::shared_ptr<BodyStream::State> stream = std::make_shared<BodyStream::State>();
+    stream->call = state;
+    stream->feeder.reset(body.data, body.size);
+    stream->total = body.size;
+    std::weak_ptr<BodyStream::State> weak = stream;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->cleanup = [weak]() {
+            std::shared_ptr<BodyStream::State> locked = weak.lock();
+            // 投递中（回调里发出了响应）由投递循环自己收尾
+            if (locked && !locked->pumping) {
+                closeBodyStream(*locked);
+            }
+        };
+    }
+    stream_handler(req, BodyStream(stream), Responder(state));
+    pumpBody(stream);
+    if (!stream->finished && !stream->feeder.owned()) {
+        stream->feeder.detach();
+    }
+}
+
+// 分发期间的原始请求体（分块路由经过中间件时，流水线末端从这里取）
+StringSlice& currentAsyncBody() {
+    static thread_local StringSlice body;
+    return body;
+}
+
+} // namespace
+} // namespace server
+
+// ========== 流式响应 ==========
+
+// 写入队列和水位在 mutex 下跨线程共享；写出、回调和收尾只在事件循环线程进行
+struct ResponseStream::State {
+    std::shared_ptr<Responder::State> call;
+    std::mutex mutex;
+    std::condition_variable drained;  // waitWritable() 在此等待
+    std::vector<std::string> queued;  // 已分帧、尚未交给 libuv 的数据（第一项是状态行和头部）
+    size_t queued_bytes;              // queued 中的响应体字节
+    size_t buffered;                  // 已写入但尚未发送完的响应体字节（含 libuv 写队列中的部分）
+    size_t low_watermark;
+    size_t high_watermark;
+    std::function<void()> on_drain;
+    bool chunked;
+    bool with_body;    // HEAD 请求只写出头部
+    bool ended;        // 已调用 end()
+    bool closed;       // 结束块已交给 libuv，或连接已断开
+    bool flush_posted;
+    int status;
+    
+    State()
+        : queued_bytes(0), buffered(0), low_watermark(256 * 1024), high_watermark(1024 * 1024),
+          chunked(true), with_body(true), ended(false), closed(false), flush_posted(false), status(200) {}
+};
+
+// ========== 安全随机数 ==========
+
+namespace {
+
+// 每个线程一个 CTR-DRBG 实例，首次使用时从系统熵源播种（之后由 mbedtls 按间隔自动重播种）
+struct ThreadRandom {
+    mbedtls_entropy_context entropy;
+    mbedtls_ctr_drbg_context drbg;
+    bool ready;
+    
+    ThreadRandom() : ready(false) {
+        static const char kPersonalization[] = "uvapi-token";
+        mbedtls_entropy_init(&entropy);
+        mbedtls_ctr_drbg_init(&drbg);
+        ready = mbedtls_ctr_drbg_seed(&drbg, mbedtls_entropy_func, &entropy,
+                                      reinterpret_cast<const unsigned char*>(kPersonalization),
+                                      sizeof(kPersonalization) - 1) == 0;
+    }
+    
+    ~ThreadRandom() {
+        mbedtls_ctr_drbg_free(&drbg);
+        mbedtls_entropy_free(&entropy);
+    }
+};
+
+bool secureRandom(unsigned char* out, size_t size) {
+    static thread_local ThreadRandom rng;
+    if (!rng.ready || mbedtls_ctr_drbg_random(&rng.drbg, out, size) != 0) {
+        std::cerr << "Error: Secure random generator unavailable" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+namespace server {
+namespace {
+
+struct StreamWrite {
+    uv_write_t req;
+    std::vector<std::string> chunks;
+    std::vector<uv_buf_t> bufs;
+    std::shared_ptr<ResponseStream::State> stream;
+    size_t payload;
+};
+
+// 丢弃未写出的数据并释放回调（回调常捕获流自身），唤醒 waitWritable() 的等待方
+void closeResponseStream(ResponseStream::State& stream) {
+    std::function<void()> on_drain;
+    {
+        std::lock_guard<std::mutex> lock(stream.mutex);
+        stream.closed = true;
+        stream.queued.clear();
+        stream.queued_bytes = 0;
+        on_drain.swap(stream.on_drain);
+    }
+    stream.drained.notify_all();
+}
+
+// 写出失败或连接已断开：按断开取消（执行 onCancel），再关闭流
+void failResponseStream(const std::shared_ptr<ResponseStream::State>& stream) {
+    cancelAsync(stream->call, CancelReason::DISCONNECT);
+    closeResponseStream(*stream);
+}
+
+void onStreamWritten(uv_write_t* req, int status) {
+    StreamWrite* write = static_cast<StreamWrite*>(req->data);
+    std::shared_ptr<ResponseStream::State> stream = std::move(write->stream);
+    size_t payload = write->payload;
+    delete write;
+    if (status < 0) {
+        failResponseStream(stream);
+        return;
+    }
+    std::function<void()> on_drain;
+    {
+        std::lock_guard<std::mutex> lock(stream->mutex);
+        stream->buffered -= payload;
+        if (stream->buffered <= stream->low_watermark && !stream->ended && !stream->closed) {
+            on_drain.swap(stream->on_drain);
+        }
+    }
+    stream->drained.notify_all();
+    if (on_drain) {
+        on_drain();
+    }
+}
+
+// 在事件循环线程把累积的块一次交给 libuv；结束块写出后半关闭连接，对端关闭后由 uvhttp 回收
+void flushResponseStream(const std::shared_ptr<ResponseStream::State>& stream) {
+    StreamWrite* write = new StreamWrite();
+    bool finishing;
+    {
+        std::lock_guard<std::mutex> lock(stream->mutex);
+        stream->flush_posted = false;
+        if (stream->closed) {
+            delete write;
+            return;
+        }
+        write->chunks.swap(stream->queued);
+        write->payload = stream->queued_bytes;
+        stream->queued_bytes = 0;
+        finishing = stream->ended;
+        stream->closed = finishing;
+    }
+    Responder::State& call = *stream->call;
+    if (asyncClientGone(call)) {
+        delete write;
+        failResponseStream(stream);
+        return;
+    }
+    uv_stream_t* client = reinterpret_cast<uv_stream_t*>(call.client);
+    if (!write->chunks.empty()) {
+        write->bufs.reserve(write->chunks.size());
+        for (size_t i = 0; i < write->chunks.size(); i++) {
+            std::string& chunk = write->chunks[i];
+            write->bufs.push_back(uv_buf_init(&chunk[0], static_cast<unsigned int>(chunk.size())));
+        }
+        write->stream = stream;
+        write->req.data = write;
+        if (uv_write(&write->req, client, write->bufs.data(), static_cast<unsigned int>(write->bufs.size()),
+                     onStreamWritten) != 0) {
+            delete write;
+            failResponseStream(stream);
+            return;
+        }
+    } else {
+        delete write;
+    }
+    if (!finishing) {
+        return;
+    }
+    // shutdown 在已排队的写完成之后才发出 FIN
+    shutdownConnection(call.client);
+    int expected = Responder::State::STREAMING;
+    if (call.phase.compare_exchange_strong(expected, Responder::State::FINISHED)) {
+        if (call.metrics) {
+            call.metrics->record(stream->status, metrics::monotonicNanos() - call.started_ns);
+        }
+        releaseAsync(call);
+    }
+}
+
+// 同一轮事件循环内的多次写入合并为一次 uv_write
+void scheduleFlush(const std::shared_ptr<ResponseStream::State>& stream) {
+    {
+        std::lock_guard<std::mutex> lock(stream->mutex);
+        if (stream->flush_posted) {
+            return;
+        }
+        stream->flush_posted = true;
+    }
+    std::shared_ptr<AsyncLoop> loop = stream->call->loop.lock();
+    if (!loop || !loop->post([stream]() { flushResponseStream(stream); })) {
+        closeResponseStream(*stream);  // 服务器已停止
+    }
+}
+
+void onAsyncClosed(uv_handle_t* handle) {
+    AsyncLoop* loop = static_cast<AsyncLoop*>(handle->data);
+    if (--loop->open_handles == 0) {
+        std::shared_ptr<AsyncLoop> last;
+        last.swap(loop->self);
+    }
+}
+
+} // namespace
+
+HttpResponse Server::runHandler(const RouteEntry& entry, const HttpRequest& req) {
+    if (entry.pipeline) {
+        return entry.pipeline->run(req);
+    }
+    if (entry.view_handler) {
+        HttpRequestView view;
+        fillRequestViewFrom(req, view);
+        return entry.view_handler(view);
+    }
+    return entry.handler(req);
+}
+
+HttpResponse Server::invokeRoute(const RouteEntry& entry, uvhttp_request_t* req, HttpMethod method,
+                                 const char* path, const RouteTable::RouteParam* params, int param_count) {
+    if (entry.view_handler && !entry.pipeline) {
+        // 零拷贝路径：视图直接引用 uvhttp 缓冲区
+        HttpRequestView view;
+        {
+            metrics::PhaseTimer timer(metrics::Phase::PARSE);
+            view.method = method;
+            view.url_path = StringSlice(path);
+            fillRequestView(req, view, params, param_count);
+        }
+        return entry.view_handler(view);
+    }
+    // 复用池中的请求对象：字符串容量跨请求保留
+    ObjectPool<HttpRequest>::Handle pooled = requestPool().acquire();
+    HttpRequest& uvapi_req = *pooled;
+    {
+        metrics::PhaseTimer timer(metrics::Phase::PARSE);
+        uvapi_req.method = method;
+        uvapi_req.url_path = path;
+        fillRequest(req, uvapi_req, params, param_count);
+    }
+    return entry.pipeline ? entry.pipeline->run(uvapi_req) : entry.handler(uvapi_req);
+}
+
+int Server::dispatchCached(const RouteEntry& entry, uvhttp_request_t* req, uvhttp_response_t* resp,
+                            HttpMethod method, const char* path,
+                            const RouteTable::RouteParam* params, int param_count) {
+    RouteCache& cache = *entry.cache;
+    // HEAD 与 GET 共用缓存条目
+    int key_method = static_cast<int>(method == HttpMethod::HEAD ? HttpMethod::GET : method);
+    std::string key = cache.buildKey(key_method, StringSlice(path),
+        [req](const std::string& name) { return findQueryParam(req, name); },
+        [req](const std::string& name) { return findRequestHeader(req, name); });
+    // 每种协商出的编码各缓存一份（已压缩的）响应
+    compress::Encoding encoding = negotiateEncoding(req);
+    if (encoding != compress::Encoding::IDENTITY) {
+        key += '\x1f';
+        key += compress::encodingName(encoding);
+    }
+    StringSlice if_none_match = findRequestHeader(req, "If-None-Match");
+    bool with_body = method != HttpMethod::HEAD;
+    
+    std::shared_ptr<const CachedResponse> cached;
+    RouteCache::Freshness freshness = cache.lookup(key, cached);
+    if (freshness != RouteCache::Freshness::MISS) {
+        int status = 304;
+        if (cached->matchesIfNoneMatch(if_none_match)) {
+            sendNotModified(resp, *cached);
+        } else {
+            sendCached(resp, *cached, with_body);
+            status = cached->status();
+        }
+        // 过期命中：先返回旧响应，同一个键只安排一次刷新
+        if (freshness == RouteCache::Freshness::STALE && cache.beginRevalidation(key)) {
+            scheduleRevalidation(entry, req, path, params, param_count, key, encoding);
+        }
+        return status;
+    }
+    
+    HttpResponse response = invokeRoute(entry, req, method, path, params, param_count);
+    if (compression_) {
+        compressResponse(*compression_, encoding, response);
+    }
+    std::shared_ptr<const CachedResponse> fresh = storeCached(cache, key, response);
+    if (!fresh) {
+        sendResponse(resp, response);
+        return response.status_code;
+    }
+    if (fresh->matchesIfNoneMatch(if_none_match)) {
+        sendNotModified(resp, *fresh);
+        return 304;
+    }
+    sendCached(resp, *fresh, with_body);
+    return fresh->status();
+}
+
+bool Server::admitRequest(rate::KeyedRateLimiter& limiter, uvhttp_request_t* req, uvhttp_response_t* resp,
+                          const char* route) {
+    const rate::RateLimitPolicy& policy = limiter.policy();
+    StringSlice key;
+    char addr[64];
+    if (policy.key_source == rate::KeySource::ROUTE) {
+        key = StringSlice(route);
+    } else {
+        if (policy.key_source == rate::KeySource::HEADER) {
+            key = findRequestHeader(req, policy.header);
+        }
+        if (!key.valid() || key.empty()) {
+            key = StringSlice(addr, peerAddress(req, addr, sizeof(addr)));
+        }
+    }
+    
+    rate::RateLimitDecision decision = limiter.tryAcquire(key.data, key.size);
+    if (decision.allowed) {
+        return true;
+    }
+    
+    char retry_after[24];
+    std::snprintf(retry_after, sizeof(retry_after), "%llu",
+                  static_cast<unsigned long long>((decision.retry_after_ms + 999) / 1000));
+    uvhttp_response_set_status(resp, 429);
+    uvhttp_response_set_header(resp, "Content-Type", "application/json");
+    uvhttp_response_set_header(resp, "Retry-After", retry_after);
+    const char* body = R"({"error": "Too Many Requests", "message": "Rate limit exceeded, retry later"})";
+    uvhttp_response_set_body(resp, body, std::strlen(body));
+    trace::noteResponse(429, std::strlen(body));
+    uvhttp_response_send(resp);
+    return false;
+}
+
+int Server::dispatch(const RouteEntry& entry, uvhttp_request_t* req, uvhttp_response_t* resp,
+                     HttpMethod method, const char* path,
+                     const RouteTable::RouteParam* params, int param_count) {
+    // 缓存命中会绕过中间件，带中间件的路由不经过缓存
+    if (entry.cache && !entry.pipeline && (method == HttpMethod::GET || method == HttpMethod::HEAD)) {
+        return dispatchCached(entry, req, resp, method, path, params, param_count);
+    }
+    HttpResponse response = invokeRoute(entry, req, method, path, params, param_count);
+    if (compression_) {
+        compressResponse(*compression_, negotiateEncoding(req), response);
+    }
+    sendResponse(resp, response);
+    return response.status_code;
+}
+
+void Server::dispatchMeasured(const RouteEntry& entry, uvhttp_request_t* req, uvhttp_response_t* resp,
+                              HttpMethod method, const char* path,
+                              const RouteTable::RouteParam* params, int param_count) {
+    if (!entry.metrics) {
+        dispatch(entry, req, resp, method, path, params, param_count);
+        return;
+    }
+    // 计时在栈上，处理期间的 PhaseTimer 都累计到这里
+    metrics::RequestTiming timing;
+    int status = dispatch(entry, req, resp, method, path, params, param_count);
+    entry.metrics->record(status, timing);
+}
+
+void Server::dispatchAsync(const RouteEntry& entry, uvhttp_request_t* req, uvhttp_response_t* resp,
+                           HttpMethod method, const char* path,
+                           const RouteTable::RouteParam* params, int param_count) {
+    std::shared_ptr<AsyncLoop> loop = asyncLoop();
+    std::shared_ptr<Responder::State> state = std::make_shared<Responder::State>();
+    state->request = std::make_shared<HttpRequest>();
+    bool streaming = static_cast<bool>(entry.stream_handler);
+    {
+        metrics::PhaseTimer timer(metrics::Phase::PARSE);
+        state->request->method = method;
+        state->request->url_path = path;
+        // 分块路由不复制请求体，直接从连接缓冲区投递
+        fillRequest(req, *state->request, params, param_count, !streaming);
+    }
+    state->resp = resp;
+    state->client = req->client;
+    state->tls = use_https_;
+    state->loop = loop;
+    uint64_t timeout_ms = static_cast<uint64_t>(entry.async_timeout.count());
+    state->deadline_ms = uv_now(loop_) + timeout_ms;
+    state->started_ns = metrics::monotonicNanos();
+    state->encoding = negotiateEncoding(req);
+    state->compression = compression_;
+    state->metrics = entry.metrics;
+    if (connections_) {
+        state->connections = connections_;
+        state->peer = request_peer_;
+    }
+    
+    Responder responder(state);
+    StringSlice body = streaming ? requestBody(req) : StringSlice();
+    if (!entry.pipeline) {
+        startAsyncCall(entry.async_handler, entry.stream_handler, state, *state->request, body);
+    } else {
+        // 流水线末端取走当前状态并启动处理器；没有取走说明中间件短路，直接发送其响应
+        std::shared_ptr<Responder::State>& current = currentAsyncCall();
+        std::shared_ptr<Responder::State> previous = std::move(current);
+        StringSlice previous_body = currentAsyncBody();
+        current = state;
+        currentAsyncBody() = body;
+        HttpResponse response = entry.pipeline->run(*state->request);
+        bool started = !current;
+        current = std::move(previous);
+        currentAsyncBody() = previous_body;
+        if (!started) {
+            responder.send(std::move(response));
+        }
+    }
+    
+    if (state->phase.load() != Responder::State::PENDING) {
+        return;
+    }
+    loop->pending.push_back(state);
+    // 轮询间隔取超时的 1/4，限制在 1~50ms
+    uint64_t tick = timeout_ms / 4;
+    tick = tick < 1 ? 1 : (tick > 50 ? 50 : tick);
+    if (!loop->timer_active || tick < loop->tick_ms) {
+        loop->tick_ms = tick;
+        uv_timer_start(&loop->timer, onAsyncTimer, loop->tick_ms, loop->tick_ms);
+        loop->timer_active = true;
+    }
+}
+
+std::shared_ptr<AsyncLoop> Server::asyncLoop() {
+    if (!async_loop_) {
+        std::shared_ptr<AsyncLoop> loop = std::make_shared<AsyncLoop>();
+        loop->thread = uv_thread_self();
+        uv_async_init(loop_, &loop->wakeup, onAsyncWakeup);
+        loop->wakeup.data = loop.get();
+        uv_timer_init(loop_, &loop->timer);
+        loop->timer.data = loop.get();
+        // 不让空闲的异步队列阻止事件循环退出
+        uv_unref(reinterpret_cast<uv_handle_t*>(&loop->wakeup));
+        uv_unref(reinterpret_cast<uv_handle_t*>(&loop->timer));
+        loop->open_handles = 2;
+        async_loop_ = loop;
+    }
+    return async_loop_;
+}
+
+void Server::stopAsync() {
+    std::shared_ptr<AsyncLoop> loop = std::move(async_loop_);
+    async_loop_.reset();
+    if (!loop) {
+        return;
+    }
+    std::vector<std::shared_ptr<Responder::State> > completed;
+    {
+        std::lock_guard<std::mutex> lock(loop->mutex);
+        loop->closed = true;
+        completed.swap(loop->completed);
+    }
+    // 已完成的照常写出，仍未完成的返回 503
+    for (size_t i = 0; i < completed.size(); i++) {
+        finishAsync(completed[i]);
+    }
+    std::vector<std::shared_ptr<Responder::State> > pending;
+    pending.swap(loop->pending);
+    for (size_t i = 0; i < pending.size(); i++) {
+        cancelAsync(pending[i], CancelReason::SHUTDOWN);
+        finishAsync(pending[i]);
+    }
+    loop->timer_active = false;
+    loop->self = loop;
+    uv_close(reinterpret_cast<uv_handle_t*>(&loop->wakeup), onAsyncClosed);
+    uv_close(reinterpret_cast<uv_handle_t*>(&loop->timer), onAsyncClosed);
+}
+
+compress::Encoding Server::negotiateEncoding(uvhttp_request_t* req) const {
+    if (!compression_) {
+        return compress::Encoding::IDENTITY;
+    }
+    return compress::negotiate(*compression_, findRequestHeader(req, "Accept-Encoding"));
+}
+
+void Server::scheduleRevalidation(const RouteEntry& entry, uvhttp_request_t* req, const char* path, const RouteTable::RouteParam* params, int param_count,
+                                  const std::string& key, compress::Encoding encoding) {
+    // 复制请求：uvhttp 的请求缓冲区在本次回调结束后失效
+    // 按 GET 重新执行（HEAD 命中触发的刷新同样需要完整响应体）
+    std::shared_ptr<HttpRequest> owned = std::make_shared<HttpRequest>();
+    owned->method = HttpMethod::GET;
+    owned->url_path = path;
+    fillRequest(req, *owned, params, param_count);
+    
+    std::shared_ptr<RouteCache> cache = entry.cache;
+    RouteEntry target;
+    target.handler = entry.handler;
+    target.view_handler = entry.view_handler;
+    
+    std::shared_ptr<const compress::CompressionPolicy> compression = compression_;
+    
+    RevalidationTask* task = new RevalidationTask();
+    task->run = [owned, cache, target, key, compression, encoding]() {
+        HttpResponse response = runHandler(target, *owned);
+        if (compression) {
+            compressResponse(*compression, encoding, response);
+        }
+        storeCached(*cache, key, response);
+        cache->endRevalidation(key);
+    };
+    
+    uv_timer_init(loop_, &task->timer);
+    task->timer.data = task;
+    if (uv_timer_start(&task->timer, onRevalidationTimer, 0, 0) != 0) {
+        cache->endRevalidation(key);
+        uv_close(reinterpret_cast<uv_handle_t*>(&task->timer), onRevalidationClosed);
+    }
+}
+
+// 请求期间占用连接的进行中计数；未跟踪连接时为空操作
+struct server::Server::ConnectionScope {
+    Server* server;
+    uv_tcp_t* client;
+    uint64_t peer;
+    bool active;
+    
+    ConnectionScope(Server* owner, uvhttp_request_t* req, uvhttp_response_t* resp)
+        : server(owner), client(req->client), peer(0), active(owner->connections_ != nullptr) {
+        if (active) {
+            peer = server->beginConnection(req, resp);
+        }
+    }
+    
+    ~ConnectionScope() {
+        if (active) {
+            server->endConnection(client, peer);
+        }
+    }
+    
+    // 请求已转交给队列，由队列结束
+    void release() { active = false; }
+};
+
+// uvhttp 请求回调
+int on_uvhttp_request(uvhttp_request_t* req, uvhttp_response_t* resp) {
+    if (!req || !resp) {
+        if (resp) {
+            uvhttp_response_set_status(resp, 500);
+            uvhttp_response_send(resp);
+        }
+        return -1;
+    }
+    
+    // 获取 server 实例
+    // 通过 req->client->data 获取 connection，然后通过 connection->server 获取服务器
+    uvhttp_connection_t* conn = static_cast<uvhttp_connection_t*>(req->client->data);
+    if (!conn || !conn->server) {
+        uvhttp_response_set_status(resp, 500);
+        uvhttp_response_send(resp);
+        return -1;
+    }
+    uvhttp_server_t* http_server = conn->server;
+    if (!http_server || !http_server->user_data) {
+        uvhttp_response_set_status(resp, 500);
+        uvhttp_response_send(resp);
+        return -1;
+    }
+    
+    server::Server* svr_instance = reinterpret_cast<server::Server*>(http_server->user_data);
+    
+    // 连接跟踪：返回时结束本次请求（转交给异步队列或准入队列的由其结束）
+    Server::ConnectionScope connection_scope(svr_instance, req, resp);
+    
+    // 本次请求的临时分配在返回（响应已发出）时一次性回收
+    ArenaScope arena_scope(svr_instance->request_arena_ ? &RequestArena::threadArena() : nullptr,
+                           svr_instance->arena_json_);
+    
+    // 追踪在 arena 之后构造、之前析构，记录时还能读到本次请求的 arena 用量
+    trace::RequestSpan span(svr_instance->tracer_.get());
+    
+    HttpMethod method = toHttpMethod(uvhttp_method_from_string(uvhttp_request_get_method(req)));
+    const char* path = uvhttp_request_get_path(req);
+    if (!path) {
+        path = "";
+    }
+    if (span.recording()) {
+        span.request(uvhttp_request_get_method(req), path, uvhttp_request_get_body_length(req));
+    }
+    
+    // CORS 在路由之前处理：预检直接应答，其他跨源请求的允许头部随响应一并写出
+    if (svr_instance->cors_ && Server::applyCors(*svr_instance->cors_, req, resp, method)) {
+        return 0;
+    }
+    
+    // 读区内使用已发布的路由表：不加锁，期间发布的新表不影响本次请求，旧表在读区结束后才会回收
+    Server::RouteCell::ReadGuard routes(*svr_instance->routes_, svr_instance->route_reader_);
+    const Server::RouteSnapshot& snapshot = *routes;
+    
+    // 单次匹配：路由表同时给出路由 ID 和路径参数切片，无需再按路径字符串二次查找
+    RouteTable::RouteParam route_params[RouteTable::kMaxParams];
+    int route_param_count = 0;
+    int route_id = snapshot.table.match(path, std::strlen(path), static_cast<int>(method),
+                                        route_params, &route_param_count);
+    const Server::RouteEntry* entry = nullptr;
+    if (route_id != RouteTable::kNoRoute && static_cast<size_t>(route_id) < snapshot.entries.size()) {
+        entry = &snapshot.entries[static_cast<size_t>(route_id)];
+        span.route(route_id, &entry->path);
+    }
+    
+    // 限流在分发前判定：全局（按路由模式或原始路径）、再路由级
+    const char* route_key = entry ? entry->path.c_str() : path;
+    if (svr_instance->rate_limit_ && !Server::admitRequest(*svr_instance->rate_limit_, req, resp, route_key)) {
+        return 0;
+    }
+    if (entry && entry->rate_limit && !Server::admitRequest(*entry->rate_limit, req, resp, route_key)) {
+        return 0;
+    }
+    
+    // 请求体上限在复制请求体之前判定（声明的 Content-Length 或已读取的长度）
+    if (entry && entry->max_body_size > 0) {
+        uint64_t declared = 0;
+        StringSlice content_length = findRequestHeader(req, "Content-Length");
+        if (content_length.valid() && !parseStaticNumber(content_length, declared)) {
+            declared = 0;
+        }
+        uint64_t body_size = uvhttp_request_get_body_length(req);
+        if (declared > entry->max_body_size || body_size > entry->max_body_size) {
+            uvhttp_response_set_status(resp, 413);
+            uvhttp_response_set_header(resp, "Content-Type", "application/json");
+            uvhttp_response_set_header(resp, "Connection", "close");
+            const char* too_large = R"({"error": "Payload Too Large", "message": "Request body exceeds the route limit"})";
+            uvhttp_response_set_body(resp, too_large, std::strlen(too_large));
+            trace::noteResponse(413, std::strlen(too_large));
+            uvhttp_response_send(resp);
+            return 0;
+        }
+    }
+    
+    // 异步路由不占用并发配额（处理器返回后不再占用事件循环），也不经过响应缓存
+    if (entry && entry->isAsync()) {
+        connection_scope.release();
+        svr_instance->dispatchAsync(*entry, req, resp, method, path, route_params, route_param_count);
+        return 0;
+    }
+    
+    if (entry && (entry->view_handler || entry->handler)) {
+        // 准入控制只包住分发本身：未获准入的请求已排队或以 503 应答
+        bool admitted = svr_instance->admission_ != nullptr;
+        if (admitted && !svr_instance->beginAdmitted(routes, route_id, req, resp, method, path,
+                                                     route_params, route_param_count)) {
+            connection_scope.release();
+            return 0;
+        }
+        svr_instance->dispatchMeasured(*entry, req, resp, method, path, route_params, route_param_count);
+        if (admitted) {
+            svr_instance->finishAdmitted();
+        }
+        return 0;
+    }
+    
+    // 未匹配路由：GET / HEAD 按前缀查找静态目录
+    if (!entry && !svr_instance->static_mounts_.empty() &&
+        (method == HttpMethod::GET || method == HttpMethod::HEAD)) {
+        size_t path_size = std::strlen(path);
+        for (size_t i = 0; i < svr_instance->static_mounts_.size(); i++) {
+            const Server::StaticMount& mount = svr_instance->static_mounts_[i];
+            const std::string& prefix = mount.prefix;
+            if (path_size >= prefix.size() && std::memcmp(path, prefix.data(), prefix.size()) == 0 &&
+                (path_size == prefix.size() || path[prefix.size()] == '/') &&
+                svr_instance->serveStaticFile(mount, req, resp, method, path, path_size)) {
+                return 0;
+            }
+        }
+    }
+    
+    // 404 Not Found
+    uvhttp_response_set_status(resp, 404);
+    uvhttp_response_set_header(resp, "Content-Type", "application/json");
+    const char* not_found = R"({"error": "Not Found", "message": "The requested resource was not found"})";
+    uvhttp_response_set_body(resp, not_found, strlen(not_found));
+    trace::noteResponse(404, strlen(not_found));
+    uvhttp_response_send(resp);
+    
+    return 0;
+}
+
+// 本循环的准入队列和轮询定时器（其他工作线程释放配额时本循环无法立即得知，靠定时器重试）
+struct server::Server::AdmissionState {
+    uv_timer_t timer;
+    Server* server;
+    rate::AdmissionQueue<PendingRequest> queue;
+    uint64_t tick_ms;
+    bool timer_active;
+    bool draining;
+    
+    explicit AdmissionState(size_t capacity)
+        : server(nullptr), queue(capacity), tick_ms(1), timer_active(false), draining(false) {}
+};
+
+server::Server::Server(uv_loop_t* loop, const ServerOptions& options)
+    : loop_(loop), use_https_(false), reuse_port_(false), route_revision_(0),
+      routes_(std::make_shared<RouteCell>(std::make_shared<RouteSnapshot>())),
+      route_reader_(routes_->attach()), routes_owner_(true), routes_live_(false), route_batch_(0),
+      rate_sweeper_(nullptr), admission_state_(nullptr),
+      request_arena_(false), arena_json_(false), connection_sweeper_(nullptr), health_scheduler_(nullptr),
+      tls_timer_(nullptr), request_peer_(0) {
+    
+    if (!loop_) {
+        std::cerr << "Error: Event loop cannot be null" << std::endl;
+        return;
+    }
+    
+    // 创建 uvhttp 上下文（两步法：创建 + 初始化）
+    uvhttp_context_t* ctx_ptr = nullptr;
+    uvhttp_error_t result = uvhttp_context_create(loop_, &ctx_ptr);
+    if (result != UVHTTP_OK || !ctx_ptr) {
+        std::cerr << "Error: Failed to create uvhttp context" << std::endl;
+        return;
+    }
+    
+    result = uvhttp_context_init(ctx_ptr);
+    if (result != UVHTTP_OK) {
+        uvhttp_context_destroy(ctx_ptr);
+        std::cerr << "Error: Failed to initialize uvhttp context" << std::endl;
+        return;
+    }
+    uvhttp_ctx_ = makeUvhttpContext(ctx_ptr);
+    
+    // 创建配置
+    uvhttp_config_t* config_ptr = nullptr;
+    result = uvhttp_config_new(&config_ptr);
+    if (result != UVHTTP_OK || !config_ptr) {
+        std::cerr << "Error: Failed to create uvhttp config" << std::endl;
+        return;
+    }
+    config_ = makeUvhttpConfig(config_ptr);
+    
+    // 创建路由器
+    uvhttp_router_t* router_ptr = nullptr;
+    result = uvhttp_router_new(&router_ptr);
+    if (result != UVHTTP_OK || !router_ptr) {
+        std::cerr << "Error: Failed to create uvhttp router" << std::endl;
+        return;
+    }
+    router_ = makeUvhttpRouter(router_ptr);
+    
+    // 创建服务器
+    uvhttp_server_t* server_ptr = nullptr;
+    result = uvhttp_server_new(loop_, &server_ptr);
+    if (result != UVHTTP_OK || !server_ptr) {
+        std::cerr << "Error: Failed to create uvhttp server" << std::endl;
+        return;
+    }
+    server_ = makeUvhttpServer(server_ptr);
+    
+    // 设置路由器到服务器
+    server_->router = router_.get();
+    server_->config = config_.get();
+    server_->user_data = this;
+    
+    setOptions(options);
+}
+
+// 移动构造函数
+server::Server::Server(Server&& other) noexcept
+    : loop_(other.loop_),
+      tls_session_(std::move(other.tls_session_)),
+      server_(std::move(other.server_)),
+      router_(std::move(other.router_)),
+      uvhttp_ctx_(std::move(other.uvhttp_ctx_)),
+      config_(std::move(other.config_)),
+      tls_config_(std::move(other.tls_config_)),
+      use_https_(other.use_https_),
+      reuse_port_(other.reuse_port_),
+      route_table_(std::move(other.route_table_)),
+      handlers_(std::move(other.handlers_)),
+      route_revision_(other.route_revision_),
+      routes_(std::move(other.routes_)),
+      route_reader_(other.route_reader_),
+      routes_owner_(other.routes_owner_),
+      routes_live_(other.routes_live_),
+      route_batch_(0),
+      route_metrics_(std::move(other.route_metrics_)),
+      rate_limit_(std::move(other.rate_limit_)),
+      rate_sweeper_(other.rate_sweeper_),
+      admission_(std::move(other.admission_)),
+      admission_state_(other.admission_state_),
+      request_arena_(other.request_arena_),
+      arena_json_(other.arena_json_),
+      middleware_(std::move(other.middleware_)),
+      compression_(std::move(other.compression_)),
+      cors_(std::move(other.cors_)),
+      tracer_(std::move(other.tracer_)),
+      async_loop_(std::move(other.async_loop_)),
+      offload_pool_(std::move(other.offload_pool_)),
+      static_mounts_(std::move(other.static_mounts_)),
+      static_watchers_(std::move(other.static_watchers_)),
+      options_(other.options_),
+      connections_(std::move(other.connections_)),
+      connection_sweeper_(other.connection_sweeper_),
+      health_(std::move(other.health_)),
+      health_scheduler_(other.health_scheduler_),
+      tls_keys_(std::move(other.tls_keys_)),
+      tls_stats_(std::move(other.tls_stats_)),
+      tls_timer_(other.tls_timer_),
+      request_peer_(0) {
+    other.route_reader_ = nullptr;
+    other.rate_sweeper_ = nullptr;
+    other.connection_sweeper_ = nullptr;
+    other.health_scheduler_ = nullptr;
+    other.tls_timer_ = nullptr;
+    other.static_watchers_.clear();
+    other.admission_state_ = nullptr;
+    if (admission_state_) {
+        admission_state_->server = this;
+    }
+    if (server_) server_->user_data = this;
+}
+
+// 移动赋值运算符
+server::Server& server::Server::operator=(Server&& other) noexcept {
+    if (this != &other) {
+        loop_ = other.loop_;
+        server_ = std::move(other.server_);
+        tls_session_ = std::move(other.tls_session_);  // 旧的 TLS 上下文已随 server_ 释放
+        router_ = std::move(other.router_);
+        uvhttp_ctx_ = std::move(other.uvhttp_ctx_);
+        config_ = std::move(other.config_);
+        tls_config_ = std::move(other.tls_config_);
+        use_https_ = other.use_https_;
+        reuse_port_ = other.reuse_port_;
+        route_table_ = std::move(other.route_table_);
+        handlers_ = std::move(other.handlers_);
+        route_revision_ = other.route_revision_;
+        if (routes_) {
+            routes_->detach(route_reader_);
+        }
+        routes_ = std::move(other.routes_);
+        route_reader_ = other.route_reader_;
+        other.route_reader_ = nullptr;
+        routes_owner_ = other.routes_owner_;
+        routes_live_ = other.routes_live_;
+        route_batch_ = 0;
+        route_metrics_ = std::move(other.route_metrics_);
+        stopRateLimitSweep();
+        rate_limit_ = std::move(other.rate_limit_);
+        rate_sweeper_ = other.rate_sweeper_;
+        other.rate_sweeper_ = nullptr;
+        stopAdmission();
+        admission_ = std::move(other.admission_);
+        admission_state_ = other.admission_state_;
+        other.admission_state_ = nullptr;
+        request_arena_ = other.request_arena_;
+        arena_json_ = other.arena_json_;
+        middleware_ = std::move(other.middleware_);
+        compression_ = std::move(other.compression_);
+        cors_ = std::move(other.cors_);
+        tracer_ = std::move(other.tracer_);
+        stopAsync();
+        async_loop_ = std::move(other.async_loop_);
+        offload_pool_ = std::move(other.offload_pool_);
+        static_mounts_ = std::move(other.static_mounts_);
+        stopStaticWatchers();
+        static_watchers_ = std::move(other.static_watchers_);
+        other.static_watchers_.clear();
+        options_ = other.options_;
+        connections_ = std::move(other.connections_);
+        stopConnectionSweep();
+        connection_sweeper_ = other.connection_sweeper_;
+        other.connection_sweeper_ = nullptr;
+        stopHealthChecks();
+        health_ = std::move(other.health_);
+        health_scheduler_ = other.health_scheduler_;
+        other.health_scheduler_ = nullptr;
+        stopTlsRotation();
+        tls_keys_ = std::move(other.tls_keys_);
+        tls_stats_ = std::move(other.tls_stats_);
+        tls_timer_ = other.tls_timer_;
+        other.tls_timer_ = nullptr;
+        if (admission_state_) {
+            admission_state_->server = this;
+        }
+    }
+    if (server_) server_->user_data = this;
+    return *this;
+}
+
+// 析构函数 - RAII 自动清理，不需要手动释放
+server::Server::~Server() {
+    // 所有资源由 RAII 包装类自动管理；回收定时器和准入队列由关闭回调释放
+    stopRateLimitSweep();
+    stopAdmission();
+    stopStaticWatchers();
+    stopAsync();
+    stopConnectionSweep();
+    stopHealthChecks();
+    stopTlsRotation();
+    if (routes_) {
+        routes_->detach(route_reader_);
+    }
+}
+
+bool server::Server::listen(const std::string& host, int port) {
+    if (!server_ || !loop_) {
+        return false;
+    }
+    
+    // 设置处理器
+    uvhttp_server_set_handler(server_.get(), on_uvhttp_request);
+    
+    if (reuse_port_ && !openReusePortSocket(host)) {
+        return false;
+    }
+    
+    // 监听之前发布已注册的路由；之后的修改立即发布
+    if (routes_owner_) {
+        syncRoutes();
+    }
+    
+    // 启动服务器
+    uvhttp_error_t result = uvhttp_server_listen(server_.get(), host.c_str(), port);
+    if (result != UVHTTP_OK) {
+        fprintf(stderr, "Failed to start server on %s:%d\n", host.c_str(), port);
+        return false;
+    }
+    routes_live_ = true;
+    
+    startRateLimitSweep();
+    startConnectionSweep();
+    startHealthChecks();
+    startTlsRotation();
+    return true;
+}
+
+bool server::Server::listenHttps(const std::string& host, int port) {
+    if (!tls_config_.enabled) {
+        fprintf(stderr, "Error: TLS not enabled. Call enableTls() first\n");
+        return false;
+    }
+    
+    return listen(host, port);
+}
+
+bool server::Server::openReusePortSocket(const std::string& host) {
+#ifdef SO_REUSEPORT
+    // 在 uvhttp 绑定前把未绑定的套接字交给其 TCP 句柄，
+    // uv_tcp_bind() 复用已有 fd，因此监听套接字会带上 SO_REUSEPORT
+    struct in6_addr probe;
+    int family = inet_pton(AF_INET6, host.c_str(), &probe) == 1 ? AF_INET6 : AF_INET;
+    int fd = socket(family, SOCK_STREAM, 0);
+    if (fd < 0) {
+        fprintf(stderr, "Failed to create socket: %s\n", strerror(errno));
+        return false;
+    }
+    int on = 1;
+    if (setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on)) != 0) {
+        fprintf(stderr, "Failed to set SO_REUSEPORT: %s\n", strerror(errno));
+        close(fd);
+        return false;
+    }
+    int result = uv_tcp_open(&server_->tcp_handle, fd);
+    if (result != 0) {
+        fprintf(stderr, "Failed to open reuseport socket: %s\n", uv_strerror(result));
+        close(fd);
+        return false;
+    }
+    return true;
+#else
+    (void)host;
+    fprintf(stderr, "SO_REUSEPORT is not supported on this platform\n");
+    return false;
+#endif
+}
+
+void server::Server::stop() {
+    stopRateLimitSweep();
+    stopAdmission();
+    stopStaticWatchers();
+    stopAsync();
+    stopConnectionSweep();
+    stopHealthChecks();
+    stopTlsRotation();
+    if (server_) {
+        uvhttp_server_stop(server_.get());
+    }
+}
+
+// 空闲键回收定时器：持有限流器副本，不依赖 Server 的生命周期
+struct server::Server::RateLimitSweeper {
+    uv_timer_t timer;
+    std::vector<std::shared_ptr<rate::KeyedRateLimiter> > limiters;
+};
+
+void server::Server::onSweepTimer(uv_timer_t* timer) {
+    RateLimitSweeper* sweeper = static_cast<RateLimitSweeper*>(timer->data);
+    for (size_t i = 0; i < sweeper->limiters.size(); i++) {
+        sweeper->limiters[i]->sweep();
+    }
+}
+
+void server::Server::onSweepClosed(uv_handle_t* handle) {
+    delete static_cast<RateLimitSweeper*>(handle->data);
+}
+
+void server::Server::startRateLimitSweep() {
+    if (rate_sweeper_ || !loop_) {
+        return;
+    }
+    std::unique_ptr<RateLimitSweeper> sweeper(new RateLimitSweeper());
+    if (rate_limit_) {
+        sweeper->limiters.push_back(rate_limit_);
+    }
+    // 按已发布的路由表收集（工作线程的草稿为空）
+    std::shared_ptr<const RouteSnapshot> routes = routes_->load();
+    for (size_t i = 0; i < routes->entries.size(); i++) {
+        if (routes->entries[i].rate_limit) {
+            sweeper->limiters.push_back(routes->entries[i].rate_limit);
+        }
+    }
+    if (sweeper->limiters.empty()) {
+        return;
+    }
+    
+    // 按最短的空闲超时的一半回收，至少间隔 1 秒
+    uint64_t interval_ms = UINT64_MAX;
+    for (size_t i = 0; i < sweeper->limiters.size(); i++) {
+        uint64_t idle = static_cast<uint64_t>(sweeper->limiters[i]->policy().idle_timeout.count()) / 2;
+        interval_ms = idle < interval_ms ? idle : interval_ms;
+    }
+    if (interval_ms < 1000) {
+        interval_ms = 1000;
+    }
+    
+    uv_timer_init(loop_, &sweeper->timer);
+    sweeper->timer.data = sweeper.get();
+    uv_timer_start(&sweeper->timer, onSweepTimer, interval_ms, interval_ms);
+    // 回收定时器不应让事件循环保持运行
+    uv_unref(reinterpret_cast<uv_handle_t*>(&sweeper->timer));
+    rate_sweeper_ = sweeper.release();
+}
+
+void server::Server::stopRateLimitSweep() {
+    if (!rate_sweeper_) {
+        return;
+    }
+    uv_handle_t* handle = reinterpret_cast<uv_handle_t*>(&rate_sweeper_->timer);
+    rate_sweeper_ = nullptr;
+    if (!uv_is_closing(handle)) {
+        uv_close(handle, onSweepClosed);
+    }
+}
+
+// ========== 连接选项 ==========
+
+namespace {
+
+// uvhttp 各版本的配置字段不同：按成员探测，存在时写入并返回 true
+#define UVAPI_UVHTTP_CONFIG_FIELD(field) \
+    template<typename Config, typename Value> \
+    auto setConfig_##field(Config* config, Value value, int) -> decltype(config->field = value, bool()) { \
+        config->field = static_cast<typename std::remove_reference<decltype(config->field)>::type>(value); \
+        return true; \
+    } \
+    template<typename Config, typename Value> \
+    bool setConfig_##field(Config*, Value, long) { \
+        return false; \
+    }
+
+UVAPI_UVHTTP_CONFIG_FIELD(read_buffer_size)
+UVAPI_UVHTTP_CONFIG_FIELD(max_header_size)
+UVAPI_UVHTTP_CONFIG_FIELD(max_connections)
+UVAPI_UVHTTP_CONFIG_FIELD(backlog)
+
+#undef UVAPI_UVHTTP_CONFIG_FIELD
+
+void warnUnsupportedOption(const char* name) {
+    std::cerr << "Warning: uvhttp config has no " << name << " field; option ignored" << std::endl;
+}
+
+} // namespace
+
+void server::Server::setOptions(const ServerOptions& options) {
+    options_ = options;
+    uvhttp_config_t* config = config_.get();
+    if (config) {
+        if (options.read_buffer_size > 0 && !setConfig_read_buffer_size(config, options.read_buffer_size, 0)) {
+            warnUnsupportedOption("read_buffer_size");
+        }
+        if (options.max_header_size > 0 && !setConfig_max_header_size(config, options.max_header_size, 0)) {
+            warnUnsupportedOption("max_header_size");
+        }
+        if (options.max_connections > 0 && !setConfig_max_connections(config, options.max_connections, 0)) {
+            warnUnsupportedOption("max_connections");
+        }
+        if (options.listen_backlog > 0 && !setConfig_backlog(config, options.listen_backlog, 0)) {
+            warnUnsupportedOption("backlog");
+        }
+    }
+    if (!options.tracksConnections()) {
+        connections_.reset();
+    } else if (!connections_) {
+        connections_ = std::make_shared<ConnectionTracker>();
+    }
+}
+
+server::ConnectionStats server::Server::connectionStats() const {
+    return connections_ ? connections_->stats() : ConnectionStats();
+}
+
+uint64_t server::Server::beginConnection(uvhttp_request_t* req, uvhttp_response_t* resp) {
+    uint64_t peer = peerDigest(req->client);
+    bool fresh = false;
+    ConnectionTracker::Connection& connection = connections_->begin(req->client, peer, monotonicMillis(), fresh);
+    if (fresh) {
+        if (tls_stats_ && use_https_) {
+            tls_stats_->handshake();
+        }
+        if (options_.tcp_nodelay) {
+            uv_tcp_nodelay(req->client, 1);
+        }
+        if (options_.tcp_keepalive_seconds > 0) {
+            uv_tcp_keepalive(req->client, 1, options_.tcp_keepalive_seconds);
+        }
+    }
+    // 达到上限：通知客户端不再复用，本次响应写出后半关闭
+    if (options_.max_requests_per_connection > 0 && connection.requests >= options_.max_requests_per_connection) {
+        connection.draining = true;
+        uvhttp_response_set_header(resp, "Connection", "close");
+    }
+    request_peer_ = peer;
+    return peer;
+}
+
+void server::Server::endConnection(uv_tcp_t* client, uint64_t peer) {
+    if (connections_ && client) {
+        endTrackedRequest(*connections_, client, peer);
+    }
+}
+
+// 连接清理定时器：持有连接表副本，不依赖 Server 的生命周期
+struct server::Server::ConnectionSweeper {
+    uv_timer_t timer;
+    std::shared_ptr<ConnectionTracker> connections;
+    uint64_t idle_ms;  // 0 表示不限制空闲时间
+};
+
+namespace {
+
+void collectTcpHandle(uv_handle_t* handle, void* arg) {
+    if (handle->type == UV_TCP) {
+        static_cast<std::unordered_set<const void*>*>(arg)->insert(handle);
+    }
+}
+
+} // namespace
+
+void server::Server::onConnectionSweep(uv_timer_t* timer) {
+    ConnectionSweeper* sweeper = static_cast<ConnectionSweeper*>(timer->data);
+    // 仍在循环句柄队列中的句柄没有被释放；其余条目是已关闭的连接
+    std::unordered_set<const void*> live;
+    live.reserve(sweeper->connections->size() + 1);
+    uv_walk(timer->loop, collectTcpHandle, &live);
+    sweeper->connections->prune([&live](const void* handle) { return live.count(handle) > 0; });
+    if (sweeper->idle_ms > 0) {
+        sweeper->connections->forEachIdle(monotonicMillis(), sweeper->idle_ms, [](const void* handle) {
+            return shutdownConnection(static_cast<uv_tcp_t*>(const_cast<void*>(handle)));
+        });
+    }
+}
+
+void server::Server::onConnectionSweepClosed(uv_handle_t* handle) {
+    delete static_cast<ConnectionSweeper*>(handle->data);
+}
+
+void server::Server::startConnectionSweep() {
+    if (connection_sweeper_ || !connections_ || !loop_) {
+        return;
+    }
+    ConnectionSweeper* sweeper = new ConnectionSweeper();
+    sweeper->connections = connections_;
+    sweeper->idle_ms = static_cast<uint64_t>(options_.keepalive_timeout.count());
+    // keep-alive 超时的一半，介于 100ms 和 1s 之间
+    uint64_t interval_ms = sweeper->idle_ms > 0 ? sweeper->idle_ms / 2 : 1000;
+    interval_ms = interval_ms < 100 ? 100 : (interval_ms > 1000 ? 1000 : interval_ms);
+    uv_timer_init(loop_, &sweeper->timer);
+    sweeper->timer.data = sweeper;
+    uv_timer_start(&sweeper->timer, onConnectionSweep, interval_ms, interval_ms);
+    uv_unref(reinterpret_cast<uv_handle_t*>(&sweeper->timer));
+    connection_sweeper_ = sweeper;
+}
+
+void server::Server::stopConnectionSweep() {
+    if (!connection_sweeper_) {
+        return;
+    }
+    uv_handle_t* handle = reinterpret_cast<uv_handle_t*>(&connection_sweeper_->timer);
+    connection_sweeper_ = nullptr;
+    if (!uv_is_closing(handle)) {
+        uv_close(handle, onConnectionSweepClosed);
+    }
+}
+
+// ========== 健康检查 ==========
+
+// 健康检查调度定时器：持有管理器和线程池副本，不依赖 Server 的生命周期
+struct server::Server::HealthScheduler {
+    uv_timer_t timer;
+    std::shared_ptr<health::HealthCheckManager> manager;
+    std::shared_ptr<offload::WorkStealingPool> pool;
+};
+
+void server::Server::onHealthTimer(uv_timer_t* timer) {
+    HealthScheduler* scheduler = static_cast<HealthScheduler*>(timer->data);
+    std::shared_ptr<health::HealthCheckManager> manager = scheduler->manager;
+    offload::WorkStealingPool* pool = scheduler->pool.get();
+    manager->tick(monotonicMillis(), [manager, pool](size_t index) {
+        return pool->submit([manager, index]() { manager->runCheck(index); });
+    });
+}
+
+void server::Server::onHealthTimerClosed(uv_handle_t* handle) {
+    delete static_cast<HealthScheduler*>(handle->data);
+}
+
+void server::Server::enableHealthChecks(const std::shared_ptr<health::HealthCheckManager>& manager,
+                                        const std::string& health_path, const std::string& ready_path) {
+    if (!manager) {
+        return;
+    }
+    if (health_) {
+        std::cerr << "Warning: Health checks already enabled; the new manager replaces the old one" << std::endl;
+    }
+    health_ = manager;
+    if (!offload_pool_) {
+        offload_pool_ = std::make_shared<offload::WorkStealingPool>();
+    }
+    
+    // 请求只复制预渲染的响应体，不执行检查
+    std::shared_ptr<health::HealthCheckManager> source = manager;
+    addRoute(health_path, HttpMethod::GET, [source](const HttpRequest& /*req*/) -> HttpResponse {
+        std::shared_ptr<const health::HealthSnapshot> snapshot = source->latest();
+        HttpResponse response(snapshot->healthCode(), snapshot->health_body);
+        response.header("Content-Type", "application/json").header("Cache-Control", "no-store");
+        return response;
+    });
+    if (!ready_path.empty()) {
+        addRoute(ready_path, HttpMethod::GET, [source](const HttpRequest& /*req*/) -> HttpResponse {
+            std::shared_ptr<const health::HealthSnapshot> snapshot = source->latest();
+            HttpResponse response(snapshot->readyCode(), snapshot->ready_body);
+            response.header("Content-Type", "application/json").header("Cache-Control", "no-store");
+            return response;
+        });
+    }
+}
+
+void server::Server::startHealthChecks() {
+    if (health_scheduler_ || !health_ || !offload_pool_ || !loop_) {
+        return;
+    }
+    HealthScheduler* scheduler = new HealthScheduler();
+    scheduler->manager = health_;
+    scheduler->pool = offload_pool_;
+    uint64_t interval_ms = static_cast<uint64_t>(health_->tickInterval().count());
+    uv_timer_init(loop_, &scheduler->timer);
+    scheduler->timer.data = scheduler;
+    // 立即提交第一轮检查，尽快结束未就绪状态
+    uv_timer_start(&scheduler->timer, onHealthTimer, 0, interval_ms);
+    uv_unref(reinterpret_cast<uv_handle_t*>(&scheduler->timer));
+    health_scheduler_ = scheduler;
+}
+
+void server::Server::stopHealthChecks() {
+    if (!health_scheduler_) {
+        return;
+    }
+    uv_handle_t* handle = reinterpret_cast<uv_handle_t*>(&health_scheduler_->timer);
+    health_scheduler_ = nullptr;
+    if (!uv_is_closing(handle)) {
+        uv_close(handle, onHealthTimerClosed);
+    }
+}
+
+// ========== 静态文件 ==========
+
+// 目录监视器：持有缓存副本，不依赖 Server 的生命周期
+struct server::Server::StaticWatcher {
+    uv_fs_event_t handle;
+    std::string dir;
+    std::vector<std::shared_ptr<StaticFileCache> > caches;
+};
+
+bool server::Server::serveStatic(const std::string& prefix, const std::string& root, const StaticOptions& options) {
+    std::shared_ptr<StaticFileCache> cache = std::make_shared<StaticFileCache>(root, options);
+    if (!cache->valid()) {
+        std::cerr << "Error: Static root does not exist: " << root << std::endl;
+        return false;
+    }
+    StaticMount mount;
+    mount.prefix = normalizeMountPrefix(prefix);
+    mount.cache = cache;
+    // 更长的前缀优先匹配；同一前缀重复注册时替换
+    std::vector<StaticMount>::iterator pos = static_mounts_.begin();
+    while (pos != static_mounts_.end() && pos->prefix.size() > mount.prefix.size()) {
+        ++pos;
+    }
+    if (pos != static_mounts_.end() && pos->prefix == mount.prefix) {
+        *pos = mount;
+    } else {
+        static_mounts_.insert(pos, mount);
+    }
+    return true;
+}
+
+bool server::Server::prewarmStatic(const std::string& prefix, const std::string& relative) {
+    std::string normalized_prefix = normalizeMountPrefix(prefix);
+    for (size_t i = 0; i < static_mounts_.size(); i++) {
+        if (static_mounts_[i].prefix != normalized_prefix) {
+            continue;
+        }
+        std::string normalized;
+        const StaticOptions& options = static_mounts_[i].cache->options();
+        if (!normalizeStaticPath(relative.data(), relative.size(), options.dotfiles, normalized)) {
+            return false;
+        }
+        return static_mounts_[i].cache->prewarm(normalized, loop_ ? uv_now(loop_) : 0);
+    }
+    return false;
+}
+
+bool server::Server::serveStaticFile(const StaticMount& mount, uvhttp_request_t* req, uvhttp_response_t* resp,
+                                     HttpMethod method, const char* path, size_t path_size) {
+    StaticFileCache& cache = *mount.cache;
+    const StaticOptions& options = cache.options();
+    std::string relative;
+    const char* rest = path + mount.prefix.size();
+    if (!normalizeStaticPath(rest, path_size - mount.prefix.size(), options.dotfiles, relative)) {
+        return false;
+    }
+    
+    uint64_t now_ms = uv_now(loop_);
+    bool inserted = false;
+    std::shared_ptr<const StaticFile> file = cache.lookup(relative, now_ms, &inserted);
+    if (!file && !options.fallback_file.empty()) {
+        // 单页应用：只有最后一段不含扩展名的路径回退，缺失的资源文件仍返回 404
+        size_t slash = relative.rfind('/');
+        size_t dot = relative.rfind('.');
+        if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+            file = cache.lookup(options.fallback_file, now_ms, &inserted);
+        }
+    }
+    if (!file) {
+        return false;
+    }
+    if (inserted) {
+        watchStaticDirectory(mount.cache, file->path.substr(0, file->path.rfind('/')));
+    }
+    
+    // 按 Accept-Encoding 选择预压缩的兄弟文件
+    const StaticFile* chosen = file.get();
+    const char* encoding = nullptr;
+    if (file->br || file->gzip) {
+        unsigned accepted = acceptedEncodings(findRequestHeader(req, "Accept-Encoding"));
+        if (file->br && (accepted & ENCODING_BR)) {
+            chosen = file->br.get();
+            encoding = "br";
+        } else if (file->gzip && (accepted & ENCODING_GZIP)) {
+            chosen = file->gzip.get();
+            encoding = "gzip";
+        }
+    }
+    
+    metrics::PhaseTimer timer(metrics::Phase::SERIALIZATION);
+    // If-None-Match 优先于 If-Modified-Since
+    StringSlice if_none_match = findRequestHeader(req, "If-None-Match");
+    bool not_modified = false;
+    if (if_none_match.valid()) {
+        not_modified = etagListMatches(if_none_match, chosen->etag);
+    } else {
+        int64_t since = 0;
+        if (parseHttpDate(findRequestHeader(req, "If-Modified-Since"), since)) {
+            not_modified = file->mtimeSeconds() <= since;
+        }
+    }
+    if (not_modified) {
+        uvhttp_response_set_status(resp, 304);
+        setStaticValidators(resp, *chosen, *file, options);
+        trace::noteResponse(304, 0);
+        uvhttp_response_send(resp);
+        return true;
+    }
+    
+    // If-Range 与当前表示不一致时忽略 Range，返回完整内容
+    ByteRange range;
+    RangeResult range_result = RangeResult::NONE;
+    StringSlice range_header = findRequestHeader(req, "Range");
+    if (range_header.valid() && method == HttpMethod::GET) {
+        StringSlice if_range = findRequestHeader(req, "If-Range");
+        int64_t if_range_date = 0;
+        bool current = !if_range.valid() || if_range.equals(chosen->etag.data(), chosen->etag.size()) ||
+                       (parseHttpDate(if_range, if_range_date) && if_range_date == file->mtimeSeconds());
+        if (current) {
+            range_result = parseByteRange(range_header, chosen->size, range);
+        }
+    }
+    
+    char content_range[64];
+    if (range_result == RangeResult::UNSATISFIABLE) {
+        std::snprintf(content_range, sizeof(content_range), "bytes */%llu",
+                      static_cast<unsigned long long>(chosen->size));
+        uvhttp_response_set_status(resp, 416);
+        uvhttp_response_set_header(resp, "Content-Range", content_range);
+        trace::noteResponse(416, 0);
+        uvhttp_response_send(resp);
+        return true;
+    }
+    
+    // 映射在发送完成前保持有效；文件已被替换时丢弃缓存条目，按未找到处理
+    std::shared_ptr<const MappedFile> mapping;
+    if (method != HttpMethod::HEAD) {
+        mapping = cache.content(*chosen);
+        if (!mapping) {
+            cache.invalidate(chosen->path);
+            return false;
+        }
+    }
+    
+    if (range_result == RangeResult::PARTIAL) {
+        std::snprintf(content_range, sizeof(content_range), "bytes %llu-%llu/%llu",
+                      static_cast<unsigned long long>(range.first), static_cast<unsigned long long>(range.last),
+                      static_cast<unsigned long long>(chosen->size));
+        uvhttp_response_set_status(resp, 206);
+        uvhttp_response_set_header(resp, "Content-Range", content_range);
+    } else {
+        range.first = 0;
+        range.last = chosen->size > 0 ? chosen->size - 1 : 0;
+        uvhttp_response_set_status(resp, 200);
+    }
+    uvhttp_response_set_header(resp, "Content-Type", file->content_type);
+    if (encoding) {
+        uvhttp_response_set_header(resp, "Content-Encoding", encoding);
+    }
+    uvhttp_response_set_header(resp, "Accept-Ranges", "bytes");
+    setStaticValidators(resp, *chosen, *file, options);
+    uint64_t body_bytes = 0;
+    if (mapping && chosen->size > 0) {
+        body_bytes = range.length();
+        uvhttp_response_set_body(resp, mapping->data() + range.first, static_cast<size_t>(body_bytes));
+    }
+    trace::noteResponse(range_result == RangeResult::PARTIAL ? 206 : 200, body_bytes);
+    uvhttp_response_send(resp);
+    return true;
+}
+
+void server::Server::watchStaticDirectory(const std::shared_ptr<StaticFileCache>& cache, const std::string& dir) {
+    std::map<std::string, StaticWatcher*>::iterator it = static_watchers_.find(dir);
+    if (it != static_watchers_.end()) {
+        std::vector<std::shared_ptr<StaticFileCache> >& caches = it->second->caches;
+        if (std::find(caches.begin(), caches.end(), cache) == caches.end()) {
+            caches.push_back(cache);
+        }
+        return;
+    }
+    
+    std::unique_ptr<StaticWatcher> watcher(new StaticWatcher());
+    watcher->dir = dir;
+    watcher->caches.push_back(cache);
+    if (uv_fs_event_init(loop_, &watcher->handle) != 0) {
+        return;
+    }
+    watcher->handle.data = watcher.get();
+    if (uv_fs_event_start(&watcher->handle, onStaticFsEvent, dir.c_str(), 0) != 0) {
+        // 监视器不可用（例如 inotify 配额耗尽）：依靠 revalidate_interval 兜底
+        uv_close(reinterpret_cast<uv_handle_t*>(&watcher.release()->handle), onStaticWatcherClosed);
+        return;
+    }
+    // 监视器不应让事件循环保持运行
+    uv_unref(reinterpret_cast<uv_handle_t*>(&watcher->handle));
+    static_watchers_[dir] = watcher.release();
+}
+
+void server::Server::onStaticFsEvent(uv_fs_event_t* handle, const char* filename, int events, int status) {
+    (void)events;
+    StaticWatcher* watcher = static_cast<StaticWatcher*>(handle->data);
+    for (size_t i = 0; i < watcher->caches.size(); i++) {
+        if (status == 0 && filename && *filename) {
+            watcher->caches[i]->invalidate(watcher->dir + "/" + filename);
+        } else {
+            watcher->caches[i]->invalidateDirectory(watcher->dir);
+        }
+    }
+}
+
+void server::Server::onStaticWatcherClosed(uv_handle_t* handle) {
+    delete static_cast<StaticWatcher*>(handle->data);
+}
+
+void server::Server::stopStaticWatchers() {
+    for (std::map<std::string, StaticWatcher*>::iterator it = static_watchers_.begin(); it != static_watchers_.end(); ++it) {
+        uv_handle_t* handle = reinterpret_cast<uv_handle_t*>(&it->second->handle);
+        if (!uv_is_closing(handle)) {
+            uv_close(handle, onStaticWatcherClosed);
+        }
+    }
+    static_watchers_.clear();
+}
+
+// ========== TLS ==========
+
+namespace {
+
+// mbedtls 的随机数回调
+int tlsRandom(void* /*context*/, unsigned char* out, size_t size) {
+    return secureRandom(out, size) ? 0 : -1;
+}
+
+// uvhttp 的 TLS 上下文在部分版本中是不透明类型：按成员探测 mbedtls 配置，不可用时返回 nullptr
+template<typename Context>
+auto sslConfigOf(Context* ctx, int) -> decltype(static_cast<mbedtls_ssl_config*>(&ctx->conf)) {
+    return &ctx->conf;
+}
+
+template<typename Context>
+mbedtls_ssl_config* sslConfigOf(Context*, long) {
+    return nullptr;
+}
+
+// 拿不到 mbedtls 配置时退回 uvhttp 自带的开关（按函数探测，不存在时返回 false）
+template<typename Context>
+auto enableUvhttpTickets(Context* ctx, int) -> decltype(uvhttp_tls_context_enable_session_tickets(ctx, 1), bool()) {
+    return uvhttp_tls_context_enable_session_tickets(ctx, 1) == UVHTTP_OK;
+}
+
+template<typename Context>
+bool enableUvhttpTickets(Context*, long) {
+    return false;
+}
+
+template<typename Context>
+auto setUvhttpSessionCache(Context* ctx, int entries, int)
+    -> decltype(uvhttp_tls_context_set_session_cache(ctx, entries), bool()) {
+    return uvhttp_tls_context_set_session_cache(ctx, entries) == UVHTTP_OK;
+}
+
+template<typename Context>
+bool setUvhttpSessionCache(Context*, int, long) {
+    return false;
+}
+
+void warnUnsupportedTlsOption(const char* name) {
+    std::cerr << "Warning: uvhttp does not expose its mbedtls configuration; TLS option " << name
+              << " ignored" << std::endl;
+}
+
+// 会话回调的上下文：转发给 mbedtls 的票据 / 缓存实现，并记录恢复次数
+struct TlsSessionHooks {
+#if defined(MBEDTLS_SSL_SESSION_TICKETS)
+    mbedtls_ssl_ticket_context* ticket;
+#endif
+#if defined(MBEDTLS_SSL_CACHE_C)
+    mbedtls_ssl_cache_context* cache;
+#endif
+    tls::SessionStats* stats;
+};
+
+// 回调的参数表随 mbedtls 版本变化，由函数指针类型推导，只固定第一个参数
+#if defined(MBEDTLS_SSL_SESSION_TICKETS)
+template<typename... Args>
+int writeSessionTicket(void* data, Args... args) {
+    return mbedtls_ssl_ticket_write(static_cast<TlsSessionHooks*>(data)->ticket, args...);
+}
+
+template<typename... Args>
+int parseSessionTicket(void* data, Args... args) {
+    TlsSessionHooks* hooks = static_cast<TlsSessionHooks*>(data);
+    int result = mbedtls_ssl_ticket_parse(hooks->ticket, args...);
+    if (result == 0) {
+        hooks->stats->resumed();
+    } else {
+        hooks->stats->ticketRejected();  // 过期、密钥已轮换出去或被篡改：退回完整握手
+    }
+    return result;
+}
+#endif
+
+#if defined(MBEDTLS_SSL_CACHE_C)
+template<typename... Args>
+int getCachedSession(void* data, Args... args) {
+    TlsSessionHooks* hooks = static_cast<TlsSessionHooks*>(data);
+    int result = mbedtls_ssl_cache_get(hooks->cache, args...);
+    if (result == 0) {
+        hooks->stats->resumed();
+    }
+    return result;
+}
+
+template<typename... Args>
+int setCachedSession(void* data, Args... args) {
+    return mbedtls_ssl_cache_set(static_cast<TlsSessionHooks*>(data)->cache, args...);
+}
+#endif
+
+} // namespace
+
+// 本 Server 的 mbedtls 会话对象；TLS 上下文持有其中对象的指针，由 Server 析构时最后释放
+struct server::Server::TlsSession {
+    mbedtls_ssl_config* conf;
+#if defined(MBEDTLS_SSL_SESSION_TICKETS)
+    mbedtls_ssl_ticket_context ticket;
+    bool ticket_ready;
+#endif
+#if defined(MBEDTLS_SSL_CACHE_C)
+    mbedtls_ssl_cache_context cache;
+#endif
+    mbedtls_x509_crt fallback_cert;  // ECDSA 证书为主证书时的 RSA 备用证书
+    mbedtls_pk_context fallback_key;
+    tls::AlpnList alpn;
+    TlsSessionHooks hooks;
+    std::shared_ptr<tls::SessionStats> stats;
+    std::shared_ptr<tls::TicketKeyRing> keys;
+    uint64_t applied_generation;  // 已装载到票据上下文的密钥代数
+    
+    explicit TlsSession(mbedtls_ssl_config* config) : conf(config), applied_generation(0) {
+#if defined(MBEDTLS_SSL_SESSION_TICKETS)
+        mbedtls_ssl_ticket_init(&ticket);
+        ticket_ready = false;
+        hooks.ticket = &ticket;
+#endif
+#if defined(MBEDTLS_SSL_CACHE_C)
+        mbedtls_ssl_cache_init(&cache);
+        hooks.cache = &cache;
+#endif
+        mbedtls_x509_crt_init(&fallback_cert);
+        mbedtls_pk_init(&fallback_key);
+        hooks.stats = nullptr;
+    }
+    
+    ~TlsSession() {
+#if defined(MBEDTLS_SSL_SESSION_TICKETS)
+        mbedtls_ssl_ticket_free(&ticket);
+#endif
+#if defined(MBEDTLS_SSL_CACHE_C)
+        mbedtls_ssl_cache_free(&cache);
+#endif
+        mbedtls_x509_crt_free(&fallback_cert);
+        mbedtls_pk_free(&fallback_key);
+    }
+    
+    TlsSession(const TlsSession&) = delete;
+    TlsSession& operator=(const TlsSession&) = delete;
+    
+    // 共享密钥轮换后装载到本循环的票据上下文，返回是否装载了新密钥
+    bool applyTicketKey() {
+#if defined(MBEDTLS_SSL_SESSION_TICKETS) && MBEDTLS_VERSION_NUMBER >= 0x03020000
+        if (!ticket_ready || !keys || keys->generation() == applied_generation) {
+            return false;
+        }
+        tls::TicketKey key;
+        if (!keys->current(key) ||
+            mbedtls_ssl_ticket_rotate(&ticket, key.name, tls::TicketKey::kNameSize, key.secret,
+                                      tls::TicketKey::kSecretSize, keys->keyLifetimeSeconds()) != 0) {
+            return false;
+        }
+        applied_generation = key.generation;
+        return true;
+#else
+        return false;
+#endif
+    }
+};
+
+// 票据密钥轮换定时器：持有会话对象副本，不依赖 Server 的生命周期
+struct server::Server::TlsRotationTimer {
+    uv_timer_t timer;
+    std::shared_ptr<TlsSession> session;
+};
+
+void server::Server::enableTls(const TlsConfig& tls_config) {
+    tls_config_ = tls_config;
+    
+    if (!tls_config_.enabled) {
+        return;
+    }
+    
+    // 创建 TLS 上下文
+    uvhttp_tls_context_t* tls_ctx = nullptr;
+    uvhttp_error_t result = uvhttp_tls_context_new(&tls_ctx);
+    if (result != UVHTTP_OK || !tls_ctx) {
+        std::cerr << "Error: Failed to create TLS context" << std::endl;
+        return;
+    }
+    
+    // ECDSA 证书作为主证书交给 uvhttp（mbedtls 按配置顺序选用第一张客户端支持的证书），
+    // RSA 证书稍后作为备用追加；拿不到 mbedtls 配置时无法追加备用证书，仍只使用 RSA 证书
+    const tls::SessionOptions& session = tls_config_.session;
+    bool ecdsa_primary = session.prefersEcdsa() && sslConfigOf(tls_ctx, 0) != nullptr;
+    if (session.prefersEcdsa() && !ecdsa_primary) {
+        warnUnsupportedTlsOption("ecdsa");
+    }
+    const std::string& cert_file = ecdsa_primary ? session.ecdsa_cert_file : tls_config_.cert_file;
+    const std::string& key_file = ecdsa_primary ? session.ecdsa_key_file : tls_config_.key_file;
+    
+    // 加载证书
+    result = uvhttp_tls_context_load_cert_chain(tls_ctx, cert_file.c_str());
+    if (result != UVHTTP_OK) {
+        std::cerr << "Error: Failed to load certificate file: " << cert_file << std::endl;
+        uvhttp_tls_context_free(tls_ctx);
+        return;
+    }
+    
+    // 加载私钥
+    result = uvhttp_tls_context_load_private_key(tls_ctx, key_file.c_str());
+    if (result != UVHTTP_OK) {
+        std::cerr << "Error: Failed to load private key file: " << key_file << std::endl;
+        uvhttp_tls_context_free(tls_ctx);
+        return;
+    }
+    
+    // 可选：加载 CA 证书（用于客户端认证）
+    if (!tls_config_.ca_file.empty()) {
+        result = uvhttp_tls_context_load_ca_file(tls_ctx, tls_config_.ca_file.c_str());
+        if (result != UVHTTP_OK) {
+            std::cerr << "Warning: Failed to load CA file: " << tls_config_.ca_file << std::endl;
+        } else {
+            // 启用客户端认证
+            uvhttp_tls_context_enable_client_auth(tls_ctx, 1);
+        }
+    }
+    
+    // 启用 TLS 到服务器
+    result = uvhttp_server_enable_tls(server_.get(), tls_ctx);
+    if (result != UVHTTP_OK) {
+        std::cerr << "Error: Failed to enable TLS on server" << std::endl;
+        uvhttp_tls_context_free(tls_ctx);
+        return;
+    }
+    
+    // TLS 上下文所有权已转移给 server，无需手动释放；会话选项在 uvhttp 完成配置之后设置，覆盖其默认值
+    use_https_ = true;
+    configureTlsSessions(tls_ctx);
+    std::cout << "TLS/SSL enabled successfully" << std::endl;
+}
+
+void server::Server::configureTlsSessions(uvhttp_tls_context_t* tls_ctx) {
+    const tls::SessionOptions& options = tls_config_.session;
+    if (!tls_stats_) {
+        tls_stats_ = std::make_shared<tls::SessionStats>();
+    }
+    // 握手按新连接计数
+    if (!connections_) {
+        connections_ = std::make_shared<ConnectionTracker>();
+    }
+    
+    mbedtls_ssl_config* conf = sslConfigOf(tls_ctx, 0);
+    if (!conf) {
+        if (options.session_tickets && !enableUvhttpTickets(tls_ctx, 0)) {
+            warnUnsupportedTlsOption("session_tickets");
+        }
+        if (options.session_cache_size > 0 &&
+            !setUvhttpSessionCache(tls_ctx, static_cast<int>(options.session_cache_size), 0)) {
+            warnUnsupportedTlsOption("session_cache_size");
+        }
+        if (!options.alpn.empty()) {
+            warnUnsupportedTlsOption("alpn");
+        }
+        return;
+    }
+    
+    std::shared_ptr<TlsSession> session = std::make_shared<TlsSession>(conf);
+    session->stats = tls_stats_;
+    session->hooks.stats = tls_stats_.get();
+    
+    if (options.prefersEcdsa()) {
+        int parsed = mbedtls_x509_crt_parse_file(&session->fallback_cert, tls_config_.cert_file.c_str());
+#if MBEDTLS_VERSION_MAJOR >= 3
+        if (parsed == 0) {
+            parsed = mbedtls_pk_parse_keyfile(&session->fallback_key, tls_config_.key_file.c_str(), nullptr,
+                                              tlsRandom, nullptr);
+        }
+#else
+        if (parsed == 0) {
+            parsed = mbedtls_pk_parse_keyfile(&session->fallback_key, tls_config_.key_file.c_str(), nullptr);
+        }
+#endif
+        if (parsed != 0 || mbedtls_ssl_conf_own_cert(conf, &session->fallback_cert, &session->fallback_key) != 0) {
+            std::cerr << "Warning: Failed to add fallback certificate " << tls_config_.cert_file
+                      << "; only the ECDSA certificate is served" << std::endl;
+        }
+    }
+    
+#if defined(MBEDTLS_SSL_SESSION_TICKETS)
+    if (options.session_tickets) {
+        uint32_t lifetime = static_cast<uint32_t>(options.ticket_rotation.count());
+        if (mbedtls_ssl_ticket_setup(&session->ticket, tlsRandom, nullptr, MBEDTLS_CIPHER_AES_256_GCM, lifetime) != 0) {
+            std::cerr << "Warning: Failed to set up TLS session tickets" << std::endl;
+        } else {
+            session->ticket_ready = true;
+#if MBEDTLS_VERSION_NUMBER >= 0x03020000
+            // 多核模式下各工作线程共用一份密钥；旧版 mbedtls 不支持外部密钥，由各上下文按有效期自行轮换
+            if (!tls_keys_) {
+                tls_keys_ = std::make_shared<tls::TicketKeyRing>(options.ticket_rotation);
+            }
+            session->keys = tls_keys_;
+            tls_keys_->rotateIfDue(monotonicMillis(), secureRandom);
+            session->applyTicketKey();
+#endif
+            mbedtls_ssl_conf_session_tickets_cb(conf, writeSessionTicket, parseSessionTicket, &session->hooks);
+        }
+    }
+#else
+    if (options.session_tickets) {
+        std::cerr << "Warning: mbedtls built without MBEDTLS_SSL_SESSION_TICKETS; session tickets disabled" << std::endl;
+    }
+#endif
+    
+#if defined(MBEDTLS_SSL_CACHE_C)
+    if (options.session_cache_size > 0) {
+        size_t entries = options.session_cache_size > static_cast<size_t>(INT_MAX) ? static_cast<size_t>(INT_MAX)
+                                                                                   : options.session_cache_size;
+        mbedtls_ssl_cache_set_max_entries(&session->cache, static_cast<int>(entries));
+#if defined(MBEDTLS_HAVE_TIME)
+        mbedtls_ssl_cache_set_timeout(&session->cache, static_cast<int>(options.session_timeout.count()));
+#endif
+        mbedtls_ssl_conf_session_cache(conf, &session->hooks, getCachedSession, setCachedSession);
+    }
+#else
+    if (options.session_cache_size > 0) {
+        std::cerr << "Warning: mbedtls built without MBEDTLS_SSL_CACHE_C; session cache disabled" << std::endl;
+    }
+#endif
+    
+#if defined(MBEDTLS_SSL_ALPN)
+    session->alpn.assign(options.alpn);
+    if (!session->alpn.empty() && mbedtls_ssl_conf_alpn_protocols(conf, session->alpn.data()) != 0) {
+        std::cerr << "Warning: Failed to configure ALPN protocols" << std::endl;
+    }
+#else
+    if (!options.alpn.empty()) {
+        std::cerr << "Warning: mbedtls built without MBEDTLS_SSL_ALPN; ALPN disabled" << std::endl;
+    }
+#endif
+    
+    tls_session_ = session;
+}
+
+void server::Server::onTlsRotationTimer(uv_timer_t* timer) {
+    TlsRotationTimer* rotation = static_cast<TlsRotationTimer*>(timer->data);
+    TlsSession& session = *rotation->session;
+    // 第一个到期的工作线程生成新密钥，其余工作线程随后装载同一把
+    session.keys->rotateIfDue(monotonicMillis(), secureRandom);
+    session.applyTicketKey();
+}
+
+void server::Server::onTlsRotationClosed(uv_handle_t* handle) {
+    delete static_cast<TlsRotationTimer*>(handle->data);
+}
+
+void server::Server::startTlsRotation() {
+    if (tls_timer_ || !tls_session_ || !tls_session_->keys || !loop_) {
+        return;
+    }
+    TlsRotationTimer* rotation = new TlsRotationTimer();
+    rotation->session = tls_session_;
+    // 轮换间隔的 1/8，介于 1 秒和 60 秒之间：各工作线程装载新密钥的时间差不超过一个周期
+    uint64_t interval_ms = static_cast<uint64_t>(tls_session_->keys->rotation().count()) * 1000 / 8;
+    interval_ms = interval_ms < 1000 ? 1000 : (interval_ms > 60000 ? 60000 : interval_ms);
+    uv_timer_init(loop_, &rotation->timer);
+    rotation->timer.data = rotation;
+    uv_timer_start(&rotation->timer, onTlsRotationTimer, interval_ms, interval_ms);
+    uv_unref(reinterpret_cast<uv_handle_t*>(&rotation->timer));
+    tls_timer_ = rotation;
+}
+
+void server::Server::stopTlsRotation() {
+    if (!tls_timer_) {
+        return;
+    }
+    uv_handle_t* handle = reinterpret_cast<uv_handle_t*>(&tls_timer_->timer);
+    tls_timer_ = nullptr;
+    if (!uv_is_closing(handle)) {
+        uv_close(handle, onTlsRotationClosed);
+    }
+}
+
+server::Server::RouteEntry* server::Server::registerRoute(const std::string& path, HttpMethod method) {
+    // 路由 ID 即 handlers_ 下标，重复注册时覆盖旧处理器
+    int route_id = route_table_.add(path, static_cast<int>(method));
+    if (route_id == RouteTable::kNoRoute) {
+        std::cerr << "Error: Invalid route pattern " << path << std::endl;
+        return nullptr;
+    }
+    size_t index = static_cast<size_t>(route_id);
+    if (index >= handlers_.size()) {
+        handlers_.resize(index + 1);
+    }
+    handlers_[index].path = path;
+    handlers_[index].method = method;
+    if (route_metrics_ && !handlers_[index].metrics) {
+        handlers_[index].metrics = route_metrics_->route(path, methodName(method));
+    }
+    
+    // 使用 uvhttp 的路由 API 注册路由；运行期间 uvhttp 的路由器只由事件循环线程访问，
+    // 新路由经默认处理器（同为 on_uvhttp_request）到达，由已发布的路由表匹配
+    if (!routes_live_) {
+        uvhttp_error_t result = uvhttp_router_add_route_method(
+            router_.get(),
+            path.c_str(),
+            toUvhttpMethod(method),
+            on_uvhttp_request
+        );
+        
+        if (result != UVHTTP_OK) {
+            std::cerr << "Error: Failed to add route " << path << std::endl;
+        }
+    }
+    
+    return &handlers_[index];
+}
+
+void server::Server::importRoutes(const Server& other) {
+    setOptions(other.options_);  // 连接表按循环各自创建
+    route_metrics_ = other.route_metrics_;
+    rate_limit_ = other.rate_limit_;  // 限流表按分片加锁，工作线程之间共享
+    admission_ = other.admission_;    // 并发上限为全部工作线程合计；队列按循环各自创建
+    request_arena_ = other.request_arena_;  // arena 按线程各自持有
+    arena_json_ = other.arena_json_;
+    middleware_ = other.middleware_;
+    compression_ = other.compression_;  // 只读，压缩上下文按线程各自持有
+    cors_ = other.cors_;
+    tracer_ = other.tracer_;  // 缓冲区按线程各自注册
+    offload_pool_ = other.offload_pool_;  // 线程池所有工作线程共享
+    health_ = other.health_;  // 每个工作线程各自调度，到期的检查只会被提交一次
+    if (other.tls_config_.enabled) {
+        // 每个工作线程一个 TLS 上下文；票据密钥与握手统计共用，票据可在任一工作线程上恢复
+        tls_keys_ = other.tls_keys_;
+        tls_stats_ = other.tls_stats_;
+        enableTls(other.tls_config_);
+    }
+    static_mounts_ = other.static_mounts_;  // 文件缓存内部加锁，工作线程之间共享；监视器按循环各自创建
+    
+    // 路由表共用原型发布的一份（条目中的缓存、统计、限流和流水线本来就在工作线程之间共享），
+    // 原型之后的发布同时作用于所有工作线程
+    other.syncRoutes();
+    if (routes_ != other.routes_) {
+        routes_->detach(route_reader_);
+        routes_ = other.routes_;
+        route_reader_ = routes_->attach();
+    }
+    routes_owner_ = false;
+    std::shared_ptr<const RouteSnapshot> routes = routes_->load();
+    for (size_t i = 0; i < routes->entries.size(); i++) {
+        const RouteEntry& source = routes->entries[i];
+        uvhttp_error_t result = uvhttp_router_add_route_method(
+            router_.get(), source.path.c_str(), toUvhttpMethod(source.method), on_uvhttp_request);
+        if (result != UVHTTP_OK) {
+            std::cerr << "Error: Failed to add route " << source.path << std::endl;
+        }
+    }
+}
+
+void server::Server::routesChanged() {
+    route_revision_++;
+    if (!routes_owner_) {
+        std::cerr << "Warning: Routes are imported from another server; changes here are not published" << std::endl;
+        return;
+    }
+    if (routes_live_ && route_batch_ == 0) {
+        syncRoutes();
+    }
+}
+
+void server::Server::syncRoutes() const {
+    if (!routes_ || !routes_owner_) {
+        return;
+    }
+    uint64_t revision = route_revision_;
+    routes_->update([this, revision](const RouteSnapshot& current) -> std::shared_ptr<const RouteSnapshot> {
+        if (current.revision == revision) {
+            return nullptr;
+        }
+        // 只收录有处理器的路由，重新编号：移除的路由不再占用路由树和条目
+        std::shared_ptr<RouteSnapshot> next = std::make_shared<RouteSnapshot>();
+        next->revision = revision;
+        next->entries.reserve(handlers_.size());
+        for (size_t i = 0; i < handlers_.size(); i++) {
+            const RouteEntry& entry = handlers_[i];
+            if (!entry.hasHandler()) {
+                continue;
+            }
+            int route_id = next->table.add(entry.path, static_cast<int>(entry.method));
+            if (route_id == RouteTable::kNoRoute) {
+                continue;
+            }
+            size_t index = static_cast<size_t>(route_id);
+            if (index >= next->entries.size()) {
+                next->entries.resize(index + 1);
+            }
+            next->entries[index] = entry;
+        }
+        return next;
+    });
+}
+
+uint64_t server::Server::publishRoutes() {
+    if (!routes_) {
+        return 0;
+    }
+    if (!routes_owner_) {
+        std::cerr << "Warning: Routes are imported from another server; publish on the prototype" << std::endl;
+        return routes_->version();
+    }
+    syncRoutes();
+    routes_live_ = true;
+    return routes_->version();
+}
+
+uint64_t server::Server::updateRoutes(const std::function<void(Server&)>& edit) {
+    route_batch_++;
+    if (edit) {
+        edit(*this);
+    }
+    route_batch_--;
+    if (route_batch_ > 0) {
+        return routeVersion();  // 外层 updateRoutes 返回时统一发布
+    }
+    return publishRoutes();
+}
+
+bool server::Server::removeRoute(const std::string& path, HttpMethod method) {
+    int route_id = route_table_.add(path, static_cast<int>(method));
+    if (route_id == RouteTable::kNoRoute || static_cast<size_t>(route_id) >= handlers_.size() ||
+        !handlers_[static_cast<size_t>(route_id)].hasHandler()) {
+        return false;
+    }
+    // 草稿中的路由 ID 保留，重新注册时复用；下次发布时不再收录
+    handlers_[static_cast<size_t>(route_id)] = RouteEntry();
+    routesChanged();
+    return true;
+}
+
+uint64_t server::Server::routeVersion() const {
+    return routes_ ? routes_->version() : 0;
+}
+
+void server::Server::addRoute(const std::string& path, HttpMethod method, 
+                      std::function<HttpResponse(const HttpRequest&)> handler) {
+    RouteEntry* entry = registerRoute(path, method);
+    if (entry) {
+        entry->handler = handler;
+        entry->view_handler = nullptr;
+        entry->async_handler = nullptr;
+        entry->stream_handler = nullptr;
+        rebuildPipeline(*entry);
+        routesChanged();
+    }
+}
+
+void server::Server::addViewRoute(const std::string& path, HttpMethod method, RequestViewHandler handler) {
+    RouteEntry* entry = registerRoute(path, method);
+    if (entry) {
+        entry->view_handler = handler;
+        entry->handler = nullptr;
+        entry->async_handler = nullptr;
+        entry->stream_handler = nullptr;
+        rebuildPipeline(*entry);
+        routesChanged();
+    }
+}
+
+void server::Server::addAsyncRoute(const std::string& path, HttpMethod method, AsyncHandler handler,
+                                   std::chrono::milliseconds timeout) {
+    RouteEntry* entry = registerRoute(path, method);
+    if (entry) {
+        if (entry->cache) {
+            std::cerr << "Warning: Route " << path << " is asynchronous; its response cache is bypassed" << std::endl;
+        }
+        entry->async_handler = handler;
+        entry->async_timeout = timeout;
+        entry->handler = nullptr;
+        entry->view_handler = nullptr;
+        entry->stream_handler = nullptr;
+        rebuildPipeline(*entry);
+        routesChanged();
+    }
+}
+
+void server::Server::addStreamRoute(const std::string& path, HttpMethod method, BodyStreamHandler handler,
+                                    std::chrono::milliseconds timeout) {
+    RouteEntry* entry = registerRoute(path, method);
+    if (entry) {
+        if (entry->cache) {
+            std::cerr << "Warning: Route " << path << " is asynchronous; its response cache is bypassed" << std::endl;
+        }
+        entry->stream_handler = handler;
+        entry->async_timeout = timeout;
+        entry->handler = nullptr;
+        entry->view_handler = nullptr;
+        entry->async_handler = nullptr;
+        rebuildPipeline(*entry);
+        routesChanged();
+    }
+}
+
+void server::Server::setRouteBodyLimit(const std::string& path, HttpMethod method, size_t max_body_size) {
+    int route_id = route_table_.add(path, static_cast<int>(method));
+    if (route_id == RouteTable::kNoRoute || static_cast<size_t>(route_id) >= handlers_.size()) {
+        std::cerr << "Error: Cannot set body limit for unregistered route " << path << std::endl;
+        return;
+    }
+    handlers_[static_cast<size_t>(route_id)].max_body_size = max_body_size;
+    routesChanged();
+}
+
+void server::Server::enableOffload(const offload::OffloadPolicy& policy) {
+    if (offload_pool_) {
+        std::cerr << "Warning: Offload pool already created; routes registered earlier keep the old pool" << std::endl;
+    }
+    offload_pool_ = std::make_shared<offload::WorkStealingPool>(policy);
+}
+
+void server::Server::addOffloadRoute(const std::string& path, HttpMethod method,
+                                     std::function<HttpResponse(const HttpRequest&)> handler,
+                                     std::chrono::milliseconds timeout) {
+    if (!offload_pool_) {
+        offload_pool_ = std::make_shared<offload::WorkStealingPool>();
+    }
+    std::shared_ptr<offload::WorkStealingPool> pool = offload_pool_;
+    // 请求副本由 Responder 的状态持有，任务只需持有 Responder
+    addAsyncRoute(path, method, [pool, handler](const HttpRequest& req, Responder responder) {
+        const HttpRequest* request = &req;
+        bool queued = pool->submit([handler, request, responder]() {
+            // 排队期间已超时或客户端已断开：不再执行
+            if (responder.done()) {
+                return;
+            }
+            responder.send(handler(*request));
+        });
+        if (!queued) {
+            HttpResponse busy(503);
+            busy.header("Retry-After", "1");
+            busy.json(R"({"error": "Service Unavailable", "message": "Offload queue is full, retry later"})");
+            responder.send(std::move(busy));
+        }
+    }, timeout);
+}
+
+void server::Server::use(const MiddlewareStage& stage) {
+    if (!stage) {
+        return;
+    }
+    middleware_.push_back(stage);
+    for (size_t i = 0; i < handlers_.size(); i++) {
+        rebuildPipeline(handlers_[i]);
+    }
+    routesChanged();
+}
+
+void server::Server::useRoute(const std::string& path, HttpMethod method, const MiddlewareStage& stage) {
+    int route_id = route_table_.add(path, static_cast<int>(method));
+    if (route_id == RouteTable::kNoRoute || static_cast<size_t>(route_id) >= handlers_.size()) {
+        std::cerr << "Error: Cannot add middleware to unregistered route " << path << std::endl;
+        return;
+    }
+    if (!stage) {
+        return;
+    }
+    RouteEntry& entry = handlers_[static_cast<size_t>(route_id)];
+    entry.middleware.push_back(stage);
+    rebuildPipeline(entry);
+    routesChanged();
+}
+
+void server::Server::rebuildPipeline(RouteEntry& entry) const {
+    if ((middleware_.empty() && entry.middleware.empty()) || !entry.hasHandler()) {
+        entry.pipeline.reset();
+        return;
+    }
+    if (entry.cache && !entry.pipeline && !entry.isAsync()) {
+        std::cerr << "Warning: Route " << entry.path << " has middleware; its response cache is bypassed" << std::endl;
+    }
+    
+    std::vector<MiddlewareStage> stages;
+    stages.reserve(middleware_.size() + entry.middleware.size());
+    stages.insert(stages.end(), middleware_.begin(), middleware_.end());
+    stages.insert(stages.end(), entry.middleware.begin(), entry.middleware.end());
+    
+    MiddlewarePipeline::Terminal terminal = entry.handler;
+    if (entry.view_handler) {
+        // 中间件面向完整请求；零拷贝处理器在流水线末端从 HttpRequest 构造视图
+        RequestViewHandler view_handler = entry.view_handler;
+        terminal = [view_handler](const HttpRequest& req) -> HttpResponse {
+            HttpRequestView view;
+            fillRequestViewFrom(req, view);
+            return view_handler(view);
+        };
+    } else if (entry.isAsync()) {
+        // 异步处理器在流水线末端启动；返回的 202 只交给中间件，不会写出
+        AsyncHandler async_handler = entry.async_handler;
+        BodyStreamHandler stream_handler = entry.stream_handler;
+        terminal = [async_handler, stream_handler](const HttpRequest& req) -> HttpResponse {
+            std::shared_ptr<Responder::State> state = std::move(currentAsyncCall());
+            if (!state) {
+                // 中间件第二次调用 next：处理器已经启动
+                return HttpResponse(500).json(R"({"error": "Internal Server Error", "message": "Async handler already started"})");
+            }
+            const HttpRequest* target = state->request.get();
+            if (&req != target) {
+                // 中间件传入了改写后的请求，复制一份与本次请求同生命周期
+                std::shared_ptr<HttpRequest> copy = std::make_shared<HttpRequest>(req);
+                target = copy.get();
+                Responder(state).keepAlive(copy);
+            }
+            startAsyncCall(async_handler, stream_handler, state, *target, currentAsyncBody());
+            return HttpResponse(202);
+        };
+    }
+    entry.pipeline = std::make_shared<const MiddlewarePipeline>(std::move(stages), terminal);
+}
+
+void server::Server::enableRouteCache(const std::string& path, HttpMethod method,
+                                      const RouteCachePolicy& policy) {
+    int route_id = route_table_.add(path, static_cast<int>(method));
+    if (route_id == RouteTable::kNoRoute || static_cast<size_t>(route_id) >= handlers_.size()) {
+        std::cerr << "Error: Cannot enable cache for unregistered route " << path << std::endl;
+        return;
+    }
+    RouteEntry& entry = handlers_[static_cast<size_t>(route_id)];
+    if (entry.isAsync()) {
+        std::cerr << "Warning: Route " << path << " is asynchronous; its response cache is bypassed" << std::endl;
+    } else if (entry.pipeline) {
+        std::cerr << "Warning: Route " << path << " has middleware; its response cache is bypassed" << std::endl;
+    }
+    entry.cache = std::make_shared<RouteCache>(policy);
+    routesChanged();
+}
+
+void server::Server::enableRateLimit(const rate::RateLimitPolicy& policy) {
+    rate_limit_ = std::make_shared<rate::KeyedRateLimiter>(policy);
+}
+
+void server::Server::enableRouteRateLimit(const std::string& path, HttpMethod method,
+                                          const rate::RateLimitPolicy& policy) {
+    int route_id = route_table_.add(path, static_cast<int>(method));
+    if (route_id == RouteTable::kNoRoute || static_cast<size_t>(route_id) >= handlers_.size()) {
+        std::cerr << "Error: Cannot enable rate limit for unregistered route " << path << std::endl;
+        return;
+    }
+    handlers_[static_cast<size_t>(route_id)].rate_limit = std::make_shared<rate::KeyedRateLimiter>(policy);
+    routesChanged();
+}
+
+void server::Server::enableRequestArena(bool hook_json) {
+    request_arena_ = true;
+    arena_json_ = hook_json;
+    if (hook_json) {
+        installJsonArenaHooks();
+    }
+}
+
+void server::Server::enableCompression(const compress::CompressionPolicy& policy) {
+    if (!compress::gzipAvailable() && !compress::brotliAvailable()) {
+        std::cerr << "Warning: Built without zlib and brotli, response compression is disabled" << std::endl;
+        return;
+    }
+    compression_ = std::make_shared<compress::CompressionPolicy>(policy);
+}
+
+void server::Server::enableCors(const CorsConfig& config) {
+    cors_ = std::make_shared<cors::CorsPolicy>(config);
+}
+
+void server::Server::disableCors() {
+    cors_.reset();
+}
+
+void server::Server::enableTracing(const std::shared_ptr<trace::Tracer>& tracer) {
+    tracer_ = tracer;
+}
+
+bool server::Server::applyCors(const cors::CorsPolicy& policy, uvhttp_request_t* req, uvhttp_response_t* resp,
+                               HttpMethod method) {
+    StringSlice origin = findRequestHeader(req, "Origin");
+    const cors::CorsPolicy::Rendered* rendered = policy.match(origin);
+    if (!rendered) {
+        return false;
+    }
+    StringSlice requested = method == HttpMethod::OPTIONS ? findRequestHeader(req, "Access-Control-Request-Method")
+                                                          : StringSlice();
+    bool preflight = requested.valid() && policy.allowsMethod(requested);
+    cors::CorsPolicy::emit(*rendered, preflight, origin, [resp](const char* name, const char* value) {
+        uvhttp_response_set_header(resp, name, value);
+    });
+    if (!preflight) {
+        return false;
+    }
+    uvhttp_response_set_status(resp, 204);
+    trace::noteResponse(204, 0);
+    uvhttp_response_send(resp);
+    return true;
+}
+
+void server::Server::enableAdmissionControl(const rate::AdmissionPolicy& policy) {
+    admission_ = std::make_shared<rate::AdmissionController>(policy);
+}
+
+rate::AdmissionStats server::Server::admissionStats() const {
+    if (!admission_state_) {
+        rate::AdmissionStats empty = { 0, 0, 0, 0 };
+        return empty;
+    }
+    return admission_state_->queue.stats();
+}
+
+server::Server::AdmissionState* server::Server::admissionState() {
+    if (!admission_state_) {
+        const rate::AdmissionPolicy& policy = admission_->policy();
+        admission_state_ = new AdmissionState(policy.max_queue);
+        admission_state_->server = this;
+        // 排队超时的 1/8 轮询一次，限制在 1~10ms
+        uint64_t tick = static_cast<uint64_t>(policy.queue_timeout.count()) / 8;
+        admission_state_->tick_ms = tick < 1 ? 1 : (tick > 10 ? 10 : tick);
+        uv_timer_init(loop_, &admission_state_->timer);
+        admission_state_->timer.data = admission_state_;
+    }
+    return admission_state_;
+}
+
+bool server::Server::beginAdmitted(const RouteCell::ReadGuard& routes, int route_id, uvhttp_request_t* req,
+                                   uvhttp_response_t* resp, HttpMethod method, const char* path,
+                                   const RouteTable::RouteParam* params, int param_count) {
+    AdmissionState* state = admissionState();
+    // 已有请求在排队时不插队，保持 FIFO
+    if (state->queue.empty() && admission_->tryAcquire()) {
+        state->queue.noteStarted();
+        return true;
+    }
+    
+    const rate::AdmissionPolicy& policy = admission_->policy();
+    PendingRequest pending;
+    pending.resp = resp;
+    pending.routes = routes.retain();
+    pending.route_id = route_id;
+    pending.encoding = negotiateEncoding(req);
+    pending.client = req->client;
+    pending.peer = request_peer_;
+    if (state->queue.size() < state->queue.capacity()) {
+        pending.request = new HttpRequest();
+        pending.request->method = method;
+        pending.request->url_path = path;
+        fillRequest(req, *pending.request, params, param_count);
+    }
+    uint64_t deadline = uv_now(loop_) + static_cast<uint64_t>(policy.queue_timeout.count());
+    if (!state->queue.push(pending, deadline)) {
+        sendServiceUnavailable(resp, policy.retry_after_seconds);
+        endConnection(req->client, request_peer_);
+        return false;
+    }
+    drainAdmissionQueue();
+    return false;
+}
+
+void server::Server::finishAdmitted() {
+    admission_->release();
+    admission_state_->queue.noteFinished();
+    drainAdmissionQueue();
+}
+
+void server::Server::drainAdmissionQueue() {
+    AdmissionState* state = admission_state_;
+    if (!state || state->draining) {
+        return;
+    }
+    state->draining = true;
+    uint64_t now = uv_now(loop_);
+    while (!state->queue.empty()) {
+        PendingRequest pending = state->queue.front();
+        if (state->queue.frontDeadline() <= now) {
+            state->queue.pop();
+            state->queue.noteTimedOut();
+            sendServiceUnavailable(pending.resp, admission_->policy().retry_after_seconds);
+            delete pending.request;
+            endConnection(pending.client, pending.peer);
+            continue;
+        }
+        if (!admission_->tryAcquire()) {
+            break;
+        }
+        state->queue.pop();
+        state->queue.noteStarted();
+        const RouteEntry& entry = pending.routes->entries[static_cast<size_t>(pending.route_id)];
+        HttpResponse response = runHandler(entry, *pending.request);
+        if (compression_) {
+            compressResponse(*compression_, pending.encoding, response);
+        }
+        sendResponse(pending.resp, response);
+        delete pending.request;
+        endConnection(pending.client, pending.peer);
+        admission_->release();
+        state->queue.noteFinished();
+    }
+    
+    if (state->queue.empty() && state->timer_active) {
+        uv_timer_stop(&state->timer);
+        state->timer_active = false;
+    } else if (!state->queue.empty() && !state->timer_active) {
+        uv_timer_start(&state->timer, onAdmissionTimer, state->tick_ms, state->tick_ms);
+        state->timer_active = true;
+    }
+    state->draining = false;
+}
+
+void server::Server::onAdmissionTimer(uv_timer_t* timer) {
+    AdmissionState* state = static_cast<AdmissionState*>(timer->data);
+    state->server->drainAdmissionQueue();
+}
+
+void server::Server::onAdmissionClosed(uv_handle_t* handle) {
+    delete static_cast<AdmissionState*>(handle->data);
+}
+
+void server::Server::stopAdmission() {
+    AdmissionState* state = admission_state_;
+    if (!state) {
+        return;
+    }
+    admission_state_ = nullptr;
+    // 仍在排队的请求直接返回 503
+    uint64_t retry_after = admission_ ? admission_->policy().retry_after_seconds : 1;
+    while (!state->queue.empty()) {
+        PendingRequest pending = state->queue.front();
+        state->queue.pop();
+        sendServiceUnavailable(pending.resp, retry_after);
+        delete pending.request;
+        endConnection(pending.client, pending.peer);
+    }
+    uv_handle_t* handle = reinterpret_cast<uv_handle_t*>(&state->timer);
+    if (!uv_is_closing(handle)) {
+        uv_close(handle, onAdmissionClosed);
+    }
+}
+
+void server::Server::enableInstrumentation(const std::shared_ptr<metrics::RouteMetricsFamily>& family) {
+    route_metrics_ = family;
+    for (size_t i = 0; i < handlers_.size(); i++) {
+        RouteEntry& entry = handlers_[i];
+        if (entry.hasHandler()) {
+            entry.metrics = family ? family->route(entry.path, methodName(entry.method)) : nullptr;
+        }
+    }
+    routesChanged();
+}
+
+std::function<HttpResponse(const HttpRequest&)> server::Server::findHandler(
+    const std::string& path, HttpMethod method) const {
+    const std::function<HttpResponse(const HttpRequest&)>* handler = matchRoute(path.c_str(), method, nullptr);
+    if (handler) {
+        return *handler;
+    }
+    return nullptr;
+}
+
+const std::function<HttpResponse(const HttpRequest&)>* server::Server::matchRoute(
+    const char* path, HttpMethod method, std::map<std::string, std::string>* path_params) const {
+    int route_id = route_table_.match(path, static_cast<int>(method), path_params);
+    if (route_id == RouteTable::kNoRoute || static_cast<size_t>(route_id) >= handlers_.size()) {
+        return nullptr;
+    }
+    const std::function<HttpResponse(const HttpRequest&)>& handler = handlers_[static_cast<size_t>(route_id)].handler;
+    return handler ? &handler : nullptr;
+}
+
+} // namespace server
+
+// ========== Responder ==========
+
+bool Responder::send(HttpResponse response) const {
+    if (!state_) {
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        if (state_->phase.load() != State::PENDING) {
+            return false;
+        }
+        state_->response = std::move(response);
+        state_->phase.store(State::COMPLETED);
+    }
+    // 队列已释放说明服务器已停止，stopAsync 会写出仍在 pending 中的已完成请求
+    std::shared_ptr<server::AsyncLoop> loop = state_->loop.lock();
+    if (loop) {
+        if (loop->onLoopThread()) {
+            server::finishAsync(state_);
+        } else {
+            loop->post(state_);
+        }
+    }
+    return true;
+}
+
+ResponseStream Responder::stream(HttpResponse head) const {
+    if (!state_ || !state_->client) {
+        return ResponseStream();
+    }
+    if (state_->tls) {
+        std::cerr << "Error: Streaming responses are not supported on TLS connections; use send()" << std::endl;
+        return ResponseStream();
+    }
+    std::shared_ptr<ResponseStream::State> stream = std::make_shared<ResponseStream::State>();
+    stream->call = state_;
+    stream->status = head.status_code;
+    stream->chunked = !head.headers.has("Content-Length");
+    stream->with_body = !state_->request || state_->request->method != HttpMethod::HEAD;
+    stream->queued.push_back(server::streamHead(head.status_code, head.headers, stream->chunked));
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        if (state_->phase.load() != State::PENDING) {
+            return ResponseStream();
+        }
+        state_->phase.store(State::STREAMING);
+        // 与已有的收尾钩子（分块请求体）串联
+        std::function<void()> previous = std::move(state_->cleanup);
+        std::weak_ptr<ResponseStream::State> weak = stream;
+        state_->cleanup = [previous, weak]() {
+            if (previous) {
+                previous();
+            }
+            std::shared_ptr<ResponseStream::State> locked = weak.lock();
+            if (locked) {
+                server::closeResponseStream(*locked);
+            }
+        };
+    }
+    server::scheduleFlush(stream);
+    return ResponseStream(stream);
+}
+
+bool Responder::cancelled() const {
+    return state_ && state_->phase.load() == State::CANCELLED;
+}
+
+bool Responder::done() const {
+    return !state_ || state_->phase.load() != State::PENDING;
+}
+
+void Responder::onCancel(std::function<void()> callback) const {
+    if (!state_) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        int phase = state_->phase.load();
+        if (phase == State::PENDING || phase == State::STREAMING) {
+            state_->on_cancel = std::move(callback);
+            return;
+        }
+        if (phase != State::CANCELLED) {
+            return;
+        }
+    }
+    if (callback) {
+        callback();
     }
-    if (server_) server_->user_data = this;
-    return *this;
 }
 
-// 析构函数 - RAII 自动清理，不需要手动释放
-server::Server::~Server() {
-    // 所有资源由 RAII 包装类自动管理
+void Responder::keepAlive(std::shared_ptr<const void> resource) const {
+    if (!state_ || !resource) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    state_->retained.push_back(std::move(resource));
 }
 
-bool server::Server::listen(const std::string& host, int port) {
-    if (!server_ || !loop_) {
+// ========== ResponseStream ==========
+
+bool ResponseStream::write(std::string data) const {
+    if (!state_ || data.empty()) {
         return false;
     }
-    
-    // 设置处理器
-    uvhttp_server_set_handler(server_.get(), on_uvhttp_request);
-    
-    // 启动服务器
-    uvhttp_error_t result = uvhttp_server_listen(server_.get(), host.c_str(), port);
-    if (result != UVHTTP_OK) {
-        fprintf(stderr, "Failed to start server on %s:%d\n", host.c_str(), port);
-        return false;
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        if (state_->ended || state_->closed) {
+            return false;
+        }
+        if (!state_->with_body) {
+            return true;
+        }
+        size_t size = data.size();
+        if (state_->chunked) {
+            state_->queued.push_back(server::chunkPrefix(size));
+            state_->queued.push_back(std::move(data));
+            state_->queued.push_back(server::kChunkSuffix);
+        } else {
+            state_->queued.push_back(std::move(data));
+        }
+        state_->queued_bytes += size;
+        state_->buffered += size;
     }
-    
+    server::scheduleFlush(state_);
     return true;
 }
 
-bool server::Server::listenHttps(const std::string& host, int port) {
-    if (!tls_config_.enabled) {
-        fprintf(stderr, "Error: TLS not enabled. Call enableTls() first\n");
+bool ResponseStream::end() const {
+    if (!state_) {
         return false;
     }
-    
-    return listen(host, port);
+    std::function<void()> on_drain;
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        if (state_->ended || state_->closed) {
+            return false;
+        }
+        state_->ended = true;
+        if (state_->chunked && state_->with_body) {
+            state_->queued.push_back(server::kLastChunk);
+        }
+        on_drain.swap(state_->on_drain);
+    }
+    state_->drained.notify_all();
+    server::scheduleFlush(state_);
+    return true;
 }
 
-void server::Server::stop() {
-    if (server_) {
-        uvhttp_server_stop(server_.get());
+size_t ResponseStream::buffered() const {
+    if (!state_) {
+        return 0;
     }
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->buffered;
 }
 
-void server::Server::enableTls(const TlsConfig& tls_config) {
-    tls_config_ = tls_config;
-    
-    if (!tls_config_.enabled) {
-        return;
+bool ResponseStream::writable() const {
+    if (!state_) {
+        return false;
     }
-    
-    // 创建 TLS 上下文
-    uvhttp_tls_context_t* tls_ctx = nullptr;
-    uvhttp_error_t result = uvhttp_tls_context_new(&tls_ctx);
-    if (result != UVHTTP_OK || !tls_ctx) {
-        std::cerr << "Error: Failed to create TLS context" << std::endl;
-        return;
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return !state_->ended && !state_->closed && state_->buffered < state_->high_watermark;
+}
+
+bool ResponseStream::waitWritable() const {
+    if (!state_) {
+        return false;
     }
-    
-    // 加载证书
-    result = uvhttp_tls_context_load_cert_chain(tls_ctx, tls_config_.cert_file.c_str());
-    if (result != UVHTTP_OK) {
-        std::cerr << "Error: Failed to load certificate file: " << tls_config_.cert_file << std::endl;
-        uvhttp_tls_context_free(tls_ctx);
-        return;
+    std::shared_ptr<server::AsyncLoop> loop = state_->call->loop.lock();
+    if (!loop || loop->onLoopThread()) {
+        return writable();
     }
-    
-    // 加载私钥
-    result = uvhttp_tls_context_load_private_key(tls_ctx, tls_config_.key_file.c_str());
-    if (result != UVHTTP_OK) {
-        std::cerr << "Error: Failed to load private key file: " << tls_config_.key_file << std::endl;
-        uvhttp_tls_context_free(tls_ctx);
+    std::unique_lock<std::mutex> lock(state_->mutex);
+    state_->drained.wait(lock, [this]() {
+        return state_->ended || state_->closed || state_->buffered < state_->high_watermark;
+    });
+    return !state_->ended && !state_->closed;
+}
+
+void ResponseStream::onDrain(std::function<void()> callback) const {
+    if (!state_ || !callback) {
         return;
     }
-    
-    // 可选：加载 CA 证书（用于客户端认证）
-    if (!tls_config_.ca_file.empty()) {
-        result = uvhttp_tls_context_load_ca_file(tls_ctx, tls_config_.ca_file.c_str());
-        if (result != UVHTTP_OK) {
-            std::cerr << "Warning: Failed to load CA file: " << tls_config_.ca_file << std::endl;
-        } else {
-            // 启用客户端认证
-            uvhttp_tls_context_enable_client_auth(tls_ctx, 1);
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        if (state_->ended || state_->closed) {
+            return;
+        }
+        if (state_->buffered > state_->low_watermark) {
+            state_->on_drain = std::move(callback);
+            return;
         }
     }
-    
-    // 启用 TLS 到服务器
-    result = uvhttp_server_enable_tls(server_.get(), tls_ctx);
-    if (result != UVHTTP_OK) {
-        std::cerr << "Error: Failed to enable TLS on server" << std::endl;
-        uvhttp_tls_context_free(tls_ctx);
+    callback();
+}
+
+void ResponseStream::setWatermarks(size_t low, size_t high) const {
+    if (!state_) {
         return;
     }
-    
-    // TLS 上下文所有权已转移给 server，无需手动释放
-    use_https_ = true;
-    std::cout << "TLS/SSL enabled successfully" << std::endl;
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    state_->high_watermark = high < 1 ? 1 : high;
+    state_->low_watermark = low < state_->high_watermark ? low : state_->high_watermark - 1;
 }
 
-void server::Server::addRoute(const std::string& path, HttpMethod method, 
-                      std::function<HttpResponse(const HttpRequest&)> handler) {
-    // 存储自定义处理器
-    handlers_[path][toUvhttpMethod(method)] = handler;
-    
-    // 使用 uvhttp 的路由 API 注册路由
-    uvhttp_error_t result = uvhttp_router_add_route_method(
-        router_.get(),
-        path.c_str(),
-        toUvhttpMethod(method),
-        on_uvhttp_request
-    );
-    
-    (void)result;  // 忽略返回值避免警告
-    
-    if (result != UVHTTP_OK) {
-        std::cerr << "Error: Failed to add route " << path << std::endl;
+bool ResponseStream::closed() const {
+    if (!state_) {
+        return true;
     }
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->ended || state_->closed;
 }
 
-std::function<HttpResponse(const HttpRequest&)> server::Server::findHandler(
-    const std::string& path, HttpMethod method) const {
-    // 查找自定义处理器
-    auto path_it = handlers_.find(path);
-    if (path_it != handlers_.end()) {
-        auto method_it = path_it->second.find(toUvhttpMethod(method));
-        if (method_it != path_it->second.end()) {
-            return method_it->second;
+// ========== BodyStream ==========
+
+void BodyStream::onChunk(std::function<BodyAction(StringSlice chunk)> callback) const {
+    if (state_ && !state_->finished) {
+        state_->on_chunk = std::move(callback);
+    }
+}
+
+void BodyStream::onEnd(std::function<void()> callback) const {
+    if (state_ && !state_->finished) {
+        state_->on_end = std::move(callback);
+    }
+}
+
+void BodyStream::resume() const {
+    if (!state_) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        if (!state_->paused) {
+            state_->resume_requested = true;
+            return;
         }
+        state_->paused = false;
+    }
+    std::shared_ptr<server::AsyncLoop> loop = state_->call->loop.lock();
+    if (!loop) {
+        return;
+    }
+    std::shared_ptr<State> stream = state_;
+    if (loop->onLoopThread()) {
+        server::pumpBody(stream);
+    } else {
+        loop->post([stream]() { server::pumpBody(stream); });
     }
-    return nullptr;
 }
 
-} // namespace server
+uint64_t BodyStream::received() const {
+    return state_ ? state_->received.load() : 0;
+}
+
+uint64_t BodyStream::total() const {
+    return state_ ? state_->total : 0;
+}
 
 // ========== Body Schema 辅助函数和方法实现 ==========
 
@@ -576,7 +3660,7 @@ void setFieldValue(void* instance, const FieldDefinition& field_def, const cJSON
             if (cJSON_IsObject(json) && field_def.nested_schema) {
                 char* nested_obj_str = cJSON_PrintUnformatted(json);
                 field_def.nested_schema->fromJson(nested_obj_str, field_ptr);
-                if (nested_obj_str) free(nested_obj_str);
+                if (nested_obj_str) cJSON_free(nested_obj_str);
             }
             break;
         case FieldType::ARRAY:
@@ -636,28 +3720,35 @@ std::string BodySchemaBase::validate(const cJSON* json) const {
         return "Request body must be a JSON object";
     }
     
-    std::vector<FieldDefinition> fields_vec = fields();
+    const FrozenSchema& schema = frozen();
     
-    // 检查必填字段
-    for (const auto& field : fields_vec) {
-        if (field.validation.required) {
-            cJSON* field_json = cJSON_GetObjectItem(json, field.name.c_str());
-            if (!field_json) {
-                return "Field '" + field.name + "' is required";
+    // 单次遍历 JSON 键：按哈希表定位字段，记录第一个未知字段
+    std::vector<const cJSON*> values(schema.size(), nullptr);
+    const cJSON* unknown = nullptr;
+    for (const cJSON* item = json->child; item; item = item->next) {
+        size_t index = item->string ? schema.find(item->string, std::strlen(item->string)) : FrozenSchema::npos;
+        if (index == FrozenSchema::npos) {
+            if (!unknown) {
+                unknown = item;
             }
+        } else if (!values[index]) {
+            values[index] = item;
         }
     }
     
-    // 验证每个字段
-    for (const auto& field : fields_vec) {
-        cJSON* field_json = cJSON_GetObjectItem(json, field.name.c_str());
-        
-        // 如果字段不存在且不是必填的，跳过验证
-        if (!field_json && !field.validation.required) {
-            continue;
+    // 检查必填字段
+    for (size_t i = 0; i < schema.size(); ++i) {
+        if (schema.isRequired(i) && !values[i]) {
+            return "Field '" + schema[i].name + "' is required";
         }
+    }
+    
+    // 验证每个字段
+    for (size_t i = 0; i < schema.size(); ++i) {
+        const FieldDefinition& field = schema[i];
+        const cJSON* field_json = values[i];
         
-        // 如果字段不存在但是必填的，已经在前面检查过了
+        // 字段不存在：必填字段已经在前面检查过了
         if (!field_json) {
             continue;
         }
@@ -676,17 +3767,8 @@ std::string BodySchemaBase::validate(const cJSON* json) const {
     }
     
     // 检查未知字段
-    for (cJSON* item = json->child; item; item = item->next) {
-        bool found = false;
-        for (const auto& field : fields_vec) {
-            if (field.name == item->string) {
-                found = true;
-                break;
-            }
-        }
-        if (!found) {
-            return "Unknown field '" + std::string(item->string) + "'";
-        }
+    if (unknown) {
+        return "Unknown field '" + std::string(unknown->string ? unknown->string : "") + "'";
     }
     
     return "";
@@ -707,7 +3789,7 @@ bool BodySchemaBase::fromJson(const std::string& json_str, void* instance) const
     }
     
     // 设置字段值
-    std::vector<FieldDefinition> fields_vec = fields();
+    const std::vector<FieldDefinition>& fields_vec = frozen().fields();
     for (const auto& field : fields_vec) {
         cJSON* field_json = cJSON_GetObjectItem(json, field.name.c_str());
         if (field_json) {
@@ -747,7 +3829,7 @@ std::string BodySchemaBase::toJson(void* instance) const {
     cJSON* json = cJSON_CreateObject();
     if (!json) return "{}";
     
-    std::vector<FieldDefinition> fields_vec = fields();
+    const std::vector<FieldDefinition>& fields_vec = frozen().fields();
     for (const auto& field : fields_vec) {
         cJSON* field_json = createJsonField(instance, field.offset, field.type);
         if (field_json) {
@@ -757,7 +3839,7 @@ std::string BodySchemaBase::toJson(void* instance) const {
     
     char* json_str = cJSON_Print(json);
     std::string result(json_str ? json_str : "{}");
-    if (json_str) free(json_str);
+    if (json_str) cJSON_free(json_str);
     cJSON_Delete(json);
     
     return result;
@@ -767,17 +3849,91 @@ std::string BodySchemaBase::toJson(void* instance) const {
 
 namespace restful {
 
-Api::Api(uv_loop_t* loop)
+// ========== Token 存储 ==========
+
+namespace {
+
+bool hmacSha256(const std::string& key, const std::string& data, unsigned char* out) {
+    const mbedtls_md_info_t* info = mbedtls_md_info_from_type(MBEDTLS_MD_SHA256);
+    return info && mbedtls_md_hmac(info, reinterpret_cast<const unsigned char*>(key.data()), key.size(),
+                                   reinterpret_cast<const unsigned char*>(data.data()), data.size(), out) == 0;
+}
+
+int64_t nowSeconds() {
+    return static_cast<int64_t>(time(nullptr));
+}
+
+const char kSignedTokenPrefix[] = "v1.";
+
+} // namespace
+
+// 按 token 哈希的高位分片，每个分片是哈希表 + 时间轮（刻度为秒），由分片自己的 mutex 保护；
+// 多核模式下各工作线程的校验只在落到同一分片时才会竞争
+struct Api::TokenState {
+    static const int kShardBits = 4;
+    static const size_t kShards = static_cast<size_t>(1) << kShardBits;
+    
+    struct Shard {
+        std::mutex mutex;
+        auth::TokenTable<TokenInfo> table;
+        auth::TimerWheel wheel;
+        
+        Shard() : table(64), wheel(static_cast<uint64_t>(nowSeconds())) {}
+        
+        // 推进时间轮到 now，只处理上次推进以来经过的刻度（调用方持有 mutex）
+        void expire(int64_t now) {
+            auth::TokenTable<TokenInfo>& entries = table;
+            wheel.advance(static_cast<uint64_t>(now), [&entries, now](const auth::TokenKey& key, uint64_t) {
+                const TokenInfo* info = entries.find(key);
+                // 已撤销的 token 不在表中，直接忽略
+                if (info && now > info->expires_at) {
+                    entries.erase(key);
+                }
+            });
+        }
+    };
+    
+    Shard shards[kShards];
+    // 签名密钥：非空时签发签名 token；整体替换发布（atomic_load / atomic_store），校验时不加锁也不复制
+    std::shared_ptr<const std::string> secret;
+    
+    // 分片选择用哈希的高位，分片内的槽位用低位
+    Shard& shardFor(const auth::TokenKey& key) {
+        return shards[key.hash() >> (64 - kShardBits)];
+    }
+    
+    std::shared_ptr<const std::string> signingSecret() const {
+        return std::atomic_load(&secret);
+    }
+    
+    // 逐个分片推进时间轮
+    void expire(int64_t now) {
+        for (size_t i = 0; i < kShards; ++i) {
+            std::lock_guard<std::mutex> lock(shards[i].mutex);
+            shards[i].expire(now);
+        }
+    }
+};
+
+// 过期定时器：持有存储的共享引用，不依赖 Api 的生命周期
+struct Api::TokenExpiryTimer {
+    uv_timer_t timer;
+    std::shared_ptr<TokenState> state;
+};
+
+Api::Api(uv_loop_t* loop, const server::ServerOptions& options)
     : api_title_("RESTful API")
     , api_description_("A RESTful API framework")
     , api_version_("1.0.0")
     , running_(false)
     , cors_config_()
     , cors_enabled_(false)
-    , tokens_()
-    , token_generation_count_(0)
-    , last_cleanup_time_(0)
-    , server_(nullptr) {
+    , tokens_(new TokenState())
+    , token_timer_(nullptr)
+    , server_(nullptr)
+    , workers_(1)
+    , cluster_(nullptr)
+    , metrics_registry_(nullptr) {
     
     if (!loop) {
         // 事件循环不能为空
@@ -786,7 +3942,7 @@ Api::Api(uv_loop_t* loop)
     }
     
     // 创建 Server 层（注入事件循环）
-    server_ = std::unique_ptr<server::Server>(new server::Server(loop));
+    server_ = std::unique_ptr<server::Server>(new server::Server(loop, options));
     if (!server_) {
         std::cerr << "Error: Failed to create server" << std::endl;
     }
@@ -794,6 +3950,7 @@ Api::Api(uv_loop_t* loop)
 
 Api::~Api() {
     stop();
+    stopTokenExpiry();
     // server_ 自动释放，无需手动 delete
 }
 
@@ -822,95 +3979,326 @@ Api& Api::patch(const std::string& path, RequestHandler handler) {
     return *this;
 }
 
-Api& Api::head(const std::string& path, RequestHandler handler) {
-    server_->addRoute(path, HttpMethod::HEAD, handler);
+Api& Api::head(const std::string& path, RequestHandler handler) {
+    server_->addRoute(path, HttpMethod::HEAD, handler);
+    return *this;
+}
+
+Api& Api::options(const std::string& path, RequestHandler handler) {
+    server_->addRoute(path, HttpMethod::OPTIONS, handler);
+    return *this;
+}
+
+bool Api::run(const std::string& host, int port) {
+    if (running_ || !server_) {
+        return false;
+    }
+    
+    // 线程池可能在开启指标之后才由 offload 路由创建，启动时统一注册
+    if (metrics_registry_ && server_->offloadPool()) {
+        server_->offloadPool()->registerMetrics(*metrics_registry_);
+    }
+    if (metrics_registry_ && server_->tlsStats()) {
+        server_->tlsStats()->registerMetrics(*metrics_registry_);
+    }
+    
+    if (workers_ != 1) {
+        // 多核模式：路由已注册在 server_ 上，发布后各工作线程共用；之后的修改由 server_ 发布
+        server_->publishRoutes();
+        cluster_.reset(new server::ServerCluster(*server_, workers_));
+        if (!cluster_->listen(host, port)) {
+            cluster_.reset();
+            return false;
+        }
+        
+        running_ = true;
+        std::cout << "Server listening on http://" << host << ":" << port
+                  << " (" << cluster_->workerCount() << " workers)" << std::endl;
+        
+        cluster_->join();
+        cluster_.reset();
+        running_ = false;
+        return true;
+    }
+    
+    // 启动服务器监听
+    if (!server_->listen(host, port)) {
+        return false;
+    }
+    
+    running_ = true;
+    std::cout << "Server listening on http://" << host << ":" << port << std::endl;
+    startTokenExpiry();
+    
+    // 运行事件循环
+    uv_run(server_->getLoop(), UV_RUN_DEFAULT);
+    
+    stopTokenExpiry();
+    running_ = false;
+    return true;
+}
+
+uint64_t Api::updateRoutes(const std::function<void(Api&)>& edit) {
+    if (!server_) {
+        return 0;
+    }
+    return server_->updateRoutes([this, &edit](server::Server&) {
+        if (edit) {
+            edit(*this);
+        }
+    });
+}
+
+bool Api::removeRoute(const std::string& path, HttpMethod method) {
+    return server_ && server_->removeRoute(path, method);
+}
+
+void Api::stop() {
+    if (cluster_) {
+        cluster_->stop();
+        return;
+    }
+    if (running_ && server_) {
+        server_->stop();
+        uv_stop(server_->getLoop());
+    }
+}
+
+// CORS 配置
+Api& Api::enableCors(const CorsConfig& config) {
+    cors_config_ = config;
+    cors_config_.enabled = true;
+    cors_enabled_ = true;
+    if (server_) {
+        server_->enableCors(cors_config_);
+    }
+    return *this;
+}
+
+Api& Api::enableCors(bool enabled) {
+    if (!enabled) {
+        return disableCors();
+    }
+    return enableCors(cors_config_);
+}
+
+Api& Api::rateLimit(const rate::RateLimitPolicy& policy) {
+    if (server_) {
+        server_->enableRateLimit(policy);
+    }
+    return *this;
+}
+
+Api& Api::use(const MiddlewareStage& stage) {
+    if (server_) {
+        server_->use(stage);
+    }
+    return *this;
+}
+
+Api& Api::compression(const compress::CompressionPolicy& policy) {
+    if (server_) {
+        server_->enableCompression(policy);
+    }
+    return *this;
+}
+
+Api& Api::offload(const offload::OffloadPolicy& policy) {
+    if (server_) {
+        server_->enableOffload(policy);
+    }
+    return *this;
+}
+
+Api& Api::options(const server::ServerOptions& options) {
+    if (server_) {
+        server_->setOptions(options);
+    }
+    return *this;
+}
+
+server::ConnectionStats Api::connectionStats() const {
+    if (cluster_) {
+        return cluster_->connectionStats();
+    }
+    return server_ ? server_->connectionStats() : server::ConnectionStats();
+}
+
+Api& Api::requestArena(bool hook_json) {
+    if (server_) {
+        server_->enableRequestArena(hook_json);
+    }
     return *this;
 }
 
-Api& Api::options(const std::string& path, RequestHandler handler) {
-    server_->addRoute(path, HttpMethod::OPTIONS, handler);
+Api& Api::admissionControl(const rate::AdmissionPolicy& policy) {
+    if (server_) {
+        server_->enableAdmissionControl(policy);
+    }
     return *this;
 }
 
-bool Api::run(const std::string& host, int port) {
-    if (running_ || !server_) {
-        return false;
-    }
-    
-    // 启动服务器监听
-    if (!server_->listen(host, port)) {
-        return false;
+Api& Api::enableMetrics(const std::string& path) {
+    return enableMetrics(path, metrics::getGlobalMetricRegistry());
+}
+
+Api& Api::enableMetrics(const std::string& path, metrics::MetricRegistry& registry,
+                        const metrics::ExpositionOptions& options) {
+    if (!server_) {
+        return *this;
     }
+    std::shared_ptr<metrics::RouteMetricsFamily> family = std::make_shared<metrics::RouteMetricsFamily>();
+    registry.registerMetric(family);
+    server_->enableInstrumentation(family);
+    metrics_registry_ = &registry;
     
-    running_ = true;
-    std::cout << "Server listening on http://" << host << ":" << port << std::endl;
+    metrics::ExpositionFormat format = options.format;
+    const char* content_type = metrics::contentType(format);
     
-    // 运行事件循环
-    uv_run(server_->getLoop(), UV_RUN_DEFAULT);
+    if (options.refresh_interval.count() > 0) {
+        // 后台渲染：请求只复制最近一次的结果
+        metrics_scraper_.reset(new metrics::BackgroundScraper(registry, options.refresh_interval, format));
+        metrics_scraper_->start();
+        metrics::BackgroundScraper* scraper = metrics_scraper_.get();
+        server_->addRoute(path, HttpMethod::GET, [scraper, content_type](const HttpRequest& /*req*/) -> HttpResponse {
+            std::shared_ptr<const std::string> text = scraper->latest();
+            return HttpResponse(200, text ? *text : std::string()).header("Content-Type", content_type);
+        });
+        return *this;
+    }
     
-    running_ = false;
-    return true;
+    // 请求时渲染：直接写入响应体；注册表由调用方持有，生命周期需覆盖 Api
+    metrics::MetricRegistry* source = &registry;
+    server_->addRoute(path, HttpMethod::GET, [source, format, content_type](const HttpRequest& /*req*/) -> HttpResponse {
+        HttpResponse response(200);
+        source->scrape(response.body, format);
+        response.header("Content-Type", content_type);
+        return response;
+    });
+    return *this;
 }
 
-void Api::stop() {
-    if (running_ && server_) {
-        server_->stop();
-        uv_stop(server_->getLoop());
+Api& Api::enableTracing(const trace::TracePolicy& policy, const std::string& path) {
+    if (!server_) {
+        return *this;
     }
-}
-
-// CORS 配置
-Api& Api::enableCors(const CorsConfig& config) {
-    cors_config_ = config;
-    cors_enabled_ = true;
+    tracer_ = std::make_shared<trace::Tracer>(policy);
+    tracer_->start();
+    server_->enableTracing(tracer_);
+    
+    // 端点只复制收集线程最近一次渲染的结果
+    trace::Tracer* tracer = tracer_.get();
+    server_->addRoute(path, HttpMethod::GET, [tracer](const HttpRequest& /*req*/) -> HttpResponse {
+        std::shared_ptr<const std::string> body = tracer->latest();
+        return HttpResponse(200, body ? *body : std::string("{}")).header("Content-Type", "application/json");
+    });
     return *this;
 }
 
-Api& Api::enableCors(bool enabled) {
-    cors_enabled_ = enabled;
-    if (enabled) {
-        cors_config_.enabled = true;
+Api& Api::healthChecks(const std::shared_ptr<health::HealthCheckManager>& manager,
+                       const std::string& health_path, const std::string& ready_path) {
+    if (server_) {
+        server_->enableHealthChecks(manager, health_path, ready_path);
     }
     return *this;
 }
 
 Api& Api::disableCors() {
     cors_enabled_ = false;
+    cors_config_.enabled = false;
+    if (server_) {
+        server_->disableCors();
+    }
+    return *this;
+}
+
+void Api::onTokenTimer(uv_timer_t* timer) {
+    TokenExpiryTimer* expiry = static_cast<TokenExpiryTimer*>(timer->data);
+    expiry->state->expire(nowSeconds());
+}
+
+void Api::onTokenTimerClosed(uv_handle_t* handle) {
+    delete static_cast<TokenExpiryTimer*>(handle->data);
+}
+
+void Api::startTokenExpiry() {
+    if (token_timer_ || !server_ || !server_->getLoop()) {
+        return;
+    }
+    TokenExpiryTimer* expiry = new TokenExpiryTimer();
+    expiry->state = tokens_;
+    uv_timer_init(server_->getLoop(), &expiry->timer);
+    expiry->timer.data = expiry;
+    uv_timer_start(&expiry->timer, onTokenTimer, 1000, 1000);
+    // 过期定时器不应让事件循环保持运行
+    uv_unref(reinterpret_cast<uv_handle_t*>(&expiry->timer));
+    token_timer_ = expiry;
+}
+
+void Api::stopTokenExpiry() {
+    if (!token_timer_) {
+        return;
+    }
+    uv_handle_t* handle = reinterpret_cast<uv_handle_t*>(&token_timer_->timer);
+    token_timer_ = nullptr;
+    if (!uv_is_closing(handle)) {
+        uv_close(handle, onTokenTimerClosed);
+    }
+}
+
+Api& Api::signedTokens(const std::string& secret) {
+    if (!secret.empty() && secret.size() < 32) {
+        std::cerr << "Error: Token signing secret must be at least 32 bytes" << std::endl;
+        return *this;
+    }
+    std::shared_ptr<const std::string> published;
+    if (!secret.empty()) {
+        published = std::make_shared<const std::string>(secret);
+    }
+    std::atomic_store(&tokens_->secret, published);
     return *this;
 }
 
 // Token 管理
 std::string Api::generateToken(int64_t user_id, const std::string& username, 
                               const std::string& role, int64_t expires_in_seconds) {
-    // 每生成 100 个 token 或距离上次清理超过 5 分钟时清理过期 token
-    token_generation_count_++;
-    int64_t now = static_cast<int64_t>(time(nullptr));
-    if (token_generation_count_ % 100 == 0 || (now - last_cleanup_time_) > 300) {
-        cleanupExpiredTokens();
-        last_cleanup_time_ = now;
-    }
-    
-    // 生成随机 token
-    static const char charset[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(0, sizeof(charset) - 2);
+    int64_t now = nowSeconds();
+    // 使用 int64_t 避免 time_t 32 位溢出问题
+    TokenInfo info(user_id, username, role, now + expires_in_seconds);
     
-    std::string token;
-    for (int i = 0; i < 32; i++) {
-        token += charset[dis(gen)];
+    std::shared_ptr<const std::string> secret = tokens_->signingSecret();
+    if (secret) {
+        // 签名 token：v1.<base64url(声明)>.<base64url(HMAC-SHA256)>
+        std::string claims;
+        if (!auth::packClaims(info.user_id, info.expires_at, info.username, info.role, claims)) {
+            return "";
+        }
+        std::string token(kSignedTokenPrefix);
+        auth::base64UrlEncode(reinterpret_cast<const unsigned char*>(claims.data()), claims.size(), token);
+        unsigned char mac[auth::kSignatureSize];
+        if (!hmacSha256(*secret, token, mac)) {
+            return "";
+        }
+        token += '.';
+        auth::base64UrlEncode(mac, sizeof(mac), token);
+        return token;
     }
     
-    // 存储 token 信息
-    TokenInfo info;
-    info.user_id = user_id;
-    info.username = username;
-    info.role = role;
-    // 使用 int64_t 避免 time_t 32 位溢出问题
-    info.expires_at = static_cast<int64_t>(time(nullptr)) + expires_in_seconds;
-    tokens_[token] = info;
+    unsigned char random[auth::kTokenSize];
+    if (!secureRandom(random, sizeof(random))) {
+        return "";
+    }
+    auth::TokenKey key = auth::TokenKey::fromRandom(random);
+    // 第一个满足 now > expires_at 的秒
+    uint64_t expire_tick = static_cast<uint64_t>(info.expires_at < now ? now : info.expires_at + 1);
     
-    return token;
+    TokenState::Shard& shard = tokens_->shardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    // 多核模式下没有过期定时器，在签发时顺带推进所在分片（均摊 O(1)）
+    shard.expire(now);
+    shard.table.insert(key, std::move(info));
+    shard.wheel.schedule(key, expire_tick);
+    return key.toString();
 }
 
 bool Api::isTokenExpired(const TokenInfo& info) const {
@@ -919,58 +4307,86 @@ bool Api::isTokenExpired(const TokenInfo& info) const {
 
 bool Api::validateToken(const std::string& token, int64_t& user_id, 
                         std::string& username, std::string& role) {
-    std::map<std::string, TokenInfo>::iterator it = tokens_.find(token);
-    if (it == tokens_.end()) {
+    if (token.compare(0, sizeof(kSignedTokenPrefix) - 1, kSignedTokenPrefix) == 0) {
+        std::shared_ptr<const std::string> secret = tokens_->signingSecret();
+        size_t dot = token.rfind('.');
+        if (!secret || dot < sizeof(kSignedTokenPrefix) - 1) {
+            return false;
+        }
+        std::string signature;
+        unsigned char expected[auth::kSignatureSize];
+        if (!auth::base64UrlDecode(token.data() + dot + 1, token.size() - dot - 1, signature) ||
+            signature.size() != auth::kSignatureSize ||
+            !hmacSha256(*secret, token.substr(0, dot), expected) ||
+            !auth::constantTimeEquals(signature.data(), expected, sizeof(expected))) {
+            return false;
+        }
+        
+        std::string claims;
+        TokenInfo info;
+        size_t begin = sizeof(kSignedTokenPrefix) - 1;
+        if (!auth::base64UrlDecode(token.data() + begin, dot - begin, claims) ||
+            !auth::unpackClaims(claims, info.user_id, info.expires_at, info.username, info.role) ||
+            isTokenExpired(info)) {
+            return false;
+        }
+        user_id = info.user_id;
+        username.swap(info.username);
+        role.swap(info.role);
+        return true;
+    }
+    
+    auth::TokenKey key;
+    if (!auth::TokenKey::parse(token.data(), token.size(), key)) {
+        return false;
+    }
+    TokenState::Shard& shard = tokens_->shardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    const TokenInfo* info = shard.table.find(key);
+    if (!info) {
         return false;
     }
     
-    // 检查过期时间
-    if (isTokenExpired(it->second)) {
-        tokens_.erase(it);
+    // 检查过期时间（时间轮回收之前也不会放行过期 token）
+    if (isTokenExpired(*info)) {
+        shard.table.erase(key);
         return false;
     }
     
-    user_id = it->second.user_id;
-    username = it->second.username;
-    role = it->second.role;
+    user_id = info->user_id;
+    username = info->username;
+    role = info->role;
     return true;
 }
 
 std::string Api::refreshToken(const std::string& token, int64_t expires_in_seconds) {
-    std::map<std::string, TokenInfo>::iterator it = tokens_.find(token);
-    if (it == tokens_.end()) {
+    int64_t user_id = 0;
+    std::string username;
+    std::string role;
+    if (!validateToken(token, user_id, username, role)) {
         return "";
     }
     
-    // 检查过期时间
-    if (isTokenExpired(it->second)) {
-        tokens_.erase(it);
-        return "";
-    }
+    // 删除旧 token（签名 token 无存储，自然过期）
+    revokeToken(token);
     
     // 生成新 token
-    std::string new_token = generateToken(it->second.user_id, it->second.username, 
-                                         it->second.role, expires_in_seconds);
-    
-    // 删除旧 token
-    tokens_.erase(it);
-    
-    return new_token;
+    return generateToken(user_id, username, role, expires_in_seconds);
 }
 
 bool Api::revokeToken(const std::string& token) {
-    return tokens_.erase(token) > 0;
+    auth::TokenKey key;
+    if (!auth::TokenKey::parse(token.data(), token.size(), key)) {
+        return false;
+    }
+    // 时间轮中的条目到期时发现表中已无此键，直接忽略
+    TokenState::Shard& shard = tokens_->shardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return shard.table.erase(key);
 }
 
 void Api::cleanupExpiredTokens() {
-    time_t now = time(nullptr);
-    for (std::map<std::string, TokenInfo>::iterator it = tokens_.begin(); it != tokens_.end(); ) {
-        if (static_cast<int64_t>(now) > it->second.expires_at) {
-            tokens_.erase(it++);
-        } else {
-            ++it;
-        }
-    }
+    tokens_->expire(nowSeconds());
 }
 
 // 请求处理
@@ -985,13 +4401,19 @@ HttpResponse Api::handle_request(const HttpRequest& req) {
 // 辅助方法
 std::string Api::generateRandomString(size_t length) {
     static const char charset[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(0, sizeof(charset) - 2);
-    
     std::string result;
-    for (size_t i = 0; i < length; i++) {
-        result += charset[dis(gen)];
+    result.reserve(length);
+    unsigned char random[64];
+    while (result.size() < length) {
+        if (!secureRandom(random, sizeof(random))) {
+            return "";
+        }
+        // 拒绝采样：丢弃 >= 248（62 的整数倍）的字节，避免取模偏差
+        for (size_t i = 0; i < sizeof(random) && result.size() < length; i++) {
+            if (random[i] < 248) {
+                result += charset[random[i] % 62];
+            }
+        }
     }
     return result;
 }
@@ -1037,168 +4459,539 @@ RouteBuilder Api::options(const std::string& path) {
     return RouteBuilder(this, path, HttpMethod::OPTIONS);
 }
 
+namespace {
+
+// ========== 预编译参数验证器 ==========
+// 路由注册时把 ParamDefinition 编译为紧凑的检查项：数值边界预先解析、
+// 枚举值预先哈希排序、错误响应体预先渲染；请求时只做比较，不再解释定义
+
+uint64_t hashSlice(const char* data, size_t size) {
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+struct CompiledParam {
+    enum NumericKind { NUMERIC_NONE, NUMERIC_INT, NUMERIC_INT64, NUMERIC_DOUBLE };
+    
+    std::string name;
+    std::string default_value;
+    bool required;
+    int slot;      // BoundParams 槽位，未绑定时为 -1
+    bool boolean;  // 绑定为 bool：只接受 true / false
+    
+    NumericKind numeric;
+    bool has_min;
+    bool has_max;
+    long long min_int;
+    long long max_int;
+    double min_double;
+    double max_double;
+    
+    std::vector<std::pair<uint64_t, std::string> > enum_set;  // 按哈希排序
+    bool has_pattern;
+    CompiledPattern pattern;
+    bool has_min_length;
+    bool has_max_length;
+    size_t min_length;
+    size_t max_length;
+    
+    // 预渲染的错误响应体
+    std::string err_required;
+    std::string err_type;
+    std::string err_range;
+    std::string err_min;
+    std::string err_max;
+    std::string err_enum;
+    std::string err_pattern;
+    std::string err_length;
+    
+    CompiledParam()
+        : required(false), slot(-1), boolean(false), numeric(NUMERIC_NONE), has_min(false), has_max(false),
+          min_int(0), max_int(0), min_double(0.0), max_double(0.0),
+          has_pattern(false), has_min_length(false), has_max_length(false),
+          min_length(0), max_length(0) {}
+};
+
+std::string renderParamError(const char* kind, const std::string& name, const std::string& detail) {
+    return std::string("{\"code\":\"400\",\"message\":\"") + kind + " parameter '" + name + "' " + detail + "\"}";
+}
+
+CompiledParam compileParam(const ParamDefinition& def, const char* kind) {
+    CompiledParam param;
+    param.name = def.name;
+    param.required = def.validation.required;
+    if (!param.required) {
+        param.default_value = def.default_value;
+    }
+    param.err_required = renderParamError(kind, def.name, "is required");
+    
+    // 绑定的数值参数即使没有范围也要检查类型
+    bool bound_numeric = def.bind && def.data_type >= 1 && def.data_type <= 4;
+    if (def.validation.has_min || def.validation.has_max || bound_numeric) {
+        param.has_min = def.validation.has_min;
+        param.has_max = def.validation.has_max;
+        if (def.data_type == 3 || def.data_type == 4) {
+            param.numeric = CompiledParam::NUMERIC_DOUBLE;
+            param.min_double = def.validation.min_double;
+            param.max_double = def.validation.max_double;
+            param.err_type = renderParamError(kind, def.name, "must be a number");
+            param.err_range = param.err_type;
+            param.err_min = renderParamError(kind, def.name, "must be at least " + std::to_string(param.min_double));
+            param.err_max = renderParamError(kind, def.name, "must be at most " + std::to_string(param.max_double));
+        } else {
+            param.numeric = def.bind && def.data_type == 2 ? CompiledParam::NUMERIC_INT64 : CompiledParam::NUMERIC_INT;
+            param.min_int = def.validation.min_value;
+            param.max_int = def.validation.max_value;
+            param.err_type = renderParamError(kind, def.name, "must be an integer");
+            param.err_range = renderParamError(kind, def.name, "value is out of range");
+            param.err_min = renderParamError(kind, def.name, "must be at least " + std::to_string(def.validation.min_value));
+            param.err_max = renderParamError(kind, def.name, "must be at most " + std::to_string(def.validation.max_value));
+        }
+    }
+    
+    if (def.bind && def.data_type == 5) {
+        param.boolean = true;
+        param.err_type = renderParamError(kind, def.name, "must be true or false");
+    }
+    
+    if (def.validation.has_enum) {
+        for (const auto& value : def.validation.enum_values) {
+            param.enum_set.push_back(std::make_pair(hashSlice(value.data(), value.size()), value));
+        }
+        std::sort(param.enum_set.begin(), param.enum_set.end());
+        param.err_enum = renderParamError(kind, def.name, "has invalid value");
+    }
+    
+    if (def.validation.has_pattern) {
+        param.pattern = def.validation.compiled_pattern.compiled()
+            ? def.validation.compiled_pattern
+            : CompiledPattern(def.validation.pattern);
+        if (param.pattern.ok()) {
+            param.has_pattern = true;
+            param.err_pattern = renderParamError(kind, def.name, "does not match the required pattern");
+        } else {
+            std::cerr << "Error: Invalid pattern for parameter " << def.name << ": "
+                      << def.validation.pattern << std::endl;
+        }
+    }
+    
+    if (def.validation.has_min_length || def.validation.has_max_length) {
+        param.has_min_length = def.validation.has_min_length;
+        param.has_max_length = def.validation.has_max_length;
+        param.min_length = static_cast<size_t>(def.validation.min_length);
+        param.max_length = static_cast<size_t>(def.validation.max_length);
+        param.err_length = renderParamError(kind, def.name, "has invalid length");
+    }
+    
+    return param;
+}
+
+// 解析十进制整数切片（不分配内存）；溢出 long long 时返回 false
+bool parseIntSlice(const StringSlice& value, long long& out) {
+    size_t i = 0;
+    bool negative = false;
+    if (i < value.size && (value.data[i] == '-' || value.data[i] == '+')) {
+        negative = value.data[i] == '-';
+        i++;
+    }
+    if (i == value.size) {
+        return false;
+    }
+    unsigned long long magnitude = 0;
+    const unsigned long long limit = negative
+        ? static_cast<unsigned long long>(LLONG_MAX) + 1ULL
+        : static_cast<unsigned long long>(LLONG_MAX);
+    for (; i < value.size; i++) {
+        char c = value.data[i];
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        unsigned long long digit = static_cast<unsigned long long>(c - '0');
+        if (magnitude > (limit - digit) / 10ULL) {
+            return false;
+        }
+        magnitude = magnitude * 10ULL + digit;
+    }
+    out = negative ? static_cast<long long>(0ULL - magnitude) : static_cast<long long>(magnitude);
+    return true;
+}
+
+bool parseDoubleSlice(const StringSlice& value, double& out) {
+    char buffer[64];
+    if (value.size == 0 || value.size >= sizeof(buffer)) {
+        return false;
+    }
+    std::memcpy(buffer, value.data, value.size);
+    buffer[value.size] = '\0';
+    char* endptr = nullptr;
+    errno = 0;
+    out = strtod(buffer, &endptr);
+    return endptr != buffer && *endptr == '\0' && errno != ERANGE;
+}
+
+// 执行单个检查项；通过返回 nullptr，否则返回预渲染的错误响应体。
+// slot 非空时（绑定参数）把解析结果写入槽位，处理器不再重复解析
+const std::string* runParamCheck(const CompiledParam& param, const StringSlice& value, BoundParams::Slot* slot) {
+    if (param.numeric == CompiledParam::NUMERIC_INT || param.numeric == CompiledParam::NUMERIC_INT64) {
+        long long int_value = 0;
+        if (!parseIntSlice(value, int_value)) {
+            return &param.err_type;
+        }
+        if (param.numeric == CompiledParam::NUMERIC_INT && (int_value < INT_MIN || int_value > INT_MAX)) {
+            return &param.err_range;
+        }
+        if (param.has_min && int_value < param.min_int) {
+            return &param.err_min;
+        }
+        if (param.has_max && int_value > param.max_int) {
+            return &param.err_max;
+        }
+        if (slot) {
+            slot->int_value = int_value;
+        }
+    } else if (param.numeric == CompiledParam::NUMERIC_DOUBLE) {
+        double double_value = 0.0;
+        if (!parseDoubleSlice(value, double_value)) {
+            return &param.err_type;
+        }
+        if (param.has_min && double_value < param.min_double) {
+            return &param.err_min;
+        }
+        if (param.has_max && double_value > param.max_double) {
+            return &param.err_max;
+        }
+        if (slot) {
+            slot->double_value = double_value;
+        }
+    } else if (param.boolean) {
+        bool bool_value = false;
+        if (ParamValue::parseBool(value, bool_value) != ParamValue::Error::NONE) {
+            return &param.err_type;
+        }
+        if (slot) {
+            slot->bool_value = bool_value;
+        }
+    }
+    if (slot) {
+        slot->text = value;
+    }
+    
+    if (!param.enum_set.empty()) {
+        uint64_t hash = hashSlice(value.data, value.size);
+        auto it = std::lower_bound(param.enum_set.begin(), param.enum_set.end(),
+                                   std::make_pair(hash, std::string()));
+        bool found = false;
+        for (; it != param.enum_set.end() && it->first == hash; ++it) {
+            if (value.equals(it->second.data(), it->second.size())) {
+                found = true;
+                break;
+            }
+        }
+        if (!found) {
+            return &param.err_enum;
+        }
+    }
+    
+    if ((param.has_min_length && value.size < param.min_length) ||
+        (param.has_max_length && value.size > param.max_length)) {
+        return &param.err_length;
+    }
+    
+    if (param.has_pattern && !param.pattern.matches(value.data, value.size)) {
+        return &param.err_pattern;
+    }
+    
+    return nullptr;
+}
+
+// 一条路由的验证程序：路径参数和查询参数分开编译
+struct ParamValidatorProgram {
+    std::vector<CompiledParam> path;
+    std::vector<CompiledParam> query;
+    bool has_defaults;
+    size_t bound_count;
+    
+    ParamValidatorProgram() : has_defaults(false), bound_count(0) {}
+    
+    static std::shared_ptr<const ParamValidatorProgram> compile(const std::vector<ParamDefinition>& params) {
+        std::shared_ptr<ParamValidatorProgram> program(new ParamValidatorProgram());
+        for (const auto& def : params) {
+            CompiledParam param = compileParam(def, def.type == ParamType::PATH ? "Path" : "Query");
+            if (def.bind) {
+                if (program->bound_count < BoundParams::kMaxSlots) {
+                    param.slot = static_cast<int>(program->bound_count++);
+                } else {
+                    std::cerr << "Warning: more than " << BoundParams::kMaxSlots
+                              << " typed parameters; '" << def.name << "' is validated but not bound" << std::endl;
+                }
+            }
+            if (def.type == ParamType::PATH) {
+                program->path.push_back(param);
+            } else if (def.type == ParamType::QUERY) {
+                program->query.push_back(param);
+            }
+            if (!def.validation.required && !def.default_value.empty()) {
+                program->has_defaults = true;
+            }
+        }
+        return program;
+    }
+    
+    bool empty() const { return path.empty() && query.empty(); }
+};
+
+// 在一张参数表上运行检查项；Lookup 返回切片，Apply 写入默认值，
+// bound 非空时绑定参数写入 BoundParams（默认值也只写入槽位）
+template<typename Lookup, typename Apply>
+const std::string* runParamChecks(const std::vector<CompiledParam>& checks, Lookup lookup, Apply apply,
+                                  BoundParams* bound = nullptr) {
+    for (const auto& param : checks) {
+        BoundParams::Slot* slot = bound && param.slot >= 0 ? bound->slot(static_cast<size_t>(param.slot), &param.name)
+                                                           : nullptr;
+        StringSlice value = lookup(param.name);
+        if (!value.valid() || value.empty()) {
+            if (param.required) {
+                return &param.err_required;
+            }
+            if (param.default_value.empty()) {
+                if (slot) {
+                    slot->name = nullptr;  // 缺失：get() 返回调用方的缺省值
+                }
+                continue;
+            }
+            // 应用默认值（默认值同样经过验证）
+            if (!slot) {
+                apply(param);
+            }
+            value = param.default_value;
+        }
+        const std::string* error = runParamCheck(param, value, slot);
+        if (error) {
+            return error;
+        }
+    }
+    return nullptr;
+}
+
+// 验证完整请求的路径和查询参数，失败时返回错误信息；
+// 只有确实需要写入默认值时才复制请求到 modified_req（写时复制）
+const std::string* checkRequestParams(const ParamValidatorProgram& program, const HttpRequest& req,
+                                      std::unique_ptr<HttpRequest>& modified_req, BoundParams* bound = nullptr) {
+    auto lookupIn = [&req, &modified_req](bool path_table, const std::string& name) -> StringSlice {
+        const HttpRequest& current = modified_req ? *modified_req : req;
+        const std::map<std::string, std::string>& table = path_table ? current.path_params : current.query_params;
+        auto it = table.find(name);
+        return it != table.end() ? StringSlice(it->second) : StringSlice();
+    };
+    auto applyTo = [&req, &modified_req](bool path_table, const CompiledParam& p) {
+        if (!modified_req) {
+            modified_req.reset(new HttpRequest(req));
+        }
+        (path_table ? modified_req->path_params : modified_req->query_params)[p.name] = p.default_value;
+    };
+    
+    metrics::PhaseTimer timer(metrics::Phase::VALIDATION);
+    const std::string* error = runParamChecks(program.path,
+        [&lookupIn](const std::string& name) { return lookupIn(true, name); },
+        [&applyTo](const CompiledParam& p) { applyTo(true, p); }, bound);
+    if (!error) {
+        error = runParamChecks(program.query,
+            [&lookupIn](const std::string& name) { return lookupIn(false, name); },
+            [&applyTo](const CompiledParam& p) { applyTo(false, p); }, bound);
+    }
+    return error;
+}
+
+} // namespace
+
 void RouteBuilder::register_() {
+    registerHandler();
+    if (api_ && route_.max_body_size > 0) {
+        api_->getServer()->setRouteBodyLimit(route_.path, route_.method, route_.max_body_size);
+    }
+    if (api_ && cache_policy_) {
+        api_->getServer()->enableRouteCache(route_.path, route_.method, *cache_policy_);
+    }
+    if (api_ && rate_policy_) {
+        api_->getServer()->enableRouteRateLimit(route_.path, route_.method, *rate_policy_);
+    }
+    if (api_) {
+        for (size_t i = 0; i < middleware_.size(); i++) {
+            api_->getServer()->useRoute(route_.path, route_.method, middleware_[i]);
+        }
+    }
+}
+
+void RouteBuilder::registerHandler() {
     // 将路由注册到 API
     if (api_) {
         std::string path = route_.path;
         HttpMethod method = route_.method;
-        RequestHandler handler = route_.handler;
-        std::vector<ParamDefinition> path_params = param_group_.getParams();
-        std::vector<ParamDefinition> query_params = param_group_.getParams();
+        std::shared_ptr<const ParamValidatorProgram> program =
+            ParamValidatorProgram::compile(param_group_.getParams());
         
-        // 创建包装的处理器，执行参数验证并应用默认值
-        RequestHandler wrapped_handler = [handler, path_params, query_params](const HttpRequest& req) -> HttpResponse {
-            // 创建可修改的请求副本
-            HttpRequest modified_req = req;
+        if (route_.view_handler) {
+            if (route_.offload) {
+                std::cerr << "Warning: Route " << path << " uses a view handler; offload() is ignored" << std::endl;
+            }
+            RequestViewHandler handler = route_.view_handler;
+            if (program->empty()) {
+                api_->getServer()->addViewRoute(path, method, handler);
+                return;
+            }
             
-            // 验证路径参数并应用默认值
-            for (const auto& param : path_params) {
-                auto it = modified_req.path_params.find(param.name);
-                
-                // 如果参数不存在且不是必填的，应用默认值
-                if (it == modified_req.path_params.end() || it->second.empty()) {
-                    if (param.validation.required) {
-                        return HttpResponse(400).json(
-                            "{\"code\":\"400\",\"message\":\"Path parameter '" + param.name + "' is required\"}"
-                        );
-                    } else if (!param.default_value.empty()) {
-                        // 应用默认值
-                        modified_req.path_params[param.name] = param.default_value;
+            // 零拷贝处理器：默认值写入 overlay，切片直接指向验证程序持有的字符串
+            RequestViewHandler wrapped_handler = [handler, program](const HttpRequestView& req) -> HttpResponse {
+                if (!program->has_defaults) {
+                    const std::string* error = nullptr;
+                    {
+                        metrics::PhaseTimer timer(metrics::Phase::VALIDATION);
+                        error = runParamChecks(program->path,
+                            [&req](const std::string& name) { return req.path_params.get(name); },
+                            [](const CompiledParam&) {});
+                        if (!error) {
+                            error = runParamChecks(program->query,
+                                [&req](const std::string& name) { return req.query_params.get(name); },
+                                [](const CompiledParam&) {});
+                        }
                     }
+                    if (error) {
+                        return HttpResponse(400).json(*error);
+                    }
+                    return handler(req);
                 }
                 
-                // 执行验证
-                it = modified_req.path_params.find(param.name);
-                if (it != modified_req.path_params.end()) {
-                    const std::string& value = it->second;
-                    
-                    // 整数范围验证
-                    if (param.validation.has_min || param.validation.has_max) {
-                        char* endptr = nullptr;
-                        errno = 0;
-                        long int_value = strtol(value.c_str(), &endptr, 10);
-                        if (endptr == value.c_str() || *endptr != '\0' || errno == ERANGE) {
-                            return HttpResponse(400).json(
-                                "{\"code\":\"400\",\"message\":\"Path parameter '" + param.name + "' must be an integer\"}"
-                            );
-                        }
-                        // 检查是否在 int 范围内
-                        if (int_value < INT_MIN || int_value > INT_MAX) {
-                            return HttpResponse(400).json(
-                                "{\"code\":\"400\",\"message\":\"Path parameter '" + param.name + "' value is out of range\"}"
-                            );
-                        }
-                        int checked_value = static_cast<int>(int_value);
-                        if (param.validation.has_min && checked_value < param.validation.min_value) {
-                            return HttpResponse(400).json(
-                                "{\"code\":\"400\",\"message\":\"Path parameter '" + param.name + "' must be at least " + std::to_string(param.validation.min_value) + "\"}"
-                            );
-                        }
-                        if (param.validation.has_max && checked_value > param.validation.max_value) {
-                            return HttpResponse(400).json(
-                                "{\"code\":\"400\",\"message\":\"Path parameter '" + param.name + "' must be at most " + std::to_string(param.validation.max_value) + "\"}"
-                            );
-                        }
+                HttpRequestView layered = HttpRequestView::overlayOf(req);
+                const std::string* error = nullptr;
+                {
+                    metrics::PhaseTimer timer(metrics::Phase::VALIDATION);
+                    error = runParamChecks(program->path,
+                        [&layered](const std::string& name) { return layered.path_params.get(name); },
+                        [&layered](const CompiledParam& p) { layered.path_params.set(p.name, p.default_value); });
+                    if (!error) {
+                        error = runParamChecks(program->query,
+                            [&layered](const std::string& name) { return layered.query_params.get(name); },
+                            [&layered](const CompiledParam& p) { layered.query_params.set(p.name, p.default_value); });
                     }
                 }
+                if (error) {
+                    return HttpResponse(400).json(*error);
+                }
+                return handler(layered);
+            };
+            
+            api_->getServer()->addViewRoute(path, method, wrapped_handler);
+            return;
+        }
+        
+        if (route_.stream_handler) {
+            BodyStreamHandler handler = route_.stream_handler;
+            if (program->empty()) {
+                api_->getServer()->addStreamRoute(path, method, handler, route_.timeout);
+                return;
             }
             
-            // 验证查询参数并应用默认值
-            for (const auto& param : query_params) {
-                auto it = modified_req.query_params.find(param.name);
-                
-                // 如果参数不存在且不是必填的，应用默认值
-                if (it == modified_req.query_params.end() || it->second.empty()) {
-                    if (param.validation.required) {
-                        return HttpResponse(400).json(
-                            "{\"code\":\"400\",\"message\":\"Query parameter '" + param.name + "' is required\"}"
-                        );
-                    } else if (!param.default_value.empty()) {
-                        // 应用默认值
-                        modified_req.query_params[param.name] = param.default_value;
-                    }
+            // 参数验证失败时不投递请求体
+            BodyStreamHandler wrapped_handler = [handler, program](const HttpRequest& req, BodyStream body,
+                                                                   Responder responder) {
+                std::unique_ptr<HttpRequest> modified_req;
+                const std::string* error = checkRequestParams(*program, req, modified_req);
+                if (error) {
+                    responder.send(HttpResponse(400).json(*error));
+                    return;
                 }
-                
-                // 执行验证
-                it = modified_req.query_params.find(param.name);
-                if (it != modified_req.query_params.end()) {
-                    const std::string& value = it->second;
-                    
-                    // 整数范围验证
-                    if (param.validation.has_min || param.validation.has_max) {
-                        char* endptr = nullptr;
-                        errno = 0;
-                        long int_value = strtol(value.c_str(), &endptr, 10);
-                        if (endptr == value.c_str() || *endptr != '\0' || errno == ERANGE) {
-                            return HttpResponse(400).json(
-                                "{\"code\":\"400\",\"message\":\"Query parameter '" + param.name + "' must be an integer\"}"
-                            );
-                        }
-                        // 检查是否在 int 范围内
-                        if (int_value < INT_MIN || int_value > INT_MAX) {
-                            return HttpResponse(400).json(
-                                "{\"code\":\"400\",\"message\":\"Query parameter '" + param.name + "' value is out of range\"}"
-                            );
-                        }
-                        int checked_value = static_cast<int>(int_value);
-                        if (param.validation.has_min && checked_value < param.validation.min_value) {
-                            return HttpResponse(400).json(
-                                "{\"code\":\"400\",\"message\":\"Query parameter '" + param.name + "' must be at least " + std::to_string(param.validation.min_value) + "\"}"
-                            );
-                        }
-                        if (param.validation.has_max && checked_value > param.validation.max_value) {
-                            return HttpResponse(400).json(
-                                "{\"code\":\"400\",\"message\":\"Query parameter '" + param.name + "' must be at most " + std::to_string(param.validation.max_value) + "\"}"
-                            );
-                        }
-                    }
-                    
-                    // 浮点数范围验证
-                    if (param.validation.has_min || param.validation.has_max) {
-                        char* endptr = nullptr;
-                        errno = 0;
-                        double double_value = strtod(value.c_str(), &endptr);
-                        if (endptr == value.c_str() || *endptr != '\0' || errno == ERANGE) {
-                            return HttpResponse(400).json(
-                                "{\"code\":\"400\",\"message\":\"Query parameter '" + param.name + "' must be a number\"}"
-                            );
-                        }
-                        if (param.validation.has_min && double_value < param.validation.min_double) {
-                            return HttpResponse(400).json(
-                                "{\"code\":\"400\",\"message\":\"Query parameter '" + param.name + "' must be at least " + std::to_string(param.validation.min_double) + "\"}"
-                            );
-                        }
-                        if (param.validation.has_max && double_value > param.validation.max_double) {
-                            return HttpResponse(400).json(
-                                "{\"code\":\"400\",\"message\":\"Query parameter '" + param.name + "' must be at most " + std::to_string(param.validation.max_double) + "\"}"
-                            );
-                        }
-                    }
-                    
-                    // 枚举值验证
-                    if (param.validation.has_enum) {
-                        bool found = false;
-                        for (const auto& enum_val : param.validation.enum_values) {
-                            if (enum_val == value) {
-                                found = true;
-                                break;
-                            }
-                        }
-                        if (!found) {
-                            return HttpResponse(400).json(
-                                "{\"code\":\"400\",\"message\":\"Query parameter '" + param.name + "' has invalid value\"}"
-                            );
-                        }
-                    }
+                if (!modified_req) {
+                    handler(req, body, responder);
+                    return;
+                }
+                std::shared_ptr<const HttpRequest> owned(modified_req.release());
+                responder.keepAlive(owned);
+                handler(*owned, body, responder);
+            };
+            api_->getServer()->addStreamRoute(path, method, wrapped_handler, route_.timeout);
+            return;
+        }
+        
+        if (route_.async_handler) {
+            AsyncHandler handler = route_.async_handler;
+            if (program->empty()) {
+                api_->getServer()->addAsyncRoute(path, method, handler, route_.timeout);
+                return;
+            }
+            
+            // 验证失败直接完成响应；写入了默认值时，修改后的请求交给 Responder 持有
+            AsyncHandler wrapped_handler = [handler, program](const HttpRequest& req, Responder responder) {
+                std::unique_ptr<HttpRequest> modified_req;
+                const std::string* error = checkRequestParams(*program, req, modified_req);
+                if (error) {
+                    responder.send(HttpResponse(400).json(*error));
+                    return;
                 }
+                if (!modified_req) {
+                    handler(req, responder);
+                    return;
+                }
+                std::shared_ptr<const HttpRequest> owned(modified_req.release());
+                responder.keepAlive(owned);
+                handler(*owned, responder);
+            };
+            api_->getServer()->addAsyncRoute(path, method, wrapped_handler, route_.timeout);
+            return;
+        }
+        
+        if (route_.bound_handler) {
+            // 类型化参数在验证时解析进栈上的 BoundParams，处理器直接读取
+            BoundRequestHandler handler = route_.bound_handler;
+            RequestHandler wrapped_handler = [handler, program](const HttpRequest& req) -> HttpResponse {
+                BoundParams bound;
+                std::unique_ptr<HttpRequest> modified_req;
+                const std::string* error = checkRequestParams(*program, req, modified_req, &bound);
+                if (error) {
+                    return HttpResponse(400).json(*error);
+                }
+                return handler(modified_req ? *modified_req : req, bound);
+            };
+            if (route_.offload) {
+                api_->getServer()->addOffloadRoute(path, method, wrapped_handler, route_.timeout);
+            } else {
+                api_->getServer()->addRoute(path, method, wrapped_handler);
+            }
+            return;
+        }
+        
+        RequestHandler handler = route_.handler;
+        if (program->empty()) {
+            if (route_.offload) {
+                api_->getServer()->addOffloadRoute(path, method, handler, route_.timeout);
+            } else {
+                api_->getServer()->addRoute(path, method, handler);
+            }
+            return;
+        }
+        
+        // 创建包装的处理器，执行参数验证并应用默认值
+        RequestHandler wrapped_handler = [handler, program](const HttpRequest& req) -> HttpResponse {
+            std::unique_ptr<HttpRequest> modified_req;
+            const std::string* error = checkRequestParams(*program, req, modified_req);
+            if (error) {
+                return HttpResponse(400).json(*error);
             }
             
-            // 调用原始处理器（传入修改后的请求）
-            return handler(modified_req);
+            // 调用原始处理器（需要默认值时传入修改后的请求）
+            return handler(modified_req ? *modified_req : req);
         };
         
-        // 注册路由
-        api_->getServer()->addRoute(path, method, wrapped_handler);
+        // 注册路由（offload 时参数验证同样在池线程中执行）
+        if (route_.offload) {
+            api_->getServer()->addOffloadRoute(path, method, wrapped_handler, route_.timeout);
+        } else {
+            api_->getServer()->addRoute(path, method, wrapped_handler);
+        }
     }
 }
 
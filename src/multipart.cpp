@@ -8,24 +8,54 @@
 #include <algorithm>
 #include <cstring>
 #include <cctype>
+#include <cstdlib>
+#include <unistd.h>
 
 namespace uvapi {
 
 // ========== MultipartParser 实现 ==========
 
 MultipartParser::MultipartParser(const std::string& boundary)
-    : boundary_(boundary)
-    , config_(UploadConfig::defaultConfig())
-    , total_uploaded_size_(0) {
+    : MultipartParser(boundary, UploadConfig::defaultConfig()) {
 }
 
 MultipartParser::MultipartParser(const std::string& boundary, const UploadConfig& config)
     : boundary_(boundary)
+    , delimiter_("\r\n--" + boundary)
     , config_(config)
-    , total_uploaded_size_(0) {
+    , total_uploaded_size_(0)
+    , total_bytes_(0)
+    , state_(State::BODY)
+    , header_line_start_(0)
+    , part_kind_(PartKind::NONE)
+    , spill_fp_(nullptr) {
+    // Horspool 跳转表：按窗口最后一个字节决定右移距离
+    const size_t m = delimiter_.size();
+    for (size_t i = 0; i < 256; i++) {
+        skip_[i] = m;
+    }
+    for (size_t i = 0; i + 1 < m; i++) {
+        skip_[static_cast<unsigned char>(delimiter_[i])] = m - 1 - i;
+    }
+    reset();
 }
 
 MultipartParser::~MultipartParser() {
+    discardPart();
+}
+
+void MultipartParser::reset() {
+    discardPart();
+    fields_.clear();
+    files_.clear();
+    total_uploaded_size_ = 0;
+    total_bytes_ = 0;
+    state_ = State::BODY;
+    // 虚拟的前导 CRLF：使位于开头的第一个分隔符（没有前置 CRLF）也能被匹配
+    pending_.assign("\r\n", 2);
+    header_buf_.clear();
+    header_line_start_ = 0;
+    error_.clear();
 }
 
 bool MultipartParser::parse(const char* data, size_t size) {
@@ -36,128 +66,340 @@ bool MultipartParser::parse(const char* data, size_t size) {
         return false;
     }
     
-    std::string boundary_line = "--" + boundary_;
-    std::string end_boundary = "--" + boundary_ + "--";
+    reset();
+    return feed(data, size) && finish();
+}
+
+bool MultipartParser::feed(const char* data, size_t size) {
+    if (state_ == State::FAILED) return false;
+    if (size == 0) return true;
+    
+    total_bytes_ += size;
+    if (total_bytes_ > config_.max_total_size) {
+        return fail("Upload exceeds maximum total size");
+    }
     
-    std::string content(data, size);
+    if (!pending_.empty()) {
+        // 上一块留下的尾部（不超过分隔符长度）：补上本块开头的字节后一起处理
+        size_t old_size = pending_.size();
+        size_t take = std::min(size, delimiter_.size());
+        pending_.append(data, take);
+        size_t used = consume(pending_.data(), pending_.size());
+        if (state_ == State::FAILED) return false;
+        if (used < old_size) {
+            // 仍无法判断是否为分隔符（本块太短，已全部并入 pending_）
+            pending_.erase(0, used);
+            return true;
+        }
+        size_t from_chunk = used - old_size;
+        pending_.clear();
+        data += from_chunk;
+        size -= from_chunk;
+    }
     
+    size_t used = consume(data, size);
+    if (state_ == State::FAILED) return false;
+    pending_.assign(data + used, size - used);
+    return true;
+}
+
+bool MultipartParser::finish() {
+    if (state_ == State::FAILED) return false;
+    if (state_ != State::DONE) {
+        return fail("Unexpected end of multipart body");
+    }
+    return true;
+}
+
+size_t MultipartParser::consume(const char* data, size_t size) {
     size_t pos = 0;
+    while (pos < size) {
+        switch (state_) {
+            case State::BODY:
+                pos += consumeBody(data + pos, size - pos);
+                if (state_ == State::BODY) {
+                    return pos;  // 剩余字节可能是分隔符前缀，等待下一块
+                }
+                break;
+                
+            case State::AFTER_DELIM: {
+                // 分隔符之后：可选的空白，然后是 CRLF（下一部分）或 "--"（结束）
+                char c = data[pos++];
+                if (c == '-') {
+                    state_ = State::CLOSE_DASH;
+                } else if (c == '\n') {
+                    state_ = State::HEADERS;
+                    header_buf_.clear();
+                    header_line_start_ = 0;
+                } else if (c != '\r' && c != ' ' && c != '\t') {
+                    fail("Malformed multipart boundary");
+                    return pos;
+                }
+                break;
+            }
+            
+            case State::CLOSE_DASH:
+                if (data[pos++] != '-') {
+                    fail("Malformed multipart boundary");
+                    return pos;
+                }
+                state_ = State::DONE;
+                break;
+                
+            case State::HEADERS:
+                pos += consumeHeaders(data + pos, size - pos);
+                break;
+                
+            case State::DONE:
+                return size;  // 忽略结束分隔符之后的内容
+                
+            case State::FAILED:
+                return pos;
+        }
+        if (state_ == State::FAILED) {
+            return pos;
+        }
+    }
+    return pos;
+}
+
+size_t MultipartParser::consumeBody(const char* data, size_t size) {
+    size_t at = findDelimiter(data, size);
+    if (at != std::string::npos) {
+        // endPart 失败（如临时文件写回失败）时已进入 FAILED，不能覆盖
+        if (appendPartData(data, at) && endPart()) {
+            state_ = State::AFTER_DELIM;
+        }
+        return at + delimiter_.size();
+    }
     
-    // 跳过第一个 boundary
-    pos = content.find(boundary_line);
-    if (pos == std::string::npos) return false;
-    pos += boundary_line.length();
-    
-    // 跳过 CRLF
-    if (pos < content.size() && content[pos] == '\r') pos++;
-    if (pos < content.size() && content[pos] == '\n') pos++;
-    
-    while (pos < content.size()) {
-        // 查找下一个 boundary
-        size_t next_boundary = content.find(boundary_line, pos);
-        if (next_boundary == std::string::npos) {
-            // 检查是否是结束 boundary
-            next_boundary = content.find(end_boundary, pos);
-            if (next_boundary == std::string::npos) return false;
+    size_t keep = partialDelimiterSuffix(data, size);
+    appendPartData(data, size - keep);
+    return size - keep;
+}
+
+size_t MultipartParser::consumeHeaders(const char* data, size_t size) {
+    size_t pos = 0;
+    while (pos < size) {
+        const void* nl = std::memchr(data + pos, '\n', size - pos);
+        size_t end = nl ? static_cast<size_t>(static_cast<const char*>(nl) - data) + 1 : size;
+        header_buf_.append(data + pos, end - pos);
+        pos = end;
+        if (header_buf_.size() > config_.max_header_size) {
+            fail("Multipart part headers too large");
+            return pos;
         }
-        
-        // 提取 part 数据
-        std::string part = content.substr(pos, next_boundary - pos);
-        
-        // 移除末尾的 CRLF
-        if (!part.empty() && part.back() == '\n') part.pop_back();
-        if (!part.empty() && part.back() == '\r') part.pop_back();
-        
-        // 解析 part
-        parsePart(part);
-        
-        // 移动到下一个 part
-        pos = next_boundary + boundary_line.length();
-        
-        // 检查是否是结束 boundary
-        if (pos + 2 <= content.size() && content[pos] == '-' && content[pos + 1] == '-') {
+        if (!nl) {
             break;
         }
         
-        // 跳过 CRLF
-        if (pos < content.size() && content[pos] == '\r') pos++;
-        if (pos < content.size() && content[pos] == '\n') pos++;
+        // 空行（"\r\n" 或 "\n"）结束头部
+        size_t line_len = header_buf_.size() - header_line_start_;
+        if (line_len == 1 || (line_len == 2 && header_buf_[header_line_start_] == '\r')) {
+            header_buf_.resize(header_line_start_);
+            if (beginPart()) {
+                state_ = State::BODY;
+            }
+            return pos;
+        }
+        header_line_start_ = header_buf_.size();
     }
-    
-    return true;
+    return pos;
 }
 
-bool MultipartParser::parsePart(const std::string& part) {
-    if (part.empty()) return false;
-    
-    // 分离头部和主体
-    size_t header_end = part.find("\r\n\r\n");
-    if (header_end == std::string::npos) {
-        header_end = part.find("\n\n");
-        if (header_end == std::string::npos) return false;
+size_t MultipartParser::findDelimiter(const char* data, size_t size) const {
+    const size_t m = delimiter_.size();
+    if (size < m) return std::string::npos;
+    
+    const char* d = delimiter_.data();
+    const char last = d[m - 1];
+    size_t i = 0;
+    while (i <= size - m) {
+        char c = data[i + m - 1];
+        if (c == last && std::memcmp(data + i, d, m - 1) == 0) {
+            return i;
+        }
+        i += skip_[static_cast<unsigned char>(c)];
     }
+    return std::string::npos;
+}
+
+size_t MultipartParser::partialDelimiterSuffix(const char* data, size_t size) const {
+    // 最长的、同时是分隔符前缀的尾部（分隔符以 '\r' 开头）
+    size_t max_len = std::min(size, delimiter_.size() - 1);
+    for (size_t k = max_len; k > 0; k--) {
+        const char* tail = data + size - k;
+        if (*tail == '\r' && std::memcmp(tail, delimiter_.data(), k) == 0) {
+            return k;
+        }
+    }
+    return 0;
+}
+
+bool MultipartParser::beginPart() {
+    part_kind_ = PartKind::NONE;
     
-    std::string headers = part.substr(0, header_end);
-    std::string body = part.substr(header_end + 4); // +4 跳过 \r\n\r\n
-    
-    // 检查是否是文件上传
-    std::string content_disposition = extractHeaderValue(headers, "Content-Disposition");
-    
-    if (content_disposition.empty()) return false;
+    std::string content_disposition = extractHeaderValue(header_buf_, "Content-Disposition");
+    if (content_disposition.empty()) return true;  // 跳过无法识别的部分
     
     // 提取字段名
     size_t name_pos = content_disposition.find("name=\"");
-    if (name_pos == std::string::npos) return false;
+    if (name_pos == std::string::npos) return true;
     name_pos += 6; // name=" 的长度
     
     size_t name_end = content_disposition.find("\"", name_pos);
-    if (name_end == std::string::npos) return false;
+    if (name_end == std::string::npos) return true;
     
-    std::string field_name = content_disposition.substr(name_pos, name_end - name_pos);
+    part_name_ = content_disposition.substr(name_pos, name_end - name_pos);
     
     // 检查是否有 filename
     std::string filename = extractFilename(content_disposition);
-    std::string content_type = extractHeaderValue(headers, "Content-Type");
-    
-    if (!filename.empty()) {
-        // 文件上传
-        UploadedFile file;
-        file.field_name = field_name;
-        file.filename = filename;
-        file.content_type = content_type;
-        file.data.assign(body.begin(), body.end());
-        file.size = body.size();
-        
-        // 验证文件
-        UploadValidationResult validation = validateFile(filename, content_type, file.size);
-        if (!validation.valid) {
-            // 跳过无效文件
-            return false;
+    if (filename.empty()) {
+        // 普通字段
+        part_kind_ = PartKind::FIELD;
+        field_value_.clear();
+        return true;
+    }
+    
+    // 文件上传：类型和扩展名在读取数据前验证，大小在读取过程中验证
+    std::string content_type = extractHeaderValue(header_buf_, "Content-Type");
+    UploadValidationResult validation = validateFile(filename, content_type, 0);
+    if (!validation.valid) {
+        // 跳过无效文件
+        return true;
+    }
+    
+    part_kind_ = PartKind::FILE;
+    file_ = UploadedFile();
+    file_.field_name = part_name_;
+    file_.filename = filename;
+    file_.content_type = content_type;
+    return true;
+}
+
+bool MultipartParser::appendPartData(const char* data, size_t size) {
+    if (size == 0 || part_kind_ == PartKind::NONE) return true;
+    
+    if (part_kind_ == PartKind::FIELD) {
+        if (field_value_.size() + size > config_.max_field_size) {
+            return fail("Field '" + part_name_ + "' exceeds maximum size");
         }
+        field_value_.append(data, size);
+        return true;
+    }
+    
+    file_.size += size;
+    if (file_.size > config_.max_file_size) {
+        if (file_data_callback_) {
+            // 调用方已经收到部分数据，不能静默跳过
+            return fail("File size exceeds maximum limit of " +
+                std::to_string(config_.max_file_size / 1024 / 1024) + "MB");
+        }
+        // 跳过过大的文件
+        discardPart();
+        return true;
+    }
+    
+    if (file_data_callback_) {
+        if (!file_data_callback_(file_, data, size)) {
+            return fail("Upload aborted by file data callback");
+        }
+        return true;
+    }
+    
+    if (spill_fp_) {
+        if (std::fwrite(data, 1, size, spill_fp_) != size) {
+            return fail("Failed to write upload temp file");
+        }
+        return true;
+    }
+    
+    file_.data.insert(file_.data.end(), data, data + size);
+    if (config_.spill_threshold > 0 && file_.data.size() > config_.spill_threshold) {
+        return spillFile();
+    }
+    return true;
+}
+
+bool MultipartParser::spillFile() {
+    std::string path_template = config_.temp_dir + "/uvapi-upload-XXXXXX";
+    std::vector<char> path(path_template.begin(), path_template.end());
+    path.push_back('\0');
+    
+    int fd = mkstemp(path.data());
+    if (fd < 0) {
+        return fail("Failed to create upload temp file");
+    }
+    file_.spill = std::make_shared<SpillFile>(std::string(path.data()));
+    spill_fp_ = fdopen(fd, "wb");
+    if (!spill_fp_) {
+        close(fd);
+        return fail("Failed to open upload temp file");
+    }
+    
+    if (std::fwrite(file_.data.data(), 1, file_.data.size(), spill_fp_) != file_.data.size()) {
+        return fail("Failed to write upload temp file");
+    }
+    std::vector<char>().swap(file_.data);  // 释放内存缓冲
+    return true;
+}
+
+bool MultipartParser::endPart() {
+    if (part_kind_ == PartKind::FIELD) {
+        fields_[part_name_] = field_value_;
         
+        if (field_callback_) {
+            field_callback_(part_name_, field_value_);
+        }
+    } else if (part_kind_ == PartKind::FILE) {
         // 更新总上传大小
-        total_uploaded_size_ += file.size;
+        total_uploaded_size_ += file_.size;
         if (total_uploaded_size_ > config_.max_total_size) {
-            return false;
+            discardPart();
+            return true;
         }
         
-        files_[field_name] = file;
-        
-        if (file_callback_) {
-            file_callback_(field_name, filename, content_type, file.data);
+        if (spill_fp_) {
+            bool ok = std::fclose(spill_fp_) == 0;
+            spill_fp_ = nullptr;
+            if (!ok) {
+                return fail("Failed to write upload temp file");
+            }
         }
-    } else {
-        // 普通字段
-        fields_[field_name] = body;
         
-        if (field_callback_) {
-            field_callback_(field_name, body);
+        UploadedFile& file = files_[part_name_];
+        file = std::move(file_);
+        
+        if (file_callback_) {
+            file_callback_(part_name_, file.filename, file.content_type, file.data);
         }
     }
     
+    part_kind_ = PartKind::NONE;
+    file_ = UploadedFile();
+    field_value_.clear();
     return true;
 }
 
+void MultipartParser::discardPart() {
+    if (spill_fp_) {
+        std::fclose(spill_fp_);
+        spill_fp_ = nullptr;
+    }
+    file_ = UploadedFile();  // 释放临时文件引用（最后一个引用会删除文件）
+    field_value_.clear();
+    part_kind_ = PartKind::NONE;
+}
+
+bool MultipartParser::fail(const std::string& message) {
+    if (state_ != State::FAILED) {
+        error_ = message;
+        state_ = State::FAILED;
+    }
+    discardPart();
+    return false;
+}
+
 std::string MultipartParser::extractHeaderValue(const std::string& headers, const std::string& name) {
     size_t pos = headers.find(name + ":");
     if (pos == std::string::npos) return "";
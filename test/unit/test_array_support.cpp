@@ -0,0 +1,204 @@
+/**
+ * @file test_array_support.cpp
+ * @brief 单元测试：标量数组的批量读写
+ */
+
+#include <iostream>
+#include <cassert>
+#include <cstdlib>
+#include <cmath>
+#include <string>
+#include <vector>
+#include "../../include/array_support.h"
+
+using namespace uvapi;
+using namespace uvapi::array_utils;
+
+int test_count = 0;
+int passed_count = 0;
+
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { \
+    test_count++; \
+    std::cout << "Running test: " << #name << "..."; \
+    test_##name(); \
+    std::cout << " PASSED" << std::endl; \
+    passed_count++; \
+} while(0)
+
+#define ASSERT_TRUE(expr) do { \
+    if (!(expr)) { \
+        std::cerr << "\n  FAILED: " << #expr << " is false" << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+#define ASSERT_FALSE(expr) ASSERT_TRUE(!(expr))
+
+#define ASSERT_EQ(a, b) do { \
+    if ((a) != (b)) { \
+        std::cerr << "\n  FAILED: " << #a << " != " << #b << std::endl; \
+        std::cerr << "    Expected: " << (b) << ", Got: " << (a) << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+template<typename T>
+static ArrayError readAll(const char* text, std::vector<T>& out, size_t* index = nullptr) {
+    json::Reader reader(text, std::strlen(text));
+    ArrayError error = readArray(reader, out, index);
+    if (error == ArrayError::NONE) {
+        ASSERT_TRUE(reader.finish());
+    }
+    return error;
+}
+
+template<typename T>
+static std::string writeAll(const std::vector<T>& values) {
+    std::string out;
+    json::Writer writer(out);
+    writeArray(writer, values);
+    return out;
+}
+
+// ========== 读取测试 ==========
+
+TEST(Read_Integers) {
+    std::vector<int> values;
+    ASSERT_TRUE(readAll("[1, -2, 30000, 1e3, 0]", values) == ArrayError::NONE);
+    ASSERT_EQ(values.size(), 5u);
+    ASSERT_EQ(values[1], -2);
+    ASSERT_EQ(values[3], 1000);
+    ASSERT_TRUE(values.capacity() == 5);  // 预数后一次 reserve
+
+    std::vector<int64_t> wide;
+    ASSERT_TRUE(readAll("[9223372036854775807, -9223372036854775808]", wide) == ArrayError::NONE);
+    ASSERT_EQ(wide[0], INT64_MAX);
+    ASSERT_EQ(wide[1], INT64_MIN);
+}
+
+TEST(Read_IntegerErrors) {
+    std::vector<int> values;
+    size_t index = 0;
+    ASSERT_TRUE(readAll("[1, 2, 3000000000]", values, &index) == ArrayError::OUT_OF_RANGE);
+    ASSERT_EQ(index, 2u);
+    ASSERT_TRUE(readAll("[1, 2.5]", values, &index) == ArrayError::NOT_INTEGER);
+    ASSERT_EQ(index, 1u);
+    ASSERT_TRUE(readAll("[1, \"2\"]", values, &index) == ArrayError::WRONG_TYPE);
+    ASSERT_TRUE(readAll("{\"a\":1}", values) == ArrayError::NOT_ARRAY);
+    ASSERT_TRUE(readAll("[1, 2", values) == ArrayError::SYNTAX);
+}
+
+TEST(Read_SkipRestAfterError) {
+    const char* text = "{\"a\":[1,\"x\",[3],4],\"b\":7}";
+    json::Reader reader(text, std::strlen(text));
+    StringSlice key;
+    ASSERT_TRUE(reader.beginObject());
+    ASSERT_TRUE(reader.nextMember(key));
+    std::vector<int> values;
+    ArrayError error = readArray(reader, values);
+    ASSERT_TRUE(error == ArrayError::WRONG_TYPE);
+    ASSERT_TRUE(skipRest(reader, error));
+    ASSERT_TRUE(reader.nextMember(key));
+    ASSERT_TRUE(key == StringSlice("b"));
+}
+
+TEST(Read_DoublesBoolsStrings) {
+    std::vector<double> doubles;
+    ASSERT_TRUE(readAll("[0.5, -1, 2.5e3]", doubles) == ArrayError::NONE);
+    ASSERT_EQ(doubles[2], 2500.0);
+
+    std::vector<bool> flags;
+    ASSERT_TRUE(readAll("[true, false, true]", flags) == ArrayError::NONE);
+    ASSERT_TRUE(flags.size() == 3 && flags[0] && !flags[1]);
+    ASSERT_TRUE(readAll("[true, 1]", flags) == ArrayError::WRONG_TYPE);
+
+    std::vector<std::string> strings;
+    ASSERT_TRUE(readAll("[\"a,b\", \"\\u00e9\", \"]\"]", strings) == ArrayError::NONE);
+    ASSERT_EQ(strings.size(), 3u);
+    ASSERT_EQ(strings[0], "a,b");
+    ASSERT_EQ(strings[1], "\xC3\xA9");
+    ASSERT_EQ(strings[2], "]");
+}
+
+// ========== 写出测试 ==========
+
+TEST(Write_AllElementTypes) {
+    std::vector<int64_t> ints;
+    ints.push_back(-1);
+    ints.push_back(INT64_MAX);
+    ASSERT_EQ(writeAll(ints), "[-1,9223372036854775807]");
+
+    std::vector<double> doubles;
+    doubles.push_back(0.1);
+    doubles.push_back(2.0);
+    ASSERT_EQ(writeAll(doubles), "[0.1,2]");
+
+    std::vector<bool> flags;
+    flags.push_back(true);
+    flags.push_back(false);
+    ASSERT_EQ(writeAll(flags), "[true,false]");
+
+    std::vector<std::string> strings;
+    strings.push_back("a\"b");
+    ASSERT_EQ(writeAll(strings), "[\"a\\\"b\"]");
+    ASSERT_EQ(writeAll(std::vector<int>()), "[]");
+}
+
+TEST(Write_InsideObject) {
+    std::vector<int> values;
+    values.push_back(1);
+    values.push_back(2);
+    std::string out;
+    json::Writer writer(out);
+    writer.beginObject();
+    writer.key("a");
+    writeArray(writer, values);
+    writer.key("b");
+    writer.integer(3);
+    writer.endObject();
+    ASSERT_EQ(out, "{\"a\":[1,2],\"b\":3}");
+}
+
+TEST(RoundTrip_LargeArray) {
+    std::vector<int64_t> values;
+    for (int64_t i = 0; i < 20000; ++i) {
+        values.push_back(i * 7919 - 1000000);
+    }
+    std::string json = writeAll(values);
+    std::vector<int64_t> parsed;
+    ASSERT_TRUE(readAll(json.c_str(), parsed) == ArrayError::NONE);
+    ASSERT_TRUE(parsed == values);
+}
+
+int main() {
+    std::cout << "========================================" << std::endl;
+    std::cout << "Array Support Unit Tests" << std::endl;
+    std::cout << "========================================" << std::endl << std::endl;
+
+    std::cout << "Read Tests:" << std::endl;
+    RUN_TEST(Read_Integers);
+    RUN_TEST(Read_IntegerErrors);
+    RUN_TEST(Read_SkipRestAfterError);
+    RUN_TEST(Read_DoublesBoolsStrings);
+
+    std::cout << std::endl << "Write Tests:" << std::endl;
+    RUN_TEST(Write_AllElementTypes);
+    RUN_TEST(Write_InsideObject);
+    RUN_TEST(RoundTrip_LargeArray);
+
+    std::cout << std::endl << "========================================" << std::endl;
+    std::cout << "Test Results:" << std::endl;
+    std::cout << "  Total: " << test_count << std::endl;
+    std::cout << "  Passed: " << passed_count << std::endl;
+    std::cout << "  Failed: " << (test_count - passed_count) << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    if (test_count == passed_count) {
+        std::cout << "All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "Some tests failed!" << std::endl;
+        return 1;
+    }
+}
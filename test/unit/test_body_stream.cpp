@@ -0,0 +1,192 @@
+/**
+ * @file test_body_stream.cpp
+ * @brief 单元测试：BodyFeeder 分块投递与 NdjsonSplitter 分行
+ */
+
+#include <iostream>
+#include <cassert>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "../../include/body_stream.h"
+
+using namespace uvapi;
+
+int test_count = 0;
+int passed_count = 0;
+
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { \
+    test_count++; \
+    std::cout << "Running test: " << #name << "..."; \
+    test_##name(); \
+    std::cout << " PASSED" << std::endl; \
+    passed_count++; \
+} while(0)
+
+#define ASSERT_TRUE(expr) do { \
+    if (!(expr)) { \
+        std::cerr << "\n  FAILED: " << #expr << " is false" << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+#define ASSERT_FALSE(expr) ASSERT_TRUE(!(expr))
+
+#define ASSERT_EQ(a, b) do { \
+    if ((a) != (b)) { \
+        std::cerr << "\n  FAILED: " << #a << " != " << #b << std::endl; \
+        std::cerr << "    Expected: " << (b) << ", Got: " << (a) << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+// ========== BodyFeeder ==========
+
+TEST(feeder_chunks_borrowed_buffer) {
+    std::string body = "abcdefghij";
+    BodyFeeder feeder;
+    feeder.reset(body.data(), body.size());
+    StringSlice first = feeder.next(4);
+    ASSERT_EQ(first.size, static_cast<size_t>(4));
+    ASSERT_TRUE(first.data == body.data());
+    ASSERT_EQ(feeder.next(4).toString(), std::string("efgh"));
+    ASSERT_EQ(feeder.next(4).toString(), std::string("ij"));
+    ASSERT_TRUE(feeder.done());
+    ASSERT_EQ(feeder.next(4).size, static_cast<size_t>(0));
+    ASSERT_EQ(feeder.consumed(), body.size());
+    ASSERT_FALSE(feeder.owned());
+}
+
+TEST(feeder_detach_copies_remainder) {
+    std::string body = "0123456789";
+    BodyFeeder feeder;
+    feeder.reset(body.data(), body.size());
+    feeder.next(3);
+    feeder.detach();
+    ASSERT_TRUE(feeder.owned());
+    ASSERT_EQ(feeder.consumed(), static_cast<size_t>(3));
+    ASSERT_EQ(feeder.remaining(), static_cast<size_t>(7));
+
+    // 原缓冲区失效后仍从副本继续
+    body.assign(body.size(), 'x');
+    StringSlice chunk = feeder.next(5);
+    ASSERT_EQ(chunk.toString(), std::string("34567"));
+    ASSERT_EQ(feeder.consumed(), static_cast<size_t>(8));
+    ASSERT_EQ(feeder.next(5).toString(), std::string("89"));
+    ASSERT_TRUE(feeder.done());
+}
+
+TEST(feeder_binary_safe) {
+    const char body[] = { 'a', '\0', 'b', '\0' };
+    BodyFeeder feeder;
+    feeder.reset(body, sizeof(body));
+    StringSlice chunk = feeder.next(16);
+    ASSERT_EQ(chunk.size, sizeof(body));
+    ASSERT_EQ(chunk.data[1], '\0');
+    ASSERT_EQ(chunk.data[2], 'b');
+}
+
+TEST(feeder_empty_body) {
+    BodyFeeder feeder;
+    feeder.reset(nullptr, 10);
+    ASSERT_TRUE(feeder.done());
+    feeder.detach();
+    ASSERT_FALSE(feeder.owned());
+}
+
+// ========== NdjsonSplitter ==========
+
+struct Collect {
+    std::vector<std::string>* lines;
+    bool operator()(StringSlice line) const {
+        lines->push_back(line.toString());
+        return true;
+    }
+};
+
+TEST(ndjson_splits_lines_across_chunks) {
+    std::vector<std::string> lines;
+    Collect collect = { &lines };
+    NdjsonSplitter splitter;
+    std::string first = "{\"a\":1}\n{\"b\"";
+    std::string second = ":2}\n{\"c\":3}";
+    ASSERT_TRUE(splitter.feed(first.data(), first.size(), collect));
+    ASSERT_EQ(lines.size(), static_cast<size_t>(1));
+    ASSERT_TRUE(splitter.feed(second.data(), second.size(), collect));
+    ASSERT_TRUE(splitter.finish(collect));
+    ASSERT_EQ(lines.size(), static_cast<size_t>(3));
+    ASSERT_EQ(lines[0], std::string("{\"a\":1}"));
+    ASSERT_EQ(lines[1], std::string("{\"b\":2}"));
+    ASSERT_EQ(lines[2], std::string("{\"c\":3}"));
+    ASSERT_EQ(splitter.lines(), static_cast<size_t>(3));
+}
+
+TEST(ndjson_strips_crlf_and_skips_empty) {
+    std::vector<std::string> lines;
+    Collect collect = { &lines };
+    NdjsonSplitter splitter;
+    std::string input = "one\r\n\r\n\ntwo\r\n";
+    ASSERT_TRUE(splitter.feed(input.data(), input.size(), collect));
+    ASSERT_TRUE(splitter.finish(collect));
+    ASSERT_EQ(lines.size(), static_cast<size_t>(2));
+    ASSERT_EQ(lines[0], std::string("one"));
+    ASSERT_EQ(lines[1], std::string("two"));
+}
+
+TEST(ndjson_line_limit) {
+    std::vector<std::string> lines;
+    Collect collect = { &lines };
+    NdjsonSplitter splitter(4);
+    ASSERT_TRUE(splitter.feed("abcd\nab", 7, collect));
+    ASSERT_FALSE(splitter.feed("cde", 3, collect));
+    ASSERT_EQ(splitter.error(), std::string("NDJSON line exceeds limit"));
+    // 失败后不再接受输入
+    ASSERT_FALSE(splitter.feed("x\n", 2, collect));
+    ASSERT_EQ(lines.size(), static_cast<size_t>(1));
+}
+
+bool rejectSecond(StringSlice line) {
+    return line.toString() != "bad";
+}
+
+TEST(ndjson_callback_rejects) {
+    NdjsonSplitter splitter;
+    ASSERT_FALSE(splitter.feed("ok\nbad\nok\n", 10, rejectSecond));
+    ASSERT_EQ(splitter.error(), std::string("NDJSON line rejected"));
+    ASSERT_EQ(splitter.lines(), static_cast<size_t>(2));
+    ASSERT_FALSE(splitter.finish(rejectSecond));
+}
+
+int main() {
+    std::cout << "========================================" << std::endl;
+    std::cout << "Body Stream Unit Tests" << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    std::cout << std::endl << "BodyFeeder Tests:" << std::endl;
+    RUN_TEST(feeder_chunks_borrowed_buffer);
+    RUN_TEST(feeder_detach_copies_remainder);
+    RUN_TEST(feeder_binary_safe);
+    RUN_TEST(feeder_empty_body);
+
+    std::cout << std::endl << "NdjsonSplitter Tests:" << std::endl;
+    RUN_TEST(ndjson_splits_lines_across_chunks);
+    RUN_TEST(ndjson_strips_crlf_and_skips_empty);
+    RUN_TEST(ndjson_line_limit);
+    RUN_TEST(ndjson_callback_rejects);
+
+    std::cout << std::endl << "========================================" << std::endl;
+    std::cout << "Test Results:" << std::endl;
+    std::cout << "  Total: " << test_count << std::endl;
+    std::cout << "  Passed: " << passed_count << std::endl;
+    std::cout << "  Failed: " << (test_count - passed_count) << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    if (test_count == passed_count) {
+        std::cout << "All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "Some tests failed!" << std::endl;
+        return 1;
+    }
+}
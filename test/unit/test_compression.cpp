@@ -0,0 +1,202 @@
+/**
+ * @file test_compression.cpp
+ * @brief 单元测试：响应压缩策略、编码协商与线程内压缩上下文
+ */
+
+#include <iostream>
+#include <cassert>
+#include <cstdlib>
+#include <string>
+#include "../../include/compression.h"
+
+using namespace uvapi;
+using namespace uvapi::compress;
+
+int test_count = 0;
+int passed_count = 0;
+
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { \
+    test_count++; \
+    std::cout << "Running test: " << #name << "..."; \
+    test_##name(); \
+    std::cout << " PASSED" << std::endl; \
+    passed_count++; \
+} while(0)
+
+#define ASSERT_TRUE(expr) do { \
+    if (!(expr)) { \
+        std::cerr << "\n  FAILED: " << #expr << " is false" << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+#define ASSERT_FALSE(expr) ASSERT_TRUE(!(expr))
+
+#define ASSERT_EQ(a, b) do { \
+    if ((a) != (b)) { \
+        std::cerr << "\n  FAILED: " << #a << " != " << #b << std::endl; \
+        std::cerr << "    Expected: " << (b) << ", Got: " << (a) << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+
+#if defined(UVAPI_WITH_ZLIB) || defined(UVAPI_WITH_BROTLI)
+// 重复度较高的 JSON 列表，接近列表接口的真实响应
+static std::string sampleJson(size_t items) {
+    std::string body = "[";
+    for (size_t i = 0; i < items; i++) {
+        if (i) body += ',';
+        body += "{\"id\":" + std::to_string(i) + ",\"name\":\"user" + std::to_string(i % 97) +
+                "\",\"active\":true,\"roles\":[\"reader\",\"writer\"]}";
+    }
+    body += ']';
+    return body;
+}
+#endif
+
+#ifdef UVAPI_WITH_ZLIB
+static std::string gunzip(const std::string& data) {
+    z_stream stream;
+    std::memset(&stream, 0, sizeof(stream));
+    ASSERT_EQ(inflateInit2(&stream, 15 + 16), Z_OK);
+    std::string out;
+    char buffer[16384];
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    stream.avail_in = static_cast<uInt>(data.size());
+    int rc = Z_OK;
+    while (rc == Z_OK) {
+        stream.next_out = reinterpret_cast<Bytef*>(buffer);
+        stream.avail_out = sizeof(buffer);
+        rc = inflate(&stream, Z_NO_FLUSH);
+        out.append(buffer, sizeof(buffer) - stream.avail_out);
+    }
+    inflateEnd(&stream);
+    ASSERT_EQ(rc, Z_STREAM_END);
+    return out;
+}
+#endif
+
+// ========== 策略 ==========
+
+TEST(Policy_AllowsType) {
+    CompressionPolicy policy;
+    ASSERT_TRUE(policy.allowsType(StringSlice("application/json")));
+    ASSERT_TRUE(policy.allowsType(StringSlice("application/json; charset=utf-8")));
+    ASSERT_TRUE(policy.allowsType(StringSlice("Text/HTML")));
+    ASSERT_FALSE(policy.allowsType(StringSlice("application/jsonp")));
+    ASSERT_FALSE(policy.allowsType(StringSlice("image/png")));
+    ASSERT_FALSE(policy.allowsType(StringSlice()));
+
+    CompressionPolicy custom;
+    custom.clearTypes().allowType("application/x-ndjson");
+    ASSERT_TRUE(custom.allowsType(StringSlice("application/x-ndjson")));
+    ASSERT_FALSE(custom.allowsType(StringSlice("application/json")));
+}
+
+TEST(Policy_Clamps) {
+    CompressionPolicy policy;
+    policy.gzipLevel(42).brotliQuality(-3);
+    ASSERT_EQ(policy.gzip_level, 9);
+    ASSERT_EQ(policy.brotli_quality, 0);
+}
+
+TEST(Policy_Negotiate) {
+    CompressionPolicy policy;
+    ASSERT_TRUE(negotiate(policy, StringSlice("identity")) == Encoding::IDENTITY);
+    ASSERT_TRUE(negotiate(policy, StringSlice()) == Encoding::IDENTITY);
+    if (brotliAvailable()) {
+        ASSERT_TRUE(negotiate(policy, StringSlice("gzip, br")) == Encoding::BROTLI);
+    }
+    if (gzipAvailable()) {
+        ASSERT_TRUE(negotiate(policy, StringSlice("gzip, br;q=0")) == Encoding::GZIP);
+        CompressionPolicy gzip_only;
+        gzip_only.useBrotli(false);
+        ASSERT_TRUE(negotiate(gzip_only, StringSlice("br, gzip")) == Encoding::GZIP);
+    }
+    CompressionPolicy none;
+    none.useGzip(false).useBrotli(false);
+    ASSERT_TRUE(negotiate(none, StringSlice("br, gzip")) == Encoding::IDENTITY);
+}
+
+// ========== 压缩 ==========
+
+TEST(Compress_GzipRoundTrip) {
+#ifdef UVAPI_WITH_ZLIB
+    CompressionPolicy policy;
+    std::string body = sampleJson(2000);
+    std::string out;
+    ASSERT_TRUE(compressBody(Encoding::GZIP, policy, body.data(), body.size(), out));
+    ASSERT_TRUE(out.size() < body.size() / 4);
+    ASSERT_EQ(static_cast<unsigned char>(out[0]), 0x1fu);
+    ASSERT_EQ(static_cast<unsigned char>(out[1]), 0x8bu);
+    ASSERT_TRUE(gunzip(out) == body);
+
+    // 上下文复用：同一线程连续压缩（含切换级别）结果仍然正确
+    std::string other = sampleJson(10);
+    ASSERT_TRUE(compressBody(Encoding::GZIP, policy, other.data(), other.size(), out));
+    ASSERT_TRUE(gunzip(out) == other);
+    policy.gzipLevel(1);
+    ASSERT_TRUE(compressBody(Encoding::GZIP, policy, body.data(), body.size(), out));
+    ASSERT_TRUE(gunzip(out) == body);
+#endif
+}
+
+TEST(Compress_BrotliReusesBlocks) {
+#ifdef UVAPI_WITH_BROTLI
+    CompressionPolicy policy;
+    std::string body = sampleJson(2000);
+    std::string first;
+    ASSERT_TRUE(compressBody(Encoding::BROTLI, policy, body.data(), body.size(), first));
+    ASSERT_TRUE(first.size() < body.size() / 4);
+    size_t cached = BrotliArena::forThread().cachedBytes();
+    ASSERT_TRUE(cached > 0);
+
+    // 相同参数的第二次压缩取回缓存的块，输出与第一次一致
+    std::string second;
+    ASSERT_TRUE(compressBody(Encoding::BROTLI, policy, body.data(), body.size(), second));
+    ASSERT_TRUE(second == first);
+    ASSERT_EQ(BrotliArena::forThread().cachedBytes(), cached);
+#endif
+}
+
+TEST(Compress_RejectsIncompressible) {
+    CompressionPolicy policy;
+    std::string out;
+    // 过短的内容压缩后不会变小
+    ASSERT_FALSE(compressBody(Encoding::GZIP, policy, "ab", 2, out));
+    ASSERT_FALSE(compressBody(Encoding::BROTLI, policy, "ab", 2, out));
+    ASSERT_FALSE(compressBody(Encoding::IDENTITY, policy, "abcdefgh", 8, out));
+}
+
+int main() {
+    std::cout << "========================================" << std::endl;
+    std::cout << "Compression Unit Tests" << std::endl;
+    std::cout << "========================================" << std::endl << std::endl;
+
+    std::cout << "Policy Tests:" << std::endl;
+    RUN_TEST(Policy_AllowsType);
+    RUN_TEST(Policy_Clamps);
+    RUN_TEST(Policy_Negotiate);
+
+    std::cout << std::endl << "Compress Tests:" << std::endl;
+    RUN_TEST(Compress_GzipRoundTrip);
+    RUN_TEST(Compress_BrotliReusesBlocks);
+    RUN_TEST(Compress_RejectsIncompressible);
+
+    std::cout << std::endl << "========================================" << std::endl;
+    std::cout << "Test Results:" << std::endl;
+    std::cout << "  Total: " << test_count << std::endl;
+    std::cout << "  Passed: " << passed_count << std::endl;
+    std::cout << "  Failed: " << (test_count - passed_count) << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    if (test_count == passed_count) {
+        std::cout << "All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "Some tests failed!" << std::endl;
+        return 1;
+    }
+}
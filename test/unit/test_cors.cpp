@@ -0,0 +1,207 @@
+/**
+ * @file test_cors.cpp
+ * @brief 单元测试：CORS 来源匹配与预渲染头部
+ */
+
+#include <iostream>
+#include <cassert>
+#include <cstdlib>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../../include/cors.h"
+
+using namespace uvapi;
+
+int test_count = 0;
+int passed_count = 0;
+
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { \
+    test_count++; \
+    std::cout << "Running test: " << #name << "..."; \
+    test_##name(); \
+    std::cout << " PASSED" << std::endl; \
+    passed_count++; \
+} while(0)
+
+#define ASSERT_TRUE(expr) do { \
+    if (!(expr)) { \
+        std::cerr << "\n  FAILED: " << #expr << " is false" << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+#define ASSERT_FALSE(expr) ASSERT_TRUE(!(expr))
+
+#define ASSERT_EQ(a, b) do { \
+    if ((a) != (b)) { \
+        std::cerr << "\n  FAILED: " << #a << " != " << #b << std::endl; \
+        std::cerr << "    Expected: " << (b) << ", Got: " << (a) << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+typedef std::vector<std::pair<std::string, std::string> > Emitted;
+
+static Emitted emitHeaders(const cors::CorsPolicy::Rendered& rendered, bool preflight, const std::string& origin) {
+    Emitted out;
+    cors::CorsPolicy::emit(rendered, preflight, StringSlice(origin.c_str()), [&out](const char* name, const char* value) {
+        out.push_back(std::make_pair(std::string(name), std::string(value)));
+    });
+    return out;
+}
+
+static std::string find(const Emitted& headers, const std::string& name) {
+    for (size_t i = 0; i < headers.size(); i++) {
+        if (headers[i].first == name) {
+            return headers[i].second;
+        }
+    }
+    return "<missing>";
+}
+
+// ========== 来源匹配 ==========
+
+TEST(Match_ExactOrigins) {
+    CorsConfig config;
+    config.allowed_origins = "https://app.example.com, https://Admin.Example.com";
+    cors::CorsPolicy policy(config);
+    ASSERT_TRUE(policy.match("https://app.example.com") != nullptr);
+    // 配置和请求中的大小写都不影响匹配
+    ASSERT_TRUE(policy.match("https://admin.example.com") != nullptr);
+    ASSERT_TRUE(policy.match("https://App.Example.COM") != nullptr);
+    ASSERT_TRUE(policy.match("https://evil.example.com") == nullptr);
+    ASSERT_TRUE(policy.match("http://app.example.com") == nullptr);
+    ASSERT_TRUE(policy.match(StringSlice()) == nullptr);
+}
+
+TEST(Match_SubdomainSuffix) {
+    CorsConfig config;
+    config.allowed_origins = "https://*.example.com, *.example.org:8443";
+    cors::CorsPolicy policy(config);
+    ASSERT_TRUE(policy.match("https://a.example.com") != nullptr);
+    ASSERT_TRUE(policy.match("https://a.b.example.com") != nullptr);
+    // 不匹配裸域名、其他协议和相似后缀
+    ASSERT_TRUE(policy.match("https://example.com") == nullptr);
+    ASSERT_TRUE(policy.match("http://a.example.com") == nullptr);
+    ASSERT_TRUE(policy.match("https://aexample.com") == nullptr);
+    ASSERT_TRUE(policy.match("https://a.example.com.evil.net") == nullptr);
+    // 没有协议前缀的规则接受任意协议，端口必须一致
+    ASSERT_TRUE(policy.match("http://x.example.org:8443") != nullptr);
+    ASSERT_TRUE(policy.match("https://x.example.org") == nullptr);
+}
+
+TEST(Match_Wildcard) {
+    CorsConfig config;
+    cors::CorsPolicy policy(config);
+    const cors::CorsPolicy::Rendered* rendered = policy.match("https://anything.test");
+    ASSERT_TRUE(rendered != nullptr);
+    Emitted actual = emitHeaders(*rendered, false, "https://anything.test");
+    ASSERT_EQ(find(actual, "Access-Control-Allow-Origin"), "*");
+    // 响应不随来源变化
+    ASSERT_EQ(find(actual, "Vary"), "<missing>");
+}
+
+// ========== 预渲染头部 ==========
+
+TEST(Render_PreflightForExactOrigin) {
+    CorsConfig config;
+    config.allowed_origins = "https://app.example.com";
+    config.allowed_methods = "GET, POST";
+    config.max_age = 600;
+    cors::CorsPolicy policy(config);
+    const cors::CorsPolicy::Rendered* rendered = policy.match("https://app.example.com");
+    ASSERT_TRUE(rendered != nullptr);
+    Emitted preflight = emitHeaders(*rendered, true, "https://app.example.com");
+    ASSERT_EQ(preflight[0].first, "Access-Control-Allow-Origin");
+    ASSERT_EQ(preflight[0].second, "https://app.example.com");
+    ASSERT_EQ(find(preflight, "Access-Control-Allow-Methods"), "GET, POST");
+    ASSERT_EQ(find(preflight, "Access-Control-Allow-Headers"), "Content-Type, Authorization");
+    ASSERT_EQ(find(preflight, "Access-Control-Max-Age"), "600");
+    ASSERT_EQ(find(preflight, "Vary"), "Origin");
+    ASSERT_EQ(find(preflight, "Access-Control-Allow-Credentials"), "<missing>");
+
+    // 实际请求只带允许来源相关的头部
+    Emitted actual = emitHeaders(*rendered, false, "https://app.example.com");
+    ASSERT_EQ(find(actual, "Access-Control-Allow-Methods"), "<missing>");
+    ASSERT_EQ(find(actual, "Access-Control-Max-Age"), "<missing>");
+}
+
+TEST(Match_WildcardRejectedWithCredentials) {
+    CorsConfig config;
+    config.allowed_origins = "*, https://app.example.com";
+    config.allow_credentials = true;
+    cors::CorsPolicy policy(config);
+    // "*" 被忽略，不会把任意来源回显成允许携带凭据
+    ASSERT_TRUE(policy.match("https://evil.test") == nullptr);
+    ASSERT_TRUE(policy.match("https://app.example.com") != nullptr);
+}
+
+TEST(Render_CredentialsEchoOrigin) {
+    CorsConfig config;
+    config.allowed_origins = "https://*.client.test";
+    config.allow_credentials = true;
+    config.expose_headers = "X-Request-ID";
+    cors::CorsPolicy policy(config);
+    const cors::CorsPolicy::Rendered* rendered = policy.match("https://app.client.test");
+    ASSERT_TRUE(rendered != nullptr);
+    Emitted actual = emitHeaders(*rendered, false, "https://app.client.test");
+    // 子域名规则回显请求的来源
+    ASSERT_EQ(find(actual, "Access-Control-Allow-Origin"), "https://app.client.test");
+    ASSERT_EQ(find(actual, "Access-Control-Allow-Credentials"), "true");
+    ASSERT_EQ(find(actual, "Access-Control-Expose-Headers"), "X-Request-ID");
+    ASSERT_EQ(find(actual, "Vary"), "Origin");
+}
+
+TEST(Render_NoMaxAge) {
+    CorsConfig config;
+    config.max_age = 0;
+    cors::CorsPolicy policy(config);
+    Emitted preflight = emitHeaders(*policy.match("https://a.test"), true, "https://a.test");
+    ASSERT_EQ(find(preflight, "Access-Control-Max-Age"), "<missing>");
+}
+
+TEST(Methods_CaseSensitiveList) {
+    CorsConfig config;
+    config.allowed_methods = "GET,  PATCH ,";
+    cors::CorsPolicy policy(config);
+    ASSERT_TRUE(policy.allowsMethod("GET"));
+    ASSERT_TRUE(policy.allowsMethod("PATCH"));
+    ASSERT_FALSE(policy.allowsMethod("patch"));
+    ASSERT_FALSE(policy.allowsMethod("DELETE"));
+    ASSERT_FALSE(policy.allowsMethod(""));
+}
+
+int main() {
+    std::cout << "========================================" << std::endl;
+    std::cout << "CORS Policy Unit Tests" << std::endl;
+    std::cout << "========================================" << std::endl << std::endl;
+
+    std::cout << "Origin Match Tests:" << std::endl;
+    RUN_TEST(Match_ExactOrigins);
+    RUN_TEST(Match_SubdomainSuffix);
+    RUN_TEST(Match_Wildcard);
+    RUN_TEST(Match_WildcardRejectedWithCredentials);
+
+    std::cout << std::endl << "Rendered Header Tests:" << std::endl;
+    RUN_TEST(Render_PreflightForExactOrigin);
+    RUN_TEST(Render_CredentialsEchoOrigin);
+    RUN_TEST(Render_NoMaxAge);
+    RUN_TEST(Methods_CaseSensitiveList);
+
+    std::cout << std::endl << "========================================" << std::endl;
+    std::cout << "Test Results:" << std::endl;
+    std::cout << "  Total: " << test_count << std::endl;
+    std::cout << "  Passed: " << passed_count << std::endl;
+    std::cout << "  Failed: " << (test_count - passed_count) << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    if (test_count == passed_count) {
+        std::cout << "All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "Some tests failed!" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,145 @@
+/**
+ * @file test_fast_match.cpp
+ * @brief 单元测试：内置格式手写匹配器（与等价正则表达式对照）
+ */
+
+#include <iostream>
+#include <cassert>
+#include <cstdlib>
+#include <regex>
+#include <string>
+#include "../../include/fast_match.h"
+
+using namespace uvapi;
+
+int test_count = 0;
+int passed_count = 0;
+
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { \
+    test_count++; \
+    std::cout << "Running test: " << #name << "..."; \
+    test_##name(); \
+    std::cout << " PASSED" << std::endl; \
+    passed_count++; \
+} while(0)
+
+#define ASSERT_TRUE(expr) do { \
+    if (!(expr)) { \
+        std::cerr << "\n  FAILED: " << #expr << " is false" << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+#define ASSERT_FALSE(expr) ASSERT_TRUE(!(expr))
+
+#define ASSERT_EQ(a, b) do { \
+    if ((a) != (b)) { \
+        std::cerr << "\n  FAILED: " << #a << " != " << #b << std::endl; \
+        std::cerr << "    Expected: " << (b) << ", Got: " << (a) << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+// 手写匹配器与原正则在同一组输入上的结果必须一致
+static void expectSameAsRegex(fastmatch::Matcher matcher, const char* pattern,
+                              const char* const* inputs, size_t count) {
+    std::regex re(pattern);
+    for (size_t i = 0; i < count; i++) {
+        std::string input(inputs[i]);
+        bool expected = std::regex_match(input, re);
+        bool actual = matcher(input.data(), input.size());
+        if (expected != actual) {
+            std::cerr << "\n  FAILED: mismatch on \"" << input << "\"" << std::endl;
+            exit(1);
+        }
+    }
+}
+
+// ========== 与正则对照 ==========
+
+TEST(Email_MatchesRegex) {
+    static const char* const inputs[] = {
+        "user@example.com", "a.b+c@sub.example.org", "x@y.co", "x@y.c", "@example.com",
+        "user@", "user@example", "user@.com", "user@ex_ample.com", "us er@example.com",
+        "user@example.c0m", "user@@example.com", "user@a.b.cd", "", "u%1@d-1.io"
+    };
+    const char* pattern = "^[a-zA-Z0-9._%+-]+@[a-zA-Z0-9.-]+\\.[a-zA-Z]{2,}$";
+    ASSERT_TRUE(fastmatch::matcherFor(pattern) == fastmatch::isEmail);
+    expectSameAsRegex(fastmatch::isEmail, pattern, inputs, sizeof(inputs) / sizeof(inputs[0]));
+}
+
+TEST(Uuid_MatchesRegex) {
+    static const char* const inputs[] = {
+        "123e4567-e89b-12d3-a456-426614174000", "123E4567-E89B-12D3-A456-426614174000",
+        "123e4567e89b12d3a456426614174000", "123e4567-e89b-12d3-a456-42661417400",
+        "123e4567-e89b-12d3-a456-4266141740000", "g23e4567-e89b-12d3-a456-426614174000", ""
+    };
+    const char* pattern = "^[0-9a-fA-F]{8}-[0-9a-fA-F]{4}-[0-9a-fA-F]{4}-[0-9a-fA-F]{4}-[0-9a-fA-F]{12}$";
+    ASSERT_TRUE(fastmatch::matcherFor(pattern) == fastmatch::isUuid);
+    expectSameAsRegex(fastmatch::isUuid, pattern, inputs, sizeof(inputs) / sizeof(inputs[0]));
+}
+
+TEST(Ipv4_MatchesRegex) {
+    static const char* const inputs[] = {
+        "0.0.0.0", "127.0.0.1", "255.255.255.255", "256.0.0.1", "01.2.3.4", "1.2.3",
+        "1.2.3.4.5", "1..2.3", "a.b.c.d", "1.2.3.4 ", "199.249.10.100", ""
+    };
+    const char* pattern =
+        "^(?:(?:25[0-5]|2[0-4]\\d|1\\d\\d|[1-9]?\\d)\\.){3}(?:25[0-5]|2[0-4]\\d|1\\d\\d|[1-9]?\\d)$";
+    ASSERT_TRUE(fastmatch::matcherFor(pattern) == fastmatch::isIpv4);
+    expectSameAsRegex(fastmatch::isIpv4, pattern, inputs, sizeof(inputs) / sizeof(inputs[0]));
+}
+
+TEST(UnknownPattern_NoMatcher) {
+    ASSERT_TRUE(fastmatch::matcherFor("^[a-z]+$") == nullptr);
+}
+
+// ========== 日期 ==========
+
+TEST(Date_Values) {
+    ASSERT_TRUE(fastmatch::isDate("2024-02-29", 10));
+    ASSERT_FALSE(fastmatch::isDate("2023-02-29", 10));
+    ASSERT_FALSE(fastmatch::isDate("2023-13-01", 10));
+    ASSERT_FALSE(fastmatch::isDate("2023-04-31", 10));
+    ASSERT_TRUE(fastmatch::hasDateShape("2023-04-31", 10));
+    ASSERT_FALSE(fastmatch::hasDateShape("2023/04/30", 10));
+}
+
+TEST(Datetime_Values) {
+    ASSERT_TRUE(fastmatch::isDatetime("2024-01-01 23:59:59", 19));
+    ASSERT_FALSE(fastmatch::isDatetime("2024-01-01 24:00:00", 19));
+    ASSERT_TRUE(fastmatch::hasDatetimeShape("2024-01-01 24:00:00", 19));
+    ASSERT_FALSE(fastmatch::hasDatetimeShape("2024-01-01T12:00:00", 19));
+}
+
+int main() {
+    std::cout << "========================================" << std::endl;
+    std::cout << "Fast Matcher Unit Tests" << std::endl;
+    std::cout << "========================================" << std::endl << std::endl;
+
+    std::cout << "Regex Equivalence Tests:" << std::endl;
+    RUN_TEST(Email_MatchesRegex);
+    RUN_TEST(Uuid_MatchesRegex);
+    RUN_TEST(Ipv4_MatchesRegex);
+    RUN_TEST(UnknownPattern_NoMatcher);
+
+    std::cout << std::endl << "Date Tests:" << std::endl;
+    RUN_TEST(Date_Values);
+    RUN_TEST(Datetime_Values);
+
+    std::cout << std::endl << "========================================" << std::endl;
+    std::cout << "Test Results:" << std::endl;
+    std::cout << "  Total: " << test_count << std::endl;
+    std::cout << "  Passed: " << passed_count << std::endl;
+    std::cout << "  Failed: " << (test_count - passed_count) << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    if (test_count == passed_count) {
+        std::cout << "All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "Some tests failed!" << std::endl;
+        return 1;
+    }
+}
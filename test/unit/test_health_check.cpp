@@ -0,0 +1,245 @@
+/**
+ * @file test_health_check.cpp
+ * @brief 单元测试：健康检查的调度、超时与预渲染结果
+ */
+
+#include <iostream>
+#include <cassert>
+#include <cstdlib>
+#include "../../include/health_check.h"
+#include <thread>
+
+using namespace uvapi::health;
+
+int test_count = 0;
+int passed_count = 0;
+
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { \
+    test_count++; \
+    std::cout << "Running test: " << #name << "..."; \
+    test_##name(); \
+    std::cout << " PASSED" << std::endl; \
+    passed_count++; \
+} while(0)
+
+#define ASSERT_TRUE(expr) do { \
+    if (!(expr)) { \
+        std::cerr << "\n  FAILED: " << #expr << " is false" << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+#define ASSERT_FALSE(expr) ASSERT_TRUE(!(expr))
+
+#define ASSERT_EQ(a, b) do { \
+    if ((a) != (b)) { \
+        std::cerr << "\n  FAILED: " << #a << " != " << #b << std::endl; \
+        std::cerr << "    Expected: " << (b) << ", Got: " << (a) << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+static bool contains(const std::string& text, const std::string& part) {
+    return text.find(part) != std::string::npos;
+}
+
+static HealthChecker fixedChecker(const std::string& name, HealthStatus status, int* calls = nullptr) {
+    return HealthChecker(name, [status, calls]() {
+        if (calls) (*calls)++;
+        HealthCheckResult result;
+        result.status = status;
+        result.message = "fixed";
+        return result;
+    });
+}
+
+// 记录 tick() 提交的检查，由测试决定何时执行
+struct Collector {
+    std::vector<size_t>* due;
+    bool accept;
+    bool operator()(size_t index) const {
+        if (accept) due->push_back(index);
+        return accept;
+    }
+};
+
+// ========== 预渲染结果 ==========
+
+TEST(Snapshot_PendingUntilReported) {
+    HealthCheckManager manager;
+    ASSERT_TRUE(manager.latest()->ready);  // 没有检查器时立即就绪
+    
+    manager.addChecker(fixedChecker("db", HealthStatus::HEALTHY));
+    std::shared_ptr<const HealthSnapshot> snapshot = manager.latest();
+    ASSERT_FALSE(snapshot->ready);
+    ASSERT_EQ(snapshot->readyCode(), 503);
+    ASSERT_EQ(snapshot->healthCode(), 200);
+    ASSERT_TRUE(contains(snapshot->health_body, "\"db\":{\"status\":\"pending\""));
+    ASSERT_EQ(snapshot->ready_body, std::string("{\"status\":\"not_ready\"}"));
+    
+    manager.runCheck(0);
+    snapshot = manager.latest();
+    ASSERT_TRUE(snapshot->ready);
+    ASSERT_EQ(snapshot->readyCode(), 200);
+    ASSERT_TRUE(contains(snapshot->health_body, "{\"status\":\"healthy\",\"checks\":{\"db\":{\"status\":\"healthy\""));
+    ASSERT_EQ(snapshot->ready_body, std::string("{\"status\":\"ready\"}"));
+}
+
+TEST(Snapshot_AggregatesAndSortsByName) {
+    HealthCheckManager manager;
+    manager.addChecker(fixedChecker("zeta", HealthStatus::DEGRADED));
+    manager.addChecker(fixedChecker("alpha", HealthStatus::HEALTHY));
+    manager.runCheck(0);
+    manager.runCheck(1);
+    std::shared_ptr<const HealthSnapshot> snapshot = manager.latest();
+    ASSERT_TRUE(snapshot->status == HealthStatus::DEGRADED);
+    ASSERT_EQ(snapshot->healthCode(), 200);
+    ASSERT_TRUE(snapshot->ready);
+    ASSERT_TRUE(snapshot->health_body.find("\"alpha\"") < snapshot->health_body.find("\"zeta\""));
+    
+    // 同名替换，结果回到未完成
+    manager.addChecker(fixedChecker("zeta", HealthStatus::UNHEALTHY));
+    ASSERT_EQ(manager.size(), 2u);
+    ASSERT_FALSE(manager.latest()->ready);
+    manager.runCheck(1);
+    snapshot = manager.latest();
+    ASSERT_TRUE(snapshot->status == HealthStatus::UNHEALTHY);
+    ASSERT_EQ(snapshot->healthCode(), 503);
+    ASSERT_FALSE(snapshot->ready);
+}
+
+TEST(Snapshot_OldSnapshotUnchanged) {
+    HealthCheckManager manager;
+    manager.addChecker(fixedChecker("db", HealthStatus::HEALTHY));
+    std::shared_ptr<const HealthSnapshot> before = manager.latest();
+    std::string body = before->health_body;
+    manager.runCheck(0);
+    ASSERT_EQ(before->health_body, body);
+    ASSERT_TRUE(manager.latest().get() != before.get());
+}
+
+// ========== 调度 ==========
+
+TEST(Tick_PerCheckIntervals) {
+    HealthCheckManager manager;
+    manager.addChecker(fixedChecker("fast", HealthStatus::HEALTHY).interval(std::chrono::milliseconds(100)));
+    manager.addChecker(fixedChecker("slow", HealthStatus::HEALTHY).interval(std::chrono::milliseconds(1000)));
+    ASSERT_EQ(manager.tickInterval().count(), 100);
+    
+    std::vector<size_t> due;
+    Collector collect = {&due, true};
+    ASSERT_EQ(manager.tick(1000, collect), 2u);  // 首轮全部提交
+    
+    // 执行中的检查不会重复提交
+    ASSERT_EQ(manager.tick(1150, collect), 0u);
+    manager.runCheck(0);
+    manager.runCheck(1);
+    
+    ASSERT_EQ(manager.tick(1150, collect), 1u);  // 只有 fast 到期
+    ASSERT_EQ(due.back(), 0u);
+    manager.runCheck(0);
+    ASSERT_EQ(manager.tick(2000, collect), 2u);
+}
+
+TEST(Tick_RejectedSubmitRetries) {
+    HealthCheckManager manager;
+    manager.addChecker(fixedChecker("db", HealthStatus::HEALTHY));
+    std::vector<size_t> due;
+    Collector reject = {&due, false};
+    ASSERT_EQ(manager.tick(0, reject), 0u);
+    
+    // 下一次 tick 立即重试，不等待整个间隔
+    Collector accept = {&due, true};
+    ASSERT_EQ(manager.tick(10, accept), 1u);
+}
+
+TEST(Tick_TimeoutMarksUnhealthy) {
+    HealthCheckManager manager;
+    manager.addChecker(fixedChecker("db", HealthStatus::HEALTHY)
+                           .interval(std::chrono::milliseconds(1000))
+                           .timeout(std::chrono::milliseconds(200)));
+    std::vector<size_t> due;
+    Collector collect = {&due, true};
+    ASSERT_EQ(manager.tick(0, collect), 1u);
+    
+    manager.tick(199, collect);
+    ASSERT_FALSE(manager.latest()->ready);
+    manager.tick(200, collect);
+    std::shared_ptr<const HealthSnapshot> snapshot = manager.latest();
+    ASSERT_TRUE(snapshot->status == HealthStatus::UNHEALTHY);
+    ASSERT_TRUE(contains(snapshot->health_body, "Check timed out after 200 ms"));
+    
+    // 挂起的检查返回之前不再提交
+    ASSERT_EQ(manager.tick(5000, collect), 0u);
+    manager.runCheck(0);
+    ASSERT_TRUE(manager.latest()->status == HealthStatus::HEALTHY);
+    ASSERT_EQ(manager.tick(5000, collect), 1u);
+}
+
+TEST(Tick_ParallelRunners) {
+    HealthCheckManager manager;
+    for (int i = 0; i < 4; i++) {
+        manager.addChecker(HealthChecker("check" + std::to_string(i), []() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            return HealthCheckResult();
+        }));
+    }
+    std::vector<std::thread> threads;
+    manager.tick(0, [&manager, &threads](size_t index) {
+        threads.push_back(std::thread([&manager, index]() { manager.runCheck(index); }));
+        return true;
+    });
+    ASSERT_EQ(threads.size(), 4u);
+    
+    // 执行期间读取方不被阻塞
+    std::shared_ptr<const HealthSnapshot> snapshot = manager.latest();
+    ASSERT_TRUE(snapshot != nullptr);
+    for (size_t i = 0; i < threads.size(); i++) {
+        threads[i].join();
+    }
+    ASSERT_TRUE(manager.latest()->ready);
+}
+
+TEST(CheckAll_Synchronous) {
+    HealthCheckManager manager;
+    int calls = 0;
+    manager.addChecker(fixedChecker("b", HealthStatus::HEALTHY, &calls));
+    manager.addChecker(fixedChecker("a", HealthStatus::DEGRADED, &calls));
+    std::string json = manager.checkAll();
+    ASSERT_EQ(calls, 2);
+    ASSERT_TRUE(contains(json, "{\"status\":\"degraded\",\"checks\":{\"a\":"));
+    ASSERT_FALSE(manager.latest()->ready);  // checkAll() 不发布
+}
+
+int main() {
+    std::cout << "Health Check Unit Tests" << std::endl;
+    std::cout << "========================================" << std::endl << std::endl;
+
+    std::cout << "Snapshot Tests:" << std::endl;
+    RUN_TEST(Snapshot_PendingUntilReported);
+    RUN_TEST(Snapshot_AggregatesAndSortsByName);
+    RUN_TEST(Snapshot_OldSnapshotUnchanged);
+
+    std::cout << std::endl << "Scheduling Tests:" << std::endl;
+    RUN_TEST(Tick_PerCheckIntervals);
+    RUN_TEST(Tick_RejectedSubmitRetries);
+    RUN_TEST(Tick_TimeoutMarksUnhealthy);
+    RUN_TEST(Tick_ParallelRunners);
+    RUN_TEST(CheckAll_Synchronous);
+
+    std::cout << std::endl << "========================================" << std::endl;
+    std::cout << "Test Results:" << std::endl;
+    std::cout << "  Total: " << test_count << std::endl;
+    std::cout << "  Passed: " << passed_count << std::endl;
+    std::cout << "  Failed: " << (test_count - passed_count) << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    if (test_count == passed_count) {
+        std::cout << "All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "Some tests failed!" << std::endl;
+        return 1;
+    }
+}
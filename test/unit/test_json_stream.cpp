@@ -0,0 +1,303 @@
+/**
+ * @file test_json_stream.cpp
+ * @brief 单元测试：流式 JSON 读取器
+ */
+
+#include <iostream>
+#include <cassert>
+#include <cstdlib>
+#include <cmath>
+#include <string>
+#include "../../include/json_stream.h"
+
+using namespace uvapi;
+using namespace uvapi::json;
+
+int test_count = 0;
+int passed_count = 0;
+
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { \
+    test_count++; \
+    std::cout << "Running test: " << #name << "..."; \
+    test_##name(); \
+    std::cout << " PASSED" << std::endl; \
+    passed_count++; \
+} while(0)
+
+#define ASSERT_TRUE(expr) do { \
+    if (!(expr)) { \
+        std::cerr << "\n  FAILED: " << #expr << " is false" << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+#define ASSERT_FALSE(expr) ASSERT_TRUE(!(expr))
+
+#define ASSERT_EQ(a, b) do { \
+    if ((a) != (b)) { \
+        std::cerr << "\n  FAILED: " << #a << " != " << #b << std::endl; \
+        std::cerr << "    Expected: " << (b) << ", Got: " << (a) << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+// 读取单个数值
+static Number readNum(const char* text) {
+    Reader reader(text, std::strlen(text));
+    Number num;
+    ASSERT_TRUE(reader.readNumber(num));
+    ASSERT_TRUE(reader.finish());
+    return num;
+}
+
+static bool numFails(const char* text) {
+    Reader reader(text, std::strlen(text));
+    Number num;
+    return !reader.readNumber(num) || !reader.finish();
+}
+
+// ========== 对象遍历测试 ==========
+
+TEST(Object_Members) {
+    const std::string text = " { \"name\" : \"bob\", \"age\": 42, \"ok\": true } ";
+    Reader reader(text.data(), text.size());
+    StringSlice key;
+    std::string name;
+    Number age;
+    bool ok = false;
+    ASSERT_TRUE(reader.beginObject());
+    int members = 0;
+    while (reader.nextMember(key)) {
+        members++;
+        if (key.equals("name", 4)) {
+            ASSERT_TRUE(reader.readString(name));
+        } else if (key.equals("age", 3)) {
+            ASSERT_TRUE(reader.readNumber(age));
+        } else {
+            ASSERT_TRUE(key.equals("ok", 2));
+            ASSERT_TRUE(reader.readBool(ok));
+        }
+    }
+    ASSERT_FALSE(reader.failed());
+    ASSERT_TRUE(reader.finish());
+    ASSERT_EQ(members, 3);
+    ASSERT_EQ(name, "bob");
+    ASSERT_EQ(age.integer, 42);
+    ASSERT_TRUE(ok);
+}
+
+TEST(Object_KeySliceIsZeroCopy) {
+    const std::string text = "{\"plain\":1}";
+    Reader reader(text.data(), text.size());
+    StringSlice key;
+    ASSERT_TRUE(reader.beginObject());
+    ASSERT_TRUE(reader.nextMember(key));
+    ASSERT_TRUE(key.data == text.data() + 2);
+    ASSERT_EQ(key.size, 5u);
+}
+
+TEST(Object_EscapedKey) {
+    const std::string text = "{\"a\\u0062c\":1}";
+    Reader reader(text.data(), text.size());
+    StringSlice key;
+    ASSERT_TRUE(reader.beginObject());
+    ASSERT_TRUE(reader.nextMember(key));
+    ASSERT_EQ(key.toString(), "abc");
+}
+
+TEST(Object_Empty) {
+    Reader reader("{}", 2);
+    StringSlice key;
+    ASSERT_TRUE(reader.beginObject());
+    ASSERT_FALSE(reader.nextMember(key));
+    ASSERT_FALSE(reader.failed());
+    ASSERT_TRUE(reader.finish());
+}
+
+// ========== 字符串测试 ==========
+
+TEST(String_Escapes) {
+    const std::string text = "\"a\\\"b\\\\c\\/d\\n\\t\\u00e9\\ud83d\\ude00\"";
+    Reader reader(text.data(), text.size());
+    std::string out;
+    ASSERT_TRUE(reader.readString(out));
+    ASSERT_EQ(out, "a\"b\\c/d\n\t\xC3\xA9\xF0\x9F\x98\x80");
+}
+
+TEST(String_Invalid) {
+    std::string out;
+    const char* cases[] = { "\"abc", "\"a\\x\"", "\"\\ud83d\"", "\"\\u12\"", "\"a\nb\"" };
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        Reader reader(cases[i], std::strlen(cases[i]));
+        ASSERT_FALSE(reader.readString(out));
+        ASSERT_TRUE(reader.failed());
+    }
+}
+
+// ========== 数值测试 ==========
+
+TEST(Number_Integers) {
+    ASSERT_EQ(readNum("0").integer, 0);
+    ASSERT_EQ(readNum("-17").integer, -17);
+    ASSERT_EQ(readNum("9223372036854775807").integer, INT64_MAX);
+    ASSERT_EQ(readNum("-9223372036854775808").integer, INT64_MIN);
+    ASSERT_TRUE(readNum("123456789012").is_integer);
+    ASSERT_FALSE(readNum("9223372036854775808").is_integer);
+    ASSERT_TRUE(readNum("18446744073709551615").is_unsigned);
+    ASSERT_TRUE(readNum("18446744073709551615").uinteger == UINT64_MAX);
+    ASSERT_FALSE(readNum("18446744073709551616").is_unsigned);
+    ASSERT_FALSE(readNum("-1").is_unsigned);
+    ASSERT_FALSE(readNum("1e3").is_integer);
+    ASSERT_EQ(readNum("1e3").value, 1000.0);
+}
+
+TEST(Number_Doubles) {
+    ASSERT_EQ(readNum("1.5").value, 1.5);
+    ASSERT_EQ(readNum("-0.25").value, -0.25);
+    ASSERT_EQ(readNum("3.14159").value, 3.14159);
+    ASSERT_EQ(readNum("2.5E-3").value, 2.5e-3);
+    ASSERT_EQ(readNum("0.0000000000000000000123").value, 1.23e-20);
+    ASSERT_EQ(readNum("1.7976931348623157e308").value, 1.7976931348623157e308);
+    ASSERT_EQ(readNum("12345678901234567890123").value, 12345678901234567890123.0);
+    ASSERT_EQ(readNum("4.9e-324").value, 4.9e-324);
+}
+
+TEST(Number_EightDigitRuns) {
+    // 覆盖 8 位一组换算的每种长度，以及一组中间夹着非数字的情况
+    std::string digits = "1234567890123456789";
+    for (size_t len = 1; len <= digits.size(); ++len) {
+        std::string text = digits.substr(0, len);
+        ASSERT_EQ(readNum(text.c_str()).uinteger, std::strtoull(text.c_str(), nullptr, 10));
+    }
+    ASSERT_EQ(readNum("12345678.5").value, 12345678.5);
+    ASSERT_EQ(readNum("1234567e2").value, 123456700.0);
+    ASSERT_EQ(readNum("-98765432109").integer, -98765432109LL);
+}
+
+TEST(Array_CountFlatElements) {
+    const char* text = "[1, 2.5, -3, true, null]";
+    Reader reader(text, std::strlen(text));
+    ASSERT_TRUE(reader.beginArray());
+    ASSERT_EQ(reader.countFlatElements(), 5u);
+    
+    const char* nested = "[1, [2], 3]";
+    Reader nested_reader(nested, std::strlen(nested));
+    ASSERT_TRUE(nested_reader.beginArray());
+    ASSERT_EQ(nested_reader.countFlatElements(), 0u);
+    
+    Reader empty("[ ]", 3);
+    ASSERT_TRUE(empty.beginArray());
+    ASSERT_EQ(empty.countFlatElements(), 0u);
+}
+
+TEST(Number_Invalid) {
+    ASSERT_TRUE(numFails("01"));
+    ASSERT_TRUE(numFails("-"));
+    ASSERT_TRUE(numFails("1."));
+    ASSERT_TRUE(numFails(".5"));
+    ASSERT_TRUE(numFails("1e"));
+    ASSERT_TRUE(numFails("+1"));
+}
+
+// ========== 跳过与错误测试 ==========
+
+TEST(Skip_Nested) {
+    const std::string text = "{\"skip\":{\"a\":[1,2,{\"b\":null}],\"c\":\"}\"},\"keep\":7}";
+    Reader reader(text.data(), text.size());
+    StringSlice key;
+    Number keep;
+    StringSlice raw;
+    ASSERT_TRUE(reader.beginObject());
+    ASSERT_TRUE(reader.nextMember(key));
+    ASSERT_TRUE(reader.skipValue(&raw));
+    ASSERT_EQ(raw.toString(), "{\"a\":[1,2,{\"b\":null}],\"c\":\"}\"}");
+    ASSERT_TRUE(reader.nextMember(key));
+    ASSERT_TRUE(key.equals("keep", 4));
+    ASSERT_TRUE(reader.readNumber(keep));
+    ASSERT_FALSE(reader.nextMember(key));
+    ASSERT_TRUE(reader.finish());
+    ASSERT_EQ(keep.integer, 7);
+}
+
+TEST(Skip_RejectsMalformed) {
+    const char* cases[] = { "[1,]", "{\"a\" 1}", "{\"a\":1,}", "[1 2]", "nul", "{\"a\":tru}" };
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        Reader reader(cases[i], std::strlen(cases[i]));
+        ASSERT_FALSE(reader.skipValue() && reader.finish());
+    }
+}
+
+TEST(Skip_DepthLimit) {
+    std::string text(Reader::kMaxDepth + 1, '[');
+    text += std::string(Reader::kMaxDepth + 1, ']');
+    Reader reader(text.data(), text.size());
+    ASSERT_FALSE(reader.skipValue());
+    ASSERT_EQ(std::string(reader.error()), "Nesting too deep");
+}
+
+TEST(Error_FirstErrorWins) {
+    const std::string text = "{\"a\":1 \"b\":2}";
+    Reader reader(text.data(), text.size());
+    StringSlice key;
+    Number num;
+    ASSERT_TRUE(reader.beginObject());
+    ASSERT_TRUE(reader.nextMember(key));
+    ASSERT_TRUE(reader.readNumber(num));
+    ASSERT_FALSE(reader.nextMember(key));
+    ASSERT_TRUE(reader.failed());
+    ASSERT_EQ(reader.offset(), 7u);
+    ASSERT_FALSE(reader.finish());
+    ASSERT_EQ(reader.describeError(), "Expected ',' or '}' in object at offset 7");
+}
+
+TEST(Error_TrailingCharacters) {
+    Reader reader("{} x", 4);
+    ASSERT_TRUE(reader.skipValue());
+    ASSERT_FALSE(reader.finish());
+}
+
+int main() {
+    std::cout << "========================================" << std::endl;
+    std::cout << "JSON Stream Reader Unit Tests" << std::endl;
+    std::cout << "========================================" << std::endl << std::endl;
+
+    std::cout << "Object Tests:" << std::endl;
+    RUN_TEST(Object_Members);
+    RUN_TEST(Object_KeySliceIsZeroCopy);
+    RUN_TEST(Object_EscapedKey);
+    RUN_TEST(Object_Empty);
+
+    std::cout << std::endl << "String Tests:" << std::endl;
+    RUN_TEST(String_Escapes);
+    RUN_TEST(String_Invalid);
+
+    std::cout << std::endl << "Number Tests:" << std::endl;
+    RUN_TEST(Number_Integers);
+    RUN_TEST(Number_Doubles);
+    RUN_TEST(Number_EightDigitRuns);
+    RUN_TEST(Number_Invalid);
+    RUN_TEST(Array_CountFlatElements);
+
+    std::cout << std::endl << "Skip And Error Tests:" << std::endl;
+    RUN_TEST(Skip_Nested);
+    RUN_TEST(Skip_RejectsMalformed);
+    RUN_TEST(Skip_DepthLimit);
+    RUN_TEST(Error_FirstErrorWins);
+    RUN_TEST(Error_TrailingCharacters);
+
+    std::cout << std::endl << "========================================" << std::endl;
+    std::cout << "Test Results:" << std::endl;
+    std::cout << "  Total: " << test_count << std::endl;
+    std::cout << "  Passed: " << passed_count << std::endl;
+    std::cout << "  Failed: " << (test_count - passed_count) << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    if (test_count == passed_count) {
+        std::cout << "All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "Some tests failed!" << std::endl;
+        return 1;
+    }
+}
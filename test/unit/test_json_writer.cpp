@@ -0,0 +1,264 @@
+/**
+ * @file test_json_writer.cpp
+ * @brief 单元测试：紧凑 JSON 写入器
+ */
+
+#include <iostream>
+#include <cassert>
+#include <cstdlib>
+#include <cfloat>
+#include <climits>
+#include <cstdlib>
+#include <string>
+#include <algorithm>
+#include "../../include/json_writer.h"
+
+using namespace uvapi::json;
+
+int test_count = 0;
+int passed_count = 0;
+
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { \
+    test_count++; \
+    std::cout << "Running test: " << #name << "..."; \
+    test_##name(); \
+    std::cout << " PASSED" << std::endl; \
+    passed_count++; \
+} while(0)
+
+#define ASSERT_TRUE(expr) do { \
+    if (!(expr)) { \
+        std::cerr << "\n  FAILED: " << #expr << " is false" << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+#define ASSERT_FALSE(expr) ASSERT_TRUE(!(expr))
+
+#define ASSERT_EQ(a, b) do { \
+    if ((a) != (b)) { \
+        std::cerr << "\n  FAILED: " << #a << " != " << #b << std::endl; \
+        std::cerr << "    Expected: " << (b) << ", Got: " << (a) << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+static std::string doubleText(double value) {
+    std::string out;
+    appendDouble(out, value);
+    return out;
+}
+
+static std::string floatText(float value) {
+    std::string out;
+    appendFloat(out, value);
+    return out;
+}
+
+// ========== 结构测试 ==========
+
+TEST(Structure_ObjectAndArray) {
+    std::string out;
+    Writer w(out);
+    w.beginObject();
+    w.key("id");
+    w.integer(42);
+    w.key("tags");
+    w.beginArray();
+    w.string("a");
+    w.string("b");
+    w.beginObject();
+    w.endObject();
+    w.endArray();
+    w.key("ok");
+    w.boolean(true);
+    w.key("none");
+    w.null();
+    w.endObject();
+    ASSERT_EQ(out, "{\"id\":42,\"tags\":[\"a\",\"b\",{}],\"ok\":true,\"none\":null}");
+}
+
+TEST(Structure_RawAndRawKey) {
+    std::string out;
+    Writer w(out);
+    w.beginArray();
+    w.raw("{\"x\":1}");
+    w.beginObject();
+    w.rawKey("\"k\":", 4);
+    w.raw("[1,2]");
+    w.endObject();
+    w.endArray();
+    ASSERT_EQ(out, "[{\"x\":1},{\"k\":[1,2]}]");
+}
+
+TEST(Structure_AppendsToExistingBuffer) {
+    std::string out = "prefix:";
+    Writer w(out);
+    w.beginArray();
+    w.integer(1);
+    w.endArray();
+    ASSERT_EQ(out, "prefix:[1]");
+}
+
+TEST(Structure_DeepNesting) {
+    std::string out;
+    Writer w(out);
+    const int depth = Writer::kMaxDepth + 6;
+    for (int i = 0; i < depth; i++) {
+        w.beginArray();
+        w.integer(i);
+    }
+    for (int i = 0; i < depth; i++) {
+        w.endArray();
+    }
+    std::string expected;
+    for (int i = 0; i < depth; i++) {
+        expected += (i == 0 ? "[" : ",[") + std::to_string(i);
+    }
+    expected += std::string(static_cast<size_t>(depth), ']');
+    ASSERT_EQ(out, expected);
+}
+
+// ========== 数值测试 ==========
+
+TEST(Number_Integers) {
+    std::string out;
+    appendInteger(out, 0);
+    out += ' ';
+    appendInteger(out, -7);
+    out += ' ';
+    appendInteger(out, INT64_MIN);
+    out += ' ';
+    appendUnsigned(out, UINT64_MAX);
+    ASSERT_EQ(out, "0 -7 -9223372036854775808 18446744073709551615");
+}
+
+TEST(Number_Doubles) {
+    ASSERT_EQ(doubleText(150.0), "150");
+    ASSERT_EQ(doubleText(-0.5), "-0.5");
+    ASSERT_EQ(doubleText(0.1), "0.1");
+    ASSERT_EQ(doubleText(1.0 / 3.0), "0.3333333333333333");
+    ASSERT_EQ(doubleText(1e300), "1e+300");
+    ASSERT_EQ(doubleText(1.0 / 0.0), "null");
+}
+
+TEST(Number_DoublesRoundTrip) {
+    const double values[] = { 0.1, 2.5e-8, 3.141592653589793, 123456.789, DBL_MAX, DBL_MIN, 5e-324 };
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+        ASSERT_TRUE(std::strtod(doubleText(values[i]).c_str(), nullptr) == values[i]);
+    }
+}
+
+TEST(Number_Floats) {
+    ASSERT_EQ(floatText(0.1f), "0.1");
+    ASSERT_EQ(floatText(2.5f), "2.5");
+    ASSERT_EQ(floatText(16.0f), "16");
+    ASSERT_TRUE(std::strtof(floatText(FLT_MAX).c_str(), nullptr) == FLT_MAX);
+}
+
+// ========== 字符串测试 ==========
+
+TEST(String_Escaping) {
+    std::string out;
+    Writer w(out);
+    w.string(std::string("q\"b\\s/n\nt\tc\x01\x1f", 13));
+    ASSERT_EQ(out, "\"q\\\"b\\\\s/n\\nt\\tc\\u0001\\u001f\"");
+}
+
+TEST(String_Utf8PassThrough) {
+    std::string out;
+    Writer w(out);
+    w.key("名字");
+    w.string("\xC3\xA9t\xC3\xA9");
+    ASSERT_EQ(out, "\"名字\":\"\xC3\xA9t\xC3\xA9\"");
+}
+
+// 按字节逐个转义的参考实现，用来对照块扫描的结果
+static std::string referenceEscape(const std::string& in) {
+    std::string out;
+    for (size_t i = 0; i < in.size(); ++i) {
+        std::string one;
+        appendEscaped(one, in.data() + i, 1);
+        out += one;
+    }
+    return out;
+}
+
+TEST(String_LongCleanRun) {
+    std::string in;
+    for (int i = 0; i < 1000; ++i) {
+        in += static_cast<char>(' ' + (i % 94));
+    }
+    in.erase(std::remove(in.begin(), in.end(), '"'), in.end());
+    in.erase(std::remove(in.begin(), in.end(), '\\'), in.end());
+    std::string out;
+    appendEscaped(out, in.data(), in.size());
+    ASSERT_EQ(out, in);
+}
+
+TEST(String_EscapeAtEveryOffset) {
+    // 覆盖 8 / 16 字节块边界前后以及尾部的每一个位置
+    const char specials[] = { '"', '\\', '\n', '\x01', '\x1f', static_cast<char>(0x7f), static_cast<char>(0xC3) };
+    for (size_t len = 1; len <= 40; ++len) {
+        for (size_t pos = 0; pos < len; ++pos) {
+            for (size_t k = 0; k < sizeof(specials); ++k) {
+                std::string in(len, 'a');
+                in[pos] = specials[k];
+                std::string out;
+                appendEscaped(out, in.data(), in.size());
+                ASSERT_EQ(out, referenceEscape(in));
+            }
+        }
+    }
+}
+
+TEST(Pretty_MatchesCJsonLayout) {
+    std::string compact = "{\"a\":1,\"b\":[1,{\"c\":\"x,y:{\\\"\"}],\"e\":{}}";
+    std::string out;
+    appendPretty(out, compact.data(), compact.size());
+    ASSERT_EQ(out, std::string("{\n\t\"a\":\t1,\n\t\"b\":\t[1, {\n\t\t\t\"c\":\t\"x,y:{\\\"\"\n\t\t}],\n"
+                               "\t\"e\":\t{\n\t}\n}"));
+}
+
+int main() {
+    std::cout << "========================================" << std::endl;
+    std::cout << "JSON Writer Unit Tests" << std::endl;
+    std::cout << "========================================" << std::endl << std::endl;
+
+    std::cout << "Structure Tests:" << std::endl;
+    RUN_TEST(Structure_ObjectAndArray);
+    RUN_TEST(Structure_RawAndRawKey);
+    RUN_TEST(Structure_AppendsToExistingBuffer);
+    RUN_TEST(Structure_DeepNesting);
+
+    std::cout << std::endl << "Number Tests:" << std::endl;
+    RUN_TEST(Number_Integers);
+    RUN_TEST(Number_Doubles);
+    RUN_TEST(Number_DoublesRoundTrip);
+    RUN_TEST(Number_Floats);
+
+    std::cout << std::endl << "String Tests:" << std::endl;
+    RUN_TEST(String_Escaping);
+    RUN_TEST(String_Utf8PassThrough);
+    RUN_TEST(String_LongCleanRun);
+    RUN_TEST(String_EscapeAtEveryOffset);
+
+    std::cout << std::endl << "Pretty Print Tests:" << std::endl;
+    RUN_TEST(Pretty_MatchesCJsonLayout);
+
+    std::cout << std::endl << "========================================" << std::endl;
+    std::cout << "Test Results:" << std::endl;
+    std::cout << "  Total: " << test_count << std::endl;
+    std::cout << "  Passed: " << passed_count << std::endl;
+    std::cout << "  Failed: " << (test_count - passed_count) << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    if (test_count == passed_count) {
+        std::cout << "All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "Some tests failed!" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,279 @@
+/**
+ * @file test_metrics.cpp
+ * @brief 单元测试：按线程分片的无锁指标
+ */
+
+#include <iostream>
+#include <cassert>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../../include/metrics.h"
+
+using namespace uvapi::metrics;
+
+int test_count = 0;
+int passed_count = 0;
+
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { \
+    test_count++; \
+    std::cout << "Running test: " << #name << "..."; \
+    test_##name(); \
+    std::cout << " PASSED" << std::endl; \
+    passed_count++; \
+} while(0)
+
+#define ASSERT_TRUE(expr) do { \
+    if (!(expr)) { \
+        std::cerr << "\n  FAILED: " << #expr << " is false" << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+#define ASSERT_FALSE(expr) ASSERT_TRUE(!(expr))
+
+#define ASSERT_EQ(a, b) do { \
+    if ((a) != (b)) { \
+        std::cerr << "\n  FAILED: " << #a << " != " << #b << std::endl; \
+        std::cerr << "    Expected: " << (b) << ", Got: " << (a) << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+// 多线程并发递增后合并结果准确
+TEST(Counter_ConcurrentIncrements) {
+    Counter counter("requests_total", "Total requests");
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; t++) {
+        threads.push_back(std::thread([&counter]() {
+            for (int i = 0; i < 10000; i++) {
+                counter.increment();
+            }
+        }));
+    }
+    for (size_t i = 0; i < threads.size(); i++) {
+        threads[i].join();
+    }
+    ASSERT_EQ(counter.value(), 80000u);
+
+    counter.reset();
+    ASSERT_EQ(counter.value(), 0u);
+}
+
+TEST(Gauge_ConcurrentUpdates) {
+    Gauge gauge("connections");
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.push_back(std::thread([&gauge]() {
+            for (int i = 0; i < 1000; i++) {
+                gauge.increment(2.0);
+                gauge.decrement();
+            }
+        }));
+    }
+    for (size_t i = 0; i < threads.size(); i++) {
+        threads[i].join();
+    }
+    ASSERT_EQ(gauge.value(), 4000.0);
+
+    gauge.set(1.5);
+    ASSERT_EQ(gauge.value(), 1.5);
+}
+
+// 小数样本不再被截断为整数
+TEST(Histogram_FractionalSum) {
+    Histogram histogram("latency_seconds");
+    histogram.observe(0.25);
+    histogram.observe(0.25);
+    histogram.observe(0.5);
+    ASSERT_EQ(histogram.count(), 3u);
+    ASSERT_EQ(histogram.sum(), 1.0);
+}
+
+// 样本等于边界时落入该边界的桶（le 语义）
+TEST(Histogram_BoundaryEquality) {
+    std::vector<double> boundaries;
+    boundaries.push_back(1.0);
+    boundaries.push_back(2.0);
+    Histogram histogram("h", "", boundaries);
+    histogram.observe(1.0);
+    histogram.observe(1.5);
+    histogram.observe(2.0);
+    histogram.observe(3.0);
+
+    Histogram::Snapshot snap = histogram.snapshot();
+    ASSERT_EQ(snap.buckets.size(), 3u);
+    ASSERT_EQ(snap.buckets[0], 1u);
+    ASSERT_EQ(snap.buckets[1], 2u);
+    ASSERT_EQ(snap.buckets[2], 1u);
+    ASSERT_EQ(snap.count, 4u);
+}
+
+// 未排序的边界在构造时排序
+TEST(Histogram_UnsortedBoundaries) {
+    std::vector<double> boundaries;
+    boundaries.push_back(5.0);
+    boundaries.push_back(0.1);
+    boundaries.push_back(1.0);
+    Histogram histogram("h", "", boundaries);
+    ASSERT_EQ(histogram.boundaries()[0], 0.1);
+    ASSERT_EQ(histogram.boundaries()[2], 5.0);
+
+    histogram.observe(0.05);
+    histogram.observe(0.7);
+    Histogram::Snapshot snap = histogram.snapshot();
+    ASSERT_EQ(snap.buckets[0], 1u);
+    ASSERT_EQ(snap.buckets[1], 1u);
+}
+
+TEST(Histogram_ConcurrentObserve) {
+    Histogram histogram("h");
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; t++) {
+        threads.push_back(std::thread([&histogram]() {
+            for (int i = 0; i < 5000; i++) {
+                histogram.observe(0.5);
+            }
+        }));
+    }
+    for (size_t i = 0; i < threads.size(); i++) {
+        threads[i].join();
+    }
+    ASSERT_EQ(histogram.count(), 40000u);
+    ASSERT_EQ(histogram.sum(), 20000.0);
+}
+
+// Prometheus 输出为累积桶计数，sum 保留小数
+TEST(Histogram_PrometheusText) {
+    std::vector<double> boundaries;
+    boundaries.push_back(0.1);
+    boundaries.push_back(1.0);
+    Histogram histogram("latency", "Latency", boundaries);
+    histogram.observe(0.05);
+    histogram.observe(0.3);
+
+    std::string text = histogram.toPrometheus();
+    ASSERT_TRUE(text.find("latency_bucket{le=\"0.1\"} 1\n") != std::string::npos);
+    ASSERT_TRUE(text.find("latency_bucket{le=\"1\"} 2\n") != std::string::npos);
+    ASSERT_TRUE(text.find("latency_bucket{le=\"+Inf\"} 2\n") != std::string::npos);
+    ASSERT_TRUE(text.find("latency_sum 0.35\n") != std::string::npos);
+    ASSERT_TRUE(text.find("latency_count 2\n") != std::string::npos);
+}
+
+TEST(Counter_PrometheusLabels) {
+    Counter counter("hits");
+    counter.addLabel("path", "/");
+    counter.increment(3);
+    ASSERT_TRUE(counter.toPrometheus().find("hits{path=\"/\"} 3\n") != std::string::npos);
+}
+
+// ========== 导出 ==========
+
+// 抓取写入调用方复用的缓冲区，先清空
+TEST(Registry_ScrapeReusesBuffer) {
+    MetricRegistry registry;
+    registry.registerCounter("b_total", "B")->increment(2);
+    registry.registerGauge("a_gauge", "A")->set(0.5);
+
+    std::string buffer = "stale";
+    registry.scrape(buffer);
+    ASSERT_TRUE(buffer.find("stale") == std::string::npos);
+    // 按名称排序
+    ASSERT_TRUE(buffer.find("a_gauge 0.5\n") < buffer.find("b_total 2\n"));
+    ASSERT_EQ(registry.toPrometheus(), buffer);
+
+    size_t capacity = buffer.capacity();
+    registry.scrape(buffer);
+    ASSERT_EQ(buffer.capacity(), capacity);
+}
+
+TEST(Registry_OpenMetrics) {
+    MetricRegistry registry;
+    registry.registerCounter("requests_total", "Requests")->increment();
+
+    std::string text;
+    registry.scrape(text, ExpositionFormat::OPENMETRICS);
+    ASSERT_TRUE(text.find("# TYPE requests counter\n") != std::string::npos);
+    ASSERT_TRUE(text.find("requests_total 1\n") != std::string::npos);
+    ASSERT_TRUE(text.size() >= 6 && text.compare(text.size() - 6, 6, "# EOF\n") == 0);
+    ASSERT_TRUE(text.find("\n\n") == std::string::npos);
+}
+
+TEST(Labels_Escaped) {
+    Gauge gauge("g", "line\nbreak");
+    gauge.addLabel("path", "a\"b\\c");
+    std::string text = gauge.toPrometheus();
+    ASSERT_TRUE(text.find("# HELP g line\\nbreak\n") != std::string::npos);
+    ASSERT_TRUE(text.find("g{path=\"a\\\"b\\\\c\"} 0\n") != std::string::npos);
+}
+
+TEST(Histogram_LabelsOnEverySeries) {
+    Histogram histogram("h", "", std::vector<double>(1, 1.0));
+    histogram.addLabel("method", "GET");
+    histogram.observe(0.5);
+    std::string text = histogram.toPrometheus();
+    ASSERT_TRUE(text.find("h_bucket{method=\"GET\",le=\"1\"} 1\n") != std::string::npos);
+    ASSERT_TRUE(text.find("h_bucket{method=\"GET\",le=\"+Inf\"} 1\n") != std::string::npos);
+    ASSERT_TRUE(text.find("h_count{method=\"GET\"} 1\n") != std::string::npos);
+}
+
+TEST(Scraper_PublishesLatest) {
+    MetricRegistry registry;
+    std::shared_ptr<Counter> counter = registry.registerCounter("ticks_total", "Ticks");
+    BackgroundScraper scraper(registry, std::chrono::milliseconds(5));
+    ASSERT_TRUE(!scraper.latest());
+
+    scraper.start();
+    ASSERT_TRUE(scraper.latest()->find("ticks_total 0\n") != std::string::npos);
+
+    counter->increment(7);
+    bool updated = false;
+    for (int i = 0; i < 200 && !updated; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        updated = scraper.latest()->find("ticks_total 7\n") != std::string::npos;
+    }
+    scraper.stop();
+    ASSERT_TRUE(updated);
+}
+
+int main() {
+    std::cout << "========================================" << std::endl;
+    std::cout << "Metrics Unit Tests" << std::endl;
+    std::cout << "========================================" << std::endl << std::endl;
+
+    std::cout << "Counter / Gauge Tests:" << std::endl;
+    RUN_TEST(Counter_ConcurrentIncrements);
+    RUN_TEST(Counter_PrometheusLabels);
+    RUN_TEST(Gauge_ConcurrentUpdates);
+
+    std::cout << std::endl << "Histogram Tests:" << std::endl;
+    RUN_TEST(Histogram_FractionalSum);
+    RUN_TEST(Histogram_BoundaryEquality);
+    RUN_TEST(Histogram_UnsortedBoundaries);
+    RUN_TEST(Histogram_ConcurrentObserve);
+    RUN_TEST(Histogram_PrometheusText);
+
+    std::cout << std::endl << "Exposition Tests:" << std::endl;
+    RUN_TEST(Registry_ScrapeReusesBuffer);
+    RUN_TEST(Registry_OpenMetrics);
+    RUN_TEST(Labels_Escaped);
+    RUN_TEST(Histogram_LabelsOnEverySeries);
+    RUN_TEST(Scraper_PublishesLatest);
+
+    std::cout << std::endl << "========================================" << std::endl;
+    std::cout << "Test Results:" << std::endl;
+    std::cout << "  Total: " << test_count << std::endl;
+    std::cout << "  Passed: " << passed_count << std::endl;
+    std::cout << "  Failed: " << (test_count - passed_count) << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    if (test_count == passed_count) {
+        std::cout << "All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "Some tests failed!" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,268 @@
+/**
+ * @file test_multipart.cpp
+ * @brief 单元测试：增量式 multipart/form-data 解析器
+ */
+
+#include <iostream>
+#include <cassert>
+#include <cstdlib>
+#include <cstdio>
+#include <csignal>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+#include "../../include/multipart.h"
+
+using namespace uvapi;
+
+int test_count = 0;
+int passed_count = 0;
+
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { \
+    test_count++; \
+    std::cout << "Running test: " << #name << "..."; \
+    test_##name(); \
+    std::cout << " PASSED" << std::endl; \
+    passed_count++; \
+} while(0)
+
+#define ASSERT_TRUE(expr) do { \
+    if (!(expr)) { \
+        std::cerr << "\n  FAILED: " << #expr << " is false" << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+#define ASSERT_FALSE(expr) ASSERT_TRUE(!(expr))
+
+#define ASSERT_EQ(a, b) do { \
+    if ((a) != (b)) { \
+        std::cerr << "\n  FAILED: " << #a << " != " << #b << std::endl; \
+        std::cerr << "    Expected: " << (b) << ", Got: " << (a) << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+static const char* kBoundary = "XyZ123";
+
+static std::string filePayload(size_t n) {
+    // 包含形似分隔符的内容，确保只有完整的 "\r\n--XyZ123" 才会结束部分
+    std::string data;
+    while (data.size() < n) {
+        data += "line\r\n--XyZ12\r\n-";
+        data += static_cast<char>('a' + data.size() % 26);
+    }
+    data.resize(n);
+    return data;
+}
+
+static std::string buildBody(const std::string& file_data) {
+    std::string body;
+    body += "preamble\r\n";
+    body += "--XyZ123\r\n";
+    body += "Content-Disposition: form-data; name=\"title\"\r\n\r\n";
+    body += "hello world\r\n";
+    body += "--XyZ123\r\n";
+    body += "Content-Disposition: form-data; name=\"doc\"; filename=\"notes.txt\"\r\n";
+    body += "Content-Type: text/plain\r\n\r\n";
+    body += file_data;
+    body += "\r\n--XyZ123\r\n";
+    body += "Content-Disposition: form-data; name=\"empty\"\r\n\r\n";
+    body += "\r\n--XyZ123--\r\nepilogue";
+    return body;
+}
+
+static bool readFile(const std::string& path, std::string& out) {
+    FILE* fp = fopen(path.c_str(), "rb");
+    if (!fp) return false;
+    char buf[4096];
+    size_t n;
+    out.clear();
+    while ((n = fread(buf, 1, sizeof(buf), fp)) > 0) {
+        out.append(buf, n);
+    }
+    fclose(fp);
+    return true;
+}
+
+// ========== 基本解析测试 ==========
+
+TEST(Parse_FieldsAndFile) {
+    std::string payload = filePayload(300);
+    std::string body = buildBody(payload);
+    MultipartParser parser(kBoundary);
+    ASSERT_TRUE(parser.parse(body.data(), body.size()));
+    ASSERT_EQ(parser.getFields().size(), 2u);
+    ASSERT_EQ(parser.getFields().at("title"), "hello world");
+    ASSERT_EQ(parser.getFields().at("empty"), "");
+    const UploadedFile& file = parser.getFiles().at("doc");
+    ASSERT_EQ(file.filename, "notes.txt");
+    ASSERT_EQ(file.content_type, "text/plain");
+    ASSERT_EQ(file.size, payload.size());
+    ASSERT_TRUE(file.inMemory());
+    ASSERT_TRUE(std::string(file.data.begin(), file.data.end()) == payload);
+}
+
+TEST(Parse_EveryChunkSplit) {
+    std::string payload = filePayload(200);
+    std::string body = buildBody(payload);
+    for (size_t chunk = 1; chunk <= 40; chunk++) {
+        MultipartParser parser(kBoundary);
+        for (size_t pos = 0; pos < body.size(); pos += chunk) {
+            size_t n = body.size() - pos < chunk ? body.size() - pos : chunk;
+            ASSERT_TRUE(parser.feed(body.data() + pos, n));
+        }
+        ASSERT_TRUE(parser.finish());
+        ASSERT_EQ(parser.getFields().at("title"), "hello world");
+        const std::vector<char>& data = parser.getFiles().at("doc").data;
+        ASSERT_TRUE(std::string(data.begin(), data.end()) == payload);
+    }
+}
+
+TEST(Parse_MissingCloseDelimiter) {
+    std::string body = buildBody("abc");
+    body.resize(body.find("--XyZ123--"));
+    MultipartParser parser(kBoundary);
+    ASSERT_TRUE(parser.feed(body.data(), body.size()));
+    ASSERT_FALSE(parser.finish());
+    ASSERT_FALSE(parser.error().empty());
+}
+
+TEST(Parse_HeadersTooLarge) {
+    UploadConfig config = UploadConfig::defaultConfig();
+    config.max_header_size = 64;
+    std::string body = "--XyZ123\r\nContent-Disposition: form-data; name=\"" + std::string(100, 'n') + "\"\r\n\r\nv\r\n--XyZ123--";
+    MultipartParser parser(kBoundary, config);
+    ASSERT_FALSE(parser.parse(body.data(), body.size()));
+    ASSERT_FALSE(parser.feed("x", 1));
+}
+
+// ========== 文件处理测试 ==========
+
+TEST(File_OversizeSkipped) {
+    UploadConfig config = UploadConfig::defaultConfig();
+    config.max_file_size = 100;
+    std::string body = buildBody(filePayload(101));
+    MultipartParser parser(kBoundary, config);
+    ASSERT_TRUE(parser.parse(body.data(), body.size()));
+    ASSERT_TRUE(parser.getFiles().empty());
+    ASSERT_EQ(parser.getFields().at("title"), "hello world");
+}
+
+TEST(File_SpillToDisk) {
+    UploadConfig config = UploadConfig::defaultConfig();
+    config.spill_threshold = 64;
+    std::string payload = filePayload(5000);
+    std::string body = buildBody(payload);
+    std::string temp_path;
+    {
+        MultipartParser parser(kBoundary, config);
+        for (size_t pos = 0; pos < body.size(); pos += 7) {
+            size_t n = body.size() - pos < 7 ? body.size() - pos : 7;
+            ASSERT_TRUE(parser.feed(body.data() + pos, n));
+        }
+        ASSERT_TRUE(parser.finish());
+        const UploadedFile& file = parser.getFiles().at("doc");
+        ASSERT_FALSE(file.inMemory());
+        ASSERT_TRUE(file.data.empty());
+        ASSERT_EQ(file.size, payload.size());
+        temp_path = file.tempPath();
+
+        std::string spilled;
+        ASSERT_TRUE(readFile(temp_path, spilled));
+        ASSERT_TRUE(spilled == payload);
+
+        std::string saved_path = temp_path + ".saved";
+        std::string saved;
+        ASSERT_TRUE(file.saveTo(saved_path));
+        ASSERT_TRUE(readFile(saved_path, saved));
+        ASSERT_TRUE(saved == payload);
+        std::remove(saved_path.c_str());
+    }
+    // 解析器释放后临时文件被删除
+    std::string gone;
+    ASSERT_FALSE(readFile(temp_path, gone));
+}
+
+TEST(File_SpillCloseFailure) {
+    // 限制进程可写文件大小：溢出数据留在 stdio 缓冲中，直到 fclose 冲刷时才失败
+    struct rlimit old_limit;
+    ASSERT_TRUE(getrlimit(RLIMIT_FSIZE, &old_limit) == 0);
+    struct rlimit limit = old_limit;
+    limit.rlim_cur = 1024;
+    void (*old_handler)(int) = std::signal(SIGXFSZ, SIG_IGN);
+    ASSERT_TRUE(setrlimit(RLIMIT_FSIZE, &limit) == 0);
+
+    UploadConfig config = UploadConfig::defaultConfig();
+    config.spill_threshold = 16;
+    std::string body = buildBody(filePayload(3000));
+    MultipartParser parser(kBoundary, config);
+    bool ok = parser.parse(body.data(), body.size());
+
+    setrlimit(RLIMIT_FSIZE, &old_limit);
+    std::signal(SIGXFSZ, old_handler);
+
+    ASSERT_FALSE(ok);
+    ASSERT_FALSE(parser.error().empty());
+    ASSERT_TRUE(parser.getFiles().empty());
+    ASSERT_FALSE(parser.feed("x", 1));
+}
+
+TEST(File_StreamingCallback) {
+    std::string payload = filePayload(3000);
+    std::string body = buildBody(payload);
+    std::string received;
+    MultipartParser parser(kBoundary);
+    parser.onFileData([&received](const UploadedFile& file, const char* data, size_t size) {
+        if (file.field_name != "doc") return false;
+        received.append(data, size);
+        return true;
+    });
+    ASSERT_TRUE(parser.parse(body.data(), body.size()));
+    ASSERT_TRUE(received == payload);
+    ASSERT_TRUE(parser.getFiles().at("doc").data.empty());
+    ASSERT_EQ(parser.getFiles().at("doc").size, payload.size());
+}
+
+TEST(File_StreamingCallbackAbort) {
+    std::string body = buildBody(filePayload(100));
+    MultipartParser parser(kBoundary);
+    parser.onFileData([](const UploadedFile&, const char*, size_t) { return false; });
+    ASSERT_FALSE(parser.parse(body.data(), body.size()));
+    ASSERT_FALSE(parser.error().empty());
+}
+
+int main() {
+    std::cout << "========================================" << std::endl;
+    std::cout << "Multipart Parser Unit Tests" << std::endl;
+    std::cout << "========================================" << std::endl << std::endl;
+
+    std::cout << "Parse Tests:" << std::endl;
+    RUN_TEST(Parse_FieldsAndFile);
+    RUN_TEST(Parse_EveryChunkSplit);
+    RUN_TEST(Parse_MissingCloseDelimiter);
+    RUN_TEST(Parse_HeadersTooLarge);
+
+    std::cout << std::endl << "File Tests:" << std::endl;
+    RUN_TEST(File_OversizeSkipped);
+    RUN_TEST(File_SpillToDisk);
+    RUN_TEST(File_SpillCloseFailure);
+    RUN_TEST(File_StreamingCallback);
+    RUN_TEST(File_StreamingCallbackAbort);
+
+    std::cout << std::endl << "========================================" << std::endl;
+    std::cout << "Test Results:" << std::endl;
+    std::cout << "  Total: " << test_count << std::endl;
+    std::cout << "  Passed: " << passed_count << std::endl;
+    std::cout << "  Failed: " << (test_count - passed_count) << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    if (test_count == passed_count) {
+        std::cout << "All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "Some tests failed!" << std::endl;
+        return 1;
+    }
+}
@@ -1,5 +1,9 @@
 #include <gtest/gtest.h>
 #include "object_pool.h"
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
 #include <thread>
 #include <vector>
 
@@ -60,7 +64,8 @@ TEST_F(ObjectPoolTest, MaxSizeLimit) {
     
     objects.clear();
     
-    EXPECT_EQ(pool.size(), 50);
+    // 归还的 20 个都在上限（50）以内，全部保留
+    EXPECT_EQ(pool.size(), 20);
 }
 
 TEST_F(ObjectPoolTest, Resize) {
@@ -94,7 +99,176 @@ TEST_F(ObjectPoolTest, ThreadSafety) {
         thread.join();
     }
     
-    EXPECT_EQ(pool.size(), 10);
+    // 每个线程同时最多持有一个对象：预分配的对象被某个线程整批取走时，其他线程各自至多新建一个
+    EXPECT_GE(pool.size(), 10);
+    EXPECT_LE(pool.size(), 10 + num_threads);
+}
+
+TEST_F(ObjectPoolTest, ObjectsAreReused) {
+    ObjectPool<TestObject> pool(1);
+    
+    TestObject* first = nullptr;
+    {
+        auto obj = pool.acquire();
+        first = obj.get();
+    }
+    auto again = pool.acquire();
+    EXPECT_EQ(again.get(), first);
+}
+
+TEST_F(ObjectPoolTest, CrossThreadRelease) {
+    ObjectPool<TestObject> pool(30);  // 仓库上限 300
+    
+    std::vector<ObjectPool<TestObject>::Handle> handles;
+    for (int i = 0; i < 200; ++i) {
+        handles.push_back(pool.acquire());
+    }
+    
+    // 在另一个线程归还：线程退出时其缓存整体转入仓库
+    std::thread consumer([&handles]() {
+        handles.clear();
+    });
+    consumer.join();
+    
+    EXPECT_EQ(pool.size(), 200);
+    
+    // 本线程可以从仓库取回，不再新建
+    auto obj = pool.acquire();
+    EXPECT_EQ(pool.size(), 199);
+}
+
+TEST_F(ObjectPoolTest, OverflowBeyondMaxIsDestroyed) {
+    static std::atomic<int> live(0);
+    struct Counted {
+        Counted() { live++; }
+        ~Counted() { live--; }
+    };
+    
+    {
+        ObjectPool<Counted> pool(1);  // 上限 10
+        std::vector<ObjectPool<Counted>::Handle> handles;
+        for (int i = 0; i < 100; ++i) {
+            handles.push_back(pool.acquire());
+        }
+        handles.clear();
+        EXPECT_LE(pool.size(), 20);
+        EXPECT_EQ(live.load(), static_cast<int>(pool.size()));
+    }
+    EXPECT_EQ(live.load(), 0);
+}
+
+TEST_F(ObjectPoolTest, PoolResetOnRelease) {
+    ObjectPool<std::string> pool(1);
+    {
+        auto s = pool.acquire();
+        s->assign("kept");
+    }
+    // 默认的 PoolReset 不修改对象
+    auto s = pool.acquire();
+    EXPECT_EQ(*s, "kept");
+}
+
+TEST_F(ObjectPoolTest, SlabAllocatorSizeClasses) {
+    EXPECT_EQ(SlabAllocator::classIndex(1), 0u);
+    EXPECT_EQ(SlabAllocator::classIndex(16), 0u);
+    EXPECT_EQ(SlabAllocator::classIndex(17), 1u);
+    EXPECT_EQ(SlabAllocator::classIndex(4096), 8u);
+    
+    SlabAllocator slab;
+    void* a = slab.allocate(24);
+    void* b = slab.allocate(24);
+    EXPECT_NE(a, b);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(a) % 16, 0u);
+    std::memset(a, 0xab, 24);
+    EXPECT_EQ(slab.reservedBytes(), static_cast<size_t>(SlabAllocator::kChunkSize));
+    
+    slab.deallocate(a, 24);
+    EXPECT_EQ(slab.allocate(20), a);
+    
+    void* big = slab.allocate(10000);
+    slab.deallocate(big, 10000);
+    slab.deallocate(b, 24);
+}
+
+TEST_F(ObjectPoolTest, SlabAllocatorCrossThreadFree) {
+    SlabAllocator slab;
+    std::vector<void*> blocks;
+    for (int i = 0; i < 1000; ++i) {
+        blocks.push_back(slab.allocate(64));
+    }
+    std::thread freer([&slab, &blocks]() {
+        for (size_t i = 0; i < blocks.size(); ++i) {
+            slab.deallocate(blocks[i], 64);
+        }
+    });
+    freer.join();
+    
+    // 归还的块重新可用，不再申请新的大块
+    size_t reserved = slab.reservedBytes();
+    for (int i = 0; i < 1000; ++i) {
+        blocks[static_cast<size_t>(i)] = slab.allocate(64);
+    }
+    EXPECT_EQ(slab.reservedBytes(), reserved);
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        slab.deallocate(blocks[i], 64);
+    }
+}
+
+// 竞争基准：多个线程同时取放，对比直接 new / delete（只打印耗时，不对速度做断言）
+TEST_F(ObjectPoolTest, ContentionBenchmark) {
+    const int num_threads = 8;
+    const int operations_per_thread = 200000;
+    
+    auto run = [&](const std::function<void()>& body) {
+        std::vector<std::thread> threads;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < num_threads; ++i) {
+            threads.emplace_back(body);
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    };
+    
+    ObjectPool<TestObject> pool(64);
+    auto pooled_us = run([&pool, operations_per_thread]() {
+        for (int j = 0; j < operations_per_thread; ++j) {
+            auto a = pool.acquire();
+            auto b = pool.acquire();
+            a->value = j;
+            b->value = j;
+        }
+    });
+    
+    SlabAllocator slab;
+    auto slab_us = run([&slab, operations_per_thread]() {
+        for (int j = 0; j < operations_per_thread; ++j) {
+            void* a = slab.allocate(sizeof(TestObject));
+            void* b = slab.allocate(200);
+            slab.deallocate(a, sizeof(TestObject));
+            slab.deallocate(b, 200);
+        }
+    });
+    
+    // 指针写入原子变量，避免编译器消除成对的 new / delete
+    static std::atomic<void*> sink(nullptr);
+    auto heap_us = run([operations_per_thread]() {
+        for (int j = 0; j < operations_per_thread; ++j) {
+            TestObject* a = new TestObject(j);
+            char* b = new char[200];
+            sink.store(a, std::memory_order_relaxed);
+            sink.store(b, std::memory_order_relaxed);
+            delete a;
+            delete[] b;
+        }
+    });
+    
+    std::cout << "  [bench] " << num_threads << " threads x " << operations_per_thread << " x 2 ops: "
+              << "ObjectPool " << pooled_us << "us, SlabAllocator " << slab_us << "us, new/delete "
+              << heap_us << "us" << std::endl;
+    
+    EXPECT_LE(pool.size(), 64 * 10 + num_threads * detail::kPoolLocalCapacity);
 }
 
 TEST_F(ObjectPoolTest, MemoryPoolManagerSingleton) {
@@ -139,4 +313,18 @@ TEST_F(ObjectPoolTest, MemoryPoolManagerClear) {
     manager.clear();
     
     EXPECT_EQ(manager.poolCount(), 0);
-}
\ No newline at end of file
+}
+// 函数内静态的池（同框架的 requestPool）在进程退出时晚于主线程的线程表析构，
+// 析构时不能再访问已销毁的线程表（ASan 下为 heap-use-after-free）
+static ObjectPool<TestObject>& staticPool() {
+    static ObjectPool<TestObject> pool(4);
+    return pool;
+}
+
+TEST_F(ObjectPoolTest, StaticPoolOutlivesThreadTable) {
+    {
+        auto obj = staticPool().acquire();
+        obj->value = 7;
+    }
+    EXPECT_EQ(staticPool().size(), 4);
+}
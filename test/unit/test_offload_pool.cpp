@@ -0,0 +1,248 @@
+/**
+ * @file test_offload_pool.cpp
+ * @brief 单元测试：offload 工作窃取线程池
+ */
+
+#include <iostream>
+#include <cassert>
+#include <cstdlib>
+#include "../../include/offload_pool.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+using namespace uvapi::offload;
+
+int test_count = 0;
+int passed_count = 0;
+
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { \
+    test_count++; \
+    std::cout << "Running test: " << #name << "..."; \
+    test_##name(); \
+    std::cout << " PASSED" << std::endl; \
+    passed_count++; \
+} while(0)
+
+#define ASSERT_TRUE(expr) do { \
+    if (!(expr)) { \
+        std::cerr << "\n  FAILED: " << #expr << " is false" << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+#define ASSERT_FALSE(expr) ASSERT_TRUE(!(expr))
+
+#define ASSERT_EQ(a, b) do { \
+    if ((a) != (b)) { \
+        std::cerr << "\n  FAILED: " << #a << " != " << #b << std::endl; \
+        std::cerr << "    Expected: " << (b) << ", Got: " << (a) << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+// 阻塞工作线程直到 open() 被调用
+struct Gate {
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool is_open;
+
+    Gate() : is_open(false) {}
+
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [this]() { return is_open; });
+    }
+
+    void open() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            is_open = true;
+        }
+        cv.notify_all();
+    }
+};
+
+// 最多等待 2 秒
+template<typename Predicate>
+bool waitFor(Predicate predicate) {
+    for (int i = 0; i < 2000; i++) {
+        if (predicate()) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return predicate();
+}
+
+// ========== 配置 ==========
+
+TEST(Policy_Defaults) {
+    OffloadPolicy policy;
+    ASSERT_EQ(policy.thread_count, 0u);
+    ASSERT_EQ(policy.max_queue, 1024u);
+    policy.threads(3).maxQueue(0);
+    ASSERT_EQ(policy.thread_count, 3u);
+    ASSERT_EQ(policy.max_queue, 1u);
+}
+
+TEST(Policy_ZeroThreadsUsesCores) {
+    WorkStealingPool pool(OffloadPolicy().threads(0));
+    ASSERT_TRUE(pool.threadCount() >= 1);
+}
+
+// ========== 执行 ==========
+
+TEST(Pool_RunsAllTasks) {
+    WorkStealingPool pool(OffloadPolicy().threads(4).maxQueue(10000));
+    std::atomic<int> done(0);
+    for (int i = 0; i < 1000; i++) {
+        ASSERT_TRUE(pool.submit([&done]() { done.fetch_add(1); }));
+    }
+    ASSERT_TRUE(waitFor([&done]() { return done.load() == 1000; }));
+    ASSERT_TRUE(waitFor([&pool]() { return pool.stats().completed == 1000; }));
+    OffloadStats stats = pool.stats();
+    ASSERT_EQ(stats.submitted, 1000u);
+    ASSERT_EQ(stats.rejected, 0u);
+    ASSERT_EQ(stats.queued, 0u);
+}
+
+TEST(Pool_IdleWorkerSteals) {
+    // 两个线程：第一个任务阻塞一个线程，轮转进入其队列的任务由另一个线程窃取
+    WorkStealingPool pool(OffloadPolicy().threads(2));
+    Gate gate;
+    std::atomic<int> done(0);
+    ASSERT_TRUE(pool.submit([&gate]() { gate.wait(); }));
+    for (int i = 0; i < 10; i++) {
+        ASSERT_TRUE(pool.submit([&done]() { done.fetch_add(1); }));
+    }
+    ASSERT_TRUE(waitFor([&done]() { return done.load() == 10; }));
+    gate.open();
+}
+
+TEST(Pool_NestedSubmitRunsOnPool) {
+    WorkStealingPool pool(OffloadPolicy().threads(2));
+    std::atomic<bool> nested_on_pool(false);
+    std::atomic<bool> outer_on_pool(false);
+    ASSERT_FALSE(pool.onWorkerThread());
+    ASSERT_TRUE(pool.submit([&pool, &nested_on_pool, &outer_on_pool]() {
+        outer_on_pool.store(pool.onWorkerThread());
+        pool.submit([&pool, &nested_on_pool]() { nested_on_pool.store(pool.onWorkerThread()); });
+    }));
+    ASSERT_TRUE(waitFor([&nested_on_pool]() { return nested_on_pool.load(); }));
+    ASSERT_TRUE(outer_on_pool.load());
+}
+
+// ========== 有界队列 ==========
+
+TEST(Pool_RejectsWhenFull) {
+    WorkStealingPool pool(OffloadPolicy().threads(1).maxQueue(2));
+    Gate gate;
+    std::atomic<bool> started(false);
+    ASSERT_TRUE(pool.submit([&gate, &started]() {
+        started.store(true);
+        gate.wait();
+    }));
+    ASSERT_TRUE(waitFor([&started]() { return started.load(); }));
+    // 正在执行的任务不计入排队上限
+    ASSERT_TRUE(pool.submit([]() {}));
+    ASSERT_TRUE(pool.submit([]() {}));
+    ASSERT_FALSE(pool.submit([]() {}));
+    OffloadStats stats = pool.stats();
+    ASSERT_EQ(stats.queued, 2u);
+    ASSERT_EQ(stats.running, 1u);
+    ASSERT_EQ(stats.rejected, 1u);
+    gate.open();
+    ASSERT_TRUE(waitFor([&pool]() { return pool.stats().completed == 3; }));
+    ASSERT_TRUE(pool.submit([]() {}));
+}
+
+TEST(Pool_RejectsEmptyTask) {
+    WorkStealingPool pool(OffloadPolicy().threads(1));
+    ASSERT_FALSE(pool.submit(WorkStealingPool::Task()));
+}
+
+TEST(Pool_DestructorDropsQueued) {
+    std::atomic<int> ran(0);
+    std::shared_ptr<int> token = std::make_shared<int>(0);
+    Gate gate;
+    std::atomic<bool> started(false);
+    std::thread opener;
+    {
+        WorkStealingPool pool(OffloadPolicy().threads(1));
+        pool.submit([&gate, &started]() {
+            started.store(true);
+            gate.wait();
+        });
+        ASSERT_TRUE(waitFor([&started]() { return started.load(); }));
+        for (int i = 0; i < 5; i++) {
+            pool.submit([&ran, token]() { ran.fetch_add(1); });
+        }
+        ASSERT_EQ(token.use_count(), 6);
+        // 析构时置停止标志并等待线程：放行后正在执行的任务结束，排队的任务随队列销毁
+        opener = std::thread([&gate]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            gate.open();
+        });
+    }
+    opener.join();
+    ASSERT_TRUE(ran.load() <= 5);
+    ASSERT_EQ(token.use_count(), 1);
+}
+
+// ========== 指标 ==========
+
+TEST(Metrics_Exported) {
+    uvapi::metrics::MetricRegistry registry;
+    WorkStealingPool pool(OffloadPolicy().threads(1));
+    pool.registerMetrics(registry);
+    std::atomic<int> done(0);
+    for (int i = 0; i < 3; i++) {
+        pool.submit([&done]() { done.fetch_add(1); });
+    }
+    ASSERT_TRUE(waitFor([&done]() { return done.load() == 3; }));
+    ASSERT_TRUE(waitFor([&pool]() { return pool.waitHistogram()->count() == 3; }));
+    std::string text = registry.toPrometheus();
+    ASSERT_TRUE(text.find("uvapi_offload_queue_depth 0") != std::string::npos);
+    ASSERT_TRUE(text.find("uvapi_offload_wait_seconds_count 3") != std::string::npos);
+    ASSERT_TRUE(text.find("uvapi_offload_rejected_total 0") != std::string::npos);
+}
+
+int main() {
+    std::cout << "========================================" << std::endl;
+    std::cout << "Offload Pool Unit Tests" << std::endl;
+    std::cout << "========================================" << std::endl << std::endl;
+
+    std::cout << "Policy Tests:" << std::endl;
+    RUN_TEST(Policy_Defaults);
+    RUN_TEST(Policy_ZeroThreadsUsesCores);
+
+    std::cout << std::endl << "Pool Tests:" << std::endl;
+    RUN_TEST(Pool_RunsAllTasks);
+    RUN_TEST(Pool_IdleWorkerSteals);
+    RUN_TEST(Pool_NestedSubmitRunsOnPool);
+    RUN_TEST(Pool_RejectsWhenFull);
+    RUN_TEST(Pool_RejectsEmptyTask);
+    RUN_TEST(Pool_DestructorDropsQueued);
+
+    std::cout << std::endl << "Metrics Tests:" << std::endl;
+    RUN_TEST(Metrics_Exported);
+
+    std::cout << std::endl << "========================================" << std::endl;
+    std::cout << "Test Results:" << std::endl;
+    std::cout << "  Total: " << test_count << std::endl;
+    std::cout << "  Passed: " << passed_count << std::endl;
+    std::cout << "  Failed: " << (test_count - passed_count) << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    if (test_count == passed_count) {
+        std::cout << "All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "Some tests failed!" << std::endl;
+        return 1;
+    }
+}
@@ -433,6 +433,57 @@ TEST(ErrorMessage_InvalidBool) {
     ASSERT_NE(msg.find("Invalid boolean"), std::string::npos);
 }
 
+// ========== 视图与类型化绑定测试 ==========
+
+TEST(View_PointsIntoMapStorage) {
+    std::map<std::string, std::string> params;
+    params["id"] = "42";
+    ParamAccessor accessor(params);
+    
+    ParamValue pv = accessor["id"];
+    ASSERT_TRUE(pv.slice().data == params["id"].data());
+    ASSERT_EQ(pv.as<int>().value(), 42);
+}
+
+TEST(StaticParser_IntOverflow) {
+    long long value = 0;
+    ASSERT_TRUE(ParamValue::parseInt(StringSlice("9223372036854775807"), value) == ParamValue::Error::NONE);
+    ASSERT_EQ(value, std::numeric_limits<long long>::max());
+    ASSERT_TRUE(ParamValue::parseInt(StringSlice("9223372036854775808"), value) == ParamValue::Error::INTEGER_OVERFLOW);
+    ASSERT_TRUE(ParamValue::parseInt(StringSlice("12a"), value) == ParamValue::Error::INVALID_INTEGER);
+}
+
+TEST(BoundParams_TypedSlots) {
+    std::string page = "page";
+    std::string active = "active";
+    BoundParams bound;
+    BoundParams::Slot* slot = bound.slot(0, &page);
+    slot->int_value = 3;
+    slot->text = StringSlice("3");
+    slot = bound.slot(1, &active);
+    slot->bool_value = true;
+    slot->text = StringSlice("true");
+    
+    ASSERT_TRUE(bound.has("page"));
+    ASSERT_EQ(bound.get<int>("page"), 3);
+    ASSERT_EQ(bound.get<int64_t>("page"), 3);
+    ASSERT_TRUE(bound.get<bool>("active"));
+    ASSERT_EQ(bound.get<std::string>("active"), "true");
+    ASSERT_TRUE(bound.text("page") == StringSlice("3"));
+}
+
+TEST(BoundParams_MissingUsesFallback) {
+    std::string limit = "limit";
+    BoundParams bound;
+    bound.slot(1, &limit)->int_value = 10;
+    bound.slot(0, nullptr);  // 槽位 0 未出现在请求中
+    
+    ASSERT_FALSE(bound.has("offset"));
+    ASSERT_EQ(bound.get<int>("offset", 7), 7);
+    ASSERT_EQ(bound.get<int>("limit", 7), 10);
+    ASSERT_TRUE(bound.slot(BoundParams::kMaxSlots, &limit) == nullptr);
+}
+
 // ========== 主函数 ==========
 
 int main() {
@@ -515,6 +566,13 @@ int main() {
     RUN_TEST(ErrorMessage_InvalidInt);
     RUN_TEST(ErrorMessage_InvalidBool);
     
+    // 视图与类型化绑定测试
+    std::cout << std::endl << "View and Binding Tests:" << std::endl;
+    RUN_TEST(View_PointsIntoMapStorage);
+    RUN_TEST(StaticParser_IntOverflow);
+    RUN_TEST(BoundParams_TypedSlots);
+    RUN_TEST(BoundParams_MissingUsesFallback);
+    
     // 打印结果
     std::cout << std::endl << "========================================" << std::endl;
     std::cout << "Test Results:" << std::endl;
@@ -0,0 +1,247 @@
+/**
+ * @file test_pipeline.cpp
+ * @brief 单元测试：扁平中间件流水线和编译期流水线
+ */
+
+#include <iostream>
+#include <cassert>
+#include <cstdlib>
+#include <cstddef>
+#include <vector>
+#include <new>
+#include <string>
+#include "../../include/pipeline.h"
+
+using namespace uvapi;
+
+int test_count = 0;
+int passed_count = 0;
+
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { \
+    test_count++; \
+    std::cout << "Running test: " << #name << "..."; \
+    test_##name(); \
+    std::cout << " PASSED" << std::endl; \
+    passed_count++; \
+} while(0)
+
+#define ASSERT_TRUE(expr) do { \
+    if (!(expr)) { \
+        std::cerr << "\n  FAILED: " << #expr << " is false" << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+#define ASSERT_FALSE(expr) ASSERT_TRUE(!(expr))
+
+#define ASSERT_EQ(a, b) do { \
+    if ((a) != (b)) { \
+        std::cerr << "\n  FAILED: " << #a << " != " << #b << std::endl; \
+        std::cerr << "    Expected: " << (b) << ", Got: " << (a) << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+
+// 统计全局分配次数，验证请求路径上没有堆分配
+static size_t g_allocations = 0;
+
+void* operator new(std::size_t size) {
+    ++g_allocations;
+    void* ptr = std::malloc(size ? size : 1);
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+struct Req {
+    std::string path;
+    bool authorized;
+};
+
+struct Resp {
+    int status;
+    std::string trace;
+};
+
+typedef BasicMiddlewarePipeline<Req, Resp> Chain;
+
+// ========== 运行期流水线 ==========
+
+TEST(Runtime_OrderAndTerminal) {
+    std::vector<Chain::Stage> stages;
+    stages.push_back([](const Req& req, const Chain::Next& next) {
+        Resp resp = next(req);
+        resp.trace = "a" + resp.trace;
+        return resp;
+    });
+    stages.push_back([](const Req& req, const Chain::Next& next) {
+        Resp resp = next(req);
+        resp.trace = "b" + resp.trace;
+        return resp;
+    });
+    Chain chain(stages, [](const Req&) { Resp r; r.status = 200; r.trace = "h"; return r; });
+    Req req;
+    req.authorized = true;
+    Resp resp = chain.run(req);
+    ASSERT_EQ(resp.status, 200);
+    ASSERT_EQ(resp.trace, "abh");
+    ASSERT_EQ(chain.size(), static_cast<size_t>(2));
+}
+
+TEST(Runtime_ShortCircuit) {
+    std::vector<Chain::Stage> stages;
+    stages.push_back([](const Req& req, const Chain::Next& next) {
+        if (!req.authorized) {
+            Resp r;
+            r.status = 401;
+            return r;
+        }
+        return next(req);
+    });
+    int handler_calls = 0;
+    Chain chain(stages, [&handler_calls](const Req&) { ++handler_calls; Resp r; r.status = 200; return r; });
+    Req req;
+    req.authorized = false;
+    ASSERT_EQ(chain.run(req).status, 401);
+    ASSERT_EQ(handler_calls, 0);
+    req.authorized = true;
+    ASSERT_EQ(chain(req).status, 200);
+    ASSERT_EQ(handler_calls, 1);
+}
+
+TEST(Runtime_NextCanBeCalledTwice) {
+    std::vector<Chain::Stage> stages;
+    stages.push_back([](const Req& req, const Chain::Next& next) {
+        ASSERT_EQ(next.remaining(), static_cast<size_t>(1));
+        Resp first = next(req);
+        return first.status == 503 ? next(req) : first;
+    });
+    stages.push_back([](const Req& req, const Chain::Next& next) {
+        ASSERT_EQ(next.remaining(), static_cast<size_t>(0));
+        return next(req);
+    });
+    int attempts = 0;
+    Chain chain(stages, [&attempts](const Req&) { Resp r; r.status = ++attempts == 1 ? 503 : 200; return r; });
+    Req req;
+    ASSERT_EQ(chain.run(req).status, 200);
+    ASSERT_EQ(attempts, 2);
+}
+
+TEST(Runtime_NoAllocationPerRequest) {
+    std::vector<Chain::Stage> stages;
+    for (int i = 0; i < 8; ++i) {
+        stages.push_back([](const Req& req, const Chain::Next& next) { return next(req); });
+    }
+    Chain chain(stages, [](const Req&) { Resp r; r.status = 204; return r; });
+    Req req;
+    size_t before = g_allocations;
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_EQ(chain.run(req).status, 204);
+    }
+    ASSERT_EQ(g_allocations, before);
+}
+
+// ========== 编译期流水线 ==========
+
+struct Tag {
+    char name;
+    template<typename Next>
+    Resp operator()(const Req& req, const Next& next) const {
+        Resp resp = next(req);
+        resp.trace = name + resp.trace;
+        return resp;
+    }
+};
+
+struct Guard {
+    template<typename Next>
+    Resp operator()(const Req& req, const Next& next) const {
+        if (!req.authorized) {
+            Resp r;
+            r.status = 401;
+            return r;
+        }
+        return next(req);
+    }
+};
+
+struct Handler {
+    Resp operator()(const Req& req) const {
+        Resp r;
+        r.status = 200;
+        r.trace = req.path;
+        return r;
+    }
+};
+
+TEST(Static_OrderAndShortCircuit) {
+    Tag x = { 'x' };
+    Tag y = { 'y' };
+    StaticPipeline<Req, Resp, Tag, Guard, Tag, Handler> pipeline(x, Guard(), y, Handler());
+    Req req;
+    req.path = "/p";
+    req.authorized = true;
+    Resp resp = pipeline(req);
+    ASSERT_EQ(resp.status, 200);
+    ASSERT_EQ(resp.trace, "xy/p");
+    req.authorized = false;
+    resp = pipeline(req);
+    ASSERT_EQ(resp.status, 401);
+    ASSERT_EQ(resp.trace, "x");
+    ASSERT_EQ(pipeline.stage<0>().name, 'x');
+}
+
+TEST(Static_HandlerOnlyAndNesting) {
+    StaticPipeline<Req, Resp, Handler> bare;
+    Req req;
+    req.path = "/q";
+    req.authorized = true;
+    ASSERT_EQ(bare(req).trace, "/q");
+
+    // 一条流水线可以作为另一条的最后一级，也可以作为运行期流水线的终点
+    typedef StaticPipeline<Req, Resp, Guard, Handler> Inner;
+    Tag t = { 't' };
+    StaticPipeline<Req, Resp, Tag, Inner> outer(t, Inner());
+    ASSERT_EQ(outer(req).trace, "t/q");
+    std::vector<Chain::Stage> none;
+    Chain chain(none, Inner());
+    ASSERT_EQ(chain.run(req).trace, "/q");
+}
+
+int main() {
+    std::cout << "========================================" << std::endl;
+    std::cout << "Pipeline Unit Tests" << std::endl;
+    std::cout << "========================================" << std::endl << std::endl;
+
+    std::cout << "Runtime Pipeline Tests:" << std::endl;
+    RUN_TEST(Runtime_OrderAndTerminal);
+    RUN_TEST(Runtime_ShortCircuit);
+    RUN_TEST(Runtime_NextCanBeCalledTwice);
+    RUN_TEST(Runtime_NoAllocationPerRequest);
+
+    std::cout << std::endl << "Static Pipeline Tests:" << std::endl;
+    RUN_TEST(Static_OrderAndShortCircuit);
+    RUN_TEST(Static_HandlerOnlyAndNesting);
+
+    std::cout << std::endl << "========================================" << std::endl;
+    std::cout << "Test Results:" << std::endl;
+    std::cout << "  Total: " << test_count << std::endl;
+    std::cout << "  Passed: " << passed_count << std::endl;
+    std::cout << "  Failed: " << (test_count - passed_count) << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    if (test_count == passed_count) {
+        std::cout << "All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "Some tests failed!" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,203 @@
+/**
+ * @file test_query_string.cpp
+ * @brief 单元测试：查询字符串单遍解析与百分号解码
+ */
+
+#include <iostream>
+#include <cassert>
+#include <cstdlib>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../../include/query_string.h"
+
+using namespace uvapi;
+
+int test_count = 0;
+int passed_count = 0;
+
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { \
+    test_count++; \
+    std::cout << "Running test: " << #name << "..."; \
+    test_##name(); \
+    std::cout << " PASSED" << std::endl; \
+    passed_count++; \
+} while(0)
+
+#define ASSERT_TRUE(expr) do { \
+    if (!(expr)) { \
+        std::cerr << "\n  FAILED: " << #expr << " is false" << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+#define ASSERT_FALSE(expr) ASSERT_TRUE(!(expr))
+
+#define ASSERT_EQ(a, b) do { \
+    if ((a) != (b)) { \
+        std::cerr << "\n  FAILED: " << #a << " != " << #b << std::endl; \
+        std::cerr << "    Expected: " << (b) << ", Got: " << (a) << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+typedef std::vector<std::pair<std::string, std::string> > Pairs;
+
+// 解析到 std::string 对，记录 scratch 的调用次数
+struct Parsed {
+    Pairs pairs;
+    std::string buffer;
+    int scratch_calls;
+    bool raw_pointers;  // 所有切片都指向原文
+
+    Parsed() : scratch_calls(0), raw_pointers(true) {}
+};
+
+static Parsed parse(const std::string& query, bool allow_scratch = true) {
+    Parsed out;
+    const char* begin = query.data();
+    const char* end = begin + query.size();
+    query::forEachParam(query.data(), query.size(),
+        [&out, allow_scratch](size_t n) -> char* {
+            out.scratch_calls++;
+            if (!allow_scratch) {
+                return nullptr;
+            }
+            out.buffer.resize(n);
+            return &out.buffer[0];
+        },
+        [&out, begin, end](const StringSlice& key, const StringSlice& value) {
+            ASSERT_TRUE(value.valid());
+            if (key.data < begin || key.data >= end || value.data < begin || value.data > end) {
+                out.raw_pointers = false;
+            }
+            out.pairs.push_back(std::make_pair(key.toString(), value.toString()));
+        });
+    return out;
+}
+
+// ========== 扫描 ==========
+
+TEST(FindSpecial_LongRuns) {
+    // 跨越 16 / 8 字节块边界
+    for (size_t pos = 0; pos < 40; pos++) {
+        std::string s(40, 'a');
+        s[pos] = '%';
+        ASSERT_EQ(query::findSpecial(s.data(), 0, s.size()), pos);
+    }
+    std::string plain(37, 'x');
+    ASSERT_EQ(query::findSpecial(plain.data(), 0, plain.size()), plain.size());
+    ASSERT_EQ(query::findSpecial("abc&def", 4, 7), 7u);
+}
+
+// ========== 切分 ==========
+
+TEST(Parse_PlainPairsPointIntoQuery) {
+    Parsed p = parse("page=2&limit=20&sort=name");
+    ASSERT_EQ(p.pairs.size(), 3u);
+    ASSERT_EQ(p.pairs[0].first, "page");
+    ASSERT_EQ(p.pairs[0].second, "2");
+    ASSERT_EQ(p.pairs[2].first, "sort");
+    ASSERT_EQ(p.pairs[2].second, "name");
+    // 没有需要解码的片段时不申请缓冲区
+    ASSERT_EQ(p.scratch_calls, 0);
+    ASSERT_TRUE(p.raw_pointers);
+}
+
+TEST(Parse_KeyWithoutValueAndEmptySegments) {
+    Parsed p = parse("&debug&&q=&=orphan&a=b=c&");
+    ASSERT_EQ(p.pairs.size(), 3u);
+    ASSERT_EQ(p.pairs[0].first, "debug");
+    ASSERT_EQ(p.pairs[0].second, "");
+    ASSERT_EQ(p.pairs[1].first, "q");
+    ASSERT_EQ(p.pairs[1].second, "");
+    // 只有第一个 '=' 分隔键值
+    ASSERT_EQ(p.pairs[2].first, "a");
+    ASSERT_EQ(p.pairs[2].second, "b=c");
+}
+
+TEST(Parse_RepeatedKeysKeepOrder) {
+    Parsed p = parse("tag=a&id=1&tag=b&tag=c");
+    ASSERT_EQ(p.pairs.size(), 4u);
+    ASSERT_EQ(p.pairs[0].second, "a");
+    ASSERT_EQ(p.pairs[2].second, "b");
+    ASSERT_EQ(p.pairs[3].second, "c");
+}
+
+// ========== 解码 ==========
+
+TEST(Decode_PercentAndPlus) {
+    Parsed p = parse("name=J%C3%BCrgen+M&file%5B%5D=a%2fb&x=100%25");
+    ASSERT_EQ(p.pairs.size(), 3u);
+    ASSERT_EQ(p.pairs[0].second, "J\xC3\xBCrgen M");
+    ASSERT_EQ(p.pairs[1].first, "file[]");
+    ASSERT_EQ(p.pairs[1].second, "a/b");
+    ASSERT_EQ(p.pairs[2].second, "100%");
+    // 整个查询字符串只申请一次
+    ASSERT_EQ(p.scratch_calls, 1);
+}
+
+TEST(Decode_InvalidSequencesKeptLiterally) {
+    Parsed p = parse("a=%zz&b=50%&c=%4");
+    ASSERT_EQ(p.pairs.size(), 3u);
+    ASSERT_EQ(p.pairs[0].second, "%zz");
+    ASSERT_EQ(p.pairs[1].second, "50%");
+    ASSERT_EQ(p.pairs[2].second, "%4");
+}
+
+TEST(Decode_InPlace) {
+    char buf[] = "a%20b+c";
+    size_t n = query::decode(buf, 7, buf);
+    ASSERT_EQ(std::string(buf, n), "a b c");
+}
+
+TEST(Decode_NoScratchKeepsRaw) {
+    Parsed p = parse("q=a+b&r=%41", false);
+    ASSERT_EQ(p.scratch_calls, 1);
+    ASSERT_EQ(p.pairs[0].second, "a+b");
+    ASSERT_EQ(p.pairs[1].second, "%41");
+    ASSERT_TRUE(p.raw_pointers);
+}
+
+TEST(Parse_EmptyQuery) {
+    Parsed p = parse("");
+    ASSERT_EQ(p.pairs.size(), 0u);
+    ASSERT_EQ(p.scratch_calls, 0);
+}
+
+int main() {
+    std::cout << "========================================" << std::endl;
+    std::cout << "Query String Unit Tests" << std::endl;
+    std::cout << "========================================" << std::endl << std::endl;
+
+    std::cout << "Scan Tests:" << std::endl;
+    RUN_TEST(FindSpecial_LongRuns);
+
+    std::cout << std::endl << "Split Tests:" << std::endl;
+    RUN_TEST(Parse_PlainPairsPointIntoQuery);
+    RUN_TEST(Parse_KeyWithoutValueAndEmptySegments);
+    RUN_TEST(Parse_RepeatedKeysKeepOrder);
+    RUN_TEST(Parse_EmptyQuery);
+
+    std::cout << std::endl << "Decode Tests:" << std::endl;
+    RUN_TEST(Decode_PercentAndPlus);
+    RUN_TEST(Decode_InvalidSequencesKeptLiterally);
+    RUN_TEST(Decode_InPlace);
+    RUN_TEST(Decode_NoScratchKeepsRaw);
+
+    std::cout << std::endl << "========================================" << std::endl;
+    std::cout << "Test Results:" << std::endl;
+    std::cout << "  Total: " << test_count << std::endl;
+    std::cout << "  Passed: " << passed_count << std::endl;
+    std::cout << "  Failed: " << (test_count - passed_count) << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    if (test_count == passed_count) {
+        std::cout << "All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "Some tests failed!" << std::endl;
+        return 1;
+    }
+}
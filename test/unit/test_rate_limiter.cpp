@@ -0,0 +1,315 @@
+/**
+ * @file test_rate_limiter.cpp
+ * @brief 单元测试：KeyedRateLimiter 按键 GCRA 限流、SlidingWindow 与准入控制
+ */
+
+#include <iostream>
+#include <cassert>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../../include/rate_limiter.h"
+
+using namespace uvapi::rate;
+
+int test_count = 0;
+int passed_count = 0;
+
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { \
+    test_count++; \
+    std::cout << "Running test: " << #name << "..."; \
+    test_##name(); \
+    std::cout << " PASSED" << std::endl; \
+    passed_count++; \
+} while(0)
+
+#define ASSERT_TRUE(expr) do { \
+    if (!(expr)) { \
+        std::cerr << "\n  FAILED: " << #expr << " is false" << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+#define ASSERT_FALSE(expr) ASSERT_TRUE(!(expr))
+
+#define ASSERT_EQ(a, b) do { \
+    if ((a) != (b)) { \
+        std::cerr << "\n  FAILED: " << #a << " != " << #b << std::endl; \
+        std::cerr << "    Expected: " << (b) << ", Got: " << (a) << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+static const uint64_t kSecond = 1000000000ULL;
+
+// ========== GCRA 判定 ==========
+
+TEST(Gcra_BurstThenDeny) {
+    KeyedRateLimiter limiter(RateLimitPolicy(10, 5));
+    uint64_t t = kSecond;
+    for (int i = 0; i < 5; i++) {
+        RateLimitDecision d = limiter.tryAcquireAt("a", 1, t);
+        ASSERT_TRUE(d.allowed);
+        ASSERT_EQ(d.remaining, static_cast<uint64_t>(4 - i));
+    }
+    RateLimitDecision denied = limiter.tryAcquireAt("a", 1, t);
+    ASSERT_FALSE(denied.allowed);
+    ASSERT_EQ(denied.retry_after_ms, static_cast<uint64_t>(100));
+}
+
+TEST(Gcra_RefillsAtRate) {
+    KeyedRateLimiter limiter(RateLimitPolicy(10, 2));
+    uint64_t t = kSecond;
+    ASSERT_TRUE(limiter.tryAcquireAt("a", 1, t).allowed);
+    ASSERT_TRUE(limiter.tryAcquireAt("a", 1, t).allowed);
+    ASSERT_FALSE(limiter.tryAcquireAt("a", 1, t).allowed);
+
+    // 100ms 补充一个配额
+    ASSERT_FALSE(limiter.tryAcquireAt("a", 1, t + kSecond / 20).allowed);
+    ASSERT_TRUE(limiter.tryAcquireAt("a", 1, t + kSecond / 10).allowed);
+    ASSERT_FALSE(limiter.tryAcquireAt("a", 1, t + kSecond / 10).allowed);
+
+    // 长时间空闲后只恢复到 burst，不会无限积攒
+    uint64_t later = t + 10 * kSecond;
+    ASSERT_TRUE(limiter.tryAcquireAt("a", 1, later).allowed);
+    ASSERT_TRUE(limiter.tryAcquireAt("a", 1, later).allowed);
+    ASSERT_FALSE(limiter.tryAcquireAt("a", 1, later).allowed);
+}
+
+TEST(Gcra_KeysAreIsolated) {
+    KeyedRateLimiter limiter(RateLimitPolicy(1, 1));
+    uint64_t t = kSecond;
+    ASSERT_TRUE(limiter.tryAcquireAt("10.0.0.1", 8, t).allowed);
+    ASSERT_FALSE(limiter.tryAcquireAt("10.0.0.1", 8, t).allowed);
+    ASSERT_TRUE(limiter.tryAcquireAt("10.0.0.2", 8, t).allowed);
+    ASSERT_EQ(limiter.size(), static_cast<size_t>(2));
+}
+
+TEST(Gcra_WeightedCost) {
+    KeyedRateLimiter limiter(RateLimitPolicy(10, 5));
+    uint64_t t = kSecond;
+    ASSERT_TRUE(limiter.tryAcquireAt("a", 1, t, 3).allowed);
+    ASSERT_FALSE(limiter.tryAcquireAt("a", 1, t, 3).allowed);
+    ASSERT_TRUE(limiter.tryAcquireAt("a", 1, t, 2).allowed);
+}
+
+// ========== 回收与容量 ==========
+
+TEST(Table_SweepReclaimsIdleKeys) {
+    KeyedRateLimiter limiter(RateLimitPolicy(10, 1).idleTimeout(std::chrono::milliseconds(1000)));
+    uint64_t t = kSecond;
+    for (int i = 0; i < 100; i++) {
+        std::string key = "idle-" + std::to_string(i);
+        ASSERT_TRUE(limiter.tryAcquireAt(key.data(), key.size(), t).allowed);
+    }
+    uint64_t later = t + 5 * kSecond;
+    ASSERT_TRUE(limiter.tryAcquireAt("busy", 4, later).allowed);
+    ASSERT_EQ(limiter.size(), static_cast<size_t>(101));
+
+    ASSERT_EQ(limiter.sweepAt(later), static_cast<size_t>(100));
+    ASSERT_EQ(limiter.size(), static_cast<size_t>(1));
+    // 仍在使用的键保留原有状态
+    ASSERT_FALSE(limiter.tryAcquireAt("busy", 4, later).allowed);
+    // 被回收的键按满额重新开始
+    ASSERT_TRUE(limiter.tryAcquireAt("idle-0", 6, later).allowed);
+}
+
+TEST(Table_FullTableFailsOpenWhenAllowed) {
+    KeyedRateLimiter limiter(RateLimitPolicy(1, 1).maxKeys(1).onOverflow(OverflowAction::ALLOW));
+    uint64_t t = kSecond;
+    // 每个分片至少 8 个可用槽，足够多的键必然填满某些分片
+    for (int i = 0; i < 2000; i++) {
+        std::string key = std::to_string(i);
+        ASSERT_TRUE(limiter.tryAcquireAt(key.data(), key.size(), t).allowed);
+    }
+    ASSERT_TRUE(limiter.overflows() > 0);
+    ASSERT_TRUE(limiter.size() <= static_cast<size_t>(64 * 8));
+}
+
+TEST(Table_OverflowSharesShardBucket) {
+    KeyedRateLimiter limiter(RateLimitPolicy(1, 1).maxKeys(1));
+    uint64_t t = kSecond;
+    // 轮换键值：表满之后溢出的键共用每个分片的一个配额，通过数不超过表容量 + 分片数
+    int allowed = 0;
+    for (int i = 0; i < 5000; i++) {
+        std::string key = "rotating-" + std::to_string(i);
+        if (limiter.tryAcquireAt(key.data(), key.size(), t).allowed) {
+            allowed++;
+        }
+    }
+    ASSERT_TRUE(limiter.overflows() > 0);
+    ASSERT_TRUE(allowed <= static_cast<int>(limiter.size()) + 64);
+}
+
+TEST(Table_OverflowDeny) {
+    KeyedRateLimiter limiter(RateLimitPolicy(1, 1).maxKeys(1).onOverflow(OverflowAction::DENY));
+    uint64_t t = kSecond;
+    int denied = 0;
+    for (int i = 0; i < 2000; i++) {
+        std::string key = std::to_string(i);
+        RateLimitDecision decision = limiter.tryAcquireAt(key.data(), key.size(), t);
+        if (!decision.allowed) {
+            denied++;
+            ASSERT_TRUE(decision.retry_after_ms > 0);
+        }
+    }
+    ASSERT_EQ(static_cast<uint64_t>(denied), limiter.overflows());
+}
+
+TEST(Table_ConcurrentAcquireHonoursBurst) {
+    KeyedRateLimiter limiter(RateLimitPolicy(1, 100));
+    std::atomic<int> allowed(0);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; i++) {
+        threads.push_back(std::thread([&limiter, &allowed]() {
+            for (int j = 0; j < 1000; j++) {
+                if (limiter.tryAcquireAt("shared", 6, kSecond).allowed) {
+                    allowed.fetch_add(1);
+                }
+            }
+        }));
+    }
+    for (size_t i = 0; i < threads.size(); i++) {
+        threads[i].join();
+    }
+    ASSERT_EQ(allowed.load(), 100);
+}
+
+// ========== 滑动窗口 ==========
+
+TEST(Window_LimitsWithinWindow) {
+    SlidingWindow window(60000, 3);
+    ASSERT_TRUE(window.tryAcquire());
+    ASSERT_TRUE(window.tryAcquire());
+    ASSERT_TRUE(window.tryAcquire());
+    ASSERT_FALSE(window.tryAcquire());
+    ASSERT_EQ(window.currentRequests(), static_cast<uint64_t>(3));
+}
+
+TEST(Window_ExpiresOldRequests) {
+    SlidingWindow window(20, 2);
+    ASSERT_TRUE(window.tryAcquire());
+    ASSERT_TRUE(window.tryAcquire());
+    ASSERT_FALSE(window.tryAcquire());
+    std::this_thread::sleep_for(std::chrono::milliseconds(40));
+    ASSERT_EQ(window.currentRequests(), static_cast<uint64_t>(0));
+    ASSERT_TRUE(window.tryAcquire());
+}
+
+// ========== 准入控制 ==========
+
+TEST(Admission_ControllerCapsInFlight) {
+    AdmissionController controller(AdmissionPolicy(2));
+    ASSERT_TRUE(controller.tryAcquire());
+    ASSERT_TRUE(controller.tryAcquire());
+    ASSERT_FALSE(controller.tryAcquire());
+    ASSERT_EQ(controller.inFlight(), static_cast<uint64_t>(2));
+    controller.release();
+    ASSERT_TRUE(controller.tryAcquire());
+}
+
+TEST(Admission_ConcurrentAcquireNeverExceedsLimit) {
+    AdmissionController controller(AdmissionPolicy(3));
+    std::atomic<uint64_t> peak(0);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; i++) {
+        threads.push_back(std::thread([&controller, &peak]() {
+            for (int j = 0; j < 10000; j++) {
+                if (!controller.tryAcquire()) {
+                    continue;
+                }
+                uint64_t current = controller.inFlight();
+                uint64_t seen = peak.load();
+                while (current > seen && !peak.compare_exchange_weak(seen, current)) {
+                }
+                controller.release();
+            }
+        }));
+    }
+    for (size_t i = 0; i < threads.size(); i++) {
+        threads[i].join();
+    }
+    ASSERT_TRUE(peak.load() <= static_cast<uint64_t>(3));
+    ASSERT_EQ(controller.inFlight(), static_cast<uint64_t>(0));
+}
+
+TEST(Admission_QueueIsBoundedFifo) {
+    AdmissionQueue<int> queue(2);
+    ASSERT_TRUE(queue.push(1, 100));
+    ASSERT_TRUE(queue.push(2, 200));
+    ASSERT_FALSE(queue.push(3, 300));
+    ASSERT_EQ(queue.front(), 1);
+    ASSERT_EQ(queue.frontDeadline(), static_cast<uint64_t>(100));
+    queue.pop();
+    ASSERT_TRUE(queue.push(4, 400));
+    ASSERT_EQ(queue.front(), 2);
+    queue.pop();
+    ASSERT_EQ(queue.front(), 4);
+    queue.pop();
+    ASSERT_TRUE(queue.empty());
+}
+
+TEST(Admission_QueueStats) {
+    AdmissionQueue<int> queue(1);
+    queue.noteStarted();
+    ASSERT_TRUE(queue.push(1, 10));
+    ASSERT_FALSE(queue.push(2, 10));
+    queue.pop();
+    queue.noteTimedOut();
+    AdmissionStats stats = queue.stats();
+    ASSERT_EQ(stats.in_flight, static_cast<uint64_t>(1));
+    ASSERT_EQ(stats.queued, static_cast<uint64_t>(0));
+    ASSERT_EQ(stats.rejected, static_cast<uint64_t>(1));
+    ASSERT_EQ(stats.timed_out, static_cast<uint64_t>(1));
+
+    // 容量为 0：不排队，直接拒绝
+    AdmissionQueue<int> none(0);
+    ASSERT_FALSE(none.push(1, 10));
+    ASSERT_EQ(none.stats().rejected, static_cast<uint64_t>(1));
+}
+
+int main() {
+    std::cout << "========================================" << std::endl;
+    std::cout << "Rate Limiter Unit Tests" << std::endl;
+    std::cout << "========================================" << std::endl << std::endl;
+
+    std::cout << "GCRA Tests:" << std::endl;
+    RUN_TEST(Gcra_BurstThenDeny);
+    RUN_TEST(Gcra_RefillsAtRate);
+    RUN_TEST(Gcra_KeysAreIsolated);
+    RUN_TEST(Gcra_WeightedCost);
+
+    std::cout << std::endl << "Key Table Tests:" << std::endl;
+    RUN_TEST(Table_SweepReclaimsIdleKeys);
+    RUN_TEST(Table_FullTableFailsOpenWhenAllowed);
+    RUN_TEST(Table_OverflowSharesShardBucket);
+    RUN_TEST(Table_OverflowDeny);
+    RUN_TEST(Table_ConcurrentAcquireHonoursBurst);
+
+    std::cout << std::endl << "Sliding Window Tests:" << std::endl;
+    RUN_TEST(Window_LimitsWithinWindow);
+    RUN_TEST(Window_ExpiresOldRequests);
+
+    std::cout << std::endl << "Admission Tests:" << std::endl;
+    RUN_TEST(Admission_ControllerCapsInFlight);
+    RUN_TEST(Admission_ConcurrentAcquireNeverExceedsLimit);
+    RUN_TEST(Admission_QueueIsBoundedFifo);
+    RUN_TEST(Admission_QueueStats);
+
+    std::cout << std::endl << "========================================" << std::endl;
+    std::cout << "Test Results:" << std::endl;
+    std::cout << "  Total: " << test_count << std::endl;
+    std::cout << "  Passed: " << passed_count << std::endl;
+    std::cout << "  Failed: " << (test_count - passed_count) << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    if (test_count == passed_count) {
+        std::cout << "All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "Some tests failed!" << std::endl;
+        return 1;
+    }
+}
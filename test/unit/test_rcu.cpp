@@ -0,0 +1,239 @@
+/**
+ * @file test_rcu.cpp
+ * @brief 单元测试：只读快照的原子发布与按纪元回收
+ */
+
+#include <iostream>
+#include <cassert>
+#include <cstdlib>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "../../include/rcu.h"
+
+using namespace uvapi::rcu;
+
+int test_count = 0;
+int passed_count = 0;
+
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { \
+    test_count++; \
+    std::cout << "Running test: " << #name << "..."; \
+    test_##name(); \
+    std::cout << " PASSED" << std::endl; \
+    passed_count++; \
+} while(0)
+
+#define ASSERT_TRUE(expr) do { \
+    if (!(expr)) { \
+        std::cerr << "\n  FAILED: " << #expr << " is false" << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+#define ASSERT_FALSE(expr) ASSERT_TRUE(!(expr))
+
+#define ASSERT_EQ(a, b) do { \
+    if ((a) != (b)) { \
+        std::cerr << "\n  FAILED: " << #a << " != " << #b << std::endl; \
+        std::cerr << "    Expected: " << (b) << ", Got: " << (a) << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+// 析构时计数的快照
+struct Table {
+    int value;
+    std::atomic<int>* destroyed;
+
+    Table(int v, std::atomic<int>* counter) : value(v), destroyed(counter) {}
+    ~Table() { destroyed->fetch_add(1); }
+};
+
+typedef Cell<Table> TableCell;
+
+// ========== 发布 ==========
+
+TEST(Publish_ReplacesAndBumpsVersion) {
+    std::atomic<int> destroyed(0);
+    TableCell cell(std::make_shared<Table>(1, &destroyed));
+    TableCell::Reader* reader = cell.attach();
+    ASSERT_EQ(cell.version(), 1u);
+    {
+        TableCell::ReadGuard table(cell, reader);
+        ASSERT_EQ(table->value, 1);
+    }
+
+    ASSERT_EQ(cell.publish(std::make_shared<Table>(2, &destroyed)), 2u);
+    {
+        TableCell::ReadGuard table(cell, reader);
+        ASSERT_EQ(table->value, 2);
+        ASSERT_EQ(table.version(), 2u);
+    }
+    // 没有读者在读区：旧版本随发布立即释放
+    ASSERT_EQ(destroyed.load(), 1);
+    ASSERT_EQ(cell.retired(), 0u);
+    cell.detach(reader);
+}
+
+TEST(Update_SkipsWhenBuildReturnsNull) {
+    std::atomic<int> destroyed(0);
+    TableCell cell(std::make_shared<Table>(1, &destroyed));
+    bool replaced = cell.update([&destroyed](const Table& current) -> std::shared_ptr<const Table> {
+        if (current.value == 1) {
+            return nullptr;
+        }
+        return std::make_shared<Table>(current.value + 1, &destroyed);
+    });
+    ASSERT_FALSE(replaced);
+    ASSERT_EQ(cell.version(), 1u);
+
+    replaced = cell.update([&destroyed](const Table& current) -> std::shared_ptr<const Table> {
+        return std::make_shared<Table>(current.value + 1, &destroyed);
+    });
+    ASSERT_TRUE(replaced);
+    ASSERT_EQ(cell.load()->value, 2);
+}
+
+// ========== 回收 ==========
+
+TEST(Reclaim_WaitsForActiveReader) {
+    std::atomic<int> destroyed(0);
+    TableCell cell(std::make_shared<Table>(1, &destroyed));
+    TableCell::Reader* reader = cell.attach();
+    {
+        TableCell::ReadGuard table(cell, reader);
+        cell.publish(std::make_shared<Table>(2, &destroyed));
+        // 读区内仍看到进入时的版本
+        ASSERT_EQ(table->value, 1);
+        ASSERT_EQ(destroyed.load(), 0);
+        ASSERT_EQ(cell.retired(), 1u);
+        ASSERT_EQ(cell.reclaim(), 0u);
+    }
+    // 最后离开的读者回收旧版本
+    ASSERT_EQ(destroyed.load(), 1);
+    ASSERT_EQ(cell.retired(), 0u);
+}
+
+TEST(Reclaim_NestedGuardKeepsOuterEpoch) {
+    std::atomic<int> destroyed(0);
+    TableCell cell(std::make_shared<Table>(1, &destroyed));
+    TableCell::Reader* reader = cell.attach();
+    {
+        TableCell::ReadGuard outer(cell, reader);
+        cell.publish(std::make_shared<Table>(2, &destroyed));
+        {
+            TableCell::ReadGuard inner(cell, reader);
+            ASSERT_EQ(inner->value, 2);
+        }
+        // 内层离开不结束外层的读区
+        ASSERT_EQ(destroyed.load(), 0);
+        ASSERT_EQ(outer->value, 1);
+    }
+    ASSERT_EQ(destroyed.load(), 1);
+}
+
+TEST(Retain_OutlivesReadSection) {
+    std::atomic<int> destroyed(0);
+    TableCell cell(std::make_shared<Table>(1, &destroyed));
+    TableCell::Reader* reader = cell.attach();
+    std::shared_ptr<const Table> kept;
+    {
+        TableCell::ReadGuard table(cell, reader);
+        kept = table.retain();
+    }
+    cell.publish(std::make_shared<Table>(2, &destroyed));
+    // 节点已回收，快照由引用计数持有
+    ASSERT_EQ(cell.retired(), 0u);
+    ASSERT_EQ(destroyed.load(), 0);
+    ASSERT_EQ(kept->value, 1);
+    kept.reset();
+    ASSERT_EQ(destroyed.load(), 1);
+}
+
+TEST(Attach_ReusesDetachedSlot) {
+    std::atomic<int> destroyed(0);
+    TableCell cell(std::make_shared<Table>(1, &destroyed));
+    TableCell::Reader* first = cell.attach();
+    TableCell::Reader* second = cell.attach();
+    ASSERT_TRUE(first != second);
+    cell.detach(first);
+    ASSERT_TRUE(cell.attach() == first);
+}
+
+// ========== 并发 ==========
+
+TEST(Concurrent_ReadersNeverSeeFreedSnapshot) {
+    std::atomic<int> destroyed(0);
+    TableCell cell(std::make_shared<Table>(0, &destroyed));
+    std::atomic<bool> stop(false);
+    std::atomic<int> bad(0);
+
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; t++) {
+        readers.push_back(std::thread([&cell, &stop, &bad]() {
+            TableCell::Reader* reader = cell.attach();
+            int last = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                TableCell::ReadGuard table(cell, reader);
+                // 已释放的快照会读到被覆盖的值；版本只增不减
+                int value = table->value;
+                if (value < last || value < 0) {
+                    bad.fetch_add(1);
+                }
+                last = value;
+            }
+            cell.detach(reader);
+        }));
+    }
+
+    const int kPublishes = 2000;
+    for (int i = 1; i <= kPublishes; i++) {
+        cell.publish(std::make_shared<Table>(i, &destroyed));
+    }
+    stop.store(true);
+    for (size_t t = 0; t < readers.size(); t++) {
+        readers[t].join();
+    }
+    cell.reclaim();
+
+    ASSERT_EQ(bad.load(), 0);
+    ASSERT_EQ(cell.retired(), 0u);
+    ASSERT_EQ(destroyed.load(), kPublishes);
+    ASSERT_EQ(cell.load()->value, kPublishes);
+}
+
+int main() {
+    std::cout << "========================================" << std::endl;
+    std::cout << "RCU Snapshot Unit Tests" << std::endl;
+    std::cout << "========================================" << std::endl << std::endl;
+
+    std::cout << "Publish Tests:" << std::endl;
+    RUN_TEST(Publish_ReplacesAndBumpsVersion);
+    RUN_TEST(Update_SkipsWhenBuildReturnsNull);
+
+    std::cout << std::endl << "Reclaim Tests:" << std::endl;
+    RUN_TEST(Reclaim_WaitsForActiveReader);
+    RUN_TEST(Reclaim_NestedGuardKeepsOuterEpoch);
+    RUN_TEST(Retain_OutlivesReadSection);
+    RUN_TEST(Attach_ReusesDetachedSlot);
+
+    std::cout << std::endl << "Concurrency Tests:" << std::endl;
+    RUN_TEST(Concurrent_ReadersNeverSeeFreedSnapshot);
+
+    std::cout << std::endl << "========================================" << std::endl;
+    std::cout << "Test Results:" << std::endl;
+    std::cout << "  Total: " << test_count << std::endl;
+    std::cout << "  Passed: " << passed_count << std::endl;
+    std::cout << "  Failed: " << (test_count - passed_count) << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    if (test_count == passed_count) {
+        std::cout << "All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "Some tests failed!" << std::endl;
+        return 1;
+    }
+}
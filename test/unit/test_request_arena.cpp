@@ -0,0 +1,260 @@
+/**
+ * @file test_request_arena.cpp
+ * @brief 单元测试：RequestArena 请求级线性分配器
+ */
+
+#include <iostream>
+#include <cassert>
+#include <cstdlib>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../../include/uvapi_allocator.h"
+#include "../../include/request_view.h"
+
+using namespace uvapi;
+
+int test_count = 0;
+int passed_count = 0;
+
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { \
+    test_count++; \
+    std::cout << "Running test: " << #name << "..."; \
+    test_##name(); \
+    std::cout << " PASSED" << std::endl; \
+    passed_count++; \
+} while(0)
+
+#define ASSERT_TRUE(expr) do { \
+    if (!(expr)) { \
+        std::cerr << "\n  FAILED: " << #expr << " is false" << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+#define ASSERT_FALSE(expr) ASSERT_TRUE(!(expr))
+
+#define ASSERT_EQ(a, b) do { \
+    if ((a) != (b)) { \
+        std::cerr << "\n  FAILED: " << #a << " != " << #b << std::endl; \
+        std::cerr << "    Expected: " << (b) << ", Got: " << (a) << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+// ========== 分配 ==========
+
+TEST(Arena_AlignedBumpAllocation) {
+    RequestArena arena;
+    char* a = static_cast<char*>(arena.allocate(3, 1));
+    uint64_t* b = arena.allocateArray<uint64_t>(4);
+    void* c = arena.allocate(10, 64);
+    ASSERT_TRUE(a != nullptr && b != nullptr && c != nullptr);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(b) % alignof(uint64_t), static_cast<uintptr_t>(0));
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(c) % 64, static_cast<uintptr_t>(0));
+    ASSERT_TRUE(arena.owns(a) && arena.owns(b) && arena.owns(c));
+    ASSERT_EQ(arena.blockCount(), static_cast<size_t>(1));
+
+    int local = 0;
+    ASSERT_FALSE(arena.owns(&local));
+}
+
+TEST(Arena_CopyString) {
+    RequestArena arena;
+    char* s = arena.copyString("hello", 5);
+    ASSERT_EQ(std::string(s), std::string("hello"));
+}
+
+TEST(Arena_ResetReusesBlock) {
+    RequestArena arena;
+    void* first = arena.allocate(100);
+    arena.allocate(200);
+    ASSERT_TRUE(arena.bytesUsed() >= 300);
+    arena.reset();
+    ASSERT_EQ(arena.bytesUsed(), static_cast<size_t>(0));
+    ASSERT_EQ(arena.blockCount(), static_cast<size_t>(1));
+    ASSERT_EQ(arena.allocate(100), first);
+}
+
+TEST(Arena_GrowsRetainedBlockToPeak) {
+    RequestArena arena(1024);
+    for (int i = 0; i < 20; i++) {
+        arena.allocate(400);
+    }
+    ASSERT_TRUE(arena.blockCount() > 1);
+    size_t peak = arena.bytesUsed();
+    arena.reset();
+    ASSERT_EQ(arena.blockCount(), static_cast<size_t>(1));
+    ASSERT_TRUE(arena.bytesReserved() >= peak);
+
+    // 下一个同样规模的请求只用一个块
+    for (int i = 0; i < 20; i++) {
+        arena.allocate(400);
+    }
+    ASSERT_EQ(arena.blockCount(), static_cast<size_t>(1));
+}
+
+TEST(Arena_LargeAllocationKeepsCurrentBlock) {
+    RequestArena arena(1024);
+    char* small = static_cast<char*>(arena.allocate(16, 1));
+    void* big = arena.allocate(100000);
+    char* next = static_cast<char*>(arena.allocate(16, 1));
+    ASSERT_TRUE(big != nullptr && arena.owns(big));
+    // 大分配单独成块，小分配继续使用原来的块
+    ASSERT_EQ(next, small + 16);
+}
+
+TEST(Arena_HugeAllocationFails) {
+    RequestArena arena(1024);
+    ASSERT_TRUE(arena.allocate(SIZE_MAX) == nullptr);
+    ASSERT_TRUE(arena.allocate(SIZE_MAX - 8, 16) == nullptr);
+    ASSERT_EQ(arena.bytesUsed(), static_cast<size_t>(0));
+    // 失败后仍可以正常分配
+    ASSERT_TRUE(arena.allocate(16) != nullptr);
+}
+
+TEST(Json_TaggedFreeOutsideScope) {
+    RequestArena arena;
+    void* from_arena = nullptr;
+    void* from_heap = nullptr;
+    {
+        ArenaScope scope(&arena, true);
+        from_arena = uvapi_json_alloc(40);
+        ASSERT_TRUE(from_arena != nullptr);
+        ASSERT_TRUE(arena.owns(from_arena));
+        ASSERT_EQ(reinterpret_cast<uintptr_t>(from_arena) % alignof(std::max_align_t), 0u);
+    }
+    {
+        // 未接管 JSON 的作用域内走堆
+        ArenaScope scope(&arena, false);
+        from_heap = uvapi_json_alloc(24);
+        ASSERT_TRUE(from_heap != nullptr);
+        ASSERT_FALSE(arena.owns(from_heap));
+    }
+    ASSERT_TRUE(uvapi_json_alloc(SIZE_MAX) == nullptr);
+    // 作用域结束后、在其他线程上释放：arena 内存为空操作，堆内存交给 free()
+    std::thread([from_arena, from_heap]() {
+        uvapi_json_free(from_arena);
+        uvapi_json_free(from_heap);
+        uvapi_json_free(nullptr);
+    }).join();
+    uvapi_json_free(from_arena);
+}
+
+// ========== 作用域与分配器 ==========
+
+TEST(Scope_SetsAndRestoresCurrent) {
+    RequestArena outer;
+    RequestArena inner;
+    ASSERT_TRUE(RequestArena::current() == nullptr);
+    {
+        ArenaScope a(&outer, true);
+        ASSERT_TRUE(RequestArena::current() == &outer);
+        ASSERT_TRUE(RequestArena::jsonHooked());
+        {
+            ArenaScope b(&inner);
+            ASSERT_TRUE(RequestArena::current() == &inner);
+            ASSERT_FALSE(RequestArena::jsonHooked());
+            inner.allocate(64);
+        }
+        ASSERT_EQ(inner.bytesUsed(), static_cast<size_t>(0));
+        ASSERT_TRUE(RequestArena::current() == &outer);
+        ASSERT_TRUE(RequestArena::jsonHooked());
+        outer.allocate(64);
+    }
+    ASSERT_TRUE(RequestArena::current() == nullptr);
+    ASSERT_EQ(outer.bytesUsed(), static_cast<size_t>(0));
+
+    // 空 arena 的作用域不做任何事
+    ArenaScope none(nullptr, true);
+    ASSERT_TRUE(RequestArena::current() == nullptr);
+}
+
+TEST(Allocator_VectorUsesArena) {
+    RequestArena arena;
+    {
+        std::vector<int, ArenaAllocator<int> > values{ArenaAllocator<int>(arena)};
+        for (int i = 0; i < 1000; i++) {
+            values.push_back(i);
+        }
+        ASSERT_TRUE(arena.owns(values.data()));
+        ASSERT_EQ(values[999], 999);
+    }
+    ASSERT_TRUE(arena.bytesUsed() >= 1000 * sizeof(int));
+}
+
+TEST(Allocator_RequestAllocatorFollowsScope) {
+    std::vector<int, RequestAllocator<int> > heap;
+    heap.push_back(1);
+    ASSERT_TRUE(heap.get_allocator().arena() == nullptr);
+
+    RequestArena arena;
+    ArenaScope scope(&arena);
+    std::vector<int, RequestAllocator<int> > scoped;
+    scoped.push_back(1);
+    ASSERT_TRUE(arena.owns(scoped.data()));
+}
+
+TEST(Allocator_OversizedRequestReturnsNull) {
+    RequestArena arena;
+    ArenaAllocator<int> alloc(arena);
+    ASSERT_TRUE(alloc.allocate(SIZE_MAX / sizeof(int) + 1) == nullptr);
+    RequestAllocator<int> heap;
+    ASSERT_TRUE(heap.allocate(SIZE_MAX / sizeof(int) + 1) == nullptr);
+}
+
+TEST(Allocator_SliceMapOverflowUsesArena) {
+    RequestArena arena;
+    ArenaScope scope(&arena);
+    SliceMap map;
+    std::vector<std::string> keys;
+    keys.reserve(40);
+    for (int i = 0; i < 40; i++) {
+        keys.push_back("h" + std::to_string(i));
+    }
+    ASSERT_EQ(arena.bytesUsed(), static_cast<size_t>(0));
+    for (size_t i = 0; i < keys.size(); i++) {
+        map.add(StringSlice(keys[i]), StringSlice(keys[i]));
+    }
+    ASSERT_TRUE(arena.bytesUsed() > 0);
+    ASSERT_TRUE(map.get(StringSlice("h39")) == StringSlice("h39"));
+}
+
+int main() {
+    std::cout << "========================================" << std::endl;
+    std::cout << "Request Arena Unit Tests" << std::endl;
+    std::cout << "========================================" << std::endl << std::endl;
+
+    std::cout << "Allocation Tests:" << std::endl;
+    RUN_TEST(Arena_AlignedBumpAllocation);
+    RUN_TEST(Arena_CopyString);
+    RUN_TEST(Arena_ResetReusesBlock);
+    RUN_TEST(Arena_GrowsRetainedBlockToPeak);
+    RUN_TEST(Arena_LargeAllocationKeepsCurrentBlock);
+    RUN_TEST(Arena_HugeAllocationFails);
+    RUN_TEST(Json_TaggedFreeOutsideScope);
+
+    std::cout << std::endl << "Scope And Allocator Tests:" << std::endl;
+    RUN_TEST(Scope_SetsAndRestoresCurrent);
+    RUN_TEST(Allocator_VectorUsesArena);
+    RUN_TEST(Allocator_RequestAllocatorFollowsScope);
+    RUN_TEST(Allocator_OversizedRequestReturnsNull);
+    RUN_TEST(Allocator_SliceMapOverflowUsesArena);
+
+    std::cout << std::endl << "========================================" << std::endl;
+    std::cout << "Test Results:" << std::endl;
+    std::cout << "  Total: " << test_count << std::endl;
+    std::cout << "  Passed: " << passed_count << std::endl;
+    std::cout << "  Failed: " << (test_count - passed_count) << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    if (test_count == passed_count) {
+        std::cout << "All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "Some tests failed!" << std::endl;
+        return 1;
+    }
+}
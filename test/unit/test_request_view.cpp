@@ -0,0 +1,171 @@
+/**
+ * @file test_request_view.cpp
+ * @brief 单元测试：StringSlice、SmallVector 和 SliceMap
+ */
+
+#include <iostream>
+#include <cassert>
+#include <cstdlib>
+#include "../../include/request_view.h"
+
+using namespace uvapi;
+
+int test_count = 0;
+int passed_count = 0;
+
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { \
+    test_count++; \
+    std::cout << "Running test: " << #name << "..."; \
+    test_##name(); \
+    std::cout << " PASSED" << std::endl; \
+    passed_count++; \
+} while(0)
+
+#define ASSERT_TRUE(expr) do { \
+    if (!(expr)) { \
+        std::cerr << "\n  FAILED: " << #expr << " is false" << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+#define ASSERT_FALSE(expr) ASSERT_TRUE(!(expr))
+
+#define ASSERT_EQ(a, b) do { \
+    if ((a) != (b)) { \
+        std::cerr << "\n  FAILED: " << #a << " != " << #b << std::endl; \
+        std::cerr << "    Expected: " << (b) << ", Got: " << (a) << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+// ========== StringSlice 测试 ==========
+
+TEST(Slice_ValidVsEmpty) {
+    StringSlice missing;
+    StringSlice empty("", 0);
+    ASSERT_FALSE(missing.valid());
+    ASSERT_TRUE(empty.valid());
+    ASSERT_TRUE(empty.empty());
+}
+
+TEST(Slice_Compare) {
+    const char* buffer = "page=10&limit=5";
+    StringSlice key(buffer, 4);
+    ASSERT_TRUE(key == StringSlice("page"));
+    ASSERT_TRUE(key != StringSlice("pages"));
+    ASSERT_EQ(key.toString(), "page");
+    ASSERT_TRUE(StringSlice("Content-Type").equalsIgnoreCase("content-type", 12));
+}
+
+// ========== SmallVector 测试 ==========
+
+TEST(SmallVector_SpillsToHeap) {
+    detail::SmallVector<int, 4> v;
+    for (int i = 0; i < 10; ++i) {
+        v.push_back(i);
+    }
+    ASSERT_EQ(v.size(), 10u);
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_EQ(v[static_cast<size_t>(i)], i);
+    }
+    v.clear();
+    ASSERT_TRUE(v.empty());
+}
+
+// ========== SliceMap 测试 ==========
+
+TEST(SliceMap_GetAndIgnoreCase) {
+    SliceMap headers;
+    headers.add("Content-Type", "application/json");
+    ASSERT_EQ(headers.get("Content-Type").toString(), "application/json");
+    ASSERT_FALSE(headers.get("content-type").valid());
+    ASSERT_EQ(headers.getIgnoreCase("content-type").toString(), "application/json");
+}
+
+TEST(SliceMap_OverlayDefaults) {
+    SliceMap query;
+    query.add("page", "3");
+    query.add("search", "");
+
+    SliceMap layered(&query);
+    layered.setDefault("page", "1");
+    layered.setDefault("limit", "20");
+    layered.setDefault("search", "all");
+
+    ASSERT_EQ(layered.get("page").toString(), "3");
+    ASSERT_EQ(layered.get("limit").toString(), "20");
+    ASSERT_EQ(layered.get("search").toString(), "all");
+    // 底层表不受影响
+    ASSERT_FALSE(query.has("limit"));
+    ASSERT_EQ(query.get("search").toString(), "");
+}
+
+TEST(SliceMap_ForEachVisibleOnce) {
+    SliceMap query;
+    query.add("a", "1");
+    query.add("b", "2");
+    SliceMap layered(&query);
+    layered.set("b", "3");
+
+    std::string seen;
+    layered.forEach([&seen](const StringSlice& k, const StringSlice& v) {
+        seen += k.toString() + "=" + v.toString() + ";";
+    });
+    ASSERT_EQ(seen, "b=3;a=1;");
+}
+
+TEST(SliceMap_RepeatedKeyValues) {
+    SliceMap query;
+    query.add("tag", "a");
+    query.add("id", "1");
+    query.add("tag", "b");
+    ASSERT_EQ(query.get("tag").toString(), "a");
+    ASSERT_EQ(query.count("tag"), 2u);
+    ASSERT_EQ(query.count("missing"), 0u);
+
+    std::string seen;
+    query.forEachValue("tag", [&seen](const StringSlice& v) { seen += v.toString() + ";"; });
+    ASSERT_EQ(seen, "a;b;");
+
+    // overlay 覆盖全部原始值；没有该键时回落到 base
+    SliceMap layered(&query);
+    layered.set("tag", "c");
+    ASSERT_EQ(layered.count("tag"), 1u);
+    ASSERT_EQ(layered.get("tag").toString(), "c");
+    ASSERT_EQ(layered.count("id"), 1u);
+}
+
+int main() {
+    std::cout << "========================================" << std::endl;
+    std::cout << "Request View Unit Tests" << std::endl;
+    std::cout << "========================================" << std::endl << std::endl;
+
+    std::cout << "StringSlice Tests:" << std::endl;
+    RUN_TEST(Slice_ValidVsEmpty);
+    RUN_TEST(Slice_Compare);
+
+    std::cout << std::endl << "SmallVector Tests:" << std::endl;
+    RUN_TEST(SmallVector_SpillsToHeap);
+
+    std::cout << std::endl << "SliceMap Tests:" << std::endl;
+    RUN_TEST(SliceMap_GetAndIgnoreCase);
+    RUN_TEST(SliceMap_OverlayDefaults);
+    RUN_TEST(SliceMap_ForEachVisibleOnce);
+    RUN_TEST(SliceMap_RepeatedKeyValues);
+
+    std::cout << std::endl << "========================================" << std::endl;
+    std::cout << "Test Results:" << std::endl;
+    std::cout << "  Total: " << test_count << std::endl;
+    std::cout << "  Passed: " << passed_count << std::endl;
+    std::cout << "  Failed: " << (test_count - passed_count) << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    if (test_count == passed_count) {
+        std::cout << "All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "Some tests failed!" << std::endl;
+        return 1;
+    }
+}
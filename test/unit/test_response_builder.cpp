@@ -144,6 +144,27 @@ TEST(ResponseBuilder_CompleteWorkflow) {
     ASSERT_TRUE(response.body.find("\"name\":\"Alice\"") != std::string::npos);
 }
 
+TEST(JsonObject_DirectWriter) {
+    std::string json = JSON::Object()
+        .set("id", static_cast<int64_t>(9007199254740993LL))
+        .set("name", "a\"b")
+        .setNull("note")
+        .set("tags", JSON::Array().append("x").append(JSON::Object().set("ok", true)))
+        .set("meta", JSON::Object())
+        .toCompactString();
+    ASSERT_EQ(json, std::string("{\"id\":9007199254740993,\"name\":\"a\\\"b\",\"note\":null,"
+                                "\"tags\":[\"x\",{\"ok\":true}],\"meta\":{}}"));
+}
+
+TEST(JsonObject_MoveOutAndReuse) {
+    JSON::Object obj;
+    obj.set("a", 1);
+    ASSERT_EQ(obj.toCompactString(), std::string("{\"a\":1}"));
+    ASSERT_EQ(std::move(obj).toCompactString(), std::string("{\"a\":1}"));
+    ASSERT_EQ(obj.toCompactString(), std::string("{}"));
+    ASSERT_EQ(JSON::Array().append(1).append(2).toString(), std::string("[1, 2]"));
+}
+
 // ========== 主函数 ==========
 
 int main() {
@@ -162,6 +183,8 @@ int main() {
     RUN_TEST(ResponseBuilder_MakeErrorResponse);
     RUN_TEST(ResponseBuilder_MakeNotFoundResponse);
     RUN_TEST(ResponseBuilder_CompleteWorkflow);
+    RUN_TEST(JsonObject_DirectWriter);
+    RUN_TEST(JsonObject_MoveOutAndReuse);
     
     std::cout << std::endl;
     std::cout << "=== 测试结果 ===" << std::endl;
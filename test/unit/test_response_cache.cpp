@@ -0,0 +1,182 @@
+/**
+ * @file test_response_cache.cpp
+ * @brief 单元测试：分片 LRU 响应缓存
+ */
+
+#include <iostream>
+#include <cassert>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../../include/response_cache.h"
+
+using namespace uvapi;
+
+int test_count = 0;
+int passed_count = 0;
+
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { \
+    test_count++; \
+    std::cout << "Running test: " << #name << "..."; \
+    test_##name(); \
+    std::cout << " PASSED" << std::endl; \
+    passed_count++; \
+} while(0)
+
+#define ASSERT_TRUE(expr) do { \
+    if (!(expr)) { \
+        std::cerr << "\n  FAILED: " << #expr << " is false" << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+#define ASSERT_FALSE(expr) ASSERT_TRUE(!(expr))
+
+#define ASSERT_EQ(a, b) do { \
+    if ((a) != (b)) { \
+        std::cerr << "\n  FAILED: " << #a << " != " << #b << std::endl; \
+        std::cerr << "    Expected: " << (b) << ", Got: " << (a) << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+// ========== LRU 测试 ==========
+
+TEST(Lru_HitAndMiss) {
+    ShardedResponseCache<std::string> cache(10, 1024, std::chrono::milliseconds(60000), 1);
+    ASSERT_TRUE(cache.put("a", std::string("alpha")));
+    std::string out;
+    ASSERT_TRUE(cache.get("a", out));
+    ASSERT_EQ(out, "alpha");
+    ASSERT_FALSE(cache.get("b", out));
+    ShardedResponseCache<std::string>::Stats s = cache.stats();
+    ASSERT_EQ(s.hits, 1u);
+    ASSERT_EQ(s.misses, 1u);
+    ASSERT_EQ(s.entries, 1u);
+    ASSERT_EQ(s.bytes, 6u);  // 响应体 5 字节 + 键 1 字节
+}
+
+TEST(Lru_EvictsLeastRecentlyUsed) {
+    ShardedResponseCache<int> cache(3, 1024, std::chrono::milliseconds(60000), 1);
+    cache.put(1, std::string("one"));
+    cache.put(2, std::string("two"));
+    cache.put(3, std::string("three"));
+    ASSERT_TRUE(cache.find(1) != nullptr);  // 1 变为最近使用
+    cache.put(4, std::string("four"));      // 淘汰 2
+    ASSERT_TRUE(cache.find(2) == nullptr);
+    ASSERT_TRUE(cache.find(1) != nullptr);
+    ASSERT_TRUE(cache.find(3) != nullptr);
+    ASSERT_TRUE(cache.find(4) != nullptr);
+    ASSERT_EQ(cache.stats().evictions, 1u);
+}
+
+TEST(Lru_ByteBudget) {
+    ShardedResponseCache<std::string> cache(100, 20, std::chrono::milliseconds(60000), 1);
+    ASSERT_TRUE(cache.put("a", std::string(9, 'x')));   // 10 字节
+    ASSERT_TRUE(cache.put("b", std::string(9, 'y')));   // 20 字节
+    ASSERT_TRUE(cache.put("c", std::string(4, 'z')));   // 淘汰 a
+    ASSERT_TRUE(cache.find("a") == nullptr);
+    ASSERT_EQ(cache.bytes(), 15u);
+    ASSERT_FALSE(cache.put("d", std::string(30, 'w'))); // 超过预算，不缓存
+    ASSERT_EQ(cache.size(), 2u);
+}
+
+TEST(Lru_ReplaceAndRemove) {
+    ShardedResponseCache<std::string> cache(10, 1024, std::chrono::milliseconds(60000), 4);
+    cache.put("k", std::string("v1"));
+    cache.put("k", std::string("value2"));
+    ASSERT_EQ(*cache.find("k"), "value2");
+    ASSERT_EQ(cache.size(), 1u);
+    ASSERT_EQ(cache.bytes(), 7u);
+    ASSERT_TRUE(cache.remove("k"));
+    ASSERT_FALSE(cache.remove("k"));
+    ASSERT_EQ(cache.bytes(), 0u);
+}
+
+TEST(Lru_Expiration) {
+    ShardedResponseCache<std::string> cache(10, 1024, std::chrono::milliseconds(1), 1);
+    cache.put("a", std::string("x"));
+    cache.put("b", std::string("y"));
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    ASSERT_TRUE(cache.find("a") == nullptr);
+    cache.cleanup();
+    ASSERT_EQ(cache.size(), 0u);
+    ASSERT_EQ(cache.stats().expirations, 2u);
+}
+
+// ========== 分片与指标测试 ==========
+
+TEST(Shard_CountRoundedToPowerOfTwo) {
+    ShardedResponseCache<std::string> cache(100, 1024, std::chrono::milliseconds(60000), 6);
+    ASSERT_EQ(cache.shardCount(), 8u);
+}
+
+TEST(Shard_ConcurrentAccess) {
+    ShardedResponseCache<int> cache(100000, 64 * 1024 * 1024);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.push_back(std::thread([&cache, t]() {
+            for (int i = 0; i < 2000; i++) {
+                int key = t * 2000 + i;
+                cache.put(key, std::to_string(key));
+                cache.find(key);
+            }
+        }));
+    }
+    for (size_t i = 0; i < threads.size(); i++) {
+        threads[i].join();
+    }
+    ASSERT_EQ(cache.size(), 8000u);
+    ASSERT_EQ(cache.stats().hits, 8000u);
+}
+
+TEST(Metrics_BoundCounters) {
+    metrics::MetricRegistry registry;
+    ShardedResponseCache<std::string> cache(1, 1024, std::chrono::milliseconds(60000), 1);
+    cache.bindMetrics(registry, "test_cache");
+    cache.put("a", std::string("1"));
+    cache.put("b", std::string("2"));  // 淘汰 a
+    cache.find("a");
+    cache.find("b");
+    std::string text = registry.toPrometheus();
+    ASSERT_TRUE(text.find("test_cache_hits_total 1") != std::string::npos);
+    ASSERT_TRUE(text.find("test_cache_misses_total 1") != std::string::npos);
+    ASSERT_TRUE(text.find("test_cache_evictions_total 1") != std::string::npos);
+    ASSERT_TRUE(text.find("test_cache_entries 1") != std::string::npos);
+    ASSERT_TRUE(text.find("test_cache_bytes 2") != std::string::npos);
+}
+
+int main() {
+    std::cout << "========================================" << std::endl;
+    std::cout << "Sharded Response Cache Unit Tests" << std::endl;
+    std::cout << "========================================" << std::endl << std::endl;
+
+    std::cout << "LRU Tests:" << std::endl;
+    RUN_TEST(Lru_HitAndMiss);
+    RUN_TEST(Lru_EvictsLeastRecentlyUsed);
+    RUN_TEST(Lru_ByteBudget);
+    RUN_TEST(Lru_ReplaceAndRemove);
+    RUN_TEST(Lru_Expiration);
+
+    std::cout << std::endl << "Shard and Metrics Tests:" << std::endl;
+    RUN_TEST(Shard_CountRoundedToPowerOfTwo);
+    RUN_TEST(Shard_ConcurrentAccess);
+    RUN_TEST(Metrics_BoundCounters);
+
+    std::cout << std::endl << "========================================" << std::endl;
+    std::cout << "Test Results:" << std::endl;
+    std::cout << "  Total: " << test_count << std::endl;
+    std::cout << "  Passed: " << passed_count << std::endl;
+    std::cout << "  Failed: " << (test_count - passed_count) << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    if (test_count == passed_count) {
+        std::cout << "All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "Some tests failed!" << std::endl;
+        return 1;
+    }
+}
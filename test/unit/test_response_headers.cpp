@@ -0,0 +1,157 @@
+/**
+ * @file test_response_headers.cpp
+ * @brief 单元测试：扁平响应头列表
+ */
+
+#include <iostream>
+#include <cassert>
+#include <cstdlib>
+#include <string>
+#include "../../include/response_headers.h"
+
+using namespace uvapi;
+
+int test_count = 0;
+int passed_count = 0;
+
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { \
+    test_count++; \
+    std::cout << "Running test: " << #name << "..."; \
+    test_##name(); \
+    std::cout << " PASSED" << std::endl; \
+    passed_count++; \
+} while(0)
+
+#define ASSERT_TRUE(expr) do { \
+    if (!(expr)) { \
+        std::cerr << "\n  FAILED: " << #expr << " is false" << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+#define ASSERT_FALSE(expr) ASSERT_TRUE(!(expr))
+
+#define ASSERT_EQ(a, b) do { \
+    if ((a) != (b)) { \
+        std::cerr << "\n  FAILED: " << #a << " != " << #b << std::endl; \
+        std::cerr << "    Expected: " << (b) << ", Got: " << (a) << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+
+// ========== 设置与查找 ==========
+
+TEST(Headers_InsertionOrder) {
+    ResponseHeaders h;
+    h.set("X-B", "2");
+    h.set("X-A", "1");
+    h.set(header::CONTENT_TYPE, "text/plain");
+    ASSERT_EQ(h.size(), static_cast<size_t>(3));
+    ResponseHeaders::const_iterator it = h.begin();
+    ASSERT_EQ(it->first, "X-B");
+    ++it;
+    ASSERT_EQ(it->first, "X-A");
+    ++it;
+    ASSERT_EQ(it->first, "Content-Type");
+}
+
+TEST(Headers_CaseInsensitiveOverwrite) {
+    ResponseHeaders h;
+    h["Content-Type"] = "text/plain";
+    h.set("content-type", "application/json");
+    h.set(header::CONTENT_TYPE, "text/html");
+    ASSERT_EQ(h.size(), static_cast<size_t>(1));
+    ASSERT_EQ(h.begin()->first, "Content-Type");
+    ASSERT_EQ(*h.get(header::CONTENT_TYPE), "text/html");
+    ASSERT_TRUE(h.find("CONTENT-TYPE") != h.end());
+}
+
+TEST(Headers_MapCompatibility) {
+    ResponseHeaders h;
+    ASSERT_TRUE(h.find("X-Missing") == h.end());
+    ASSERT_EQ(h.count("X-Missing"), static_cast<size_t>(0));
+    ASSERT_TRUE(h.get("X-Missing") == nullptr);
+    h["X-Id"] = "7";
+    ASSERT_EQ(h["X-Id"], "7");
+    ASSERT_EQ(h.count("x-id"), static_cast<size_t>(1));
+    ASSERT_EQ(h.erase("X-ID"), static_cast<size_t>(1));
+    ASSERT_TRUE(h.empty());
+}
+
+TEST(Headers_AddKeepsDuplicates) {
+    ResponseHeaders h;
+    h.add("Set-Cookie", "a=1");
+    h.add("Set-Cookie", "b=2");
+    ASSERT_EQ(h.size(), static_cast<size_t>(2));
+    ASSERT_EQ(h.entries()[1].second, "b=2");
+}
+
+TEST(Headers_MoveValueAndClear) {
+    ResponseHeaders h;
+    std::string value(100, 'v');
+    const char* storage = value.data();
+    h.set(header::CACHE_CONTROL, std::move(value));
+    const std::string* stored = h.get(header::CACHE_CONTROL);
+    ASSERT_TRUE(stored != nullptr);
+    ASSERT_TRUE(stored->data() == storage);
+    h.reserve(8);
+    h.clear();
+    ASSERT_TRUE(h.empty());
+    ASSERT_TRUE(h.entries().capacity() >= 8);
+}
+
+TEST(Intern_CanonicalNames) {
+    const HeaderName* a = internHeaderName("content-type", 12);
+    const HeaderName* b = internHeaderName("CONTENT-TYPE", 12);
+    ASSERT_TRUE(a != nullptr);
+    // 同一名称总是同一个驻留常量，且采用规范大小写
+    ASSERT_TRUE(a == b);
+    ASSERT_EQ(std::string(a->data, a->size), "Content-Type");
+    const HeaderName* forwarded = internHeaderName("x-forwarded-for", 15);
+    ASSERT_TRUE(forwarded != nullptr);
+    ASSERT_EQ(std::string(forwarded->data), "X-Forwarded-For");
+    ASSERT_TRUE(internHeaderName("X-Custom", 8) == nullptr);
+    ASSERT_TRUE(internHeaderName("Host-Extra", 4) != nullptr);
+}
+
+TEST(RequestHeaders_CaseInsensitiveLookup) {
+    RequestHeaders h;
+    h["authorization"] = "Bearer t";
+    ASSERT_TRUE(h.find("Authorization") != h.end());
+    ASSERT_EQ(*h.get(header::AUTHORIZATION), "Bearer t");
+    ASSERT_FALSE(h.has(header::COOKIE));
+}
+
+int main() {
+    std::cout << "========================================" << std::endl;
+    std::cout << "Response Headers Unit Tests" << std::endl;
+    std::cout << "========================================" << std::endl << std::endl;
+
+    std::cout << "Header List Tests:" << std::endl;
+    RUN_TEST(Headers_InsertionOrder);
+    RUN_TEST(Headers_CaseInsensitiveOverwrite);
+    RUN_TEST(Headers_MapCompatibility);
+    RUN_TEST(Headers_AddKeepsDuplicates);
+    RUN_TEST(Headers_MoveValueAndClear);
+
+    std::cout << std::endl << "Interned Name Tests:" << std::endl;
+    RUN_TEST(Intern_CanonicalNames);
+    RUN_TEST(RequestHeaders_CaseInsensitiveLookup);
+
+    std::cout << std::endl << "========================================" << std::endl;
+    std::cout << "Test Results:" << std::endl;
+    std::cout << "  Total: " << test_count << std::endl;
+    std::cout << "  Passed: " << passed_count << std::endl;
+    std::cout << "  Failed: " << (test_count - passed_count) << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    if (test_count == passed_count) {
+        std::cout << "All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "Some tests failed!" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,129 @@
+/**
+ * @file test_response_stream.cpp
+ * @brief 单元测试：流式响应的状态行、头部和 chunked 分帧
+ */
+
+#include <iostream>
+#include <cassert>
+#include <cstdlib>
+#include <string>
+#include "../../include/response_stream.h"
+
+using namespace uvapi;
+using namespace uvapi::server;
+
+int test_count = 0;
+int passed_count = 0;
+
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { \
+    test_count++; \
+    std::cout << "Running test: " << #name << "..."; \
+    test_##name(); \
+    std::cout << " PASSED" << std::endl; \
+    passed_count++; \
+} while(0)
+
+#define ASSERT_TRUE(expr) do { \
+    if (!(expr)) { \
+        std::cerr << "\n  FAILED: " << #expr << " is false" << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+#define ASSERT_FALSE(expr) ASSERT_TRUE(!(expr))
+
+#define ASSERT_EQ(a, b) do { \
+    if ((a) != (b)) { \
+        std::cerr << "\n  FAILED: " << #a << " != " << #b << std::endl; \
+        std::cerr << "    Expected: " << (b) << ", Got: " << (a) << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+bool contains(const std::string& text, const char* part) {
+    return text.find(part) != std::string::npos;
+}
+
+// ========== 状态行和头部 ==========
+
+TEST(head_chunked) {
+    ResponseHeaders headers;
+    headers.set("Content-Type", "application/json");
+    std::string head = streamHead(200, headers, true);
+    ASSERT_EQ(head.substr(0, 17), std::string("HTTP/1.1 200 OK\r\n"));
+    ASSERT_TRUE(contains(head, "Content-Type: application/json\r\n"));
+    ASSERT_TRUE(contains(head, "Transfer-Encoding: chunked\r\n"));
+    ASSERT_EQ(head.substr(head.size() - 21), std::string("Connection: close\r\n\r\n"));
+}
+
+TEST(head_with_content_length) {
+    ResponseHeaders headers;
+    headers.set("Content-Length", "42");
+    std::string head = streamHead(201, headers, false);
+    ASSERT_EQ(head.substr(0, 22), std::string("HTTP/1.1 201 Created\r\n"));
+    ASSERT_TRUE(contains(head, "Content-Length: 42\r\n"));
+    ASSERT_FALSE(contains(head, "Transfer-Encoding"));
+}
+
+TEST(head_drops_framing_and_unsafe_headers) {
+    ResponseHeaders headers;
+    headers.set("Connection", "keep-alive");
+    headers.set("Transfer-Encoding", "gzip");
+    headers.set("Content-Length", "10");
+    headers.set("X-Bad", "a\r\nSet-Cookie: x=1");
+    headers.set("X-Ok", "1");
+    std::string head = streamHead(200, headers, true);
+    ASSERT_FALSE(contains(head, "keep-alive"));
+    ASSERT_FALSE(contains(head, "gzip"));
+    ASSERT_FALSE(contains(head, "Content-Length"));
+    ASSERT_FALSE(contains(head, "Set-Cookie"));
+    ASSERT_TRUE(contains(head, "X-Ok: 1\r\n"));
+}
+
+TEST(status_reason_fallback) {
+    ASSERT_EQ(std::string(statusReason(404)), std::string("Not Found"));
+    ASSERT_EQ(std::string(statusReason(299)), std::string("OK"));
+    ASSERT_EQ(std::string(statusReason(418)), std::string("Client Error"));
+    ASSERT_EQ(std::string(statusReason(599)), std::string("Server Error"));
+}
+
+// ========== chunked 分帧 ==========
+
+TEST(chunk_prefix_hex) {
+    ASSERT_EQ(chunkPrefix(1), std::string("1\r\n"));
+    ASSERT_EQ(chunkPrefix(255), std::string("ff\r\n"));
+    ASSERT_EQ(chunkPrefix(65536), std::string("10000\r\n"));
+    ASSERT_EQ(std::string(kLastChunk), std::string("0\r\n\r\n"));
+    ASSERT_EQ(std::string(kChunkSuffix), std::string("\r\n"));
+}
+
+int main() {
+    std::cout << "========================================" << std::endl;
+    std::cout << "Response Stream Unit Tests" << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    std::cout << std::endl << "Head Tests:" << std::endl;
+    RUN_TEST(head_chunked);
+    RUN_TEST(head_with_content_length);
+    RUN_TEST(head_drops_framing_and_unsafe_headers);
+    RUN_TEST(status_reason_fallback);
+
+    std::cout << std::endl << "Chunk Tests:" << std::endl;
+    RUN_TEST(chunk_prefix_hex);
+
+    std::cout << std::endl << "========================================" << std::endl;
+    std::cout << "Test Results:" << std::endl;
+    std::cout << "  Total: " << test_count << std::endl;
+    std::cout << "  Passed: " << passed_count << std::endl;
+    std::cout << "  Failed: " << (test_count - passed_count) << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    if (test_count == passed_count) {
+        std::cout << "All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "Some tests failed!" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,182 @@
+/**
+ * @file test_route_cache.cpp
+ * @brief 单元测试：路由级预编码响应缓存
+ */
+
+#include <iostream>
+#include <cassert>
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <thread>
+#include "../../include/route_cache.h"
+
+using namespace uvapi;
+using namespace uvapi::server;
+
+int test_count = 0;
+int passed_count = 0;
+
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { \
+    test_count++; \
+    std::cout << "Running test: " << #name << "..."; \
+    test_##name(); \
+    std::cout << " PASSED" << std::endl; \
+    passed_count++; \
+} while(0)
+
+#define ASSERT_TRUE(expr) do { \
+    if (!(expr)) { \
+        std::cerr << "\n  FAILED: " << #expr << " is false" << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+#define ASSERT_FALSE(expr) ASSERT_TRUE(!(expr))
+
+#define ASSERT_EQ(a, b) do { \
+    if ((a) != (b)) { \
+        std::cerr << "\n  FAILED: " << #a << " != " << #b << std::endl; \
+        std::cerr << "    Expected: " << (b) << ", Got: " << (a) << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+static CachedResponse::HeaderList jsonHeaders() {
+    CachedResponse::HeaderList headers;
+    headers.push_back(std::make_pair(std::string("Content-Type"), std::string("application/json")));
+    return headers;
+}
+
+// ========== 预编码响应测试 ==========
+
+TEST(Cached_LayoutAndGeneratedEtag) {
+    std::shared_ptr<const CachedResponse> cached = CachedResponse::create(200, jsonHeaders(), "{\"a\":1}");
+    ASSERT_EQ(cached->status(), 200);
+    ASSERT_EQ(cached->headerCount(), 2u);
+    ASSERT_EQ(std::string(cached->headerName(0)), "Content-Type");
+    ASSERT_EQ(std::string(cached->headerValue(0)), "application/json");
+    ASSERT_EQ(std::string(cached->headerName(1)), "ETag");
+    ASSERT_EQ(std::string(cached->headerValue(1)), cached->etag());
+    ASSERT_EQ(cached->etag().size(), 18u);
+    ASSERT_EQ(std::string(cached->body(), cached->bodySize()), "{\"a\":1}");
+
+    // 相同响应体得到相同 ETag
+    ASSERT_EQ(CachedResponse::create(200, jsonHeaders(), "{\"a\":1}")->etag(), cached->etag());
+    ASSERT_TRUE(CachedResponse::create(200, jsonHeaders(), "{\"a\":2}")->etag() != cached->etag());
+}
+
+TEST(Cached_KeepsHandlerEtag) {
+    CachedResponse::HeaderList headers = jsonHeaders();
+    headers.push_back(std::make_pair(std::string("etag"), std::string("W/\"v7\"")));
+    std::shared_ptr<const CachedResponse> cached = CachedResponse::create(200, headers, "x");
+    ASSERT_EQ(cached->headerCount(), 2u);
+    ASSERT_EQ(cached->etag(), "W/\"v7\"");
+}
+
+TEST(Cached_IfNoneMatch) {
+    CachedResponse::HeaderList headers;
+    headers.push_back(std::make_pair(std::string("ETag"), std::string("\"abc\"")));
+    std::shared_ptr<const CachedResponse> cached = CachedResponse::create(200, headers, "x");
+    ASSERT_TRUE(cached->matchesIfNoneMatch(StringSlice("\"abc\"")));
+    ASSERT_TRUE(cached->matchesIfNoneMatch(StringSlice("W/\"abc\"")));
+    ASSERT_TRUE(cached->matchesIfNoneMatch(StringSlice("\"x\", \"abc\"")));
+    ASSERT_TRUE(cached->matchesIfNoneMatch(StringSlice("*")));
+    ASSERT_FALSE(cached->matchesIfNoneMatch(StringSlice("\"abcd\"")));
+    ASSERT_FALSE(cached->matchesIfNoneMatch(StringSlice("")));
+    ASSERT_FALSE(cached->matchesIfNoneMatch(StringSlice()));
+}
+
+// ========== 路由缓存测试 ==========
+
+TEST(Route_KeyVaries) {
+    RouteCache cache(RouteCachePolicy().varyQuery("lang").varyHeader("Accept"));
+    std::map<std::string, std::string> query;
+    std::map<std::string, std::string> headers;
+    auto q = [&query](const std::string& name) {
+        auto it = query.find(name);
+        return it == query.end() ? StringSlice() : StringSlice(it->second);
+    };
+    auto h = [&headers](const std::string& name) {
+        auto it = headers.find(name);
+        return it == headers.end() ? StringSlice() : StringSlice(it->second);
+    };
+
+    std::string none = cache.buildKey(1, StringSlice("/config"), q, h);
+    query["lang"] = "";
+    std::string empty = cache.buildKey(1, StringSlice("/config"), q, h);
+    query["lang"] = "zh";
+    std::string zh = cache.buildKey(1, StringSlice("/config"), q, h);
+    query["other"] = "ignored";
+    ASSERT_EQ(cache.buildKey(1, StringSlice("/config"), q, h), zh);
+    headers["Accept"] = "text/html";
+    ASSERT_TRUE(cache.buildKey(1, StringSlice("/config"), q, h) != zh);
+    ASSERT_TRUE(none != empty);
+    ASSERT_TRUE(empty != zh);
+    ASSERT_TRUE(cache.buildKey(2, StringSlice("/config"), q, h) != cache.buildKey(1, StringSlice("/config"), q, h));
+}
+
+TEST(Route_Cacheable) {
+    CachedResponse::HeaderList headers = jsonHeaders();
+    ASSERT_TRUE(RouteCache::isCacheable(200, headers));
+    ASSERT_FALSE(RouteCache::isCacheable(500, headers));
+    CachedResponse::HeaderList cookie = headers;
+    cookie.push_back(std::make_pair(std::string("set-cookie"), std::string("sid=1")));
+    ASSERT_FALSE(RouteCache::isCacheable(200, cookie));
+    CachedResponse::HeaderList no_store = headers;
+    no_store.push_back(std::make_pair(std::string("Cache-Control"), std::string("no-store")));
+    ASSERT_FALSE(RouteCache::isCacheable(200, no_store));
+}
+
+TEST(Route_FreshThenStale) {
+    RouteCache cache(RouteCachePolicy(std::chrono::milliseconds(5))
+                         .staleWhileRevalidate(std::chrono::milliseconds(60000)));
+    std::shared_ptr<const CachedResponse> out;
+    ASSERT_TRUE(cache.lookup("k", out) == RouteCache::Freshness::MISS);
+    cache.store("k", CachedResponse::create(200, jsonHeaders(), "v"));
+    ASSERT_TRUE(cache.lookup("k", out) == RouteCache::Freshness::FRESH);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    ASSERT_TRUE(cache.lookup("k", out) == RouteCache::Freshness::STALE);
+    ASSERT_EQ(std::string(out->body(), out->bodySize()), "v");
+
+    // 同一个键只有一个刷新者
+    ASSERT_TRUE(cache.beginRevalidation("k"));
+    ASSERT_FALSE(cache.beginRevalidation("k"));
+    cache.store("k", CachedResponse::create(200, jsonHeaders(), "v2"));
+    cache.endRevalidation("k");
+    ASSERT_TRUE(cache.lookup("k", out) == RouteCache::Freshness::FRESH);
+    ASSERT_EQ(std::string(out->body(), out->bodySize()), "v2");
+    ASSERT_TRUE(cache.beginRevalidation("k"));
+}
+
+int main() {
+    std::cout << "========================================" << std::endl;
+    std::cout << "Route Cache Unit Tests" << std::endl;
+    std::cout << "========================================" << std::endl << std::endl;
+
+    std::cout << "Cached Response Tests:" << std::endl;
+    RUN_TEST(Cached_LayoutAndGeneratedEtag);
+    RUN_TEST(Cached_KeepsHandlerEtag);
+    RUN_TEST(Cached_IfNoneMatch);
+
+    std::cout << std::endl << "Route Cache Tests:" << std::endl;
+    RUN_TEST(Route_KeyVaries);
+    RUN_TEST(Route_Cacheable);
+    RUN_TEST(Route_FreshThenStale);
+
+    std::cout << std::endl << "========================================" << std::endl;
+    std::cout << "Test Results:" << std::endl;
+    std::cout << "  Total: " << test_count << std::endl;
+    std::cout << "  Passed: " << passed_count << std::endl;
+    std::cout << "  Failed: " << (test_count - passed_count) << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    if (test_count == passed_count) {
+        std::cout << "All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "Some tests failed!" << std::endl;
+        return 1;
+    }
+}
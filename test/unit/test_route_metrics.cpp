@@ -0,0 +1,236 @@
+/**
+ * @file test_route_metrics.cpp
+ * @brief 单元测试：路由级延迟直方图与阶段计时
+ */
+
+#include <iostream>
+#include <cassert>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../../include/route_metrics.h"
+
+using namespace uvapi::metrics;
+
+int test_count = 0;
+int passed_count = 0;
+
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { \
+    test_count++; \
+    std::cout << "Running test: " << #name << "..."; \
+    test_##name(); \
+    std::cout << " PASSED" << std::endl; \
+    passed_count++; \
+} while(0)
+
+#define ASSERT_TRUE(expr) do { \
+    if (!(expr)) { \
+        std::cerr << "\n  FAILED: " << #expr << " is false" << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+#define ASSERT_FALSE(expr) ASSERT_TRUE(!(expr))
+
+#define ASSERT_EQ(a, b) do { \
+    if ((a) != (b)) { \
+        std::cerr << "\n  FAILED: " << #a << " != " << #b << std::endl; \
+        std::cerr << "    Expected: " << (b) << ", Got: " << (a) << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+// ========== LatencyHistogram ==========
+
+// 桶下标单调，且每个值都落在其桶的相对误差范围内
+TEST(Latency_BucketBounds) {
+    ASSERT_EQ(LatencyHistogram::bucketIndex(0), 0u);
+    ASSERT_EQ(LatencyHistogram::bucketIndex(15), 15u);
+    size_t previous = 0;
+    for (uint64_t v = 16; v < (static_cast<uint64_t>(1) << 30); v = v * 3 / 2 + 1) {
+        size_t index = LatencyHistogram::bucketIndex(v);
+        ASSERT_TRUE(index >= previous);
+        previous = index;
+        double mid = LatencyHistogram::bucketMidpoint(index);
+        double error = (mid > static_cast<double>(v) ? mid - static_cast<double>(v) : static_cast<double>(v) - mid) /
+                       static_cast<double>(v);
+        ASSERT_TRUE(error <= 1.0 / 32.0 + 1e-9);
+    }
+    // 超出上限计入最后一个桶
+    ASSERT_EQ(LatencyHistogram::bucketIndex(~static_cast<uint64_t>(0)), LatencyHistogram::kBucketCount - 1);
+}
+
+TEST(Latency_Quantiles) {
+    std::unique_ptr<LatencyHistogram> histogram(new LatencyHistogram());
+    for (uint64_t i = 1; i <= 1000; i++) {
+        histogram->record(i * 1000);  // 1us .. 1ms
+    }
+    LatencyHistogram::Snapshot snap = histogram->snapshot();
+    ASSERT_EQ(snap.count, 1000u);
+    ASSERT_EQ(snap.sum_ns, 500500000u);
+    double p50 = snap.quantile(0.5);
+    double p99 = snap.quantile(0.99);
+    ASSERT_TRUE(p50 > 500000 * 0.96 && p50 < 500000 * 1.04);
+    ASSERT_TRUE(p99 > 990000 * 0.96 && p99 < 990000 * 1.04);
+    ASSERT_TRUE(snap.quantile(0.0) <= snap.quantile(1.0));
+}
+
+TEST(Latency_ConcurrentRecord) {
+    std::unique_ptr<LatencyHistogram> histogram(new LatencyHistogram());
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; t++) {
+        threads.push_back(std::thread([&histogram]() {
+            for (int i = 0; i < 10000; i++) {
+                histogram->record(250);
+            }
+        }));
+    }
+    for (size_t i = 0; i < threads.size(); i++) {
+        threads[i].join();
+    }
+    LatencyHistogram::Snapshot snap = histogram->snapshot();
+    ASSERT_EQ(snap.count, 80000u);
+    ASSERT_EQ(snap.sum_ns, 80000u * 250u);
+}
+
+// ========== 阶段计时 ==========
+
+TEST(Timing_InactiveTimerIsNoop) {
+    ASSERT_TRUE(RequestTiming::active() == nullptr);
+    PhaseTimer timer(Phase::PARSE);
+    ASSERT_TRUE(RequestTiming::active() == nullptr);
+}
+
+TEST(Timing_PhasesAccumulate) {
+    RequestTiming timing;
+    ASSERT_TRUE(RequestTiming::active() == &timing);
+    {
+        PhaseTimer timer(Phase::VALIDATION);
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    {
+        PhaseTimer timer(Phase::VALIDATION);
+    }
+    ASSERT_TRUE(timing.phase(Phase::VALIDATION) >= 2000000u);
+    ASSERT_EQ(timing.phase(Phase::PARSE), 0u);
+    ASSERT_TRUE(timing.elapsed() >= timing.phase(Phase::VALIDATION));
+}
+
+TEST(Timing_RestoresPrevious) {
+    RequestTiming outer;
+    {
+        RequestTiming inner;
+        ASSERT_TRUE(RequestTiming::active() == &inner);
+    }
+    ASSERT_TRUE(RequestTiming::active() == &outer);
+}
+
+TEST(Timing_NestedAccumulatesOuter) {
+    RequestTiming outer;
+    {
+        RequestTiming inner;
+        inner.add(Phase::PARSE, 100);
+        ASSERT_EQ(inner.phase(Phase::PARSE), 100u);
+    }
+    ASSERT_EQ(outer.phase(Phase::PARSE), 100u);
+}
+
+// ========== RouteMetrics ==========
+
+TEST(Route_StatusClasses) {
+    ASSERT_EQ(RouteMetrics::statusClass(200), 1u);
+    ASSERT_EQ(RouteMetrics::statusClass(404), 3u);
+    ASSERT_EQ(RouteMetrics::statusClass(503), 4u);
+    ASSERT_EQ(RouteMetrics::statusClass(0), 0u);
+    ASSERT_EQ(RouteMetrics::statusClass(999), 4u);
+
+    RouteMetrics route("/users/:id", "GET");
+    {
+        RequestTiming timing;
+        route.record(200, timing);
+    }
+    ASSERT_TRUE(route.find(1) != nullptr);
+    ASSERT_TRUE(route.find(3) == nullptr);
+    ASSERT_EQ(route.find(1)->phases[static_cast<size_t>(Phase::TOTAL)].snapshot().count, 1u);
+}
+
+// 处理器耗时 = 总耗时 - 解析 - 验证 - 序列化
+TEST(Route_HandlerIsRemainder) {
+    RouteMetrics route("/slow", "POST");
+    {
+        RequestTiming timing;
+        {
+            PhaseTimer timer(Phase::PARSE);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(3));
+        route.record(201, timing);
+    }
+    const RouteMetrics::PhaseSet* set = route.find(1);
+    ASSERT_TRUE(set != nullptr);
+    LatencyHistogram::Snapshot handler = set->phases[static_cast<size_t>(Phase::HANDLER)].snapshot();
+    LatencyHistogram::Snapshot total = set->phases[static_cast<size_t>(Phase::TOTAL)].snapshot();
+    ASSERT_TRUE(handler.sum_ns >= 3000000u);
+    ASSERT_TRUE(total.sum_ns >= handler.sum_ns);
+}
+
+TEST(Family_PrometheusText) {
+    RouteMetricsFamily family;
+    std::shared_ptr<RouteMetrics> route = family.route("/items", "GET");
+    ASSERT_TRUE(family.route("/items", "GET") == route);
+    ASSERT_EQ(family.routeCount(), 1u);
+    {
+        RequestTiming timing;
+        route->record(404, timing);
+    }
+
+    std::string text = family.toPrometheus();
+    ASSERT_TRUE(text.find("# TYPE uvapi_route_duration_seconds summary\n") != std::string::npos);
+    ASSERT_TRUE(text.find("uvapi_route_duration_seconds{method=\"GET\",route=\"/items\",status=\"4xx\","
+                          "phase=\"handler\",quantile=\"0.99\"} ") != std::string::npos);
+    ASSERT_TRUE(text.find("uvapi_route_duration_seconds_count{method=\"GET\",route=\"/items\",status=\"4xx\","
+                          "phase=\"total\"} 1\n") != std::string::npos);
+    ASSERT_TRUE(text.find("status=\"2xx\"") == std::string::npos);
+
+    MetricRegistry registry;
+    registry.registerMetric(std::make_shared<RouteMetricsFamily>());
+    ASSERT_TRUE(registry.getMetric("uvapi_route_duration_seconds") != nullptr);
+}
+
+int main() {
+    std::cout << "========================================" << std::endl;
+    std::cout << "Route Metrics Unit Tests" << std::endl;
+    std::cout << "========================================" << std::endl << std::endl;
+
+    std::cout << "Latency Histogram Tests:" << std::endl;
+    RUN_TEST(Latency_BucketBounds);
+    RUN_TEST(Latency_Quantiles);
+    RUN_TEST(Latency_ConcurrentRecord);
+
+    std::cout << std::endl << "Phase Timing Tests:" << std::endl;
+    RUN_TEST(Timing_InactiveTimerIsNoop);
+    RUN_TEST(Timing_PhasesAccumulate);
+    RUN_TEST(Timing_RestoresPrevious);
+    RUN_TEST(Timing_NestedAccumulatesOuter);
+
+    std::cout << std::endl << "Route Metrics Tests:" << std::endl;
+    RUN_TEST(Route_StatusClasses);
+    RUN_TEST(Route_HandlerIsRemainder);
+    RUN_TEST(Family_PrometheusText);
+
+    std::cout << std::endl << "========================================" << std::endl;
+    std::cout << "Test Results:" << std::endl;
+    std::cout << "  Total: " << test_count << std::endl;
+    std::cout << "  Passed: " << passed_count << std::endl;
+    std::cout << "  Failed: " << (test_count - passed_count) << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    if (test_count == passed_count) {
+        std::cout << "All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "Some tests failed!" << std::endl;
+        return 1;
+    }
+}
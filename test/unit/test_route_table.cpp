@@ -0,0 +1,182 @@
+/**
+ * @file test_route_table.cpp
+ * @brief 单元测试：RouteTable 单次路由匹配
+ */
+
+#include <iostream>
+#include <cassert>
+#include <cstdlib>
+#include "../../include/route_table.h"
+
+using namespace uvapi::server;
+
+int test_count = 0;
+int passed_count = 0;
+
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { \
+    test_count++; \
+    std::cout << "Running test: " << #name << "..."; \
+    test_##name(); \
+    std::cout << " PASSED" << std::endl; \
+    passed_count++; \
+} while(0)
+
+#define ASSERT_TRUE(expr) do { \
+    if (!(expr)) { \
+        std::cerr << "\n  FAILED: " << #expr << " is false" << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+#define ASSERT_FALSE(expr) ASSERT_TRUE(!(expr))
+
+#define ASSERT_EQ(a, b) do { \
+    if ((a) != (b)) { \
+        std::cerr << "\n  FAILED: " << #a << " != " << #b << std::endl; \
+        std::cerr << "    Expected: " << (b) << ", Got: " << (a) << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+// HttpMethod 整数值
+static const int ANY = 0;
+static const int GET = 1;
+static const int POST = 2;
+
+// ========== 静态路由测试 ==========
+
+TEST(Static_ExactMatch) {
+    RouteTable table;
+    int id = table.add("/api/users", GET);
+    ASSERT_EQ(id, 0);
+    ASSERT_EQ(table.match("/api/users", GET, nullptr), id);
+    ASSERT_EQ(table.match("/api/users/", GET, nullptr), id);
+    ASSERT_EQ(table.match("/api/user", GET, nullptr), RouteTable::kNoRoute);
+    ASSERT_EQ(table.match("/api/users/1", GET, nullptr), RouteTable::kNoRoute);
+}
+
+TEST(Static_DenseIds) {
+    RouteTable table;
+    ASSERT_EQ(table.add("/a", GET), 0);
+    ASSERT_EQ(table.add("/b", GET), 1);
+    ASSERT_EQ(table.add("/a", POST), 2);
+    ASSERT_EQ(table.add("/a", GET), 0);  // 重复注册复用 ID
+    ASSERT_EQ(table.size(), 3u);
+}
+
+TEST(Method_Dispatch) {
+    RouteTable table;
+    int get_id = table.add("/items", GET);
+    int post_id = table.add("/items", POST);
+    ASSERT_EQ(table.match("/items", GET, nullptr), get_id);
+    ASSERT_EQ(table.match("/items", POST, nullptr), post_id);
+    ASSERT_EQ(table.match("/items", 3, nullptr), RouteTable::kNoRoute);
+}
+
+TEST(Method_AnyFallback) {
+    RouteTable table;
+    int any_id = table.add("/health", ANY);
+    int post_id = table.add("/health", POST);
+    ASSERT_EQ(table.match("/health", GET, nullptr), any_id);
+    ASSERT_EQ(table.match("/health", POST, nullptr), post_id);
+}
+
+// ========== 参数路由测试 ==========
+
+TEST(Param_Extract) {
+    RouteTable table;
+    int id = table.add("/api/users/:id/posts/:post_id", GET);
+    std::map<std::string, std::string> params;
+    ASSERT_EQ(table.match("/api/users/42/posts/7", GET, &params), id);
+    ASSERT_EQ(params["id"], "42");
+    ASSERT_EQ(params["post_id"], "7");
+}
+
+TEST(Param_StaticPreferred) {
+    RouteTable table;
+    int param_id = table.add("/users/:id", GET);
+    int me_id = table.add("/users/me", GET);
+    std::map<std::string, std::string> params;
+    ASSERT_EQ(table.match("/users/me", GET, &params), me_id);
+    ASSERT_TRUE(params.empty());
+    ASSERT_EQ(table.match("/users/9", GET, &params), param_id);
+    ASSERT_EQ(params["id"], "9");
+}
+
+TEST(Param_Backtrack) {
+    RouteTable table;
+    table.add("/users/me/settings", GET);
+    int id = table.add("/users/:id/profile", GET);
+    std::map<std::string, std::string> params;
+    ASSERT_EQ(table.match("/users/me/profile", GET, &params), id);
+    ASSERT_EQ(params["id"], "me");
+}
+
+TEST(Param_NoWriteOnMiss) {
+    RouteTable table;
+    table.add("/users/:id/profile", GET);
+    std::map<std::string, std::string> params;
+    ASSERT_EQ(table.match("/users/1/other", GET, &params), RouteTable::kNoRoute);
+    ASSERT_TRUE(params.empty());
+}
+
+TEST(Param_ConflictingName) {
+    RouteTable table;
+    ASSERT_TRUE(table.add("/users/:id", GET) >= 0);
+    ASSERT_EQ(table.add("/users/:uid/x", GET), RouteTable::kNoRoute);
+}
+
+// ========== 通配路由测试 ==========
+
+TEST(Wildcard_Rest) {
+    RouteTable table;
+    int id = table.add("/static/*", GET);
+    std::map<std::string, std::string> params;
+    ASSERT_EQ(table.match("/static/css/app.css", GET, &params), id);
+    ASSERT_EQ(params["*"], "css/app.css");
+    ASSERT_EQ(table.match("/static", GET, nullptr), id);
+}
+
+TEST(Wildcard_MustBeLast) {
+    RouteTable table;
+    ASSERT_EQ(table.add("/static/*/x", GET), RouteTable::kNoRoute);
+}
+
+int main() {
+    std::cout << "========================================" << std::endl;
+    std::cout << "RouteTable Unit Tests" << std::endl;
+    std::cout << "========================================" << std::endl << std::endl;
+
+    std::cout << "Static Route Tests:" << std::endl;
+    RUN_TEST(Static_ExactMatch);
+    RUN_TEST(Static_DenseIds);
+    RUN_TEST(Method_Dispatch);
+    RUN_TEST(Method_AnyFallback);
+
+    std::cout << std::endl << "Param Route Tests:" << std::endl;
+    RUN_TEST(Param_Extract);
+    RUN_TEST(Param_StaticPreferred);
+    RUN_TEST(Param_Backtrack);
+    RUN_TEST(Param_NoWriteOnMiss);
+    RUN_TEST(Param_ConflictingName);
+
+    std::cout << std::endl << "Wildcard Route Tests:" << std::endl;
+    RUN_TEST(Wildcard_Rest);
+    RUN_TEST(Wildcard_MustBeLast);
+
+    std::cout << std::endl << "========================================" << std::endl;
+    std::cout << "Test Results:" << std::endl;
+    std::cout << "  Total: " << test_count << std::endl;
+    std::cout << "  Passed: " << passed_count << std::endl;
+    std::cout << "  Failed: " << (test_count - passed_count) << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    if (test_count == passed_count) {
+        std::cout << "All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "Some tests failed!" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,243 @@
+/**
+ * @file test_server_options.cpp
+ * @brief 单元测试：ServerOptions 与 ConnectionTracker 连接统计
+ */
+
+#include <iostream>
+#include <cassert>
+#include <cstdlib>
+#include "../../include/server_options.h"
+#include <set>
+
+using namespace uvapi::server;
+
+int test_count = 0;
+int passed_count = 0;
+
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { \
+    test_count++; \
+    std::cout << "Running test: " << #name << "..."; \
+    test_##name(); \
+    std::cout << " PASSED" << std::endl; \
+    passed_count++; \
+} while(0)
+
+#define ASSERT_TRUE(expr) do { \
+    if (!(expr)) { \
+        std::cerr << "\n  FAILED: " << #expr << " is false" << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+#define ASSERT_FALSE(expr) ASSERT_TRUE(!(expr))
+
+#define ASSERT_EQ(a, b) do { \
+    if ((a) != (b)) { \
+        std::cerr << "\n  FAILED: " << #a << " != " << #b << std::endl; \
+        std::cerr << "    Expected: " << (b) << ", Got: " << (a) << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+// ========== 选项 ==========
+
+TEST(Options_DefaultsDoNotTrack) {
+    ServerOptions options;
+    ASSERT_FALSE(options.tracksConnections());
+    ASSERT_EQ(options.keepalive_timeout.count(), 0);
+    ASSERT_EQ(options.listen_backlog, 0);
+    
+    // 只写入 uvhttp 配置的选项不需要跟踪
+    options.readBufferSize(65536).maxHeaderSize(8192).maxConnections(10000).listenBacklog(1024);
+    ASSERT_FALSE(options.tracksConnections());
+}
+
+TEST(Options_PerConnectionOptionsTrack) {
+    ASSERT_TRUE(ServerOptions().keepAliveTimeout(std::chrono::seconds(5)).tracksConnections());
+    ASSERT_TRUE(ServerOptions().maxRequestsPerConnection(100).tracksConnections());
+    ASSERT_TRUE(ServerOptions().tcpNoDelay(true).tracksConnections());
+    ASSERT_TRUE(ServerOptions().tcpKeepAlive(60).tracksConnections());
+    ASSERT_TRUE(ServerOptions().trackConnections(true).tracksConnections());
+}
+
+// ========== 连接表 ==========
+
+TEST(Tracker_FreshAndReused) {
+    ConnectionTracker tracker;
+    int a = 0;
+    int b = 0;
+    bool fresh = false;
+    
+    tracker.begin(&a, 1, 100, fresh);
+    ASSERT_TRUE(fresh);
+    tracker.end(&a, 1, 110);
+    ConnectionTracker::Connection& again = tracker.begin(&a, 1, 120, fresh);
+    ASSERT_FALSE(fresh);
+    ASSERT_EQ(again.requests, 2u);
+    tracker.end(&a, 1, 130);
+    tracker.begin(&b, 2, 140, fresh);
+    ASSERT_TRUE(fresh);
+    
+    ConnectionStats stats = tracker.stats();
+    ASSERT_EQ(stats.active, 2u);
+    ASSERT_EQ(stats.idle, 1u);
+    ASSERT_EQ(stats.opened, 2u);
+    ASSERT_EQ(stats.reused, 1u);
+    ASSERT_EQ(stats.requests, 3u);
+    ASSERT_EQ(stats.max_requests, 2u);
+    ASSERT_TRUE(stats.requestsPerConnection() == 1.5);
+}
+
+TEST(Tracker_HandleReusedByNewPeer) {
+    ConnectionTracker tracker;
+    int handle = 0;
+    bool fresh = false;
+    
+    tracker.begin(&handle, 1, 0, fresh);
+    tracker.end(&handle, 1, 10);
+    // 同一句柄地址上对端变化：旧连接记为关闭
+    ConnectionTracker::Connection& connection = tracker.begin(&handle, 2, 20, fresh);
+    ASSERT_TRUE(fresh);
+    ASSERT_EQ(connection.requests, 1u);
+    
+    ConnectionStats stats = tracker.stats();
+    ASSERT_EQ(stats.active, 1u);
+    ASSERT_EQ(stats.idle, 0u);
+    ASSERT_EQ(stats.opened, 2u);
+    ASSERT_EQ(stats.closed, 1u);
+    ASSERT_EQ(stats.reused, 0u);
+    
+    // 旧连接的迟到结束不影响新连接
+    ASSERT_TRUE(tracker.end(&handle, 1, 30) == nullptr);
+    ASSERT_EQ(tracker.stats().idle, 0u);
+    ASSERT_TRUE(tracker.end(&handle, 2, 30) != nullptr);
+    ASSERT_TRUE(tracker.end(&handle, 2, 40) == nullptr);
+    ASSERT_EQ(tracker.stats().idle, 1u);
+}
+
+TEST(Tracker_InFlightCounts) {
+    ConnectionTracker tracker;
+    int handle = 0;
+    bool fresh = false;
+    
+    // 流水线上的两个请求
+    tracker.begin(&handle, 1, 0, fresh);
+    tracker.begin(&handle, 1, 1, fresh);
+    ConnectionTracker::Connection* connection = tracker.end(&handle, 1, 2);
+    ASSERT_TRUE(connection != nullptr);
+    ASSERT_EQ(connection->in_flight, 1u);
+    ASSERT_EQ(tracker.stats().idle, 0u);
+    connection = tracker.end(&handle, 1, 3);
+    ASSERT_TRUE(connection != nullptr);
+    ASSERT_EQ(connection->in_flight, 0u);
+    ASSERT_EQ(tracker.stats().idle, 1u);
+}
+
+TEST(Tracker_Prune) {
+    ConnectionTracker tracker;
+    int a = 0;
+    int b = 0;
+    bool fresh = false;
+    
+    tracker.begin(&a, 1, 0, fresh);
+    tracker.end(&a, 1, 0);
+    tracker.begin(&b, 2, 0, fresh);
+    
+    std::set<const void*> live;
+    live.insert(&b);
+    tracker.prune([&live](const void* handle) { return live.count(handle) > 0; });
+    ASSERT_EQ(tracker.size(), 1u);
+    
+    ConnectionStats stats = tracker.stats();
+    ASSERT_EQ(stats.active, 1u);
+    ASSERT_EQ(stats.idle, 0u);
+    ASSERT_EQ(stats.closed, 1u);
+    
+    tracker.prune([](const void*) { return false; });
+    ASSERT_EQ(tracker.size(), 0u);
+    ASSERT_EQ(tracker.stats().active, 0u);
+    ASSERT_EQ(tracker.stats().closed, 2u);
+}
+
+TEST(Tracker_ForEachIdle) {
+    ConnectionTracker tracker;
+    int idle = 0;
+    int busy = 0;
+    int recent = 0;
+    bool fresh = false;
+    
+    tracker.begin(&idle, 1, 0, fresh);
+    tracker.end(&idle, 1, 100);
+    tracker.begin(&busy, 2, 0, fresh);
+    tracker.begin(&recent, 3, 0, fresh);
+    tracker.end(&recent, 3, 900);
+    
+    std::set<const void*> visited;
+    tracker.forEachIdle(1000, 500, [&visited](const void* handle) {
+        visited.insert(handle);
+        return true;
+    });
+    ASSERT_EQ(visited.size(), 1u);
+    ASSERT_TRUE(visited.count(&idle) == 1);
+    
+    // 已标记关闭的连接不再访问
+    visited.clear();
+    tracker.forEachIdle(2000, 500, [&visited](const void* handle) {
+        visited.insert(handle);
+        return false;
+    });
+    ASSERT_EQ(visited.size(), 1u);
+    ASSERT_TRUE(visited.count(&recent) == 1);
+}
+
+TEST(Stats_Accumulate) {
+    ConnectionStats total;
+    ConnectionStats part;
+    part.active = 2;
+    part.idle = 1;
+    part.opened = 5;
+    part.requests = 20;
+    part.max_requests = 7;
+    accumulate(total, part);
+    part.max_requests = 3;
+    accumulate(total, part);
+    ASSERT_EQ(total.active, 4u);
+    ASSERT_EQ(total.idle, 2u);
+    ASSERT_EQ(total.opened, 10u);
+    ASSERT_EQ(total.requests, 40u);
+    ASSERT_EQ(total.max_requests, 7u);
+}
+
+int main() {
+    std::cout << "========================================" << std::endl;
+    std::cout << "Server Options Unit Tests" << std::endl;
+    std::cout << "========================================" << std::endl << std::endl;
+
+    std::cout << "Options Tests:" << std::endl;
+    RUN_TEST(Options_DefaultsDoNotTrack);
+    RUN_TEST(Options_PerConnectionOptionsTrack);
+
+    std::cout << std::endl << "Connection Tracker Tests:" << std::endl;
+    RUN_TEST(Tracker_FreshAndReused);
+    RUN_TEST(Tracker_HandleReusedByNewPeer);
+    RUN_TEST(Tracker_InFlightCounts);
+    RUN_TEST(Tracker_Prune);
+    RUN_TEST(Tracker_ForEachIdle);
+    RUN_TEST(Stats_Accumulate);
+
+    std::cout << std::endl << "========================================" << std::endl;
+    std::cout << "Test Results:" << std::endl;
+    std::cout << "  Total: " << test_count << std::endl;
+    std::cout << "  Passed: " << passed_count << std::endl;
+    std::cout << "  Failed: " << (test_count - passed_count) << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    if (test_count == passed_count) {
+        std::cout << "All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "Some tests failed!" << std::endl;
+        return 1;
+    }
+}
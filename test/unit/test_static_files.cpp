@@ -0,0 +1,317 @@
+/**
+ * @file test_static_files.cpp
+ * @brief 单元测试：静态文件缓存、路径规范化与条件 / 范围请求解析
+ */
+
+#include <iostream>
+#include <cassert>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include "../../include/static_files.h"
+
+using namespace uvapi;
+using namespace uvapi::server;
+
+int test_count = 0;
+int passed_count = 0;
+
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { \
+    test_count++; \
+    std::cout << "Running test: " << #name << "..."; \
+    test_##name(); \
+    std::cout << " PASSED" << std::endl; \
+    passed_count++; \
+} while(0)
+
+#define ASSERT_TRUE(expr) do { \
+    if (!(expr)) { \
+        std::cerr << "\n  FAILED: " << #expr << " is false" << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+#define ASSERT_FALSE(expr) ASSERT_TRUE(!(expr))
+
+#define ASSERT_EQ(a, b) do { \
+    if ((a) != (b)) { \
+        std::cerr << "\n  FAILED: " << #a << " != " << #b << std::endl; \
+        std::cerr << "    Expected: " << (b) << ", Got: " << (a) << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+
+// ========== 测试辅助 ==========
+
+static std::string makeTempRoot() {
+    char templ[] = "/tmp/uvapi_static_XXXXXX";
+    char* dir = mkdtemp(templ);
+    ASSERT_TRUE(dir != nullptr);
+    return dir;
+}
+
+static void writeFile(const std::string& path, const std::string& content) {
+    std::ofstream out(path.c_str(), std::ios::binary | std::ios::trunc);
+    out << content;
+}
+
+static void setMtime(const std::string& path, time_t seconds) {
+    struct timespec times[2];
+    times[0].tv_sec = seconds;
+    times[0].tv_nsec = 0;
+    times[1] = times[0];
+    utimensat(AT_FDCWD, path.c_str(), times, 0);
+}
+
+static void removeTree(const std::string& root) {
+    std::string command = "rm -rf '" + root + "'";
+    ASSERT_EQ(std::system(command.c_str()), 0);
+}
+
+static std::string normalized(const char* path, bool dotfiles = false) {
+    std::string out;
+    if (!normalizeStaticPath(path, std::strlen(path), dotfiles, out)) {
+        return "<rejected>";
+    }
+    return out;
+}
+
+// ========== 路径规范化 ==========
+
+TEST(Path_Normalizes) {
+    ASSERT_EQ(normalized("css/site.css"), std::string("css/site.css"));
+    ASSERT_EQ(normalized("/css//./site.css"), std::string("css/site.css"));
+    ASSERT_EQ(normalized("docs/"), std::string("docs/"));
+    ASSERT_EQ(normalized(""), std::string(""));
+    ASSERT_EQ(normalized("/"), std::string(""));
+    ASSERT_EQ(normalized("a%20b.txt"), std::string("a b.txt"));
+    ASSERT_EQ(normalized("app.js?v=3"), std::string("app.js"));
+}
+
+TEST(Path_RejectsTraversal) {
+    ASSERT_EQ(normalized("../etc/passwd"), std::string("<rejected>"));
+    ASSERT_EQ(normalized("css/../../x"), std::string("<rejected>"));
+    ASSERT_EQ(normalized("%2e%2e/x"), std::string("<rejected>"));
+    ASSERT_EQ(normalized("a%2fb"), std::string("<rejected>"));
+    ASSERT_EQ(normalized("a%00b"), std::string("<rejected>"));
+    ASSERT_EQ(normalized("a\\b"), std::string("<rejected>"));
+    ASSERT_EQ(normalized("bad%4"), std::string("<rejected>"));
+    ASSERT_EQ(normalized(".env"), std::string("<rejected>"));
+    ASSERT_EQ(normalized(".well-known/x", true), std::string(".well-known/x"));
+}
+
+// ========== 请求头解析 ==========
+
+TEST(Header_AcceptEncoding) {
+    ASSERT_EQ(acceptedEncodings(StringSlice("gzip, deflate, br")), 3u);
+    ASSERT_EQ(acceptedEncodings(StringSlice("gzip;q=1.0, br;q=0")), static_cast<unsigned>(ENCODING_GZIP));
+    ASSERT_EQ(acceptedEncodings(StringSlice("br;q=0.5")), static_cast<unsigned>(ENCODING_BR));
+    ASSERT_EQ(acceptedEncodings(StringSlice("*;q=0.1, gzip;q=0")), static_cast<unsigned>(ENCODING_BR));
+    ASSERT_EQ(acceptedEncodings(StringSlice("identity")), 0u);
+    ASSERT_EQ(acceptedEncodings(StringSlice()), 0u);
+}
+
+TEST(Header_ByteRange) {
+    ByteRange range;
+    ASSERT_TRUE(parseByteRange(StringSlice("bytes=0-99"), 1000, range) == RangeResult::PARTIAL);
+    ASSERT_EQ(range.first, 0u);
+    ASSERT_EQ(range.last, 99u);
+    ASSERT_TRUE(parseByteRange(StringSlice("bytes=900-"), 1000, range) == RangeResult::PARTIAL);
+    ASSERT_EQ(range.length(), 100u);
+    ASSERT_TRUE(parseByteRange(StringSlice("bytes=-200"), 1000, range) == RangeResult::PARTIAL);
+    ASSERT_EQ(range.first, 800u);
+    ASSERT_TRUE(parseByteRange(StringSlice("bytes=-5000"), 1000, range) == RangeResult::PARTIAL);
+    ASSERT_EQ(range.first, 0u);
+    ASSERT_TRUE(parseByteRange(StringSlice("bytes=500-5000"), 1000, range) == RangeResult::PARTIAL);
+    ASSERT_EQ(range.last, 999u);
+
+    ASSERT_TRUE(parseByteRange(StringSlice("bytes=1000-"), 1000, range) == RangeResult::UNSATISFIABLE);
+    ASSERT_TRUE(parseByteRange(StringSlice("bytes=-0"), 1000, range) == RangeResult::UNSATISFIABLE);
+    ASSERT_TRUE(parseByteRange(StringSlice("bytes=0-1,5-6"), 1000, range) == RangeResult::NONE);
+    ASSERT_TRUE(parseByteRange(StringSlice("bytes=9-3"), 1000, range) == RangeResult::NONE);
+    ASSERT_TRUE(parseByteRange(StringSlice("items=0-1"), 1000, range) == RangeResult::NONE);
+    ASSERT_TRUE(parseByteRange(StringSlice(), 1000, range) == RangeResult::NONE);
+}
+
+TEST(Header_EtagAndDate) {
+    ASSERT_TRUE(etagListMatches(StringSlice("\"a\", \"b\""), "\"b\""));
+    ASSERT_TRUE(etagListMatches(StringSlice("W/\"b\""), "\"b\""));
+    ASSERT_TRUE(etagListMatches(StringSlice("*"), "\"b\""));
+    ASSERT_FALSE(etagListMatches(StringSlice("\"a\""), "\"b\""));
+
+    char date[32];
+    size_t size = formatHttpDate(784111777, date, sizeof(date));
+    ASSERT_EQ(std::string(date, size), std::string("Sun, 06 Nov 1994 08:49:37 GMT"));
+    int64_t seconds = 0;
+    ASSERT_TRUE(parseHttpDate(StringSlice(date, size), seconds));
+    ASSERT_EQ(seconds, 784111777);
+    ASSERT_FALSE(parseHttpDate(StringSlice("Sunday, 06-Nov-94 08:49:37 GMT"), seconds));
+}
+
+// ========== 文件缓存 ==========
+
+TEST(Cache_LookupAndContent) {
+    std::string root = makeTempRoot();
+    mkdir((root + "/css").c_str(), 0755);
+    writeFile(root + "/index.html", "<h1>home</h1>");
+    writeFile(root + "/css/site.css", "body{}");
+
+    StaticFileCache cache(root, StaticOptions());
+    ASSERT_TRUE(cache.valid());
+    bool inserted = false;
+    std::shared_ptr<const StaticFile> file = cache.lookup("css/site.css", 0, &inserted);
+    ASSERT_TRUE(file != nullptr);
+    ASSERT_TRUE(inserted);
+    ASSERT_EQ(file->size, 6u);
+    ASSERT_EQ(std::string(file->content_type), std::string("text/css; charset=utf-8"));
+    ASSERT_EQ(file->etag[0], '"');
+    ASSERT_EQ(file->last_modified.size(), 29u);
+
+    std::shared_ptr<const MappedFile> mapping = cache.content(*file);
+    ASSERT_TRUE(mapping != nullptr);
+    ASSERT_EQ(std::string(mapping->data(), mapping->size()), std::string("body{}"));
+    ASSERT_EQ(cache.mappedBytes(), 6u);
+    ASSERT_TRUE(cache.content(*file).get() == mapping.get());
+
+    // 命中缓存：同一条目，不再视为新插入
+    inserted = false;
+    ASSERT_TRUE(cache.lookup("css/site.css", 10, &inserted).get() == file.get());
+    ASSERT_FALSE(inserted);
+
+    // 目录与空路径返回 index_file
+    std::shared_ptr<const StaticFile> index = cache.lookup("", 0);
+    ASSERT_TRUE(index != nullptr);
+    ASSERT_EQ(index->path, cache.root() + "/index.html");
+    ASSERT_TRUE(cache.lookup("css/", 0) == nullptr);
+    ASSERT_TRUE(cache.lookup("missing.js", 0) == nullptr);
+    removeTree(root);
+}
+
+TEST(Cache_PrecompressedVariants) {
+    std::string root = makeTempRoot();
+    writeFile(root + "/app.js", "console.log(1)");
+    writeFile(root + "/app.js.br", "BR");
+    writeFile(root + "/app.js.gz", "GZ");
+    setMtime(root + "/app.js", 1000);
+    setMtime(root + "/app.js.br", 2000);
+    setMtime(root + "/app.js.gz", 500);  // 比原文件旧，不使用
+
+    StaticFileCache cache(root, StaticOptions());
+    std::shared_ptr<const StaticFile> file = cache.lookup("app.js", 0);
+    ASSERT_TRUE(file != nullptr);
+    ASSERT_TRUE(file->br != nullptr);
+    ASSERT_TRUE(file->gzip == nullptr);
+    ASSERT_EQ(std::string(file->br->content_type), std::string(file->content_type));
+    ASSERT_TRUE(file->br->etag != file->etag);
+    std::shared_ptr<const MappedFile> br = cache.content(*file->br);
+    ASSERT_EQ(std::string(br->data(), br->size()), std::string("BR"));
+
+    StaticFileCache plain(root, StaticOptions().usePrecompressed(false));
+    ASSERT_TRUE(plain.lookup("app.js", 0)->br == nullptr);
+    removeTree(root);
+}
+
+TEST(Cache_InvalidateAndRevalidate) {
+    std::string root = makeTempRoot();
+    writeFile(root + "/a.txt", "one");
+    setMtime(root + "/a.txt", 1000);
+
+    StaticFileCache cache(root, StaticOptions().revalidateEvery(std::chrono::milliseconds(100)));
+    std::shared_ptr<const StaticFile> first = cache.lookup("a.txt", 0);
+    ASSERT_TRUE(first != nullptr);
+    cache.content(*first);
+
+    // 原子替换：新 inode，旧映射保持有效
+    writeFile(root + "/a.txt.tmp", "second");
+    setMtime(root + "/a.txt.tmp", 2000);
+    ASSERT_EQ(rename((root + "/a.txt.tmp").c_str(), (root + "/a.txt").c_str()), 0);
+
+    // 兜底间隔内仍返回旧条目；间隔过后重新 stat
+    ASSERT_TRUE(cache.lookup("a.txt", 50).get() == first.get());
+    std::shared_ptr<const StaticFile> second = cache.lookup("a.txt", 200);
+    ASSERT_TRUE(second.get() != first.get());
+    ASSERT_EQ(second->size, 6u);
+    ASSERT_TRUE(second->etag != first->etag);
+
+    // 旧条目的映射已失效：文件被替换后 content 返回 nullptr
+    ASSERT_TRUE(cache.content(*first) == nullptr);
+    std::shared_ptr<const MappedFile> mapping = cache.content(*second);
+    ASSERT_EQ(std::string(mapping->data(), mapping->size()), std::string("second"));
+
+    // 事件失效立即生效
+    cache.invalidate(second->path);
+    ASSERT_EQ(cache.size(), 0u);
+    ASSERT_EQ(cache.mappedBytes(), 0u);
+    unlink((root + "/a.txt").c_str());
+    ASSERT_TRUE(cache.lookup("a.txt", 210) == nullptr);
+    removeTree(root);
+}
+
+TEST(Cache_RejectsSymlinkEscape) {
+    std::string root = makeTempRoot();
+    std::string outside = makeTempRoot();
+    writeFile(outside + "/secret.txt", "secret");
+    ASSERT_EQ(symlink((outside + "/secret.txt").c_str(), (root + "/link.txt").c_str()), 0);
+
+    StaticFileCache cache(root, StaticOptions());
+    ASSERT_TRUE(cache.lookup("link.txt", 0) == nullptr);
+    removeTree(root);
+    removeTree(outside);
+}
+
+TEST(Cache_EvictsByBytes) {
+    std::string root = makeTempRoot();
+    writeFile(root + "/a.bin", std::string(600, 'a'));
+    writeFile(root + "/b.bin", std::string(600, 'b'));
+    writeFile(root + "/big.bin", std::string(5000, 'c'));
+
+    StaticFileCache cache(root, StaticOptions().maxCacheBytes(1000).maxCachedFile(1000));
+    cache.content(*cache.lookup("a.bin", 0));
+    cache.content(*cache.lookup("b.bin", 0));
+    ASSERT_EQ(cache.mappedBytes(), 600u);
+
+    // 超过 max_cached_file 的文件单独映射，不计入常驻字节
+    std::shared_ptr<const MappedFile> big = cache.content(*cache.lookup("big.bin", 0));
+    ASSERT_EQ(big->size(), 5000u);
+    ASSERT_EQ(cache.mappedBytes(), 600u);
+    removeTree(root);
+}
+
+int main() {
+    std::cout << "========================================" << std::endl;
+    std::cout << "Static Files Unit Tests" << std::endl;
+    std::cout << "========================================" << std::endl << std::endl;
+
+    std::cout << "Path Tests:" << std::endl;
+    RUN_TEST(Path_Normalizes);
+    RUN_TEST(Path_RejectsTraversal);
+
+    std::cout << std::endl << "Header Tests:" << std::endl;
+    RUN_TEST(Header_AcceptEncoding);
+    RUN_TEST(Header_ByteRange);
+    RUN_TEST(Header_EtagAndDate);
+
+    std::cout << std::endl << "Cache Tests:" << std::endl;
+    RUN_TEST(Cache_LookupAndContent);
+    RUN_TEST(Cache_PrecompressedVariants);
+    RUN_TEST(Cache_InvalidateAndRevalidate);
+    RUN_TEST(Cache_RejectsSymlinkEscape);
+    RUN_TEST(Cache_EvictsByBytes);
+
+    std::cout << std::endl << "========================================" << std::endl;
+    std::cout << "Test Results:" << std::endl;
+    std::cout << "  Total: " << test_count << std::endl;
+    std::cout << "  Passed: " << passed_count << std::endl;
+    std::cout << "  Failed: " << (test_count - passed_count) << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    if (test_count == passed_count) {
+        std::cout << "All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "Some tests failed!" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,315 @@
+/**
+ * @file test_static_schema.cpp
+ * @brief 单元测试：UVAPI_SCHEMA 编译期 Schema 的解析、校验、序列化与 BodySchemaBase 适配
+ */
+
+#include <iostream>
+#include <cassert>
+#include <cstdlib>
+#include "../../include/static_schema.h"
+
+using namespace uvapi;
+
+int test_count = 0;
+int passed_count = 0;
+
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { \
+    test_count++; \
+    std::cout << "Running test: " << #name << "..."; \
+    test_##name(); \
+    std::cout << " PASSED" << std::endl; \
+    passed_count++; \
+} while(0)
+
+#define ASSERT_TRUE(expr) do { \
+    if (!(expr)) { \
+        std::cerr << "\n  FAILED: " << #expr << " is false" << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+#define ASSERT_FALSE(expr) ASSERT_TRUE(!(expr))
+
+#define ASSERT_EQ(a, b) do { \
+    if ((a) != (b)) { \
+        std::cerr << "\n  FAILED: " << #a << " != " << #b << std::endl; \
+        std::cerr << "    Expected: " << (b) << ", Got: " << (a) << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+namespace shop {
+
+struct Address {
+    std::string city;
+    std::string zip;
+};
+
+UVAPI_SCHEMA(Address,
+    UVAPI_FIELD(city).required(),
+    UVAPI_FIELD(zip).pattern("^[0-9]{5}$"));
+
+struct Item {
+    std::string sku;
+    int quantity;
+
+    Item() : quantity(0) {}
+};
+
+UVAPI_SCHEMA(Item,
+    UVAPI_FIELD(sku).required(),
+    UVAPI_FIELD(quantity).required().range(1, 100));
+
+struct Order {
+    int64_t id;
+    std::string customer;
+    uint8_t priority;
+    double total;
+    bool paid;
+    optional<std::string> note;
+    std::vector<std::string> tags;
+    Address address;
+    std::vector<Item> items;
+
+    Order() : id(0), priority(0), total(0.0), paid(false) {}
+
+    std::string validateBody() const {
+        if (paid && total <= 0) {
+            return "Paid orders must have a positive total";
+        }
+        return "";
+    }
+};
+
+UVAPI_SCHEMA(Order,
+    UVAPI_FIELD(id).required().min(1),
+    UVAPI_FIELD_AS("customer_name", customer).required().length(2, 32),
+    UVAPI_FIELD(priority),
+    UVAPI_FIELD(total),
+    UVAPI_FIELD(paid),
+    UVAPI_FIELD(note),
+    UVAPI_FIELD(tags).maxLength(2).oneOf("gift", "express"),
+    UVAPI_FIELD(address).required(),
+    UVAPI_FIELD(items).length(1, 3));
+
+} // namespace shop
+
+using shop::Order;
+
+static const char* kOrder =
+    "{\"id\":42,\"customer_name\":\"Acme\",\"priority\":3,\"total\":19.5,\"paid\":true,"
+    "\"note\":\"leave at door\",\"tags\":[\"gift\"],\"extra\":{\"ignored\":[1,2]},"
+    "\"address\":{\"city\":\"Springfield\",\"zip\":\"12345\"},"
+    "\"items\":[{\"sku\":\"A-1\",\"quantity\":2},{\"sku\":\"B-2\",\"quantity\":1}]}";
+
+static std::string errorOf(const std::string& json) {
+    Order order;
+    ValidationResult result = parseRequest(json, order);
+    return result ? std::string() : result.error_message;
+}
+
+// ========== 识别 ==========
+
+TEST(Trait_DetectsDeclaredTypes) {
+    ASSERT_TRUE(schema::HasStaticSchema<Order>::value);
+    ASSERT_TRUE(schema::HasStaticSchema<shop::Address>::value);
+    ASSERT_FALSE(schema::HasStaticSchema<std::string>::value);
+    ASSERT_EQ(schema::StaticSchema<Order>::kFieldCount, 9u);
+}
+
+// ========== 解析 ==========
+
+TEST(Parse_ReadsAllMembers) {
+    Order order;
+    ValidationResult result = parseRequest(kOrder, order);
+    ASSERT_TRUE(result);
+    ASSERT_EQ(order.id, 42);
+    ASSERT_EQ(order.customer, "Acme");
+    ASSERT_EQ(static_cast<int>(order.priority), 3);
+    ASSERT_TRUE(order.total == 19.5);
+    ASSERT_TRUE(order.paid);
+    ASSERT_TRUE(order.note.has_value());
+    ASSERT_EQ(*order.note, "leave at door");
+    ASSERT_EQ(order.tags.size(), 1u);
+    ASSERT_EQ(order.address.city, "Springfield");
+    ASSERT_EQ(order.items.size(), 2u);
+    ASSERT_EQ(order.items[1].sku, "B-2");
+    ASSERT_EQ(order.items[1].quantity, 1);
+}
+
+TEST(Parse_MissingOptionalFieldsReset) {
+    Order order;
+    order.priority = 9;
+    order.note = std::string("stale");
+    order.tags.push_back("gift");
+    order = parseBody<Order>("{\"id\":1,\"customer_name\":\"Bo\",\"address\":{\"city\":\"X\"}}");
+    ASSERT_EQ(static_cast<int>(order.priority), 0);
+    ASSERT_FALSE(order.note.has_value());
+    ASSERT_TRUE(order.tags.empty());
+
+    Order reused;
+    reused.note = std::string("stale");
+    ASSERT_TRUE(schema::StaticSchema<Order>::parseJson("{\"id\":1}", 8, reused, false, nullptr));
+    ASSERT_FALSE(reused.note.has_value());
+}
+
+TEST(Parse_NonValidatingSkipsMismatchAndClamps) {
+    Order order;
+    std::string error;
+    const char* json = "{\"id\":\"x\",\"priority\":300,\"paid\":1}";
+    ASSERT_TRUE(schema::StaticSchema<Order>::parseJson(json, std::strlen(json), order, false, &error));
+    ASSERT_EQ(order.id, 0);
+    ASSERT_EQ(static_cast<int>(order.priority), 255);
+    ASSERT_FALSE(order.paid);
+}
+
+TEST(Parse_ReportsSyntaxErrors) {
+    ASSERT_EQ(errorOf("[1,2]"), "Request body must be a JSON object");
+    ASSERT_EQ(errorOf("{\"id\":1,").find("Invalid JSON"), 0u);
+
+    Order order;
+    std::string error;
+    ASSERT_FALSE(schema::StaticSchema<Order>::parseJson("{\"id\":1} x", 10, order, false, &error));
+    ASSERT_EQ(error.find("Invalid JSON"), 0u);
+}
+
+// ========== 校验 ==========
+
+TEST(Validate_FieldRules) {
+    ASSERT_EQ(errorOf("{\"customer_name\":\"Acme\"}"), "Field 'id' is required");
+    ASSERT_EQ(errorOf("{\"id\":null}"), "Field 'id' is required");
+    ASSERT_EQ(errorOf("{\"id\":\"42\"}"), "Field 'id' must be an integer");
+    ASSERT_EQ(errorOf("{\"id\":1.5}"), "Field 'id' must be an integer");
+    ASSERT_EQ(errorOf("{\"id\":0}").find("Field 'id' must be at least"), 0u);
+    ASSERT_EQ(errorOf("{\"id\":1,\"customer_name\":\"A\"}"), "Field 'customer_name' must be at least 2 characters");
+    ASSERT_EQ(errorOf("{\"id\":1,\"customer_name\":\"Acme\",\"priority\":256}"), "Field 'priority' is out of range");
+    ASSERT_EQ(errorOf("{\"id\":1,\"customer_name\":\"Acme\",\"tags\":[\"gift\",\"x\"]}"),
+              "Field 'tags' must be one of: 'gift', 'express'");
+    ASSERT_EQ(errorOf("{\"id\":1,\"customer_name\":\"Acme\",\"tags\":[\"gift\",1]}"), "Field 'tags' item 1 must be a string");
+    ASSERT_EQ(errorOf("{\"id\":1,\"customer_name\":\"Acme\"}"), "Field 'address' is required");
+}
+
+TEST(Validate_NestedObjectsAndBodyHook) {
+    std::string base = "{\"id\":1,\"customer_name\":\"Acme\",";
+    ASSERT_EQ(errorOf(base + "\"address\":{\"zip\":\"12345\"}}"), "Field 'city' is required");
+    ASSERT_EQ(errorOf(base + "\"address\":{\"city\":\"X\",\"zip\":\"1\"}}"), "Field 'zip' does not match the required pattern");
+    ASSERT_EQ(errorOf(base + "\"address\":{\"city\":\"X\"},\"items\":[{\"sku\":\"A\",\"quantity\":0}]}"),
+              "Field 'quantity' must be at least 1.000000");
+    ASSERT_EQ(errorOf(base + "\"address\":{\"city\":\"X\"},\"items\":[]}"), "Field 'items' must have at least 1 items");
+    ASSERT_EQ(errorOf(base + "\"address\":{\"city\":\"X\"},\"paid\":true}"), "Paid orders must have a positive total");
+    ASSERT_EQ(errorOf(base + "\"address\":{\"city\":\"X\"}}"), "");
+}
+
+TEST(ValidateRequest_ChecksObjectDirectly) {
+    Order order = parseBody<Order>(kOrder);
+    ASSERT_TRUE(validateRequest(order));
+    order.customer.clear();
+    ASSERT_EQ(validateRequest(order).error_message, "Field 'customer_name' is required");
+    order.customer = "Acme";
+    order.items[0].quantity = 500;
+    ASSERT_EQ(validateRequest(order).error_message, "Field 'quantity' must be at most 100.000000");
+}
+
+// ========== 序列化 ==========
+
+TEST(Write_SkipsEmptyOptionalFields) {
+    Order order;
+    order.id = 7;
+    order.customer = "Bo";
+    order.address.city = "X";
+    ASSERT_EQ(toJson(order), "{\"id\":7,\"customer_name\":\"Bo\",\"address\":{\"city\":\"X\"}}");
+}
+
+TEST(Write_RoundTrip) {
+    Order order = parseBody<Order>(kOrder);
+    std::string json = toJson(order);
+    ASSERT_EQ(json,
+              "{\"id\":42,\"customer_name\":\"Acme\",\"priority\":3,\"total\":19.5,\"paid\":true,"
+              "\"note\":\"leave at door\",\"tags\":[\"gift\"],"
+              "\"address\":{\"city\":\"Springfield\",\"zip\":\"12345\"},"
+              "\"items\":[{\"sku\":\"A-1\",\"quantity\":2},{\"sku\":\"B-2\",\"quantity\":1}]}");
+
+    std::vector<shop::Item> items = order.items;
+    std::string list;
+    appendJson(items, list);
+    ASSERT_EQ(list, "[{\"sku\":\"A-1\",\"quantity\":2},{\"sku\":\"B-2\",\"quantity\":1}]");
+}
+
+// ========== BodySchemaBase 适配 ==========
+
+TEST(BodySchema_ForwardsToStaticSchema) {
+    BodySchemaBase* base = schema::bodySchema<Order>();
+    ASSERT_TRUE(base == schema::bodySchema<Order>());
+
+    Order order;
+    std::string error;
+    ASSERT_TRUE(base->parseJson(kOrder, std::strlen(kOrder), &order, true, &error));
+    ASSERT_EQ(order.customer, "Acme");
+    ASSERT_EQ(base->toJson(&order), toJson(order));
+    ASSERT_EQ(base->validateBody(&order), "");
+
+    order.total = 0;
+    ASSERT_EQ(base->validateObject(&order), "Paid orders must have a positive total");
+}
+
+TEST(BodySchema_DescribesFields) {
+    const FrozenSchema& defs = schema::bodySchema<Order>()->frozen();
+    ASSERT_EQ(defs.size(), 9u);
+    ASSERT_EQ(defs[0].name, "id");
+    ASSERT_TRUE(defs[0].type == FieldType::INT64);
+    ASSERT_TRUE(defs[0].validation.required);
+    ASSERT_EQ(defs[1].name, "customer_name");
+    ASSERT_EQ(defs[1].offset, offsetof(Order, customer));
+    ASSERT_TRUE(defs[2].type == FieldType::UINT8);
+    ASSERT_TRUE(defs[5].type == FieldType::STRING);
+    ASSERT_TRUE(defs[5].is_optional);
+    ASSERT_TRUE(defs[6].typed_array);
+    ASSERT_TRUE(defs[6].element_type == FieldType::STRING);
+    ASSERT_TRUE(defs[7].type == FieldType::OBJECT);
+    ASSERT_TRUE(defs[7].nested_schema == schema::bodySchema<shop::Address>());
+    ASSERT_TRUE(defs[8].item_schema == schema::bodySchema<shop::Item>());
+}
+
+int main() {
+    std::cout << "========================================" << std::endl;
+    std::cout << "Static Schema Unit Tests" << std::endl;
+    std::cout << "========================================" << std::endl << std::endl;
+
+    std::cout << "Trait Tests:" << std::endl;
+    RUN_TEST(Trait_DetectsDeclaredTypes);
+
+    std::cout << std::endl << "Parse Tests:" << std::endl;
+    RUN_TEST(Parse_ReadsAllMembers);
+    RUN_TEST(Parse_MissingOptionalFieldsReset);
+    RUN_TEST(Parse_NonValidatingSkipsMismatchAndClamps);
+    RUN_TEST(Parse_ReportsSyntaxErrors);
+
+    std::cout << std::endl << "Validation Tests:" << std::endl;
+    RUN_TEST(Validate_FieldRules);
+    RUN_TEST(Validate_NestedObjectsAndBodyHook);
+    RUN_TEST(ValidateRequest_ChecksObjectDirectly);
+
+    std::cout << std::endl << "Serialization Tests:" << std::endl;
+    RUN_TEST(Write_SkipsEmptyOptionalFields);
+    RUN_TEST(Write_RoundTrip);
+
+    std::cout << std::endl << "BodySchemaBase Tests:" << std::endl;
+    RUN_TEST(BodySchema_ForwardsToStaticSchema);
+    RUN_TEST(BodySchema_DescribesFields);
+
+    std::cout << std::endl << "========================================" << std::endl;
+    std::cout << "Test Results:" << std::endl;
+    std::cout << "  Total: " << test_count << std::endl;
+    std::cout << "  Passed: " << passed_count << std::endl;
+    std::cout << "  Failed: " << (test_count - passed_count) << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    if (test_count == passed_count) {
+        std::cout << "All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "Some tests failed!" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,148 @@
+/**
+ * @file test_string_builder.cpp
+ * @brief 单元测试：追加式字符串构建器
+ */
+
+#include <iostream>
+#include <cassert>
+#include <cstdlib>
+#include <climits>
+#include <cstdint>
+#include <string>
+#include "../../include/string_builder.h"
+
+using namespace uvapi;
+
+int test_count = 0;
+int passed_count = 0;
+
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { \
+    test_count++; \
+    std::cout << "Running test: " << #name << "..."; \
+    test_##name(); \
+    std::cout << " PASSED" << std::endl; \
+    passed_count++; \
+} while(0)
+
+#define ASSERT_TRUE(expr) do { \
+    if (!(expr)) { \
+        std::cerr << "\n  FAILED: " << #expr << " is false" << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+#define ASSERT_FALSE(expr) ASSERT_TRUE(!(expr))
+
+#define ASSERT_EQ(a, b) do { \
+    if ((a) != (b)) { \
+        std::cerr << "\n  FAILED: " << #a << " != " << #b << std::endl; \
+        std::cerr << "    Expected: " << (b) << ", Got: " << (a) << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+
+// ========== 数值格式化测试 ==========
+
+TEST(Format_Integers) {
+    StringBuilder sb;
+    sb << 0 << ',' << -42 << ',' << 7u << ',' << static_cast<int64_t>(INT64_MIN)
+       << ',' << static_cast<uint64_t>(UINT64_MAX);
+    ASSERT_EQ(sb.str(), "0,-42,7,-9223372036854775808,18446744073709551615");
+}
+
+TEST(Format_DoublesAndBool) {
+    StringBuilder sb;
+    sb << 0.1 << ',' << 2.0 << ',' << true << ',' << false;
+    ASSERT_EQ(sb.str(), "0.1,2,true,false");
+}
+
+TEST(Format_NullCString) {
+    StringBuilder sb;
+    const char* missing = 0;
+    sb << "a" << missing << "b";
+    ASSERT_EQ(sb.str(), "ab");
+}
+
+// ========== 转义测试 ==========
+
+TEST(Escape_QuotedAndRaw) {
+    StringBuilder sb;
+    sb << '{';
+    sb.appendQuoted("k");
+    sb << ':';
+    sb.appendQuoted(std::string("a\"b\\c\n"));
+    sb << ',' << "\"raw\":\"";
+    sb.appendEscaped(std::string("\t"));
+    sb << "\"}";
+    ASSERT_EQ(sb.str(), "{\"k\":\"a\\\"b\\\\c\\n\",\"raw\":\"\\t\"}");
+}
+
+// ========== 缓冲区测试 ==========
+
+TEST(Buffer_ReserveKeepsStorage) {
+    StringBuilder sb(256);
+    ASSERT_TRUE(sb.capacity() >= 256);
+    const char* before = sb.data();
+    for (int i = 0; i < 50; ++i) {
+        sb << i;
+    }
+    ASSERT_TRUE(sb.data() == before);
+}
+
+TEST(Buffer_ReleaseDoesNotCopy) {
+    StringBuilder sb(1024);
+    sb << std::string(600, 'x');
+    const char* storage = sb.data();
+    std::string out = sb.release();
+    ASSERT_TRUE(out.data() == storage);
+    ASSERT_EQ(out.size(), static_cast<size_t>(600));
+    ASSERT_TRUE(sb.empty());
+    sb << "next";
+    ASSERT_EQ(sb.str(), "next");
+}
+
+TEST(Buffer_ClearAndToString) {
+    StringBuilder sb;
+    sb << "hello";
+    std::string copy = sb.toString();
+    ASSERT_EQ(copy, "hello");
+    ASSERT_EQ(sb.size(), static_cast<size_t>(5));
+    sb.clear();
+    ASSERT_TRUE(sb.empty());
+}
+
+int main() {
+    std::cout << "========================================" << std::endl;
+    std::cout << "String Builder Unit Tests" << std::endl;
+    std::cout << "========================================" << std::endl << std::endl;
+
+    std::cout << "Format Tests:" << std::endl;
+    RUN_TEST(Format_Integers);
+    RUN_TEST(Format_DoublesAndBool);
+    RUN_TEST(Format_NullCString);
+
+    std::cout << std::endl << "Escape Tests:" << std::endl;
+    RUN_TEST(Escape_QuotedAndRaw);
+
+    std::cout << std::endl << "Buffer Tests:" << std::endl;
+    RUN_TEST(Buffer_ReserveKeepsStorage);
+    RUN_TEST(Buffer_ReleaseDoesNotCopy);
+    RUN_TEST(Buffer_ClearAndToString);
+
+    std::cout << std::endl << "========================================" << std::endl;
+    std::cout << "Test Results:" << std::endl;
+    std::cout << "  Total: " << test_count << std::endl;
+    std::cout << "  Passed: " << passed_count << std::endl;
+    std::cout << "  Failed: " << (test_count - passed_count) << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    if (test_count == passed_count) {
+        std::cout << "All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "Some tests failed!" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,209 @@
+/**
+ * @file test_tls_session.cpp
+ * @brief 单元测试：TLS 会话选项、票据密钥轮换与握手统计
+ */
+
+#include <iostream>
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include "../../include/tls_session.h"
+
+using namespace uvapi::tls;
+
+int test_count = 0;
+int passed_count = 0;
+
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { \
+    test_count++; \
+    std::cout << "Running test: " << #name << "..."; \
+    test_##name(); \
+    std::cout << " PASSED" << std::endl; \
+    passed_count++; \
+} while(0)
+
+#define ASSERT_TRUE(expr) do { \
+    if (!(expr)) { \
+        std::cerr << "\n  FAILED: " << #expr << " is false" << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+#define ASSERT_FALSE(expr) ASSERT_TRUE(!(expr))
+
+#define ASSERT_EQ(a, b) do { \
+    if ((a) != (b)) { \
+        std::cerr << "\n  FAILED: " << #a << " != " << #b << std::endl; \
+        std::cerr << "    Expected: " << (b) << ", Got: " << (a) << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+// 按调用次数填充可预测字节的随机源
+struct CountingFill {
+    int* calls;
+    bool ok;
+    bool operator()(unsigned char* out, size_t size) const {
+        (*calls)++;
+        if (!ok) return false;
+        std::memset(out, *calls, size);
+        return true;
+    }
+};
+
+// ========== 选项 ==========
+
+TEST(Options_Defaults) {
+    SessionOptions options;
+    ASSERT_TRUE(options.session_tickets);
+    ASSERT_EQ(options.ticket_rotation.count(), 3600);
+    ASSERT_TRUE(options.session_cache_size > 0u);
+    ASSERT_EQ(options.alpn.size(), 1u);
+    ASSERT_EQ(options.alpn[0], std::string("http/1.1"));
+    ASSERT_FALSE(options.prefersEcdsa());
+    
+    options.ecdsa("ec.crt", "ec.key").ticketRotation(std::chrono::seconds(5)).sessionCache(0);
+    ASSERT_TRUE(options.prefersEcdsa());
+    ASSERT_EQ(options.ticket_rotation.count(), 60);  // 下限 60 秒
+    ASSERT_EQ(options.session_cache_size, 0u);
+}
+
+// ========== 票据密钥 ==========
+
+TEST(KeyRing_RotatesOnSchedule) {
+    TicketKeyRing ring(std::chrono::seconds(60));
+    TicketKey key;
+    ASSERT_FALSE(ring.current(key));
+    ASSERT_EQ(ring.generation(), 0u);
+    ASSERT_EQ(ring.keyLifetimeSeconds(), 120u);
+    
+    int calls = 0;
+    CountingFill fill = {&calls, true};
+    ASSERT_TRUE(ring.rotateIfDue(1000, fill));  // 首次立即生成
+    ASSERT_TRUE(ring.current(key));
+    ASSERT_EQ(key.generation, 1u);
+    unsigned char first = key.secret[0];
+    
+    // 其他工作线程在同一间隔内调用不会再生成
+    ASSERT_FALSE(ring.rotateIfDue(30000, fill));
+    ASSERT_FALSE(ring.rotateIfDue(60999, fill));
+    ASSERT_EQ(ring.generation(), 1u);
+    
+    ASSERT_TRUE(ring.rotateIfDue(61000, fill));
+    ASSERT_TRUE(ring.current(key));
+    ASSERT_EQ(key.generation, 2u);
+    ASSERT_TRUE(key.secret[0] != first);
+}
+
+TEST(KeyRing_FailedFillKeepsKey) {
+    TicketKeyRing ring(std::chrono::seconds(60));
+    int calls = 0;
+    CountingFill fill = {&calls, true};
+    ring.rotateIfDue(0, fill);
+    
+    CountingFill broken = {&calls, false};
+    ASSERT_FALSE(ring.rotateIfDue(60000, broken));
+    TicketKey key;
+    ASSERT_TRUE(ring.current(key));
+    ASSERT_EQ(key.generation, 1u);
+    
+    // 下一次调用重试
+    ASSERT_TRUE(ring.rotateIfDue(60001, fill));
+    ASSERT_EQ(ring.generation(), 2u);
+}
+
+// ========== 握手统计 ==========
+
+TEST(Stats_ResumptionRatio) {
+    SessionStats stats;
+    ASSERT_EQ(stats.resumptionRatio(), 0.0);
+    for (int i = 0; i < 4; i++) {
+        stats.handshake();
+    }
+    stats.resumed();
+    stats.resumed();
+    stats.resumed();
+    ASSERT_EQ(stats.handshakes(), 4u);
+    ASSERT_EQ(stats.resumedCount(), 3u);
+    ASSERT_EQ(stats.resumptionRatio(), 0.75);
+    
+    // 恢复先于握手计数时按 1 截断
+    SessionStats early;
+    early.resumed();
+    ASSERT_EQ(early.resumptionRatio(), 0.0);
+    early.handshake();
+    early.resumed();
+    ASSERT_EQ(early.resumptionRatio(), 1.0);
+}
+
+TEST(Stats_ExportedMetrics) {
+    SessionStats stats;
+    stats.handshake();
+    stats.handshake();
+    stats.resumed();
+    stats.ticketRejected();
+    
+    uvapi::metrics::MetricRegistry registry;
+    stats.registerMetrics(registry);
+    std::string text;
+    registry.scrape(text, uvapi::metrics::ExpositionFormat::PROMETHEUS);
+    ASSERT_TRUE(text.find("uvapi_tls_handshakes_total 2") != std::string::npos);
+    ASSERT_TRUE(text.find("uvapi_tls_resumed_total 1") != std::string::npos);
+    ASSERT_TRUE(text.find("uvapi_tls_tickets_rejected_total 1") != std::string::npos);
+    ASSERT_TRUE(text.find("uvapi_tls_resumption_ratio 0.5") != std::string::npos);
+}
+
+// ========== ALPN ==========
+
+TEST(Alpn_NullTerminated) {
+    std::vector<std::string> protocols;
+    protocols.push_back("h2");
+    protocols.push_back("");
+    protocols.push_back(std::string(256, 'x'));
+    protocols.push_back("http/1.1");
+    AlpnList list(protocols);
+    ASSERT_EQ(list.size(), 2u);
+    const char** data = list.data();
+    ASSERT_EQ(std::string(data[0]), std::string("h2"));
+    ASSERT_EQ(std::string(data[1]), std::string("http/1.1"));
+    ASSERT_TRUE(data[2] == nullptr);
+    
+    list.assign(std::vector<std::string>());
+    ASSERT_TRUE(list.empty());
+    ASSERT_TRUE(list.data()[0] == nullptr);
+}
+
+int main() {
+    std::cout << "TLS Session Unit Tests" << std::endl;
+    std::cout << "========================================" << std::endl << std::endl;
+
+    std::cout << "Options Tests:" << std::endl;
+    RUN_TEST(Options_Defaults);
+
+    std::cout << std::endl << "Ticket Key Tests:" << std::endl;
+    RUN_TEST(KeyRing_RotatesOnSchedule);
+    RUN_TEST(KeyRing_FailedFillKeepsKey);
+
+    std::cout << std::endl << "Stats Tests:" << std::endl;
+    RUN_TEST(Stats_ResumptionRatio);
+    RUN_TEST(Stats_ExportedMetrics);
+
+    std::cout << std::endl << "ALPN Tests:" << std::endl;
+    RUN_TEST(Alpn_NullTerminated);
+
+    std::cout << std::endl << "========================================" << std::endl;
+    std::cout << "Test Results:" << std::endl;
+    std::cout << "  Total: " << test_count << std::endl;
+    std::cout << "  Passed: " << passed_count << std::endl;
+    std::cout << "  Failed: " << (test_count - passed_count) << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    if (test_count == passed_count) {
+        std::cout << "All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "Some tests failed!" << std::endl;
+        return 1;
+    }
+}
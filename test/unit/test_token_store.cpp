@@ -0,0 +1,258 @@
+/**
+ * @file test_token_store.cpp
+ * @brief 单元测试：token 哈希表、分层时间轮与签名 token 编解码
+ */
+
+#include <iostream>
+#include <cassert>
+#include <cstdlib>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+#include "../../include/token_store.h"
+
+using namespace uvapi::auth;
+
+int test_count = 0;
+int passed_count = 0;
+
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { \
+    test_count++; \
+    std::cout << "Running test: " << #name << "..."; \
+    test_##name(); \
+    std::cout << " PASSED" << std::endl; \
+    passed_count++; \
+} while(0)
+
+#define ASSERT_TRUE(expr) do { \
+    if (!(expr)) { \
+        std::cerr << "\n  FAILED: " << #expr << " is false" << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+#define ASSERT_FALSE(expr) ASSERT_TRUE(!(expr))
+
+#define ASSERT_EQ(a, b) do { \
+    if ((a) != (b)) { \
+        std::cerr << "\n  FAILED: " << #a << " != " << #b << std::endl; \
+        std::cerr << "    Expected: " << (b) << ", Got: " << (a) << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+
+// 确定性的伪随机 token（测试用）
+static TokenKey makeKey(uint64_t seed) {
+    unsigned char random[kTokenSize];
+    uint64_t x = seed * 0x9E3779B97F4A7C15ULL + 1;
+    for (size_t i = 0; i < kTokenSize; ++i) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        random[i] = static_cast<unsigned char>(x);
+    }
+    return TokenKey::fromRandom(random);
+}
+
+// ========== 哈希表测试 ==========
+
+TEST(Table_InsertFindErase) {
+    TokenTable<int> table;
+    TokenKey a = makeKey(1);
+    TokenKey b = makeKey(2);
+    ASSERT_TRUE(table.insert(a, 10));
+    ASSERT_TRUE(table.insert(b, 20));
+    ASSERT_FALSE(table.insert(a, 11));
+    const int* found = table.find(a);
+    ASSERT_TRUE(found != nullptr);
+    ASSERT_EQ(*found, 11);
+    ASSERT_EQ(table.size(), static_cast<size_t>(2));
+    ASSERT_TRUE(table.erase(a));
+    ASSERT_FALSE(table.erase(a));
+    ASSERT_TRUE(table.find(a) == nullptr);
+    found = table.find(b);
+    ASSERT_TRUE(found != nullptr);
+    ASSERT_EQ(*found, 20);
+}
+
+TEST(Table_MatchesReferenceUnderChurn) {
+    // 随机插入 / 删除，与 std::map 对照，覆盖扩容和后移删除
+    TokenTable<uint64_t> table(16);
+    std::map<std::string, uint64_t> reference;
+    uint64_t x = 12345;
+    for (int step = 0; step < 20000; ++step) {
+        x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+        TokenKey key = makeKey((x >> 33) % 3000);
+        if ((x >> 20) % 3 == 0) {
+            ASSERT_EQ(table.erase(key), reference.erase(key.toString()) > 0);
+        } else {
+            table.insert(key, x);
+            reference[key.toString()] = x;
+        }
+    }
+    ASSERT_EQ(table.size(), reference.size());
+    for (std::map<std::string, uint64_t>::const_iterator it = reference.begin(); it != reference.end(); ++it) {
+        TokenKey key;
+        ASSERT_TRUE(TokenKey::parse(it->first.data(), it->first.size(), key));
+        const uint64_t* found = table.find(key);
+        ASSERT_TRUE(found != nullptr);
+        ASSERT_EQ(*found, it->second);
+    }
+    ASSERT_TRUE(table.capacity() * 7 >= table.size() * 10);
+}
+
+TEST(Table_KeyFormat) {
+    TokenKey key = makeKey(7);
+    std::string text = key.toString();
+    ASSERT_EQ(text.size(), kTokenSize);
+    for (size_t i = 0; i < text.size(); ++i) {
+        char c = text[i];
+        ASSERT_TRUE((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '-' || c == '_');
+    }
+    TokenKey parsed;
+    ASSERT_FALSE(TokenKey::parse(text.data(), text.size() - 1, parsed));
+    ASSERT_TRUE(TokenKey::parse(text.data(), text.size(), parsed));
+    ASSERT_TRUE(parsed == key);
+}
+
+// ========== 时间轮测试 ==========
+
+TEST(Wheel_FiresAtExpiryTick) {
+    // 覆盖每一层的范围（含跨层下沉）
+    TimerWheel wheel(1000);
+    std::vector<uint64_t> delays;
+    delays.push_back(1);
+    delays.push_back(63);
+    delays.push_back(64);
+    delays.push_back(65);
+    delays.push_back(4095);
+    delays.push_back(4096);
+    delays.push_back(4097);
+    delays.push_back(300000);
+    for (size_t i = 0; i < delays.size(); ++i) {
+        wheel.schedule(makeKey(i), 1000 + delays[i]);
+    }
+    ASSERT_EQ(wheel.pending(), delays.size());
+
+    std::map<std::string, uint64_t> fired_at;
+    for (uint64_t now = 1001; now <= 1000 + 300000; ++now) {
+        wheel.advance(now, [&fired_at, now](const TokenKey& key, uint64_t expires) {
+            ASSERT_EQ(expires, now);
+            fired_at[key.toString()] = now;
+        });
+    }
+    ASSERT_EQ(fired_at.size(), delays.size());
+    for (size_t i = 0; i < delays.size(); ++i) {
+        ASSERT_EQ(fired_at[makeKey(i).toString()], 1000 + delays[i]);
+    }
+    ASSERT_EQ(wheel.pending(), static_cast<size_t>(0));
+}
+
+TEST(Wheel_LargeJumpAndPastDue) {
+    TimerWheel wheel(0);
+    wheel.schedule(makeKey(1), 0);       // 已到期：下一个刻度触发
+    wheel.schedule(makeKey(2), 100);
+    wheel.schedule(makeKey(3), 5000);
+    size_t count = 0;
+    ASSERT_EQ(wheel.advance(1, [&count](const TokenKey&, uint64_t) { ++count; }), static_cast<size_t>(1));
+    ASSERT_EQ(wheel.advance(10000, [&count](const TokenKey&, uint64_t) { ++count; }), static_cast<size_t>(2));
+    ASSERT_EQ(count, static_cast<size_t>(3));
+    // 没有待到期条目时直接跳到目标刻度
+    wheel.advance(1000000000ULL, [](const TokenKey&, uint64_t) {});
+    ASSERT_EQ(wheel.currentTick(), 1000000000ULL);
+}
+
+TEST(Wheel_BeyondRangeIsRequeued) {
+    TimerWheel wheel(0);
+    uint64_t span = static_cast<uint64_t>(1) << (TimerWheel::kSlotBits * TimerWheel::kLevels);
+    wheel.schedule(makeKey(1), span + 10);
+    uint64_t fired = 0;
+    wheel.advance(span + 9, [&fired](const TokenKey&, uint64_t expires) { fired = expires; });
+    ASSERT_EQ(fired, static_cast<uint64_t>(0));
+    ASSERT_EQ(wheel.pending(), static_cast<size_t>(1));
+    wheel.advance(span + 10, [&fired](const TokenKey&, uint64_t expires) { fired = expires; });
+    ASSERT_EQ(fired, span + 10);
+}
+
+// ========== 签名 token 编解码测试 ==========
+
+TEST(Signed_Base64UrlRoundTrip) {
+    for (size_t len = 0; len < 40; ++len) {
+        std::string raw;
+        for (size_t i = 0; i < len; ++i) {
+            raw += static_cast<char>((i * 37 + len) & 0xFF);
+        }
+        std::string encoded;
+        base64UrlEncode(reinterpret_cast<const unsigned char*>(raw.data()), raw.size(), encoded);
+        ASSERT_TRUE(encoded.find('=') == std::string::npos);
+        std::string decoded;
+        ASSERT_TRUE(base64UrlDecode(encoded.data(), encoded.size(), decoded));
+        ASSERT_EQ(decoded, raw);
+    }
+    std::string out;
+    ASSERT_FALSE(base64UrlDecode("ab+c", 4, out));
+    ASSERT_FALSE(base64UrlDecode("abcde", 5, out));
+}
+
+TEST(Signed_ClaimsRoundTrip) {
+    std::string packed;
+    ASSERT_TRUE(packClaims(-42, 1700000000, "alice", "admin", packed));
+    int64_t user_id = 0;
+    int64_t expires_at = 0;
+    std::string username;
+    std::string role;
+    ASSERT_TRUE(unpackClaims(packed, user_id, expires_at, username, role));
+    ASSERT_EQ(user_id, -42);
+    ASSERT_EQ(expires_at, 1700000000);
+    ASSERT_EQ(username, "alice");
+    ASSERT_EQ(role, "admin");
+    ASSERT_FALSE(unpackClaims(packed.substr(0, packed.size() - 1), user_id, expires_at, username, role));
+    ASSERT_FALSE(unpackClaims(packed + "x", user_id, expires_at, username, role));
+}
+
+TEST(Signed_ConstantTimeEquals) {
+    unsigned char a[32] = { 0 };
+    unsigned char b[32] = { 0 };
+    ASSERT_TRUE(constantTimeEquals(a, b, sizeof(a)));
+    b[31] = 1;
+    ASSERT_FALSE(constantTimeEquals(a, b, sizeof(a)));
+}
+
+int main() {
+    std::cout << "========================================" << std::endl;
+    std::cout << "Token Store Unit Tests" << std::endl;
+    std::cout << "========================================" << std::endl << std::endl;
+
+    std::cout << "Table Tests:" << std::endl;
+    RUN_TEST(Table_InsertFindErase);
+    RUN_TEST(Table_MatchesReferenceUnderChurn);
+    RUN_TEST(Table_KeyFormat);
+
+    std::cout << std::endl << "Timer Wheel Tests:" << std::endl;
+    RUN_TEST(Wheel_FiresAtExpiryTick);
+    RUN_TEST(Wheel_LargeJumpAndPastDue);
+    RUN_TEST(Wheel_BeyondRangeIsRequeued);
+
+    std::cout << std::endl << "Signed Token Tests:" << std::endl;
+    RUN_TEST(Signed_Base64UrlRoundTrip);
+    RUN_TEST(Signed_ClaimsRoundTrip);
+    RUN_TEST(Signed_ConstantTimeEquals);
+
+    std::cout << std::endl << "========================================" << std::endl;
+    std::cout << "Test Results:" << std::endl;
+    std::cout << "  Total: " << test_count << std::endl;
+    std::cout << "  Passed: " << passed_count << std::endl;
+    std::cout << "  Failed: " << (test_count - passed_count) << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    if (test_count == passed_count) {
+        std::cout << "All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "Some tests failed!" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,277 @@
+/**
+ * @file test_tracing.cpp
+ * @brief 单元测试：请求追踪缓冲区、采样与渲染
+ */
+
+#include <iostream>
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <thread>
+#include <vector>
+#include "../../include/tracing.h"
+
+using namespace uvapi;
+using namespace uvapi::trace;
+
+int test_count = 0;
+int passed_count = 0;
+
+#define TEST(name) void test_##name()
+#define RUN_TEST(name) do { \
+    test_count++; \
+    std::cout << "Running test: " << #name << "..."; \
+    test_##name(); \
+    std::cout << " PASSED" << std::endl; \
+    passed_count++; \
+} while(0)
+
+#define ASSERT_TRUE(expr) do { \
+    if (!(expr)) { \
+        std::cerr << "\n  FAILED: " << #expr << " is false" << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+#define ASSERT_FALSE(expr) ASSERT_TRUE(!(expr))
+
+#define ASSERT_EQ(a, b) do { \
+    if ((a) != (b)) { \
+        std::cerr << "\n  FAILED: " << #a << " != " << #b << std::endl; \
+        std::cerr << "    Expected: " << (b) << ", Got: " << (a) << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+static SpanRecord makeRecord(uint64_t id, uint8_t flags) {
+    SpanRecord record;
+    std::memset(&record, 0, sizeof(record));
+    record.trace_id = id;
+    record.flags = flags;
+    record.route_id = -1;
+    copyField(record.method, sizeof(record.method), "GET", 3);
+    return record;
+}
+
+// ========== 环形缓冲区 ==========
+
+TEST(Ring_PushDrainInOrder) {
+    SpanRing ring(4);
+    ASSERT_EQ(ring.capacity(), 16u);  // 最小 16
+    for (uint64_t i = 1; i <= 5; ++i) {
+        ASSERT_TRUE(ring.push(makeRecord(i, SpanRecord::SAMPLED)));
+    }
+    std::vector<SpanRecord> out;
+    ASSERT_EQ(ring.drain(out), 5u);
+    ASSERT_EQ(out.size(), 5u);
+    ASSERT_EQ(out[0].trace_id, 1u);
+    ASSERT_EQ(out[4].trace_id, 5u);
+    ASSERT_EQ(ring.drain(out), 0u);
+}
+
+TEST(Ring_DropsWhenFull) {
+    SpanRing ring(16);
+    for (uint64_t i = 0; i < 20; ++i) {
+        ring.push(makeRecord(i, SpanRecord::SAMPLED));
+    }
+    ASSERT_EQ(ring.dropped(), 4u);
+    std::vector<SpanRecord> out;
+    ASSERT_EQ(ring.drain(out), 16u);
+    ASSERT_EQ(out[15].trace_id, 15u);
+    ASSERT_TRUE(ring.push(makeRecord(99, SpanRecord::SAMPLED)));  // 取走后又有空位
+}
+
+TEST(Ring_ConcurrentProducer) {
+    SpanRing ring(256);
+    const uint64_t total = 20000;
+    std::thread producer([&ring, total]() {
+        for (uint64_t i = 0; i < total; ++i) {
+            while (!ring.push(makeRecord(i, 0))) {
+                std::this_thread::yield();
+            }
+        }
+    });
+    std::vector<SpanRecord> out;
+    while (out.size() < total) {
+        ring.drain(out);
+    }
+    producer.join();
+    for (uint64_t i = 0; i < total; ++i) {
+        ASSERT_EQ(out[i].trace_id, i);
+    }
+}
+
+TEST(Field_Truncates) {
+    char buf[4];
+    copyField(buf, sizeof(buf), "abcdef", 6);
+    ASSERT_EQ(std::string(buf), std::string("abc"));
+    copyField(buf, sizeof(buf), nullptr, 0);
+    ASSERT_EQ(std::string(buf), std::string());
+}
+
+// ========== 采样与记录 ==========
+
+TEST(Span_DisabledIsInert) {
+    RequestSpan none(nullptr);
+    ASSERT_FALSE(none.recording());
+    ASSERT_TRUE(RequestSpan::active() == nullptr);
+
+    Tracer off(TracePolicy().sampleRate(0).slowThreshold(std::chrono::microseconds(0)));
+    ASSERT_FALSE(off.active());
+    {
+        RequestSpan span(&off);
+        ASSERT_FALSE(span.recording());
+        ASSERT_TRUE(metrics::RequestTiming::active() == nullptr);
+    }
+    ASSERT_EQ(off.collect(), 0u);
+}
+
+TEST(Span_SampledRecordsPhases) {
+    Tracer tracer(TracePolicy().sampleRate(1.0).slowThreshold(std::chrono::microseconds(0)));
+    {
+        RequestSpan span(&tracer);
+        ASSERT_TRUE(span.recording());
+        ASSERT_TRUE(RequestSpan::active() == &span);
+        span.request("POST", "/users/42", 17);
+        std::string pattern("/users/:id");
+        span.route(3, &pattern);
+        metrics::RequestTiming::active()->add(metrics::Phase::PARSE, 1000);
+        noteResponse(201, 9);
+    }
+    ASSERT_TRUE(RequestSpan::active() == nullptr);
+    ASSERT_EQ(tracer.collect(), 1u);
+    ASSERT_EQ(tracer.stats().recorded, 1u);
+
+    std::shared_ptr<const std::string> body = tracer.latest();
+    ASSERT_TRUE(body != nullptr);
+    ASSERT_TRUE(body->find("\"route\":\"/users/:id\"") != std::string::npos);
+    ASSERT_TRUE(body->find("\"path\":\"/users/42\"") != std::string::npos);
+    ASSERT_TRUE(body->find("\"status\":201") != std::string::npos);
+    ASSERT_TRUE(body->find("\"request_bytes\":17") != std::string::npos);
+    ASSERT_TRUE(body->find("\"parse\":1000") != std::string::npos);
+    ASSERT_TRUE(body->find("\"sampled\":true") != std::string::npos);
+}
+
+TEST(Span_SlowOnlyKeepsSlowRequests) {
+    Tracer tracer(TracePolicy().sampleRate(0).slowThreshold(std::chrono::microseconds(2000)));
+    ASSERT_TRUE(tracer.active());
+    {
+        RequestSpan fast(&tracer);
+        ASSERT_TRUE(fast.recording());  // 有阈值时每个请求都计时
+    }
+    {
+        RequestSpan slow(&tracer);
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    ASSERT_EQ(tracer.collect(), 1u);
+    std::shared_ptr<const std::string> body = tracer.latest();
+    ASSERT_TRUE(body->find("\"slow\":[{") != std::string::npos);
+    ASSERT_TRUE(body->find("\"recent\":[]") != std::string::npos);
+}
+
+TEST(Span_RetainsMostRecent) {
+    Tracer tracer(TracePolicy().sampleRate(1.0).retain(2));
+    for (int i = 0; i < 5; ++i) {
+        RequestSpan span(&tracer);
+        noteResponse(200 + i, 0);
+    }
+    tracer.collect();
+    std::shared_ptr<const std::string> body = tracer.latest();
+    ASSERT_TRUE(body->find("\"status\":204") != std::string::npos);
+    ASSERT_TRUE(body->find("\"status\":203") != std::string::npos);
+    ASSERT_TRUE(body->find("\"status\":202") == std::string::npos);
+    ASSERT_TRUE(body->find("\"recorded\":5") != std::string::npos);
+}
+
+TEST(Sample_RateIsApproximate) {
+    Tracer tracer(TracePolicy().sampleRate(0.25));
+    int hits = 0;
+    for (int i = 0; i < 10000; ++i) {
+        hits += tracer.sample() ? 1 : 0;
+    }
+    ASSERT_TRUE(hits > 2000 && hits < 3000);
+}
+
+// ========== 收集与导出 ==========
+
+TEST(Collector_ExportsFromOtherThreads) {
+    std::atomic<size_t> exported(0);
+    Tracer tracer(TracePolicy()
+                      .sampleRate(1.0)
+                      .drainInterval(std::chrono::milliseconds(5))
+                      .exportTo([&exported](const std::vector<SpanRecord>& batch) {
+                          exported.fetch_add(batch.size());
+                      }));
+    tracer.start();
+    std::thread worker([&tracer]() {
+        for (int i = 0; i < 10; ++i) {
+            RequestSpan span(&tracer);
+        }
+    });
+    worker.join();
+    {
+        RequestSpan span(&tracer);
+    }
+    tracer.stop();  // 停止前取走剩余记录
+    ASSERT_EQ(exported.load(), 11u);
+    ASSERT_EQ(tracer.stats().threads, 2u);
+}
+
+TEST(Otlp_RendersServerSpans) {
+    Tracer tracer(TracePolicy().sampleRate(1.0));
+    SpanRecord record = makeRecord(0x1234, SpanRecord::SAMPLED);
+    copyField(record.route, sizeof(record.route), "/items/:id", 10);
+    record.status = 503;
+    record.duration_ns = 1500;
+    std::vector<SpanRecord> spans(1, record);
+
+    std::string out;
+    renderOtlpJson(tracer, spans, "orders", out);
+    ASSERT_TRUE(out.find("\"stringValue\":\"orders\"") != std::string::npos);
+    ASSERT_TRUE(out.find("\"name\":\"GET /items/:id\"") != std::string::npos);
+    ASSERT_TRUE(out.find("\"kind\":2") != std::string::npos);
+    ASSERT_TRUE(out.find("0000000000001234\"") != std::string::npos);  // traceId 低 64 位
+    ASSERT_TRUE(out.find("\"key\":\"uvapi.phase.handler_ns\"") != std::string::npos);
+    ASSERT_TRUE(out.find("\"status\":{\"code\":2}") != std::string::npos);
+    ASSERT_TRUE(out.find("\"key\":\"url.path\"") == std::string::npos);  // 空字段不输出
+}
+
+int main() {
+    std::cout << "========================================" << std::endl;
+    std::cout << "Request Tracing Unit Tests" << std::endl;
+    std::cout << "========================================" << std::endl << std::endl;
+
+    std::cout << "Ring Buffer Tests:" << std::endl;
+    RUN_TEST(Ring_PushDrainInOrder);
+    RUN_TEST(Ring_DropsWhenFull);
+    RUN_TEST(Ring_ConcurrentProducer);
+    RUN_TEST(Field_Truncates);
+
+    std::cout << std::endl << "Sampling Tests:" << std::endl;
+    RUN_TEST(Span_DisabledIsInert);
+    RUN_TEST(Span_SampledRecordsPhases);
+    RUN_TEST(Span_SlowOnlyKeepsSlowRequests);
+    RUN_TEST(Span_RetainsMostRecent);
+    RUN_TEST(Sample_RateIsApproximate);
+
+    std::cout << std::endl << "Collector Tests:" << std::endl;
+    RUN_TEST(Collector_ExportsFromOtherThreads);
+    RUN_TEST(Otlp_RendersServerSpans);
+
+    std::cout << std::endl << "========================================" << std::endl;
+    std::cout << "Test Results:" << std::endl;
+    std::cout << "  Total: " << test_count << std::endl;
+    std::cout << "  Passed: " << passed_count << std::endl;
+    std::cout << "  Failed: " << (test_count - passed_count) << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    if (test_count == passed_count) {
+        std::cout << "All tests passed!" << std::endl;
+        return 0;
+    } else {
+        std::cout << "Some tests failed!" << std::endl;
+        return 1;
+    }
+}